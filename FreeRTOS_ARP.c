@@ -89,13 +89,135 @@ static void vProcessARPPacketReply( ARPPacket_t * pxARPFrame,
 
 /*-----------------------------------------------------------*/
 
+/*
+ * Age one entry of the ARP cache by one period of the ARP timer.
+ */
+static void prvARPAgeEntry( BaseType_t xEntry );
+
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+
+/*
+ * Calculate the hash bucket of an IP-address or a MAC-address.
+ */
+    static size_t prvARPHashIPAddress( uint32_t ulIPAddress );
+    static size_t prvARPHashMACAddress( const MACAddress_t * pxMACAddress );
+
+/*
+ * Find the row that holds a given IP-address, or -1 when not found.
+ */
+    static BaseType_t prvARPFindIPAddress( uint32_t ulIPAddress );
+
+/*
+ * Find a row with a valid MAC-address, but with a different IP-address than
+ * ulIPAddress, or -1 when not found.
+ */
+    static BaseType_t prvARPFindMACAddress( const MACAddress_t * pxMACAddress,
+                                            uint32_t ulIPAddress );
+
+/*
+ * Add a row to, or remove a row from the IP-address or the MAC-address hash table.
+ */
+    static void prvARPLinkIPAddress( BaseType_t xEntry );
+    static void prvARPUnlinkIPAddress( BaseType_t xEntry );
+    static void prvARPLinkMACAddress( BaseType_t xEntry );
+    static void prvARPUnlinkMACAddress( BaseType_t xEntry );
+
+/*
+ * Take the least recently refreshed row, and clear it if it is in use.
+ */
+    static BaseType_t prvARPAllocateRow( void );
+
+/*
+ * Remove a row from the hash tables, release its waiting packets, and make it
+ * the first candidate for re-use.
+ */
+    static void prvARPClearRow( BaseType_t xEntry );
+
+/*
+ * Mark a row as the most recently refreshed one.
+ */
+    static void prvARPTouchRow( BaseType_t xEntry );
+
+/*
+ * Take a row out of the list that is ordered by the time of refreshing.
+ */
+    static void prvARPRemoveFromAgeList( BaseType_t xEntry );
+
+/*
+ * Pass the packets waiting for an ARP reply back to the IP-task, or release them.
+ */
+    static void prvARPFlushPending( BaseType_t xEntry,
+                                    BaseType_t xResolved );
+#endif /* ipconfigUSE_ARP_HASH_TABLE */
+
+#if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+
+/*
+ * Schedule the next moment at which an entry needs attention from the ARP timer.
+ */
+    static void prvARPWheelSchedule( BaseType_t xEntry );
+
+/*
+ * Take an entry out of the timer wheel.
+ */
+    static void prvARPWheelRemove( BaseType_t xEntry );
+
+/*
+ * Move the timer wheel one period of the ARP timer forward, and age the entries
+ * that are due.
+ */
+    static void prvARPWheelAdvance( void );
+#endif /* ipconfigUSE_ARP_TIMER_WHEEL */
+
+/*-----------------------------------------------------------*/
+
 /** @brief The ARP cache. */
 _static ARPCacheRow_t xARPCache[ ipconfigARP_CACHE_ENTRIES ];
 
+#if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+
+/** @brief Value of a row reference that does not refer to any row.  Row references
+ * are stored as 1 + the index in xARPCache[]. */
+    #define arpNO_ROW    ( 0U )
+
+/** @brief The first row in each IP-address hash bucket. */
+    static uint16_t usARPIPBuckets[ ipconfigARP_HASH_BUCKETS ];
+
+/** @brief The first row in each MAC-address hash bucket. */
+    static uint16_t usARPMACBuckets[ ipconfigARP_HASH_BUCKETS ];
+
+/** @brief The rows, ordered from the most recently to the least recently refreshed. */
+    static uint16_t usARPNewestRow, usARPOldestRow;
+
+/** @brief pdTRUE as soon as the rows have been linked in the LRU list. */
+    static BaseType_t xARPHashReady = pdFALSE;
+
+/** @brief The total number of packets waiting for an ARP reply. */
+    static UBaseType_t uxARPPendingPackets = 0U;
+#endif /* ipconfigUSE_ARP_HASH_TABLE */
+
+#if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+
+/** @brief The first entry in each slot of the timer wheel.  An entry that is due
+ * at period N is stored in slot ( N % ipconfigARP_TIMER_WHEEL_SLOTS ). */
+    static uint16_t usARPWheelSlots[ ipconfigARP_TIMER_WHEEL_SLOTS ];
+
+/** @brief The number of ARP timer periods that have passed. */
+    static uint16_t usARPWheelTime = 0U;
+#endif /* ipconfigUSE_ARP_TIMER_WHEEL */
+
 /** @brief  The time at which the last gratuitous ARP was sent.  Gratuitous ARPs are used
  * to ensure ARP tables are up to date and to detect IP address conflicts. */
 static TickType_t xLastGratuitousARPTime = 0U;
 
+#if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+    /** @brief Incremented every time that a MAC-address stored by a socket might
+     * have become invalid, see ulARPGetGeneration(). */
+    static volatile uint32_t ulARPGeneration = 1U;
+#endif
+
 /*
  * IP-clash detection is currently only used internally. When DHCP doesn't respond, the
  * driver can try out a random LinkLayer IP address (169.254.x.x).  It will send out a
@@ -324,34 +446,40 @@ static void vProcessARPPacketReply( ARPPacket_t * pxARPFrame,
         vARPRefreshCacheEntry( &( pxARPHeader->xSenderHardwareAddress ), ulSenderProtocolAddress );
     }
 
-    if( pxARPWaitingNetworkBuffer != NULL )
-    {
-        IPPacket_t * pxARPWaitingIPPacket = ipCAST_PTR_TO_TYPE_PTR( IPPacket_t, pxARPWaitingNetworkBuffer->pucEthernetBuffer );
-        IPHeader_t * pxARPWaitingIPHeader = &( pxARPWaitingIPPacket->xIPHeader );
-
-        if( ulSenderProtocolAddress == pxARPWaitingIPHeader->ulSourceIPAddress )
+    /* When the ARP cache is hashed, vARPRefreshCacheEntry() has passed the
+     * packets waiting for this reply back to the IP-task. */
+    #if ( ipconfigUSE_ARP_HASH_TABLE == 0 )
         {
-            IPStackEvent_t xEventMessage;
-            const TickType_t xDontBlock = ( TickType_t ) 0;
+            if( pxARPWaitingNetworkBuffer != NULL )
+            {
+                IPPacket_t * pxARPWaitingIPPacket = ipCAST_PTR_TO_TYPE_PTR( IPPacket_t, pxARPWaitingNetworkBuffer->pucEthernetBuffer );
+                IPHeader_t * pxARPWaitingIPHeader = &( pxARPWaitingIPPacket->xIPHeader );
 
-            xEventMessage.eEventType = eNetworkRxEvent;
-            xEventMessage.pvData = ( void * ) pxARPWaitingNetworkBuffer;
+                if( ulSenderProtocolAddress == pxARPWaitingIPHeader->ulSourceIPAddress )
+                {
+                    IPStackEvent_t xEventMessage;
+                    const TickType_t xDontBlock = ( TickType_t ) 0;
 
-            if( xSendEventStructToIPTask( &xEventMessage, xDontBlock ) != pdPASS )
-            {
-                /* Failed to send the message, so release the network buffer. */
-                vReleaseNetworkBufferAndDescriptor( pxARPWaitingNetworkBuffer );
-            }
+                    xEventMessage.eEventType = eNetworkRxEvent;
+                    xEventMessage.pvData = ( void * ) pxARPWaitingNetworkBuffer;
+
+                    if( xSendEventStructToIPTask( &xEventMessage, xDontBlock ) != pdPASS )
+                    {
+                        /* Failed to send the message, so release the network buffer. */
+                        vReleaseNetworkBufferAndDescriptor( pxARPWaitingNetworkBuffer );
+                    }
 
-            /* Clear the buffer. */
-            pxARPWaitingNetworkBuffer = NULL;
+                    /* Clear the buffer. */
+                    pxARPWaitingNetworkBuffer = NULL;
 
-            /* Found an ARP resolution, disable ARP resolution timer. */
-            vIPSetARPResolutionTimerEnableState( pdFALSE );
+                    /* Found an ARP resolution, disable ARP resolution timer. */
+                    vIPSetARPResolutionTimerEnableState( pdFALSE );
 
-            iptrace_DELAYED_ARP_REQUEST_REPLIED();
+                    iptrace_DELAYED_ARP_REQUEST_REPLIED();
+                }
+            }
         }
-    }
+    #endif /* ipconfigUSE_ARP_HASH_TABLE == 0 */
 }
 
 /**
@@ -366,25 +494,39 @@ BaseType_t xIsIPInARPCache( uint32_t ulAddressToLookup )
 {
     BaseType_t x, xReturn = pdFALSE;
 
-    /* Loop through each entry in the ARP cache. */
-    for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
-    {
-        /* Does this row in the ARP cache table hold an entry for the IP address
-         * being queried? */
-        if( xARPCache[ x ].ulIPAddress == ulAddressToLookup )
+    #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
         {
-            xReturn = pdTRUE;
+            x = prvARPFindIPAddress( ulAddressToLookup );
 
-            /* A matching valid entry was found. */
-            if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
+            /* Entries waiting for an ARP reply are not valid. */
+            if( ( x >= 0 ) && ( xARPCache[ x ].ucValid != ( uint8_t ) pdFALSE ) )
             {
-                /* This entry is waiting an ARP reply, so is not valid. */
-                xReturn = pdFALSE;
+                xReturn = pdTRUE;
             }
+        }
+    #else /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+        {
+            /* Loop through each entry in the ARP cache. */
+            for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+            {
+                /* Does this row in the ARP cache table hold an entry for the IP address
+                 * being queried? */
+                if( xARPCache[ x ].ulIPAddress == ulAddressToLookup )
+                {
+                    xReturn = pdTRUE;
 
-            break;
+                    /* A matching valid entry was found. */
+                    if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
+                    {
+                        /* This entry is waiting an ARP reply, so is not valid. */
+                        xReturn = pdFALSE;
+                    }
+
+                    break;
+                }
+            }
         }
-    }
+    #endif /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
 
     return xReturn;
 }
@@ -408,6 +550,13 @@ BaseType_t xCheckRequiresARPResolution( NetworkBufferDescriptor_t * pxNetworkBuf
          * then we should send out ARP for finding the MAC address. */
         if( xIsIPInARPCache( pxIPHeader->ulSourceIPAddress ) == pdFALSE )
         {
+            #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+                {
+                    /* Reserve an entry, so that the packet can wait for the reply. */
+                    vARPRefreshCacheEntry( NULL, pxIPHeader->ulSourceIPAddress );
+                }
+            #endif
+
             FreeRTOS_OutputARPRequest( pxIPHeader->ulSourceIPAddress );
 
             /* This packet needs resolution since this is on the same subnet
@@ -435,16 +584,38 @@ BaseType_t xCheckRequiresARPResolution( NetworkBufferDescriptor_t * pxNetworkBuf
 
         configASSERT( pxMACAddress != NULL );
 
-        /* For each entry in the ARP cache table. */
-        for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
-        {
-            if( ( memcmp( xARPCache[ x ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 ) )
+        #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
             {
-                lResult = xARPCache[ x ].ulIPAddress;
-                ( void ) memset( &xARPCache[ x ], 0, sizeof( xARPCache[ x ] ) );
-                break;
+                /* Pass an IP-address that can not be in the table. */
+                x = prvARPFindMACAddress( pxMACAddress, 0U );
+
+                if( x >= 0 )
+                {
+                    lResult = xARPCache[ x ].ulIPAddress;
+                    prvARPClearRow( x );
+                }
             }
-        }
+        #else /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+            {
+                /* For each entry in the ARP cache table. */
+                for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+                {
+                    if( ( memcmp( xARPCache[ x ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 ) )
+                    {
+                        lResult = xARPCache[ x ].ulIPAddress;
+                        ( void ) memset( &xARPCache[ x ], 0, sizeof( xARPCache[ x ] ) );
+
+                        #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+                            {
+                                vARPInvalidateDestinations();
+                            }
+                        #endif
+
+                        break;
+                    }
+                }
+            }
+        #endif /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
 
         return lResult;
     }
@@ -452,184 +623,330 @@ BaseType_t xCheckRequiresARPResolution( NetworkBufferDescriptor_t * pxNetworkBuf
 #endif /* ipconfigUSE_ARP_REMOVE_ENTRY != 0 */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+
 /**
  * @brief Add/update the ARP cache entry MAC-address to IP-address mapping.
+ *        The entries are found through the hash tables, and a new entry
+ *        replaces the least recently refreshed one.  When the MAC-address
+ *        becomes known, the packets waiting for it are passed to the IP-task.
  *
  * @param[in] pxMACAddress: Pointer to the MAC address whose mapping is being
  *                          updated.
  * @param[in] ulIPAddress: 32-bit representation of the IP-address whose mapping
  *                         is being updated.
  */
-void vARPRefreshCacheEntry( const MACAddress_t * pxMACAddress,
-                            const uint32_t ulIPAddress )
-{
-    BaseType_t x = 0;
-    BaseType_t xIpEntry = -1;
-    BaseType_t xMacEntry = -1;
-    BaseType_t xUseEntry = 0;
-    BaseType_t xAllDone = pdFALSE;
-    uint8_t ucMinAgeFound = 0U;
-
-    #if ( ipconfigARP_STORES_REMOTE_ADDRESSES == 0 )
-        /* Only process the IP address if it is on the local network. */
-        if( ( ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) )
-    #else
-
-        /* If ipconfigARP_STORES_REMOTE_ADDRESSES is non-zero, IP addresses with
-         * a different netmask will also be stored.  After when replying to a UDP
-         * message from a different netmask, the IP address can be looped up and a
-         * reply sent.  This option is useful for systems with multiple gateways,
-         * the reply will surely arrive.  If ipconfigARP_STORES_REMOTE_ADDRESSES is
-         * zero the the gateway address is the only option. */
-
-        if( pdTRUE )
-    #endif
+    void vARPRefreshCacheEntry( const MACAddress_t * pxMACAddress,
+                                const uint32_t ulIPAddress )
     {
-        /* Start with the maximum possible number. */
-        ucMinAgeFound--;
+        BaseType_t xIpEntry;
+        BaseType_t xMacEntry = -1;
+        BaseType_t xUseEntry;
 
-        /* For each entry in the ARP cache table. */
-        for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+        #if ( ipconfigARP_STORES_REMOTE_ADDRESSES == 0 )
+            /* Only process the IP address if it is on the local network. */
+            if( ( ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) )
+        #else
+            if( pdTRUE )
+        #endif
         {
-            BaseType_t xMatchingMAC;
+            xIpEntry = prvARPFindIPAddress( ulIPAddress );
 
-            if( pxMACAddress != NULL )
+            if( pxMACAddress == NULL )
             {
-                if( memcmp( xARPCache[ x ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 )
-                {
-                    xMatchingMAC = pdTRUE;
-                }
-                else
+                if( xIpEntry < 0 )
                 {
-                    xMatchingMAC = pdFALSE;
+                    /* Reserve an entry to indicate that there is an outstanding
+                     * ARP request, This entry will have "ucValid == pdFALSE". */
+                    xUseEntry = prvARPAllocateRow();
+                    xARPCache[ xUseEntry ].ulIPAddress = ulIPAddress;
+                    xARPCache[ xUseEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_RETRANSMISSIONS;
+                    xARPCache[ xUseEntry ].ucValid = ( uint8_t ) pdFALSE;
+                    prvARPLinkIPAddress( xUseEntry );
+
+                    #if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+                        {
+                            prvARPWheelSchedule( xUseEntry );
+                        }
+                    #endif
                 }
             }
-            else
+            else if( ( xIpEntry >= 0 ) &&
+                     ( xARPCache[ xIpEntry ].ucValid != ( uint8_t ) pdFALSE ) &&
+                     ( memcmp( xARPCache[ xIpEntry ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 ) )
             {
-                xMatchingMAC = pdFALSE;
-            }
+                /* A perfect match is found, update the entry. */
+                xARPCache[ xIpEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
+                prvARPTouchRow( xIpEntry );
 
-            /* Does this line in the cache table hold an entry for the IP
-             * address being queried? */
-            if( xARPCache[ x ].ulIPAddress == ulIPAddress )
+                #if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+                    {
+                        prvARPWheelSchedule( xIpEntry );
+                    }
+                #endif
+            }
+            else
             {
-                if( pxMACAddress == NULL )
+                xMacEntry = prvARPFindMACAddress( pxMACAddress, ulIPAddress );
+
+                if( xMacEntry >= 0 )
                 {
-                    /* In case the parameter pxMACAddress is NULL, an entry will be reserved to
-                     * indicate that there is an outstanding ARP request, This entry will have
-                     * "ucValid == pdFALSE". */
-                    xIpEntry = x;
-                    break;
+                    /* The MAC-address is known with a different IP-address. */
+                    xUseEntry = xMacEntry;
+
+                    if( xIpEntry >= 0 )
+                    {
+                        /* Both the MAC address as well as the IP address were found in
+                         * different rows: clear the row which matches the IP-address.
+                         * Packets waiting for it can be sent now. */
+                        prvARPFlushPending( xIpEntry, pdTRUE );
+                        prvARPClearRow( xIpEntry );
+                    }
+
+                    prvARPUnlinkIPAddress( xUseEntry );
+                    xARPCache[ xUseEntry ].ulIPAddress = 0U;
                 }
+                else if( xIpEntry >= 0 )
+                {
+                    /* An entry containing the IP-address was found, but it had a different
+                     * MAC address, or it was waiting for an ARP reply. */
+                    xUseEntry = xIpEntry;
 
-                /* See if the MAC-address also matches. */
-                if( xMatchingMAC != pdFALSE )
+                    if( xARPCache[ xUseEntry ].ucValid != ( uint8_t ) pdFALSE )
+                    {
+                        prvARPUnlinkMACAddress( xUseEntry );
+                    }
+                }
+                else
                 {
-                    /* A perfect match is found, update the entry and leave this
-                     * function by setting 'xAllDone' to pdTRUE. */
-                    xARPCache[ x ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
-                    xARPCache[ x ].ucValid = ( uint8_t ) pdTRUE;
-                    xAllDone = pdTRUE;
-                    break;
+                    /* No matching entry found, use the least recently refreshed row. */
+                    xUseEntry = prvARPAllocateRow();
                 }
 
-                /* Found an entry containing ulIPAddress, but the MAC address
-                 * doesn't match.  Might be an entry with ucValid=pdFALSE, waiting
-                 * for an ARP reply.  Still want to see if there is match with the
-                 * given MAC address.ucBytes.  If found, either of the two entries
-                 * must be cleared. */
-                xIpEntry = x;
-            }
-            else if( xMatchingMAC != pdFALSE )
-            {
-                /* Found an entry with the given MAC-address, but the IP-address
-                 * is different.  Continue looping to find a possible match with
-                 * ulIPAddress. */
-                #if ( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 )
+                if( xARPCache[ xUseEntry ].ulIPAddress == 0U )
+                {
+                    xARPCache[ xUseEntry ].ulIPAddress = ulIPAddress;
+                    prvARPLinkIPAddress( xUseEntry );
+                }
 
-                    /* If ARP stores the MAC address of IP addresses outside the
-                     * network, than the MAC address of the gateway should not be
-                     * overwritten. */
-                    BaseType_t bIsLocal[ 2 ];
-                    bIsLocal[ 0 ] = ( ( xARPCache[ x ].ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) );
-                    bIsLocal[ 1 ] = ( ( ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) );
+                if( xUseEntry != xMacEntry )
+                {
+                    ( void ) memcpy( xARPCache[ xUseEntry ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) );
+                    prvARPLinkMACAddress( xUseEntry );
+                }
+
+                iptraceARP_TABLE_ENTRY_CREATED( ulIPAddress, ( *pxMACAddress ) );
+                /* And this entry does not need immediate attention */
+                xARPCache[ xUseEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
+                xARPCache[ xUseEntry ].ucValid = ( uint8_t ) pdTRUE;
+                prvARPTouchRow( xUseEntry );
 
-                    if( bIsLocal[ 0 ] == bIsLocal[ 1 ] )
+                #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
                     {
-                        xMacEntry = x;
+                        vARPInvalidateDestinations();
                     }
-                #else /* if ( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 ) */
-                    xMacEntry = x;
-                #endif /* if ( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 ) */
-            }
+                #endif
 
-            /* _HT_
-             * Shouldn't we test for xARPCache[ x ].ucValid == pdFALSE here ? */
-            else if( xARPCache[ x ].ucAge < ucMinAgeFound )
-            {
-                /* As the table is traversed, remember the table row that
-                 * contains the oldest entry (the lowest age count, as ages are
-                 * decremented to zero) so the row can be re-used if this function
-                 * needs to add an entry that does not already exist. */
-                ucMinAgeFound = xARPCache[ x ].ucAge;
-                xUseEntry = x;
-            }
-            else
-            {
-                /* Nothing happens to this cache entry for now. */
+                #if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+                    {
+                        prvARPWheelSchedule( xUseEntry );
+                    }
+                #endif
+
+                /* The packets waiting for this address can be processed. */
+                prvARPFlushPending( xUseEntry, pdTRUE );
             }
         }
+    }
+
+#else /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+
+/**
+ * @brief Add/update the ARP cache entry MAC-address to IP-address mapping.
+ *
+ * @param[in] pxMACAddress: Pointer to the MAC address whose mapping is being
+ *                          updated.
+ * @param[in] ulIPAddress: 32-bit representation of the IP-address whose mapping
+ *                         is being updated.
+ */
+    void vARPRefreshCacheEntry( const MACAddress_t * pxMACAddress,
+                                const uint32_t ulIPAddress )
+    {
+        BaseType_t x = 0;
+        BaseType_t xIpEntry = -1;
+        BaseType_t xMacEntry = -1;
+        BaseType_t xUseEntry = 0;
+        BaseType_t xAllDone = pdFALSE;
+        uint8_t ucMinAgeFound = 0U;
+
+        #if ( ipconfigARP_STORES_REMOTE_ADDRESSES == 0 )
+            /* Only process the IP address if it is on the local network. */
+            if( ( ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) )
+        #else
 
-        if( xAllDone == pdFALSE )
+            /* If ipconfigARP_STORES_REMOTE_ADDRESSES is non-zero, IP addresses with
+             * a different netmask will also be stored.  After when replying to a UDP
+             * message from a different netmask, the IP address can be looped up and a
+             * reply sent.  This option is useful for systems with multiple gateways,
+             * the reply will surely arrive.  If ipconfigARP_STORES_REMOTE_ADDRESSES is
+             * zero the the gateway address is the only option. */
+
+            if( pdTRUE )
+        #endif
         {
-            /* A perfect match was not found. See if either the MAC-address
-             * or the IP-address has a match. */
-            if( xMacEntry >= 0 )
+            /* Start with the maximum possible number. */
+            ucMinAgeFound--;
+
+            /* For each entry in the ARP cache table. */
+            for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
             {
-                xUseEntry = xMacEntry;
+                BaseType_t xMatchingMAC;
 
-                if( xIpEntry >= 0 )
+                if( pxMACAddress != NULL )
                 {
-                    /* Both the MAC address as well as the IP address were found in
-                     * different locations: clear the entry which matches the
-                     * IP-address */
-                    ( void ) memset( &( xARPCache[ xIpEntry ] ), 0, sizeof( ARPCacheRow_t ) );
+                    if( memcmp( xARPCache[ x ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 )
+                    {
+                        xMatchingMAC = pdTRUE;
+                    }
+                    else
+                    {
+                        xMatchingMAC = pdFALSE;
+                    }
+                }
+                else
+                {
+                    xMatchingMAC = pdFALSE;
                 }
-            }
-            else if( xIpEntry >= 0 )
-            {
-                /* An entry containing the IP-address was found, but it had a different MAC address */
-                xUseEntry = xIpEntry;
-            }
-            else
-            {
-                /* No matching entry found. */
-            }
 
-            /* If the entry was not found, we use the oldest entry and set the IPaddress */
-            xARPCache[ xUseEntry ].ulIPAddress = ulIPAddress;
+                /* Does this line in the cache table hold an entry for the IP
+                 * address being queried? */
+                if( xARPCache[ x ].ulIPAddress == ulIPAddress )
+                {
+                    if( pxMACAddress == NULL )
+                    {
+                        /* In case the parameter pxMACAddress is NULL, an entry will be reserved to
+                         * indicate that there is an outstanding ARP request, This entry will have
+                         * "ucValid == pdFALSE". */
+                        xIpEntry = x;
+                        break;
+                    }
 
-            if( pxMACAddress != NULL )
-            {
-                ( void ) memcpy( xARPCache[ xUseEntry ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) );
+                    /* See if the MAC-address also matches. */
+                    if( xMatchingMAC != pdFALSE )
+                    {
+                        /* A perfect match is found, update the entry and leave this
+                         * function by setting 'xAllDone' to pdTRUE. */
+                        xARPCache[ x ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
+                        xARPCache[ x ].ucValid = ( uint8_t ) pdTRUE;
+                        xAllDone = pdTRUE;
+                        break;
+                    }
 
-                iptraceARP_TABLE_ENTRY_CREATED( ulIPAddress, ( *pxMACAddress ) );
-                /* And this entry does not need immediate attention */
-                xARPCache[ xUseEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
-                xARPCache[ xUseEntry ].ucValid = ( uint8_t ) pdTRUE;
-            }
-            else if( xIpEntry < 0 )
-            {
-                xARPCache[ xUseEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_RETRANSMISSIONS;
-                xARPCache[ xUseEntry ].ucValid = ( uint8_t ) pdFALSE;
+                    /* Found an entry containing ulIPAddress, but the MAC address
+                     * doesn't match.  Might be an entry with ucValid=pdFALSE, waiting
+                     * for an ARP reply.  Still want to see if there is match with the
+                     * given MAC address.ucBytes.  If found, either of the two entries
+                     * must be cleared. */
+                    xIpEntry = x;
+                }
+                else if( xMatchingMAC != pdFALSE )
+                {
+                    /* Found an entry with the given MAC-address, but the IP-address
+                     * is different.  Continue looping to find a possible match with
+                     * ulIPAddress. */
+                    #if ( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 )
+
+                        /* If ARP stores the MAC address of IP addresses outside the
+                         * network, than the MAC address of the gateway should not be
+                         * overwritten. */
+                        BaseType_t bIsLocal[ 2 ];
+                        bIsLocal[ 0 ] = ( ( xARPCache[ x ].ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) );
+                        bIsLocal[ 1 ] = ( ( ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) );
+
+                        if( bIsLocal[ 0 ] == bIsLocal[ 1 ] )
+                        {
+                            xMacEntry = x;
+                        }
+                    #else /* if ( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 ) */
+                        xMacEntry = x;
+                    #endif /* if ( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 ) */
+                }
+
+                /* _HT_
+                 * Shouldn't we test for xARPCache[ x ].ucValid == pdFALSE here ? */
+                else if( xARPCache[ x ].ucAge < ucMinAgeFound )
+                {
+                    /* As the table is traversed, remember the table row that
+                     * contains the oldest entry (the lowest age count, as ages are
+                     * decremented to zero) so the row can be re-used if this function
+                     * needs to add an entry that does not already exist. */
+                    ucMinAgeFound = xARPCache[ x ].ucAge;
+                    xUseEntry = x;
+                }
+                else
+                {
+                    /* Nothing happens to this cache entry for now. */
+                }
             }
-            else
+
+            if( xAllDone == pdFALSE )
             {
-                /* Nothing will be stored. */
+                /* A perfect match was not found. See if either the MAC-address
+                 * or the IP-address has a match. */
+                if( xMacEntry >= 0 )
+                {
+                    xUseEntry = xMacEntry;
+
+                    if( xIpEntry >= 0 )
+                    {
+                        /* Both the MAC address as well as the IP address were found in
+                         * different locations: clear the entry which matches the
+                         * IP-address */
+                        ( void ) memset( &( xARPCache[ xIpEntry ] ), 0, sizeof( ARPCacheRow_t ) );
+                    }
+                }
+                else if( xIpEntry >= 0 )
+                {
+                    /* An entry containing the IP-address was found, but it had a different MAC address */
+                    xUseEntry = xIpEntry;
+                }
+                else
+                {
+                    /* No matching entry found. */
+                }
+
+                /* If the entry was not found, we use the oldest entry and set the IPaddress */
+                xARPCache[ xUseEntry ].ulIPAddress = ulIPAddress;
+
+                #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+                    {
+                        vARPInvalidateDestinations();
+                    }
+                #endif
+
+                if( pxMACAddress != NULL )
+                {
+                    ( void ) memcpy( xARPCache[ xUseEntry ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) );
+
+                    iptraceARP_TABLE_ENTRY_CREATED( ulIPAddress, ( *pxMACAddress ) );
+                    /* And this entry does not need immediate attention */
+                    xARPCache[ xUseEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
+                    xARPCache[ xUseEntry ].ucValid = ( uint8_t ) pdTRUE;
+                }
+                else if( xIpEntry < 0 )
+                {
+                    xARPCache[ xUseEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_RETRANSMISSIONS;
+                    xARPCache[ xUseEntry ].ucValid = ( uint8_t ) pdFALSE;
+                }
+                else
+                {
+                    /* Nothing will be stored. */
+                }
             }
         }
     }
-}
+
+#endif /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
 /*-----------------------------------------------------------*/
 
 #if ( ipconfigUSE_ARP_REVERSED_LOOKUP == 1 )
@@ -651,24 +968,39 @@ void vARPRefreshCacheEntry( const MACAddress_t * pxMACAddress,
         configASSERT( pxMACAddress != NULL );
         configASSERT( pulIPAddress != NULL );
 
-        /* Loop through each entry in the ARP cache. */
-        for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
-        {
-            /* Does this row in the ARP cache table hold an entry for the MAC
-             * address being searched? */
-            if( memcmp( pxMACAddress->ucBytes, xARPCache[ x ].xMACAddress.ucBytes, sizeof( MACAddress_t ) ) == 0 )
+        #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
             {
-                *pulIPAddress = xARPCache[ x ].ulIPAddress;
-                eReturn = eARPCacheHit;
-                break;
-            }
-        }
-
-        return eReturn;
-    }
-#endif /* ipconfigUSE_ARP_REVERSED_LOOKUP */
-
-/*-----------------------------------------------------------*/
+                /* Pass an IP-address that can not be in the table. */
+                x = prvARPFindMACAddress( pxMACAddress, 0U );
+
+                if( x >= 0 )
+                {
+                    *pulIPAddress = xARPCache[ x ].ulIPAddress;
+                    eReturn = eARPCacheHit;
+                }
+            }
+        #else /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+            {
+                /* Loop through each entry in the ARP cache. */
+                for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+                {
+                    /* Does this row in the ARP cache table hold an entry for the MAC
+                     * address being searched? */
+                    if( memcmp( pxMACAddress->ucBytes, xARPCache[ x ].xMACAddress.ucBytes, sizeof( MACAddress_t ) ) == 0 )
+                    {
+                        *pulIPAddress = xARPCache[ x ].ulIPAddress;
+                        eReturn = eARPCacheHit;
+                        break;
+                    }
+                }
+            }
+        #endif /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+
+        return eReturn;
+    }
+#endif /* ipconfigUSE_ARP_REVERSED_LOOKUP */
+
+/*-----------------------------------------------------------*/
 
 /**
  * @brief Look for ulIPAddress in the ARP cache.
@@ -807,15 +1139,15 @@ static eARPLookupResult_t prvCacheLookup( uint32_t ulAddressToLookup,
     BaseType_t x;
     eARPLookupResult_t eReturn = eARPCacheMiss;
 
-    /* Loop through each entry in the ARP cache. */
-    for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
-    {
-        /* Does this row in the ARP cache table hold an entry for the IP address
-         * being queried? */
-        if( xARPCache[ x ].ulIPAddress == ulAddressToLookup )
+    #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
         {
-            /* A matching valid entry was found. */
-            if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
+            x = prvARPFindIPAddress( ulAddressToLookup );
+
+            if( x < 0 )
+            {
+                /* Not found. */
+            }
+            else if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
             {
                 /* This entry is waiting an ARP reply, so is not valid. */
                 eReturn = eCantSendPacket;
@@ -826,15 +1158,95 @@ static eARPLookupResult_t prvCacheLookup( uint32_t ulAddressToLookup,
                 ( void ) memcpy( pxMACAddress->ucBytes, xARPCache[ x ].xMACAddress.ucBytes, sizeof( MACAddress_t ) );
                 eReturn = eARPCacheHit;
             }
+        }
+    #else /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+        {
+            /* Loop through each entry in the ARP cache. */
+            for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+            {
+                /* Does this row in the ARP cache table hold an entry for the IP address
+                 * being queried? */
+                if( xARPCache[ x ].ulIPAddress == ulAddressToLookup )
+                {
+                    /* A matching valid entry was found. */
+                    if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
+                    {
+                        /* This entry is waiting an ARP reply, so is not valid. */
+                        eReturn = eCantSendPacket;
+                    }
+                    else
+                    {
+                        /* A valid entry was found. */
+                        ( void ) memcpy( pxMACAddress->ucBytes, xARPCache[ x ].xMACAddress.ucBytes, sizeof( MACAddress_t ) );
+                        eReturn = eARPCacheHit;
+                    }
 
-            break;
+                    break;
+                }
+            }
         }
-    }
+    #endif /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
 
     return eReturn;
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Age one entry of the ARP cache by one period of the ARP timer.  An ARP
+ *        request is sent when the entry is waiting for a reply, or when it is
+ *        about to expire.  The entry is removed when its age reaches 0.
+ *
+ * @param[in] xEntry: The index of the entry in xARPCache[].
+ */
+static void prvARPAgeEntry( BaseType_t xEntry )
+{
+    /* Decrement the age value of the entry in this ARP cache table row.
+     * When the age reaches zero it is no longer considered valid. */
+    ( xARPCache[ xEntry ].ucAge )--;
+
+    /* If the entry is not yet valid, then it is waiting an ARP
+     * reply, and the ARP request should be retransmitted. */
+    if( xARPCache[ xEntry ].ucValid == ( uint8_t ) pdFALSE )
+    {
+        FreeRTOS_OutputARPRequest( xARPCache[ xEntry ].ulIPAddress );
+    }
+    else if( xARPCache[ xEntry ].ucAge <= ( uint8_t ) arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST )
+    {
+        /* This entry will get removed soon.  See if the MAC address is
+         * still valid to prevent this happening. */
+        iptraceARP_TABLE_ENTRY_WILL_EXPIRE( xARPCache[ xEntry ].ulIPAddress );
+        FreeRTOS_OutputARPRequest( xARPCache[ xEntry ].ulIPAddress );
+    }
+    else
+    {
+        /* The age has just ticked down, with nothing to do. */
+    }
+
+    if( xARPCache[ xEntry ].ucAge == 0U )
+    {
+        /* The entry is no longer valid.  Wipe it out. */
+        iptraceARP_TABLE_ENTRY_EXPIRED( xARPCache[ xEntry ].ulIPAddress );
+
+        #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+            {
+                /* Also releases the packets that waited for a reply. */
+                prvARPClearRow( xEntry );
+            }
+        #else
+            {
+                xARPCache[ xEntry ].ulIPAddress = 0U;
+
+                #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+                    {
+                        vARPInvalidateDestinations();
+                    }
+                #endif
+            }
+        #endif /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+    }
+}
+/*-----------------------------------------------------------*/
+
 /**
  * @brief A call to this function will update (or 'Age') the ARP cache entries.
  *        The function will also try to prevent a removal of entry by sending
@@ -845,45 +1257,28 @@ static eARPLookupResult_t prvCacheLookup( uint32_t ulAddressToLookup,
  */
 void vARPAgeCache( void )
 {
-    BaseType_t x;
     TickType_t xTimeNow;
 
-    /* Loop through each entry in the ARP cache. */
-    for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
-    {
-        /* If the entry is valid (its age is greater than zero). */
-        if( xARPCache[ x ].ucAge > 0U )
+    #if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
         {
-            /* Decrement the age value of the entry in this ARP cache table row.
-             * When the age reaches zero it is no longer considered valid. */
-            ( xARPCache[ x ].ucAge )--;
-
-            /* If the entry is not yet valid, then it is waiting an ARP
-             * reply, and the ARP request should be retransmitted. */
-            if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
-            {
-                FreeRTOS_OutputARPRequest( xARPCache[ x ].ulIPAddress );
-            }
-            else if( xARPCache[ x ].ucAge <= ( uint8_t ) arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST )
-            {
-                /* This entry will get removed soon.  See if the MAC address is
-                 * still valid to prevent this happening. */
-                iptraceARP_TABLE_ENTRY_WILL_EXPIRE( xARPCache[ x ].ulIPAddress );
-                FreeRTOS_OutputARPRequest( xARPCache[ x ].ulIPAddress );
-            }
-            else
-            {
-                /* The age has just ticked down, with nothing to do. */
-            }
+            /* Only the entries that are due in this period are visited. */
+            prvARPWheelAdvance();
+        }
+    #else
+        {
+            BaseType_t x;
 
-            if( xARPCache[ x ].ucAge == 0U )
+            /* Loop through each entry in the ARP cache. */
+            for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
             {
-                /* The entry is no longer valid.  Wipe it out. */
-                iptraceARP_TABLE_ENTRY_EXPIRED( xARPCache[ x ].ulIPAddress );
-                xARPCache[ x ].ulIPAddress = 0U;
+                /* If the entry is valid (its age is greater than zero). */
+                if( xARPCache[ x ].ucAge > 0U )
+                {
+                    prvARPAgeEntry( x );
+                }
             }
         }
-    }
+    #endif /* if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 ) */
 
     xTimeNow = xTaskGetTickCount();
 
@@ -1112,14 +1507,751 @@ void vARPGenerateRequestPacket( NetworkBufferDescriptor_t * const pxNetworkBuffe
 /*-----------------------------------------------------------*/
 
 /**
- * @brief A call to this function will clear the ARP cache.
+ * @brief A call to this function will clear the ARP cache.  When the cache is
+ *        hashed, the cache, and the tables and queues that belong to it, are
+ *        only changed by the IP-task.  When another task calls this function
+ *        while the IP-task is running, the IP-task is asked to clear the cache,
+ *        and this function returns as soon as the request has been queued.
  */
 void FreeRTOS_ClearARP( void )
 {
+    #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+        {
+            IPStackEvent_t xEventMessage;
+
+            if( ( xIPIsNetworkTaskReady() != pdFALSE ) && ( xIsCallingFromIPTask() == pdFALSE ) )
+            {
+                xEventMessage.eEventType = eARPClearEvent;
+                xEventMessage.pvData = NULL;
+
+                /* Wait for space in the queue: the request may not get lost. */
+                ( void ) xSendEventStructToIPTask( &xEventMessage, portMAX_DELAY );
+            }
+            else
+            {
+                vARPClearCache();
+            }
+        }
+    #else
+        {
+            /* Only the array must be cleared, which is done immediately. */
+            vARPClearCache();
+        }
+    #endif /* ipconfigUSE_ARP_HASH_TABLE */
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Clear the ARP cache.  Packets that are waiting for an address
+ *        resolution are released.  Called from the IP-task, or before the
+ *        IP-task has started.
+ */
+void vARPClearCache( void )
+{
+    #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+        {
+            BaseType_t x;
+
+            if( uxARPPendingPackets != 0U )
+            {
+                for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+                {
+                    prvARPFlushPending( x, pdFALSE );
+                }
+            }
+
+            ( void ) memset( usARPIPBuckets, 0, sizeof( usARPIPBuckets ) );
+            ( void ) memset( usARPMACBuckets, 0, sizeof( usARPMACBuckets ) );
+            xARPHashReady = pdFALSE;
+
+            #if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+                {
+                    ( void ) memset( usARPWheelSlots, 0, sizeof( usARPWheelSlots ) );
+                }
+            #endif
+        }
+    #endif /* ipconfigUSE_ARP_HASH_TABLE */
+
     ( void ) memset( xARPCache, 0, sizeof( xARPCache ) );
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        {
+            vARPInvalidateDestinations();
+        }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+
+/**
+ * @brief Get the generation of the ARP cache and the address configuration.  A
+ *        socket may use a MAC-address that it stored, as long as the generation
+ *        did not change.
+ *
+ * @return A non-zero number that changes every time that a stored MAC-address
+ *         might have become invalid.
+ */
+    uint32_t ulARPGetGeneration( void )
+    {
+        return ulARPGeneration;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Invalidate all MAC-addresses that are stored by sockets.  Called when
+ *        an entry of the ARP cache changes or disappears, and when the address
+ *        configuration changes.  The latter may be done by any task, so the
+ *        generation is incremented within a critical section.
+ */
+    void vARPInvalidateDestinations( void )
+    {
+        uint32_t ulGeneration;
+
+        taskENTER_CRITICAL();
+        {
+            ulGeneration = ulARPGeneration + 1U;
+
+            if( ulGeneration == 0U )
+            {
+                /* Zero means: not valid. */
+                ulGeneration = 1U;
+            }
+
+            ulARPGeneration = ulGeneration;
+        }
+        taskEXIT_CRITICAL();
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_DESTINATION_CACHE */
+
+#if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+
+/**
+ * @brief Calculate the hash bucket of an IP-address.  All octets are folded,
+ *        so that the result does not depend on the byte order.
+ *
+ * @param[in] ulIPAddress: The IP-address.
+ *
+ * @return The index in usARPIPBuckets[].
+ */
+    static size_t prvARPHashIPAddress( uint32_t ulIPAddress )
+    {
+        uint32_t ulHash = ulIPAddress ^ ( ulIPAddress >> 16 );
+
+        ulHash ^= ulHash >> 8;
+
+        return ( size_t ) ( ulHash & ( ( uint32_t ) ipconfigARP_HASH_BUCKETS - 1U ) );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate the hash bucket of a MAC-address.  The last octets are the
+ *        most specific for a device.
+ *
+ * @param[in] pxMACAddress: The MAC-address.
+ *
+ * @return The index in usARPMACBuckets[].
+ */
+    static size_t prvARPHashMACAddress( const MACAddress_t * pxMACAddress )
+    {
+        uint32_t ulHash = ( ( uint32_t ) pxMACAddress->ucBytes[ 3 ] << 8 ) ^
+                          ( ( uint32_t ) pxMACAddress->ucBytes[ 4 ] << 4 ) ^
+                          ( uint32_t ) pxMACAddress->ucBytes[ 5 ];
+
+        return ( size_t ) ( ulHash & ( ( uint32_t ) ipconfigARP_HASH_BUCKETS - 1U ) );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the row that holds a given IP-address.
+ *
+ * @param[in] ulIPAddress: The IP-address to look for.
+ *
+ * @return The index of the row, or -1 when the IP-address was not found.
+ */
+    static BaseType_t prvARPFindIPAddress( uint32_t ulIPAddress )
+    {
+        BaseType_t xReturn = -1;
+        uint16_t usRow = arpNO_ROW;
+
+        if( ulIPAddress != 0U )
+        {
+            usRow = usARPIPBuckets[ prvARPHashIPAddress( ulIPAddress ) ];
+        }
+
+        while( usRow != arpNO_ROW )
+        {
+            if( xARPCache[ usRow - 1U ].ulIPAddress == ulIPAddress )
+            {
+                xReturn = ( BaseType_t ) usRow - 1;
+                break;
+            }
+
+            usRow = xARPCache[ usRow - 1U ].usNextIP;
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find a row with a valid MAC-address, but with another IP-address.
+ *
+ * @param[in] pxMACAddress: The MAC-address to look for.
+ * @param[in] ulIPAddress: The IP-address that the row must not have.
+ *
+ * @return The index of the row, or -1 when the MAC-address was not found.
+ */
+    static BaseType_t prvARPFindMACAddress( const MACAddress_t * pxMACAddress,
+                                            uint32_t ulIPAddress )
+    {
+        BaseType_t xReturn = -1;
+        uint16_t usRow = usARPMACBuckets[ prvARPHashMACAddress( pxMACAddress ) ];
+        const ARPCacheRow_t * pxRow;
+
+        while( usRow != arpNO_ROW )
+        {
+            pxRow = &( xARPCache[ usRow - 1U ] );
+
+            if( ( pxRow->ulIPAddress != ulIPAddress ) &&
+                ( memcmp( pxRow->xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 ) )
+            {
+                #if ( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 )
+
+                    /* If ARP stores the MAC address of IP addresses outside the
+                     * network, than the MAC address of the gateway should not be
+                     * overwritten. */
+                    BaseType_t bIsLocal[ 2 ];
+                    bIsLocal[ 0 ] = ( ( pxRow->ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) );
+                    bIsLocal[ 1 ] = ( ( ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) );
+
+                    /* A look-up by MAC-address only passes zero as IP-address. */
+                    if( ( ulIPAddress == 0U ) || ( bIsLocal[ 0 ] == bIsLocal[ 1 ] ) )
+                #endif /* if ( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 ) */
+                {
+                    xReturn = ( BaseType_t ) usRow - 1;
+                    break;
+                }
+            }
+
+            usRow = pxRow->usNextMAC;
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Add a row to the bucket of its IP-address.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPLinkIPAddress( BaseType_t xEntry )
+    {
+        size_t uxBucket = prvARPHashIPAddress( xARPCache[ xEntry ].ulIPAddress );
+
+        xARPCache[ xEntry ].usNextIP = usARPIPBuckets[ uxBucket ];
+        usARPIPBuckets[ uxBucket ] = ( uint16_t ) ( xEntry + 1 );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove a row from the bucket of its IP-address.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPUnlinkIPAddress( BaseType_t xEntry )
+    {
+        uint16_t * pusLink = &( usARPIPBuckets[ prvARPHashIPAddress( xARPCache[ xEntry ].ulIPAddress ) ] );
+
+        while( *pusLink != arpNO_ROW )
+        {
+            if( *pusLink == ( uint16_t ) ( xEntry + 1 ) )
+            {
+                *pusLink = xARPCache[ xEntry ].usNextIP;
+                break;
+            }
+
+            pusLink = &( xARPCache[ *pusLink - 1U ].usNextIP );
+        }
+
+        xARPCache[ xEntry ].usNextIP = arpNO_ROW;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Add a row to the bucket of its MAC-address.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPLinkMACAddress( BaseType_t xEntry )
+    {
+        size_t uxBucket = prvARPHashMACAddress( &( xARPCache[ xEntry ].xMACAddress ) );
+
+        xARPCache[ xEntry ].usNextMAC = usARPMACBuckets[ uxBucket ];
+        usARPMACBuckets[ uxBucket ] = ( uint16_t ) ( xEntry + 1 );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove a row from the bucket of its MAC-address.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPUnlinkMACAddress( BaseType_t xEntry )
+    {
+        uint16_t * pusLink = &( usARPMACBuckets[ prvARPHashMACAddress( &( xARPCache[ xEntry ].xMACAddress ) ) ] );
+
+        while( *pusLink != arpNO_ROW )
+        {
+            if( *pusLink == ( uint16_t ) ( xEntry + 1 ) )
+            {
+                *pusLink = xARPCache[ xEntry ].usNextMAC;
+                break;
+            }
+
+            pusLink = &( xARPCache[ *pusLink - 1U ].usNextMAC );
+        }
+
+        xARPCache[ xEntry ].usNextMAC = arpNO_ROW;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a row out of the list that is ordered by the time of refreshing.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPRemoveFromAgeList( BaseType_t xEntry )
+    {
+        uint16_t usNewer = xARPCache[ xEntry ].usNewer;
+        uint16_t usOlder = xARPCache[ xEntry ].usOlder;
+
+        if( usNewer == arpNO_ROW )
+        {
+            usARPNewestRow = usOlder;
+        }
+        else
+        {
+            xARPCache[ usNewer - 1U ].usOlder = usOlder;
+        }
+
+        if( usOlder == arpNO_ROW )
+        {
+            usARPOldestRow = usNewer;
+        }
+        else
+        {
+            xARPCache[ usOlder - 1U ].usNewer = usNewer;
+        }
+
+        xARPCache[ xEntry ].usNewer = arpNO_ROW;
+        xARPCache[ xEntry ].usOlder = arpNO_ROW;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Mark a row as the most recently refreshed one.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPTouchRow( BaseType_t xEntry )
+    {
+        uint16_t usRow = ( uint16_t ) ( xEntry + 1 );
+
+        if( usARPNewestRow != usRow )
+        {
+            prvARPRemoveFromAgeList( xEntry );
+
+            xARPCache[ xEntry ].usOlder = usARPNewestRow;
+
+            if( usARPNewestRow == arpNO_ROW )
+            {
+                usARPOldestRow = usRow;
+            }
+            else
+            {
+                xARPCache[ usARPNewestRow - 1U ].usNewer = usRow;
+            }
+
+            usARPNewestRow = usRow;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove a row from the hash tables, release the packets that are waiting
+ *        for it, and make it the first candidate for re-use.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPClearRow( BaseType_t xEntry )
+    {
+        ARPCacheRow_t * pxRow = &( xARPCache[ xEntry ] );
+        uint16_t usRow = ( uint16_t ) ( xEntry + 1 );
+
+        if( pxRow->ulIPAddress != 0U )
+        {
+            prvARPUnlinkIPAddress( xEntry );
+        }
+
+        if( pxRow->ucValid != ( uint8_t ) pdFALSE )
+        {
+            prvARPUnlinkMACAddress( xEntry );
+        }
+
+        prvARPFlushPending( xEntry, pdFALSE );
+
+        #if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+            {
+                prvARPWheelRemove( xEntry );
+            }
+        #endif
+
+        #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+            {
+                if( pxRow->ucValid != ( uint8_t ) pdFALSE )
+                {
+                    vARPInvalidateDestinations();
+                }
+            }
+        #endif
+
+        pxRow->ulIPAddress = 0U;
+        ( void ) memset( pxRow->xMACAddress.ucBytes, 0, sizeof( pxRow->xMACAddress.ucBytes ) );
+        pxRow->ucAge = 0U;
+        pxRow->ucValid = ( uint8_t ) pdFALSE;
+
+        if( usARPOldestRow != usRow )
+        {
+            prvARPRemoveFromAgeList( xEntry );
+
+            pxRow->usNewer = usARPOldestRow;
+
+            if( usARPOldestRow == arpNO_ROW )
+            {
+                usARPNewestRow = usRow;
+            }
+            else
+            {
+                xARPCache[ usARPOldestRow - 1U ].usOlder = usRow;
+            }
+
+            usARPOldestRow = usRow;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Take the least recently refreshed row.  The first time, all rows are
+ *        linked in the list that is ordered by the time of refreshing.
+ *
+ * @return The index of an empty row, which is marked as the most recently
+ *         refreshed one.
+ */
+    static BaseType_t prvARPAllocateRow( void )
+    {
+        BaseType_t x;
+
+        if( xARPHashReady == pdFALSE )
+        {
+            for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+            {
+                xARPCache[ x ].usNewer = ( uint16_t ) x;
+                xARPCache[ x ].usOlder = ( x < ( ipconfigARP_CACHE_ENTRIES - 1 ) ) ? ( uint16_t ) ( x + 2 ) : arpNO_ROW;
+            }
+
+            usARPNewestRow = 1U;
+            usARPOldestRow = ( uint16_t ) ipconfigARP_CACHE_ENTRIES;
+            xARPHashReady = pdTRUE;
+        }
+
+        x = ( BaseType_t ) usARPOldestRow - 1;
+
+        if( ( xARPCache[ x ].ulIPAddress != 0U ) || ( xARPCache[ x ].ucValid != ( uint8_t ) pdFALSE ) )
+        {
+            prvARPClearRow( x );
+        }
+
+        prvARPTouchRow( x );
+
+        return x;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Pass the packets that are waiting for an ARP reply back to the IP-task,
+ *        or release them.
+ *
+ * @param[in] xEntry: The index of the row.
+ * @param[in] xResolved: pdTRUE if the MAC-address is known now, pdFALSE if the
+ *                       packets must be released.
+ */
+    static void prvARPFlushPending( BaseType_t xEntry,
+                                    BaseType_t xResolved )
+    {
+        ARPCacheRow_t * pxRow = &( xARPCache[ xEntry ] );
+        NetworkBufferDescriptor_t * pxBuffer;
+        IPStackEvent_t xEventMessage;
+        UBaseType_t uxIndex;
+        BaseType_t xSent;
+
+        for( uxIndex = 0U; uxIndex < ( UBaseType_t ) pxRow->ucPendingCount; uxIndex++ )
+        {
+            pxBuffer = pxRow->pxPending[ uxIndex ];
+            pxRow->pxPending[ uxIndex ] = NULL;
+            xSent = pdFALSE;
+
+            if( xResolved != pdFALSE )
+            {
+                /* A received packet will be processed again, a packet to be sent
+                 * will pass vProcessGeneratedUDPPacket() again. */
+                if( ( pxRow->ucPendingOutgoing & ( uint8_t ) ( 1U << uxIndex ) ) != 0U )
+                {
+                    xEventMessage.eEventType = eStackTxEvent;
+                }
+                else
+                {
+                    xEventMessage.eEventType = eNetworkRxEvent;
+                }
+
+                xEventMessage.pvData = ( void * ) pxBuffer;
+
+                if( xSendEventStructToIPTask( &xEventMessage, ( TickType_t ) 0 ) == pdPASS )
+                {
+                    xSent = pdTRUE;
+                }
+            }
+
+            if( xSent == pdFALSE )
+            {
+                vReleaseNetworkBufferAndDescriptor( pxBuffer );
+            }
+        }
+
+        if( pxRow->ucPendingCount != 0U )
+        {
+            if( xResolved != pdFALSE )
+            {
+                iptrace_DELAYED_ARP_REQUEST_REPLIED();
+            }
+
+            uxARPPendingPackets -= ( UBaseType_t ) pxRow->ucPendingCount;
+            pxRow->ucPendingCount = 0U;
+            pxRow->ucPendingOutgoing = 0U;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Let a packet wait for the ARP reply from a given IP-address.  An ARP
+ *        request must be outstanding for that address.
+ *
+ * @param[in] ulIPAddress: The IP-address whose MAC-address is needed.
+ * @param[in] pxNetworkBuffer: The packet that has to wait.
+ * @param[in] xIsOutgoing: pdTRUE for a packet to be sent, pdFALSE for a packet
+ *                         that was received.
+ *
+ * @return pdTRUE if the packet was queued, pdFALSE if the caller still owns it.
+ */
+    BaseType_t xARPQueuePendingPacket( uint32_t ulIPAddress,
+                                       NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                       BaseType_t xIsOutgoing )
+    {
+        BaseType_t x = prvARPFindIPAddress( ulIPAddress );
+        BaseType_t xReturn = pdFALSE;
+        ARPCacheRow_t * pxRow;
+
+        if( ( x >= 0 ) && ( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE ) )
+        {
+            pxRow = &( xARPCache[ x ] );
+
+            if( pxRow->ucPendingCount < ( uint8_t ) ipconfigARP_PENDING_QUEUE_LENGTH )
+            {
+                if( pxRow->ucPendingCount == 0U )
+                {
+                    pxRow->xPendingTime = xTaskGetTickCount();
+                }
+
+                if( xIsOutgoing != pdFALSE )
+                {
+                    pxRow->ucPendingOutgoing |= ( uint8_t ) ( 1U << pxRow->ucPendingCount );
+                }
+
+                pxRow->pxPending[ pxRow->ucPendingCount ] = pxNetworkBuffer;
+                pxRow->ucPendingCount++;
+                uxARPPendingPackets++;
+
+                /* Let the IP-task check for packets that waited too long. */
+                vIPSetARPResolutionTimerEnableState( pdTRUE );
+                xReturn = pdTRUE;
+            }
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Release the packets that have been waiting too long for an ARP reply.
+ *
+ * @param[in] xMaxDelay: The maximum time that a packet may wait, in clock ticks.
+ *
+ * @return pdTRUE if there are still packets waiting.
+ */
+    BaseType_t xARPCheckPendingPackets( TickType_t xMaxDelay )
+    {
+        BaseType_t x;
+        TickType_t xNow = xTaskGetTickCount();
+
+        for( x = 0; ( x < ipconfigARP_CACHE_ENTRIES ) && ( uxARPPendingPackets != 0U ); x++ )
+        {
+            if( ( xARPCache[ x ].ucPendingCount != 0U ) &&
+                ( ( xNow - xARPCache[ x ].xPendingTime ) >= xMaxDelay ) )
+            {
+                iptraceDELAYED_ARP_TIMER_EXPIRED();
+                prvARPFlushPending( x, pdFALSE );
+            }
+        }
+
+        return ( uxARPPendingPackets != 0U ) ? pdTRUE : pdFALSE;
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_ARP_HASH_TABLE */
+
+#if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+
+/**
+ * @brief Schedule the next moment at which an entry needs attention from the ARP
+ *        timer.  An entry that waits for a reply, or that is about to expire, is
+ *        visited every period.  Otherwise nothing happens until the age drops to
+ *        arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST, which is brought forward by up to
+ *        ipconfigARP_AGE_JITTER periods.  That way entries that were learnt at the
+ *        same moment will not all be refreshed in the same period.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPWheelSchedule( BaseType_t xEntry )
+    {
+        ARPCacheRow_t * pxRow = &( xARPCache[ xEntry ] );
+        uint32_t ulDelay = 1U;
+        uint32_t ulJitter;
+        size_t uxSlot;
+
+        prvARPWheelRemove( xEntry );
+
+        if( pxRow->ucAge > 0U )
+        {
+            if( ( pxRow->ucValid != ( uint8_t ) pdFALSE ) &&
+                ( pxRow->ucAge > ( uint8_t ) ( arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST + 1 ) ) )
+            {
+                ulDelay = ( uint32_t ) pxRow->ucAge - ( uint32_t ) arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST;
+
+                /* The IP-address and the current time give enough variation
+                 * between entries, without calling the random number generator
+                 * for every refresh. */
+                ulJitter = ( pxRow->ulIPAddress ^ ( pxRow->ulIPAddress >> 16 ) ^ ( uint32_t ) usARPWheelTime ) %
+                           ( ( uint32_t ) ipconfigARP_AGE_JITTER + 1U );
+
+                if( ulJitter >= ulDelay )
+                {
+                    ulJitter = ulDelay - 1U;
+                }
+
+                ulDelay -= ulJitter;
+
+                /* The age that the entry will have when it is visited, so that
+                 * prvARPAgeEntry() sends the first ARP request. */
+                pxRow->ucAge = ( uint8_t ) ( arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST + 1 );
+            }
+
+            pxRow->usWheelDue = ( uint16_t ) ( usARPWheelTime + ( uint16_t ) ulDelay );
+            uxSlot = ( size_t ) pxRow->usWheelDue & ( ( size_t ) ipconfigARP_TIMER_WHEEL_SLOTS - 1U );
+
+            pxRow->usWheelPrev = arpNO_ROW;
+            pxRow->usWheelNext = usARPWheelSlots[ uxSlot ];
+
+            if( pxRow->usWheelNext != arpNO_ROW )
+            {
+                xARPCache[ pxRow->usWheelNext - 1U ].usWheelPrev = ( uint16_t ) ( xEntry + 1 );
+            }
+
+            usARPWheelSlots[ uxSlot ] = ( uint16_t ) ( xEntry + 1 );
+            pxRow->ucInWheel = ( uint8_t ) pdTRUE;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Take an entry out of the timer wheel, if it is in there.
+ *
+ * @param[in] xEntry: The index of the row.
+ */
+    static void prvARPWheelRemove( BaseType_t xEntry )
+    {
+        ARPCacheRow_t * pxRow = &( xARPCache[ xEntry ] );
+
+        if( pxRow->ucInWheel != ( uint8_t ) pdFALSE )
+        {
+            if( pxRow->usWheelPrev == arpNO_ROW )
+            {
+                usARPWheelSlots[ ( size_t ) pxRow->usWheelDue & ( ( size_t ) ipconfigARP_TIMER_WHEEL_SLOTS - 1U ) ] = pxRow->usWheelNext;
+            }
+            else
+            {
+                xARPCache[ pxRow->usWheelPrev - 1U ].usWheelNext = pxRow->usWheelNext;
+            }
+
+            if( pxRow->usWheelNext != arpNO_ROW )
+            {
+                xARPCache[ pxRow->usWheelNext - 1U ].usWheelPrev = pxRow->usWheelPrev;
+            }
+
+            pxRow->usWheelNext = arpNO_ROW;
+            pxRow->usWheelPrev = arpNO_ROW;
+            pxRow->ucInWheel = ( uint8_t ) pdFALSE;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Move the timer wheel one period of the ARP timer forward.  Only the
+ *        slot of the new period is visited.  It may also hold entries that are
+ *        due one or more turns of the wheel later, those are left alone.
+ */
+    static void prvARPWheelAdvance( void )
+    {
+        uint16_t usRow;
+        BaseType_t xEntry;
+
+        usARPWheelTime++;
+        usRow = usARPWheelSlots[ ( size_t ) usARPWheelTime & ( ( size_t ) ipconfigARP_TIMER_WHEEL_SLOTS - 1U ) ];
+
+        while( usRow != arpNO_ROW )
+        {
+            xEntry = ( BaseType_t ) usRow - 1;
+            usRow = xARPCache[ xEntry ].usWheelNext;
+
+            if( xARPCache[ xEntry ].usWheelDue == usARPWheelTime )
+            {
+                prvARPAgeEntry( xEntry );
+
+                /* An entry that has expired was cleared and taken out of the
+                 * wheel already. */
+                if( xARPCache[ xEntry ].ucAge > 0U )
+                {
+                    prvARPWheelSchedule( xEntry );
+                }
+            }
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_ARP_TIMER_WHEEL */
+
 #if 1
 
 /**
@@ -133,6 +133,38 @@
         static void prvPrepareLinkLayerIPLookUp( void );
     #endif
 
+/*
+ * Check if the address of a previous lease is known, either from memory or from
+ * the application.  If so, prepare to request it with an INIT-REBOOT request.
+ */
+    #if ( ipconfigDHCP_STORE_LEASE != 0 )
+        static BaseType_t prvPrepareInitReboot( void );
+
+/*
+ * Pass the lease that was just acknowledged to the application, or tell it to
+ * forget the lease when the parameter is pdFALSE.
+ */
+        static void prvSaveLease( BaseType_t xValid );
+
+/*
+ * The INIT-REBOOT request was not answered.
+ */
+        static void prvInitRebootTimedOut( void );
+    #endif
+
+/*
+ * Start using the address that was acknowledged by the DHCP server.
+ */
+    static void prvUseLeasedAddress( void );
+
+/*
+ * Another device uses the address that was leased: send a decline message to
+ * the DHCP server, and start again after a while.
+ */
+    #if ( ipconfigDHCP_CHECK_ADDRESS_CONFLICT != 0 )
+        static void prvDeclineLeasedAddress( void );
+    #endif
+
 /*-----------------------------------------------------------*/
 
 /** @brief Hold information in between steps in the DHCP state machine. */
@@ -252,6 +284,26 @@
                             /* Send the first discover request. */
                             EP_DHCPData.xDHCPTxTime = xTaskGetTickCount();
 
+                            #if ( ipconfigDHCP_STORE_LEASE != 0 )
+                                if( prvPrepareInitReboot() != pdFALSE )
+                                {
+                                    /* The address of the previous lease is requested
+                                     * directly, skipping the discover and the offer. */
+                                    if( prvSendDHCPRequest() == pdPASS )
+                                    {
+                                        EP_DHCPData.xDHCPTxPeriod = dhcpINITIAL_DHCP_TX_PERIOD;
+                                        EP_DHCPData.eDHCPState = eWaitingAcknowledge;
+                                    }
+                                    else
+                                    {
+                                        /* Either the creation of a message buffer failed, or sendto().
+                                         * Try again in the next cycle. */
+                                        FreeRTOS_debug_printf( ( "Send failed during eWaitingSendFirstDiscover/INIT-REBOOT\n" ) );
+                                    }
+                                }
+                                else
+                            #endif /* ipconfigDHCP_STORE_LEASE */
+
                             if( prvSendDHCPDiscover() == pdPASS )
                             {
                                 EP_DHCPData.eDHCPState = eWaitingOffer;
@@ -311,6 +363,17 @@
                             if( eAnswer == eDHCPContinue )
                         #endif /* ipconfigUSE_DHCP_HOOK */
                         {
+                            #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+                                if( EP_DHCPData.xRapidCommit != pdFALSE )
+                                {
+                                    /* The server answered with an ACK, the lease has
+                                     * been committed already. */
+                                    FreeRTOS_debug_printf( ( "vDHCPProcess: rapid commit %xip\n", ( unsigned ) FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
+                                    prvUseLeasedAddress();
+                                    break;
+                                }
+                            #endif /* ipconfigDHCP_USE_RAPID_COMMIT */
+
                             /* An offer has been made, the user wants to continue,
                              * generate the request. */
                             if( prvSendDHCPRequest() == pdPASS )
@@ -417,42 +480,7 @@
                     if( prvProcessDHCPReplies( dhcpMESSAGE_TYPE_ACK ) == pdPASS )
                     {
                         FreeRTOS_debug_printf( ( "vDHCPProcess: acked %xip\n", ( unsigned ) FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
-
-                        /* DHCP completed.  The IP address can now be used, and the
-                         * timer set to the lease timeout time. */
-                        *ipLOCAL_IP_ADDRESS_POINTER = EP_DHCPData.ulOfferedIPAddress;
-
-                        /* Setting the 'local' broadcast address, something like
-                         * '192.168.1.255'. */
-                        EP_IPv4_SETTINGS.ulBroadcastAddress = ( EP_DHCPData.ulOfferedIPAddress & xNetworkAddressing.ulNetMask ) | ~xNetworkAddressing.ulNetMask;
-                        EP_DHCPData.eDHCPState = eLeasedAddress;
-
-                        iptraceDHCP_SUCCEDEED( EP_DHCPData.ulOfferedIPAddress );
-
-                        /* DHCP failed, the default configured IP-address will be used
-                         * Now call vIPNetworkUpCalls() to send the network-up event and
-                         * start the ARP timer. */
-                        vIPNetworkUpCalls();
-
-                        /* Close socket to ensure packets don't queue on it. */
-                        prvCloseDHCPSocket();
-
-                        if( EP_DHCPData.ulLeaseTime == 0U )
-                        {
-                            EP_DHCPData.ulLeaseTime = ( uint32_t ) dhcpDEFAULT_LEASE_TIME;
-                        }
-                        else if( EP_DHCPData.ulLeaseTime < dhcpMINIMUM_LEASE_TIME )
-                        {
-                            EP_DHCPData.ulLeaseTime = dhcpMINIMUM_LEASE_TIME;
-                        }
-                        else
-                        {
-                            /* The lease time is already valid. */
-                        }
-
-                        /* Check for clashes. */
-                        vARPSendGratuitous();
-                        vIPReloadDHCPTimer( EP_DHCPData.ulLeaseTime );
+                        prvUseLeasedAddress();
                     }
                     else
                     {
@@ -463,6 +491,17 @@
                              * point of giving up - send another request. */
                             EP_DHCPData.xDHCPTxPeriod <<= 1;
 
+                            #if ( ipconfigDHCP_STORE_LEASE != 0 )
+                                if( ( EP_DHCPData.xInitReboot != pdFALSE ) &&
+                                    ( EP_DHCPData.xDHCPTxPeriod > dhcpINIT_REBOOT_MAX_TX_PERIOD ) )
+                                {
+                                    /* A server that does not know the lease stays silent,
+                                     * so don't wait long for an answer. */
+                                    prvInitRebootTimedOut();
+                                }
+                                else
+                            #endif /* ipconfigDHCP_STORE_LEASE */
+
                             if( EP_DHCPData.xDHCPTxPeriod <= ( TickType_t ) ipconfigMAXIMUM_DISCOVER_TX_PERIOD )
                             {
                                 EP_DHCPData.xDHCPTxTime = xTaskGetTickCount();
@@ -518,6 +557,29 @@
                             break;
                     #endif /* ipconfigDHCP_FALL_BACK_AUTO_IP */
 
+                    #if ( ipconfigDHCP_CHECK_ADDRESS_CONFLICT != 0 )
+                        case eCheckLeasedAddress:
+
+                            if( xARPHadIPClash != pdFALSE )
+                            {
+                                /* Another device uses the same address. */
+                                prvDeclineLeasedAddress();
+                            }
+                            else if( EP_DHCPData.uxConflictChecks < ( UBaseType_t ) dhcpCONFLICT_CHECK_COUNT )
+                            {
+                                EP_DHCPData.uxConflictChecks++;
+                                vARPSendGratuitous();
+                                vIPReloadDHCPTimer( dhcpCONFLICT_CHECK_PERIOD );
+                            }
+                            else
+                            {
+                                /* Nobody objected, wait for the time to renew the lease. */
+                                EP_DHCPData.eDHCPState = eLeasedAddress;
+                                vIPReloadDHCPTimer( EP_DHCPData.ulLeaseTime );
+                            }
+                            break;
+                    #endif /* ipconfigDHCP_CHECK_ADDRESS_CONFLICT */
+
                 case eLeasedAddress:
 
                     if( FreeRTOS_IsNetworkUp() != 0 )
@@ -673,6 +735,9 @@
             EP_DHCPData.ulOfferedIPAddress = 0U;
             EP_DHCPData.ulDHCPServerAddress = 0U;
             EP_DHCPData.xDHCPTxPeriod = dhcpINITIAL_DHCP_TX_PERIOD;
+            #if ( ipconfigDHCP_STORE_LEASE != 0 )
+                EP_DHCPData.xInitReboot = pdFALSE;
+            #endif
 
             /* Create the DHCP socket if it has not already been created. */
             prvCreateDHCPSocket();
@@ -686,6 +751,170 @@
     }
     /*-----------------------------------------------------------*/
 
+/**
+ * @brief The DHCP server has acknowledged the lease: start using the address,
+ *        and set the timer to the time at which the lease must be renewed.
+ */
+    static void prvUseLeasedAddress( void )
+    {
+        #if ( ipconfigDHCP_CHECK_ADDRESS_CONFLICT != 0 )
+            /* Only an address that was not in use yet will be checked. */
+            BaseType_t xNewAddress = ( *ipLOCAL_IP_ADDRESS_POINTER != EP_DHCPData.ulOfferedIPAddress ) ? pdTRUE : pdFALSE;
+        #endif
+
+        /* DHCP completed.  The IP address can now be used, and the
+         * timer set to the lease timeout time. */
+        *ipLOCAL_IP_ADDRESS_POINTER = EP_DHCPData.ulOfferedIPAddress;
+
+        /* Setting the 'local' broadcast address, something like
+         * '192.168.1.255'. */
+        EP_IPv4_SETTINGS.ulBroadcastAddress = ( EP_DHCPData.ulOfferedIPAddress & xNetworkAddressing.ulNetMask ) | ~xNetworkAddressing.ulNetMask;
+        EP_DHCPData.eDHCPState = eLeasedAddress;
+
+        iptraceDHCP_SUCCEDEED( EP_DHCPData.ulOfferedIPAddress );
+
+        /* DHCP failed, the default configured IP-address will be used
+         * Now call vIPNetworkUpCalls() to send the network-up event and
+         * start the ARP timer. */
+        vIPNetworkUpCalls();
+
+        /* Close socket to ensure packets don't queue on it. */
+        prvCloseDHCPSocket();
+
+        if( EP_DHCPData.ulLeaseTime == 0U )
+        {
+            EP_DHCPData.ulLeaseTime = ( uint32_t ) dhcpDEFAULT_LEASE_TIME;
+        }
+        else if( EP_DHCPData.ulLeaseTime < dhcpMINIMUM_LEASE_TIME )
+        {
+            EP_DHCPData.ulLeaseTime = dhcpMINIMUM_LEASE_TIME;
+        }
+        else
+        {
+            /* The lease time is already valid. */
+        }
+
+        #if ( ipconfigDHCP_STORE_LEASE != 0 )
+            {
+                /* Remember the lease for a next INIT-REBOOT. */
+                prvSaveLease( pdTRUE );
+            }
+        #endif
+
+        /* Check for clashes. */
+        vARPSendGratuitous();
+
+        #if ( ipconfigDHCP_CHECK_ADDRESS_CONFLICT != 0 )
+            if( xNewAddress != pdFALSE )
+            {
+                /* The network is up already.  In the mean time, a few more
+                 * announcements are sent, and any device that claims the
+                 * same address will be noticed by the ARP module. */
+                xARPHadIPClash = pdFALSE;
+                EP_DHCPData.uxConflictChecks = 1U;
+                EP_DHCPData.eDHCPState = eCheckLeasedAddress;
+                vIPReloadDHCPTimer( dhcpCONFLICT_CHECK_PERIOD );
+            }
+            else
+        #endif /* ipconfigDHCP_CHECK_ADDRESS_CONFLICT */
+        {
+            vIPReloadDHCPTimer( EP_DHCPData.ulLeaseTime );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigDHCP_CHECK_ADDRESS_CONFLICT != 0 )
+
+/**
+ * @brief Another device uses the address that was leased.  Stop using it, send
+ *        a DHCP decline message, and start again with a discover after
+ *        dhcpDECLINE_RESTART_PERIOD.
+ */
+        static void prvDeclineLeasedAddress( void )
+        {
+            uint8_t * pucUDPPayloadBuffer;
+            struct freertos_sockaddr xAddress;
+            size_t uxOptionsLength;
+            /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
+            const void * pvCopySource;
+            void * pvCopyDest;
+            static const uint8_t ucDHCPDeclineOptions[] =
+            {
+                /* Do not change the ordering without also changing
+                 * dhcpCLIENT_IDENTIFIER_OFFSET, dhcpREQUESTED_IP_ADDRESS_OFFSET and
+                 * dhcpDHCP_SERVER_IP_ADDRESS_OFFSET. */
+                dhcpIPv4_MESSAGE_TYPE_OPTION_CODE,       1, dhcpMESSAGE_TYPE_DECLINE, /* Message type option. */
+                dhcpIPv4_CLIENT_IDENTIFIER_OPTION_CODE,  7, 1, 0, 0, 0, 0, 0, 0,      /* Client identifier. */
+                dhcpIPv4_REQUEST_IP_ADDRESS_OPTION_CODE, 4, 0, 0, 0, 0,               /* The IP address being declined. */
+                dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE,  4, 0, 0, 0, 0,               /* The IP address of the DHCP server. */
+                dhcpOPTION_END_BYTE
+            };
+
+            FreeRTOS_printf( ( "vDHCPProcess: %xip is in use by another device, decline it\n", ( unsigned ) FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
+
+            /* The address must not be used anymore, also not as the source
+             * address of the decline message.  The network was reported to
+             * be up when the address was acknowledged, undo that, so the
+             * next acknowledgement will report it up again. */
+            *ipLOCAL_IP_ADDRESS_POINTER = 0U;
+            vIPNetworkDownCalls();
+
+            #if ( ipconfigDHCP_STORE_LEASE != 0 )
+                {
+                    prvSaveLease( pdFALSE );
+                }
+            #endif
+
+            prvCreateDHCPSocket();
+
+            if( xDHCPSocket != NULL )
+            {
+                uxOptionsLength = sizeof( ucDHCPDeclineOptions );
+                pucUDPPayloadBuffer = prvCreatePartDHCPMessage( &xAddress,
+                                                                ( BaseType_t ) dhcpREQUEST_OPCODE,
+                                                                ucDHCPDeclineOptions,
+                                                                &( uxOptionsLength ) );
+
+                if( pucUDPPayloadBuffer != NULL )
+                {
+                    /*
+                     * Use helper variables for memcpy() source & dest to remain
+                     * compliant with MISRA Rule 21.15.  These should be
+                     * optimized away.
+                     */
+                    pvCopySource = &EP_DHCPData.ulOfferedIPAddress;
+                    pvCopyDest = &pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpREQUESTED_IP_ADDRESS_OFFSET ];
+                    ( void ) memcpy( pvCopyDest, pvCopySource, sizeof( EP_DHCPData.ulOfferedIPAddress ) );
+
+                    pvCopySource = &EP_DHCPData.ulDHCPServerAddress;
+                    pvCopyDest = &pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpDHCP_SERVER_IP_ADDRESS_OFFSET ];
+                    ( void ) memcpy( pvCopyDest, pvCopySource, sizeof( EP_DHCPData.ulDHCPServerAddress ) );
+
+                    if( FreeRTOS_sendto( xDHCPSocket,
+                                         pucUDPPayloadBuffer,
+                                         sizeof( DHCPMessage_IPv4_t ) + uxOptionsLength,
+                                         FREERTOS_ZERO_COPY,
+                                         &( xAddress ),
+                                         ( socklen_t ) sizeof( xAddress ) ) == 0 )
+                    {
+                        /* The decline is not essential, the server will find out
+                         * about the conflict itself. */
+                        FreeRTOS_ReleaseUDPPayloadBuffer( pucUDPPayloadBuffer );
+                    }
+                }
+
+                prvCloseDHCPSocket();
+            }
+
+            /* Start again, but not too quickly, in case the server offers the
+             * same address again. */
+            EP_DHCPData.eDHCPState = eInitialWait;
+            vIPReloadDHCPTimer( dhcpDECLINE_RESTART_PERIOD );
+        }
+
+    #endif /* ipconfigDHCP_CHECK_ADDRESS_CONFLICT */
+    /*-----------------------------------------------------------*/
+
 /**
  * @brief Check whether the DHCP response from the server has all valid
  *        invariant parameters and valid (non broadcast and non localhost)
@@ -736,6 +965,11 @@
         uint32_t ulProcessed, ulParameter;
         BaseType_t xReturn = pdFALSE;
         const uint32_t ulMandatoryOptions = 2U; /* DHCP server address, and the correct DHCP message type must be present in the options. */
+
+        #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+            BaseType_t xAckToDiscover = pdFALSE;
+            BaseType_t xHasRapidCommit = pdFALSE;
+        #endif
         /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
         const void * pvCopySource;
         void * pvCopyDest;
@@ -856,12 +1090,40 @@
                                      * state machine is expecting. */
                                     ulProcessed++;
                                 }
+
+                                #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+                                    else if( ( xExpectedMessageType == ( BaseType_t ) dhcpMESSAGE_TYPE_OFFER ) &&
+                                             ( pucByte[ uxIndex ] == ( uint8_t ) dhcpMESSAGE_TYPE_ACK ) )
+                                    {
+                                        /* An ACK to a discover, which is only valid when
+                                         * it has the rapid commit option as well. */
+                                        xAckToDiscover = pdTRUE;
+                                        ulProcessed++;
+                                    }
+                                #endif /* ipconfigDHCP_USE_RAPID_COMMIT */
                                 else
                                 {
                                     if( pucByte[ uxIndex ] == ( uint8_t ) dhcpMESSAGE_TYPE_NACK )
                                     {
                                         if( xExpectedMessageType == ( BaseType_t ) dhcpMESSAGE_TYPE_ACK )
                                         {
+                                            #if ( ipconfigDHCP_USE_LEASE_AT_ONCE != 0 )
+                                                if( EP_DHCPData.xInitReboot != pdFALSE )
+                                                {
+                                                    /* The address was used while it was revalidated,
+                                                     * and the network was reported to be up. */
+                                                    *ipLOCAL_IP_ADDRESS_POINTER = 0U;
+                                                    vIPNetworkDownCalls();
+                                                }
+                                            #endif
+
+                                            #if ( ipconfigDHCP_STORE_LEASE != 0 )
+                                                {
+                                                    /* The lease is not valid anymore. */
+                                                    prvSaveLease( pdFALSE );
+                                                }
+                                            #endif
+
                                             /* Start again. */
                                             EP_DHCPData.eDHCPState = eInitialWait;
                                         }
@@ -924,6 +1186,20 @@
                                         {
                                             ulProcessed++;
                                         }
+
+                                        #if ( ipconfigDHCP_STORE_LEASE != 0 )
+                                            else if( EP_DHCPData.xInitReboot != pdFALSE )
+                                            {
+                                                /* An INIT-REBOOT request has no server
+                                                 * identifier, any server may answer it. */
+                                                EP_DHCPData.ulDHCPServerAddress = ulParameter;
+                                                ulProcessed++;
+                                            }
+                                        #endif
+                                        else
+                                        {
+                                            /* An ack from another server. */
+                                        }
                                     }
                                 }
 
@@ -950,6 +1226,21 @@
 
                                 break;
 
+                            #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+                                case dhcpIPv4_RAPID_COMMIT_OPTION_CODE:
+
+                                    if( uxLength == 0U )
+                                    {
+                                        xHasRapidCommit = pdTRUE;
+
+                                        /* The option has no data, continue with the
+                                         * next option. */
+                                        continue;
+                                    }
+
+                                    break;
+                            #endif /* ipconfigDHCP_USE_RAPID_COMMIT */
+
                             default:
 
                                 /* Not interested in this field. */
@@ -966,6 +1257,19 @@
                         uxIndex = uxIndex + uxLength;
                     }
 
+                    #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+                        {
+                            if( ( xAckToDiscover != pdFALSE ) && ( xHasRapidCommit == pdFALSE ) )
+                            {
+                                /* The server committed a lease that was not asked for. */
+                                ulProcessed = 0U;
+                                xAckToDiscover = pdFALSE;
+                            }
+
+                            EP_DHCPData.xRapidCommit = xAckToDiscover;
+                        }
+                    #endif /* ipconfigDHCP_USE_RAPID_COMMIT */
+
                     /* Were all the mandatory options received? */
                     if( ulProcessed >= ulMandatoryOptions )
                     {
@@ -1108,14 +1412,36 @@
             dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE,  4, 0, 0, 0, 0,               /* The IP address of the DHCP server. */
             dhcpOPTION_END_BYTE
         };
+        const uint8_t * pucOptions = ucDHCPRequestOptions;
         size_t uxOptionsLength = sizeof( ucDHCPRequestOptions );
         /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
         const void * pvCopySource;
         void * pvCopyDest;
 
+        #if ( ipconfigDHCP_STORE_LEASE != 0 )
+            static const uint8_t ucDHCPRebootOptions[] =
+            {
+                /* Do not change the ordering without also changing
+                 * dhcpCLIENT_IDENTIFIER_OFFSET and dhcpREQUESTED_IP_ADDRESS_OFFSET.
+                 * An INIT-REBOOT request has no server identifier, and it asks for
+                 * the parameters because there was no offer. */
+                dhcpIPv4_MESSAGE_TYPE_OPTION_CODE,       1, dhcpMESSAGE_TYPE_REQUEST,                                                                         /* Message type option. */
+                dhcpIPv4_CLIENT_IDENTIFIER_OPTION_CODE,  7, 1,                                0,                            0, 0, 0, 0, 0,                    /* Client identifier. */
+                dhcpIPv4_REQUEST_IP_ADDRESS_OPTION_CODE, 4, 0,                                0,                            0, 0,                             /* The IP address being requested. */
+                dhcpIPv4_PARAMETER_REQUEST_OPTION_CODE,  3, dhcpIPv4_SUBNET_MASK_OPTION_CODE, dhcpIPv4_GATEWAY_OPTION_CODE, dhcpIPv4_DNS_SERVER_OPTIONS_CODE, /* Parameter request option. */
+                dhcpOPTION_END_BYTE
+            };
+
+            if( EP_DHCPData.xInitReboot != pdFALSE )
+            {
+                pucOptions = ucDHCPRebootOptions;
+                uxOptionsLength = sizeof( ucDHCPRebootOptions );
+            }
+        #endif /* ipconfigDHCP_STORE_LEASE */
+
         pucUDPPayloadBuffer = prvCreatePartDHCPMessage( &xAddress,
                                                         ( BaseType_t ) dhcpREQUEST_OPCODE,
-                                                        ucDHCPRequestOptions,
+                                                        pucOptions,
                                                         &( uxOptionsLength ) );
 
         if( pucUDPPayloadBuffer != NULL )
@@ -1131,10 +1457,13 @@
             pvCopyDest = &pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpREQUESTED_IP_ADDRESS_OFFSET ];
             ( void ) memcpy( pvCopyDest, pvCopySource, sizeof( EP_DHCPData.ulOfferedIPAddress ) );
 
-            /* Copy in the address of the DHCP server being used. */
-            pvCopySource = &EP_DHCPData.ulDHCPServerAddress;
-            pvCopyDest = &pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpDHCP_SERVER_IP_ADDRESS_OFFSET ];
-            ( void ) memcpy( pvCopyDest, pvCopySource, sizeof( EP_DHCPData.ulDHCPServerAddress ) );
+            if( pucOptions == ucDHCPRequestOptions )
+            {
+                /* Copy in the address of the DHCP server being used. */
+                pvCopySource = &EP_DHCPData.ulDHCPServerAddress;
+                pvCopyDest = &pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpDHCP_SERVER_IP_ADDRESS_OFFSET ];
+                ( void ) memcpy( pvCopyDest, pvCopySource, sizeof( EP_DHCPData.ulDHCPServerAddress ) );
+            }
 
             FreeRTOS_debug_printf( ( "vDHCPProcess: reply %xip\n", ( unsigned ) FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
             iptraceSENDING_DHCP_REQUEST();
@@ -1171,6 +1500,9 @@
             dhcpIPv4_CLIENT_IDENTIFIER_OPTION_CODE,  7, 1,                                0,                            0, 0, 0, 0, 0,                    /* Client identifier. */
             dhcpIPv4_REQUEST_IP_ADDRESS_OPTION_CODE, 4, 0,                                0,                            0, 0,                             /* The IP address being requested. */
             dhcpIPv4_PARAMETER_REQUEST_OPTION_CODE,  3, dhcpIPv4_SUBNET_MASK_OPTION_CODE, dhcpIPv4_GATEWAY_OPTION_CODE, dhcpIPv4_DNS_SERVER_OPTIONS_CODE, /* Parameter request option. */
+            #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+                dhcpIPv4_RAPID_COMMIT_OPTION_CODE,   0,                                                                                                   /* Rapid commit, it has no data. */
+            #endif
             dhcpOPTION_END_BYTE
         };
         size_t uxOptionsLength = sizeof( ucDHCPDiscoverOptions );
@@ -1264,4 +1596,137 @@
     #endif /* ipconfigDHCP_FALL_BACK_AUTO_IP */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigDHCP_STORE_LEASE != 0 )
+
+/**
+ * @brief Check if the address of a previous lease is known.  The application is
+ *        asked once, after that the last acknowledged lease is remembered.  When
+ *        an address is known, prepare to request it with an INIT-REBOOT request.
+ *
+ * @return pdTRUE when an INIT-REBOOT request must be sent, otherwise pdFALSE.
+ */
+        static BaseType_t prvPrepareInitReboot( void )
+        {
+            DHCPLease_t xLease;
+            BaseType_t xReturn = pdFALSE;
+
+            if( ( EP_DHCPData.ulRebootIPAddress == 0U ) && ( EP_DHCPData.xLeaseRestored == pdFALSE ) )
+            {
+                EP_DHCPData.xLeaseRestored = pdTRUE;
+                ( void ) memset( &( xLease ), 0, sizeof( xLease ) );
+
+                if( ( xApplicationDHCPRestoreLeaseHook( &( xLease ) ) != pdFALSE ) &&
+                    ( xLease.ulIPAddress != 0U ) &&
+                    ( xLease.ulLeaseSeconds != 0U ) )
+                {
+                    EP_DHCPData.ulRebootIPAddress = xLease.ulIPAddress;
+                    EP_IPv4_SETTINGS.ulNetMask = xLease.ulNetMask;
+                    EP_IPv4_SETTINGS.ulGatewayAddress = xLease.ulGatewayAddress;
+                    EP_IPv4_SETTINGS.ulDNSServerAddress = xLease.ulDNSServerAddress;
+
+                    /* Renew halfway the part of the lease that is left, as is done
+                     * for a new lease. */
+                    EP_DHCPData.ulLeaseTime = ( uint32_t ) configTICK_RATE_HZ * ( xLease.ulLeaseSeconds >> 1 );
+
+                    if( EP_DHCPData.ulLeaseTime < dhcpMINIMUM_LEASE_TIME )
+                    {
+                        EP_DHCPData.ulLeaseTime = dhcpMINIMUM_LEASE_TIME;
+                    }
+                }
+            }
+
+            if( EP_DHCPData.ulRebootIPAddress != 0U )
+            {
+                EP_DHCPData.ulOfferedIPAddress = EP_DHCPData.ulRebootIPAddress;
+                EP_DHCPData.ulDHCPServerAddress = 0U;
+
+                #if ( ipconfigDHCP_USE_LEASE_AT_ONCE != 0 )
+                    {
+                        /* Use the address while it is revalidated. */
+                        *ipLOCAL_IP_ADDRESS_POINTER = EP_DHCPData.ulOfferedIPAddress;
+                        EP_IPv4_SETTINGS.ulBroadcastAddress = ( EP_DHCPData.ulOfferedIPAddress & EP_IPv4_SETTINGS.ulNetMask ) | ~EP_IPv4_SETTINGS.ulNetMask;
+
+                        if( EP_DHCPData.xInitReboot == pdFALSE )
+                        {
+                            FreeRTOS_printf( ( "vDHCPProcess: using %xip while revalidating it\n", ( unsigned ) FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
+                            vIPNetworkUpCalls();
+                            vARPSendGratuitous();
+                        }
+                    }
+                #endif /* ipconfigDHCP_USE_LEASE_AT_ONCE */
+
+                EP_DHCPData.xInitReboot = pdTRUE;
+                xReturn = pdTRUE;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Remember the lease that was acknowledged for a next INIT-REBOOT, and
+ *        pass it to the application.  Or, when the server refused the lease,
+ *        forget it and tell the application to do the same.
+ *
+ * @param[in] xValid: pdTRUE when the lease was acknowledged, pdFALSE when it
+ *                    was refused.
+ */
+        static void prvSaveLease( BaseType_t xValid )
+        {
+            DHCPLease_t xLease;
+
+            ( void ) memset( &( xLease ), 0, sizeof( xLease ) );
+            EP_DHCPData.xInitReboot = pdFALSE;
+
+            if( xValid != pdFALSE )
+            {
+                EP_DHCPData.ulRebootIPAddress = EP_DHCPData.ulOfferedIPAddress;
+
+                xLease.ulIPAddress = EP_DHCPData.ulOfferedIPAddress;
+                xLease.ulNetMask = EP_IPv4_SETTINGS.ulNetMask;
+                xLease.ulGatewayAddress = EP_IPv4_SETTINGS.ulGatewayAddress;
+                xLease.ulDNSServerAddress = EP_IPv4_SETTINGS.ulDNSServerAddress;
+                xLease.ulDHCPServerAddress = EP_DHCPData.ulDHCPServerAddress;
+                /* 'ulLeaseTime' holds half of the lease, in clock ticks. */
+                xLease.ulLeaseSeconds = ( EP_DHCPData.ulLeaseTime / ( uint32_t ) configTICK_RATE_HZ ) << 1;
+            }
+            else
+            {
+                EP_DHCPData.ulRebootIPAddress = 0U;
+            }
+
+            vApplicationDHCPSaveLeaseHook( &( xLease ) );
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief The INIT-REBOOT request was not answered.  Either start again with a
+ *        discover, or, when ipconfigDHCP_USE_LEASE_AT_ONCE is set, keep using
+ *        the address until it is time to renew the lease.
+ */
+        static void prvInitRebootTimedOut( void )
+        {
+            EP_DHCPData.xInitReboot = pdFALSE;
+
+            #if ( ipconfigDHCP_USE_LEASE_AT_ONCE != 0 )
+                {
+                    FreeRTOS_printf( ( "vDHCPProcess: no answer, keep using %xip\n", ( unsigned ) FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
+                    EP_DHCPData.eDHCPState = eLeasedAddress;
+
+                    /* Close socket to ensure packets don't queue on it. */
+                    prvCloseDHCPSocket();
+                    vIPReloadDHCPTimer( EP_DHCPData.ulLeaseTime );
+                }
+            #else
+                {
+                    /* Forget the address, and start again with a discover. */
+                    EP_DHCPData.ulRebootIPAddress = 0U;
+                    EP_DHCPData.eDHCPState = eInitialWait;
+                }
+            #endif /* ipconfigDHCP_USE_LEASE_AT_ONCE */
+        }
+
+    #endif /* ipconfigDHCP_STORE_LEASE */
+/*-----------------------------------------------------------*/
+
 #endif /* ipconfigUSE_DHCP != 0 */
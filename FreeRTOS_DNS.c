@@ -54,7 +54,9 @@
  * Create a socket and bind it to the standard DNS port number.  Return the
  * the created socket - or NULL if the socket could not be created or bound.
  */
-    static Socket_t prvCreateDNSSocket( void );
+    #if ( ipconfigDNS_USE_RESOLVER == 0 )
+        static Socket_t prvCreateDNSSocket( void );
+    #endif
 
 /*
  * Create the DNS message in the zero copy buffer passed in the first parameter.
@@ -64,11 +66,18 @@
                                         TickType_t uxIdentifier );
 
 /*
- * Simple routine that jumps over the NAME field of a resource record.
- * It returns the number of bytes read.
+ * Check the name at the read position of a DNS message, following its
+ * compression pointers, and move the read position past it.
+ */
+    _static BaseType_t prvDNSReadName( DNSReader_t * pxReader );
+
+/*
+ * Read a question or a resource record at the read position of a DNS message,
+ * without copying its name, and move the read position to the next record.
  */
-    _static size_t prvSkipNameField( const uint8_t * pucByte,
-                                     size_t uxLength );
+    _static BaseType_t prvDNSReadRecord( DNSReader_t * pxReader,
+                                         DNSRecord_t * pxRecord,
+                                         BaseType_t xIsQuestion );
 
 /*
  * Process a response packet from a DNS server.
@@ -95,11 +104,13 @@
  * Prepare and send a message to a DNS server.  'uxReadTimeOut_ticks' will be passed as
  * zero, in case the user has supplied a call-back function.
  */
-    static uint32_t prvGetHostByName( const char * pcHostName,
-                                      TickType_t uxIdentifier,
-                                      TickType_t uxReadTimeOut_ticks );
+    #if ( ipconfigDNS_USE_RESOLVER == 0 )
+        static uint32_t prvGetHostByName( const char * pcHostName,
+                                          TickType_t uxIdentifier,
+                                          TickType_t uxReadTimeOut_ticks );
+    #endif
 
-    #if ( ipconfigDNS_USE_CALLBACKS != 0 )
+    #if ( ipconfigDNS_USE_CALLBACKS != 0 ) && ( ipconfigDNS_USE_RESOLVER == 0 )
         static void vDNSSetCallBack( const char * pcHostName,
                                      void * pvSearchID,
                                      FOnDNSEvent pCallbackFunction,
@@ -107,6 +118,16 @@
                                      TickType_t uxIdentifier );
     #endif /* ipconfigDNS_USE_CALLBACKS */
 
+    #if ( ipconfigDNS_USE_RESOLVER != 0 )
+        static uint32_t prvDNSResolverLookup( const char * pcHostName,
+                                              TickType_t uxIdentifier,
+                                              FOnDNSEvent pCallback,
+                                              void * pvSearchID,
+                                              TickType_t uxTimeout );
+
+        static void prvDNSResolverCancel( const void * pvSearchID );
+    #endif /* ipconfigDNS_USE_RESOLVER */
+
     #if ( ipconfigDNS_USE_CALLBACKS != 0 )
         static BaseType_t xDNSDoCallback( TickType_t uxIdentifier,
                                           const char * pcName,
@@ -128,12 +149,16 @@
     #endif /* ipconfigUSE_NBNS */
 
 
-    #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
-        _static size_t prvReadNameField( const uint8_t * pucByte,
-                                         size_t uxRemainingBytes,
-                                         char * pcName,
-                                         size_t uxDestLen );
-    #endif /* ipconfigUSE_DNS_CACHE || ipconfigDNS_USE_CALLBACKS */
+    #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 ) || ( ipconfigUSE_MDNS != 0 )
+        _static BaseType_t prvDNSCopyName( const DNSReader_t * pxReader,
+                                           size_t uxNameOffset,
+                                           char * pcName,
+                                           size_t uxDestLen );
+    #endif /* ipconfigUSE_DNS_CACHE || ipconfigDNS_USE_CALLBACKS || ipconfigUSE_MDNS */
+
+    #if ( ipconfigUSE_MDNS != 0 )
+        static BaseType_t prvMDNSIsLocalName( const char * pcName );
+    #endif /* ipconfigUSE_MDNS */
 
     #if ( ipconfigUSE_DNS_CACHE == 1 )
         static BaseType_t prvProcessDNSCache( const char * pcName,
@@ -143,10 +168,63 @@
 
         _static DNSCacheRow_t xDNSCache[ ipconfigDNS_CACHE_ENTRIES ];
 
+        #if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+            #define dnsCACHE_NONE                 ( 0xffffU ) /**< Marks the end of a hash chain or list. */
+            #define dnsCACHE_FLAG_IN_USE          ( 0x01U )   /**< The entry holds a name. */
+            #define dnsCACHE_FLAG_NEGATIVE        ( 0x02U )   /**< The name is known to have no address. */
+            #define dnsCACHE_FLAG_PREFETCH        ( 0x04U )   /**< The entry is being refreshed. */
+            #define dnsCACHE_PREFETCH_MIN_HITS    ( 2U )      /**< The number of look-ups that make an entry worth a prefetch. */
+
+/** @brief The first entry in each hash bucket. */
+            static uint16_t usDNSCacheBuckets[ ipconfigDNS_CACHE_HASH_BUCKETS ];
+
+/** @brief The names of the cache entries, in lower case and without a terminating zero. */
+            static uint8_t ucDNSNameArena[ ipconfigDNS_CACHE_NAME_ARENA_SIZE ];
+
+/** @brief The number of bytes used in the name arena, including the names of removed entries. */
+            static size_t uxDNSNameArenaUsed;
+
+/** @brief The first free entry, the others are linked through 'usHashNext'. */
+            static uint16_t usDNSCacheFree;
+
+/** @brief The most and the least recently used entries. */
+            static uint16_t usDNSCacheLRUHead, usDNSCacheLRUTail;
+
+/** @brief Becomes true when the hash buckets and lists have been initialised. */
+            static BaseType_t xDNSCacheReady = pdFALSE;
+
+            static uint32_t prvDNSCacheHash( const char * pcName,
+                                             size_t * puxLength );
+
+            static BaseType_t prvDNSCacheFind( const char * pcName,
+                                               uint32_t ulHash,
+                                               size_t uxLength );
+
+            static BaseType_t prvDNSCacheIsNegative( const char * pcName );
+
+            static void prvDNSCacheStoreNegative( const char * pcName,
+                                                  DNSReader_t * pxReader,
+                                                  uint16_t usSkip,
+                                                  uint16_t usAuthorities );
+        #endif /* ipconfigUSE_DNS_CACHE_HASH */
+
 /* Utility function: Clear DNS cache by calling this function. */
         void FreeRTOS_dnsclear( void )
         {
-            ( void ) memset( xDNSCache, 0x0, sizeof( xDNSCache ) );
+            #if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+                {
+                    vTaskSuspendAll();
+                    {
+                        ( void ) memset( xDNSCache, 0x0, sizeof( xDNSCache ) );
+                        xDNSCacheReady = pdFALSE;
+                    }
+                    ( void ) xTaskResumeAll();
+                }
+            #else
+                {
+                    ( void ) memset( xDNSCache, 0x0, sizeof( xDNSCache ) );
+                }
+            #endif
         }
     #endif /* ipconfigUSE_DNS_CACHE == 1 */
 
@@ -250,6 +328,85 @@
             ( void ) prvProcessDNSCache( pcHostName, &ulIPAddress, 0, pdTRUE );
             return ulIPAddress;
         }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Get all addresses of a host name that are stored in the DNS cache,
+ *        in the order in which they were received.  The address selection of
+ *        FreeRTOS_dnslookup() is not affected.
+ *
+ * @param[in] pcHostName: The host name.
+ * @param[out] pxAddresses: The addresses found, together with the number of
+ *                          seconds that they remain valid.  The TTL is
+ *                          kept per name, so all addresses have the same TTL.
+ * @param[in] xMaxCount: The maximum number of addresses to return.
+ *
+ * @return The number of addresses stored in pxAddresses.
+ */
+        BaseType_t FreeRTOS_dnslookup_all( const char * pcHostName,
+                                           DNSAddress_t * pxAddresses,
+                                           BaseType_t xMaxCount )
+        {
+            BaseType_t xCount = 0;
+            BaseType_t xEntry = -1;
+            BaseType_t xNumAddresses = 1;
+            uint32_t ulExpiry;
+            uint32_t ulCurrentTimeSeconds = ( xTaskGetTickCount() / portTICK_PERIOD_MS ) / 1000U;
+
+            configASSERT( ( pcHostName != NULL ) && ( pxAddresses != NULL ) );
+
+            vTaskSuspendAll();
+            {
+                #if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+                    {
+                        size_t uxLength;
+                        uint32_t ulHash = prvDNSCacheHash( pcHostName, &( uxLength ) );
+
+                        xEntry = prvDNSCacheFind( pcHostName, ulHash, uxLength );
+
+                        if( ( xEntry >= 0 ) && ( ( xDNSCache[ xEntry ].ucFlags & dnsCACHE_FLAG_NEGATIVE ) != 0U ) )
+                        {
+                            xEntry = -1;
+                        }
+                    }
+                #else
+                    {
+                        BaseType_t x;
+
+                        for( x = 0; x < ( BaseType_t ) ipconfigDNS_CACHE_ENTRIES; x++ )
+                        {
+                            if( ( xDNSCache[ x ].pcName[ 0 ] != ( char ) 0 ) && ( strcmp( xDNSCache[ x ].pcName, pcHostName ) == 0 ) )
+                            {
+                                xEntry = x;
+                                break;
+                            }
+                        }
+                    }
+                #endif /* if ( ipconfigUSE_DNS_CACHE_HASH != 0 ) */
+
+                if( xEntry >= 0 )
+                {
+                    ulExpiry = xDNSCache[ xEntry ].ulTimeWhenAddedInSeconds + FreeRTOS_ntohl( xDNSCache[ xEntry ].ulTTL );
+
+                    #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+                        xNumAddresses = ( BaseType_t ) xDNSCache[ xEntry ].ucNumIPAddresses;
+                    #endif
+
+                    if( ulCurrentTimeSeconds < ulExpiry )
+                    {
+                        while( ( xCount < xNumAddresses ) && ( xCount < xMaxCount ) )
+                        {
+                            pxAddresses[ xCount ].ulIPAddress = xDNSCache[ xEntry ].ulIPAddresses[ xCount ];
+                            pxAddresses[ xCount ].ulTTL = ulExpiry - ulCurrentTimeSeconds;
+                            xCount++;
+                        }
+                    }
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            return xCount;
+        }
     #endif /* ipconfigUSE_DNS_CACHE == 1 */
     /*-----------------------------------------------------------*/
 
@@ -349,11 +506,20 @@
  */
         void FreeRTOS_gethostbyname_cancel( void * pvSearchID )
         {
-            /* _HT_ Should better become a new API call to have the IP-task remove the callback */
-            vDNSCheckCallBack( pvSearchID );
+            #if ( ipconfigDNS_USE_RESOLVER != 0 )
+                {
+                    prvDNSResolverCancel( pvSearchID );
+                }
+            #else
+                {
+                    /* _HT_ Should better become a new API call to have the IP-task remove the callback */
+                    vDNSCheckCallBack( pvSearchID );
+                }
+            #endif
         }
         /*-----------------------------------------------------------*/
 
+        #if ( ipconfigDNS_USE_RESOLVER == 0 )
 /**
  * @brief FreeRTOS_gethostbyname_a() was called along with callback parameters.
  *        Store them in a list for later reference.
@@ -364,40 +530,41 @@
  * @param[in] uxTimeout: Timeout of the callback function.
  * @param[in] uxIdentifier: Random number used as ID in the DNS message.
  */
-        static void vDNSSetCallBack( const char * pcHostName,
-                                     void * pvSearchID,
-                                     FOnDNSEvent pCallbackFunction,
-                                     TickType_t uxTimeout,
-                                     TickType_t uxIdentifier )
-        {
-            size_t lLength = strlen( pcHostName );
-            DNSCallback_t * pxCallback = ipCAST_PTR_TO_TYPE_PTR( DNSCallback_t, pvPortMalloc( sizeof( *pxCallback ) + lLength ) );
+            static void vDNSSetCallBack( const char * pcHostName,
+                                         void * pvSearchID,
+                                         FOnDNSEvent pCallbackFunction,
+                                         TickType_t uxTimeout,
+                                         TickType_t uxIdentifier )
+            {
+                size_t lLength = strlen( pcHostName );
+                DNSCallback_t * pxCallback = ipCAST_PTR_TO_TYPE_PTR( DNSCallback_t, pvPortMalloc( sizeof( *pxCallback ) + lLength ) );
 
-            /* Translate from ms to number of clock ticks. */
-            uxTimeout /= portTICK_PERIOD_MS;
+                /* Translate from ms to number of clock ticks. */
+                uxTimeout /= portTICK_PERIOD_MS;
 
-            if( pxCallback != NULL )
-            {
-                if( listLIST_IS_EMPTY( &xCallbackList ) != pdFALSE )
+                if( pxCallback != NULL )
                 {
-                    /* This is the first one, start the DNS timer to check for timeouts */
-                    vIPReloadDNSTimer( FreeRTOS_min_uint32( 1000U, uxTimeout ) );
-                }
+                    if( listLIST_IS_EMPTY( &xCallbackList ) != pdFALSE )
+                    {
+                        /* This is the first one, start the DNS timer to check for timeouts */
+                        vIPReloadDNSTimer( FreeRTOS_min_uint32( 1000U, uxTimeout ) );
+                    }
 
-                ( void ) strcpy( pxCallback->pcName, pcHostName );
-                pxCallback->pCallbackFunction = pCallbackFunction;
-                pxCallback->pvSearchID = pvSearchID;
-                pxCallback->uxRemaningTime = uxTimeout;
-                vTaskSetTimeOutState( &pxCallback->uxTimeoutState );
-                listSET_LIST_ITEM_OWNER( &( pxCallback->xListItem ), ( void * ) pxCallback );
-                listSET_LIST_ITEM_VALUE( &( pxCallback->xListItem ), uxIdentifier );
-                vTaskSuspendAll();
-                {
-                    vListInsertEnd( &xCallbackList, &pxCallback->xListItem );
+                    ( void ) strcpy( pxCallback->pcName, pcHostName );
+                    pxCallback->pCallbackFunction = pCallbackFunction;
+                    pxCallback->pvSearchID = pvSearchID;
+                    pxCallback->uxRemaningTime = uxTimeout;
+                    vTaskSetTimeOutState( &pxCallback->uxTimeoutState );
+                    listSET_LIST_ITEM_OWNER( &( pxCallback->xListItem ), ( void * ) pxCallback );
+                    listSET_LIST_ITEM_VALUE( &( pxCallback->xListItem ), uxIdentifier );
+                    vTaskSuspendAll();
+                    {
+                        vListInsertEnd( &xCallbackList, &pxCallback->xListItem );
+                    }
+                    ( void ) xTaskResumeAll();
                 }
-                ( void ) xTaskResumeAll();
             }
-        }
+        #endif /* ipconfigDNS_USE_RESOLVER == 0 */
         /*-----------------------------------------------------------*/
 
 /**
@@ -450,1395 +617,3779 @@
     #endif /* ipconfigDNS_USE_CALLBACKS == 1 */
     /*-----------------------------------------------------------*/
 
-    #if ( ipconfigDNS_USE_CALLBACKS == 0 )
+    #if ( ipconfigDNS_USE_RESOLVER != 0 )
+
+/** @brief The states of an entry in the query table of the resolver. */
+        #define dnsQUERY_FREE    ( 0U ) /**< The entry is not in use. */
+        #define dnsQUERY_NEW     ( 1U ) /**< The query waits to be sent by the IP-task. */
+        #define dnsQUERY_SENT    ( 2U ) /**< The query has been sent and waits for a reply. */
+
+/** @brief The interval at which the resolver checks its queries for a time-out. */
+        #define dnsRESOLVER_POLL_TICKS    pdMS_TO_TICKS( 250U )
+
+        #if ( ipconfigUSE_DNS_CACHE != 0 )
+            #define dnsRESOLVER_NAME_LENGTH    ipconfigDNS_CACHE_NAME_LENGTH
+        #else
+            #define dnsRESOLVER_NAME_LENGTH    dnsMAX_HOSTNAME_LENGTH
+        #endif
+
+/** @brief A query of the resolver. */
+        typedef struct xDNS_QUERY
+        {
+            char pcName[ dnsRESOLVER_NAME_LENGTH ]; /**< The name being looked up. */
+            FOnDNSEvent pCallbackFunction;          /**< Called when the query has finished, NULL when it was cancelled. */
+            void * pvSearchID;                      /**< Passed to the call-back function. */
+            TickType_t xStartTime;                  /**< The time at which the query was submitted. */
+            TickType_t uxTimeoutTicks;              /**< The time allowed for the query, or portMAX_DELAY. */
+            TickType_t xSendTime;                   /**< The time at which the query was last sent. */
+            uint16_t usIdentifier;                  /**< The DNS identifier, unique among the outstanding queries. */
+            uint8_t ucState;                        /**< One of the dnsQUERY_ states. */
+            uint8_t ucAttempts;                     /**< The number of times that the query has been sent. */
+        } DNSQuery_t;
+
+/** @brief A blocking look-up waits for the resolver through this structure. */
+        typedef struct xDNS_FUTURE
+        {
+            SemaphoreHandle_t xSemaphore; /**< Given when the query has finished. */
+            uint32_t ulIPAddress;         /**< The result of the query. */
+        } DNSFuture_t;
 
 /**
- * @brief Get the IP-address corresponding to the given hostname.
+ * @brief Utility function to cast pointer of a type to pointer of type DNSFuture_t.
  *
- * @param[in] pcHostName: The hostname whose IP address is being queried.
+ * @return The casted pointer.
+ */
+        static portINLINE ipDECL_CAST_PTR_FUNC_FOR_TYPE( DNSFuture_t )
+        {
+            return ( DNSFuture_t * ) pvArgument;
+        }
+
+/** @brief The queries of the resolver.  Once submitted, they are handled by the IP-task. */
+        static DNSQuery_t xDNSQueries[ ipconfigDNS_RESOLVER_QUERIES ];
+
+/** @brief The alternative DNS servers.  Entry 0 is not used, it is the DNS server
+ *         of the network configuration. */
+        static uint32_t ulDNSResolverServers[ ipconfigDNS_RESOLVER_SERVERS ];
+
+/** @brief The socket through which the resolver sends all queries. */
+        static Socket_t xDNSResolverSocket = NULL;
+
+/**
+ * @brief Ask the IP-task to run the resolver.
  *
- * @return The IP-address corresponding to the hostname.
+ * @return pdPASS if the event was sent, pdFAIL otherwise.
  */
-        uint32_t FreeRTOS_gethostbyname( const char * pcHostName )
+        BaseType_t xSendDNSResolverEvent( void )
         {
-            return prvPrepareLookup( pcHostName );
+            IPStackEvent_t xEventMessage;
+            const TickType_t uxDontBlock = 0U;
+
+            xEventMessage.eEventType = eDNSResolverEvent;
+            xEventMessage.pvData = NULL;
+
+            return xSendEventStructToIPTask( &xEventMessage, uxDontBlock );
         }
-    #else
+        /*-----------------------------------------------------------*/
 
 /**
- * @brief Get the IP-address corresponding to the given hostname.
+ * @brief Check whether a given socket is the socket of the resolver.
  *
- * @param[in] pcHostName: The hostname whose IP address is being queried.
- * @param[in] pCallback: The callback function which will be called upon DNS response.
- * @param[in] pvSearchID: Search ID for the callback function.
- * @param[in] uxTimeout: Timeout for the callback function.
+ * @param[in] xSocket: The socket to be checked.
  *
- * @return The IP-address corresponding to the hostname.
+ * @return pdTRUE if it is the socket of the resolver, else pdFALSE.
  */
-        uint32_t FreeRTOS_gethostbyname_a( const char * pcHostName,
-                                           FOnDNSEvent pCallback,
-                                           void * pvSearchID,
-                                           TickType_t uxTimeout )
+        BaseType_t xIsDNSResolverSocket( Socket_t xSocket )
         {
-            return prvPrepareLookup( pcHostName, pCallback, pvSearchID, uxTimeout );
-        }
-    #endif /* if ( ipconfigDNS_USE_CALLBACKS == 0 ) */
+            BaseType_t xReturn;
 
-    #if ( ipconfigDNS_USE_CALLBACKS == 1 )
+            if( ( xDNSResolverSocket != NULL ) && ( xDNSResolverSocket == xSocket ) )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                xReturn = pdFALSE;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
 
 /**
- * @brief Check if hostname is already known. If not, call prvGetHostByName() to send a DNS request.
+ * @brief Set the address of an alternative DNS server.  Retransmissions of a
+ *        query go to the next server in turn.
  *
- * @param[in] pcHostName: The hostname whose IP address is being queried.
- * @param[in] pCallback: The callback function which will be called upon DNS response.
- * @param[in] pvSearchID: Search ID for the callback function.
- * @param[in] uxTimeout: Timeout for the callback function.
+ * @param[in] xIndex: The number of the server, from 1 to ipconfigDNS_RESOLVER_SERVERS - 1.
+ *                    Server 0 is the DNS server of the network configuration.
+ * @param[in] ulIPAddress: The IP-address of the server, or 0 to remove it.
  *
- * @return The IP-address corresponding to the hostname.
+ * @return pdPASS if the server was set, pdFAIL if the index is out of range.
  */
-        static uint32_t prvPrepareLookup( const char * pcHostName,
-                                          FOnDNSEvent pCallback,
-                                          void * pvSearchID,
-                                          TickType_t uxTimeout )
-    #else
+        BaseType_t FreeRTOS_SetDNSResolverServer( BaseType_t xIndex,
+                                                  uint32_t ulIPAddress )
+        {
+            BaseType_t xReturn = pdFAIL;
+
+            if( ( xIndex > 0 ) && ( xIndex < ( BaseType_t ) ipconfigDNS_RESOLVER_SERVERS ) )
+            {
+                ulDNSResolverServers[ xIndex ] = ulIPAddress;
+                xReturn = pdPASS;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
 
 /**
- * @brief Check if hostname is already known. If not, call prvGetHostByName() to send a DNS request.
+ * @brief Get the DNS server to which an attempt of a query will be sent.
  *
- * @param[in] pcHostName: The hostname whose IP address is being queried.
+ * @param[in] ucAttempt: The number of earlier attempts of the query.
  *
- * @return The IP-address corresponding to the hostname.
+ * @return The IP-address of the DNS server.
  */
-        static uint32_t prvPrepareLookup( const char * pcHostName )
-    #endif
-    {
-        uint32_t ulIPAddress = 0U;
-        TickType_t uxReadTimeOut_ticks = ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS;
+        static uint32_t prvDNSResolverServer( uint8_t ucAttempt )
+        {
+            size_t uxIndex = ( ( size_t ) ucAttempt ) % ( size_t ) ipconfigDNS_RESOLVER_SERVERS;
+            uint32_t ulIPAddress = ulDNSResolverServers[ uxIndex ];
 
-        /* Generate a unique identifier for this query. Keep it in a local variable
-         * as gethostbyname() may be called from different threads */
-        BaseType_t xHasRandom = pdFALSE;
-        TickType_t uxIdentifier = 0U;
-        BaseType_t xLengthOk = pdFALSE;
+            if( ( uxIndex == 0U ) || ( ulIPAddress == 0U ) )
+            {
+                /* Use the DNS server of the network configuration. */
+                FreeRTOS_GetAddressConfiguration( NULL, NULL, NULL, &ulIPAddress );
+            }
 
-        if( pcHostName != NULL )
+            return ulIPAddress;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Create the socket of the resolver, bound to a random port number.
+ */
+        static void prvDNSResolverCreateSocket( void )
         {
-            size_t uxLength = strlen( pcHostName ) + 1U;
+            struct freertos_sockaddr xAddress;
+            BaseType_t xReturn;
+            TickType_t xTimeoutTime = ( TickType_t ) 0;
 
-            #if ( ipconfigUSE_DNS_CACHE != 0 )
-                if( uxLength <= ipconfigDNS_CACHE_NAME_LENGTH )
-            #else
-                if( uxLength <= dnsMAX_HOSTNAME_LENGTH )
-            #endif
+            xDNSResolverSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+
+            if( xDNSResolverSocket != FREERTOS_INVALID_SOCKET )
             {
-                /* The name is not too long. */
-                xLengthOk = pdTRUE;
+                /* Ensure the Rx and Tx timeouts are zero as the resolver executes
+                 * in the context of the IP task. */
+                ( void ) FreeRTOS_setsockopt( xDNSResolverSocket, 0, FREERTOS_SO_RCVTIMEO, &( xTimeoutTime ), sizeof( TickType_t ) );
+                ( void ) FreeRTOS_setsockopt( xDNSResolverSocket, 0, FREERTOS_SO_SNDTIMEO, &( xTimeoutTime ), sizeof( TickType_t ) );
+
+                /* Auto bind the port. */
+                ( void ) memset( &( xAddress ), 0, sizeof( xAddress ) );
+                xReturn = vSocketBind( xDNSResolverSocket, &xAddress, sizeof( xAddress ), pdFALSE );
+
+                if( xReturn != 0 )
+                {
+                    /* This module runs from the IP-task. Use the internal
+                     * function 'vSocketClose()` to close the socket. */
+                    ( void ) vSocketClose( xDNSResolverSocket );
+                    xDNSResolverSocket = NULL;
+                }
             }
             else
             {
-                FreeRTOS_printf( ( "prvPrepareLookup: name is too long ( %u > %u )\n",
-                                   ( unsigned ) uxLength,
-                                   ( unsigned ) ipconfigDNS_CACHE_NAME_LENGTH ) );
+                /* Change to NULL for easier testing. */
+                xDNSResolverSocket = NULL;
             }
         }
+        /*-----------------------------------------------------------*/
 
-        if( ( pcHostName != NULL ) && ( xLengthOk != pdFALSE ) )
+/**
+ * @brief Send a query, or send it again to the next DNS server.
+ *
+ * @param[in] pxQuery: The query to be sent.
+ */
+        static void prvDNSResolverSend( DNSQuery_t * pxQuery )
         {
-            /* If the supplied hostname is IP address, convert it to uint32_t
-             * and return. */
-            #if ( ipconfigINCLUDE_FULL_INET_ADDR == 1 )
+            NetworkBufferDescriptor_t * pxNetworkBuffer;
+            struct freertos_sockaddr xAddress;
+            uint8_t * pucUDPPayloadBuffer;
+            size_t uxPayloadLength;
+            const size_t uxHeaderBytes = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER;
+            /* Two is added at the end for the count of characters in the first
+             * subdomain part and the string end byte. */
+            size_t uxExpectedPayloadLength = sizeof( DNSMessage_t ) + strlen( pxQuery->pcName ) + sizeof( uint16_t ) + sizeof( uint16_t ) + 2U;
+
+            pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxHeaderBytes + uxExpectedPayloadLength, 0U );
+
+            if( pxNetworkBuffer != NULL )
+            {
+                pucUDPPayloadBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ uxHeaderBytes ] );
+
+                /* Create the message in the obtained buffer. */
+                uxPayloadLength = prvCreateDNSMessage( pucUDPPayloadBuffer, pxQuery->pcName, ( TickType_t ) pxQuery->usIdentifier );
+
+                iptraceSENDING_DNS_REQUEST();
+
+                #if ( ipconfigUSE_LLMNR == 1 )
+                    if( strchr( pxQuery->pcName, ( int ) ASCII_BASELINE_DOT ) == NULL )
+                    {
+                        /* Use LLMNR addressing. */
+                        ( ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer ) )->usFlags = 0;
+                        xAddress.sin_addr = ipLLMNR_IP_ADDR; /* Is in network byte order. */
+                        xAddress.sin_port = ipLLMNR_PORT;
+                        xAddress.sin_port = FreeRTOS_ntohs( xAddress.sin_port );
+                    }
+                    else
+                #endif
+                #if ( ipconfigUSE_MDNS != 0 )
+                    if( prvMDNSIsLocalName( pxQuery->pcName ) != pdFALSE )
+                    {
+                        /* Use a one-shot mDNS query. */
+                        ( ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer ) )->usFlags = 0;
+                        xAddress.sin_addr = ipMDNS_IP_ADDR; /* Is in network byte order. */
+                        xAddress.sin_port = FreeRTOS_htons( ipMDNS_PORT );
+                    }
+                    else
+                #endif
                 {
-                    ulIPAddress = FreeRTOS_inet_addr( pcHostName );
+                    /* Use the DNS server for this attempt. */
+                    xAddress.sin_addr = prvDNSResolverServer( pxQuery->ucAttempts );
+                    xAddress.sin_port = dnsDNS_PORT;
                 }
-            #endif /* ipconfigINCLUDE_FULL_INET_ADDR == 1 */
 
-            /* If a DNS cache is used then check the cache before issuing another DNS
-             * request. */
-            #if ( ipconfigUSE_DNS_CACHE == 1 )
+                if( FreeRTOS_sendto( xDNSResolverSocket, pucUDPPayloadBuffer, uxPayloadLength, FREERTOS_ZERO_COPY, &xAddress, ( socklen_t ) sizeof( xAddress ) ) == 0 )
                 {
-                    if( ulIPAddress == 0U )
-                    {
-                        ulIPAddress = FreeRTOS_dnslookup( pcHostName );
-
-                        if( ulIPAddress != 0U )
-                        {
-                            FreeRTOS_debug_printf( ( "FreeRTOS_gethostbyname: found '%s' in cache: %xip\n", pcHostName, ( unsigned ) ulIPAddress ) );
-                        }
-                        else
-                        {
-                            /* prvGetHostByName will be called to start a DNS lookup. */
-                        }
-                    }
+                    /* The message was not sent so the stack will not be
+                     * releasing the zero copy - it must be released here. */
+                    vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
                 }
-            #endif /* ipconfigUSE_DNS_CACHE == 1 */
+            }
 
-            /* Generate a unique identifier. */
-            if( ulIPAddress == 0U )
+            /* Also when no buffer was available, this counts as an attempt.
+             * The query will be sent again after a time-out. */
+            pxQuery->ucAttempts++;
+            pxQuery->xSendTime = xTaskGetTickCount();
+            pxQuery->ucState = dnsQUERY_SENT;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Report the result of a query and release its entry.
+ *
+ * @param[in] pxQuery: The query that has finished.
+ * @param[in] ulIPAddress: The IP-address found, or zero.
+ */
+        static void prvDNSResolverFinish( DNSQuery_t * pxQuery,
+                                          uint32_t ulIPAddress )
+        {
+            /* The call-back may be cancelled by another task. */
+            vTaskSuspendAll();
             {
-                uint32_t ulNumber = 0U;
+                if( pxQuery->pCallbackFunction != NULL )
+                {
+                    pxQuery->pCallbackFunction( pxQuery->pcName, pxQuery->pvSearchID, ulIPAddress );
+                }
 
-                xHasRandom = xApplicationGetRandomNumber( &( ulNumber ) );
-                /* DNS identifiers are 16-bit. */
-                uxIdentifier = ( TickType_t ) ( ulNumber & 0xffffU );
+                pxQuery->ucState = dnsQUERY_FREE;
             }
+            ( void ) xTaskResumeAll();
+        }
+        /*-----------------------------------------------------------*/
 
-            #if ( ipconfigDNS_USE_CALLBACKS == 1 )
+/**
+ * @brief A reply was received on the socket of the resolver, look up the query
+ *        with the same identifier.
+ *
+ * @param[in] pucUDPPayloadBuffer: The DNS reply.
+ * @param[in] uxBufferLength: The length of the reply.
+ */
+        static void prvDNSResolverReply( uint8_t * pucUDPPayloadBuffer,
+                                         size_t uxBufferLength )
+        {
+            BaseType_t xIndex;
+            uint16_t usIdentifier;
+            uint32_t ulIPAddress;
+
+            if( uxBufferLength >= sizeof( DNSMessage_t ) )
+            {
+                usIdentifier = ( ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer ) )->usIdentifier;
+
+                for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
                 {
-                    if( pCallback != NULL )
+                    DNSQuery_t * pxQuery = &( xDNSQueries[ xIndex ] );
+
+                    /* A reply to an earlier attempt is also accepted, all attempts
+                     * use the same identifier. */
+                    if( ( pxQuery->ucState == dnsQUERY_SENT ) && ( pxQuery->usIdentifier == usIdentifier ) )
                     {
-                        if( ulIPAddress == 0U )
+                        ulIPAddress = prvParseDNSReply( pucUDPPayloadBuffer, uxBufferLength, pdTRUE );
+
+                        if( ulIPAddress != 0U )
                         {
-                            /* The user has provided a callback function, so do not block on recvfrom() */
-                            if( xHasRandom != pdFALSE )
-                            {
-                                uxReadTimeOut_ticks = 0U;
-                                vDNSSetCallBack( pcHostName, pvSearchID, pCallback, uxTimeout, uxIdentifier );
-                            }
+                            prvDNSResolverFinish( pxQuery, ulIPAddress );
+                        }
+                        else if( pxQuery->ucAttempts < ( uint8_t ) ipconfigDNS_REQUEST_ATTEMPTS )
+                        {
+                            /* This server did not give an address, ask the next one. */
+                            prvDNSResolverSend( pxQuery );
                         }
                         else
                         {
-                            /* The IP address is known, do the call-back now. */
-                            pCallback( pcHostName, pvSearchID, ulIPAddress );
+                            prvDNSResolverFinish( pxQuery, 0U );
                         }
+
+                        break;
                     }
                 }
-            #endif /* if ( ipconfigDNS_USE_CALLBACKS == 1 ) */
-
-            if( ( ulIPAddress == 0U ) && ( xHasRandom != pdFALSE ) )
-            {
-                ulIPAddress = prvGetHostByName( pcHostName, uxIdentifier, uxReadTimeOut_ticks );
             }
         }
-
-        return ulIPAddress;
-    }
-    /*-----------------------------------------------------------*/
+        /*-----------------------------------------------------------*/
 
 /**
- * @brief Prepare and send a message to a DNS server.  'uxReadTimeOut_ticks' will be passed as
- * zero, in case the user has supplied a call-back function.
- *
- * @param[in] pcHostName: The hostname for which an IP address is required.
- * @param[in] uxIdentifier: Identifier to send in the DNS message.
- * @param[in] uxReadTimeOut_ticks: The timeout in ticks for waiting. In case the user has supplied
- *                                 a call-back function, this value should be zero.
- *
- * @return The IPv4 IP address for the hostname being queried. It will be zero if there is no reply.
+ * @brief Handle the replies received by the resolver, send the new queries, and
+ *        retransmit the queries that have not been answered in time.  Called by
+ *        the IP-task when the DNS timer expires, or when an eDNSResolverEvent
+ *        was received.
  */
-    static uint32_t prvGetHostByName( const char * pcHostName,
-                                      TickType_t uxIdentifier,
-                                      TickType_t uxReadTimeOut_ticks )
-    {
-        struct freertos_sockaddr xAddress;
-        Socket_t xDNSSocket;
-        uint32_t ulIPAddress = 0U;
-        uint32_t ulAddressLength = ( uint32_t ) sizeof( struct freertos_sockaddr );
-        BaseType_t xAttempt;
-        int32_t lBytes;
-        size_t uxPayloadLength, uxExpectedPayloadLength;
-        TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
-
-        #if ( ipconfigUSE_LLMNR == 1 )
-            BaseType_t bHasDot = pdFALSE;
-        #endif /* ipconfigUSE_LLMNR == 1 */
+        void vDNSResolverProcess( void )
+        {
+            BaseType_t xIndex;
+            BaseType_t xBusy = pdFALSE;
+            int32_t lBytes;
+            uint8_t * pucUDPPayload;
+            TickType_t xNow;
 
-        /* If LLMNR is being used then determine if the host name includes a '.' -
-         * if not then LLMNR can be used as the lookup method. */
-        #if ( ipconfigUSE_LLMNR == 1 )
+            if( xDNSResolverSocket == NULL )
             {
-                const char * pucPtr;
+                prvDNSResolverCreateSocket();
+            }
 
-                for( pucPtr = pcHostName; *pucPtr != ( char ) 0; pucPtr++ )
+            if( xDNSResolverSocket != NULL )
+            {
+                for( ; ; )
                 {
-                    if( *pucPtr == '.' )
+                    lBytes = FreeRTOS_recvfrom( xDNSResolverSocket, &( pucUDPPayload ), 0U, FREERTOS_ZERO_COPY, NULL, NULL );
+
+                    if( lBytes <= 0 )
                     {
-                        bHasDot = pdTRUE;
                         break;
                     }
+
+                    prvDNSResolverReply( pucUDPPayload, ( size_t ) lBytes );
+                    FreeRTOS_ReleaseUDPPayloadBuffer( pucUDPPayload );
                 }
             }
-        #endif /* ipconfigUSE_LLMNR == 1 */
-
-        /* Two is added at the end for the count of characters in the first
-         * subdomain part and the string end byte. */
-        uxExpectedPayloadLength = sizeof( DNSMessage_t ) + strlen( pcHostName ) + sizeof( uint16_t ) + sizeof( uint16_t ) + 2U;
 
-        xDNSSocket = prvCreateDNSSocket();
+            xNow = xTaskGetTickCount();
 
-        if( xDNSSocket != NULL )
-        {
-            /* Ideally we should check for the return value. But since we are passing
-             * correct parameters, and xDNSSocket is != NULL, the return value is
-             * going to be '0' i.e. success. Thus, return value is discarded */
-            ( void ) FreeRTOS_setsockopt( xDNSSocket, 0, FREERTOS_SO_SNDTIMEO, &( uxWriteTimeOut_ticks ), sizeof( TickType_t ) );
-            ( void ) FreeRTOS_setsockopt( xDNSSocket, 0, FREERTOS_SO_RCVTIMEO, &( uxReadTimeOut_ticks ), sizeof( TickType_t ) );
-
-            for( xAttempt = 0; xAttempt < ipconfigDNS_REQUEST_ATTEMPTS; xAttempt++ )
+            for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
             {
-                size_t uxHeaderBytes;
-                NetworkBufferDescriptor_t * pxNetworkBuffer;
-                uint8_t * pucUDPPayloadBuffer = NULL, * pucReceiveBuffer;
-
-                /* Get a buffer.  This uses a maximum delay, but the delay will be
-                 * capped to ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS so the return value
-                 * still needs to be tested. */
-
-                uxHeaderBytes = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER;
+                DNSQuery_t * pxQuery = &( xDNSQueries[ xIndex ] );
 
-                pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxHeaderBytes + uxExpectedPayloadLength, 0U );
-
-                if( pxNetworkBuffer != NULL )
+                if( pxQuery->ucState == dnsQUERY_NEW )
                 {
-                    pucUDPPayloadBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ uxHeaderBytes ] );
+                    if( xDNSResolverSocket != NULL )
+                    {
+                        prvDNSResolverSend( pxQuery );
+                    }
+                    else
+                    {
+                        prvDNSResolverFinish( pxQuery, 0U );
+                    }
                 }
-
-                if( pucUDPPayloadBuffer != NULL )
+                else if( pxQuery->ucState == dnsQUERY_SENT )
                 {
-                    /* Create the message in the obtained buffer. */
-                    uxPayloadLength = prvCreateDNSMessage( pucUDPPayloadBuffer, pcHostName, uxIdentifier );
-
-                    iptraceSENDING_DNS_REQUEST();
-
-                    /* Obtain the DNS server address. */
-                    FreeRTOS_GetAddressConfiguration( NULL, NULL, NULL, &ulIPAddress );
-
-                    /* Send the DNS message. */
-                    #if ( ipconfigUSE_LLMNR == 1 )
-                        if( bHasDot == pdFALSE )
-                        {
-                            /* Use LLMNR addressing. */
-                            ( ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer ) )->usFlags = 0;
-                            xAddress.sin_addr = ipLLMNR_IP_ADDR; /* Is in network byte order. */
-                            xAddress.sin_port = ipLLMNR_PORT;
-                            xAddress.sin_port = FreeRTOS_ntohs( xAddress.sin_port );
-                        }
-                        else
-                    #endif
+                    if( ( pxQuery->uxTimeoutTicks != portMAX_DELAY ) &&
+                        ( ( xNow - pxQuery->xStartTime ) >= pxQuery->uxTimeoutTicks ) )
                     {
-                        /* Use DNS server. */
-                        xAddress.sin_addr = ulIPAddress;
-                        xAddress.sin_port = dnsDNS_PORT;
+                        /* The time allowed by the user has passed. */
+                        prvDNSResolverFinish( pxQuery, 0U );
                     }
-
-                    ulIPAddress = 0U;
-
-                    if( FreeRTOS_sendto( xDNSSocket, pucUDPPayloadBuffer, uxPayloadLength, FREERTOS_ZERO_COPY, &xAddress, ( socklen_t ) sizeof( xAddress ) ) != 0 )
+                    else if( ( xNow - pxQuery->xSendTime ) >= ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS )
                     {
-                        /* Wait for the reply. */
-                        lBytes = FreeRTOS_recvfrom( xDNSSocket, &pucReceiveBuffer, 0, FREERTOS_ZERO_COPY, &xAddress, &ulAddressLength );
-
-                        if( lBytes > 0 )
+                        if( pxQuery->ucAttempts < ( uint8_t ) ipconfigDNS_REQUEST_ATTEMPTS )
                         {
-                            BaseType_t xExpected;
-                            const DNSMessage_t * pxDNSMessageHeader = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( DNSMessage_t, pucReceiveBuffer );
-
-                            /* See if the identifiers match. */
-                            if( uxIdentifier == ( TickType_t ) pxDNSMessageHeader->usIdentifier )
-                            {
-                                xExpected = pdTRUE;
-                            }
-                            else
-                            {
-                                /* The reply was not expected. */
-                                xExpected = pdFALSE;
-                            }
-
-                            /* The reply was received.  Process it. */
-                            #if ( ipconfigDNS_USE_CALLBACKS == 0 )
-
-                                /* It is useless to analyse the unexpected reply
-                                 * unless asynchronous look-ups are enabled. */
-                                if( xExpected != pdFALSE )
-                            #endif /* ipconfigDNS_USE_CALLBACKS == 0 */
-                            {
-                                ulIPAddress = prvParseDNSReply( pucReceiveBuffer, ( size_t ) lBytes, xExpected );
-                            }
-
-                            /* Finished with the buffer.  The zero copy interface
-                             * is being used, so the buffer must be freed by the
-                             * task. */
-                            FreeRTOS_ReleaseUDPPayloadBuffer( pucReceiveBuffer );
-
-                            if( ulIPAddress != 0U )
-                            {
-                                /* All done. */
-                                /* coverity[break_stmt] : Break statement terminating the loop */
-                                break;
-                            }
+                            prvDNSResolverSend( pxQuery );
+                        }
+                        else
+                        {
+                            prvDNSResolverFinish( pxQuery, 0U );
                         }
                     }
                     else
                     {
-                        /* The message was not sent so the stack will not be
-                         * releasing the zero copy - it must be released here. */
-                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                        /* Still waiting for a reply. */
                     }
                 }
+                else
+                {
+                    /* This entry is not in use. */
+                }
 
-                if( uxReadTimeOut_ticks == 0U )
+                if( pxQuery->ucState != dnsQUERY_FREE )
                 {
-                    /* This DNS lookup is asynchronous, using a call-back:
-                     * send the request only once. */
-                    break;
+                    xBusy = pdTRUE;
                 }
             }
 
-            /* Finished with the socket. */
-            ( void ) FreeRTOS_closesocket( xDNSSocket );
+            if( xBusy != pdFALSE )
+            {
+                vIPReloadDNSTimer( dnsRESOLVER_POLL_TICKS );
+            }
+            else
+            {
+                /* No outstanding queries. No need for periodic polling. */
+                vIPSetDnsTimerEnableState( pdFALSE );
+            }
         }
-
-        return ulIPAddress;
-    }
-    /*-----------------------------------------------------------*/
+        /*-----------------------------------------------------------*/
 
 /**
- * @brief Create the DNS message in the zero copy buffer passed in the first parameter.
- *
- * @param[in,out] pucUDPPayloadBuffer: The zero copy buffer where the DNS message will be created.
- * @param[in] pcHostName: Hostname to be looked up.
- * @param[in] uxIdentifier: The identifier to be added to the DNS message.
+ * @brief The call-back of a blocking look-up: wake up the waiting task.
  *
- * @return Total size of the generated message, which is the space from the last written byte
- *         to the beginning of the buffer.
+ * @param[in] pcName: The name that was looked up.
+ * @param[in] pvSearchID: The DNSFuture_t of the waiting task.
+ * @param[in] ulIPAddress: The IP-address found, or zero.
  */
-    _static size_t prvCreateDNSMessage( uint8_t * pucUDPPayloadBuffer,
-                                        const char * pcHostName,
-                                        TickType_t uxIdentifier )
-    {
-        DNSMessage_t * pxDNSMessageHeader;
-        size_t uxStart, uxIndex;
-        DNSTail_t const * pxTail;
-        static const DNSMessage_t xDefaultPartDNSHeader =
-        {
-            0,                 /* The identifier will be overwritten. */
-            dnsOUTGOING_FLAGS, /* Flags set for standard query. */
-            dnsONE_QUESTION,   /* One question is being asked. */
-            0,                 /* No replies are included. */
-            0,                 /* No authorities. */
-            0                  /* No additional authorities. */
-        };
-
-        /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
-        const void * pvCopySource;
-        void * pvCopyDest;
-
-        /* Copy in the const part of the header. Intentionally using different
-         * pointers with memcpy() to put the information in to correct place. */
-
-        /*
-         * Use helper variables for memcpy() to remain
-         * compliant with MISRA Rule 21.15.  These should be
-         * optimized away.
-         */
-        pvCopySource = &xDefaultPartDNSHeader;
-        pvCopyDest = pucUDPPayloadBuffer;
-        ( void ) memcpy( pvCopyDest, pvCopySource, sizeof( xDefaultPartDNSHeader ) );
-
-        /* Write in a unique identifier. Cast the Payload Buffer to DNSMessage_t
-         * to easily access fields of the DNS Message. */
-        pxDNSMessageHeader = ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer );
-        pxDNSMessageHeader->usIdentifier = ( uint16_t ) uxIdentifier;
-
-        /* Create the resource record at the end of the header.  First
-         * find the end of the header. */
-        uxStart = sizeof( xDefaultPartDNSHeader );
-
-        /* Leave a gap for the first length byte. */
-        uxIndex = uxStart + 1U;
-
-        /* Copy in the host name. */
-        ( void ) strcpy( ( char * ) &( pucUDPPayloadBuffer[ uxIndex ] ), pcHostName );
-
-        /* Walk through the string to replace the '.' characters with byte
-         * counts.  pucStart holds the address of the byte count.  Walking the
-         * string starts after the byte count position. */
-        uxIndex = uxStart;
-
-        do
+        static void prvDNSResolverWakeUp( const char * pcName,
+                                          void * pvSearchID,
+                                          uint32_t ulIPAddress )
         {
-            size_t uxLength;
-
-            /* Skip the length byte. */
-            uxIndex++;
-
-            while( ( pucUDPPayloadBuffer[ uxIndex ] != ( uint8_t ) 0U ) &&
-                   ( pucUDPPayloadBuffer[ uxIndex ] != ( uint8_t ) ASCII_BASELINE_DOT ) )
-            {
-                uxIndex++;
-            }
-
-            /* Fill in the byte count, then move the pucStart pointer up to
-             * the found byte position. */
-            uxLength = uxIndex - ( uxStart + 1U );
-            pucUDPPayloadBuffer[ uxStart ] = ( uint8_t ) uxLength;
-
-            uxStart = uxIndex;
-        } while( pucUDPPayloadBuffer[ uxIndex ] != ( uint8_t ) 0U );
-
-        /* Finish off the record. Cast the record onto DNSTail_t structure to easily
-         * access the fields of the DNS Message. */
-        pxTail = ipCAST_PTR_TO_TYPE_PTR( DNSTail_t, &( pucUDPPayloadBuffer[ uxStart + 1U ] ) );
-
-        #if defined( _lint ) || defined( __COVERITY__ )
-            ( void ) pxTail;
-        #else
-            vSetField16( pxTail, DNSTail_t, usType, dnsTYPE_A_HOST );
-            vSetField16( pxTail, DNSTail_t, usClass, dnsCLASS_IN );
-        #endif
+            DNSFuture_t * pxFuture = ipCAST_PTR_TO_TYPE_PTR( DNSFuture_t, pvSearchID );
 
-        /* Return the total size of the generated message, which is the space from
-         * the last written byte to the beginning of the buffer. */
-        return uxIndex + sizeof( DNSTail_t ) + 1U;
-    }
-    /*-----------------------------------------------------------*/
+            ( void ) pcName;
 
-    #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
+            pxFuture->ulIPAddress = ulIPAddress;
+            ( void ) xSemaphoreGive( pxFuture->xSemaphore );
+        }
+        /*-----------------------------------------------------------*/
 
 /**
- * @brief Read the Name field out of a DNS response packet.
+ * @brief Submit a query to the resolver.  Without a call-back function, wait
+ *        until the resolver has finished it.
  *
- * @param[in] pucByte: Pointer to the DNS response.
- * @param[in] uxRemainingBytes: Length of the DNS response.
- * @param[out] pcName: The pointer in which the name in the DNS response will be returned.
- * @param[in] uxDestLen: Size of the pcName array.
+ * @param[in] pcHostName: The hostname whose IP address is being searched for.
+ * @param[in] uxIdentifier: Random number to be used as ID in the DNS message.
+ * @param[in] pCallback: The call-back function, or NULL for a blocking look-up.
+ * @param[in] pvSearchID: The search ID passed to the call-back function.
+ * @param[in] uxTimeout: Timeout in ms for the call-back function.
  *
- * @return If a fully formed name was found, then return the number of bytes processed in pucByte.
+ * @return The IP-address found by a blocking look-up, otherwise zero.
  */
-        _static size_t prvReadNameField( const uint8_t * pucByte,
-                                         size_t uxRemainingBytes,
-                                         char * pcName,
-                                         size_t uxDestLen )
+        static uint32_t prvDNSResolverLookup( const char * pcHostName,
+                                              TickType_t uxIdentifier,
+                                              FOnDNSEvent pCallback,
+                                              void * pvSearchID,
+                                              TickType_t uxTimeout )
         {
-            size_t uxNameLen = 0U;
-            size_t uxIndex = 0U;
-            size_t uxSourceLen = uxRemainingBytes;
-
-            /* uxCount gets the values from pucByte and counts down to 0.
-             * No need to have a different type than that of pucByte */
-            size_t uxCount;
-
-            if( uxSourceLen == ( size_t ) 0U )
+            DNSFuture_t xFuture;
+            IPStackEvent_t xEventMessage;
+            DNSQuery_t * pxQuery = NULL;
+            FOnDNSEvent pxOnEvent = pCallback;
+            void * pvID = pvSearchID;
+            TickType_t uxTimeoutTicks = uxTimeout / portTICK_PERIOD_MS;
+            uint16_t usIdentifier = ( uint16_t ) uxIdentifier;
+            BaseType_t xIndex;
+            BaseType_t xUnique;
+
+            xFuture.xSemaphore = NULL;
+            xFuture.ulIPAddress = 0U;
+
+            if( pCallback == NULL )
             {
-                /* Return 0 value in case of error. */
-                uxIndex = 0U;
+                /* A blocking look-up.  The resolver finishes every query, either
+                 * with a reply or after the last attempt has timed out. */
+                xFuture.xSemaphore = xSemaphoreCreateBinary();
+                pxOnEvent = prvDNSResolverWakeUp;
+                pvID = &( xFuture );
+                uxTimeoutTicks = portMAX_DELAY;
             }
 
-            /* Determine if the name is the fully coded name, or an offset to the name
-             * elsewhere in the message. */
-            else if( ( pucByte[ uxIndex ] & dnsNAME_IS_OFFSET ) == dnsNAME_IS_OFFSET )
-            {
-                /* Jump over the two byte offset. */
-                if( uxSourceLen > sizeof( uint16_t ) )
-                {
-                    uxIndex += sizeof( uint16_t );
-                }
-                else
-                {
-                    uxIndex = 0U;
-                }
-            }
-            else
+            if( ( pCallback != NULL ) || ( xFuture.xSemaphore != NULL ) )
             {
-                /* 'uxIndex' points to the full name. Walk over the string. */
-                while( ( uxIndex < uxSourceLen ) && ( pucByte[ uxIndex ] != ( uint8_t ) 0x00U ) )
+                vTaskSuspendAll();
                 {
-                    /* If this is not the first time through the loop, then add a
-                     * separator in the output. */
-                    if( ( uxNameLen > 0U ) )
+                    /* Make the identifier unique among the outstanding queries. */
+                    do
                     {
-                        if( uxNameLen >= uxDestLen )
+                        xUnique = pdTRUE;
+
+                        for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
                         {
-                            uxIndex = 0U;
-                            /* coverity[break_stmt] : Break statement terminating the loop */
-                            break;
+                            if( ( xDNSQueries[ xIndex ].ucState != dnsQUERY_FREE ) && ( xDNSQueries[ xIndex ].usIdentifier == usIdentifier ) )
+                            {
+                                usIdentifier++;
+                                xUnique = pdFALSE;
+                            }
                         }
+                    } while( xUnique == pdFALSE );
 
-                        pcName[ uxNameLen ] = '.';
-                        uxNameLen++;
-                    }
-
-                    /* Process the first/next sub-string. */
-                    uxCount = ( size_t ) pucByte[ uxIndex ];
-                    uxIndex++;
-
-                    if( ( uxIndex + uxCount ) > uxSourceLen )
-                    {
-                        uxIndex = 0U;
-                        break;
-                    }
-
-                    while( uxCount-- != 0U )
+                    for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
                     {
-                        if( uxNameLen >= uxDestLen )
+                        if( xDNSQueries[ xIndex ].ucState == dnsQUERY_FREE )
                         {
-                            uxIndex = 0U;
+                            pxQuery = &( xDNSQueries[ xIndex ] );
+                            ( void ) strcpy( pxQuery->pcName, pcHostName );
+                            pxQuery->pCallbackFunction = pxOnEvent;
+                            pxQuery->pvSearchID = pvID;
+                            pxQuery->xStartTime = xTaskGetTickCount();
+                            pxQuery->uxTimeoutTicks = uxTimeoutTicks;
+                            pxQuery->xSendTime = pxQuery->xStartTime;
+                            pxQuery->usIdentifier = usIdentifier;
+                            pxQuery->ucAttempts = 0U;
+                            pxQuery->ucState = dnsQUERY_NEW;
                             break;
-
-                            /* break out of inner loop here
-                             * break out of outer loop at the test uxNameLen >= uxDestLen. */
                         }
-
-                        pcName[ uxNameLen ] = ( char ) pucByte[ uxIndex ];
-                        uxNameLen++;
-                        uxIndex++;
                     }
                 }
+                ( void ) xTaskResumeAll();
 
-                /* Confirm that a fully formed name was found. */
-                if( uxIndex > 0U )
+                if( pxQuery == NULL )
                 {
-                    /* Here, there is no need to check for pucByte[ uxindex ] == 0 because:
-                     * When we break out of the above while loop, uxIndex is made 0 thereby
-                     * failing above check. Whenever we exit the loop otherwise, either
-                     * pucByte[ uxIndex ] == 0 (which makes the check here unnecessary) or
-                     * uxIndex >= uxSourceLen (which makes sure that we do not go in the 'if'
-                     * case).
-                     */
-                    if( ( uxNameLen < uxDestLen ) && ( uxIndex < uxSourceLen ) )
-                    {
-                        pcName[ uxNameLen ] = '\0';
-                        uxIndex++;
-                    }
-                    else
+                    FreeRTOS_printf( ( "DNS resolver: no room for '%s'\n", pcHostName ) );
+                }
+                else
+                {
+                    /* Wake up the IP-task.  When called from the IP-task, this
+                     * does not block and may fail; the query will then be sent
+                     * when the DNS timer expires. */
+                    xEventMessage.eEventType = eDNSResolverEvent;
+                    xEventMessage.pvData = NULL;
+                    ( void ) xSendEventStructToIPTask( &( xEventMessage ), portMAX_DELAY );
+
+                    if( xFuture.xSemaphore != NULL )
                     {
-                        uxIndex = 0U;
+                        ( void ) xSemaphoreTake( xFuture.xSemaphore, portMAX_DELAY );
                     }
                 }
+
+                if( xFuture.xSemaphore != NULL )
+                {
+                    vSemaphoreDelete( xFuture.xSemaphore );
+                }
             }
 
-            return uxIndex;
+            return xFuture.ulIPAddress;
         }
-    #endif /* ipconfigUSE_DNS_CACHE || ipconfigDNS_USE_CALLBACKS */
-    /*-----------------------------------------------------------*/
+        /*-----------------------------------------------------------*/
 
 /**
- * @brief Simple routine that jumps over the NAME field of a resource record.
+ * @brief Cancel the queries with a given search ID: their call-back function
+ *        will not be called.
  *
- * @param[in] pucByte: The pointer to the resource record.
- * @param[in] uxLength: Length of the resource record.
- *
- * @return It returns the number of bytes read, or zero when an error has occurred.
+ * @param[in] pvSearchID: The search ID of the queries to be cancelled.
  */
-    _static size_t prvSkipNameField( const uint8_t * pucByte,
-                                     size_t uxLength )
-    {
-        size_t uxChunkLength;
-        size_t uxSourceLenCpy = uxLength;
-        size_t uxIndex = 0U;
-
-        if( uxSourceLenCpy == 0U )
+        static void prvDNSResolverCancel( const void * pvSearchID )
         {
-            uxIndex = 0U;
-        }
+            BaseType_t xIndex;
 
-        /* Determine if the name is the fully coded name, or an offset to the name
-         * elsewhere in the message. */
-        else if( ( pucByte[ uxIndex ] & dnsNAME_IS_OFFSET ) == dnsNAME_IS_OFFSET )
-        {
-            /* Jump over the two byte offset. */
-            if( uxSourceLenCpy > sizeof( uint16_t ) )
+            vTaskSuspendAll();
             {
-                uxIndex += sizeof( uint16_t );
-            }
-            else
-            {
-                uxIndex = 0U;
-            }
-        }
-        else
-        {
-            /* pucByte points to the full name. Walk over the string. */
-            while( ( pucByte[ uxIndex ] != 0U ) && ( uxSourceLenCpy > 1U ) )
-            {
-                /* Conversion to size_t causes addition to be done
-                 * in size_t */
-                uxChunkLength = ( ( size_t ) pucByte[ uxIndex ] ) + 1U;
-
-                if( uxSourceLenCpy > uxChunkLength )
-                {
-                    uxSourceLenCpy -= uxChunkLength;
-                    uxIndex += uxChunkLength;
-                }
-                else
-                {
-                    uxIndex = 0U;
-                    break;
-                }
-            }
-
-            /* Confirm that a fully formed name was found. */
-            if( uxIndex > 0U )
-            {
-                if( pucByte[ uxIndex ] == 0U )
+                for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
                 {
-                    uxIndex++;
-                }
-                else
-                {
-                    uxIndex = 0U;
+                    if( ( xDNSQueries[ xIndex ].ucState != dnsQUERY_FREE ) && ( xDNSQueries[ xIndex ].pvSearchID == pvSearchID ) )
+                    {
+                        xDNSQueries[ xIndex ].pCallbackFunction = NULL;
+                    }
                 }
             }
+            ( void ) xTaskResumeAll();
         }
+        /*-----------------------------------------------------------*/
 
-        return uxIndex;
-    }
-    /*-----------------------------------------------------------*/
+    #endif /* ipconfigDNS_USE_RESOLVER != 0 */
 
-/* The function below will only be called :
- * when ipconfigDNS_USE_CALLBACKS == 1
- * when ipconfigUSE_LLMNR == 1
- * for testing purposes, by the module test_freertos_tcp.c
- */
+    #if ( ipconfigDNS_USE_CALLBACKS == 0 )
 
 /**
- * @brief Perform some preliminary checks and then parse the DNS packet.
+ * @brief Get the IP-address corresponding to the given hostname.
  *
- * @param[in] pxNetworkBuffer: The network buffer to be parsed.
+ * @param[in] pcHostName: The hostname whose IP address is being queried.
  *
- * @return Always pdFAIL to indicate that the packet was not consumed and must
- *         be released by the caller.
+ * @return The IP-address corresponding to the hostname.
  */
-    uint32_t ulDNSHandlePacket( const NetworkBufferDescriptor_t * pxNetworkBuffer )
-    {
-        uint8_t * pucPayLoadBuffer;
-        size_t uxPayloadSize;
-
-        /* Only proceed if the payload length indicated in the header
-         * appears to be valid. */
-        if( pxNetworkBuffer->xDataLength >= sizeof( UDPPacket_t ) )
+        uint32_t FreeRTOS_gethostbyname( const char * pcHostName )
         {
-            uxPayloadSize = pxNetworkBuffer->xDataLength - sizeof( UDPPacket_t );
-
-            if( uxPayloadSize >= sizeof( DNSMessage_t ) )
-            {
-                pucPayLoadBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( UDPPacket_t ) ] );
-
-                /* The parameter pdFALSE indicates that the reply was not expected. */
-                ( void ) prvParseDNSReply( pucPayLoadBuffer,
-                                           uxPayloadSize,
-                                           pdFALSE );
-            }
+            return prvPrepareLookup( pcHostName );
         }
-
-        /* The packet was not consumed. */
-        return pdFAIL;
-    }
-    /*-----------------------------------------------------------*/
-
-
-    #if ( ipconfigUSE_NBNS == 1 )
+    #else
 
 /**
- * @brief Handle an NBNS packet.
+ * @brief Get the IP-address corresponding to the given hostname.
  *
- * @param[in] pxNetworkBuffer: The network buffer holding the NBNS packet.
+ * @param[in] pcHostName: The hostname whose IP address is being queried.
+ * @param[in] pCallback: The callback function which will be called upon DNS response.
+ * @param[in] pvSearchID: Search ID for the callback function.
+ * @param[in] uxTimeout: Timeout for the callback function.
  *
- * @return pdFAIL to show that the packet was not consumed.
+ * @return The IP-address corresponding to the hostname.
  */
-        uint32_t ulNBNSHandlePacket( NetworkBufferDescriptor_t * pxNetworkBuffer )
+        uint32_t FreeRTOS_gethostbyname_a( const char * pcHostName,
+                                           FOnDNSEvent pCallback,
+                                           void * pvSearchID,
+                                           TickType_t uxTimeout )
         {
-            UDPPacket_t * pxUDPPacket = ipCAST_PTR_TO_TYPE_PTR( UDPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
-            uint8_t * pucUDPPayloadBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( *pxUDPPacket ) ] );
-
-            prvTreatNBNS( pucUDPPayloadBuffer,
-                          pxNetworkBuffer->xDataLength,
-                          pxUDPPacket->xIPHeader.ulSourceIPAddress );
-
-            /* The packet was not consumed. */
-            return pdFAIL;
+            return prvPrepareLookup( pcHostName, pCallback, pvSearchID, uxTimeout );
         }
+    #endif /* if ( ipconfigDNS_USE_CALLBACKS == 0 ) */
 
-    #endif /* ipconfigUSE_NBNS */
-    /*-----------------------------------------------------------*/
+    #if ( ipconfigDNS_USE_CALLBACKS == 1 )
 
 /**
- * @brief Process a response packet from a DNS server, or an LLMNR reply.
+ * @brief Check if hostname is already known. If not, call prvGetHostByName() to send a DNS request.
  *
- * @param[in] pucUDPPayloadBuffer: The DNS response received as a UDP
- *                                 payload.
- * @param[in] uxBufferLength: Length of the UDP payload buffer.
- * @param[in] xExpected: indicates whether the identifier in the reply
- *                       was expected, and thus if the DNS cache may be
- *                       updated with the reply.
+ * @param[in] pcHostName: The hostname whose IP address is being queried.
+ * @param[in] pCallback: The callback function which will be called upon DNS response.
+ * @param[in] pvSearchID: Search ID for the callback function.
+ * @param[in] uxTimeout: Timeout for the callback function.
  *
- * @return The IP address in the DNS response if present and if xExpected is set to pdTRUE.
- *         An error code (dnsPARSE_ERROR) if there was an error in the DNS response.
- *         0 if xExpected set to pdFALSE.
+ * @return The IP-address corresponding to the hostname.
  */
-    _static uint32_t prvParseDNSReply( uint8_t * pucUDPPayloadBuffer,
-                                       size_t uxBufferLength,
-                                       BaseType_t xExpected )
+        static uint32_t prvPrepareLookup( const char * pcHostName,
+                                          FOnDNSEvent pCallback,
+                                          void * pvSearchID,
+                                          TickType_t uxTimeout )
+    #else
+
+/**
+ * @brief Check if hostname is already known. If not, call prvGetHostByName() to send a DNS request.
+ *
+ * @param[in] pcHostName: The hostname whose IP address is being queried.
+ *
+ * @return The IP-address corresponding to the hostname.
+ */
+        static uint32_t prvPrepareLookup( const char * pcHostName )
+    #endif
     {
-        DNSMessage_t * pxDNSMessageHeader;
-        /* This pointer is not used to modify anything */
-        const DNSAnswerRecord_t * pxDNSAnswerRecord;
         uint32_t ulIPAddress = 0U;
 
-        #if ( ipconfigUSE_LLMNR == 1 )
-            char * pcRequestedName = NULL;
+        #if ( ipconfigDNS_USE_RESOLVER == 0 )
+            TickType_t uxReadTimeOut_ticks = ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS;
         #endif
-        uint8_t * pucByte;
-        size_t uxSourceBytesRemaining;
-        uint16_t x, usDataLength, usQuestions;
-        uint16_t usType = 0U;
-        BaseType_t xReturn = pdTRUE;
-        /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
-        const void * pvCopySource;
-        void * pvCopyDest;
 
-        #if ( ipconfigUSE_LLMNR == 1 )
-            uint16_t usClass = 0U;
-        #endif
-        #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
-            BaseType_t xDoStore = xExpected;
-            char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ] = "";
-        #endif
-        const size_t uxAddressLength = ipSIZE_OF_IPv4_ADDRESS;
+        /* Generate a unique identifier for this query. Keep it in a local variable
+         * as gethostbyname() may be called from different threads */
+        BaseType_t xHasRandom = pdFALSE;
+        TickType_t uxIdentifier = 0U;
+        BaseType_t xLengthOk = pdFALSE;
+        BaseType_t xIsNegative = pdFALSE;
 
-        /* Ensure that the buffer is of at least minimal DNS message length. */
-        if( uxBufferLength < sizeof( DNSMessage_t ) )
-        {
-            xReturn = pdFALSE;
-        }
-        else
+        if( pcHostName != NULL )
         {
-            uxSourceBytesRemaining = uxBufferLength;
-
-            /* Parse the DNS message header. Map the byte stream onto a structure
-             * for easier access. */
-            pxDNSMessageHeader = ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer );
+            size_t uxLength = strlen( pcHostName ) + 1U;
 
-            /* Introduce a do {} while (0) to allow the use of breaks. */
-            do
+            #if ( ipconfigUSE_DNS_CACHE != 0 )
+                if( uxLength <= ipconfigDNS_CACHE_NAME_LENGTH )
+            #else
+                if( uxLength <= dnsMAX_HOSTNAME_LENGTH )
+            #endif
             {
-                size_t uxBytesRead = 0U;
-                size_t uxResult;
-
-                /* Start at the first byte after the header. */
-                pucByte = &( pucUDPPayloadBuffer[ sizeof( DNSMessage_t ) ] );
-                uxSourceBytesRemaining -= sizeof( DNSMessage_t );
+                /* The name is not too long. */
+                xLengthOk = pdTRUE;
+            }
+            else
+            {
+                FreeRTOS_printf( ( "prvPrepareLookup: name is too long ( %u > %u )\n",
+                                   ( unsigned ) uxLength,
+                                   ( unsigned ) ipconfigDNS_CACHE_NAME_LENGTH ) );
+            }
+        }
 
-                /* Skip any question records. */
-                usQuestions = FreeRTOS_ntohs( pxDNSMessageHeader->usQuestions );
+        if( ( pcHostName != NULL ) && ( xLengthOk != pdFALSE ) )
+        {
+            /* If the supplied hostname is IP address, convert it to uint32_t
+             * and return. */
+            #if ( ipconfigINCLUDE_FULL_INET_ADDR == 1 )
+                {
+                    ulIPAddress = FreeRTOS_inet_addr( pcHostName );
+                }
+            #endif /* ipconfigINCLUDE_FULL_INET_ADDR == 1 */
 
-                for( x = 0U; x < usQuestions; x++ )
+            /* If a DNS cache is used then check the cache before issuing another DNS
+             * request. */
+            #if ( ipconfigUSE_DNS_CACHE == 1 )
                 {
-                    #if ( ipconfigUSE_LLMNR == 1 )
+                    if( ulIPAddress == 0U )
+                    {
+                        ulIPAddress = FreeRTOS_dnslookup( pcHostName );
+
+                        if( ulIPAddress != 0U )
                         {
-                            if( x == 0U )
-                            {
-                                pcRequestedName = ( char * ) pucByte;
-                            }
+                            FreeRTOS_debug_printf( ( "FreeRTOS_gethostbyname: found '%s' in cache: %xip\n", pcHostName, ( unsigned ) ulIPAddress ) );
                         }
-                    #endif
-
-                    #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
-                        if( x == 0U )
+                        else
                         {
-                            uxResult = prvReadNameField( pucByte,
-                                                         uxSourceBytesRemaining,
-                                                         pcName,
-                                                         sizeof( pcName ) );
-
-                            /* Check for a malformed response. */
-                            if( uxResult == 0U )
-                            {
-                                xReturn = pdFALSE;
-                                break;
-                            }
+                            #if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+                                if( prvDNSCacheIsNegative( pcHostName ) != pdFALSE )
+                                {
+                                    /* The name is known to have no address.  Do not ask
+                                     * again before the negative answer expires. */
+                                    xIsNegative = pdTRUE;
 
-                            uxBytesRead += uxResult;
-                            pucByte = &( pucByte[ uxResult ] );
-                            uxSourceBytesRemaining -= uxResult;
+                                    #if ( ipconfigDNS_USE_CALLBACKS == 1 )
+                                        if( pCallback != NULL )
+                                        {
+                                            pCallback( pcHostName, pvSearchID, 0U );
+                                        }
+                                    #endif
+                                }
+                            #endif /* ipconfigUSE_DNS_CACHE_HASH */
+                            /* prvGetHostByName will be called to start a DNS lookup. */
                         }
-                        else
-                    #endif /* ipconfigUSE_DNS_CACHE || ipconfigDNS_USE_CALLBACKS */
-                    {
-                        /* Skip the variable length pcName field. */
-                        uxResult = prvSkipNameField( pucByte,
-                                                     uxSourceBytesRemaining );
+                    }
+                }
+            #endif /* ipconfigUSE_DNS_CACHE == 1 */
+
+            /* Generate a unique identifier. */
+            if( ( ulIPAddress == 0U ) && ( xIsNegative == pdFALSE ) )
+            {
+                uint32_t ulNumber = 0U;
+
+                xHasRandom = xApplicationGetRandomNumber( &( ulNumber ) );
+                /* DNS identifiers are 16-bit. */
+                uxIdentifier = ( TickType_t ) ( ulNumber & 0xffffU );
+            }
 
-                        /* Check for a malformed response. */
-                        if( uxResult == 0U )
+            #if ( ipconfigDNS_USE_RESOLVER != 0 )
+                {
+                    if( ulIPAddress != 0U )
+                    {
+                        if( pCallback != NULL )
                         {
-                            xReturn = pdFALSE;
-                            break;
+                            /* The IP address is known, do the call-back now. */
+                            pCallback( pcHostName, pvSearchID, ulIPAddress );
                         }
-
-                        uxBytesRead += uxResult;
-                        pucByte = &( pucByte[ uxResult ] );
-                        uxSourceBytesRemaining -= uxResult;
                     }
-
-                    /* Check the remaining buffer size. */
-                    if( uxSourceBytesRemaining >= sizeof( uint32_t ) )
+                    else if( xHasRandom != pdFALSE )
                     {
-                        #if ( ipconfigUSE_LLMNR == 1 )
-                            {
-                                /* usChar2u16 returns value in host endianness. */
-                                usType = usChar2u16( pucByte );
-                                usClass = usChar2u16( &( pucByte[ 2 ] ) );
-                            }
-                        #endif /* ipconfigUSE_LLMNR */
-
-                        /* Skip the type and class fields. */
-                        pucByte = &( pucByte[ sizeof( uint32_t ) ] );
-                        uxSourceBytesRemaining -= sizeof( uint32_t );
+                        /* Let the resolver in the IP-task send the query. */
+                        ulIPAddress = prvDNSResolverLookup( pcHostName, uxIdentifier, pCallback, pvSearchID, uxTimeout );
                     }
                     else
                     {
-                        xReturn = pdFALSE;
-                        break;
+                        /* No identifier could be generated. */
                     }
                 }
-
-                if( xReturn == pdFALSE )
-                {
-                    /* No need to proceed. Break out of the do-while loop. */
-                    break;
-                }
-
-                /* Search through the answer records. */
-                pxDNSMessageHeader->usAnswers = FreeRTOS_ntohs( pxDNSMessageHeader->usAnswers );
-
-                if( ( pxDNSMessageHeader->usFlags & dnsRX_FLAGS_MASK ) == dnsEXPECTED_RX_FLAGS )
+            #elif ( ipconfigDNS_USE_CALLBACKS == 1 )
                 {
-                    const uint16_t usCount = ( uint16_t ) ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY;
-                    uint16_t usNumARecordsStored = 0;
-
-                    for( x = 0U; x < pxDNSMessageHeader->usAnswers; x++ )
+                    if( pCallback != NULL )
                     {
-                        BaseType_t xDoAccept;
-
-                        if( usNumARecordsStored >= usCount )
+                        if( ulIPAddress == 0U )
                         {
-                            /* Only count ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY number of records. */
-                            break;
+                            /* The user has provided a callback function, so do not block on recvfrom() */
+                            if( xHasRandom != pdFALSE )
+                            {
+                                uxReadTimeOut_ticks = 0U;
+                                vDNSSetCallBack( pcHostName, pvSearchID, pCallback, uxTimeout, uxIdentifier );
+                            }
                         }
-
-                        uxResult = prvSkipNameField( pucByte,
-                                                     uxSourceBytesRemaining );
-
-                        /* Check for a malformed response. */
-                        if( uxResult == 0U )
+                        else
                         {
-                            xReturn = pdFALSE;
-                            break;
+                            /* The IP address is known, do the call-back now. */
+                            pCallback( pcHostName, pvSearchID, ulIPAddress );
                         }
+                    }
+                }
+            #endif /* if ( ipconfigDNS_USE_RESOLVER != 0 ) */
+
+            #if ( ipconfigDNS_USE_RESOLVER == 0 )
+                if( ( ulIPAddress == 0U ) && ( xHasRandom != pdFALSE ) )
+                {
+                    ulIPAddress = prvGetHostByName( pcHostName, uxIdentifier, uxReadTimeOut_ticks );
+                }
+            #endif
+        }
 
-                        uxBytesRead += uxResult;
-                        pucByte = &( pucByte[ uxResult ] );
-                        uxSourceBytesRemaining -= uxResult;
+        return ulIPAddress;
+    }
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigDNS_USE_RESOLVER == 0 )
+/**
+ * @brief Prepare and send a message to a DNS server.  'uxReadTimeOut_ticks' will be passed as
+ * zero, in case the user has supplied a call-back function.
+ *
+ * @param[in] pcHostName: The hostname for which an IP address is required.
+ * @param[in] uxIdentifier: Identifier to send in the DNS message.
+ * @param[in] uxReadTimeOut_ticks: The timeout in ticks for waiting. In case the user has supplied
+ *                                 a call-back function, this value should be zero.
+ *
+ * @return The IPv4 IP address for the hostname being queried. It will be zero if there is no reply.
+ */
+        static uint32_t prvGetHostByName( const char * pcHostName,
+                                          TickType_t uxIdentifier,
+                                          TickType_t uxReadTimeOut_ticks )
+        {
+            struct freertos_sockaddr xAddress;
+            Socket_t xDNSSocket;
+            uint32_t ulIPAddress = 0U;
+            uint32_t ulAddressLength = ( uint32_t ) sizeof( struct freertos_sockaddr );
+            BaseType_t xAttempt;
+            int32_t lBytes;
+            size_t uxPayloadLength, uxExpectedPayloadLength;
+            TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
+
+            #if ( ipconfigUSE_LLMNR == 1 )
+                BaseType_t bHasDot = pdFALSE;
+            #endif /* ipconfigUSE_LLMNR == 1 */
+
+            /* If LLMNR is being used then determine if the host name includes a '.' -
+             * if not then LLMNR can be used as the lookup method. */
+            #if ( ipconfigUSE_LLMNR == 1 )
+                {
+                    const char * pucPtr;
 
-                        /* Is there enough data for an IPv4 A record answer and, if so,
-                         * is this an A record? */
-                        if( uxSourceBytesRemaining < sizeof( uint16_t ) )
+                    for( pucPtr = pcHostName; *pucPtr != ( char ) 0; pucPtr++ )
+                    {
+                        if( *pucPtr == '.' )
                         {
-                            xReturn = pdFALSE;
+                            bHasDot = pdTRUE;
                             break;
                         }
+                    }
+                }
+            #endif /* ipconfigUSE_LLMNR == 1 */
 
-                        usType = usChar2u16( pucByte );
+            /* Two is added at the end for the count of characters in the first
+             * subdomain part and the string end byte. */
+            uxExpectedPayloadLength = sizeof( DNSMessage_t ) + strlen( pcHostName ) + sizeof( uint16_t ) + sizeof( uint16_t ) + 2U;
 
-                        if( usType == ( uint16_t ) dnsTYPE_A_HOST )
-                        {
-                            if( uxSourceBytesRemaining >= ( sizeof( DNSAnswerRecord_t ) + uxAddressLength ) )
-                            {
-                                xDoAccept = pdTRUE;
-                            }
-                            else
-                            {
-                                xDoAccept = pdFALSE;
-                            }
-                        }
-                        else
-                        {
-                            /* Unknown host type. */
-                            xDoAccept = pdFALSE;
-                        }
+            xDNSSocket = prvCreateDNSSocket();
 
-                        if( xDoAccept != pdFALSE )
-                        {
-                            /* This is the required record type and is of sufficient size. */
+            if( xDNSSocket != NULL )
+            {
+                /* Ideally we should check for the return value. But since we are passing
+                 * correct parameters, and xDNSSocket is != NULL, the return value is
+                 * going to be '0' i.e. success. Thus, return value is discarded */
+                ( void ) FreeRTOS_setsockopt( xDNSSocket, 0, FREERTOS_SO_SNDTIMEO, &( uxWriteTimeOut_ticks ), sizeof( TickType_t ) );
+                ( void ) FreeRTOS_setsockopt( xDNSSocket, 0, FREERTOS_SO_RCVTIMEO, &( uxReadTimeOut_ticks ), sizeof( TickType_t ) );
 
-                            /* Mapping pucByte to a DNSAnswerRecord allows easy access of the
-                             * fields of the structure. */
-                            pxDNSAnswerRecord = ipCAST_PTR_TO_TYPE_PTR( DNSAnswerRecord_t, pucByte );
+                for( xAttempt = 0; xAttempt < ipconfigDNS_REQUEST_ATTEMPTS; xAttempt++ )
+                {
+                    size_t uxHeaderBytes;
+                    NetworkBufferDescriptor_t * pxNetworkBuffer;
+                    uint8_t * pucUDPPayloadBuffer = NULL, * pucReceiveBuffer;
 
-                            /* Sanity check the data length of an IPv4 answer. */
-                            if( FreeRTOS_ntohs( pxDNSAnswerRecord->usDataLength ) == ( uint16_t ) uxAddressLength )
-                            {
-                                /* Copy the IP address out of the record. Using different pointers
-                                 * to copy only the portion we want is intentional here. */
-
-                                /*
-                                 * Use helper variables for memcpy() to remain
-                                 * compliant with MISRA Rule 21.15.  These should be
-                                 * optimized away.
-                                 */
-                                pvCopySource = &pucByte[ sizeof( DNSAnswerRecord_t ) ];
-                                pvCopyDest = &ulIPAddress;
-                                ( void ) memcpy( pvCopyDest, pvCopySource, uxAddressLength );
-
-                                #if ( ipconfigDNS_USE_CALLBACKS == 1 )
-                                    {
-                                        /* See if any asynchronous call was made to FreeRTOS_gethostbyname_a() */
-                                        if( xDNSDoCallback( ( TickType_t ) pxDNSMessageHeader->usIdentifier, pcName, ulIPAddress ) != pdFALSE )
-                                        {
-                                            /* This device has requested this DNS look-up.
-                                             * The result may be stored in the DNS cache. */
-                                            xDoStore = pdTRUE;
-                                        }
-                                    }
-                                #endif /* ipconfigDNS_USE_CALLBACKS == 1 */
-                                #if ( ipconfigUSE_DNS_CACHE == 1 )
-                                    {
-                                        char cBuffer[ 16 ];
+                    /* Get a buffer.  This uses a maximum delay, but the delay will be
+                     * capped to ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS so the return value
+                     * still needs to be tested. */
 
-                                        /* The reply will only be stored in the DNS cache when the
-                                         * request was issued by this device. */
-                                        if( xDoStore != pdFALSE )
-                                        {
-                                            ( void ) prvProcessDNSCache( pcName, &ulIPAddress, pxDNSAnswerRecord->ulTTL, pdFALSE );
-                                            usNumARecordsStored++; /* Track # of A records stored */
-                                        }
+                    uxHeaderBytes = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER;
 
-                                        ( void ) FreeRTOS_inet_ntop( FREERTOS_AF_INET, ( const void * ) &( ulIPAddress ), cBuffer, ( socklen_t ) sizeof( cBuffer ) );
-                                        /* Show what has happened. */
-                                        FreeRTOS_printf( ( "DNS[0x%04lX]: The answer to '%s' (%s) will%s be stored\n",
-                                                           ( UBaseType_t ) pxDNSMessageHeader->usIdentifier,
-                                                           pcName,
-                                                           cBuffer,
-                                                           ( xDoStore != 0 ) ? "" : " NOT" ) );
-                                    }
-                                #endif /* ipconfigUSE_DNS_CACHE */
-                            }
+                    pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxHeaderBytes + uxExpectedPayloadLength, 0U );
 
-                            pucByte = &( pucByte[ sizeof( DNSAnswerRecord_t ) + uxAddressLength ] );
-                            uxSourceBytesRemaining -= ( sizeof( DNSAnswerRecord_t ) + uxAddressLength );
-                        }
-                        else if( uxSourceBytesRemaining >= sizeof( DNSAnswerRecord_t ) )
-                        {
-                            /* It's not an A record, so skip it. Get the header location
-                             * and then jump over the header. */
-                            /* Cast the response to DNSAnswerRecord for easy access to fields of the DNS response. */
-                            pxDNSAnswerRecord = ipCAST_PTR_TO_TYPE_PTR( DNSAnswerRecord_t, pucByte );
+                    if( pxNetworkBuffer != NULL )
+                    {
+                        pucUDPPayloadBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ uxHeaderBytes ] );
+                    }
+
+                    if( pucUDPPayloadBuffer != NULL )
+                    {
+                        /* Create the message in the obtained buffer. */
+                        uxPayloadLength = prvCreateDNSMessage( pucUDPPayloadBuffer, pcHostName, uxIdentifier );
 
-                            pucByte = &( pucByte[ sizeof( DNSAnswerRecord_t ) ] );
-                            uxSourceBytesRemaining -= sizeof( DNSAnswerRecord_t );
+                        iptraceSENDING_DNS_REQUEST();
 
-                            /* Determine the length of the answer data from the header. */
-                            usDataLength = FreeRTOS_ntohs( pxDNSAnswerRecord->usDataLength );
+                        /* Obtain the DNS server address. */
+                        FreeRTOS_GetAddressConfiguration( NULL, NULL, NULL, &ulIPAddress );
 
-                            /* Jump over the answer. */
-                            if( uxSourceBytesRemaining >= usDataLength )
+                        /* Send the DNS message. */
+                        #if ( ipconfigUSE_LLMNR == 1 )
+                            if( bHasDot == pdFALSE )
                             {
-                                pucByte = &( pucByte[ usDataLength ] );
-                                uxSourceBytesRemaining -= usDataLength;
+                                /* Use LLMNR addressing. */
+                                ( ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer ) )->usFlags = 0;
+                                xAddress.sin_addr = ipLLMNR_IP_ADDR; /* Is in network byte order. */
+                                xAddress.sin_port = ipLLMNR_PORT;
+                                xAddress.sin_port = FreeRTOS_ntohs( xAddress.sin_port );
                             }
                             else
+                        #endif
+                        #if ( ipconfigUSE_MDNS != 0 )
+                            if( prvMDNSIsLocalName( pcHostName ) != pdFALSE )
                             {
-                                /* Malformed response. */
-                                xReturn = pdFALSE;
-                                break;
+                                /* Use a one-shot mDNS query. */
+                                ( ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer ) )->usFlags = 0;
+                                xAddress.sin_addr = ipMDNS_IP_ADDR; /* Is in network byte order. */
+                                xAddress.sin_port = FreeRTOS_htons( ipMDNS_PORT );
                             }
-                        }
-                        else
+                            else
+                        #endif
                         {
-                            /* Do nothing */
+                            /* Use DNS server. */
+                            xAddress.sin_addr = ulIPAddress;
+                            xAddress.sin_port = dnsDNS_PORT;
                         }
-                    }
-                }
 
-                #if ( ipconfigUSE_LLMNR == 1 )
+                        ulIPAddress = 0U;
 
-                    /* No need to check that pcRequestedName != NULL since is usQuestions != 0, then
-                     * pcRequestedName is assigned with this statement
-                     * "pcRequestedName = ( char * ) pucByte;" */
-                    else if( ( usQuestions != ( uint16_t ) 0U ) && ( usType == dnsTYPE_A_HOST ) && ( usClass == dnsCLASS_IN ) )
-                    {
-                        /* If this is not a reply to our DNS request, it might an LLMNR
-                         * request. */
-                        if( xApplicationDNSQueryHook( &( pcRequestedName[ 1 ] ) ) != pdFALSE )
+                        if( FreeRTOS_sendto( xDNSSocket, pucUDPPayloadBuffer, uxPayloadLength, FREERTOS_ZERO_COPY, &xAddress, ( socklen_t ) sizeof( xAddress ) ) != 0 )
                         {
-                            int16_t usLength;
-                            NetworkBufferDescriptor_t * pxNewBuffer = NULL;
-                            NetworkBufferDescriptor_t * pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pucUDPPayloadBuffer );
-                            LLMNRAnswer_t * pxAnswer;
-                            uint8_t * pucNewBuffer = NULL;
+                            /* Wait for the reply. */
+                            lBytes = FreeRTOS_recvfrom( xDNSSocket, &pucReceiveBuffer, 0, FREERTOS_ZERO_COPY, &xAddress, &ulAddressLength );
 
-                            if( pxNetworkBuffer != NULL )
+                            if( lBytes > 0 )
                             {
-                                if( xBufferAllocFixedSize == pdFALSE )
-                                {
-                                    size_t uxDataLength = uxBufferLength + sizeof( UDPHeader_t ) + sizeof( EthernetHeader_t ) + sizeof( IPHeader_t );
-
-                                    /* Set the size of the outgoing packet. */
-                                    pxNetworkBuffer->xDataLength = uxDataLength;
-                                    pxNewBuffer = pxDuplicateNetworkBufferWithDescriptor( pxNetworkBuffer, uxDataLength + sizeof( LLMNRAnswer_t ) );
-
-                                    if( pxNewBuffer != NULL )
-                                    {
-                                        BaseType_t xOffset1, xOffset2;
-
-                                        xOffset1 = ( BaseType_t ) ( pucByte - pucUDPPayloadBuffer );
-                                        xOffset2 = ( BaseType_t ) ( ( ( uint8_t * ) pcRequestedName ) - pucUDPPayloadBuffer );
-
-                                        pxNetworkBuffer = pxNewBuffer;
-                                        pucNewBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] );
+                                BaseType_t xExpected;
+                                const DNSMessage_t * pxDNSMessageHeader = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( DNSMessage_t, pucReceiveBuffer );
 
-                                        pucByte = &( pucNewBuffer[ xOffset1 ] );
-                                        pcRequestedName = ( char * ) &( pucNewBuffer[ xOffset2 ] );
-                                        pxDNSMessageHeader = ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucNewBuffer );
-                                    }
-                                    else
-                                    {
-                                        /* Just to indicate that the message may not be answered. */
-                                        pxNetworkBuffer = NULL;
-                                    }
+                                /* See if the identifiers match. */
+                                if( uxIdentifier == ( TickType_t ) pxDNSMessageHeader->usIdentifier )
+                                {
+                                    xExpected = pdTRUE;
                                 }
                                 else
                                 {
-                                    pucNewBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] );
+                                    /* The reply was not expected. */
+                                    xExpected = pdFALSE;
                                 }
-                            }
-
-                            /* The test on 'pucNewBuffer' is only to satisfy lint. */
-                            if( ( pxNetworkBuffer != NULL ) && ( pucNewBuffer != NULL ) )
-                            {
-                                pxAnswer = ipCAST_PTR_TO_TYPE_PTR( LLMNRAnswer_t, pucByte );
-
-                                /* We leave 'usIdentifier' and 'usQuestions' untouched */
-                                #ifndef _lint
-                                    vSetField16( pxDNSMessageHeader, DNSMessage_t, usFlags, dnsLLMNR_FLAGS_IS_REPONSE ); /* Set the response flag */
-                                    vSetField16( pxDNSMessageHeader, DNSMessage_t, usAnswers, 1 );                       /* Provide a single answer */
-                                    vSetField16( pxDNSMessageHeader, DNSMessage_t, usAuthorityRRs, 0 );                  /* No authority */
-                                    vSetField16( pxDNSMessageHeader, DNSMessage_t, usAdditionalRRs, 0 );                 /* No additional info */
-                                #endif /* lint */
 
-                                pxAnswer->ucNameCode = dnsNAME_IS_OFFSET;
-                                pxAnswer->ucNameOffset = ( uint8_t ) ( pcRequestedName - ( char * ) pucNewBuffer );
+                                /* The reply was received.  Process it. */
+                                #if ( ipconfigDNS_USE_CALLBACKS == 0 )
 
-                                #ifndef _lint
-                                    vSetField16( pxAnswer, LLMNRAnswer_t, usType, dnsTYPE_A_HOST ); /* Type A: host */
-                                    vSetField16( pxAnswer, LLMNRAnswer_t, usClass, dnsCLASS_IN );   /* 1: Class IN */
-                                    vSetField32( pxAnswer, LLMNRAnswer_t, ulTTL, dnsLLMNR_TTL_VALUE );
-                                    vSetField16( pxAnswer, LLMNRAnswer_t, usDataLength, 4 );
-                                    vSetField32( pxAnswer, LLMNRAnswer_t, ulIPAddress, FreeRTOS_ntohl( *ipLOCAL_IP_ADDRESS_POINTER ) );
-                                #endif /* lint */
-                                usLength = ( int16_t ) ( sizeof( *pxAnswer ) + ( size_t ) ( pucByte - pucNewBuffer ) );
+                                    /* It is useless to analyse the unexpected reply
+                                     * unless asynchronous look-ups are enabled. */
+                                    if( xExpected != pdFALSE )
+                                #endif /* ipconfigDNS_USE_CALLBACKS == 0 */
+                                {
+                                    ulIPAddress = prvParseDNSReply( pucReceiveBuffer, ( size_t ) lBytes, xExpected );
+                                }
 
-                                prvReplyDNSMessage( pxNetworkBuffer, usLength );
+                                /* Finished with the buffer.  The zero copy interface
+                                 * is being used, so the buffer must be freed by the
+                                 * task. */
+                                FreeRTOS_ReleaseUDPPayloadBuffer( pucReceiveBuffer );
 
-                                if( pxNewBuffer != NULL )
+                                if( ulIPAddress != 0U )
                                 {
-                                    vReleaseNetworkBufferAndDescriptor( pxNewBuffer );
+                                    /* All done. */
+                                    /* coverity[break_stmt] : Break statement terminating the loop */
+                                    break;
                                 }
                             }
                         }
+                        else
+                        {
+                            /* The message was not sent so the stack will not be
+                             * releasing the zero copy - it must be released here. */
+                            vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                        }
                     }
-                    else
+
+                    if( uxReadTimeOut_ticks == 0U )
                     {
-                        /* Not an expected reply. */
+                        /* This DNS lookup is asynchronous, using a call-back:
+                         * send the request only once. */
+                        break;
                     }
-                #endif /* ipconfigUSE_LLMNR == 1 */
-                ( void ) uxBytesRead;
-            } while( ipFALSE_BOOL );
-        }
-
-        if( xReturn == pdFALSE )
-        {
-            /* There was an error while parsing the DNS response. Return error code. */
-            ulIPAddress = dnsPARSE_ERROR;
-        }
-        else if( xExpected == pdFALSE )
-        {
-            /* Do not return a valid IP-address in case the reply was not expected. */
-            ulIPAddress = 0U;
-        }
-        else
-        {
-            /* The IP-address found will be returned. */
-        }
+                }
 
-        #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
-            ( void ) xDoStore;
-        #endif
+                /* Finished with the socket. */
+                ( void ) FreeRTOS_closesocket( xDNSSocket );
+            }
 
-        return ulIPAddress;
-    }
+            return ulIPAddress;
+        }
+    #endif /* ipconfigDNS_USE_RESOLVER == 0 */
     /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_NBNS == 1 )
-
 /**
- * @brief Respond to an NBNS query or an NBNS reply.
+ * @brief Create the DNS message in the zero copy buffer passed in the first parameter.
  *
- * @param[in] pucPayload: the UDP payload of the NBNS message.
- * @param[in] uxBufferLength: Length of the Buffer.
- * @param[in] ulIPAddress: IP address of the sender.
+ * @param[in,out] pucUDPPayloadBuffer: The zero copy buffer where the DNS message will be created.
+ * @param[in] pcHostName: Hostname to be looked up.
+ * @param[in] uxIdentifier: The identifier to be added to the DNS message.
+ *
+ * @return Total size of the generated message, which is the space from the last written byte
+ *         to the beginning of the buffer.
  */
-        static void prvTreatNBNS( uint8_t * pucPayload,
-                                  size_t uxBufferLength,
-                                  uint32_t ulIPAddress )
+    _static size_t prvCreateDNSMessage( uint8_t * pucUDPPayloadBuffer,
+                                        const char * pcHostName,
+                                        TickType_t uxIdentifier )
+    {
+        DNSMessage_t * pxDNSMessageHeader;
+        size_t uxStart, uxIndex;
+        DNSTail_t const * pxTail;
+        static const DNSMessage_t xDefaultPartDNSHeader =
         {
-            uint16_t usFlags, usType, usClass;
-            uint8_t * pucSource, * pucTarget;
-            uint8_t ucByte;
-            uint8_t ucNBNSName[ 17 ];
-            uint8_t * pucUDPPayloadBuffer = pucPayload;
-            NetworkBufferDescriptor_t * pxNetworkBuffer;
-            size_t uxBytesNeeded = sizeof( UDPPacket_t ) + sizeof( NBNSRequest_t );
+            0,                 /* The identifier will be overwritten. */
+            dnsOUTGOING_FLAGS, /* Flags set for standard query. */
+            dnsONE_QUESTION,   /* One question is being asked. */
+            0,                 /* No replies are included. */
+            0,                 /* No authorities. */
+            0                  /* No additional authorities. */
+        };
 
-            /* Check for minimum buffer size. */
-            if( uxBufferLength < uxBytesNeeded )
-            {
-                return;
-            }
+        /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
+        const void * pvCopySource;
+        void * pvCopyDest;
 
-            /* Read the request flags in host endianness. */
-            usFlags = usChar2u16( &( pucUDPPayloadBuffer[ offsetof( NBNSRequest_t, usFlags ) ] ) );
+        /* Copy in the const part of the header. Intentionally using different
+         * pointers with memcpy() to put the information in to correct place. */
 
-            if( ( usFlags & dnsNBNS_FLAGS_OPCODE_MASK ) == dnsNBNS_FLAGS_OPCODE_QUERY )
-            {
-                usType = usChar2u16( &( pucUDPPayloadBuffer[ offsetof( NBNSRequest_t, usType ) ] ) );
-                usClass = usChar2u16( &( pucUDPPayloadBuffer[ offsetof( NBNSRequest_t, usClass ) ] ) );
+        /*
+         * Use helper variables for memcpy() to remain
+         * compliant with MISRA Rule 21.15.  These should be
+         * optimized away.
+         */
+        pvCopySource = &xDefaultPartDNSHeader;
+        pvCopyDest = pucUDPPayloadBuffer;
+        ( void ) memcpy( pvCopyDest, pvCopySource, sizeof( xDefaultPartDNSHeader ) );
 
-                /* Not used for now */
-                ( void ) usClass;
+        /* Write in a unique identifier. Cast the Payload Buffer to DNSMessage_t
+         * to easily access fields of the DNS Message. */
+        pxDNSMessageHeader = ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer );
+        pxDNSMessageHeader->usIdentifier = ( uint16_t ) uxIdentifier;
 
-                /* For NBNS a name is 16 bytes long, written with capitals only.
+        /* Create the resource record at the end of the header.  First
+         * find the end of the header. */
+        uxStart = sizeof( xDefaultPartDNSHeader );
+
+        /* Leave a gap for the first length byte. */
+        uxIndex = uxStart + 1U;
+
+        /* Copy in the host name. */
+        ( void ) strcpy( ( char * ) &( pucUDPPayloadBuffer[ uxIndex ] ), pcHostName );
+
+        /* Walk through the string to replace the '.' characters with byte
+         * counts.  pucStart holds the address of the byte count.  Walking the
+         * string starts after the byte count position. */
+        uxIndex = uxStart;
+
+        do
+        {
+            size_t uxLength;
+
+            /* Skip the length byte. */
+            uxIndex++;
+
+            while( ( pucUDPPayloadBuffer[ uxIndex ] != ( uint8_t ) 0U ) &&
+                   ( pucUDPPayloadBuffer[ uxIndex ] != ( uint8_t ) ASCII_BASELINE_DOT ) )
+            {
+                uxIndex++;
+            }
+
+            /* Fill in the byte count, then move the pucStart pointer up to
+             * the found byte position. */
+            uxLength = uxIndex - ( uxStart + 1U );
+            pucUDPPayloadBuffer[ uxStart ] = ( uint8_t ) uxLength;
+
+            uxStart = uxIndex;
+        } while( pucUDPPayloadBuffer[ uxIndex ] != ( uint8_t ) 0U );
+
+        /* Finish off the record. Cast the record onto DNSTail_t structure to easily
+         * access the fields of the DNS Message. */
+        pxTail = ipCAST_PTR_TO_TYPE_PTR( DNSTail_t, &( pucUDPPayloadBuffer[ uxStart + 1U ] ) );
+
+        #if defined( _lint ) || defined( __COVERITY__ )
+            ( void ) pxTail;
+        #else
+            vSetField16( pxTail, DNSTail_t, usType, dnsTYPE_A_HOST );
+            vSetField16( pxTail, DNSTail_t, usClass, dnsCLASS_IN );
+        #endif
+
+        /* Return the total size of the generated message, which is the space from
+         * the last written byte to the beginning of the buffer. */
+        return uxIndex + sizeof( DNSTail_t ) + 1U;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Check the name that starts at the read position of a DNS message, and
+ *        move the read position to the first byte after it.  Compression pointers
+ *        are followed and checked here, so a name that was accepted can later be
+ *        expanded without checking it again: each pointer must point to an
+ *        earlier position than the previous one, so a name can not loop, and the
+ *        expanded name may not be longer than dnsMAX_HOSTNAME_LENGTH bytes.
+ *
+ * @param[in,out] pxReader: The read position in the DNS message.
+ *
+ * @return pdPASS when a well-formed name was found, otherwise pdFAIL.
+ */
+    _static BaseType_t prvDNSReadName( DNSReader_t * pxReader )
+    {
+        const uint8_t * pucMessage = pxReader->pucMessage;
+        size_t uxOffset = pxReader->uxOffset;
+        size_t uxLimit = pxReader->uxOffset;
+        size_t uxEnd = 0U;
+        size_t uxNameLength = 0U;
+        size_t uxLabelLength;
+        BaseType_t xReturn = pdFAIL;
+
+        while( uxOffset < pxReader->uxLength )
+        {
+            uxLabelLength = ( size_t ) pucMessage[ uxOffset ];
+
+            if( ( pucMessage[ uxOffset ] & dnsNAME_IS_OFFSET ) == dnsNAME_IS_OFFSET )
+            {
+                if( ( uxOffset + 1U ) >= pxReader->uxLength )
+                {
+                    break;
+                }
+
+                if( uxEnd == 0U )
+                {
+                    /* The rest of the name is found elsewhere in the message. */
+                    uxEnd = uxOffset + sizeof( uint16_t );
+                }
+
+                uxOffset = ( ( uxLabelLength & 0x3fU ) << 8 ) | ( size_t ) pucMessage[ uxOffset + 1U ];
+
+                if( uxOffset >= uxLimit )
+                {
+                    /* Only pointers to earlier positions are accepted. */
+                    break;
+                }
+
+                uxLimit = uxOffset;
+            }
+            else if( ( pucMessage[ uxOffset ] & dnsNAME_IS_OFFSET ) != 0U )
+            {
+                /* The label types 0x40 and 0x80 are not in use. */
+                break;
+            }
+            else if( uxLabelLength == 0U )
+            {
+                if( uxEnd == 0U )
+                {
+                    uxEnd = uxOffset + 1U;
+                }
+
+                pxReader->uxOffset = uxEnd;
+                xReturn = pdPASS;
+                break;
+            }
+            else
+            {
+                /* Count the label and its length byte, plus the terminating zero. */
+                uxNameLength += uxLabelLength + 1U;
+
+                if( ( uxNameLength + 1U ) > dnsMAX_HOSTNAME_LENGTH )
+                {
+                    break;
+                }
+
+                uxOffset += uxLabelLength + 1U;
+            }
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Read a question or a resource record at the read position of a DNS
+ *        message, and move the read position to the next record.  The name of
+ *        the record is checked, but not copied.
+ *
+ * @param[in,out] pxReader: The read position in the DNS message.
+ * @param[out] pxRecord: The fields of the record, in host endianness.
+ * @param[in] xIsQuestion: pdTRUE for a question, which has no TTL and no data.
+ *
+ * @return pdPASS when the complete record was found, otherwise pdFAIL.
+ */
+    _static BaseType_t prvDNSReadRecord( DNSReader_t * pxReader,
+                                         DNSRecord_t * pxRecord,
+                                         BaseType_t xIsQuestion )
+    {
+        const uint8_t * pucField;
+        size_t uxRemaining;
+        BaseType_t xReturn = pdFAIL;
+
+        pxRecord->uxNameOffset = pxReader->uxOffset;
+
+        if( prvDNSReadName( pxReader ) == pdPASS )
+        {
+            uxRemaining = pxReader->uxLength - pxReader->uxOffset;
+            pucField = &( pxReader->pucMessage[ pxReader->uxOffset ] );
+
+            if( xIsQuestion != pdFALSE )
+            {
+                /* A question only has the type and class fields. */
+                if( uxRemaining >= sizeof( uint32_t ) )
+                {
+                    pxRecord->usType = usChar2u16( pucField );
+                    pxRecord->usClass = usChar2u16( &( pucField[ 2 ] ) );
+                    pxRecord->ulTTL = 0U;
+                    pxRecord->usDataLength = 0U;
+                    pxReader->uxOffset += sizeof( uint32_t );
+                    pxRecord->uxDataOffset = pxReader->uxOffset;
+                    xReturn = pdPASS;
+                }
+            }
+            else if( uxRemaining >= sizeof( DNSAnswerRecord_t ) )
+            {
+                /* The fields of DNSAnswerRecord_t: type, class, TTL and data length. */
+                pxRecord->usType = usChar2u16( pucField );
+                pxRecord->usClass = usChar2u16( &( pucField[ 2 ] ) );
+                pxRecord->ulTTL = ulChar2u32( &( pucField[ 4 ] ) );
+                pxRecord->usDataLength = usChar2u16( &( pucField[ 8 ] ) );
+
+                if( ( uxRemaining - sizeof( DNSAnswerRecord_t ) ) >= ( size_t ) pxRecord->usDataLength )
+                {
+                    pxRecord->uxDataOffset = pxReader->uxOffset + sizeof( DNSAnswerRecord_t );
+                    pxReader->uxOffset = pxRecord->uxDataOffset + ( size_t ) pxRecord->usDataLength;
+                    xReturn = pdPASS;
+                }
+            }
+            else
+            {
+                /* The record is truncated. */
+            }
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 ) || ( ipconfigUSE_MDNS != 0 )
+
+/**
+ * @brief Copy a name from a DNS message to a string, with dots between the
+ *        labels.  The name should have been checked by prvDNSReadName(), the
+ *        checks done here only make sure that the function is safe to use.
+ *
+ * @param[in] pxReader: The DNS message that contains the name.
+ * @param[in] uxNameOffset: The offset of the name in the message.
+ * @param[out] pcName: The buffer to which the name will be copied.
+ * @param[in] uxDestLen: Size of the pcName array.
+ *
+ * @return pdPASS when the name was copied, pdFAIL when it did not fit.
+ */
+        _static BaseType_t prvDNSCopyName( const DNSReader_t * pxReader,
+                                           size_t uxNameOffset,
+                                           char * pcName,
+                                           size_t uxDestLen )
+        {
+            const uint8_t * pucMessage = pxReader->pucMessage;
+            size_t uxOffset = uxNameOffset;
+            size_t uxLimit = uxNameOffset;
+            size_t uxNameLen = 0U;
+            size_t uxLabelLength;
+            size_t uxNeeded;
+            BaseType_t xReturn = pdFAIL;
+            /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
+            const void * pvCopySource;
+            void * pvCopyDest;
+
+            while( ( uxOffset < pxReader->uxLength ) && ( uxDestLen > 0U ) )
+            {
+                uxLabelLength = ( size_t ) pucMessage[ uxOffset ];
+
+                if( ( pucMessage[ uxOffset ] & dnsNAME_IS_OFFSET ) == dnsNAME_IS_OFFSET )
+                {
+                    if( ( uxOffset + 1U ) >= pxReader->uxLength )
+                    {
+                        break;
+                    }
+
+                    uxOffset = ( ( uxLabelLength & 0x3fU ) << 8 ) | ( size_t ) pucMessage[ uxOffset + 1U ];
+
+                    if( uxOffset >= uxLimit )
+                    {
+                        break;
+                    }
+
+                    uxLimit = uxOffset;
+                }
+                else if( ( pucMessage[ uxOffset ] & dnsNAME_IS_OFFSET ) != 0U )
+                {
+                    break;
+                }
+                else if( uxLabelLength == 0U )
+                {
+                    pcName[ uxNameLen ] = '\0';
+                    xReturn = pdPASS;
+                    break;
+                }
+                else
+                {
+                    /* The label, preceded by a dot when it is not the first one. */
+                    uxNeeded = ( uxNameLen > 0U ) ? ( uxLabelLength + 1U ) : uxLabelLength;
+
+                    if( ( ( uxNameLen + uxNeeded ) >= uxDestLen ) ||
+                        ( ( uxOffset + uxLabelLength ) >= pxReader->uxLength ) )
+                    {
+                        break;
+                    }
+
+                    if( uxNameLen > 0U )
+                    {
+                        pcName[ uxNameLen ] = '.';
+                        uxNameLen++;
+                    }
+
+                    pvCopySource = &( pucMessage[ uxOffset + 1U ] );
+                    pvCopyDest = &( pcName[ uxNameLen ] );
+                    ( void ) memcpy( pvCopyDest, pvCopySource, uxLabelLength );
+                    uxNameLen += uxLabelLength;
+                    uxOffset += uxLabelLength + 1U;
+                }
+            }
+
+            return xReturn;
+        }
+    #endif /* ipconfigUSE_DNS_CACHE || ipconfigDNS_USE_CALLBACKS || ipconfigUSE_MDNS */
+    /*-----------------------------------------------------------*/
+
+/* The function below will only be called :
+ * when ipconfigDNS_USE_CALLBACKS == 1
+ * when ipconfigUSE_LLMNR == 1
+ * for testing purposes, by the module test_freertos_tcp.c
+ */
+
+/**
+ * @brief Perform some preliminary checks and then parse the DNS packet.
+ *
+ * @param[in] pxNetworkBuffer: The network buffer to be parsed.
+ *
+ * @return Always pdFAIL to indicate that the packet was not consumed and must
+ *         be released by the caller.
+ */
+    uint32_t ulDNSHandlePacket( const NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        uint8_t * pucPayLoadBuffer;
+        size_t uxPayloadSize;
+
+        /* Only proceed if the payload length indicated in the header
+         * appears to be valid. */
+        if( pxNetworkBuffer->xDataLength >= sizeof( UDPPacket_t ) )
+        {
+            uxPayloadSize = pxNetworkBuffer->xDataLength - sizeof( UDPPacket_t );
+
+            if( uxPayloadSize >= sizeof( DNSMessage_t ) )
+            {
+                pucPayLoadBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( UDPPacket_t ) ] );
+
+                /* The parameter pdFALSE indicates that the reply was not expected. */
+                ( void ) prvParseDNSReply( pucPayLoadBuffer,
+                                           uxPayloadSize,
+                                           pdFALSE );
+            }
+        }
+
+        /* The packet was not consumed. */
+        return pdFAIL;
+    }
+    /*-----------------------------------------------------------*/
+
+
+    #if ( ipconfigUSE_NBNS == 1 )
+
+/**
+ * @brief Handle an NBNS packet.
+ *
+ * @param[in] pxNetworkBuffer: The network buffer holding the NBNS packet.
+ *
+ * @return pdFAIL to show that the packet was not consumed.
+ */
+        uint32_t ulNBNSHandlePacket( NetworkBufferDescriptor_t * pxNetworkBuffer )
+        {
+            UDPPacket_t * pxUDPPacket = ipCAST_PTR_TO_TYPE_PTR( UDPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+            uint8_t * pucUDPPayloadBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( *pxUDPPacket ) ] );
+
+            prvTreatNBNS( pucUDPPayloadBuffer,
+                          pxNetworkBuffer->xDataLength,
+                          pxUDPPacket->xIPHeader.ulSourceIPAddress );
+
+            /* The packet was not consumed. */
+            return pdFAIL;
+        }
+
+    #endif /* ipconfigUSE_NBNS */
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Process a response packet from a DNS server, or an LLMNR reply.
+ *
+ * @param[in] pucUDPPayloadBuffer: The DNS response received as a UDP
+ *                                 payload.
+ * @param[in] uxBufferLength: Length of the UDP payload buffer.
+ * @param[in] xExpected: indicates whether the identifier in the reply
+ *                       was expected, and thus if the DNS cache may be
+ *                       updated with the reply.
+ *
+ * @return The IP address in the DNS response if present and if xExpected is set to pdTRUE.
+ *         An error code (dnsPARSE_ERROR) if there was an error in the DNS response.
+ *         0 if xExpected set to pdFALSE.
+ */
+    _static uint32_t prvParseDNSReply( uint8_t * pucUDPPayloadBuffer,
+                                       size_t uxBufferLength,
+                                       BaseType_t xExpected )
+    {
+        DNSMessage_t * pxDNSMessageHeader;
+        DNSReader_t xReader;
+        DNSRecord_t xRecord;
+        DNSRecord_t xQuestion;
+        uint32_t ulIPAddress = 0U;
+        uint16_t x, usQuestions, usAnswers;
+        BaseType_t xReturn = pdTRUE;
+        /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
+        const void * pvCopySource;
+        void * pvCopyDest;
+
+        #if ( ipconfigUSE_LLMNR == 1 )
+            char * pcRequestedName = NULL;
+            uint8_t * pucByte;
+        #endif
+        #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
+            BaseType_t xDoStore = xExpected;
+            char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ] = "";
+        #endif
+        const size_t uxAddressLength = ipSIZE_OF_IPv4_ADDRESS;
+
+        ( void ) memset( &( xQuestion ), 0, sizeof( xQuestion ) );
+
+        /* Ensure that the buffer is of at least minimal DNS message length. */
+        if( uxBufferLength < sizeof( DNSMessage_t ) )
+        {
+            xReturn = pdFALSE;
+        }
+        else
+        {
+            /* Parse the DNS message header. Map the byte stream onto a structure
+             * for easier access. */
+            pxDNSMessageHeader = ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer );
+
+            /* The message is read in a single pass, starting at the first byte
+             * after the header.  Names are not copied while reading, a record
+             * only refers to the position of its name. */
+            xReader.pucMessage = pucUDPPayloadBuffer;
+            xReader.uxLength = uxBufferLength;
+            xReader.uxOffset = sizeof( DNSMessage_t );
+
+            /* Introduce a do {} while (0) to allow the use of breaks. */
+            do
+            {
+                /* Read the question records, only the first one is of interest. */
+                usQuestions = FreeRTOS_ntohs( pxDNSMessageHeader->usQuestions );
+
+                for( x = 0U; x < usQuestions; x++ )
+                {
+                    if( prvDNSReadRecord( &( xReader ), &( xRecord ), pdTRUE ) == pdFAIL )
+                    {
+                        /* Malformed response. */
+                        xReturn = pdFALSE;
+                        break;
+                    }
+
+                    if( x == 0U )
+                    {
+                        xQuestion = xRecord;
+                    }
+                }
+
+                if( xReturn == pdFALSE )
+                {
+                    /* No need to proceed. Break out of the do-while loop. */
+                    break;
+                }
+
+                #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
+                    /* The name that was looked up is only needed as a string by the
+                     * DNS cache and by the call-backs. */
+                    if( ( usQuestions != 0U ) &&
+                        ( prvDNSCopyName( &( xReader ), xQuestion.uxNameOffset, pcName, sizeof( pcName ) ) == pdFAIL ) )
+                    {
+                        xReturn = pdFALSE;
+                        break;
+                    }
+                #endif /* ipconfigUSE_DNS_CACHE || ipconfigDNS_USE_CALLBACKS */
+
+                /* Search through the answer records. */
+                usAnswers = FreeRTOS_ntohs( pxDNSMessageHeader->usAnswers );
+
+                if( ( pxDNSMessageHeader->usFlags & dnsRX_FLAGS_MASK ) == dnsEXPECTED_RX_FLAGS )
+                {
+                    const uint16_t usCount = ( uint16_t ) ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY;
+                    uint16_t usNumARecordsStored = 0;
+
+                    for( x = 0U; x < usAnswers; x++ )
+                    {
+                        if( usNumARecordsStored >= usCount )
+                        {
+                            /* Only count ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY number of records. */
+                            break;
+                        }
+
+                        if( prvDNSReadRecord( &( xReader ), &( xRecord ), pdFALSE ) == pdFAIL )
+                        {
+                            /* Malformed response. */
+                            xReturn = pdFALSE;
+                            break;
+                        }
+
+                        /* Only IPv4 A records are of interest, the others are skipped. */
+                        if( ( xRecord.usType == ( uint16_t ) dnsTYPE_A_HOST ) &&
+                            ( xRecord.usDataLength == ( uint16_t ) uxAddressLength ) )
+                        {
+                            /*
+                             * Use helper variables for memcpy() to remain
+                             * compliant with MISRA Rule 21.15.  These should be
+                             * optimized away.
+                             */
+                            pvCopySource = &( pucUDPPayloadBuffer[ xRecord.uxDataOffset ] );
+                            pvCopyDest = &ulIPAddress;
+                            ( void ) memcpy( pvCopyDest, pvCopySource, uxAddressLength );
+
+                            #if ( ipconfigDNS_USE_CALLBACKS == 1 )
+                                {
+                                    /* See if any asynchronous call was made to FreeRTOS_gethostbyname_a() */
+                                    if( xDNSDoCallback( ( TickType_t ) pxDNSMessageHeader->usIdentifier, pcName, ulIPAddress ) != pdFALSE )
+                                    {
+                                        /* This device has requested this DNS look-up.
+                                         * The result may be stored in the DNS cache. */
+                                        xDoStore = pdTRUE;
+                                    }
+                                }
+                            #endif /* ipconfigDNS_USE_CALLBACKS == 1 */
+                            #if ( ipconfigUSE_DNS_CACHE == 1 )
+                                {
+                                    char cBuffer[ 16 ];
+
+                                    /* The reply will only be stored in the DNS cache when the
+                                     * request was issued by this device. */
+                                    if( xDoStore != pdFALSE )
+                                    {
+                                        ( void ) prvProcessDNSCache( pcName, &ulIPAddress, FreeRTOS_htonl( xRecord.ulTTL ), pdFALSE );
+                                        usNumARecordsStored++; /* Track # of A records stored */
+                                    }
+
+                                    ( void ) FreeRTOS_inet_ntop( FREERTOS_AF_INET, ( const void * ) &( ulIPAddress ), cBuffer, ( socklen_t ) sizeof( cBuffer ) );
+                                    /* Show what has happened. */
+                                    FreeRTOS_printf( ( "DNS[0x%04lX]: The answer to '%s' (%s) will%s be stored\n",
+                                                       ( UBaseType_t ) pxDNSMessageHeader->usIdentifier,
+                                                       pcName,
+                                                       cBuffer,
+                                                       ( xDoStore != 0 ) ? "" : " NOT" ) );
+                                }
+                            #endif /* ipconfigUSE_DNS_CACHE */
+                        }
+                    }
+
+                    #if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+                        if( ( xReturn != pdFALSE ) && ( xDoStore != pdFALSE ) && ( ulIPAddress == 0U ) && ( x == usAnswers ) )
+                        {
+                            /* The name exists, but it has no address. */
+                            prvDNSCacheStoreNegative( pcName, &( xReader ), 0U, FreeRTOS_ntohs( pxDNSMessageHeader->usAuthorityRRs ) );
+                        }
+                    #endif /* ipconfigUSE_DNS_CACHE_HASH */
+                }
+
+                #if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+                    else if( ( pxDNSMessageHeader->usFlags & dnsRX_FLAGS_MASK ) == dnsNXDOMAIN_RX_FLAGS )
+                    {
+                        /* The name does not exist. */
+                        if( xDoStore != pdFALSE )
+                        {
+                            prvDNSCacheStoreNegative( pcName, &( xReader ), usAnswers, FreeRTOS_ntohs( pxDNSMessageHeader->usAuthorityRRs ) );
+                        }
+                    }
+                #endif /* ipconfigUSE_DNS_CACHE_HASH */
+
+                #if ( ipconfigUSE_LLMNR == 1 )
+
+                    /* A question was read when usQuestions is not zero, xQuestion
+                     * is only valid in that case. */
+                    else if( ( usQuestions != ( uint16_t ) 0U ) && ( xQuestion.usType == dnsTYPE_A_HOST ) && ( xQuestion.usClass == dnsCLASS_IN ) )
+                    {
+                        /* If this is not a reply to our DNS request, it might an LLMNR
+                         * request.  The answer will follow the questions. */
+                        pcRequestedName = ( char * ) &( pucUDPPayloadBuffer[ xQuestion.uxNameOffset ] );
+                        pucByte = &( pucUDPPayloadBuffer[ xReader.uxOffset ] );
+
+                        if( xApplicationDNSQueryHook( &( pcRequestedName[ 1 ] ) ) != pdFALSE )
+                        {
+                            int16_t usLength;
+                            NetworkBufferDescriptor_t * pxNewBuffer = NULL;
+                            NetworkBufferDescriptor_t * pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pucUDPPayloadBuffer );
+                            LLMNRAnswer_t * pxAnswer;
+                            uint8_t * pucNewBuffer = NULL;
+
+                            if( pxNetworkBuffer != NULL )
+                            {
+                                if( xBufferAllocFixedSize == pdFALSE )
+                                {
+                                    size_t uxDataLength = uxBufferLength + sizeof( UDPHeader_t ) + sizeof( EthernetHeader_t ) + sizeof( IPHeader_t );
+
+                                    /* Set the size of the outgoing packet. */
+                                    pxNetworkBuffer->xDataLength = uxDataLength;
+                                    pxNewBuffer = pxDuplicateNetworkBufferWithDescriptor( pxNetworkBuffer, uxDataLength + sizeof( LLMNRAnswer_t ) );
+
+                                    if( pxNewBuffer != NULL )
+                                    {
+                                        BaseType_t xOffset1, xOffset2;
+
+                                        xOffset1 = ( BaseType_t ) ( pucByte - pucUDPPayloadBuffer );
+                                        xOffset2 = ( BaseType_t ) ( ( ( uint8_t * ) pcRequestedName ) - pucUDPPayloadBuffer );
+
+                                        pxNetworkBuffer = pxNewBuffer;
+                                        pucNewBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] );
+
+                                        pucByte = &( pucNewBuffer[ xOffset1 ] );
+                                        pcRequestedName = ( char * ) &( pucNewBuffer[ xOffset2 ] );
+                                        pxDNSMessageHeader = ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucNewBuffer );
+                                    }
+                                    else
+                                    {
+                                        /* Just to indicate that the message may not be answered. */
+                                        pxNetworkBuffer = NULL;
+                                    }
+                                }
+                                else
+                                {
+                                    pucNewBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] );
+                                }
+                            }
+
+                            /* The test on 'pucNewBuffer' is only to satisfy lint. */
+                            if( ( pxNetworkBuffer != NULL ) && ( pucNewBuffer != NULL ) )
+                            {
+                                pxAnswer = ipCAST_PTR_TO_TYPE_PTR( LLMNRAnswer_t, pucByte );
+
+                                /* We leave 'usIdentifier' and 'usQuestions' untouched */
+                                #ifndef _lint
+                                    vSetField16( pxDNSMessageHeader, DNSMessage_t, usFlags, dnsLLMNR_FLAGS_IS_REPONSE ); /* Set the response flag */
+                                    vSetField16( pxDNSMessageHeader, DNSMessage_t, usAnswers, 1 );                       /* Provide a single answer */
+                                    vSetField16( pxDNSMessageHeader, DNSMessage_t, usAuthorityRRs, 0 );                  /* No authority */
+                                    vSetField16( pxDNSMessageHeader, DNSMessage_t, usAdditionalRRs, 0 );                 /* No additional info */
+                                #endif /* lint */
+
+                                pxAnswer->ucNameCode = dnsNAME_IS_OFFSET;
+                                pxAnswer->ucNameOffset = ( uint8_t ) ( pcRequestedName - ( char * ) pucNewBuffer );
+
+                                #ifndef _lint
+                                    vSetField16( pxAnswer, LLMNRAnswer_t, usType, dnsTYPE_A_HOST ); /* Type A: host */
+                                    vSetField16( pxAnswer, LLMNRAnswer_t, usClass, dnsCLASS_IN );   /* 1: Class IN */
+                                    vSetField32( pxAnswer, LLMNRAnswer_t, ulTTL, dnsLLMNR_TTL_VALUE );
+                                    vSetField16( pxAnswer, LLMNRAnswer_t, usDataLength, 4 );
+                                    vSetField32( pxAnswer, LLMNRAnswer_t, ulIPAddress, FreeRTOS_ntohl( *ipLOCAL_IP_ADDRESS_POINTER ) );
+                                #endif /* lint */
+                                usLength = ( int16_t ) ( sizeof( *pxAnswer ) + ( size_t ) ( pucByte - pucNewBuffer ) );
+
+                                prvReplyDNSMessage( pxNetworkBuffer, usLength );
+
+                                if( pxNewBuffer != NULL )
+                                {
+                                    vReleaseNetworkBufferAndDescriptor( pxNewBuffer );
+                                }
+                            }
+                        }
+                    }
+                    else
+                    {
+                        /* Not an expected reply. */
+                    }
+                #endif /* ipconfigUSE_LLMNR == 1 */
+            } while( ipFALSE_BOOL );
+        }
+
+        if( xReturn == pdFALSE )
+        {
+            /* There was an error while parsing the DNS response. Return error code. */
+            ulIPAddress = dnsPARSE_ERROR;
+        }
+        else if( xExpected == pdFALSE )
+        {
+            /* Do not return a valid IP-address in case the reply was not expected. */
+            ulIPAddress = 0U;
+        }
+        else
+        {
+            /* The IP-address found will be returned. */
+        }
+
+        #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
+            ( void ) xDoStore;
+        #endif
+
+        return ulIPAddress;
+    }
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_NBNS == 1 )
+
+/**
+ * @brief Respond to an NBNS query or an NBNS reply.
+ *
+ * @param[in] pucPayload: the UDP payload of the NBNS message.
+ * @param[in] uxBufferLength: Length of the Buffer.
+ * @param[in] ulIPAddress: IP address of the sender.
+ */
+        static void prvTreatNBNS( uint8_t * pucPayload,
+                                  size_t uxBufferLength,
+                                  uint32_t ulIPAddress )
+        {
+            uint16_t usFlags, usType, usClass;
+            uint8_t * pucSource, * pucTarget;
+            uint8_t ucByte;
+            uint8_t ucNBNSName[ 17 ];
+            uint8_t * pucUDPPayloadBuffer = pucPayload;
+            NetworkBufferDescriptor_t * pxNetworkBuffer;
+            size_t uxBytesNeeded = sizeof( UDPPacket_t ) + sizeof( NBNSRequest_t );
+
+            /* Check for minimum buffer size. */
+            if( uxBufferLength < uxBytesNeeded )
+            {
+                return;
+            }
+
+            /* Read the request flags in host endianness. */
+            usFlags = usChar2u16( &( pucUDPPayloadBuffer[ offsetof( NBNSRequest_t, usFlags ) ] ) );
+
+            if( ( usFlags & dnsNBNS_FLAGS_OPCODE_MASK ) == dnsNBNS_FLAGS_OPCODE_QUERY )
+            {
+                usType = usChar2u16( &( pucUDPPayloadBuffer[ offsetof( NBNSRequest_t, usType ) ] ) );
+                usClass = usChar2u16( &( pucUDPPayloadBuffer[ offsetof( NBNSRequest_t, usClass ) ] ) );
+
+                /* Not used for now */
+                ( void ) usClass;
+
+                /* For NBNS a name is 16 bytes long, written with capitals only.
                  * Make sure that the copy is terminated with a zero. */
                 pucTarget = &( ucNBNSName[ sizeof( ucNBNSName ) - 2U ] );
                 pucTarget[ 1 ] = ( uint8_t ) 0U;
 
-                /* Start with decoding the last 2 bytes. */
-                pucSource = &( pucUDPPayloadBuffer[ ( dnsNBNS_ENCODED_NAME_LENGTH - 2 ) + offsetof( NBNSRequest_t, ucName ) ] );
+                /* Start with decoding the last 2 bytes. */
+                pucSource = &( pucUDPPayloadBuffer[ ( dnsNBNS_ENCODED_NAME_LENGTH - 2 ) + offsetof( NBNSRequest_t, ucName ) ] );
+
+                for( ; ; )
+                {
+                    const uint8_t ucCharA = ( uint8_t ) 0x41U;
+
+                    ucByte = ( ( uint8_t ) ( ( pucSource[ 0 ] - ucCharA ) << 4 ) ) | ( pucSource[ 1 ] - ucCharA );
+
+                    /* Make sure there are no trailing spaces in the name. */
+                    if( ( ucByte == ( uint8_t ) ' ' ) && ( pucTarget[ 1 ] == 0U ) )
+                    {
+                        ucByte = 0U;
+                    }
+
+                    *pucTarget = ucByte;
+
+                    if( pucTarget == ucNBNSName )
+                    {
+                        break;
+                    }
+
+                    pucTarget -= 1;
+                    pucSource -= 2;
+                }
+
+                #if ( ipconfigUSE_DNS_CACHE == 1 )
+                    {
+                        if( ( usFlags & dnsNBNS_FLAGS_RESPONSE ) != 0U )
+                        {
+                            /* If this is a response from another device,
+                             * add the name to the DNS cache */
+                            ( void ) prvProcessDNSCache( ( char * ) ucNBNSName, &( ulIPAddress ), 0, pdFALSE );
+                        }
+                    }
+                #else
+                    {
+                        /* Avoid compiler warnings. */
+                        ( void ) ulIPAddress;
+                    }
+                #endif /* ipconfigUSE_DNS_CACHE */
+
+                if( ( ( usFlags & dnsNBNS_FLAGS_RESPONSE ) == 0U ) &&
+                    ( usType == dnsNBNS_TYPE_NET_BIOS ) &&
+                    ( xApplicationDNSQueryHook( ( const char * ) ucNBNSName ) != pdFALSE ) )
+                {
+                    uint16_t usLength;
+                    DNSMessage_t * pxMessage;
+                    NBNSAnswer_t * pxAnswer;
+                    NetworkBufferDescriptor_t * pxNewBuffer = NULL;
+
+                    /* Someone is looking for a device with ucNBNSName,
+                     * prepare a positive reply. */
+                    pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pucUDPPayloadBuffer );
+
+                    if( ( xBufferAllocFixedSize == pdFALSE ) && ( pxNetworkBuffer != NULL ) )
+                    {
+                        /* The field xDataLength was set to the total length of the UDP packet,
+                         * i.e. the payload size plus sizeof( UDPPacket_t ). */
+                        pxNewBuffer = pxDuplicateNetworkBufferWithDescriptor( pxNetworkBuffer, pxNetworkBuffer->xDataLength + sizeof( NBNSAnswer_t ) );
+
+                        if( pxNewBuffer != NULL )
+                        {
+                            pucUDPPayloadBuffer = &( pxNewBuffer->pucEthernetBuffer[ sizeof( UDPPacket_t ) ] );
+                            pxNetworkBuffer = pxNewBuffer;
+                        }
+                        else
+                        {
+                            /* Just prevent that a reply will be sent */
+                            pxNetworkBuffer = NULL;
+                        }
+                    }
+
+                    /* Should not occur: pucUDPPayloadBuffer is part of a xNetworkBufferDescriptor */
+                    if( pxNetworkBuffer != NULL )
+                    {
+                        pxMessage = ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer );
+
+                        /* As the fields in the structures are not word-aligned, we have to
+                         * copy the values byte-by-byte using macro's vSetField16() and vSetField32() */
+                        #ifndef _lint
+                            vSetField16( pxMessage, DNSMessage_t, usFlags, dnsNBNS_QUERY_RESPONSE_FLAGS ); /* 0x8500 */
+                            vSetField16( pxMessage, DNSMessage_t, usQuestions, 0 );
+                            vSetField16( pxMessage, DNSMessage_t, usAnswers, 1 );
+                            vSetField16( pxMessage, DNSMessage_t, usAuthorityRRs, 0 );
+                            vSetField16( pxMessage, DNSMessage_t, usAdditionalRRs, 0 );
+                        #else
+                            ( void ) pxMessage;
+                        #endif
+
+                        pxAnswer = ipCAST_PTR_TO_TYPE_PTR( NBNSAnswer_t, &( pucUDPPayloadBuffer[ offsetof( NBNSRequest_t, usType ) ] ) );
+
+                        #ifndef _lint
+                            vSetField16( pxAnswer, NBNSAnswer_t, usType, usType );            /* Type */
+                            vSetField16( pxAnswer, NBNSAnswer_t, usClass, dnsNBNS_CLASS_IN ); /* Class */
+                            vSetField32( pxAnswer, NBNSAnswer_t, ulTTL, dnsNBNS_TTL_VALUE );
+                            vSetField16( pxAnswer, NBNSAnswer_t, usDataLength, 6 );           /* 6 bytes including the length field */
+                            vSetField16( pxAnswer, NBNSAnswer_t, usNbFlags, dnsNBNS_NAME_FLAGS );
+                            vSetField32( pxAnswer, NBNSAnswer_t, ulIPAddress, FreeRTOS_ntohl( *ipLOCAL_IP_ADDRESS_POINTER ) );
+                        #else
+                            ( void ) pxAnswer;
+                        #endif
+
+                        usLength = ( uint16_t ) ( sizeof( NBNSAnswer_t ) + ( size_t ) offsetof( NBNSRequest_t, usType ) );
+
+                        prvReplyDNSMessage( pxNetworkBuffer, ( BaseType_t ) usLength );
+
+                        if( pxNewBuffer != NULL )
+                        {
+                            vReleaseNetworkBufferAndDescriptor( pxNewBuffer );
+                        }
+                    }
+                }
+            }
+        }
+
+    #endif /* ipconfigUSE_NBNS */
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigDNS_USE_RESOLVER == 0 )
+/**
+ * @brief Create a socket and bind it to the standard DNS port number.
+ *
+ * @return The created socket - or NULL if the socket could not be created or could not be bound.
+ */
+        static Socket_t prvCreateDNSSocket( void )
+        {
+            Socket_t xSocket;
+            struct freertos_sockaddr xAddress;
+            BaseType_t xReturn;
+
+            /* This must be the first time this function has been called.  Create
+             * the socket. */
+            xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+
+            if( xSocketValid( xSocket ) == pdFALSE )
+            {
+                /* There was an error, return NULL. */
+                xSocket = NULL;
+            }
+            else
+            {
+                /* Auto bind the port. */
+                xAddress.sin_port = 0U;
+                xReturn = FreeRTOS_bind( xSocket, &xAddress, ( socklen_t ) sizeof( xAddress ) );
+
+                /* Check the bind was successful, and clean up if not. */
+                if( xReturn != 0 )
+                {
+                    ( void ) FreeRTOS_closesocket( xSocket );
+                    xSocket = NULL;
+                }
+                else
+                {
+                    /* The send and receive timeouts will be set later on. */
+                }
+            }
+
+            return xSocket;
+        }
+    #endif /* ipconfigDNS_USE_RESOLVER == 0 */
+/*-----------------------------------------------------------*/
+
+    #if ( ( ipconfigUSE_NBNS == 1 ) || ( ipconfigUSE_LLMNR == 1 ) )
+
+/**
+ * @brief Send a DNS message to be used in NBNS or LLMNR
+ *
+ * @param[in] pxNetworkBuffer: The network buffer descriptor with the DNS message.
+ * @param[in] lNetLength: The length of the DNS message.
+ */
+        static void prvReplyDNSMessage( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                        BaseType_t lNetLength )
+        {
+            UDPPacket_t * pxUDPPacket;
+            IPHeader_t * pxIPHeader;
+            UDPHeader_t * pxUDPHeader;
+            size_t uxDataLength;
+
+            pxUDPPacket = ipCAST_PTR_TO_TYPE_PTR( UDPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+            pxIPHeader = &pxUDPPacket->xIPHeader;
+            pxUDPHeader = &pxUDPPacket->xUDPHeader;
+            /* HT: started using defines like 'ipSIZE_OF_xxx' */
+            pxIPHeader->usLength = FreeRTOS_htons( ( uint16_t ) lNetLength + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER );
+            /* HT:endian: should not be translated, copying from packet to packet */
+            pxIPHeader->ulDestinationIPAddress = pxIPHeader->ulSourceIPAddress;
+            pxIPHeader->ulSourceIPAddress = *ipLOCAL_IP_ADDRESS_POINTER;
+            pxIPHeader->ucTimeToLive = ipconfigUDP_TIME_TO_LIVE;
+            pxIPHeader->usIdentification = FreeRTOS_htons( usPacketIdentifier );
+
+            /* The stack doesn't support fragments, so the fragment offset field must always be zero.
+             * The header was never memset to zero, so set both the fragment offset and fragmentation flags in one go.
+             */
+            #if ( ipconfigFORCE_IP_DONT_FRAGMENT != 0 )
+                pxIPHeader->usFragmentOffset = ipFRAGMENT_FLAGS_DONT_FRAGMENT;
+            #else
+                pxIPHeader->usFragmentOffset = 0U;
+            #endif
+            usPacketIdentifier++;
+            pxUDPHeader->usLength = FreeRTOS_htons( ( uint32_t ) lNetLength + ipSIZE_OF_UDP_HEADER );
+            vFlip_16( pxUDPHeader->usSourcePort, pxUDPHeader->usDestinationPort );
+
+            /* Important: tell NIC driver how many bytes must be sent */
+            uxDataLength = ( ( size_t ) lNetLength ) + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER + ipSIZE_OF_ETH_HEADER;
+
+            #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                {
+                    /* Calculate the IP header checksum. */
+                    pxIPHeader->usHeaderChecksum = 0U;
+                    pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+                    pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+
+                    /* calculate the UDP checksum for outgoing package */
+                    ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxUDPPacket, uxDataLength, pdTRUE );
+                }
+            #endif
+
+            /* Important: tell NIC driver how many bytes must be sent */
+            pxNetworkBuffer->xDataLength = uxDataLength;
+
+            /* This function will fill in the eth addresses and send the packet */
+            vReturnEthernetFrame( pxNetworkBuffer, pdFALSE );
+        }
+
+    #endif /* ipconfigUSE_NBNS == 1 || ipconfigUSE_LLMNR == 1 */
+
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_MDNS != 0 )
+
+/*
+ * Every record that the mDNS responder can send is represented by a bit: one
+ * for the A record of the host name, four bits for each service, and one for
+ * the A record of a name that the application accepted.
+ */
+        #define dnsMDNS_RECORD_HOST         ( 0x00000001UL ) /**< The A record of the host name. */
+        #define dnsMDNS_RECORD_ENUM         ( 0x00000002UL ) /**< The PTR record "_services._dns-sd._udp.local" of service 0. */
+        #define dnsMDNS_RECORD_PTR          ( 0x00000004UL ) /**< The PTR record of the service type of service 0. */
+        #define dnsMDNS_RECORD_SRV          ( 0x00000008UL ) /**< The SRV record of the instance of service 0. */
+        #define dnsMDNS_RECORD_TXT          ( 0x00000010UL ) /**< The TXT record of the instance of service 0. */
+        #define dnsMDNS_RECORD_ALIAS        ( 0x80000000UL ) /**< The A record of a name accepted by xApplicationDNSQueryHook(). */
+        #define dnsMDNS_ALL_PTR_RECORDS     ( 0x04444444UL ) /**< The PTR records of all services. */
+        #define dnsMDNS_ALL_SRV_RECORDS     ( 0x08888888UL ) /**< The SRV records of all services. */
+        #define dnsMDNS_BITS_PER_SERVICE    ( 4U )           /**< The number of records of a service. */
+
+/** @brief The size of the buffers that hold a name read from an mDNS message. */
+        #define dnsMDNS_NAME_LENGTH         ( 128U )
+
+/** @brief The name that is used to enumerate the service types. */
+        #define dnsMDNS_SERVICES_NAME       "_services._dns-sd._udp"
+
+/** @brief The MAC address used for mDNS. */
+        const MACAddress_t xMDNS_MacAddress = { { 0x01, 0x00, 0x5e, 0x00, 0x00, 0xfb } };
+
+/** @brief A DNS-SD service, registered by FreeRTOS_mDNSAddService(). */
+        typedef struct xMDNS_SERVICE
+        {
+            const char * pcInstance; /**< The instance name, a single label, e.g. "Printer in hall". */
+            const char * pcService;  /**< The service type, e.g. "_ipp._tcp". */
+            const char * pcText;     /**< The TXT strings, separated by a newline, or NULL. */
+            uint16_t usPort;         /**< The port number, in host endianness.  Zero when the entry is free. */
+        } MDNSService_t;
+
+/** @brief The write position in an mDNS message that is being created. */
+        typedef struct xMDNS_WRITER
+        {
+            uint8_t * pucBuffer; /**< The first byte of the DNS message. */
+            size_t uxLength;     /**< The maximum length of the message. */
+            size_t uxOffset;     /**< The position of the next byte to be written. */
+            BaseType_t xFailed;  /**< Becomes pdTRUE when a field did not fit, or could not be encoded. */
+        } MDNSWriter_t;
+
+        #if ( ipconfigMDNS_SERVICES > 0 )
+            /** @brief The registered services. */
+            static MDNSService_t xMDNSServices[ ipconfigMDNS_SERVICES ];
+        #endif
+
+/** @brief The number of unsolicited responses that are still to be sent. */
+        static uint8_t ucMDNSAnnouncements;
+
+/** @brief The last name, without ".local", that was accepted by xApplicationDNSQueryHook(). */
+        static char pcMDNSAlias[ dnsMDNS_NAME_LENGTH ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if a name, e.g. from a query, ends with ".local".
+ *
+ * @param[in] pcName: The name to be checked.
+ *
+ * @return pdTRUE when the name can be looked up with mDNS.
+ */
+        static BaseType_t prvMDNSIsLocalName( const char * pcName )
+        {
+            const char pcSuffix[] = ".local";
+            size_t uxLength = strlen( pcName );
+            size_t uxSuffixLength = sizeof( pcSuffix ) - 1U;
+            size_t uxIndex;
+            BaseType_t xReturn = pdFALSE;
+
+            /* Allow a trailing dot, as in "printer.local.". */
+            if( ( uxLength > 0U ) && ( pcName[ uxLength - 1U ] == '.' ) )
+            {
+                uxLength--;
+            }
+
+            if( uxLength > uxSuffixLength )
+            {
+                xReturn = pdTRUE;
+
+                for( uxIndex = 0U; uxIndex < uxSuffixLength; uxIndex++ )
+                {
+                    /* The ASCII letters only differ in the 0x20 bit. */
+                    if( ( ( ( uint8_t ) pcName[ uxLength - uxSuffixLength + uxIndex ] ) | 0x20U ) != ( uint8_t ) pcSuffix[ uxIndex ] )
+                    {
+                        xReturn = pdFALSE;
+                        break;
+                    }
+                }
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Compare the start of a name with a string, ignoring the case of
+ *        ASCII letters.  When they match, the name pointer is moved.
+ *
+ * @param[in,out] ppcName: Pointer to the name that is being compared.
+ * @param[in] pcPart: The expected part of the name.
+ *
+ * @return pdTRUE if the name starts with pcPart.
+ */
+        static BaseType_t prvMDNSMatch( const char ** ppcName,
+                                        const char * pcPart )
+        {
+            const char * pcName = *ppcName;
+            const char * pcNext = pcPart;
+            char cLeft, cRight;
+            BaseType_t xReturn = pdTRUE;
+
+            while( *pcNext != ( char ) 0 )
+            {
+                cLeft = *pcName;
+                cRight = *pcNext;
+
+                if( ( cLeft >= 'A' ) && ( cLeft <= 'Z' ) )
+                {
+                    cLeft = ( char ) ( cLeft + ( 'a' - 'A' ) );
+                }
+
+                if( ( cRight >= 'A' ) && ( cRight <= 'Z' ) )
+                {
+                    cRight = ( char ) ( cRight + ( 'a' - 'A' ) );
+                }
+
+                if( cLeft != cRight )
+                {
+                    xReturn = pdFALSE;
+                    break;
+                }
+
+                pcName++;
+                pcNext++;
+            }
+
+            if( xReturn != pdFALSE )
+            {
+                *ppcName = pcName;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if a name is equal to "<label>.<dotted>.local".
+ *
+ * @param[in] pcName: The name, as copied from a DNS message.
+ * @param[in] pcLabel: The first label, or NULL.
+ * @param[in] pcDotted: The labels that follow, or NULL.
+ *
+ * @return pdTRUE when the name matches.
+ */
+        static BaseType_t prvMDNSNameIs( const char * pcName,
+                                         const char * pcLabel,
+                                         const char * pcDotted )
+        {
+            const char * pcNext = pcName;
+            BaseType_t xReturn = pdTRUE;
+
+            if( pcLabel != NULL )
+            {
+                xReturn = ( ( prvMDNSMatch( &( pcNext ), pcLabel ) != pdFALSE ) &&
+                            ( prvMDNSMatch( &( pcNext ), "." ) != pdFALSE ) ) ? pdTRUE : pdFALSE;
+            }
+
+            if( ( xReturn != pdFALSE ) && ( pcDotted != NULL ) )
+            {
+                xReturn = ( ( prvMDNSMatch( &( pcNext ), pcDotted ) != pdFALSE ) &&
+                            ( prvMDNSMatch( &( pcNext ), "." ) != pdFALSE ) ) ? pdTRUE : pdFALSE;
+            }
+
+            if( xReturn != pdFALSE )
+            {
+                xReturn = ( ( prvMDNSMatch( &( pcNext ), "local" ) != pdFALSE ) &&
+                            ( *pcNext == ( char ) 0 ) ) ? pdTRUE : pdFALSE;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the records that answer a question.
+ *
+ * @param[in] pcName: The name in the question.  It will be modified when it
+ *                    is passed to xApplicationDNSQueryHook().
+ * @param[in] usType: The type in the question, or dnsTYPE_ANY.
+ *
+ * @return A bit for each record that answers the question.
+ */
+        static uint32_t prvMDNSRecordsFor( char * pcName,
+                                           uint16_t usType )
+        {
+            const char * pcHostName = pcApplicationHostnameHook();
+            BaseType_t xAny = ( usType == ( uint16_t ) dnsTYPE_ANY ) ? pdTRUE : pdFALSE;
+            uint32_t ulRecords = 0U;
+            size_t uxLength;
+
+            #if ( ipconfigMDNS_SERVICES > 0 )
+                {
+                    const MDNSService_t * pxService;
+                    UBaseType_t uxService, uxOther;
+                    uint32_t ulFound;
+
+                    for( uxService = 0U; uxService < ( UBaseType_t ) ipconfigMDNS_SERVICES; uxService++ )
+                    {
+                        pxService = &( xMDNSServices[ uxService ] );
+
+                        if( pxService->usPort == 0U )
+                        {
+                            continue;
+                        }
+
+                        ulFound = 0U;
+
+                        if( ( xAny != pdFALSE ) || ( usType == ( uint16_t ) dnsTYPE_PTR ) )
+                        {
+                            if( prvMDNSNameIs( pcName, NULL, pxService->pcService ) != pdFALSE )
+                            {
+                                ulFound |= dnsMDNS_RECORD_PTR;
+                            }
+                            else if( prvMDNSNameIs( pcName, NULL, dnsMDNS_SERVICES_NAME ) != pdFALSE )
+                            {
+                                /* A service type is enumerated once, by the first
+                                 * service of that type. */
+                                ulFound |= dnsMDNS_RECORD_ENUM;
+
+                                for( uxOther = 0U; uxOther < uxService; uxOther++ )
+                                {
+                                    if( ( xMDNSServices[ uxOther ].usPort != 0U ) &&
+                                        ( strcmp( xMDNSServices[ uxOther ].pcService, pxService->pcService ) == 0 ) )
+                                    {
+                                        ulFound = 0U;
+                                        break;
+                                    }
+                                }
+                            }
+                            else
+                            {
+                                /* Not a PTR record of this service. */
+                            }
+                        }
+
+                        if( prvMDNSNameIs( pcName, pxService->pcInstance, pxService->pcService ) != pdFALSE )
+                        {
+                            if( ( xAny != pdFALSE ) || ( usType == ( uint16_t ) dnsTYPE_SRV ) )
+                            {
+                                ulFound |= dnsMDNS_RECORD_SRV;
+                            }
+
+                            if( ( xAny != pdFALSE ) || ( usType == ( uint16_t ) dnsTYPE_TXT ) )
+                            {
+                                ulFound |= dnsMDNS_RECORD_TXT;
+                            }
+                        }
+
+                        ulRecords |= ulFound << ( dnsMDNS_BITS_PER_SERVICE * uxService );
+                    }
+                }
+            #endif /* ipconfigMDNS_SERVICES > 0 */
+
+            if( ( xAny != pdFALSE ) || ( usType == ( uint16_t ) dnsTYPE_A_HOST ) )
+            {
+                if( ( pcHostName != NULL ) && ( pcHostName[ 0 ] != ( char ) 0 ) &&
+                    ( prvMDNSNameIs( pcName, pcHostName, NULL ) != pdFALSE ) )
+                {
+                    ulRecords |= dnsMDNS_RECORD_HOST;
+                }
+                else if( ( ulRecords == 0U ) && ( prvMDNSIsLocalName( pcName ) != pdFALSE ) )
+                {
+                    /* Let the application decide, about the name without ".local". */
+                    uxLength = strlen( pcName );
+
+                    if( pcName[ uxLength - 1U ] == '.' )
+                    {
+                        uxLength--;
+                    }
+
+                    pcName[ uxLength - 6U ] = ( char ) 0;
+
+                    if( xApplicationDNSQueryHook( pcName ) != pdFALSE )
+                    {
+                        /* The answer will have the name of the question. */
+                        ( void ) strcpy( pcMDNSAlias, pcName );
+                        ulRecords |= dnsMDNS_RECORD_ALIAS;
+                    }
+                }
+                else
+                {
+                    /* The name is not ours. */
+                }
+            }
+
+            return ulRecords;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the kind of a record and the service that it belongs to.
+ *
+ * @param[in] ulRecord: A single record bit.
+ * @param[out] puxService: The index of the service.
+ *
+ * @return The record bit as if it belonged to service 0.
+ */
+        static uint32_t prvMDNSRecordKind( uint32_t ulRecord,
+                                           UBaseType_t * puxService )
+        {
+            uint32_t ulKind = ulRecord;
+            UBaseType_t uxService = 0U;
+
+            while( ( ulKind > dnsMDNS_RECORD_TXT ) && ( ulKind != dnsMDNS_RECORD_ALIAS ) )
+            {
+                ulKind >>= dnsMDNS_BITS_PER_SERVICE;
+                uxService++;
+            }
+
+            *puxService = uxService;
+
+            return ulKind;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Write bytes at the write position of an mDNS message.
+ *
+ * @param[in,out] pxWriter: The write position.
+ * @param[in] pvData: The bytes to be written.
+ * @param[in] uxLength: The number of bytes.
+ */
+        static void prvMDNSWriteBytes( MDNSWriter_t * pxWriter,
+                                       const void * pvData,
+                                       size_t uxLength )
+        {
+            /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
+            const void * pvCopySource;
+            void * pvCopyDest;
+
+            if( ( pxWriter->xFailed != pdFALSE ) || ( uxLength > ( pxWriter->uxLength - pxWriter->uxOffset ) ) )
+            {
+                pxWriter->xFailed = pdTRUE;
+            }
+            else
+            {
+                pvCopySource = pvData;
+                pvCopyDest = &( pxWriter->pucBuffer[ pxWriter->uxOffset ] );
+                ( void ) memcpy( pvCopyDest, pvCopySource, uxLength );
+                pxWriter->uxOffset += uxLength;
+            }
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Write a 16-bit and a 32-bit value, in network byte order.
+ *
+ * @param[in,out] pxWriter: The write position.
+ * @param[in] usValue: The 16-bit value, in host endianness.
+ * @param[in] ulValue: The 32-bit value, in host endianness.
+ * @param[in] xWithLong: pdTRUE when ulValue must be written.
+ */
+        static void prvMDNSWriteFields( MDNSWriter_t * pxWriter,
+                                        uint16_t usValue,
+                                        uint32_t ulValue,
+                                        BaseType_t xWithLong )
+        {
+            uint8_t ucBytes[ 6 ];
+            size_t uxLength = sizeof( uint16_t );
+
+            ucBytes[ 0 ] = ( uint8_t ) ( usValue >> 8 );
+            ucBytes[ 1 ] = ( uint8_t ) usValue;
+
+            if( xWithLong != pdFALSE )
+            {
+                ucBytes[ 2 ] = ( uint8_t ) ( ulValue >> 24 );
+                ucBytes[ 3 ] = ( uint8_t ) ( ulValue >> 16 );
+                ucBytes[ 4 ] = ( uint8_t ) ( ulValue >> 8 );
+                ucBytes[ 5 ] = ( uint8_t ) ulValue;
+                uxLength += sizeof( uint32_t );
+            }
+
+            prvMDNSWriteBytes( pxWriter, ucBytes, uxLength );
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Write a string as a sequence of length-prefixed strings, split at
+ *        every occurrence of a separator.
+ *
+ * @param[in,out] pxWriter: The write position.
+ * @param[in] pcString: The string to be written.
+ * @param[in] cSeparator: The character that separates the parts.
+ * @param[in] xIsName: pdTRUE when the parts are the labels of a name, which
+ *                     can not be empty and have at most 63 bytes.
+ */
+        static void prvMDNSWriteStrings( MDNSWriter_t * pxWriter,
+                                         const char * pcString,
+                                         char cSeparator,
+                                         BaseType_t xIsName )
+        {
+            const char * pcPart = pcString;
+            const size_t uxMaxLength = ( xIsName != pdFALSE ) ? 63U : 255U;
+            size_t uxLength;
+            uint8_t ucLength;
+
+            for( ; ; )
+            {
+                uxLength = 0U;
+
+                while( ( pcPart[ uxLength ] != ( char ) 0 ) && ( pcPart[ uxLength ] != cSeparator ) )
+                {
+                    uxLength++;
+                }
+
+                if( ( uxLength > uxMaxLength ) || ( ( uxLength == 0U ) && ( xIsName != pdFALSE ) ) )
+                {
+                    pxWriter->xFailed = pdTRUE;
+                }
+
+                ucLength = ( uint8_t ) uxLength;
+                prvMDNSWriteBytes( pxWriter, &( ucLength ), sizeof( ucLength ) );
+                prvMDNSWriteBytes( pxWriter, pcPart, uxLength );
+
+                if( ( pcPart[ uxLength ] == ( char ) 0 ) || ( pxWriter->xFailed != pdFALSE ) )
+                {
+                    break;
+                }
+
+                pcPart = &( pcPart[ uxLength + 1U ] );
+            }
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Write the name "<label>.<dotted>.local", without compression.
+ *
+ * @param[in,out] pxWriter: The write position.
+ * @param[in] pcLabel: A single label, which may contain dots, or NULL.
+ * @param[in] pcDotted: The labels that follow, separated by dots, or NULL.
+ */
+        static void prvMDNSWriteName( MDNSWriter_t * pxWriter,
+                                      const char * pcLabel,
+                                      const char * pcDotted )
+        {
+            const uint8_t ucLocal[] = { 5U, ( uint8_t ) 'l', ( uint8_t ) 'o', ( uint8_t ) 'c', ( uint8_t ) 'a', ( uint8_t ) 'l', 0U };
+
+            if( pcLabel != NULL )
+            {
+                prvMDNSWriteStrings( pxWriter, pcLabel, ( char ) 0, pdTRUE );
+            }
+
+            if( pcDotted != NULL )
+            {
+                prvMDNSWriteStrings( pxWriter, pcDotted, '.', pdTRUE );
+            }
+
+            prvMDNSWriteBytes( pxWriter, ucLocal, sizeof( ucLocal ) );
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Write a resource record.  When it does not fit, the write position
+ *        is restored.
+ *
+ * @param[in,out] pxWriter: The write position.
+ * @param[in] ulRecord: A single record bit.
+ * @param[in] xLegacy: pdTRUE in an answer to a one-shot query, which gets a
+ *                     short TTL and no cache-flush bits.
+ *
+ * @return pdPASS when the record was written.
+ */
+        static BaseType_t prvMDNSWriteRecord( MDNSWriter_t * pxWriter,
+                                              uint32_t ulRecord,
+                                              BaseType_t xLegacy )
+        {
+            const char * pcHostName = pcApplicationHostnameHook();
+            const MDNSService_t * pxService = NULL;
+            size_t uxStart = pxWriter->uxOffset;
+            size_t uxData;
+            UBaseType_t uxService;
+            uint32_t ulKind = prvMDNSRecordKind( ulRecord, &( uxService ) );
+            uint32_t ulTTL = dnsMDNS_OTHER_TTL_VALUE;
+            uint16_t usType = dnsTYPE_PTR;
+            uint16_t usClass = dnsCLASS_IN;
+            BaseType_t xReturn = pdPASS;
+
+            #if ( ipconfigMDNS_SERVICES > 0 )
+                if( ( ulKind != dnsMDNS_RECORD_HOST ) && ( ulKind != dnsMDNS_RECORD_ALIAS ) )
+                {
+                    pxService = &( xMDNSServices[ uxService ] );
+                }
+            #endif
+
+            /* The A, SRV and TXT records are unique to this host, the PTR
+             * records are shared with other hosts. */
+            if( ( ulKind == dnsMDNS_RECORD_HOST ) || ( ulKind == dnsMDNS_RECORD_ALIAS ) ||
+                ( ulKind == dnsMDNS_RECORD_SRV ) || ( ulKind == dnsMDNS_RECORD_TXT ) )
+            {
+                if( xLegacy == pdFALSE )
+                {
+                    usClass |= ( uint16_t ) dnsMDNS_CLASS_TOP_BIT;
+                }
+            }
+
+            /* The owner name of the record. */
+            if( ( ulKind == dnsMDNS_RECORD_HOST ) || ( ulKind == dnsMDNS_RECORD_ALIAS ) )
+            {
+                if( ulKind == dnsMDNS_RECORD_HOST )
+                {
+                    prvMDNSWriteName( pxWriter, pcHostName, NULL );
+                }
+                else
+                {
+                    prvMDNSWriteName( pxWriter, NULL, pcMDNSAlias );
+                }
+
+                usType = dnsTYPE_A_HOST;
+                ulTTL = dnsMDNS_HOST_TTL_VALUE;
+            }
+            else if( pxService == NULL )
+            {
+                xReturn = pdFAIL;
+            }
+            else if( ulKind == dnsMDNS_RECORD_ENUM )
+            {
+                prvMDNSWriteName( pxWriter, NULL, dnsMDNS_SERVICES_NAME );
+            }
+            else if( ulKind == dnsMDNS_RECORD_PTR )
+            {
+                prvMDNSWriteName( pxWriter, NULL, pxService->pcService );
+            }
+            else
+            {
+                prvMDNSWriteName( pxWriter, pxService->pcInstance, pxService->pcService );
+
+                if( ulKind == dnsMDNS_RECORD_SRV )
+                {
+                    usType = dnsTYPE_SRV;
+                    ulTTL = dnsMDNS_HOST_TTL_VALUE;
+                }
+                else
+                {
+                    usType = dnsTYPE_TXT;
+                }
+            }
+
+            if( ( xLegacy != pdFALSE ) && ( ulTTL > dnsMDNS_LEGACY_TTL_VALUE ) )
+            {
+                ulTTL = dnsMDNS_LEGACY_TTL_VALUE;
+            }
+
+            if( xReturn == pdPASS )
+            {
+                /* Type, class and TTL, the data length is filled in later. */
+                prvMDNSWriteFields( pxWriter, usType, 0U, pdFALSE );
+                prvMDNSWriteFields( pxWriter, usClass, ulTTL, pdTRUE );
+                prvMDNSWriteFields( pxWriter, 0U, 0U, pdFALSE );
+                uxData = pxWriter->uxOffset;
+
+                if( ( ulKind == dnsMDNS_RECORD_HOST ) || ( ulKind == dnsMDNS_RECORD_ALIAS ) )
+                {
+                    prvMDNSWriteBytes( pxWriter, ipLOCAL_IP_ADDRESS_POINTER, ipSIZE_OF_IPv4_ADDRESS );
+                }
+                else if( ulKind == dnsMDNS_RECORD_ENUM )
+                {
+                    prvMDNSWriteName( pxWriter, NULL, pxService->pcService );
+                }
+                else if( ulKind == dnsMDNS_RECORD_PTR )
+                {
+                    prvMDNSWriteName( pxWriter, pxService->pcInstance, pxService->pcService );
+                }
+                else if( ulKind == dnsMDNS_RECORD_SRV )
+                {
+                    /* Priority and weight zero, the port and the target host. */
+                    prvMDNSWriteFields( pxWriter, 0U, ( uint32_t ) pxService->usPort, pdTRUE );
+                    prvMDNSWriteName( pxWriter, pcHostName, NULL );
+                }
+                else
+                {
+                    /* A TXT record contains at least one string, which may be empty. */
+                    prvMDNSWriteStrings( pxWriter, ( pxService->pcText != NULL ) ? pxService->pcText : "", '\n', pdFALSE );
+                }
+
+                if( pxWriter->xFailed == pdFALSE )
+                {
+                    pxWriter->pucBuffer[ uxData - 2U ] = ( uint8_t ) ( ( pxWriter->uxOffset - uxData ) >> 8 );
+                    pxWriter->pucBuffer[ uxData - 1U ] = ( uint8_t ) ( pxWriter->uxOffset - uxData );
+                }
+            }
+
+            if( ( xReturn == pdFAIL ) || ( pxWriter->xFailed != pdFALSE ) )
+            {
+                /* Forget the record, a next record might still fit. */
+                pxWriter->uxOffset = uxStart;
+                pxWriter->xFailed = pdFALSE;
+                xReturn = pdFAIL;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Create and send an mDNS response.  Records that do not fit in the
+ *        message are not sent.
+ *
+ * @param[in] ulAnswers: The records for the answer section.
+ * @param[in] ulAdditional: The records for the additional section.
+ * @param[in] ulIPAddress: The destination address, in network byte order.
+ * @param[in] usPort: The destination port, in network byte order.
+ * @param[in] pxQuery: The one-shot query that is answered, or NULL.  Its
+ *                     identifier and questions are repeated.
+ *
+ * @return The records that were not sent.
+ */
+        static uint32_t prvMDNSSend( uint32_t ulAnswers,
+                                     uint32_t ulAdditional,
+                                     uint32_t ulIPAddress,
+                                     uint16_t usPort,
+                                     const DNSReader_t * pxQuery )
+        {
+            NetworkBufferDescriptor_t * pxNetworkBuffer;
+            MDNSWriter_t xWriter;
+            BaseType_t xLegacy = ( pxQuery != NULL ) ? pdTRUE : pdFALSE;
+            uint16_t usCount[ 2 ] = { 0U, 0U };
+            uint32_t ulRecords[ 2 ];
+            uint32_t ulLeft = 0U;
+            uint32_t ulBit;
+            size_t uxSection;
+            const size_t uxMaxPayload = ( size_t ) ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER );
+
+            ulRecords[ 0 ] = ulAnswers;
+            ulRecords[ 1 ] = ulAdditional;
+
+            pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( sizeof( UDPPacket_t ) + uxMaxPayload, 0U );
+
+            if( pxNetworkBuffer == NULL )
+            {
+                ulLeft = ulAnswers;
+            }
+            else
+            {
+                xWriter.pucBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] );
+                xWriter.uxLength = uxMaxPayload;
+                xWriter.uxOffset = sizeof( DNSMessage_t );
+                xWriter.xFailed = pdFALSE;
+                ( void ) memset( xWriter.pucBuffer, 0, sizeof( DNSMessage_t ) );
+                xWriter.pucBuffer[ 2 ] = ( uint8_t ) ( dnsMDNS_FLAGS_IS_RESPONSE >> 8 );
+
+                if( pxQuery != NULL )
+                {
+                    /* Repeat the identifier, the number of questions, and the
+                     * questions.  Name pointers in the questions remain valid,
+                     * because the questions are copied to the same offset. */
+                    ( void ) memcpy( xWriter.pucBuffer, pxQuery->pucMessage, sizeof( uint16_t ) );
+                    ( void ) memcpy( &( xWriter.pucBuffer[ 4 ] ), &( pxQuery->pucMessage[ 4 ] ), sizeof( uint16_t ) );
+                    prvMDNSWriteBytes( &( xWriter ), &( pxQuery->pucMessage[ sizeof( DNSMessage_t ) ] ), pxQuery->uxOffset - sizeof( DNSMessage_t ) );
+                }
+
+                for( uxSection = 0U; uxSection < 2U; uxSection++ )
+                {
+                    for( ulBit = 1U; ( ulBit != 0U ) && ( ulBit <= ulRecords[ uxSection ] ); ulBit <<= 1 )
+                    {
+                        if( ( ulRecords[ uxSection ] & ulBit ) == 0U )
+                        {
+                            continue;
+                        }
+
+                        if( ( xWriter.xFailed == pdFALSE ) && ( prvMDNSWriteRecord( &( xWriter ), ulBit, xLegacy ) == pdPASS ) )
+                        {
+                            usCount[ uxSection ]++;
+                        }
+                        else if( uxSection == 0U )
+                        {
+                            ulLeft |= ulBit;
+                        }
+                        else
+                        {
+                            /* An additional record may be left out. */
+                        }
+                    }
+                }
+
+                if( usCount[ 0 ] == 0U )
+                {
+                    vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                }
+                else
+                {
+                    xWriter.pucBuffer[ 6 ] = ( uint8_t ) ( usCount[ 0 ] >> 8 );
+                    xWriter.pucBuffer[ 7 ] = ( uint8_t ) usCount[ 0 ];
+                    xWriter.pucBuffer[ 10 ] = ( uint8_t ) ( usCount[ 1 ] >> 8 );
+                    xWriter.pucBuffer[ 11 ] = ( uint8_t ) usCount[ 1 ];
+
+                    /* The message is complete, IP and checksum's are handled by
+                     * vProcessGeneratedUDPPacket */
+                    pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = FREERTOS_SO_UDPCKSUM_OUT;
+                    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+                        {
+                            /* The destination MAC-address is not known yet. */
+                            ( void ) memset( &( pxNetworkBuffer->pucEthernetBuffer[ ipDESTINATION_GENERATION_OFFSET ] ), 0, sizeof( uint32_t ) );
+                        }
+                    #endif
+                    pxNetworkBuffer->ulIPAddress = ulIPAddress;
+                    pxNetworkBuffer->usPort = usPort;
+                    pxNetworkBuffer->usBoundPort = FreeRTOS_htons( ipMDNS_PORT );
+                    pxNetworkBuffer->xDataLength = sizeof( UDPPacket_t ) + xWriter.uxOffset;
+
+                    vProcessGeneratedUDPPacket( pxNetworkBuffer );
+                }
+            }
+
+            return ulLeft;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the records that the querier already knows, from a record in the
+ *        answer section of a query.  An answer is known when its TTL is at
+ *        least half of the true value.
+ *
+ * @param[in] pxReader: The query.
+ * @param[in] pxRecord: The known answer.
+ * @param[in] pcName: The owner name of the known answer.
+ *
+ * @return A bit for each record that does not need to be sent.
+ */
+        static uint32_t prvMDNSKnownAnswers( const DNSReader_t * pxReader,
+                                             const DNSRecord_t * pxRecord,
+                                             char * pcName )
+        {
+            uint32_t ulRecords = prvMDNSRecordsFor( pcName, pxRecord->usType );
+            uint32_t ulKnown = 0U;
+            uint32_t ulBit, ulKind, ulTTL;
+            UBaseType_t uxService;
+            BaseType_t xSame;
+
+            for( ulBit = 1U; ( ulBit != 0U ) && ( ulBit <= ulRecords ); ulBit <<= 1 )
+            {
+                if( ( ulRecords & ulBit ) == 0U )
+                {
+                    continue;
+                }
+
+                ulKind = prvMDNSRecordKind( ulBit, &( uxService ) );
+                ulTTL = ( ( ulKind == dnsMDNS_RECORD_ENUM ) || ( ulKind == dnsMDNS_RECORD_PTR ) || ( ulKind == dnsMDNS_RECORD_TXT ) ) ? dnsMDNS_OTHER_TTL_VALUE : dnsMDNS_HOST_TTL_VALUE;
+                xSame = ( pxRecord->ulTTL >= ( ulTTL / 2U ) ) ? pdTRUE : pdFALSE;
+
+                if( xSame == pdFALSE )
+                {
+                    /* The answer is about to expire. */
+                }
+                else if( ( ulKind == dnsMDNS_RECORD_HOST ) || ( ulKind == dnsMDNS_RECORD_ALIAS ) )
+                {
+                    xSame = ( ( pxRecord->usDataLength == ( uint16_t ) ipSIZE_OF_IPv4_ADDRESS ) &&
+                              ( memcmp( &( pxReader->pucMessage[ pxRecord->uxDataOffset ] ), ipLOCAL_IP_ADDRESS_POINTER, ipSIZE_OF_IPv4_ADDRESS ) == 0 ) ) ? pdTRUE : pdFALSE;
+                }
+                else if( ( ulKind == dnsMDNS_RECORD_ENUM ) || ( ulKind == dnsMDNS_RECORD_PTR ) )
+                {
+                    xSame = pdFALSE;
+
+                    #if ( ipconfigMDNS_SERVICES > 0 )
+                        {
+                            DNSReader_t xData = *pxReader;
+                            char pcData[ dnsMDNS_NAME_LENGTH ];
+
+                            /* The data of a PTR record is a name, which must be checked before it is copied. */
+                            xData.uxOffset = pxRecord->uxDataOffset;
+
+                            if( ( prvDNSReadName( &( xData ) ) == pdPASS ) &&
+                                ( prvDNSCopyName( pxReader, pxRecord->uxDataOffset, pcData, sizeof( pcData ) ) == pdPASS ) )
+                            {
+                                xSame = prvMDNSNameIs( pcData,
+                                                       ( ulKind == dnsMDNS_RECORD_PTR ) ? xMDNSServices[ uxService ].pcInstance : NULL,
+                                                       xMDNSServices[ uxService ].pcService );
+                            }
+                        }
+                    #endif /* ipconfigMDNS_SERVICES > 0 */
+                }
+                else
+                {
+                    /* An SRV or TXT record with the name of the instance. */
+                }
+
+                if( xSame != pdFALSE )
+                {
+                    ulKnown |= ulBit;
+                }
+            }
+
+            return ulKnown;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Answer an mDNS query.
+ *
+ * @param[in] pxReader: The query, the read position is just after the header.
+ * @param[in] pxUDPPacket: The packet that contains the query.
+ */
+        static void prvMDNSTreatQuery( DNSReader_t * pxReader,
+                                       const UDPPacket_t * pxUDPPacket )
+        {
+            const DNSMessage_t * pxDNSMessageHeader = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( DNSMessage_t, pxReader->pucMessage );
+            DNSRecord_t xRecord;
+            char pcName[ dnsMDNS_NAME_LENGTH ];
+            uint16_t usQuestions = FreeRTOS_ntohs( pxDNSMessageHeader->usQuestions );
+            uint16_t usAnswers = FreeRTOS_ntohs( pxDNSMessageHeader->usAnswers );
+            uint16_t usClass, x;
+            uint32_t ulAnswers = 0U;
+            uint32_t ulAdditional;
+            uint32_t ulFound;
+            uint32_t ulIPAddress = ipMDNS_IP_ADDR;
+            uint16_t usPort = FreeRTOS_htons( ipMDNS_PORT );
+            DNSReader_t xQuestions;
+            const DNSReader_t * pxLegacy = NULL;
+            BaseType_t xReturn = pdPASS;
+
+            for( x = 0U; x < usQuestions; x++ )
+            {
+                if( ( prvDNSReadRecord( pxReader, &( xRecord ), pdTRUE ) == pdFAIL ) ||
+                    ( prvDNSCopyName( pxReader, xRecord.uxNameOffset, pcName, sizeof( pcName ) ) == pdFAIL ) )
+                {
+                    xReturn = pdFAIL;
+                    break;
+                }
+
+                usClass = xRecord.usClass & ( uint16_t ) dnsMDNS_CLASS_MASK;
+
+                if( ( usClass == ( uint16_t ) dnsCLASS_IN ) || ( usClass == ( uint16_t ) dnsCLASS_ANY ) )
+                {
+                    ulFound = prvMDNSRecordsFor( pcName, xRecord.usType );
+
+                    if( ( ulFound != 0U ) && ( ( xRecord.usClass & ( uint16_t ) dnsMDNS_CLASS_TOP_BIT ) != 0U ) )
+                    {
+                        /* The querier asks for a unicast response. */
+                        ulIPAddress = pxUDPPacket->xIPHeader.ulSourceIPAddress;
+                        usPort = pxUDPPacket->xUDPHeader.usSourcePort;
+                    }
+
+                    ulAnswers |= ulFound;
+                }
+            }
+
+            if( ( xReturn == pdPASS ) && ( ulAnswers != 0U ) )
+            {
+                if( pxUDPPacket->xUDPHeader.usSourcePort != FreeRTOS_htons( ipMDNS_PORT ) )
+                {
+                    /* A one-shot query from a simple resolver, the answer is
+                     * sent to the querier, and it repeats the questions. */
+                    xQuestions = *pxReader;
+                    pxLegacy = &( xQuestions );
+                    ulIPAddress = pxUDPPacket->xIPHeader.ulSourceIPAddress;
+                    usPort = pxUDPPacket->xUDPHeader.usSourcePort;
+                }
+
+                /* Leave out the answers that the querier already knows. */
+                for( x = 0U; x < usAnswers; x++ )
+                {
+                    if( ( prvDNSReadRecord( pxReader, &( xRecord ), pdFALSE ) == pdFAIL ) ||
+                        ( prvDNSCopyName( pxReader, xRecord.uxNameOffset, pcName, sizeof( pcName ) ) == pdFAIL ) )
+                    {
+                        break;
+                    }
+
+                    ulAnswers &= ~prvMDNSKnownAnswers( pxReader, &( xRecord ), pcName );
+                }
+
+                /* A PTR record is followed by the SRV and TXT records of the
+                 * instance, and an SRV record by the address of the host. */
+                ulAdditional = ( ( ulAnswers & dnsMDNS_ALL_PTR_RECORDS ) << 1 ) | ( ( ulAnswers & dnsMDNS_ALL_PTR_RECORDS ) << 2 );
+
+                if( ( ulAnswers & ( dnsMDNS_ALL_PTR_RECORDS | dnsMDNS_ALL_SRV_RECORDS ) ) != 0U )
+                {
+                    ulAdditional |= dnsMDNS_RECORD_HOST;
+                }
+
+                ulAdditional &= ~ulAnswers;
+
+                if( ulAnswers != 0U )
+                {
+                    ( void ) prvMDNSSend( ulAnswers, ulAdditional, ulIPAddress, usPort, pxLegacy );
+                }
+            }
+        }
+        /*-----------------------------------------------------------*/
+
+        #if ( ipconfigUSE_DNS_CACHE == 1 )
+
+/**
+ * @brief Store the addresses found in an mDNS response in the DNS cache.
+ *
+ * @param[in] pxReader: The response, the read position is just after the header.
+ */
+            static void prvMDNSTreatResponse( DNSReader_t * pxReader )
+            {
+                const DNSMessage_t * pxDNSMessageHeader = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( DNSMessage_t, pxReader->pucMessage );
+                DNSRecord_t xRecord;
+                char pcName[ dnsMDNS_NAME_LENGTH ];
+                uint32_t ulIPAddress;
+                uint32_t ulRecord, ulCount;
+                uint16_t usQuestions = FreeRTOS_ntohs( pxDNSMessageHeader->usQuestions );
+
+                /* All records that follow the questions are of interest. */
+                ulCount = ( uint32_t ) usQuestions +
+                          ( uint32_t ) FreeRTOS_ntohs( pxDNSMessageHeader->usAnswers ) +
+                          ( uint32_t ) FreeRTOS_ntohs( pxDNSMessageHeader->usAuthorityRRs ) +
+                          ( uint32_t ) FreeRTOS_ntohs( pxDNSMessageHeader->usAdditionalRRs );
+
+                for( ulRecord = 0U; ulRecord < ulCount; ulRecord++ )
+                {
+                    if( prvDNSReadRecord( pxReader, &( xRecord ), ( ulRecord < usQuestions ) ? pdTRUE : pdFALSE ) == pdFAIL )
+                    {
+                        break;
+                    }
+
+                    if( ( ulRecord >= usQuestions ) &&
+                        ( xRecord.usType == ( uint16_t ) dnsTYPE_A_HOST ) &&
+                        ( ( xRecord.usClass & ( uint16_t ) dnsMDNS_CLASS_MASK ) == ( uint16_t ) dnsCLASS_IN ) &&
+                        ( xRecord.usDataLength == ( uint16_t ) ipSIZE_OF_IPv4_ADDRESS ) )
+                    {
+                        ( void ) memcpy( &( ulIPAddress ), &( pxReader->pucMessage[ xRecord.uxDataOffset ] ), sizeof( ulIPAddress ) );
+
+                        if( ( ulIPAddress != 0U ) &&
+                            ( prvDNSCopyName( pxReader, xRecord.uxNameOffset, pcName, sizeof( pcName ) ) == pdPASS ) )
+                        {
+                            ( void ) prvProcessDNSCache( pcName, &( ulIPAddress ), FreeRTOS_htonl( xRecord.ulTTL ), pdFALSE );
+                        }
+                    }
+                }
+            }
+        #endif /* ipconfigUSE_DNS_CACHE */
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle an mDNS packet: answer a query, or learn from a response.
+ *
+ * @param[in] pxNetworkBuffer: The network buffer holding the mDNS packet.
+ *
+ * @return pdFAIL to show that the packet was not consumed.
+ */
+        uint32_t ulMDNSHandlePacket( NetworkBufferDescriptor_t * pxNetworkBuffer )
+        {
+            const UDPPacket_t * pxUDPPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( UDPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+            DNSReader_t xReader;
+            uint8_t ucFlags;
+
+            /* Messages that this device sent itself are ignored. */
+            if( ( pxNetworkBuffer->xDataLength >= ( sizeof( UDPPacket_t ) + sizeof( DNSMessage_t ) ) ) &&
+                ( *ipLOCAL_IP_ADDRESS_POINTER != 0U ) &&
+                ( pxUDPPacket->xIPHeader.ulSourceIPAddress != *ipLOCAL_IP_ADDRESS_POINTER ) )
+            {
+                xReader.pucMessage = &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( UDPPacket_t ) ] );
+                xReader.uxLength = pxNetworkBuffer->xDataLength - sizeof( UDPPacket_t );
+                xReader.uxOffset = sizeof( DNSMessage_t );
+
+                /* The QR bit and the opcode. */
+                ucFlags = xReader.pucMessage[ 2 ];
+
+                if( ( ucFlags & 0x80U ) != 0U )
+                {
+                    #if ( ipconfigUSE_DNS_CACHE == 1 )
+                        prvMDNSTreatResponse( &( xReader ) );
+                    #endif
+                }
+                else if( ( ucFlags & 0x78U ) == 0U )
+                {
+                    prvMDNSTreatQuery( &( xReader ), pxUDPPacket );
+                }
+                else
+                {
+                    /* Other opcodes are ignored. */
+                }
+            }
+
+            /* The packet was not consumed. */
+            return pdFAIL;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the records of all registered services, and of the host.
+ *
+ * @return A bit for each record that is announced.
+ */
+        static uint32_t prvMDNSAllRecords( void )
+        {
+            const char * pcHostName = pcApplicationHostnameHook();
+            uint32_t ulRecords = 0U;
+
+            if( ( pcHostName != NULL ) && ( pcHostName[ 0 ] != ( char ) 0 ) )
+            {
+                ulRecords |= dnsMDNS_RECORD_HOST;
+            }
 
-                for( ; ; )
+            #if ( ipconfigMDNS_SERVICES > 0 )
                 {
-                    const uint8_t ucCharA = ( uint8_t ) 0x41U;
-
-                    ucByte = ( ( uint8_t ) ( ( pucSource[ 0 ] - ucCharA ) << 4 ) ) | ( pucSource[ 1 ] - ucCharA );
+                    UBaseType_t uxService, uxOther;
+                    uint32_t ulFound;
 
-                    /* Make sure there are no trailing spaces in the name. */
-                    if( ( ucByte == ( uint8_t ) ' ' ) && ( pucTarget[ 1 ] == 0U ) )
+                    for( uxService = 0U; uxService < ( UBaseType_t ) ipconfigMDNS_SERVICES; uxService++ )
                     {
-                        ucByte = 0U;
+                        if( xMDNSServices[ uxService ].usPort != 0U )
+                        {
+                            ulFound = dnsMDNS_RECORD_ENUM | dnsMDNS_RECORD_PTR | dnsMDNS_RECORD_SRV | dnsMDNS_RECORD_TXT;
+
+                            for( uxOther = 0U; uxOther < uxService; uxOther++ )
+                            {
+                                if( ( xMDNSServices[ uxOther ].usPort != 0U ) &&
+                                    ( strcmp( xMDNSServices[ uxOther ].pcService, xMDNSServices[ uxService ].pcService ) == 0 ) )
+                                {
+                                    /* The service type was already enumerated. */
+                                    ulFound &= ~dnsMDNS_RECORD_ENUM;
+                                    break;
+                                }
+                            }
+
+                            ulRecords |= ulFound << ( dnsMDNS_BITS_PER_SERVICE * uxService );
+                        }
                     }
+                }
+            #endif /* ipconfigMDNS_SERVICES > 0 */
 
-                    *pucTarget = ucByte;
+            return ulRecords;
+        }
+        /*-----------------------------------------------------------*/
 
-                    if( pucTarget == ucNBNSName )
+/**
+ * @brief Start sending unsolicited responses, for instance when the network
+ *        comes up.  Called from the IP-task.
+ */
+        void vMDNSStartAnnouncing( void )
+        {
+            ucMDNSAnnouncements = ( uint8_t ) dnsMDNS_ANNOUNCEMENTS;
+            vMDNSAnnounceProcess();
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Send an unsolicited response with all records, and schedule the next
+ *        one.  Called from the IP-task.
+ */
+        void vMDNSAnnounceProcess( void )
+        {
+            uint32_t ulRecords = prvMDNSAllRecords();
+            uint32_t ulLeft;
+
+            if( ( ucMDNSAnnouncements > 0U ) && ( *ipLOCAL_IP_ADDRESS_POINTER != 0U ) )
+            {
+                /* Send as many messages as needed. */
+                while( ulRecords != 0U )
+                {
+                    ulLeft = prvMDNSSend( ulRecords, 0U, ipMDNS_IP_ADDR, FreeRTOS_htons( ipMDNS_PORT ), NULL );
+
+                    if( ulLeft == ulRecords )
                     {
+                        /* No progress, out of buffers or a record that never fits. */
                         break;
                     }
 
-                    pucTarget -= 1;
-                    pucSource -= 2;
+                    ulRecords = ulLeft;
                 }
 
-                #if ( ipconfigUSE_DNS_CACHE == 1 )
+                ucMDNSAnnouncements--;
+            }
+
+            if( ucMDNSAnnouncements > 0U )
+            {
+                vIPReloadMDNSTimer( pdMS_TO_TICKS( dnsMDNS_ANNOUNCE_MS ) );
+            }
+            else
+            {
+                vIPSetMDNSTimerEnableState( pdFALSE );
+            }
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Ask the IP-task to announce the host name and the services again.
+ *
+ * @return pdPASS when the message was sent to the IP-task.
+ */
+        BaseType_t FreeRTOS_mDNSAnnounce( void )
+        {
+            return xSendEventToIPTask( eMDNSAnnounceEvent );
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Register a DNS-SD service.  The strings are not copied.
+ *
+ * @param[in] pcInstance: The instance name, a single label of at most 63 bytes.
+ * @param[in] pcService: The service type, e.g. "_http._tcp".
+ * @param[in] usPort: The port number of the service, in host endianness.
+ * @param[in] pcText: The TXT strings separated by newlines, or NULL.
+ *
+ * @return pdPASS when the service was registered.
+ */
+        BaseType_t FreeRTOS_mDNSAddService( const char * pcInstance,
+                                            const char * pcService,
+                                            uint16_t usPort,
+                                            const char * pcText )
+        {
+            BaseType_t xReturn = pdFAIL;
+
+            #if ( ipconfigMDNS_SERVICES > 0 )
+                {
+                    UBaseType_t uxService;
+                    size_t uxLength;
+
+                    if( ( pcInstance != NULL ) && ( pcService != NULL ) && ( usPort != 0U ) )
                     {
-                        if( ( usFlags & dnsNBNS_FLAGS_RESPONSE ) != 0U )
+                        uxLength = strlen( pcInstance );
+
+                        if( ( uxLength > 0U ) && ( uxLength <= 63U ) && ( pcService[ 0 ] == '_' ) )
                         {
-                            /* If this is a response from another device,
-                             * add the name to the DNS cache */
-                            ( void ) prvProcessDNSCache( ( char * ) ucNBNSName, &( ulIPAddress ), 0, pdFALSE );
+                            vTaskSuspendAll();
+                            {
+                                for( uxService = 0U; uxService < ( UBaseType_t ) ipconfigMDNS_SERVICES; uxService++ )
+                                {
+                                    if( xMDNSServices[ uxService ].usPort == 0U )
+                                    {
+                                        xMDNSServices[ uxService ].pcInstance = pcInstance;
+                                        xMDNSServices[ uxService ].pcService = pcService;
+                                        xMDNSServices[ uxService ].pcText = pcText;
+                                        xMDNSServices[ uxService ].usPort = usPort;
+                                        xReturn = pdPASS;
+                                        break;
+                                    }
+                                }
+                            }
+                            ( void ) xTaskResumeAll();
                         }
                     }
-                #else
+
+                    if( xReturn == pdPASS )
                     {
-                        /* Avoid compiler warnings. */
-                        ( void ) ulIPAddress;
+                        ( void ) FreeRTOS_mDNSAnnounce();
                     }
-                #endif /* ipconfigUSE_DNS_CACHE */
+                }
+            #else /* if ( ipconfigMDNS_SERVICES > 0 ) */
+                {
+                    ( void ) pcInstance;
+                    ( void ) pcService;
+                    ( void ) usPort;
+                    ( void ) pcText;
+                }
+            #endif /* ipconfigMDNS_SERVICES > 0 */
+
+            return xReturn;
+        }
+
+    #endif /* ipconfigUSE_MDNS */
+/*-----------------------------------------------------------*/
+
+
+    #if ( ipconfigUSE_DNS_CACHE == 1 )
+
+    #if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+
+/**
+ * @brief Convert an upper case ASCII character to lower case.
+ *
+ * @param[in] ucChar: The character.
+ *
+ * @return The character in lower case.
+ */
+        static portINLINE uint8_t prvDNSToLower( uint8_t ucChar )
+        {
+            uint8_t ucReturn = ucChar;
+
+            if( ( ucChar >= ( uint8_t ) 'A' ) && ( ucChar <= ( uint8_t ) 'Z' ) )
+            {
+                ucReturn = ucChar + ( uint8_t ) ( 'a' - 'A' );
+            }
+
+            return ucReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate the case-insensitive FNV-1a hash of a host name.
+ *
+ * @param[in] pcName: The host name.
+ * @param[out] puxLength: The length of the name.
+ *
+ * @return The hash of the name.
+ */
+        static uint32_t prvDNSCacheHash( const char * pcName,
+                                         size_t * puxLength )
+        {
+            const uint8_t * pucName = ( const uint8_t * ) pcName;
+            uint32_t ulHash = 0x811c9dc5U;
+            size_t uxIndex = 0U;
+
+            while( pucName[ uxIndex ] != 0U )
+            {
+                ulHash ^= ( uint32_t ) prvDNSToLower( pucName[ uxIndex ] );
+                ulHash *= 0x01000193U;
+                uxIndex++;
+            }
+
+            *puxLength = uxIndex;
+
+            return ulHash;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Initialise the hash buckets, the list of free entries and the LRU list.
+ */
+        static void prvDNSCacheInit( void )
+        {
+            BaseType_t x;
+
+            for( x = 0; x < ( BaseType_t ) ipconfigDNS_CACHE_HASH_BUCKETS; x++ )
+            {
+                usDNSCacheBuckets[ x ] = dnsCACHE_NONE;
+            }
+
+            for( x = 0; x < ( BaseType_t ) ipconfigDNS_CACHE_ENTRIES; x++ )
+            {
+                xDNSCache[ x ].ucFlags = 0U;
+                xDNSCache[ x ].usHashNext = ( uint16_t ) ( x + 1 );
+            }
+
+            xDNSCache[ ipconfigDNS_CACHE_ENTRIES - 1 ].usHashNext = dnsCACHE_NONE;
+            usDNSCacheFree = 0U;
+            usDNSCacheLRUHead = dnsCACHE_NONE;
+            usDNSCacheLRUTail = dnsCACHE_NONE;
+            uxDNSNameArenaUsed = 0U;
+            xDNSCacheReady = pdTRUE;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the cache entry of a host name.
+ *
+ * @param[in] pcName: The host name.
+ * @param[in] ulHash: The hash of the name.
+ * @param[in] uxLength: The length of the name.
+ *
+ * @return The index of the entry, or -1 when the name is not in the cache.
+ */
+        static BaseType_t prvDNSCacheFind( const char * pcName,
+                                           uint32_t ulHash,
+                                           size_t uxLength )
+        {
+            const uint8_t * pucName = ( const uint8_t * ) pcName;
+            BaseType_t xReturn = -1;
+            uint16_t usEntry;
+            size_t uxIndex;
+
+            if( xDNSCacheReady == pdFALSE )
+            {
+                prvDNSCacheInit();
+            }
+
+            usEntry = usDNSCacheBuckets[ ulHash & ( ipconfigDNS_CACHE_HASH_BUCKETS - 1U ) ];
+
+            while( usEntry != dnsCACHE_NONE )
+            {
+                const DNSCacheRow_t * pxRow = &( xDNSCache[ usEntry ] );
+
+                if( ( pxRow->ulNameHash == ulHash ) && ( ( size_t ) pxRow->ucNameLength == uxLength ) )
+                {
+                    for( uxIndex = 0U; uxIndex < uxLength; uxIndex++ )
+                    {
+                        if( ucDNSNameArena[ pxRow->usNameOffset + uxIndex ] != prvDNSToLower( pucName[ uxIndex ] ) )
+                        {
+                            break;
+                        }
+                    }
+
+                    if( uxIndex == uxLength )
+                    {
+                        xReturn = ( BaseType_t ) usEntry;
+                        break;
+                    }
+                }
+
+                usEntry = pxRow->usHashNext;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove an entry from the LRU list.
+ *
+ * @param[in] xEntry: The index of the entry.
+ */
+        static void prvDNSCacheLRURemove( BaseType_t xEntry )
+        {
+            DNSCacheRow_t * pxRow = &( xDNSCache[ xEntry ] );
+
+            if( pxRow->usLRUPrev != dnsCACHE_NONE )
+            {
+                xDNSCache[ pxRow->usLRUPrev ].usLRUNext = pxRow->usLRUNext;
+            }
+            else
+            {
+                usDNSCacheLRUHead = pxRow->usLRUNext;
+            }
+
+            if( pxRow->usLRUNext != dnsCACHE_NONE )
+            {
+                xDNSCache[ pxRow->usLRUNext ].usLRUPrev = pxRow->usLRUPrev;
+            }
+            else
+            {
+                usDNSCacheLRUTail = pxRow->usLRUPrev;
+            }
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Insert an entry at the head of the LRU list, as the most recently used one.
+ *
+ * @param[in] xEntry: The index of the entry.
+ */
+        static void prvDNSCacheLRUInsert( BaseType_t xEntry )
+        {
+            DNSCacheRow_t * pxRow = &( xDNSCache[ xEntry ] );
+
+            pxRow->usLRUPrev = dnsCACHE_NONE;
+            pxRow->usLRUNext = usDNSCacheLRUHead;
+
+            if( usDNSCacheLRUHead != dnsCACHE_NONE )
+            {
+                xDNSCache[ usDNSCacheLRUHead ].usLRUPrev = ( uint16_t ) xEntry;
+            }
+            else
+            {
+                usDNSCacheLRUTail = ( uint16_t ) xEntry;
+            }
+
+            usDNSCacheLRUHead = ( uint16_t ) xEntry;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove an entry from the cache, and add it to the list of free entries.
+ *        Its name stays in the arena until the arena is compacted.
+ *
+ * @param[in] xEntry: The index of the entry.
+ */
+        static void prvDNSCacheRemove( BaseType_t xEntry )
+        {
+            DNSCacheRow_t * pxRow = &( xDNSCache[ xEntry ] );
+            uint16_t * pusLink = &( usDNSCacheBuckets[ pxRow->ulNameHash & ( ipconfigDNS_CACHE_HASH_BUCKETS - 1U ) ] );
+
+            while( *pusLink != dnsCACHE_NONE )
+            {
+                if( *pusLink == ( uint16_t ) xEntry )
+                {
+                    *pusLink = pxRow->usHashNext;
+                    break;
+                }
+
+                pusLink = &( xDNSCache[ *pusLink ].usHashNext );
+            }
+
+            prvDNSCacheLRURemove( xEntry );
+
+            pxRow->ucFlags = 0U;
+            pxRow->usHashNext = usDNSCacheFree;
+            usDNSCacheFree = ( uint16_t ) xEntry;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Move the names of the entries in use to the start of the arena, so
+ *        that the space of the removed entries becomes available.
+ */
+        static void prvDNSCacheCompact( void )
+        {
+            BaseType_t x;
+            BaseType_t xLowest;
+            size_t uxWrite = 0U;
+
+            /* Names only move down, so the entries that have not been moved yet
+             * are the ones with an offset at or above the write position.  Move
+             * them in the order of their offset. */
+            for( ; ; )
+            {
+                xLowest = -1;
+
+                for( x = 0; x < ( BaseType_t ) ipconfigDNS_CACHE_ENTRIES; x++ )
+                {
+                    if( ( xDNSCache[ x ].ucFlags != 0U ) &&
+                        ( ( size_t ) xDNSCache[ x ].usNameOffset >= uxWrite ) &&
+                        ( ( xLowest < 0 ) || ( xDNSCache[ x ].usNameOffset < xDNSCache[ xLowest ].usNameOffset ) ) )
+                    {
+                        xLowest = x;
+                    }
+                }
+
+                if( xLowest < 0 )
+                {
+                    break;
+                }
+
+                if( ( size_t ) xDNSCache[ xLowest ].usNameOffset != uxWrite )
+                {
+                    ( void ) memmove( &( ucDNSNameArena[ uxWrite ] ),
+                                      &( ucDNSNameArena[ xDNSCache[ xLowest ].usNameOffset ] ),
+                                      xDNSCache[ xLowest ].ucNameLength );
+                    xDNSCache[ xLowest ].usNameOffset = ( uint16_t ) uxWrite;
+                }
+
+                uxWrite += xDNSCache[ xLowest ].ucNameLength;
+            }
+
+            uxDNSNameArenaUsed = uxWrite;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Create a new entry for a host name.  When there is no free entry or not
+ *        enough room in the name arena, the least recently used entries are
+ *        replaced.
+ *
+ * @param[in] pcName: The host name.
+ * @param[in] ulHash: The hash of the name.
+ * @param[in] uxLength: The length of the name, which fits in the arena.
+ *
+ * @return The index of the new entry.
+ */
+        static BaseType_t prvDNSCacheAllocate( const char * pcName,
+                                               uint32_t ulHash,
+                                               size_t uxLength )
+        {
+            const uint8_t * pucName = ( const uint8_t * ) pcName;
+            DNSCacheRow_t * pxRow;
+            BaseType_t xEntry;
+            size_t uxIndex;
+            uint16_t * pusBucket;
+
+            if( usDNSCacheFree == dnsCACHE_NONE )
+            {
+                prvDNSCacheRemove( ( BaseType_t ) usDNSCacheLRUTail );
+            }
+
+            if( ( uxDNSNameArenaUsed + uxLength ) > ( size_t ) ipconfigDNS_CACHE_NAME_ARENA_SIZE )
+            {
+                prvDNSCacheCompact();
+
+                while( ( uxDNSNameArenaUsed + uxLength ) > ( size_t ) ipconfigDNS_CACHE_NAME_ARENA_SIZE )
+                {
+                    prvDNSCacheRemove( ( BaseType_t ) usDNSCacheLRUTail );
+                    prvDNSCacheCompact();
+                }
+            }
+
+            xEntry = ( BaseType_t ) usDNSCacheFree;
+            pxRow = &( xDNSCache[ xEntry ] );
+            usDNSCacheFree = pxRow->usHashNext;
+
+            /* The name is stored in lower case, so it can be compared directly. */
+            for( uxIndex = 0U; uxIndex < uxLength; uxIndex++ )
+            {
+                ucDNSNameArena[ uxDNSNameArenaUsed + uxIndex ] = prvDNSToLower( pucName[ uxIndex ] );
+            }
+
+            pxRow->usNameOffset = ( uint16_t ) uxDNSNameArenaUsed;
+            pxRow->ucNameLength = ( uint8_t ) uxLength;
+            pxRow->ulNameHash = ulHash;
+            pxRow->ucFlags = dnsCACHE_FLAG_IN_USE;
+            pxRow->usHits = 0U;
+            uxDNSNameArenaUsed += uxLength;
+
+            #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+                pxRow->ucNumIPAddresses = 0U;
+                pxRow->ucCurrentIPAddress = 0U;
+            #endif
+            ( void ) memset( pxRow->ulIPAddresses, 0, sizeof( pxRow->ulIPAddresses ) );
 
-                if( ( ( usFlags & dnsNBNS_FLAGS_RESPONSE ) == 0U ) &&
-                    ( usType == dnsNBNS_TYPE_NET_BIOS ) &&
-                    ( xApplicationDNSQueryHook( ( const char * ) ucNBNSName ) != pdFALSE ) )
-                {
-                    uint16_t usLength;
-                    DNSMessage_t * pxMessage;
-                    NBNSAnswer_t * pxAnswer;
-                    NetworkBufferDescriptor_t * pxNewBuffer = NULL;
+            pusBucket = &( usDNSCacheBuckets[ ulHash & ( ipconfigDNS_CACHE_HASH_BUCKETS - 1U ) ] );
+            pxRow->usHashNext = *pusBucket;
+            *pusBucket = ( uint16_t ) xEntry;
 
-                    /* Someone is looking for a device with ucNBNSName,
-                     * prepare a positive reply. */
-                    pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pucUDPPayloadBuffer );
+            prvDNSCacheLRUInsert( xEntry );
 
-                    if( ( xBufferAllocFixedSize == pdFALSE ) && ( pxNetworkBuffer != NULL ) )
-                    {
-                        /* The field xDataLength was set to the total length of the UDP packet,
-                         * i.e. the payload size plus sizeof( UDPPacket_t ). */
-                        pxNewBuffer = pxDuplicateNetworkBufferWithDescriptor( pxNetworkBuffer, pxNetworkBuffer->xDataLength + sizeof( NBNSAnswer_t ) );
+            return xEntry;
+        }
+        /*-----------------------------------------------------------*/
 
-                        if( pxNewBuffer != NULL )
-                        {
-                            pucUDPPayloadBuffer = &( pxNewBuffer->pucEthernetBuffer[ sizeof( UDPPacket_t ) ] );
-                            pxNetworkBuffer = pxNewBuffer;
-                        }
-                        else
-                        {
-                            /* Just prevent that a reply will be sent */
-                            pxNetworkBuffer = NULL;
-                        }
-                    }
+/**
+ * @brief Check whether the cache holds a negative answer for a host name, i.e.
+ *        the name is known not to have an address.
+ *
+ * @param[in] pcName: The host name.
+ *
+ * @return pdTRUE if a negative answer is cached, otherwise pdFALSE.
+ */
+        static BaseType_t prvDNSCacheIsNegative( const char * pcName )
+        {
+            BaseType_t xReturn = pdFALSE;
+            BaseType_t xEntry;
+            size_t uxLength;
+            uint32_t ulHash = prvDNSCacheHash( pcName, &( uxLength ) );
+            uint32_t ulCurrentTimeSeconds = ( xTaskGetTickCount() / portTICK_PERIOD_MS ) / 1000U;
 
-                    /* Should not occur: pucUDPPayloadBuffer is part of a xNetworkBufferDescriptor */
-                    if( pxNetworkBuffer != NULL )
-                    {
-                        pxMessage = ipCAST_PTR_TO_TYPE_PTR( DNSMessage_t, pucUDPPayloadBuffer );
+            vTaskSuspendAll();
+            {
+                xEntry = prvDNSCacheFind( pcName, ulHash, uxLength );
 
-                        /* As the fields in the structures are not word-aligned, we have to
-                         * copy the values byte-by-byte using macro's vSetField16() and vSetField32() */
-                        #ifndef _lint
-                            vSetField16( pxMessage, DNSMessage_t, usFlags, dnsNBNS_QUERY_RESPONSE_FLAGS ); /* 0x8500 */
-                            vSetField16( pxMessage, DNSMessage_t, usQuestions, 0 );
-                            vSetField16( pxMessage, DNSMessage_t, usAnswers, 1 );
-                            vSetField16( pxMessage, DNSMessage_t, usAuthorityRRs, 0 );
-                            vSetField16( pxMessage, DNSMessage_t, usAdditionalRRs, 0 );
-                        #else
-                            ( void ) pxMessage;
-                        #endif
+                if( ( xEntry >= 0 ) &&
+                    ( ( xDNSCache[ xEntry ].ucFlags & dnsCACHE_FLAG_NEGATIVE ) != 0U ) &&
+                    ( ulCurrentTimeSeconds < ( xDNSCache[ xEntry ].ulTimeWhenAddedInSeconds + FreeRTOS_ntohl( xDNSCache[ xEntry ].ulTTL ) ) ) )
+                {
+                    xReturn = pdTRUE;
+                }
+            }
+            ( void ) xTaskResumeAll();
 
-                        pxAnswer = ipCAST_PTR_TO_TYPE_PTR( NBNSAnswer_t, &( pucUDPPayloadBuffer[ offsetof( NBNSRequest_t, usType ) ] ) );
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
 
-                        #ifndef _lint
-                            vSetField16( pxAnswer, NBNSAnswer_t, usType, usType );            /* Type */
-                            vSetField16( pxAnswer, NBNSAnswer_t, usClass, dnsNBNS_CLASS_IN ); /* Class */
-                            vSetField32( pxAnswer, NBNSAnswer_t, ulTTL, dnsNBNS_TTL_VALUE );
-                            vSetField16( pxAnswer, NBNSAnswer_t, usDataLength, 6 );           /* 6 bytes including the length field */
-                            vSetField16( pxAnswer, NBNSAnswer_t, usNbFlags, dnsNBNS_NAME_FLAGS );
-                            vSetField32( pxAnswer, NBNSAnswer_t, ulIPAddress, FreeRTOS_ntohl( *ipLOCAL_IP_ADDRESS_POINTER ) );
-                        #else
-                            ( void ) pxAnswer;
-                        #endif
+/**
+ * @brief A DNS reply did not contain an address for the name: look for the SOA
+ *        record in the authority section, and cache the negative answer for
+ *        the time given by it (RFC 2308).  Without a SOA record, nothing is cached.
+ *
+ * @param[in] pcName: The name that was looked up.
+ * @param[in,out] pxReader: The read position of the first record following the
+ *                          question section, or following the answer section.
+ * @param[in] usSkip: The number of answer records to skip before the authority section.
+ * @param[in] usAuthorities: The number of records in the authority section.
+ */
+        static void prvDNSCacheStoreNegative( const char * pcName,
+                                              DNSReader_t * pxReader,
+                                              uint16_t usSkip,
+                                              uint16_t usAuthorities )
+        {
+            DNSRecord_t xRecord;
+            DNSReader_t xData;
+            uint32_t ulRecord;
+            uint32_t ulTTL;
+            uint32_t ulMinimum;
+            uint32_t ulIPAddress = 0U;
 
-                        usLength = ( uint16_t ) ( sizeof( NBNSAnswer_t ) + ( size_t ) offsetof( NBNSRequest_t, usType ) );
+            for( ulRecord = 0U; ulRecord < ( ( uint32_t ) usSkip + ( uint32_t ) usAuthorities ); ulRecord++ )
+            {
+                if( prvDNSReadRecord( pxReader, &( xRecord ), pdFALSE ) == pdFAIL )
+                {
+                    /* Malformed response. */
+                    break;
+                }
 
-                        prvReplyDNSMessage( pxNetworkBuffer, ( BaseType_t ) usLength );
+                if( ( ulRecord >= ( uint32_t ) usSkip ) && ( xRecord.usType == ( uint16_t ) dnsTYPE_SOA ) )
+                {
+                    /* Skip MNAME and RNAME, followed by SERIAL, REFRESH, RETRY,
+                     * EXPIRE and MINIMUM.  The names may refer to earlier names
+                     * in the message, so only the end of the data is changed. */
+                    xData.pucMessage = pxReader->pucMessage;
+                    xData.uxLength = xRecord.uxDataOffset + ( size_t ) xRecord.usDataLength;
+                    xData.uxOffset = xRecord.uxDataOffset;
+
+                    if( ( prvDNSReadName( &( xData ) ) == pdPASS ) &&
+                        ( prvDNSReadName( &( xData ) ) == pdPASS ) &&
+                        ( ( xData.uxLength - xData.uxOffset ) >= ( 5U * sizeof( uint32_t ) ) ) )
+                    {
+                        ulMinimum = ulChar2u32( &( xData.pucMessage[ xData.uxOffset + ( 4U * sizeof( uint32_t ) ) ] ) );
+                        ulTTL = FreeRTOS_min_uint32( xRecord.ulTTL, ulMinimum );
+                        ulTTL = FreeRTOS_min_uint32( ulTTL, ( uint32_t ) ipconfigDNS_CACHE_NEGATIVE_TTL_MAX );
 
-                        if( pxNewBuffer != NULL )
+                        if( ulTTL != 0U )
                         {
-                            vReleaseNetworkBufferAndDescriptor( pxNewBuffer );
+                            /* Storing the address 0 records a negative answer. */
+                            ( void ) prvProcessDNSCache( pcName, &( ulIPAddress ), FreeRTOS_htonl( ulTTL ), pdFALSE );
                         }
                     }
+
+                    break;
                 }
             }
         }
+        /*-----------------------------------------------------------*/
 
-    #endif /* ipconfigUSE_NBNS */
-    /*-----------------------------------------------------------*/
+        #if ( ipconfigDNS_CACHE_PREFETCH_SECONDS != 0 )
 
 /**
- * @brief Create a socket and bind it to the standard DNS port number.
+ * @brief The call-back of a prefetch.  The answer has already been stored in
+ *        the DNS cache, there is nothing left to do.
  *
- * @return The created socket - or NULL if the socket could not be created or could not be bound.
+ * @param[in] pcName: The name that was looked up.
+ * @param[in] pvSearchID: Not used.
+ * @param[in] ulIPAddress: The IP-address found, or zero.
  */
-    static Socket_t prvCreateDNSSocket( void )
-    {
-        Socket_t xSocket;
-        struct freertos_sockaddr xAddress;
-        BaseType_t xReturn;
-
-        /* This must be the first time this function has been called.  Create
-         * the socket. */
-        xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
-
-        if( xSocketValid( xSocket ) == pdFALSE )
-        {
-            /* There was an error, return NULL. */
-            xSocket = NULL;
-        }
-        else
-        {
-            /* Auto bind the port. */
-            xAddress.sin_port = 0U;
-            xReturn = FreeRTOS_bind( xSocket, &xAddress, ( socklen_t ) sizeof( xAddress ) );
-
-            /* Check the bind was successful, and clean up if not. */
-            if( xReturn != 0 )
-            {
-                ( void ) FreeRTOS_closesocket( xSocket );
-                xSocket = NULL;
-            }
-            else
+            static void prvDNSCachePrefetchDone( const char * pcName,
+                                                 void * pvSearchID,
+                                                 uint32_t ulIPAddress )
             {
-                /* The send and receive timeouts will be set later on. */
+                ( void ) pcName;
+                ( void ) pvSearchID;
+                ( void ) ulIPAddress;
             }
-        }
+            /*-----------------------------------------------------------*/
 
-        return xSocket;
-    }
-/*-----------------------------------------------------------*/
+/**
+ * @brief Let the resolver look up a name again before its cache entry expires.
+ *
+ * @param[in] pcName: The name to be looked up.
+ */
+            static void prvDNSCachePrefetch( const char * pcName )
+            {
+                uint32_t ulNumber = 0U;
 
-    #if ( ( ipconfigUSE_NBNS == 1 ) || ( ipconfigUSE_LLMNR == 1 ) )
+                if( xApplicationGetRandomNumber( &( ulNumber ) ) != pdFALSE )
+                {
+                    ( void ) prvDNSResolverLookup( pcName,
+                                                   ( TickType_t ) ( ulNumber & 0xffffU ),
+                                                   prvDNSCachePrefetchDone,
+                                                   NULL,
+                                                   ( TickType_t ) ( ipconfigDNS_CACHE_PREFETCH_SECONDS * 1000U ) );
+                }
+            }
+            /*-----------------------------------------------------------*/
+        #endif /* ipconfigDNS_CACHE_PREFETCH_SECONDS */
 
 /**
- * @brief Send a DNS message to be used in NBNS or LLMNR
+ * @brief Look up a host name in the DNS cache, or add/update its entry.  The
+ *        entries are found through a hash table, and when the cache is full,
+ *        the least recently used entry is replaced.
  *
- * @param[in] pxNetworkBuffer: The network buffer descriptor with the DNS message.
- * @param[in] lNetLength: The length of the DNS message.
+ * @param[in] pcName: the name of the host
+ * @param[in,out] pulIP: when doing a lookup, will be set, when doing an update,
+ *                       will be read.  Adding the address 0 stores a negative answer.
+ * @param[in] ulTTL: Time To Live, in network byte order.
+ * @param[in] xLookUp: pdTRUE if a look-up is expected, pdFALSE, when the DNS cache must
+ *                     be updated.
+ *
+ * @return pdTRUE if the name was found in the cache.
  */
-        static void prvReplyDNSMessage( NetworkBufferDescriptor_t * pxNetworkBuffer,
-                                        BaseType_t lNetLength )
+        static BaseType_t prvProcessDNSCache( const char * pcName,
+                                              uint32_t * pulIP,
+                                              uint32_t ulTTL,
+                                              BaseType_t xLookUp )
         {
-            UDPPacket_t * pxUDPPacket;
-            IPHeader_t * pxIPHeader;
-            UDPHeader_t * pxUDPHeader;
-            size_t uxDataLength;
-
-            pxUDPPacket = ipCAST_PTR_TO_TYPE_PTR( UDPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
-            pxIPHeader = &pxUDPPacket->xIPHeader;
-            pxUDPHeader = &pxUDPPacket->xUDPHeader;
-            /* HT: started using defines like 'ipSIZE_OF_xxx' */
-            pxIPHeader->usLength = FreeRTOS_htons( ( uint16_t ) lNetLength + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER );
-            /* HT:endian: should not be translated, copying from packet to packet */
-            pxIPHeader->ulDestinationIPAddress = pxIPHeader->ulSourceIPAddress;
-            pxIPHeader->ulSourceIPAddress = *ipLOCAL_IP_ADDRESS_POINTER;
-            pxIPHeader->ucTimeToLive = ipconfigUDP_TIME_TO_LIVE;
-            pxIPHeader->usIdentification = FreeRTOS_htons( usPacketIdentifier );
+            BaseType_t xFound = pdFALSE;
+            BaseType_t xEntry;
+            DNSCacheRow_t * pxRow;
+            uint32_t ulCurrentTimeSeconds = ( xTaskGetTickCount() / portTICK_PERIOD_MS ) / 1000U;
+            uint32_t ulIPAddressIndex = 0;
+            size_t uxLength;
+            uint32_t ulHash;
 
-            /* The stack doesn't support fragments, so the fragment offset field must always be zero.
-             * The header was never memset to zero, so set both the fragment offset and fragmentation flags in one go.
-             */
-            #if ( ipconfigFORCE_IP_DONT_FRAGMENT != 0 )
-                pxIPHeader->usFragmentOffset = ipFRAGMENT_FLAGS_DONT_FRAGMENT;
-            #else
-                pxIPHeader->usFragmentOffset = 0U;
+            #if ( ipconfigDNS_CACHE_PREFETCH_SECONDS != 0 )
+                BaseType_t xPrefetch = pdFALSE;
             #endif
-            usPacketIdentifier++;
-            pxUDPHeader->usLength = FreeRTOS_htons( ( uint32_t ) lNetLength + ipSIZE_OF_UDP_HEADER );
-            vFlip_16( pxUDPHeader->usSourcePort, pxUDPHeader->usDestinationPort );
 
-            /* Important: tell NIC driver how many bytes must be sent */
-            uxDataLength = ( ( size_t ) lNetLength ) + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER + ipSIZE_OF_ETH_HEADER;
+            configASSERT( ( pcName != NULL ) );
 
-            #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+            ulHash = prvDNSCacheHash( pcName, &( uxLength ) );
+
+            /* The cache is updated by the IP-task and consulted by the user tasks. */
+            vTaskSuspendAll();
+            {
+                xEntry = prvDNSCacheFind( pcName, ulHash, uxLength );
+
+                if( xLookUp != pdFALSE )
                 {
-                    /* Calculate the IP header checksum. */
-                    pxIPHeader->usHeaderChecksum = 0U;
-                    pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
-                    pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+                    *pulIP = 0U;
 
-                    /* calculate the UDP checksum for outgoing package */
-                    ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxUDPPacket, uxDataLength, pdTRUE );
+                    if( xEntry >= 0 )
+                    {
+                        pxRow = &( xDNSCache[ xEntry ] );
+
+                        /* Confirm that the record is still fresh. */
+                        if( ulCurrentTimeSeconds < ( pxRow->ulTimeWhenAddedInSeconds + FreeRTOS_ntohl( pxRow->ulTTL ) ) )
+                        {
+                            xFound = pdTRUE;
+
+                            if( ( pxRow->ucFlags & dnsCACHE_FLAG_NEGATIVE ) == 0U )
+                            {
+                                #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+                                    if( pxRow->ucNumIPAddresses != 0U )
+                                    {
+                                        ulIPAddressIndex = ( uint32_t ) ( pxRow->ucCurrentIPAddress % pxRow->ucNumIPAddresses );
+                                        pxRow->ucCurrentIPAddress++;
+                                    }
+                                #endif
+
+                                *pulIP = pxRow->ulIPAddresses[ ulIPAddressIndex ];
+
+                                if( pxRow->usHits < 0xffffU )
+                                {
+                                    pxRow->usHits++;
+                                }
+
+                                prvDNSCacheLRURemove( xEntry );
+                                prvDNSCacheLRUInsert( xEntry );
+
+                                #if ( ipconfigDNS_CACHE_PREFETCH_SECONDS != 0 )
+                                    if( ( ( pxRow->ucFlags & dnsCACHE_FLAG_PREFETCH ) == 0U ) &&
+                                        ( pxRow->usHits >= dnsCACHE_PREFETCH_MIN_HITS ) &&
+                                        ( ( ( pxRow->ulTimeWhenAddedInSeconds + FreeRTOS_ntohl( pxRow->ulTTL ) ) - ulCurrentTimeSeconds ) <= ( uint32_t ) ipconfigDNS_CACHE_PREFETCH_SECONDS ) )
+                                    {
+                                        /* A name that is used often is about to expire. */
+                                        pxRow->ucFlags |= dnsCACHE_FLAG_PREFETCH;
+                                        xPrefetch = pdTRUE;
+                                    }
+                                #endif /* ipconfigDNS_CACHE_PREFETCH_SECONDS */
+                            }
+                        }
+                        else
+                        {
+                            /* Age out the old cached record. */
+                            prvDNSCacheRemove( xEntry );
+                        }
+                    }
                 }
-            #endif
+                else
+                {
+                    if( xEntry >= 0 )
+                    {
+                        xFound = pdTRUE;
+                    }
+                    else if( uxLength < ( size_t ) ipconfigDNS_CACHE_NAME_LENGTH )
+                    {
+                        xEntry = prvDNSCacheAllocate( pcName, ulHash, uxLength );
+                    }
+                    else
+                    {
+                        /* The name is too long to be cached. */
+                    }
 
-            /* Important: tell NIC driver how many bytes must be sent */
-            pxNetworkBuffer->xDataLength = uxDataLength;
+                    if( xEntry >= 0 )
+                    {
+                        pxRow = &( xDNSCache[ xEntry ] );
 
-            /* This function will fill in the eth addresses and send the packet */
-            vReturnEthernetFrame( pxNetworkBuffer, pdFALSE );
-        }
+                        if( *pulIP == 0U )
+                        {
+                            /* A negative answer replaces the addresses. */
+                            pxRow->ucFlags |= dnsCACHE_FLAG_NEGATIVE;
+                            #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+                                pxRow->ucNumIPAddresses = 0U;
+                            #endif
+                        }
+                        else
+                        {
+                            if( ( pxRow->ucFlags & dnsCACHE_FLAG_NEGATIVE ) != 0U )
+                            {
+                                pxRow->ucFlags &= ( uint8_t ) ~dnsCACHE_FLAG_NEGATIVE;
+                                #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+                                    pxRow->ucNumIPAddresses = 0U;
+                                #endif
+                            }
 
-    #endif /* ipconfigUSE_NBNS == 1 || ipconfigUSE_LLMNR == 1 */
+                            #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+                                {
+                                    /* An address that is already known is not stored twice. */
+                                    while( ulIPAddressIndex < ( uint32_t ) pxRow->ucNumIPAddresses )
+                                    {
+                                        if( pxRow->ulIPAddresses[ ulIPAddressIndex ] == *pulIP )
+                                        {
+                                            break;
+                                        }
 
-/*-----------------------------------------------------------*/
+                                        ulIPAddressIndex++;
+                                    }
 
-    #if ( ipconfigUSE_DNS_CACHE == 1 )
+                                    if( ulIPAddressIndex == ( uint32_t ) pxRow->ucNumIPAddresses )
+                                    {
+                                        if( pxRow->ucNumIPAddresses < ( uint8_t ) ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY )
+                                        {
+                                            pxRow->ucNumIPAddresses++;
+                                        }
+                                        else
+                                        {
+                                            /* If more answers exist than there are IP address storage slots */
+                                            /* they will overwrite entry 0 */
+                                            ulIPAddressIndex = 0U;
+                                        }
+                                    }
+                                }
+                            #endif /* if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 ) */
+                            pxRow->ulIPAddresses[ ulIPAddressIndex ] = *pulIP;
+                        }
+
+                        pxRow->ulTTL = ulTTL;
+                        pxRow->ulTimeWhenAddedInSeconds = ulCurrentTimeSeconds;
+                        pxRow->usHits = 0U;
+                        pxRow->ucFlags &= ( uint8_t ) ~dnsCACHE_FLAG_PREFETCH;
+                        prvDNSCacheLRURemove( xEntry );
+                        prvDNSCacheLRUInsert( xEntry );
+                    }
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            #if ( ipconfigDNS_CACHE_PREFETCH_SECONDS != 0 )
+                if( xPrefetch != pdFALSE )
+                {
+                    prvDNSCachePrefetch( pcName );
+                }
+            #endif
+
+            if( ( xLookUp == 0 ) || ( *pulIP != 0U ) )
+            {
+                FreeRTOS_debug_printf( ( "prvProcessDNSCache: %s: '%s' @ %xip\n", ( xLookUp != 0 ) ? "look-up" : "add", pcName, ( unsigned ) FreeRTOS_ntohl( *pulIP ) ) );
+            }
+
+            return xFound;
+        }
+
+    #else /* if ( ipconfigUSE_DNS_CACHE_HASH != 0 ) */
 
 /**
  * @brief Send a DNS message to be used in NBNS or LLMNR
@@ -1981,6 +4532,8 @@
             return xFound;
         }
 
+    #endif /* if ( ipconfigUSE_DNS_CACHE_HASH != 0 ) */
+
     #endif /* ipconfigUSE_DNS_CACHE */
 
 #endif /* ipconfigUSE_DNS != 0 */
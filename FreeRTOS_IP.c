@@ -140,6 +140,14 @@
  * had an invalid length. */
 #define ipINVALID_LENGTH        0x1234U
 
+#if ( ipconfigIP_EVENT_CLASSES != 0 )
+    /** @brief The number of events waiting for the IP-task, in all of its queues. */
+    #define ipEVENTS_WAITING()    uxQueueMessagesWaiting( xIPEventSet )
+#else
+    /** @brief The number of events waiting for the IP-task. */
+    #define ipEVENTS_WAITING()    uxQueueMessagesWaiting( xNetworkEventQueue )
+#endif
+
 /* Trace macros to aid in debugging, disabled if ipconfigHAS_PRINTF != 1 */
 #if ( ipconfigHAS_PRINTF == 1 )
     #define DEBUG_DECLARE_TRACE_VARIABLE( type, var, init )    type var = ( init ) /**< Trace macro to set "type var = init". */
@@ -276,9 +284,89 @@ static eFrameProcessingResult_t prvAllowIPPacket( const IPPacket_t * const pxIPP
 /* Even when the driver takes care of checksum calculations,
  *  the IP-task will still check if the length fields are OK. */
     static BaseType_t xCheckSizeFields( const uint8_t * const pucEthernetBuffer,
-                                        size_t uxBufferLength );
+                                        size_t uxBufferLength,
+                                        size_t uxSegmentCount );
 #endif /* ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 1 ) */
 
+#if ( ipconfigIP_RX_WORKER_COUNT > 0 )
+
+/*
+ * Create the RX worker tasks and their queues.
+ */
+    static BaseType_t prvCreateRxWorkers( void );
+
+/*
+ * An RX worker task: it checks received packets, and passes the correct ones
+ * to the IP-task.
+ */
+    static void prvRxWorkerTask( void * pvParameters );
+
+/*
+ * Find the RX worker that handles the flow of a received packet.
+ */
+    static BaseType_t prvRxWorkerIndex( const NetworkBufferDescriptor_t * pxBuffer );
+
+/*
+ * Queue received packets for an RX worker, or for the IP-task.
+ */
+    static BaseType_t prvRxWorkerPost( BaseType_t xIndex,
+                                       const IPStackEvent_t * pxEvent,
+                                       TickType_t uxTimeout );
+
+/*
+ * Send an event to the RX workers, or to the IP-task for events other than
+ * received packets.  A chain of packets is split per flow.
+ */
+    static BaseType_t prvRxWorkerSend( const IPStackEvent_t * pxEvent,
+                                       TickType_t uxTimeout );
+
+/*
+ * Check a received packet in an RX worker task.
+ */
+    static BaseType_t prvRxWorkerCheckPacket( NetworkBufferDescriptor_t * pxBuffer );
+#endif /* ipconfigIP_RX_WORKER_COUNT */
+
+/*
+ * Put an event in the queue of the IP-task, or in the queue of its class.
+ */
+static BaseType_t prvPostIPEvent( const IPStackEvent_t * pxEvent,
+                                  TickType_t uxTimeout );
+
+#if ( ipconfigIP_EVENT_CLASSES != 0 )
+
+/*
+ * Create the queues of the event classes, and the queue set in which the
+ * IP-task waits for all of its queues.
+ */
+    static BaseType_t prvCreateIPEventQueues( void );
+
+/*
+ * Delete the queues of the event classes and the queue set.
+ */
+    static void prvDeleteIPEventQueues( void );
+
+/*
+ * Find the class of an event.
+ */
+    static BaseType_t prvIPEventClass( eIPEvent_t eEvent );
+
+/*
+ * Wait for the next event of the IP-task, and take it from one of its queues.
+ */
+    static BaseType_t prvReceiveIPEvent( IPStackEvent_t * pxEvent,
+                                         TickType_t xTicksToWait );
+
+/*
+ * Choose the class from which the next event will be taken.
+ */
+    static BaseType_t prvNextEventClass( void );
+
+/*
+ * Find the bucket of a histogram in which a value is counted.
+ */
+    static size_t prvHistogramIndex( uint32_t ulValue );
+#endif /* ipconfigIP_EVENT_CLASSES */
+
 /*
  * Returns the network buffer descriptor that owns a given packet buffer.
  */
@@ -316,6 +404,45 @@ static volatile BaseType_t xNetworkDownEventPending = pdFALSE;
 
 static TaskHandle_t xIPTaskHandle = NULL;
 
+#if ( ipconfigIP_RX_WORKER_COUNT > 0 )
+
+/** @brief The queues through which received packets are passed to the RX workers. */
+    static QueueHandle_t xRxWorkerQueues[ ipconfigIP_RX_WORKER_COUNT ];
+#endif
+
+#if ( ipconfigIP_EVENT_CLASSES != 0 )
+
+/** @brief An event as it is stored in the queue of its class, together with the
+ * time at which it was sent. */
+    typedef struct xIP_CLASS_EVENT
+    {
+        IPStackEvent_t xEvent; /**< The event. */
+        TickType_t xSendTime;  /**< The tick count at the moment the event was sent. */
+    } IPClassEvent_t;
+
+/** @brief The queues of the event classes, indexed by ipEVENT_CLASS_CONTROL,
+ * ipEVENT_CLASS_TX and ipEVENT_CLASS_RX. */
+    static QueueHandle_t xIPClassQueues[ ipEVENT_CLASS_COUNT ];
+
+/** @brief Counts the events in the queues of the event classes: it is given
+ * once for every event that is put in one of them. */
+    static SemaphoreHandle_t xIPClassEventCount = NULL;
+
+/** @brief The queue set that contains xNetworkEventQueue and xIPClassEventCount. */
+    static QueueSetHandle_t xIPEventSet = NULL;
+
+/** @brief The number of received packets that may still be handled before a
+ * waiting TX event gets its turn. */
+    static UBaseType_t uxRxEventCredit = ipconfigIP_RX_EVENT_BUDGET;
+
+/** @brief The number of TX events that may still be handled before a waiting
+ * received packet gets its turn. */
+    static UBaseType_t uxTxEventCredit = ipconfigIP_TX_EVENT_BUDGET;
+
+/** @brief The statistics of each class of events, see FreeRTOS_GetIPEventStats(). */
+    static IPEventStats_t xIPEventStats[ ipEVENT_CLASS_COUNT ];
+#endif /* ipconfigIP_EVENT_CLASSES */
+
 #if ( ipconfigUSE_TCP != 0 )
 
 /** @brief Set to a non-zero value if one or more TCP message have been processed
@@ -350,12 +477,17 @@ static IPTimer_t xARPTimer;
     /** @brief DNS timer, to check for timeouts when looking-up a domain. */
     static IPTimer_t xDNSTimer;
 #endif
+#if ( ipconfigUSE_MDNS != 0 )
+    /** @brief mDNS timer, to repeat the unsolicited responses. */
+    static IPTimer_t xMDNSTimer;
+#endif
 
 /** @brief Set to pdTRUE when the IP task is ready to start processing packets. */
 static BaseType_t xIPTaskInitialised = pdFALSE;
 
 #if ( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
-    /** @brief Keep track of the lowest amount of space in 'xNetworkEventQueue'. */
+    /** @brief Keep track of the lowest amount of space in 'xNetworkEventQueue', or
+     * when ipconfigIP_EVENT_CLASSES is enabled, in any of the queues of the IP-task. */
     static UBaseType_t uxQueueMinimumSpace = ipconfigEVENT_QUEUE_LENGTH;
 #endif
 
@@ -421,7 +553,11 @@ static void prvIPTask( void * pvParameters )
         /* Wait until there is something to do. If the following call exits
          * due to a time out rather than a message being received, set a
          * 'NoEvent' value. */
-        if( xQueueReceive( xNetworkEventQueue, ( void * ) &xReceivedEvent, xNextIPSleep ) == pdFALSE )
+        #if ( ipconfigIP_EVENT_CLASSES != 0 )
+            if( prvReceiveIPEvent( &xReceivedEvent, xNextIPSleep ) == pdFALSE )
+        #else
+            if( xQueueReceive( xNetworkEventQueue, ( void * ) &xReceivedEvent, xNextIPSleep ) == pdFALSE )
+        #endif
         {
             xReceivedEvent.eEventType = eNoEvent;
         }
@@ -434,6 +570,24 @@ static void prvIPTask( void * pvParameters )
 
                     uxCount = uxQueueSpacesAvailable( xNetworkEventQueue );
 
+                    #if ( ipconfigIP_EVENT_CLASSES != 0 )
+                        {
+                            BaseType_t xClass;
+                            UBaseType_t uxClassCount;
+
+                            /* Events are normally sent to the queue of their class. */
+                            for( xClass = 0; xClass < ( BaseType_t ) ipEVENT_CLASS_COUNT; xClass++ )
+                            {
+                                uxClassCount = uxQueueSpacesAvailable( xIPClassQueues[ xClass ] );
+
+                                if( uxCount > uxClassCount )
+                                {
+                                    uxCount = uxClassCount;
+                                }
+                            }
+                        }
+                    #endif
+
                     if( uxQueueMinimumSpace > uxCount )
                     {
                         uxQueueMinimumSpace = uxCount;
@@ -607,6 +761,23 @@ static void prvIPTask( void * pvParameters )
                 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
                 break;
 
+            case eDNSResolverEvent:
+                #if ( ipconfigDNS_USE_RESOLVER != 0 )
+                    vDNSResolverProcess();
+                #endif /* ipconfigDNS_USE_RESOLVER */
+                break;
+
+            case eMDNSAnnounceEvent:
+                #if ( ipconfigUSE_MDNS != 0 )
+                    vMDNSStartAnnouncing();
+                #endif /* ipconfigUSE_MDNS */
+                break;
+
+            case eARPClearEvent:
+                /* FreeRTOS_ClearARP() was called by another task. */
+                vARPClearCache();
+                break;
+
             case eNoEvent:
                 /* xQueueReceive() returned because of a normal time-out. */
                 break;
@@ -651,64 +822,870 @@ BaseType_t xIsCallingFromIPTask( void )
         xReturn = pdFALSE;
     }
 
-    return xReturn;
-}
-/*-----------------------------------------------------------*/
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The variable 'xIPTaskHandle' is declared static.  This function
+ *        gives read-only access to it.
+ *
+ * @return The handle of the IP-task.
+ */
+TaskHandle_t FreeRTOS_GetIPTaskHandle( void )
+{
+    return xIPTaskHandle;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle the incoming Ethernet packets.
+ *
+ * @param[in] pxBuffer: Linked/un-linked network buffer descriptor(s)
+ *                      to be processed.
+ */
+static void prvHandleEthernetPacket( NetworkBufferDescriptor_t * pxBuffer )
+{
+    #if ( ipconfigUSE_LINKED_RX_MESSAGES == 0 )
+        {
+            /* When ipconfigUSE_LINKED_RX_MESSAGES is not set to 0 then only one
+             * buffer will be sent at a time.  This is the default way for +TCP to pass
+             * messages from the MAC to the TCP/IP stack. */
+            prvProcessEthernetPacket( pxBuffer );
+        }
+    #else /* ipconfigUSE_LINKED_RX_MESSAGES */
+        {
+            NetworkBufferDescriptor_t * pxNextBuffer;
+
+            #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_RX_COALESCING != 0 )
+                {
+                    /* Merge in-order TCP segments of the same connection, so that
+                     * they will be handled as a single segment. */
+                    pxBuffer = pxTCPCoalesceReceivedPackets( pxBuffer );
+                }
+            #endif
+
+            /* An optimisation that is useful when there is high network traffic.
+             * Instead of passing received packets into the IP task one at a time the
+             * network interface can chain received packets together and pass them into
+             * the IP task in one go.  The packets are chained using the pxNextBuffer
+             * member.  The loop below walks through the chain processing each packet
+             * in the chain in turn. */
+            do
+            {
+                /* Store a pointer to the buffer after pxBuffer for use later on. */
+                pxNextBuffer = pxBuffer->pxNextBuffer;
+
+                /* Make it NULL to avoid using it later on. */
+                pxBuffer->pxNextBuffer = NULL;
+
+                prvProcessEthernetPacket( pxBuffer );
+                pxBuffer = pxNextBuffer;
+
+                /* While there is another packet in the chain. */
+            } while( pxBuffer != NULL );
+        }
+    #endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigIP_RX_WORKER_COUNT > 0 )
+
+/**
+ * @brief Create the RX worker tasks and their queues.  The queues have the
+ *        same length as the queue of the IP-task.
+ *
+ * @return pdPASS if all workers were created, otherwise pdFAIL.
+ */
+    static BaseType_t prvCreateRxWorkers( void )
+    {
+        BaseType_t xIndex;
+        BaseType_t xReturn = pdPASS;
+
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            static StaticQueue_t xRxWorkerStaticQueues[ ipconfigIP_RX_WORKER_COUNT ];
+            static uint8_t ucRxWorkerQueueStorageAreas[ ipconfigIP_RX_WORKER_COUNT ][ ipconfigEVENT_QUEUE_LENGTH * sizeof( IPStackEvent_t ) ];
+            static StaticTask_t xRxWorkerTaskBuffers[ ipconfigIP_RX_WORKER_COUNT ];
+            static StackType_t xRxWorkerTaskStacks[ ipconfigIP_RX_WORKER_COUNT ][ ipconfigIP_TASK_STACK_SIZE_WORDS ];
+        #endif
+
+        for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigIP_RX_WORKER_COUNT; xIndex++ )
+        {
+            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                {
+                    xRxWorkerQueues[ xIndex ] = xQueueCreateStatic( ipconfigEVENT_QUEUE_LENGTH,
+                                                                    sizeof( IPStackEvent_t ),
+                                                                    ucRxWorkerQueueStorageAreas[ xIndex ],
+                                                                    &( xRxWorkerStaticQueues[ xIndex ] ) );
+
+                    if( xTaskCreateStatic( prvRxWorkerTask,
+                                           "IP-RX",
+                                           ipconfigIP_TASK_STACK_SIZE_WORDS,
+                                           ( void * ) xRxWorkerQueues[ xIndex ],
+                                           ipconfigIP_TASK_PRIORITY,
+                                           xRxWorkerTaskStacks[ xIndex ],
+                                           &( xRxWorkerTaskBuffers[ xIndex ] ) ) == NULL )
+                    {
+                        xReturn = pdFAIL;
+                    }
+                }
+            #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+                {
+                    xRxWorkerQueues[ xIndex ] = xQueueCreate( ipconfigEVENT_QUEUE_LENGTH, sizeof( IPStackEvent_t ) );
+
+                    if( xRxWorkerQueues[ xIndex ] == NULL )
+                    {
+                        xReturn = pdFAIL;
+                    }
+                    else if( xTaskCreate( prvRxWorkerTask,
+                                          "IP-RX",
+                                          ipconfigIP_TASK_STACK_SIZE_WORDS,
+                                          ( void * ) xRxWorkerQueues[ xIndex ],
+                                          ipconfigIP_TASK_PRIORITY,
+                                          NULL ) != pdPASS )
+                    {
+                        xReturn = pdFAIL;
+                    }
+                    else
+                    {
+                        /* The worker is running. */
+                    }
+                }
+            #endif /* configSUPPORT_STATIC_ALLOCATION */
+
+            if( xReturn != pdPASS )
+            {
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief An RX worker task.  It checks the packets that were steered to it, and
+ *        passes the correct ones to the IP-task, in the order of arrival.
+ *
+ * @param[in] pvParameters: The queue of this worker.
+ */
+    static void prvRxWorkerTask( void * pvParameters )
+    {
+        QueueHandle_t xQueue = ( QueueHandle_t ) pvParameters;
+        IPStackEvent_t xEvent;
+        NetworkBufferDescriptor_t * pxBuffer;
+        NetworkBufferDescriptor_t * pxFirst;
+        NetworkBufferDescriptor_t * pxNext;
+
+        #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+            NetworkBufferDescriptor_t * pxLast;
+        #endif
+
+        for( ; ; )
+        {
+            if( xQueueReceive( xQueue, ( void * ) &xEvent, portMAX_DELAY ) == pdTRUE )
+            {
+                pxBuffer = ipCAST_PTR_TO_TYPE_PTR( NetworkBufferDescriptor_t, xEvent.pvData );
+                pxFirst = NULL;
+
+                #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                    {
+                        pxLast = NULL;
+                    }
+                #endif
+
+                /* Walk through the packets, which might be a chain, and release
+                 * the ones that are not correct. */
+                while( pxBuffer != NULL )
+                {
+                    #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                        {
+                            pxNext = pxBuffer->pxNextBuffer;
+                            pxBuffer->pxNextBuffer = NULL;
+                        }
+                    #else
+                        {
+                            pxNext = NULL;
+                        }
+                    #endif
+
+                    if( prvRxWorkerCheckPacket( pxBuffer ) == pdPASS )
+                    {
+                        #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                            {
+                                if( pxLast != NULL )
+                                {
+                                    pxLast->pxNextBuffer = pxBuffer;
+                                }
+                                else
+                                {
+                                    pxFirst = pxBuffer;
+                                }
+
+                                pxLast = pxBuffer;
+                            }
+                        #else
+                            {
+                                pxFirst = pxBuffer;
+                            }
+                        #endif
+                    }
+                    else
+                    {
+                        vReleaseNetworkBufferAndDescriptor( pxBuffer );
+                    }
+
+                    pxBuffer = pxNext;
+                }
+
+                if( pxFirst != NULL )
+                {
+                    xEvent.pvData = ( void * ) pxFirst;
+
+                    /* The IP-task never waits for a worker, so it will make
+                     * space in its queue. */
+                    if( prvPostIPEvent( &xEvent, portMAX_DELAY ) != pdPASS )
+                    {
+                        iptraceETHERNET_RX_EVENT_LOST();
+
+                        while( pxFirst != NULL )
+                        {
+                            pxBuffer = pxFirst;
+
+                            #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                                {
+                                    pxFirst = pxBuffer->pxNextBuffer;
+                                }
+                            #else
+                                {
+                                    pxFirst = NULL;
+                                }
+                            #endif
+
+                            vReleaseNetworkBufferAndDescriptor( pxBuffer );
+                        }
+                    }
+                }
+            }
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the RX worker that checks a received packet.  An IPv4 packet is
+ *        steered by a hash of its source address and, for TCP and UDP, its
+ *        ports.  All packets of one flow go to the same worker, so they reach
+ *        the IP-task in order.  Other packets, e.g. ARP, go to the IP-task
+ *        directly.
+ *
+ * @param[in] pxBuffer: The network buffer that holds the packet.
+ *
+ * @return The index of an RX worker, or ipconfigIP_RX_WORKER_COUNT when the
+ *         packet goes to the IP-task.
+ */
+    static BaseType_t prvRxWorkerIndex( const NetworkBufferDescriptor_t * pxBuffer )
+    {
+        BaseType_t xIndex = ( BaseType_t ) ipconfigIP_RX_WORKER_COUNT;
+        const IPPacket_t * pxIPPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( IPPacket_t, pxBuffer->pucEthernetBuffer );
+        const uint8_t * pucPorts;
+        size_t uxHeaderLength;
+        uint32_t ulHash;
+
+        if( ( pxBuffer->xDataLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ) ) &&
+            ( pxIPPacket->xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE ) )
+        {
+            ulHash = pxIPPacket->xIPHeader.ulSourceIPAddress;
+            uxHeaderLength = ( ( size_t ) pxIPPacket->xIPHeader.ucVersionHeaderLength & 0x0FU ) << 2;
+
+            if( ( ( pxIPPacket->xIPHeader.ucProtocol == ( uint8_t ) ipPROTOCOL_TCP ) ||
+                  ( pxIPPacket->xIPHeader.ucProtocol == ( uint8_t ) ipPROTOCOL_UDP ) ) &&
+                ( pxBuffer->xDataLength >= ( ipSIZE_OF_ETH_HEADER + uxHeaderLength + sizeof( uint32_t ) ) ) )
+            {
+                /* Both TCP and UDP headers start with the two port numbers. */
+                pucPorts = &( pxBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxHeaderLength ] );
+                ulHash ^= ( ( ( uint32_t ) pucPorts[ 0 ] ) << 24 ) |
+                          ( ( ( uint32_t ) pucPorts[ 1 ] ) << 16 ) |
+                          ( ( ( uint32_t ) pucPorts[ 2 ] ) << 8 ) |
+                          ( ( uint32_t ) pucPorts[ 3 ] );
+            }
+
+            /* Mix the bits, so that all workers get a share of the flows. */
+            ulHash ^= ulHash >> 16;
+            ulHash *= 0x45D9F3BU;
+            ulHash ^= ulHash >> 16;
+
+            xIndex = ( BaseType_t ) ( ulHash % ( uint32_t ) ipconfigIP_RX_WORKER_COUNT );
+        }
+
+        return xIndex;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Queue a received packet, or a chain of them, for the RX worker with
+ *        the given index, or for the IP-task.
+ *
+ * @param[in] xIndex: The index returned by prvRxWorkerIndex().
+ * @param[in] pxEvent: The eNetworkRxEvent to be sent.
+ * @param[in] uxTimeout: The maximum time to wait for space in the queue.
+ *
+ * @return pdPASS when the event was queued, otherwise pdFAIL.
+ */
+    static BaseType_t prvRxWorkerPost( BaseType_t xIndex,
+                                       const IPStackEvent_t * pxEvent,
+                                       TickType_t uxTimeout )
+    {
+        BaseType_t xReturn;
+
+        if( xIndex < ( BaseType_t ) ipconfigIP_RX_WORKER_COUNT )
+        {
+            xReturn = xQueueSendToBack( xRxWorkerQueues[ xIndex ], pxEvent, uxTimeout );
+        }
+        else
+        {
+            xReturn = prvPostIPEvent( pxEvent, uxTimeout );
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Send an event: received packets go to the RX worker of their flow, all
+ *        other events go to the IP-task.  When ipconfigUSE_LINKED_RX_MESSAGES
+ *        is enabled, the packets of one chain may belong to several flows.  The
+ *        chain is then split into one part per worker, keeping the order of
+ *        the packets within each part.
+ *
+ * @param[in] pxEvent: The event to be sent.
+ * @param[in] uxTimeout: The maximum time to wait for space in a queue.
+ *
+ * @return pdFAIL when the event could not be sent, and the caller still owns
+ *         the packets.  Once a chain has been split, its parts belong to the
+ *         stack: a part that can not be queued is released here, and pdPASS is
+ *         returned.
+ */
+    static BaseType_t prvRxWorkerSend( const IPStackEvent_t * pxEvent,
+                                       TickType_t uxTimeout )
+    {
+        BaseType_t xReturn;
+        NetworkBufferDescriptor_t * pxBuffer;
+
+        if( pxEvent->eEventType != eNetworkRxEvent )
+        {
+            xReturn = prvPostIPEvent( pxEvent, uxTimeout );
+        }
+        else
+        {
+            pxBuffer = ipCAST_PTR_TO_TYPE_PTR( NetworkBufferDescriptor_t, pxEvent->pvData );
+
+            #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                {
+                    /* The first and last packet of each part.  The last part
+                     * is for the IP-task. */
+                    NetworkBufferDescriptor_t * pxFirst[ ipconfigIP_RX_WORKER_COUNT + 1 ];
+                    NetworkBufferDescriptor_t * pxLast[ ipconfigIP_RX_WORKER_COUNT + 1 ];
+                    NetworkBufferDescriptor_t * pxNext;
+                    IPStackEvent_t xPart;
+                    BaseType_t xIndex;
+                    BaseType_t xLastIndex = 0;
+                    BaseType_t xParts = 0;
+
+                    ( void ) memset( pxFirst, 0, sizeof( pxFirst ) );
+                    ( void ) memset( pxLast, 0, sizeof( pxLast ) );
+
+                    while( pxBuffer != NULL )
+                    {
+                        pxNext = pxBuffer->pxNextBuffer;
+                        pxBuffer->pxNextBuffer = NULL;
+                        xIndex = prvRxWorkerIndex( pxBuffer );
+
+                        if( pxFirst[ xIndex ] == NULL )
+                        {
+                            pxFirst[ xIndex ] = pxBuffer;
+                            xParts++;
+                        }
+                        else
+                        {
+                            pxLast[ xIndex ]->pxNextBuffer = pxBuffer;
+                        }
+
+                        pxLast[ xIndex ] = pxBuffer;
+                        xLastIndex = xIndex;
+                        pxBuffer = pxNext;
+                    }
+
+                    xPart.eEventType = eNetworkRxEvent;
+
+                    if( xParts <= 1 )
+                    {
+                        /* All packets belong to one worker.  The chain was
+                         * rebuilt in its original order, and the caller will
+                         * release it when it can not be sent. */
+                        xPart.pvData = pxEvent->pvData;
+                        xReturn = prvRxWorkerPost( xLastIndex, &xPart, uxTimeout );
+                    }
+                    else
+                    {
+                        xReturn = pdPASS;
+
+                        for( xIndex = 0; xIndex <= ( BaseType_t ) ipconfigIP_RX_WORKER_COUNT; xIndex++ )
+                        {
+                            if( pxFirst[ xIndex ] != NULL )
+                            {
+                                xPart.pvData = ( void * ) pxFirst[ xIndex ];
+
+                                if( prvRxWorkerPost( xIndex, &xPart, uxTimeout ) != pdPASS )
+                                {
+                                    iptraceETHERNET_RX_EVENT_LOST();
+
+                                    while( pxFirst[ xIndex ] != NULL )
+                                    {
+                                        pxBuffer = pxFirst[ xIndex ];
+                                        pxFirst[ xIndex ] = pxBuffer->pxNextBuffer;
+                                        vReleaseNetworkBufferAndDescriptor( pxBuffer );
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            #else /* if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) */
+                {
+                    xReturn = prvRxWorkerPost( prvRxWorkerIndex( pxBuffer ), pxEvent, uxTimeout );
+                }
+            #endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Do the checks of a received packet that do not depend on the state of
+ *        the stack: the checksums of an IPv4 packet, or when the driver has
+ *        checked those, the length fields.  prvAllowIPPacket() leaves these
+ *        checks to the RX workers.
+ *
+ * @param[in] pxBuffer: The network buffer that holds the packet.
+ *
+ * @return pdFAIL when the packet must be dropped, otherwise pdPASS.
+ */
+    static BaseType_t prvRxWorkerCheckPacket( NetworkBufferDescriptor_t * pxBuffer )
+    {
+        const IPPacket_t * pxIPPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( IPPacket_t, pxBuffer->pucEthernetBuffer );
+        size_t uxHeaderLength;
+        BaseType_t xReturn = pdPASS;
+
+        /* Packets other than IPv4 are left to the IP-task. */
+        if( ( pxBuffer->xDataLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ) ) &&
+            ( pxIPPacket->xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE ) )
+        {
+            uxHeaderLength = ( ( size_t ) pxIPPacket->xIPHeader.ucVersionHeaderLength & 0x0FU ) << 2;
+
+            if( ( uxHeaderLength < ipSIZE_OF_IPv4_HEADER ) ||
+                ( uxHeaderLength > ( pxBuffer->xDataLength - ipSIZE_OF_ETH_HEADER ) ) )
+            {
+                /* The IP-task would drop this packet as well. */
+                xReturn = pdFAIL;
+            }
+
+            #if ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 )
+                else if( usGenerateChecksum( 0U, &( pxIPPacket->xIPHeader.ucVersionHeaderLength ), uxHeaderLength ) != ipCORRECT_CRC )
+                {
+                    /* Check sum in IP-header not correct. */
+                    xReturn = pdFAIL;
+                }
+                else if( usGenerateProtocolChecksum( pxBuffer->pucEthernetBuffer, pxBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
+                {
+                    /* Protocol checksum not accepted. */
+                    xReturn = pdFAIL;
+                }
+            #else
+                else if( xCheckSizeFields( pxBuffer->pucEthernetBuffer, pxBuffer->xDataLength, 1U ) != pdPASS )
+                {
+                    /* Some of the length checks were not successful. */
+                    xReturn = pdFAIL;
+                }
+            #endif /* ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM */
+            else
+            {
+                /* The packet may be passed to the IP-task. */
+            }
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigIP_RX_WORKER_COUNT */
+
+/**
+ * @brief Put an event in the queue of the IP-task.  When ipconfigIP_EVENT_CLASSES
+ *        is enabled, the event is stamped with the current time and put in the
+ *        queue of its class.
+ *
+ * @param[in] pxEvent: The event to be sent.
+ * @param[in] uxTimeout: Timeout for waiting in case the queue is full.
+ *
+ * @return pdPASS if the event was put in a queue, otherwise pdFAIL.
+ */
+static BaseType_t prvPostIPEvent( const IPStackEvent_t * pxEvent,
+                                  TickType_t uxTimeout )
+{
+    BaseType_t xReturn;
+
+    #if ( ipconfigIP_EVENT_CLASSES != 0 )
+        {
+            IPClassEvent_t xClassEvent;
+
+            xClassEvent.xEvent = *pxEvent;
+            xClassEvent.xSendTime = xTaskGetTickCount();
+
+            xReturn = xQueueSendToBack( xIPClassQueues[ prvIPEventClass( pxEvent->eEventType ) ], &xClassEvent, uxTimeout );
+
+            if( xReturn == pdPASS )
+            {
+                /* Can not fail: the count has room for all events of all classes. */
+                ( void ) xSemaphoreGive( xIPClassEventCount );
+            }
+        }
+    #else
+        {
+            xReturn = xQueueSendToBack( xNetworkEventQueue, pxEvent, uxTimeout );
+        }
+    #endif
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigIP_EVENT_CLASSES != 0 )
+
+/**
+ * @brief Create the queues of the event classes, the semaphore that counts
+ *        their events, and the queue set through which the IP-task waits for
+ *        that semaphore and for xNetworkEventQueue.  The queue set is always
+ *        allocated from the heap.
+ *
+ * @return pdPASS if all queues were created, otherwise pdFAIL.
+ */
+    static BaseType_t prvCreateIPEventQueues( void )
+    {
+        BaseType_t xIndex;
+        BaseType_t xReturn = pdPASS;
+
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            static StaticQueue_t xIPClassStaticQueues[ ipEVENT_CLASS_COUNT ];
+            static uint8_t ucIPClassQueueStorageAreas[ ipEVENT_CLASS_COUNT ][ ipconfigEVENT_QUEUE_LENGTH * sizeof( IPClassEvent_t ) ];
+            static StaticSemaphore_t xIPClassEventCountBuffer;
+        #endif
+
+        /* The count must have room for all events of all classes. */
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            {
+                xIPClassEventCount = xSemaphoreCreateCountingStatic( ( UBaseType_t ) ipEVENT_CLASS_COUNT * ( UBaseType_t ) ipconfigEVENT_QUEUE_LENGTH,
+                                                                     0U,
+                                                                     &( xIPClassEventCountBuffer ) );
+            }
+        #else
+            {
+                xIPClassEventCount = xSemaphoreCreateCounting( ( UBaseType_t ) ipEVENT_CLASS_COUNT * ( UBaseType_t ) ipconfigEVENT_QUEUE_LENGTH, 0U );
+            }
+        #endif
+
+        /* The set must have space for all events of its members. */
+        xIPEventSet = xQueueCreateSet( ( UBaseType_t ) ( ipEVENT_CLASS_COUNT + 1 ) * ( UBaseType_t ) ipconfigEVENT_QUEUE_LENGTH );
+
+        if( ( xIPClassEventCount == NULL ) ||
+            ( xIPEventSet == NULL ) ||
+            ( xQueueAddToSet( xNetworkEventQueue, xIPEventSet ) != pdPASS ) ||
+            ( xQueueAddToSet( xIPClassEventCount, xIPEventSet ) != pdPASS ) )
+        {
+            xReturn = pdFAIL;
+        }
+
+        for( xIndex = 0; ( xIndex < ( BaseType_t ) ipEVENT_CLASS_COUNT ) && ( xReturn == pdPASS ); xIndex++ )
+        {
+            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                {
+                    xIPClassQueues[ xIndex ] = xQueueCreateStatic( ipconfigEVENT_QUEUE_LENGTH,
+                                                                   sizeof( IPClassEvent_t ),
+                                                                   ucIPClassQueueStorageAreas[ xIndex ],
+                                                                   &( xIPClassStaticQueues[ xIndex ] ) );
+                }
+            #else
+                {
+                    xIPClassQueues[ xIndex ] = xQueueCreate( ipconfigEVENT_QUEUE_LENGTH, sizeof( IPClassEvent_t ) );
+                }
+            #endif
+
+            if( xIPClassQueues[ xIndex ] == NULL )
+            {
+                xReturn = pdFAIL;
+            }
+        }
+
+        if( xReturn != pdPASS )
+        {
+            prvDeleteIPEventQueues();
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Delete the queues of the event classes, their semaphore and the queue
+ *        set, after FreeRTOS_IPInit() failed.  xNetworkEventQueue is removed
+ *        from the set, the caller deletes it.  All members are still empty, so
+ *        they can be removed from the set.
+ */
+    static void prvDeleteIPEventQueues( void )
+    {
+        BaseType_t xIndex;
+
+        for( xIndex = 0; xIndex < ( BaseType_t ) ipEVENT_CLASS_COUNT; xIndex++ )
+        {
+            if( xIPClassQueues[ xIndex ] != NULL )
+            {
+                vQueueDelete( xIPClassQueues[ xIndex ] );
+                xIPClassQueues[ xIndex ] = NULL;
+            }
+        }
+
+        if( xIPEventSet != NULL )
+        {
+            /* Fails harmlessly for a member that was not added to the set. */
+            ( void ) xQueueRemoveFromSet( xNetworkEventQueue, xIPEventSet );
+
+            if( xIPClassEventCount != NULL )
+            {
+                ( void ) xQueueRemoveFromSet( xIPClassEventCount, xIPEventSet );
+            }
+
+            vQueueDelete( xIPEventSet );
+            xIPEventSet = NULL;
+        }
+
+        if( xIPClassEventCount != NULL )
+        {
+            vSemaphoreDelete( xIPClassEventCount );
+            xIPClassEventCount = NULL;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the class of an event: received packets, packets to be sent, or
+ *        any other event.
+ *
+ * @param[in] eEvent: The type of the event.
+ *
+ * @return ipEVENT_CLASS_RX, ipEVENT_CLASS_TX or ipEVENT_CLASS_CONTROL.
+ */
+    static BaseType_t prvIPEventClass( eIPEvent_t eEvent )
+    {
+        BaseType_t xClass;
+
+        switch( eEvent )
+        {
+            case eNetworkRxEvent:
+                xClass = ipEVENT_CLASS_RX;
+                break;
+
+            case eNetworkTxEvent:
+            case eStackTxEvent:
+                xClass = ipEVENT_CLASS_TX;
+                break;
+
+            default:
+                xClass = ipEVENT_CLASS_CONTROL;
+                break;
+        }
+
+        return xClass;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Choose the class from which the IP-task takes its next event.  Control
+ *        events always go first.  When both received packets and TX events are
+ *        waiting, up to ipconfigIP_RX_EVENT_BUDGET received packets are handled,
+ *        followed by up to ipconfigIP_TX_EVENT_BUDGET TX events.  A class that
+ *        has no competition does not use its budget.
+ *
+ * @return The class of the next event.
+ */
+    static BaseType_t prvNextEventClass( void )
+    {
+        BaseType_t xClass;
+        BaseType_t xRxWaiting = ( uxQueueMessagesWaiting( xIPClassQueues[ ipEVENT_CLASS_RX ] ) != 0U ) ? pdTRUE : pdFALSE;
+        BaseType_t xTxWaiting = ( uxQueueMessagesWaiting( xIPClassQueues[ ipEVENT_CLASS_TX ] ) != 0U ) ? pdTRUE : pdFALSE;
+
+        if( uxQueueMessagesWaiting( xIPClassQueues[ ipEVENT_CLASS_CONTROL ] ) != 0U )
+        {
+            xClass = ipEVENT_CLASS_CONTROL;
+        }
+        else if( ( xRxWaiting != pdFALSE ) && ( xTxWaiting != pdFALSE ) )
+        {
+            if( ( uxRxEventCredit == 0U ) && ( uxTxEventCredit == 0U ) )
+            {
+                uxRxEventCredit = ipconfigIP_RX_EVENT_BUDGET;
+                uxTxEventCredit = ipconfigIP_TX_EVENT_BUDGET;
+            }
+
+            if( uxRxEventCredit != 0U )
+            {
+                uxRxEventCredit--;
+                xClass = ipEVENT_CLASS_RX;
+            }
+            else
+            {
+                uxTxEventCredit--;
+                xClass = ipEVENT_CLASS_TX;
+            }
+        }
+        else if( xRxWaiting != pdFALSE )
+        {
+            xClass = ipEVENT_CLASS_RX;
+        }
+        else
+        {
+            xClass = ipEVENT_CLASS_TX;
+        }
+
+        return xClass;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the bucket of a histogram in which a value is counted: bucket 0
+ *        for 0, and bucket n for the values 2^(n-1) up to 2^n - 1.  Larger values
+ *        are counted in the last bucket.
+ *
+ * @param[in] ulValue: The value to be counted.
+ *
+ * @return The index of the bucket.
+ */
+    static size_t prvHistogramIndex( uint32_t ulValue )
+    {
+        size_t uxIndex = 0U;
+        uint32_t ulRemaining = ulValue;
+
+        while( ( ulRemaining != 0U ) && ( uxIndex < ( ( size_t ) ipEVENT_HISTOGRAM_SIZE - 1U ) ) )
+        {
+            ulRemaining >>= 1;
+            uxIndex++;
+        }
+
+        return uxIndex;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Wait for the next event of the IP-task.  The queue set holds one entry
+ *        for every event, and the member that it selects is always read from:
+ *        either xNetworkEventQueue, for events that were sent to it directly,
+ *        for instance from an ISR, or xIPClassEventCount.  When the count was
+ *        selected, it is taken, and one event is taken from the class chosen by
+ *        prvNextEventClass().
+ *
+ * @param[out] pxEvent: The event that was taken.
+ * @param[in] xTicksToWait: The maximum time to wait for an event.
+ *
+ * @return pdTRUE if an event was taken, pdFALSE when the time expired.
+ */
+    static BaseType_t prvReceiveIPEvent( IPStackEvent_t * pxEvent,
+                                         TickType_t xTicksToWait )
+    {
+        IPClassEvent_t xClassEvent;
+        QueueSetMemberHandle_t xMember;
+        QueueHandle_t xQueue = NULL;
+        BaseType_t xClass = ipEVENT_CLASS_CONTROL;
+        BaseType_t xReturn = pdFALSE;
+        BaseType_t xHasLatency = pdFALSE;
+        uint32_t ulLatency = 0U;
+        UBaseType_t uxDepth;
+
+        xMember = xQueueSelectFromSet( xIPEventSet, xTicksToWait );
+
+        if( xMember != NULL )
+        {
+            if( xMember == ( QueueSetMemberHandle_t ) xNetworkEventQueue )
+            {
+                if( xQueueReceive( xNetworkEventQueue, ( void * ) pxEvent, 0U ) == pdPASS )
+                {
+                    /* These events were not stamped with a time. */
+                    xQueue = xNetworkEventQueue;
+                    xReturn = pdTRUE;
+                }
+            }
+            else if( xSemaphoreTake( xIPClassEventCount, 0U ) == pdPASS )
+            {
+                /* The event was put in its queue before the count was given. */
+                xClass = prvNextEventClass();
+                xQueue = xIPClassQueues[ xClass ];
+
+                if( xQueueReceive( xQueue, ( void * ) &xClassEvent, 0U ) == pdPASS )
+                {
+                    *pxEvent = xClassEvent.xEvent;
+                    ulLatency = ( uint32_t ) ( xTaskGetTickCount() - xClassEvent.xSendTime );
+                    xHasLatency = pdTRUE;
+                    xReturn = pdTRUE;
+                }
+            }
+
+            if( xReturn != pdFALSE )
+            {
+                /* The depth includes the event that was just taken. */
+                uxDepth = uxQueueMessagesWaiting( xQueue ) + 1U;
+
+                taskENTER_CRITICAL();
+                {
+                    xIPEventStats[ xClass ].ulEventCount++;
+                    xIPEventStats[ xClass ].ulDepth[ prvHistogramIndex( ( uint32_t ) uxDepth ) ]++;
+
+                    if( xHasLatency != pdFALSE )
+                    {
+                        xIPEventStats[ xClass ].ulLatency[ prvHistogramIndex( ulLatency ) ]++;
+                    }
+                }
+                taskEXIT_CRITICAL();
+            }
+        }
 
-/**
- * @brief The variable 'xIPTaskHandle' is declared static.  This function
- *        gives read-only access to it.
- *
- * @return The handle of the IP-task.
- */
-TaskHandle_t FreeRTOS_GetIPTaskHandle( void )
-{
-    return xIPTaskHandle;
-}
-/*-----------------------------------------------------------*/
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
 
 /**
- * @brief Handle the incoming Ethernet packets.
+ * @brief Get the statistics of the event classes of the IP-task: for each class
+ *        the number of events handled, a histogram of the number of events that
+ *        were waiting in the queue of the class, and a histogram of the time in
+ *        clock ticks that the events were waiting.
  *
- * @param[in] pxBuffer: Linked/un-linked network buffer descriptor(s)
- *                      to be processed.
+ * @param[out] pxStats: The statistics, indexed by ipEVENT_CLASS_CONTROL,
+ *                      ipEVENT_CLASS_TX and ipEVENT_CLASS_RX.
+ * @param[in] xReset: When pdTRUE, the statistics are cleared after copying them.
  */
-static void prvHandleEthernetPacket( NetworkBufferDescriptor_t * pxBuffer )
-{
-    #if ( ipconfigUSE_LINKED_RX_MESSAGES == 0 )
-        {
-            /* When ipconfigUSE_LINKED_RX_MESSAGES is not set to 0 then only one
-             * buffer will be sent at a time.  This is the default way for +TCP to pass
-             * messages from the MAC to the TCP/IP stack. */
-            prvProcessEthernetPacket( pxBuffer );
-        }
-    #else /* ipconfigUSE_LINKED_RX_MESSAGES */
+    void FreeRTOS_GetIPEventStats( IPEventStats_t pxStats[ ipEVENT_CLASS_COUNT ],
+                                   BaseType_t xReset )
+    {
+        taskENTER_CRITICAL();
         {
-            NetworkBufferDescriptor_t * pxNextBuffer;
+            ( void ) memcpy( pxStats, xIPEventStats, sizeof( xIPEventStats ) );
 
-            /* An optimisation that is useful when there is high network traffic.
-             * Instead of passing received packets into the IP task one at a time the
-             * network interface can chain received packets together and pass them into
-             * the IP task in one go.  The packets are chained using the pxNextBuffer
-             * member.  The loop below walks through the chain processing each packet
-             * in the chain in turn. */
-            do
+            if( xReset != pdFALSE )
             {
-                /* Store a pointer to the buffer after pxBuffer for use later on. */
-                pxNextBuffer = pxBuffer->pxNextBuffer;
-
-                /* Make it NULL to avoid using it later on. */
-                pxBuffer->pxNextBuffer = NULL;
-
-                prvProcessEthernetPacket( pxBuffer );
-                pxBuffer = pxNextBuffer;
-
-                /* While there is another packet in the chain. */
-            } while( pxBuffer != NULL );
+                ( void ) memset( xIPEventStats, 0, sizeof( xIPEventStats ) );
+            }
         }
-    #endif /* ipconfigUSE_LINKED_RX_MESSAGES */
-}
-/*-----------------------------------------------------------*/
+        taskEXIT_CRITICAL();
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigIP_EVENT_CLASSES */
 
 /**
  * @brief Calculate the maximum sleep time remaining. It will go through all
@@ -767,6 +1744,18 @@ static TickType_t prvCalculateSleepTime( void )
         }
     #endif
 
+    #if ( ipconfigUSE_MDNS != 0 )
+        {
+            if( xMDNSTimer.bActive != pdFALSE_UNSIGNED )
+            {
+                if( xMDNSTimer.ulRemainingTime < xMaximumSleepTime )
+                {
+                    xMaximumSleepTime = xMDNSTimer.ulRemainingTime;
+                }
+            }
+        }
+    #endif
+
     return xMaximumSleepTime;
 }
 /*-----------------------------------------------------------*/
@@ -786,20 +1775,37 @@ static void prvCheckNetworkTimers( void )
     /* Is the ARP resolution timer expired? */
     if( prvIPTimerCheck( &xARPResolutionTimer ) != pdFALSE )
     {
-        if( pxARPWaitingNetworkBuffer != NULL )
-        {
-            /* Disable the ARP resolution timer. */
-            vIPSetARPResolutionTimerEnableState( pdFALSE );
+        #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+            {
+                /* Release the packets that waited too long for an ARP reply, and
+                 * check again while other packets are still waiting. */
+                if( xARPCheckPendingPackets( ipARP_RESOLUTION_MAX_DELAY ) != pdFALSE )
+                {
+                    prvIPTimerStart( &( xARPResolutionTimer ), ipARP_RESOLUTION_MAX_DELAY / 2U );
+                }
+                else
+                {
+                    vIPSetARPResolutionTimerEnableState( pdFALSE );
+                }
+            }
+        #else /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+            {
+                if( pxARPWaitingNetworkBuffer != NULL )
+                {
+                    /* Disable the ARP resolution timer. */
+                    vIPSetARPResolutionTimerEnableState( pdFALSE );
 
-            /* We have waited long enough for the ARP response. Now, free the network
-             * buffer. */
-            vReleaseNetworkBufferAndDescriptor( pxARPWaitingNetworkBuffer );
+                    /* We have waited long enough for the ARP response. Now, free the network
+                     * buffer. */
+                    vReleaseNetworkBufferAndDescriptor( pxARPWaitingNetworkBuffer );
 
-            /* Clear the pointer. */
-            pxARPWaitingNetworkBuffer = NULL;
+                    /* Clear the pointer. */
+                    pxARPWaitingNetworkBuffer = NULL;
 
-            iptraceDELAYED_ARP_TIMER_EXPIRED();
-        }
+                    iptraceDELAYED_ARP_TIMER_EXPIRED();
+                }
+            }
+        #endif /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
     }
 
     #if ( ipconfigUSE_DHCP == 1 )
@@ -817,11 +1823,29 @@ static void prvCheckNetworkTimers( void )
             /* Is it time for DNS processing? */
             if( prvIPTimerCheck( &xDNSTimer ) != pdFALSE )
             {
-                vDNSCheckCallBack( NULL );
+                #if ( ipconfigDNS_USE_RESOLVER != 0 )
+                    {
+                        vDNSResolverProcess();
+                    }
+                #else
+                    {
+                        vDNSCheckCallBack( NULL );
+                    }
+                #endif
             }
         }
     #endif /* ipconfigDNS_USE_CALLBACKS */
 
+    #if ( ipconfigUSE_MDNS != 0 )
+        {
+            /* Is it time for the next unsolicited mDNS response? */
+            if( prvIPTimerCheck( &xMDNSTimer ) != pdFALSE )
+            {
+                vMDNSAnnounceProcess();
+            }
+        }
+    #endif /* ipconfigUSE_MDNS */
+
     #if ( ipconfigUSE_TCP == 1 )
         {
             BaseType_t xWillSleep;
@@ -830,7 +1854,7 @@ static void prvCheckNetworkTimers( void )
 
             /* If the IP task has messages waiting to be processed then
              * it will not sleep in any case. */
-            if( uxQueueMessagesWaiting( xNetworkEventQueue ) == 0U )
+            if( ipEVENTS_WAITING() == 0U )
             {
                 xWillSleep = pdTRUE;
             }
@@ -1232,6 +2256,17 @@ BaseType_t FreeRTOS_IPInit( const uint8_t ucIPAddress[ ipIP_ADDRESS_LENGTH_BYTES
         }
     #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+    #if ( ipconfigIP_EVENT_CLASSES != 0 )
+        {
+            if( ( xNetworkEventQueue != NULL ) && ( prvCreateIPEventQueues() != pdPASS ) )
+            {
+                /* prvCreateIPEventQueues() has removed it from the queue set. */
+                vQueueDelete( xNetworkEventQueue );
+                xNetworkEventQueue = NULL;
+            }
+        }
+    #endif
+
     if( xNetworkEventQueue != NULL )
     {
         #if ( configQUEUE_REGISTRY_SIZE > 0 )
@@ -1280,40 +2315,56 @@ BaseType_t FreeRTOS_IPInit( const uint8_t ucIPAddress[ ipIP_ADDRESS_LENGTH_BYTES
             /* Prepare the sockets interface. */
             vNetworkSocketsInit();
 
-            /* Create the task that processes Ethernet and stack events. */
-            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            #if ( ipconfigIP_RX_WORKER_COUNT > 0 )
+                /* The RX workers must exist before the IP-task receives packets. */
+                if( prvCreateRxWorkers() != pdPASS )
                 {
-                    static StaticTask_t xIPTaskBuffer;
-                    static StackType_t xIPTaskStack[ ipconfigIP_TASK_STACK_SIZE_WORDS ];
-                    xIPTaskHandle = xTaskCreateStatic( prvIPTask,
-                                                       "IP-Task",
-                                                       ipconfigIP_TASK_STACK_SIZE_WORDS,
-                                                       NULL,
-                                                       ipconfigIP_TASK_PRIORITY,
-                                                       xIPTaskStack,
-                                                       &xIPTaskBuffer );
-
-                    if( xIPTaskHandle != NULL )
+                    FreeRTOS_debug_printf( ( "FreeRTOS_IPInit: RX workers could not be created\n" ) );
+                }
+                else
+            #endif
+            {
+                /* Create the task that processes Ethernet and stack events. */
+                #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                     {
-                        xReturn = pdTRUE;
+                        static StaticTask_t xIPTaskBuffer;
+                        static StackType_t xIPTaskStack[ ipconfigIP_TASK_STACK_SIZE_WORDS ];
+                        xIPTaskHandle = xTaskCreateStatic( prvIPTask,
+                                                           "IP-Task",
+                                                           ipconfigIP_TASK_STACK_SIZE_WORDS,
+                                                           NULL,
+                                                           ipconfigIP_TASK_PRIORITY,
+                                                           xIPTaskStack,
+                                                           &xIPTaskBuffer );
+
+                        if( xIPTaskHandle != NULL )
+                        {
+                            xReturn = pdTRUE;
+                        }
                     }
-                }
-            #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
-                {
-                    xReturn = xTaskCreate( prvIPTask,
-                                           "IP-task",
-                                           ipconfigIP_TASK_STACK_SIZE_WORDS,
-                                           NULL,
-                                           ipconfigIP_TASK_PRIORITY,
-                                           &( xIPTaskHandle ) );
-                }
-            #endif /* configSUPPORT_STATIC_ALLOCATION */
+                #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+                    {
+                        xReturn = xTaskCreate( prvIPTask,
+                                               "IP-task",
+                                               ipconfigIP_TASK_STACK_SIZE_WORDS,
+                                               NULL,
+                                               ipconfigIP_TASK_PRIORITY,
+                                               &( xIPTaskHandle ) );
+                    }
+                #endif /* configSUPPORT_STATIC_ALLOCATION */
+            }
         }
         else
         {
             FreeRTOS_debug_printf( ( "FreeRTOS_IPInit: xNetworkBuffersInitialise() failed\n" ) );
 
             /* Clean up. */
+            #if ( ipconfigIP_EVENT_CLASSES != 0 )
+                {
+                    prvDeleteIPEventQueues();
+                }
+            #endif
+
             vQueueDelete( xNetworkEventQueue );
             xNetworkEventQueue = NULL;
         }
@@ -1400,6 +2451,12 @@ void FreeRTOS_SetAddressConfiguration( const uint32_t * pulIPAddress,
     {
         xNetworkAddressing.ulDNSServerAddress = *pulDNSServerAddress;
     }
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        {
+            vARPInvalidateDestinations();
+        }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -1469,6 +2526,12 @@ void FreeRTOS_SetAddressConfiguration( const uint32_t * pulIPAddress,
                 /* The message is complete, IP and checksum's are handled by
                  * vProcessGeneratedUDPPacket */
                 pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = FREERTOS_SO_UDPCKSUM_OUT;
+                #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+                    {
+                        /* The destination MAC-address is not known yet. */
+                        ( void ) memset( &( pxNetworkBuffer->pucEthernetBuffer[ ipDESTINATION_GENERATION_OFFSET ] ), 0, sizeof( uint32_t ) );
+                    }
+                #endif
                 pxNetworkBuffer->ulIPAddress = ulIPAddress;
                 pxNetworkBuffer->usPort = ipPACKET_CONTAINS_ICMP_DATA;
                 /* xDataLength is the size of the total packet, including the Ethernet header. */
@@ -1552,7 +2615,7 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
                      * IP task is already awake processing other message. */
                     xTCPTimer.bExpired = pdTRUE;
 
-                    if( uxQueueMessagesWaiting( xNetworkEventQueue ) != 0U )
+                    if( ipEVENTS_WAITING() != 0U )
                     {
                         /* Not actually going to send the message but this is not a
                          * failure as the message didn't need to be sent. */
@@ -1571,7 +2634,16 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
                 uxUseTimeout = ( TickType_t ) 0;
             }
 
-            xReturn = xQueueSendToBack( xNetworkEventQueue, pxEvent, uxUseTimeout );
+            #if ( ipconfigIP_RX_WORKER_COUNT > 0 )
+                {
+                    /* Received packets are checked by an RX worker first. */
+                    xReturn = prvRxWorkerSend( pxEvent, uxUseTimeout );
+                }
+            #else
+                {
+                    xReturn = prvPostIPEvent( pxEvent, uxUseTimeout );
+                }
+            #endif
 
             if( xReturn == pdFAIL )
             {
@@ -1648,6 +2720,14 @@ eFrameProcessingResult_t eConsiderFrameForProcessing( const uint8_t * const pucE
         }
         else
     #endif /* ipconfigUSE_LLMNR */
+    #if ( ipconfigUSE_MDNS != 0 )
+        if( memcmp( xMDNS_MacAddress.ucBytes, pxEthernetHeader->xDestinationAddress.ucBytes, sizeof( MACAddress_t ) ) == 0 )
+        {
+            /* The packet is an mDNS message - process it. */
+            eReturn = eProcessBuffer;
+        }
+        else
+    #endif /* ipconfigUSE_MDNS */
     {
         /* The packet was not a broadcast, or for this node, just release
          * the buffer without taking any other action. */
@@ -1703,7 +2783,7 @@ static void prvProcessNetworkDownEvent( void )
     /* Per the ARP Cache Validation section of https://tools.ietf.org/html/rfc1122,
      * treat network down as a "delivery problem" and flush the ARP cache for this
      * interface. */
-    FreeRTOS_ClearARP();
+    vARPClearCache();
 
     /* The network has been disconnected (or is being initialised for the first
      * time).  Perform whatever hardware processing is necessary to bring it up
@@ -1756,8 +2836,49 @@ void vIPNetworkUpCalls( void )
         }
     #endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 
+    #if ( ipconfigUSE_MDNS != 0 )
+        {
+            /* Tell the neighbours about the host name and the services. */
+            vMDNSStartAnnouncing();
+        }
+    #endif /* ipconfigUSE_MDNS */
+
     /* Set remaining time to 0 so it will become active immediately. */
     prvIPTimerReload( &xARPTimer, pdMS_TO_TICKS( ipARP_TIMER_PERIOD_MS ) );
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        {
+            /* The address configuration may have changed. */
+            vARPInvalidateDestinations();
+        }
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Undo vIPNetworkUpCalls() when the IP-address in use must be given up,
+ *        while the network interface itself stays up, e.g. because the DHCP
+ *        server refused it.  Called from the IP-task.
+ */
+void vIPNetworkDownCalls( void )
+{
+    xNetworkUp = pdFALSE;
+
+    /* Stop the ARP timer while there is no address. */
+    xARPTimer.bActive = pdFALSE_UNSIGNED;
+
+    #if ( ipconfigUSE_NETWORK_EVENT_HOOK == 1 )
+        {
+            vApplicationIPNetworkEventHook( eNetworkDown );
+        }
+    #endif /* ipconfigUSE_NETWORK_EVENT_HOOK */
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        {
+            /* The address configuration has changed. */
+            vARPInvalidateDestinations();
+        }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -1855,20 +2976,40 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
 
         case eWaitingARPResolution:
 
-            if( pxARPWaitingNetworkBuffer == NULL )
-            {
-                pxARPWaitingNetworkBuffer = pxNetworkBuffer;
-                prvIPTimerStart( &( xARPResolutionTimer ), ipARP_RESOLUTION_MAX_DELAY );
+            #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+                {
+                    const IPPacket_t * pxIPPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( IPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
 
-                iptraceDELAYED_ARP_REQUEST_STARTED();
-            }
-            else
-            {
-                /* We are already waiting on one ARP resolution. This frame will be dropped. */
-                vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    /* Every address that is being resolved has its own queue. */
+                    if( xARPQueuePendingPacket( pxIPPacket->xIPHeader.ulSourceIPAddress, pxNetworkBuffer, pdFALSE ) != pdFALSE )
+                    {
+                        iptraceDELAYED_ARP_REQUEST_STARTED();
+                    }
+                    else
+                    {
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
 
-                iptraceDELAYED_ARP_BUFFER_FULL();
-            }
+                        iptraceDELAYED_ARP_BUFFER_FULL();
+                    }
+                }
+            #else /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
+                {
+                    if( pxARPWaitingNetworkBuffer == NULL )
+                    {
+                        pxARPWaitingNetworkBuffer = pxNetworkBuffer;
+                        prvIPTimerStart( &( xARPResolutionTimer ), ipARP_RESOLUTION_MAX_DELAY );
+
+                        iptraceDELAYED_ARP_REQUEST_STARTED();
+                    }
+                    else
+                    {
+                        /* We are already waiting on one ARP resolution. This frame will be dropped. */
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+
+                        iptraceDELAYED_ARP_BUFFER_FULL();
+                    }
+                }
+            #endif /* if ( ipconfigUSE_ARP_HASH_TABLE != 0 ) */
 
             break;
 
@@ -1945,7 +3086,7 @@ static eFrameProcessingResult_t prvAllowIPPacket( const IPPacket_t * const pxIPP
 {
     eFrameProcessingResult_t eReturn = eProcessBuffer;
 
-    #if ( ( ipconfigETHERNET_DRIVER_FILTERS_PACKETS == 0 ) || ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) )
+    #if ( ( ipconfigETHERNET_DRIVER_FILTERS_PACKETS == 0 ) || ( ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) && ( ipconfigIP_RX_WORKER_COUNT == 0 ) ) )
         const IPHeader_t * pxIPHeader = &( pxIPPacket->xIPHeader );
     #else
 
@@ -1990,6 +3131,10 @@ static eFrameProcessingResult_t prvAllowIPPacket( const IPPacket_t * const pxIPP
                          /* Is it the LLMNR multicast address? */
                          ( ulDestinationIPAddress != ipLLMNR_IP_ADDR ) &&
                      #endif
+                     #if ( ipconfigUSE_MDNS != 0 )
+                         /* Is it the mDNS multicast address? */
+                         ( ulDestinationIPAddress != ipMDNS_IP_ADDR ) &&
+                     #endif
                      /* Or (during DHCP negotiation) we have no IP-address yet? */
                      ( *ipLOCAL_IP_ADDRESS_POINTER != 0U ) )
             {
@@ -2036,43 +3181,71 @@ static eFrameProcessingResult_t prvAllowIPPacket( const IPPacket_t * const pxIPP
         {
             /* Some drivers of NIC's with checksum-offloading will enable the above
              * define, so that the checksum won't be checked again here */
-            if( eReturn == eProcessBuffer )
-            {
-                /* Is the IP header checksum correct?
-                 *
-                 * NOTE: When the checksum of IP header is calculated while not omitting
-                 * the checksum field, the resulting value of the checksum always is 0xffff
-                 * which is denoted by ipCORRECT_CRC. See this wiki for more information:
-                 * https://en.wikipedia.org/wiki/IPv4_header_checksum#Verifying_the_IPv4_header_checksum
-                 * and this RFC: https://tools.ietf.org/html/rfc1624#page-4
-                 */
-                if( usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ( size_t ) uxHeaderLength ) != ipCORRECT_CRC )
-                {
-                    /* Check sum in IP-header not correct. */
-                    eReturn = eReleaseBuffer;
-                }
-                /* Is the upper-layer checksum (TCP/UDP/ICMP) correct? */
-                else if( usGenerateProtocolChecksum( ( uint8_t * ) ( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
+            #if ( ipconfigIP_RX_WORKER_COUNT == 0 )
                 {
-                    /* Protocol checksum not accepted. */
-                    eReturn = eReleaseBuffer;
+                    if( eReturn == eProcessBuffer )
+                    {
+                        /* Is the IP header checksum correct?
+                         *
+                         * NOTE: When the checksum of IP header is calculated while not omitting
+                         * the checksum field, the resulting value of the checksum always is 0xffff
+                         * which is denoted by ipCORRECT_CRC. See this wiki for more information:
+                         * https://en.wikipedia.org/wiki/IPv4_header_checksum#Verifying_the_IPv4_header_checksum
+                         * and this RFC: https://tools.ietf.org/html/rfc1624#page-4
+                         */
+                        if( usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ( size_t ) uxHeaderLength ) != ipCORRECT_CRC )
+                        {
+                            /* Check sum in IP-header not correct. */
+                            eReturn = eReleaseBuffer;
+                        }
+                        /* Is the upper-layer checksum (TCP/UDP/ICMP) correct? */
+                        else if( usGenerateProtocolChecksum( ( uint8_t * ) ( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
+                        {
+                            /* Protocol checksum not accepted. */
+                            eReturn = eReleaseBuffer;
+                        }
+                        else
+                        {
+                            /* The checksum of the received packet is OK. */
+                        }
+                    }
                 }
-                else
+            #else
                 {
-                    /* The checksum of the received packet is OK. */
+                    /* The checksums have been checked by an RX worker task. */
+                    ( void ) pxNetworkBuffer;
+                    ( void ) uxHeaderLength;
                 }
-            }
+            #endif /* ipconfigIP_RX_WORKER_COUNT */
         }
     #else /* if ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) */
         {
-            if( eReturn == eProcessBuffer )
-            {
-                if( xCheckSizeFields( ( uint8_t * ) ( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength ) != pdPASS )
+            #if ( ipconfigIP_RX_WORKER_COUNT == 0 )
                 {
-                    /* Some of the length checks were not successful. */
-                    eReturn = eReleaseBuffer;
+                    size_t uxSegmentCount = 1U;
+
+                    #if ( ipconfigUSE_TCP_RX_COALESCING != 0 )
+                        {
+                            /* A packet merged by the IP-task may be larger than the MTU. */
+                            uxSegmentCount = FreeRTOS_max_size_t( uxSegmentCount, ( size_t ) pxNetworkBuffer->usCoalescedCount );
+                        }
+                    #endif
+
+                    if( eReturn == eProcessBuffer )
+                    {
+                        if( xCheckSizeFields( ( uint8_t * ) ( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, uxSegmentCount ) != pdPASS )
+                        {
+                            /* Some of the length checks were not successful. */
+                            eReturn = eReleaseBuffer;
+                        }
+                    }
                 }
-            }
+            #else
+                {
+                    /* The length fields have been checked by an RX worker task. */
+                    ( void ) pxNetworkBuffer;
+                }
+            #endif /* ipconfigIP_RX_WORKER_COUNT */
 
             #if ( ipconfigUDP_PASS_ZERO_CHECKSUM_PACKETS == 0 )
                 {
@@ -2509,12 +3682,16 @@ static eFrameProcessingResult_t prvProcessIPPacket( IPPacket_t * pxIPPacket,
  *
  * @param[in] pucEthernetBuffer: The Ethernet packet received.
  * @param[in] uxBufferLength: The total number of bytes received.
+ * @param[in] uxSegmentCount: The number of TCP segments that were merged into
+ *                            this packet by receive coalescing, 1 for a packet
+ *                            as received from the driver.
  *
  * @return pdPASS when the length fields in the packet OK, pdFAIL when the packet
  *         should be dropped.
  */
     static BaseType_t xCheckSizeFields( const uint8_t * const pucEthernetBuffer,
-                                        size_t uxBufferLength )
+                                        size_t uxBufferLength,
+                                        size_t uxSegmentCount )
     {
         size_t uxLength;
         const IPPacket_t * pxIPPacket;
@@ -2524,6 +3701,7 @@ static eFrameProcessingResult_t prvProcessIPPacket( IPPacket_t * pxIPPacket,
         uint16_t usLength;
         uint16_t ucVersionHeaderLength;
         size_t uxMinimumLength;
+        size_t uxMaximumLength;
         BaseType_t xResult = pdFAIL;
 
         DEBUG_DECLARE_TRACE_VARIABLE( BaseType_t, xLocation, 0 );
@@ -2615,9 +3793,16 @@ static eFrameProcessingResult_t prvProcessIPPacket( IPPacket_t * pxIPPacket,
 
             uxLength = ( size_t ) usLength;
             uxLength -= ( ( uint16_t ) uxIPHeaderLength ); /* normally, minus 20. */
+            uxMaximumLength = ( size_t ) ipconfigNETWORK_MTU - ( size_t ) uxIPHeaderLength;
+
+            /* Only TCP segments merged by the IP-task may be larger than the MTU. */
+            if( ( ucProtocol == ( uint8_t ) ipPROTOCOL_TCP ) && ( uxSegmentCount > 1U ) )
+            {
+                uxMaximumLength *= uxSegmentCount;
+            }
 
             if( ( uxLength < ( ( size_t ) sizeof( pxProtPack->xUDPPacket.xUDPHeader ) ) ) ||
-                ( uxLength > ( ( size_t ) ipconfigNETWORK_MTU - ( size_t ) uxIPHeaderLength ) ) )
+                ( uxLength > uxMaximumLength ) )
             {
                 /* For incoming packets, the length is out of bound: either
                  * too short or too long. For outgoing packets, there is a
@@ -3286,6 +4471,12 @@ uint32_t FreeRTOS_GetIPAddress( void )
 void FreeRTOS_SetIPAddress( uint32_t ulIPAddress )
 {
     *ipLOCAL_IP_ADDRESS_POINTER = ulIPAddress;
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        {
+            vARPInvalidateDestinations();
+        }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -3354,6 +4545,12 @@ const uint8_t * FreeRTOS_GetMACAddress( void )
 void FreeRTOS_SetNetmask( uint32_t ulNetmask )
 {
     xNetworkAddressing.ulNetMask = ulNetmask;
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        {
+            vARPInvalidateDestinations();
+        }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -3365,6 +4562,12 @@ void FreeRTOS_SetNetmask( uint32_t ulNetmask )
 void FreeRTOS_SetGatewayAddress( uint32_t ulGatewayAddress )
 {
     xNetworkAddressing.ulGatewayAddress = ulGatewayAddress;
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        {
+            vARPInvalidateDestinations();
+        }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -3457,6 +4660,38 @@ void vIPSetARPResolutionTimerEnableState( BaseType_t xEnableState )
 #endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_MDNS != 0 )
+
+/**
+ * @brief Enable/disable the mDNS timer.
+ *
+ * @param[in] xEnableState: pdTRUE - enable timer; pdFALSE - disable timer.
+ */
+    void vIPSetMDNSTimerEnableState( BaseType_t xEnableState )
+    {
+        if( xEnableState != 0 )
+        {
+            xMDNSTimer.bActive = pdTRUE;
+        }
+        else
+        {
+            xMDNSTimer.bActive = pdFALSE;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Reload the mDNS timer.
+ *
+ * @param[in] ulCheckTime: The reload value.
+ */
+    void vIPReloadMDNSTimer( uint32_t ulCheckTime )
+    {
+        prvIPTimerReload( &xMDNSTimer, ulCheckTime );
+    }
+#endif /* ipconfigUSE_MDNS != 0 */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Returns whether the IP task is ready.
  *
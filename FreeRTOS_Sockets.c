@@ -45,6 +45,7 @@
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS_Sockets.h"
 #include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_ARP.h"
 #include "FreeRTOS_DNS.h"
 #include "NetworkBufferManagement.h"
 
@@ -94,11 +95,65 @@
 #define sock80_PERCENT            80U  /**< 80% of the defined limit. */
 #define sock100_PERCENT           100U /**< 100% of the defined limit. */
 
+#if ( ipTCP_GUARD_RX_STREAM != 0 ) || ( ipTCP_GUARD_TX_STREAM != 0 )
+
+/** @brief The IP-task may replace or release the rxStream or the txStream of a
+ *         socket, which it does in a critical section.  A user task must read the
+ *         stream pointer, and use it, within a critical section as well, also
+ *         when the IP-task runs on another core. */
+    #define sockENTER_STREAM_CRITICAL()    taskENTER_CRITICAL()
+    #define sockEXIT_STREAM_CRITICAL()     taskEXIT_CRITICAL()
+#else
+    #define sockENTER_STREAM_CRITICAL()
+    #define sockEXIT_STREAM_CRITICAL()
+#endif
+
 /** @brief When ucASCIIToHex() can not convert a character,
  *         the value 255 will be returned.
  */
 #define socketINVALID_HEX_CHAR    0xffU
 
+/** @brief The memory used by the event group of a socket. */
+#if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+    #define socketEVENT_GROUP_SIZE    ( 0U )
+#else
+    #define socketEVENT_GROUP_SIZE    sizeof( StaticEventGroup_t )
+#endif
+
+/** @brief The size of a UDP socket, which does not have space for the TCP fields. */
+#define socketUDP_SOCKET_SIZE    ( ( sizeof( FreeRTOS_Socket_t ) - sizeof( ( ( const FreeRTOS_Socket_t * ) NULL )->u ) ) + sizeof( IPUDPSocket_t ) )
+
+#if ( ipconfigUSE_TCP == 1 )
+    /** @brief The size of a TCP socket. */
+    #define socketTCP_SOCKET_SIZE    ( ( sizeof( FreeRTOS_Socket_t ) - sizeof( ( ( const FreeRTOS_Socket_t * ) NULL )->u ) ) + sizeof( IPTCPSocket_t ) )
+#endif
+
+#if ( ipconfigSOCKET_POOL != 0 )
+    /** @brief The indexes of the pools in xSocketPools[]. */
+    #define socketPOOL_UDP             0
+    #define socketPOOL_TCP             1
+    #define socketPOOL_STREAM_SMALL    2
+    #define socketPOOL_STREAM_LARGE    3
+    #define socketPOOL_COUNT           4
+
+    /** @brief The number of 64-bit words in a pool block of at least 'uxSize' bytes. */
+    #define socketPOOL_WORDS( uxSize )    ( ( ( uxSize ) + 7U ) / 8U )
+
+    /** @brief The space needed for a stream of 'uxLength' bytes: the header, the
+     *         extra bytes added by prvTCPAllocateStream(), and the largest mirror. */
+    #define socketPOOL_STREAM_SIZE( uxLength ) \
+    ( ( sizeof( StreamBuffer_t ) - sizeof( ( ( const StreamBuffer_t * ) NULL )->ucArray ) ) + ( uxLength ) + sizeof( size_t ) + ( size_t ) ipconfigSTREAM_BUFFER_MIRROR_SIZE )
+
+/** @brief A pool of memory blocks of a fixed size. */
+    typedef struct xSOCKET_POOL
+    {
+        uint8_t * pucStart;     /**< The first block of the pool. */
+        size_t uxBlockSize;     /**< The size of each block, a multiple of 8 bytes. */
+        UBaseType_t uxCount;    /**< The number of blocks in the pool. */
+        void * pvFreeList;      /**< The first free block.  A free block starts with a pointer to the next free block. */
+    } SocketPool_t;
+#endif /* ipconfigSOCKET_POOL */
+
 #if ( ipconfigUSE_CALLBACKS != 0 )
     static ipDECL_CAST_CONST_PTR_FUNC_FOR_TYPE( F_TCP_UDP_Handler_t )
     {
@@ -169,6 +224,12 @@ static uint8_t ucASCIIToHex( char cChar );
  */
     static StreamBuffer_t * prvTCPCreateStream( FreeRTOS_Socket_t * pxSocket,
                                                 BaseType_t xIsInputStream );
+
+/*
+ * Allocate and clear a stream buffer that can hold at least 'uxStreamSize' bytes.
+ */
+    static StreamBuffer_t * prvTCPAllocateStream( size_t uxStreamSize,
+                                                  size_t * puxAllocatedSize );
 #endif /* ipconfigUSE_TCP == 1 */
 
 #if ( ipconfigUSE_TCP == 1 )
@@ -214,6 +275,108 @@ static uint8_t ucASCIIToHex( char cChar );
     static void prvFindSelectedSocket( SocketSelect_t * pxSocketSet );
 
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+
+#if ( ipconfigSUPPORT_EPOLL == 1 )
+
+/*
+ * Return the events of interest for which a socket is ready at this moment.
+ */
+    static EventBits_t prvEPollReadiness( const FreeRTOS_Socket_t * pxSocket );
+
+/*
+ * Take the sockets that have events to report from the ready list of an epoll
+ * set.
+ */
+    static BaseType_t prvEPollHarvest( SocketEPoll_t * pxEPoll,
+                                       EPollEvent_t * pxEvents,
+                                       BaseType_t xMaxEvents );
+
+/*
+ * Unregister a socket from its epoll set.  The scheduler must be suspended.
+ */
+    static void prvEPollRemove( FreeRTOS_Socket_t * pxSocket );
+
+#endif /* ipconfigSUPPORT_EPOLL == 1 */
+
+#if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+
+/*
+ * Copy the destination MAC-address that a UDP socket stored into a packet.
+ */
+    static void prvSetDestinationMAC( const FreeRTOS_Socket_t * pxSocket,
+                                      NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif /* ipconfigUSE_DESTINATION_CACHE */
+
+#if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+
+/*
+ * Remove a waiting task from the list of a socket.
+ */
+    static void prvSocketRemoveWaiter( FreeRTOS_Socket_t * pxSocket,
+                                       const SocketWaiter_t * pxWaiter );
+#endif /* ipconfigSOCKET_USES_NOTIFY */
+
+#if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+
+/*
+ * Wait until the IP-task has closed a static socket.
+ */
+    static void prvStaticSocketWaitClosed( FreeRTOS_Socket_t * pxSocket );
+
+/*
+ * Mark a static socket as closed, and wake up the task that closed it.
+ */
+    static void prvStaticSocketRelease( FreeRTOS_Socket_t * pxSocket );
+#endif /* ipconfigSUPPORT_STATIC_SOCKETS */
+
+/*
+ * Create a socket, either in the memory that 'pxSocketBuffer' points to, or when
+ * it is NULL, in memory taken from a pool or from the heap.
+ */
+static Socket_t prvSocketCreate( BaseType_t xDomain,
+                                 BaseType_t xType,
+                                 BaseType_t xProtocol,
+                                 FreeRTOS_Socket_t * pxSocketBuffer );
+
+/*
+ * Give the memory of a socket back to its pool or to the heap, unless the memory
+ * was provided by the user.
+ */
+static void prvSocketFree( FreeRTOS_Socket_t * pxSocket,
+                           BaseType_t xUserMemory );
+
+#if ( ipconfigSOCKET_POOL != 0 )
+
+/*
+ * Link the blocks of a pool into its list of free blocks.
+ */
+    static void prvSocketPoolInit( SocketPool_t * pxPool,
+                                   uint64_t * pullStorage,
+                                   size_t uxBlockWords,
+                                   UBaseType_t uxCount );
+
+/*
+ * Take a block of at least 'uxSize' bytes from the first pool in the range
+ * 'xFirstPool' to 'xLastPool' that has one.
+ */
+    static void * prvSocketPoolTake( BaseType_t xFirstPool,
+                                     BaseType_t xLastPool,
+                                     size_t uxSize );
+
+/*
+ * Give a block back to the pool it was taken from.  Returns pdFALSE when the
+ * block does not belong to any pool.
+ */
+    static BaseType_t prvSocketPoolGive( void * pvBlock );
+#endif /* ipconfigSOCKET_POOL */
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/*
+ * Free a stream that was allocated by prvTCPAllocateStream().
+ */
+    static void prvTCPFreeStream( StreamBuffer_t * pxBuffer );
+#endif /* ipconfigUSE_TCP == 1 */
 /*-----------------------------------------------------------*/
 
 /** @brief The list that contains mappings between sockets and port numbers.
@@ -232,6 +395,43 @@ List_t xBoundUDPSocketsList;
 
 #endif /* ipconfigUSE_TCP == 1 */
 
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+
+/** @brief The number of bytes by which the txStreams of all sockets together may
+ *         still grow.  Only accessed from the IP-task.
+ */
+    static size_t uxTxStreamBudget = ( size_t ) ipconfigTCP_TX_AUTOTUNE_BUDGET;
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 ) */
+
+#if ( ipconfigSOCKET_POOL != 0 )
+
+/** @brief The pools of sockets and streams.  Accesses must be protected by a
+ *         critical section. */
+    static SocketPool_t xSocketPools[ socketPOOL_COUNT ];
+
+    #if ( ipconfigSOCKET_POOL_UDP_COUNT > 0 )
+        /** @brief The memory of the UDP sockets in the pool. */
+        static uint64_t ullUDPSocketStorage[ ipconfigSOCKET_POOL_UDP_COUNT ][ socketPOOL_WORDS( socketUDP_SOCKET_SIZE ) ];
+    #endif
+
+    #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigSOCKET_POOL_TCP_COUNT > 0 )
+        /** @brief The memory of the TCP sockets in the pool. */
+        static uint64_t ullTCPSocketStorage[ ipconfigSOCKET_POOL_TCP_COUNT ][ socketPOOL_WORDS( socketTCP_SOCKET_SIZE ) ];
+    #endif
+
+    #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigSTREAM_POOL_SMALL_COUNT > 0 )
+        /** @brief The memory of the small streams in the pool. */
+        static uint64_t ullSmallStreamStorage[ ipconfigSTREAM_POOL_SMALL_COUNT ][ socketPOOL_WORDS( socketPOOL_STREAM_SIZE( ipconfigSTREAM_POOL_SMALL_LENGTH ) ) ];
+    #endif
+
+    #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigSTREAM_POOL_LARGE_COUNT > 0 )
+        /** @brief The memory of the large streams in the pool. */
+        static uint64_t ullLargeStreamStorage[ ipconfigSTREAM_POOL_LARGE_COUNT ][ socketPOOL_WORDS( socketPOOL_STREAM_SIZE( ipconfigSTREAM_POOL_LARGE_LENGTH ) ) ];
+    #endif
+
+#endif /* ipconfigSOCKET_POOL */
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -285,6 +485,184 @@ void vNetworkSocketsInit( void )
             vListInitialise( &xBoundTCPSocketsList );
         }
     #endif /* ipconfigUSE_TCP == 1 */
+
+    #if ( ipconfigSOCKET_POOL != 0 )
+        {
+            ( void ) memset( xSocketPools, 0, sizeof( xSocketPools ) );
+
+            #if ( ipconfigSOCKET_POOL_UDP_COUNT > 0 )
+                {
+                    prvSocketPoolInit( &( xSocketPools[ socketPOOL_UDP ] ), ullUDPSocketStorage[ 0 ],
+                                       socketPOOL_WORDS( socketUDP_SOCKET_SIZE ), ( UBaseType_t ) ipconfigSOCKET_POOL_UDP_COUNT );
+                }
+            #endif
+
+            #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigSOCKET_POOL_TCP_COUNT > 0 )
+                {
+                    prvSocketPoolInit( &( xSocketPools[ socketPOOL_TCP ] ), ullTCPSocketStorage[ 0 ],
+                                       socketPOOL_WORDS( socketTCP_SOCKET_SIZE ), ( UBaseType_t ) ipconfigSOCKET_POOL_TCP_COUNT );
+                }
+            #endif
+
+            #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigSTREAM_POOL_SMALL_COUNT > 0 )
+                {
+                    prvSocketPoolInit( &( xSocketPools[ socketPOOL_STREAM_SMALL ] ), ullSmallStreamStorage[ 0 ],
+                                       socketPOOL_WORDS( socketPOOL_STREAM_SIZE( ipconfigSTREAM_POOL_SMALL_LENGTH ) ),
+                                       ( UBaseType_t ) ipconfigSTREAM_POOL_SMALL_COUNT );
+                }
+            #endif
+
+            #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigSTREAM_POOL_LARGE_COUNT > 0 )
+                {
+                    prvSocketPoolInit( &( xSocketPools[ socketPOOL_STREAM_LARGE ] ), ullLargeStreamStorage[ 0 ],
+                                       socketPOOL_WORDS( socketPOOL_STREAM_SIZE( ipconfigSTREAM_POOL_LARGE_LENGTH ) ),
+                                       ( UBaseType_t ) ipconfigSTREAM_POOL_LARGE_COUNT );
+                }
+            #endif
+        }
+    #endif /* ipconfigSOCKET_POOL */
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSOCKET_POOL != 0 )
+
+/**
+ * @brief Link the blocks of a pool into its list of free blocks.
+ *
+ * @param[out] pxPool: The pool to be initialised.
+ * @param[in] pullStorage: The memory of the blocks.
+ * @param[in] uxBlockWords: The size of a block in 64-bit words.
+ * @param[in] uxCount: The number of blocks.
+ */
+    static void prvSocketPoolInit( SocketPool_t * pxPool,
+                                   uint64_t * pullStorage,
+                                   size_t uxBlockWords,
+                                   UBaseType_t uxCount )
+    {
+        UBaseType_t uxIndex;
+        void ** ppvBlock;
+
+        pxPool->pucStart = ipPOINTER_CAST( uint8_t *, pullStorage );
+        pxPool->uxBlockSize = uxBlockWords * sizeof( uint64_t );
+        pxPool->uxCount = uxCount;
+        pxPool->pvFreeList = NULL;
+
+        /* Link the blocks backwards, so that the first block will be taken first. */
+        for( uxIndex = uxCount; uxIndex > 0U; uxIndex-- )
+        {
+            ppvBlock = ipPOINTER_CAST( void **, &( pullStorage[ ( uxIndex - 1U ) * uxBlockWords ] ) );
+            *ppvBlock = pxPool->pvFreeList;
+            pxPool->pvFreeList = ppvBlock;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a block from the first pool, in the range 'xFirstPool' to
+ *        'xLastPool', which has a free block that is big enough.
+ *
+ * @param[in] xFirstPool: The index of the first pool to look at.
+ * @param[in] xLastPool: The index of the last pool to look at.
+ * @param[in] uxSize: The minimum size of the block.
+ *
+ * @return The block, or NULL when none of the pools has a block available.
+ */
+    static void * prvSocketPoolTake( BaseType_t xFirstPool,
+                                     BaseType_t xLastPool,
+                                     size_t uxSize )
+    {
+        BaseType_t xIndex;
+        SocketPool_t * pxPool;
+        void * pvBlock = NULL;
+
+        taskENTER_CRITICAL();
+        {
+            for( xIndex = xFirstPool; xIndex <= xLastPool; xIndex++ )
+            {
+                pxPool = &( xSocketPools[ xIndex ] );
+
+                if( ( pxPool->pvFreeList != NULL ) && ( uxSize <= pxPool->uxBlockSize ) )
+                {
+                    pvBlock = pxPool->pvFreeList;
+                    pxPool->pvFreeList = *( ipPOINTER_CAST( void **, pvBlock ) );
+                    break;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return pvBlock;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Give a block back to the pool that contains it.
+ *
+ * @param[in] pvBlock: The block to be given back.
+ *
+ * @return pdTRUE when the block was given back, pdFALSE when it does not belong
+ *         to any of the pools.
+ */
+    static BaseType_t prvSocketPoolGive( void * pvBlock )
+    {
+        BaseType_t xIndex;
+        SocketPool_t * pxPool;
+        uintptr_t uxAddress = ( uintptr_t ) pvBlock;
+        uintptr_t uxStart;
+        BaseType_t xReturn = pdFALSE;
+
+        for( xIndex = 0; xIndex < socketPOOL_COUNT; xIndex++ )
+        {
+            pxPool = &( xSocketPools[ xIndex ] );
+            uxStart = ( uintptr_t ) pxPool->pucStart;
+
+            if( ( pxPool->uxCount > 0U ) &&
+                ( uxAddress >= uxStart ) &&
+                ( uxAddress < ( uxStart + ( pxPool->uxCount * pxPool->uxBlockSize ) ) ) )
+            {
+                taskENTER_CRITICAL();
+                {
+                    *( ipPOINTER_CAST( void **, pvBlock ) ) = pxPool->pvFreeList;
+                    pxPool->pvFreeList = pvBlock;
+                }
+                taskEXIT_CRITICAL();
+
+                xReturn = pdTRUE;
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigSOCKET_POOL */
+
+/**
+ * @brief Give the memory of a socket back to its pool or to the heap.
+ *
+ * @param[in] pxSocket: The socket whose memory is freed.
+ * @param[in] xUserMemory: pdTRUE when the memory was provided to
+ *                         FreeRTOS_socket_static(), it will not be freed.
+ */
+static void prvSocketFree( FreeRTOS_Socket_t * pxSocket,
+                           BaseType_t xUserMemory )
+{
+    if( xUserMemory != pdFALSE )
+    {
+        /* The memory belongs to the user. */
+    }
+
+    #if ( ipconfigSOCKET_POOL != 0 )
+        else if( prvSocketPoolGive( pxSocket ) != pdFALSE )
+        {
+            /* The socket was taken from a pool. */
+        }
+    #endif
+    else
+    {
+        vPortFreeSocket( pxSocket );
+    }
 }
 /*-----------------------------------------------------------*/
 
@@ -306,7 +684,6 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain,
                                           size_t * pxSocketSize )
 {
     BaseType_t xReturn = pdPASS;
-    FreeRTOS_Socket_t const * pxSocket = NULL;
 
     /* Asserts must not appear before it has been determined that the network
      * task is ready - otherwise the asserts will fail. */
@@ -337,7 +714,7 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain,
             }
 
             /* In case a UDP socket is created, do not allocate space for TCP data. */
-            *pxSocketSize = ( sizeof( *pxSocket ) - sizeof( pxSocket->u ) ) + sizeof( pxSocket->u.xUDP );
+            *pxSocketSize = socketUDP_SOCKET_SIZE;
         }
 
         #if ( ipconfigUSE_TCP == 1 )
@@ -349,7 +726,7 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain,
                     configASSERT( xReturn == pdPASS );
                 }
 
-                *pxSocketSize = ( sizeof( *pxSocket ) - sizeof( pxSocket->u ) ) + sizeof( pxSocket->u.xTCP );
+                *pxSocketSize = socketTCP_SOCKET_SIZE;
             }
         #endif /* ipconfigUSE_TCP == 1 */
         else
@@ -361,7 +738,6 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain,
 
     /* In case configASSERT() is not used */
     ( void ) xDomain;
-    ( void ) pxSocket; /* Was only used for sizeof. */
     return xReturn;
 }
 /*-----------------------------------------------------------*/
@@ -380,11 +756,126 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
                           BaseType_t xType,
                           BaseType_t xProtocol )
 {
-    FreeRTOS_Socket_t * pxSocket;
+    return prvSocketCreate( xDomain, xType, xProtocol, NULL );
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+
+/**
+ * @brief Initialise a socket in memory that is provided by the caller.  The
+ *        memory will not be freed when the socket is closed.
+ *
+ * @param[in] xDomain: The domain in which the socket should be created.
+ * @param[in] xType: The type of the socket.
+ * @param[in] xProtocol: The protocol of the socket.
+ * @param[in] pxSocketBuffer: The memory for the socket.  It must remain valid
+ *                            until the IP-task has closed the socket.
+ *
+ * @return FREERTOS_INVALID_SOCKET if there was a parameter error, otherwise
+ *         a valid socket.
+ */
+    Socket_t FreeRTOS_socket_static( BaseType_t xDomain,
+                                     BaseType_t xType,
+                                     BaseType_t xProtocol,
+                                     StaticSocket_t * pxSocketBuffer )
+    {
+        Socket_t xReturn;
+
+        /* Like the kernel does for StaticTask_t: the public type must be large
+         * enough to hold the real socket.  A volatile variable keeps the
+         * compiler from warning about a constant comparison. */
+        volatile size_t uxSize = sizeof( StaticSocket_t );
+
+        configASSERT( pxSocketBuffer != NULL );
+        configASSERT( uxSize >= sizeof( FreeRTOS_Socket_t ) );
+
+        if( ( pxSocketBuffer == NULL ) || ( uxSize < sizeof( FreeRTOS_Socket_t ) ) )
+        {
+            xReturn = FREERTOS_INVALID_SOCKET;
+        }
+        else
+        {
+            xReturn = prvSocketCreate( xDomain, xType, xProtocol, ipCAST_PTR_TO_TYPE_PTR( FreeRTOS_Socket_t, pxSocketBuffer ) );
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Wait until the IP-task has closed a static socket, so that its memory
+ *        may be used again.  A socket that is closed from the IP-task itself,
+ *        e.g. in a callback, is closed later, and this function returns
+ *        immediately.
+ *
+ * @param[in] pxSocket: The socket that is being closed.
+ */
+    static void prvStaticSocketWaitClosed( FreeRTOS_Socket_t * pxSocket )
+    {
+        if( ( pxSocket->ucStaticSocket != pdFALSE_UNSIGNED ) && ( xIsCallingFromIPTask() == pdFALSE ) )
+        {
+            /* The notification might be left from an earlier wait, so the flag
+             * is checked after every wake-up. */
+            while( pxSocket->ucStaticClosed == pdFALSE_UNSIGNED )
+            {
+                ( void ) ulTaskNotifyTakeIndexed( ipconfigSOCKET_NOTIFY_INDEX, pdTRUE, portMAX_DELAY );
+            }
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the IP-task as the last step of closing a static socket: give
+ *        the memory back to the user, and wake up the task that is waiting in
+ *        FreeRTOS_closesocket().
+ *
+ * @param[in] pxSocket: The socket that was closed.
+ */
+    static void prvStaticSocketRelease( FreeRTOS_Socket_t * pxSocket )
+    {
+        TaskHandle_t xCloseTask = pxSocket->xCloseTask;
+
+        /* The memory may be used again as soon as the flag is seen, so it must
+         * not be accessed after this point. */
+        ipMEMORY_BARRIER();
+        pxSocket->ucStaticClosed = pdTRUE_UNSIGNED;
+
+        if( xCloseTask != NULL )
+        {
+            ( void ) xTaskNotifyGiveIndexed( xCloseTask, ipconfigSOCKET_NOTIFY_INDEX );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigSUPPORT_STATIC_SOCKETS */
+
+/**
+ * @brief Initialise a socket in the memory that 'pxSocketBuffer' points to, or
+ *        when it is NULL, in memory that is taken from a pool or the heap.
+ *
+ * @param[in] xDomain: The domain in which the socket should be created.
+ * @param[in] xType: The type of the socket.
+ * @param[in] xProtocol: The protocol of the socket.
+ * @param[in] pxSocketBuffer: Memory provided by the user, or NULL.
+ *
+ * @return FREERTOS_INVALID_SOCKET if the allocation failed, or if there was
+ *         a parameter error, otherwise a valid socket.
+ */
+static Socket_t prvSocketCreate( BaseType_t xDomain,
+                                 BaseType_t xType,
+                                 BaseType_t xProtocol,
+                                 FreeRTOS_Socket_t * pxSocketBuffer )
+{
+    FreeRTOS_Socket_t * pxSocket = pxSocketBuffer;
+    BaseType_t xUserMemory = ( pxSocketBuffer != NULL ) ? pdTRUE : pdFALSE;
 
 /* Note that this value will be over-written by the call to prvDetermineSocketSize. */
     size_t uxSocketSize = 1;
-    EventGroupHandle_t xEventGroup;
+
+    #if ( ipconfigSOCKET_USES_NOTIFY == 0 )
+        EventGroupHandle_t xEventGroup;
+    #endif
     Socket_t xReturn;
 
     if( prvDetermineSocketSize( xDomain, xType, xProtocol, &uxSocketSize ) == pdFAIL )
@@ -393,11 +884,30 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
     }
     else
     {
-        /* Allocate the structure that will hold the socket information. The
-        * size depends on the type of socket: UDP sockets need less space. A
-        * define 'pvPortMallocSocket' will used to allocate the necessary space.
-        * By default it points to the FreeRTOS function 'pvPortMalloc()'. */
-        pxSocket = ipCAST_PTR_TO_TYPE_PTR( FreeRTOS_Socket_t, pvPortMallocSocket( uxSocketSize ) );
+        #if ( ipconfigSOCKET_POOL != 0 )
+            if( pxSocket == NULL )
+            {
+                /* Sockets of the same protocol have the same size, so there is
+                 * only one pool for each protocol. */
+                if( xProtocol == FREERTOS_IPPROTO_UDP )
+                {
+                    pxSocket = ipCAST_PTR_TO_TYPE_PTR( FreeRTOS_Socket_t, prvSocketPoolTake( socketPOOL_UDP, socketPOOL_UDP, uxSocketSize ) );
+                }
+                else
+                {
+                    pxSocket = ipCAST_PTR_TO_TYPE_PTR( FreeRTOS_Socket_t, prvSocketPoolTake( socketPOOL_TCP, socketPOOL_TCP, uxSocketSize ) );
+                }
+            }
+        #endif /* ipconfigSOCKET_POOL */
+
+        if( pxSocket == NULL )
+        {
+            /* Allocate the structure that will hold the socket information. The
+            * size depends on the type of socket: UDP sockets need less space. A
+            * define 'pvPortMallocSocket' will used to allocate the necessary space.
+            * By default it points to the FreeRTOS function 'pvPortMalloc()'. */
+            pxSocket = ipCAST_PTR_TO_TYPE_PTR( FreeRTOS_Socket_t, pvPortMallocSocket( uxSocketSize ) );
+        }
 
         if( pxSocket == NULL )
         {
@@ -406,30 +916,42 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
         }
         else
         {
-            xEventGroup = xEventGroupCreate();
+            #if ( ipconfigSOCKET_USES_NOTIFY == 0 )
+                xEventGroup = xEventGroupCreate();
 
-            if( xEventGroup == NULL )
-            {
-                vPortFreeSocket( pxSocket );
-                xReturn = FREERTOS_INVALID_SOCKET;
-                iptraceFAILED_TO_CREATE_EVENT_GROUP();
-            }
-            else
+                if( xEventGroup == NULL )
+                {
+                    prvSocketFree( pxSocket, xUserMemory );
+                    xReturn = FREERTOS_INVALID_SOCKET;
+                    iptraceFAILED_TO_CREATE_EVENT_GROUP();
+                }
+                else
+            #endif /* ipconfigSOCKET_USES_NOTIFY */
             {
                 if( xProtocol == FREERTOS_IPPROTO_UDP )
                 {
-                    iptraceMEM_STATS_CREATE( tcpSOCKET_UDP, pxSocket, uxSocketSize + sizeof( StaticEventGroup_t ) );
+                    iptraceMEM_STATS_CREATE( tcpSOCKET_UDP, pxSocket, uxSocketSize + socketEVENT_GROUP_SIZE );
                 }
                 else
                 {
                     /* Lint wants at least a comment, in case the macro is empty. */
-                    iptraceMEM_STATS_CREATE( tcpSOCKET_TCP, pxSocket, uxSocketSize + sizeof( StaticEventGroup_t ) );
+                    iptraceMEM_STATS_CREATE( tcpSOCKET_TCP, pxSocket, uxSocketSize + socketEVENT_GROUP_SIZE );
                 }
 
                 /* Clear the entire space to avoid nulling individual entries. */
                 ( void ) memset( pxSocket, 0, uxSocketSize );
 
-                pxSocket->xEventGroup = xEventGroup;
+                #if ( ipconfigSOCKET_USES_NOTIFY == 0 )
+                    {
+                        pxSocket->xEventGroup = xEventGroup;
+                    }
+                #endif
+
+                #if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+                    {
+                        pxSocket->ucStaticSocket = ( uint8_t ) xUserMemory;
+                    }
+                #endif
 
                 /* Initialise the socket's members.  The semaphore will be created
                  * if the socket is bound to an address, for now the pointer to the
@@ -448,6 +970,15 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
                 vListInitialiseItem( &( pxSocket->xBoundSocketListItem ) );
                 listSET_LIST_ITEM_OWNER( &( pxSocket->xBoundSocketListItem ), ipPOINTER_CAST( void *, pxSocket ) );
 
+                #if ( ipconfigSUPPORT_EPOLL == 1 )
+                    {
+                        vListInitialiseItem( &( pxSocket->xEPollMemberItem ) );
+                        listSET_LIST_ITEM_OWNER( &( pxSocket->xEPollMemberItem ), ipPOINTER_CAST( void *, pxSocket ) );
+                        vListInitialiseItem( &( pxSocket->xEPollReadyItem ) );
+                        listSET_LIST_ITEM_OWNER( &( pxSocket->xEPollReadyItem ), ipPOINTER_CAST( void *, pxSocket ) );
+                    }
+                #endif /* ipconfigSUPPORT_EPOLL */
+
                 pxSocket->xReceiveBlockTime = ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME;
                 pxSocket->xSendBlockTime = ipconfigSOCK_DEFAULT_SEND_BLOCK_TIME;
                 pxSocket->ucSocketOptions = ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT;
@@ -488,6 +1019,8 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
 
     /* Remove compiler warnings in the case the configASSERT() is not defined. */
     ( void ) xDomain;
+    /* Not used when there is no event group to create and no static sockets. */
+    ( void ) xUserMemory;
 
     return xReturn;
 }
@@ -627,176 +1160,615 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
     }
 
 
-#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
-/*-----------------------------------------------------------*/
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+/*-----------------------------------------------------------*/
+
+
+#if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+/**
+ * @brief Test if a socket belongs to a socket-set and if so, which event bit(s)
+ *        are set.
+ *
+ * @param[in] xSocket: The socket of interest.
+ * @param[in] xSocketSet: The socket set to which the socket belongs.
+ *
+ * @return If the socket belongs to the socket set: the event bits, otherwise zero.
+ */
+    EventBits_t FreeRTOS_FD_ISSET( Socket_t xSocket,
+                                   SocketSet_t xSocketSet )
+    {
+        EventBits_t xReturn;
+        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+
+        configASSERT( pxSocket != NULL );
+        configASSERT( xSocketSet != NULL );
+
+        if( xSocketSet == ( SocketSet_t ) pxSocket->pxSocketSet )
+        {
+            /* Make sure we're not adding bits which are reserved for internal
+             * use. */
+            xReturn = pxSocket->xSocketBits & ( ( EventBits_t ) eSELECT_ALL );
+        }
+        else
+        {
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+
+
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+/**
+ * @brief The select() statement: wait for an event to occur on any of the sockets
+ *        included in a socket set.
+ *
+ * @param[in] xSocketSet: The socket set including the sockets on which we are
+ *                        waiting for an event to occur.
+ * @param[in] xBlockTimeTicks: Maximum time ticks to wait for an event to occur.
+ *                   If the value is 'portMAX_DELAY' then the function will wait
+ *                   indefinitely for an event to occur.
+ *
+ * @return The socket which might have triggered the event bit.
+ */
+    BaseType_t FreeRTOS_select( SocketSet_t xSocketSet,
+                                TickType_t xBlockTimeTicks )
+    {
+        TimeOut_t xTimeOut;
+        TickType_t xRemainingTime;
+        SocketSelect_t * pxSocketSet = ( SocketSelect_t * ) xSocketSet;
+        EventBits_t uxResult;
+
+        configASSERT( xSocketSet != NULL );
+
+        /* Only in the first round, check for non-blocking */
+        xRemainingTime = xBlockTimeTicks;
+
+        /* Fetch the current time */
+        vTaskSetTimeOutState( &xTimeOut );
+
+        for( ; ; )
+        {
+            /* Find a socket which might have triggered the bit
+             * This function might return immediately or block for a limited time */
+            uxResult = xEventGroupWaitBits( pxSocketSet->xSelectGroup, ( ( EventBits_t ) eSELECT_ALL ), pdFALSE, pdFALSE, xRemainingTime );
+
+            #if ( ipconfigSUPPORT_SIGNALS != 0 )
+                {
+                    if( ( uxResult & ( ( EventBits_t ) eSELECT_INTR ) ) != 0U )
+                    {
+                        ( void ) xEventGroupClearBits( pxSocketSet->xSelectGroup, ( EventBits_t ) eSELECT_INTR );
+                        FreeRTOS_debug_printf( ( "FreeRTOS_select: interrupted\n" ) );
+                        break;
+                    }
+                }
+            #endif /* ipconfigSUPPORT_SIGNALS */
+
+            /* Have the IP-task find the socket which had an event */
+            prvFindSelectedSocket( pxSocketSet );
+
+            uxResult = xEventGroupGetBits( pxSocketSet->xSelectGroup );
+
+            if( uxResult != 0U )
+            {
+                break;
+            }
+
+            /* Has the timeout been reached? */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+            {
+                break;
+            }
+        }
+
+        return ( BaseType_t ) uxResult;
+    }
+
+
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+/**
+ * @brief Send a message to the IP-task to have it check all sockets belonging to
+ *        'pxSocketSet'
+ *
+ * @param[in] pxSocketSet: The socket set being asked to check.
+ */
+    static void prvFindSelectedSocket( SocketSelect_t * pxSocketSet )
+    {
+        IPStackEvent_t xSelectEvent;
+
+        #if ( ipconfigSELECT_USES_NOTIFY != 0 )
+            SocketSelectMessage_t xSelectMessage;
+        #endif
+
+        xSelectEvent.eEventType = eSocketSelectEvent;
+        #if ( ipconfigSELECT_USES_NOTIFY != 0 )
+            {
+                xSelectMessage.pxSocketSet = pxSocketSet;
+                xSelectMessage.xTaskhandle = xTaskGetCurrentTaskHandle();
+                xSelectEvent.pvData = &( xSelectMessage );
+            }
+        #else
+            {
+                xSelectEvent.pvData = pxSocketSet;
+
+                /* while the IP-task works on the request, the API will block on
+                 * 'eSELECT_CALL_IP'.  So clear it first. */
+                ( void ) xEventGroupClearBits( pxSocketSet->xSelectGroup, ( BaseType_t ) eSELECT_CALL_IP );
+            }
+        #endif /* if ( ipconfigSELECT_USES_NOTIFY != 0 ) */
+
+        /* Now send the socket select event */
+        if( xSendEventStructToIPTask( &xSelectEvent, ( TickType_t ) portMAX_DELAY ) == pdFAIL )
+        {
+            /* Oops, we failed to wake-up the IP task. No use to wait for it. */
+            FreeRTOS_debug_printf( ( "prvFindSelectedSocket: failed\n" ) );
+        }
+        else
+        {
+            /* As soon as the IP-task is ready, it will set 'eSELECT_CALL_IP' to
+             * wakeup the calling API */
+            #if ( ipconfigSELECT_USES_NOTIFY != 0 )
+                {
+                    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+                }
+            #else
+                {
+                    ( void ) xEventGroupWaitBits( pxSocketSet->xSelectGroup, ( BaseType_t ) eSELECT_CALL_IP, pdTRUE, pdFALSE, portMAX_DELAY );
+                }
+            #endif
+        }
+    }
+
+
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSUPPORT_EPOLL == 1 )
+
+/** @brief The bit in the event group of an epoll set that is set when a socket
+ * is added to its ready list. */
+    #define socketEPOLL_READY_BIT    ( ( EventBits_t ) 0x0001U )
+
+/** @brief The events that can be registered with FreeRTOS_epoll_ctl(). */
+    #define socketEPOLL_EVENTS       ( ( EventBits_t ) eSELECT_READ | ( EventBits_t ) eSELECT_WRITE | ( EventBits_t ) eSELECT_EXCEPT )
+
+/**
+ * @brief Function to cast pointers to SocketEPoll_t.
+ */
+    static portINLINE ipDECL_CAST_PTR_FUNC_FOR_TYPE( SocketEPoll_t )
+    {
+        return ( SocketEPoll_t * ) pvArgument;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Create an epoll set.
+ *
+ * @return The new epoll set, or NULL when there was not enough memory.
+ */
+    EPollSet_t FreeRTOS_epoll_create( void )
+    {
+        SocketEPoll_t * pxEPoll;
+
+        pxEPoll = ipCAST_PTR_TO_TYPE_PTR( SocketEPoll_t, pvPortMalloc( sizeof( *pxEPoll ) ) );
+
+        if( pxEPoll != NULL )
+        {
+            ( void ) memset( pxEPoll, 0, sizeof( *pxEPoll ) );
+            pxEPoll->xWaitGroup = xEventGroupCreate();
+
+            if( pxEPoll->xWaitGroup == NULL )
+            {
+                vPortFree( pxEPoll );
+                pxEPoll = NULL;
+            }
+            else
+            {
+                vListInitialise( &( pxEPoll->xMemberList ) );
+                vListInitialise( &( pxEPoll->xReadyList ) );
+                /* Lint wants at least a comment, in case the macro is empty. */
+                iptraceMEM_STATS_CREATE( tcpSOCKET_SET, pxEPoll, sizeof( *pxEPoll ) + sizeof( StaticEventGroup_t ) );
+            }
+        }
+
+        return ( EPollSet_t ) pxEPoll;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Delete an epoll set.  The sockets that are still registered to it are
+ *        unregistered, they are not closed.  No task may be waiting on the set.
+ *
+ * @param[in] xEPollSet: The epoll set being deleted.
+ */
+    void FreeRTOS_epoll_delete( EPollSet_t xEPollSet )
+    {
+        SocketEPoll_t * pxEPoll = ( SocketEPoll_t * ) xEPollSet;
+        FreeRTOS_Socket_t * pxSocket;
+
+        configASSERT( pxEPoll != NULL );
+
+        vTaskSuspendAll();
+        {
+            while( listCURRENT_LIST_LENGTH( &( pxEPoll->xMemberList ) ) > 0U )
+            {
+                pxSocket = ipCAST_PTR_TO_TYPE_PTR( FreeRTOS_Socket_t, listGET_OWNER_OF_HEAD_ENTRY( &( pxEPoll->xMemberList ) ) );
+                prvEPollRemove( pxSocket );
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        iptraceMEM_STATS_DELETE( pxEPoll );
+        vEventGroupDelete( pxEPoll->xWaitGroup );
+        vPortFree( pxEPoll );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Register a socket to an epoll set, change its registration, or
+ *        unregister it.
+ *
+ * @param[in] xEPollSet: The epoll set.
+ * @param[in] xOperation: FREERTOS_EPOLL_CTL_ADD, FREERTOS_EPOLL_CTL_MOD, or
+ *                        FREERTOS_EPOLL_CTL_DEL.
+ * @param[in] xSocket: The socket.
+ * @param[in] xEvents: The events of interest, a combination of eSELECT_READ,
+ *                     eSELECT_WRITE and eSELECT_EXCEPT, and optionally
+ *                     FREERTOS_EPOLL_EDGE.  Not used by FREERTOS_EPOLL_CTL_DEL.
+ * @param[in] pvData: The value that FreeRTOS_epoll_wait() will return along with
+ *                    the socket.  Not used by FREERTOS_EPOLL_CTL_DEL.
+ *
+ * @return 0 on success, otherwise -pdFREERTOS_ERRNO_EINVAL for a bad parameter,
+ *         -pdFREERTOS_ERRNO_EEXIST when the socket was registered already,
+ *         -pdFREERTOS_ERRNO_EBUSY when the socket belongs to a socket set, or
+ *         -pdFREERTOS_ERRNO_ENOENT when the socket is not registered to the set.
+ */
+    BaseType_t FreeRTOS_epoll_ctl( EPollSet_t xEPollSet,
+                                   BaseType_t xOperation,
+                                   Socket_t xSocket,
+                                   EventBits_t xEvents,
+                                   void * pvData )
+    {
+        SocketEPoll_t * pxEPoll = ( SocketEPoll_t * ) xEPollSet;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        EventBits_t xReady;
+        BaseType_t xReturn = 0;
+
+        if( ( pxEPoll == NULL ) || ( xSocket == NULL ) || ( xSocket == FREERTOS_INVALID_SOCKET ) )
+        {
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            vTaskSuspendAll();
+            {
+                switch( xOperation )
+                {
+                    case FREERTOS_EPOLL_CTL_ADD:
+
+                        if( pxSocket->pxEPollSet != NULL )
+                        {
+                            xReturn = -pdFREERTOS_ERRNO_EEXIST;
+                        }
+                        else if( pxSocket->pxSocketSet != NULL )
+                        {
+                            /* The socket set uses the same event bits. */
+                            xReturn = -pdFREERTOS_ERRNO_EBUSY;
+                        }
+                        else
+                        {
+                            pxSocket->pxEPollSet = pxEPoll;
+                            pxSocket->xEPollEvents = 0U;
+                            vListInsertEnd( &( pxEPoll->xMemberList ), &( pxSocket->xEPollMemberItem ) );
+                        }
+
+                        break;
+
+                    case FREERTOS_EPOLL_CTL_MOD:
+                    case FREERTOS_EPOLL_CTL_DEL:
+
+                        if( pxSocket->pxEPollSet != pxEPoll )
+                        {
+                            xReturn = -pdFREERTOS_ERRNO_ENOENT;
+                        }
+                        else if( xOperation == FREERTOS_EPOLL_CTL_DEL )
+                        {
+                            prvEPollRemove( pxSocket );
+                        }
+                        else
+                        {
+                            /* The events will be changed here below. */
+                        }
+
+                        break;
+
+                    default:
+                        xReturn = -pdFREERTOS_ERRNO_EINVAL;
+                        break;
+                }
+
+                if( ( xReturn == 0 ) && ( xOperation != FREERTOS_EPOLL_CTL_DEL ) )
+                {
+                    /* The IP-task will only signal the events of interest. */
+                    pxSocket->xSelectBits = xEvents & ( socketEPOLL_EVENTS | ( EventBits_t ) FREERTOS_EPOLL_EDGE );
+                    pxSocket->pvEPollData = pvData;
+
+                    /* A socket that is ready already must be reported, also
+                     * in the edge-triggered mode. */
+                    xReady = prvEPollReadiness( pxSocket );
+
+                    if( xReady != 0U )
+                    {
+                        pxSocket->xEPollEvents |= xReady;
+
+                        if( listLIST_ITEM_CONTAINER( &( pxSocket->xEPollReadyItem ) ) == NULL )
+                        {
+                            vListInsertEnd( &( pxEPoll->xReadyList ), &( pxSocket->xEPollReadyItem ) );
+                        }
 
+                        ( void ) xEventGroupSetBits( pxEPoll->xWaitGroup, socketEPOLL_READY_BIT );
+                    }
+                }
+            }
+            ( void ) xTaskResumeAll();
+        }
 
-#if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
 
 /**
- * @brief Test if a socket belongs to a socket-set and if so, which event bit(s)
- *        are set.
+ * @brief Wait until one or more of the sockets in an epoll set are ready.
  *
- * @param[in] xSocket: The socket of interest.
- * @param[in] xSocketSet: The socket set to which the socket belongs.
+ * @param[in] xEPollSet: The epoll set.
+ * @param[out] pxEvents: The array that receives the sockets that are ready.
+ * @param[in] xMaxEvents: The number of elements in pxEvents.
+ * @param[in] xBlockTimeTicks: Maximum time ticks to wait for a socket to become
+ *                             ready.  Zero means: do not block.
  *
- * @return If the socket belongs to the socket set: the event bits, otherwise zero.
+ * @return The number of sockets that were stored in pxEvents, zero after a
+ *         time-out, or -pdFREERTOS_ERRNO_EINVAL for a bad parameter.
  */
-    EventBits_t FreeRTOS_FD_ISSET( Socket_t xSocket,
-                                   SocketSet_t xSocketSet )
+    BaseType_t FreeRTOS_epoll_wait( EPollSet_t xEPollSet,
+                                    EPollEvent_t * pxEvents,
+                                    BaseType_t xMaxEvents,
+                                    TickType_t xBlockTimeTicks )
     {
-        EventBits_t xReturn;
-        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
-
-        configASSERT( pxSocket != NULL );
-        configASSERT( xSocketSet != NULL );
+        SocketEPoll_t * pxEPoll = ( SocketEPoll_t * ) xEPollSet;
+        TimeOut_t xTimeOut;
+        TickType_t xRemainingTime = xBlockTimeTicks;
+        BaseType_t xReturn;
 
-        if( xSocketSet == ( SocketSet_t ) pxSocket->pxSocketSet )
+        if( ( pxEPoll == NULL ) || ( pxEvents == NULL ) || ( xMaxEvents <= 0 ) )
         {
-            /* Make sure we're not adding bits which are reserved for internal
-             * use. */
-            xReturn = pxSocket->xSocketBits & ( ( EventBits_t ) eSELECT_ALL );
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
         }
         else
         {
-            xReturn = 0;
+            vTaskSetTimeOutState( &xTimeOut );
+
+            for( ; ; )
+            {
+                /* Clear the bit before looking at the ready list, so a socket
+                 * that becomes ready later on will set it again. */
+                ( void ) xEventGroupClearBits( pxEPoll->xWaitGroup, socketEPOLL_READY_BIT );
+
+                xReturn = prvEPollHarvest( pxEPoll, pxEvents, xMaxEvents );
+
+                if( xReturn != 0 )
+                {
+                    break;
+                }
+
+                /* Has the timeout been reached? */
+                if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+                {
+                    break;
+                }
+
+                ( void ) xEventGroupWaitBits( pxEPoll->xWaitGroup, socketEPOLL_READY_BIT, pdFALSE, pdFALSE, xRemainingTime );
+            }
         }
 
         return xReturn;
     }
+    /*-----------------------------------------------------------*/
 
+/**
+ * @brief Called by the IP-task when events occur on a socket that is registered
+ *        to an epoll set: put the socket in the ready list and wake up the
+ *        waiting task.
+ *
+ * @param[in] pxSocket: The socket.
+ * @param[in] xEvents: The events that occurred, see eSelectEvent_t.
+ */
+    void vSocketEPollSignal( FreeRTOS_Socket_t * pxSocket,
+                             EventBits_t xEvents )
+    {
+        SocketEPoll_t * pxEPoll;
 
-#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
-/*-----------------------------------------------------------*/
+        vTaskSuspendAll();
+        {
+            /* The user might have unregistered the socket in the mean time. */
+            pxEPoll = pxSocket->pxEPollSet;
 
-#if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+            if( ( pxEPoll != NULL ) && ( ( xEvents & pxSocket->xSelectBits & socketEPOLL_EVENTS ) != 0U ) )
+            {
+                pxSocket->xEPollEvents |= xEvents & pxSocket->xSelectBits & socketEPOLL_EVENTS;
+
+                if( listLIST_ITEM_CONTAINER( &( pxSocket->xEPollReadyItem ) ) == NULL )
+                {
+                    vListInsertEnd( &( pxEPoll->xReadyList ), &( pxSocket->xEPollReadyItem ) );
+                }
+
+                ( void ) xEventGroupSetBits( pxEPoll->xWaitGroup, socketEPOLL_READY_BIT );
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+    /*-----------------------------------------------------------*/
 
 /**
- * @brief The select() statement: wait for an event to occur on any of the sockets
- *        included in a socket set.
+ * @brief Return the events of interest for which a socket is ready at this
+ *        moment.  This is the same test as in vSocketSelect(), without its
+ *        side effects, because it is called from the user's task.
  *
- * @param[in] xSocketSet: The socket set including the sockets on which we are
- *                        waiting for an event to occur.
- * @param[in] xBlockTimeTicks: Maximum time ticks to wait for an event to occur.
- *                   If the value is 'portMAX_DELAY' then the function will wait
- *                   indefinitely for an event to occur.
+ * @param[in] pxSocket: The socket to be checked.
  *
- * @return The socket which might have triggered the event bit.
+ * @return The events for which the socket is ready, see eSelectEvent_t.
  */
-    BaseType_t FreeRTOS_select( SocketSet_t xSocketSet,
-                                TickType_t xBlockTimeTicks )
+    static EventBits_t prvEPollReadiness( const FreeRTOS_Socket_t * pxSocket )
     {
-        TimeOut_t xTimeOut;
-        TickType_t xRemainingTime;
-        SocketSelect_t * pxSocketSet = ( SocketSelect_t * ) xSocketSet;
-        EventBits_t uxResult;
-
-        configASSERT( xSocketSet != NULL );
-
-        /* Only in the first round, check for non-blocking */
-        xRemainingTime = xBlockTimeTicks;
+        EventBits_t xReady = 0U;
 
-        /* Fetch the current time */
-        vTaskSetTimeOutState( &xTimeOut );
-
-        for( ; ; )
-        {
-            /* Find a socket which might have triggered the bit
-             * This function might return immediately or block for a limited time */
-            uxResult = xEventGroupWaitBits( pxSocketSet->xSelectGroup, ( ( EventBits_t ) eSELECT_ALL ), pdFALSE, pdFALSE, xRemainingTime );
+        #if ( ipconfigUSE_TCP == 1 )
+            if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+            {
+                /* A socket that was not accepted yet is of no use to the user. */
+                BaseType_t xAccepted = ( ( pxSocket->u.xTCP.bits.bPassQueued == pdFALSE_UNSIGNED ) &&
+                                         ( pxSocket->u.xTCP.bits.bPassAccept == pdFALSE_UNSIGNED ) ) ? pdTRUE : pdFALSE;
 
-            #if ( ipconfigSUPPORT_SIGNALS != 0 )
+                if( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eTCP_LISTEN )
                 {
-                    if( ( uxResult & ( ( EventBits_t ) eSELECT_INTR ) ) != 0U )
+                    if( ( pxSocket->u.xTCP.pxPeerSocket != NULL ) && ( pxSocket->u.xTCP.pxPeerSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) )
                     {
-                        ( void ) xEventGroupClearBits( pxSocketSet->xSelectGroup, ( EventBits_t ) eSELECT_INTR );
-                        FreeRTOS_debug_printf( ( "FreeRTOS_select: interrupted\n" ) );
-                        break;
+                        xReady |= ( EventBits_t ) eSELECT_READ;
                     }
                 }
-            #endif /* ipconfigSUPPORT_SIGNALS */
-
-            /* Have the IP-task find the socket which had an event */
-            prvFindSelectedSocket( pxSocketSet );
+                else if( ( pxSocket->u.xTCP.bits.bReuseSocket != pdFALSE_UNSIGNED ) && ( pxSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) )
+                {
+                    xReady |= ( EventBits_t ) eSELECT_READ;
+                }
+                else if( ( xAccepted != pdFALSE ) && ( FreeRTOS_recvcount( pxSocket ) > 0 ) )
+                {
+                    xReady |= ( EventBits_t ) eSELECT_READ;
+                }
+                else
+                {
+                    /* Nothing to read. */
+                }
 
-            uxResult = xEventGroupGetBits( pxSocketSet->xSelectGroup );
+                if( ( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eCLOSE_WAIT ) || ( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eCLOSED ) )
+                {
+                    xReady |= ( EventBits_t ) eSELECT_EXCEPT;
+                }
 
-            if( uxResult != 0U )
-            {
-                break;
+                if( ( xAccepted != pdFALSE ) &&
+                    ( pxSocket->u.xTCP.ucTCPState >= ( uint8_t ) eESTABLISHED ) &&
+                    ( FreeRTOS_tx_space( pxSocket ) > 0 ) )
+                {
+                    xReady |= ( EventBits_t ) eSELECT_WRITE;
+                }
             }
-
-            /* Has the timeout been reached? */
-            if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+            else
+        #endif /* ipconfigUSE_TCP == 1 */
+        {
+            /* UDP sockets can only be read. */
+            if( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) > 0U )
             {
-                break;
+                xReady |= ( EventBits_t ) eSELECT_READ;
             }
         }
 
-        return ( BaseType_t ) uxResult;
+        return xReady & pxSocket->xSelectBits;
     }
-
-
-#endif /* ipconfigSUPPORT_SELECT_FUNCTION */
-/*-----------------------------------------------------------*/
-
-#if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+    /*-----------------------------------------------------------*/
 
 /**
- * @brief Send a message to the IP-task to have it check all sockets belonging to
- *        'pxSocketSet'
+ * @brief Take the sockets that have events to report from the ready list of an
+ *        epoll set.  An edge-triggered socket leaves the list once its events
+ *        have been reported.  A level-triggered socket is checked again, and it
+ *        stays at the end of the list for as long as it is ready.
  *
- * @param[in] pxSocketSet: The socket set being asked to check.
+ * @param[in] pxEPoll: The epoll set.
+ * @param[out] pxEvents: The array that receives the sockets that are ready.
+ * @param[in] xMaxEvents: The number of elements in pxEvents.
+ *
+ * @return The number of sockets stored in pxEvents.
  */
-    static void prvFindSelectedSocket( SocketSelect_t * pxSocketSet )
+    static BaseType_t prvEPollHarvest( SocketEPoll_t * pxEPoll,
+                                       EPollEvent_t * pxEvents,
+                                       BaseType_t xMaxEvents )
     {
-        IPStackEvent_t xSelectEvent;
+        FreeRTOS_Socket_t * pxSocket;
+        EventBits_t xEvents;
+        UBaseType_t uxCount;
+        BaseType_t xCount = 0;
 
-        #if ( ipconfigSELECT_USES_NOTIFY != 0 )
-            SocketSelectMessage_t xSelectMessage;
-        #endif
+        vTaskSuspendAll();
+        {
+            /* Look at each socket at most once, level-triggered sockets are
+             * put back at the end of the list. */
+            uxCount = listCURRENT_LIST_LENGTH( &( pxEPoll->xReadyList ) );
 
-        xSelectEvent.eEventType = eSocketSelectEvent;
-        #if ( ipconfigSELECT_USES_NOTIFY != 0 )
-            {
-                xSelectMessage.pxSocketSet = pxSocketSet;
-                xSelectMessage.xTaskhandle = xTaskGetCurrentTaskHandle();
-                xSelectEvent.pvData = &( xSelectMessage );
-            }
-        #else
+            while( ( uxCount > 0U ) && ( xCount < xMaxEvents ) )
             {
-                xSelectEvent.pvData = pxSocketSet;
+                uxCount--;
+                pxSocket = ipCAST_PTR_TO_TYPE_PTR( FreeRTOS_Socket_t, listGET_OWNER_OF_HEAD_ENTRY( &( pxEPoll->xReadyList ) ) );
+                ( void ) uxListRemove( &( pxSocket->xEPollReadyItem ) );
 
-                /* while the IP-task works on the request, the API will block on
-                 * 'eSELECT_CALL_IP'.  So clear it first. */
-                ( void ) xEventGroupClearBits( pxSocketSet->xSelectGroup, ( BaseType_t ) eSELECT_CALL_IP );
-            }
-        #endif /* if ( ipconfigSELECT_USES_NOTIFY != 0 ) */
-
-        /* Now send the socket select event */
-        if( xSendEventStructToIPTask( &xSelectEvent, ( TickType_t ) portMAX_DELAY ) == pdFAIL )
-        {
-            /* Oops, we failed to wake-up the IP task. No use to wait for it. */
-            FreeRTOS_debug_printf( ( "prvFindSelectedSocket: failed\n" ) );
-        }
-        else
-        {
-            /* As soon as the IP-task is ready, it will set 'eSELECT_CALL_IP' to
-             * wakeup the calling API */
-            #if ( ipconfigSELECT_USES_NOTIFY != 0 )
+                if( ( pxSocket->xSelectBits & ( EventBits_t ) FREERTOS_EPOLL_EDGE ) != 0U )
                 {
-                    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+                    xEvents = pxSocket->xEPollEvents & pxSocket->xSelectBits;
                 }
-            #else
+                else
                 {
-                    ( void ) xEventGroupWaitBits( pxSocketSet->xSelectGroup, ( BaseType_t ) eSELECT_CALL_IP, pdTRUE, pdFALSE, portMAX_DELAY );
+                    /* Report the current state, which may have changed since
+                     * the socket was signalled. */
+                    xEvents = prvEPollReadiness( pxSocket );
+
+                    if( xEvents != 0U )
+                    {
+                        vListInsertEnd( &( pxEPoll->xReadyList ), &( pxSocket->xEPollReadyItem ) );
+                    }
                 }
-            #endif
+
+                pxSocket->xEPollEvents = 0U;
+
+                if( xEvents != 0U )
+                {
+                    pxEvents[ xCount ].xSocket = ( Socket_t ) pxSocket;
+                    pxEvents[ xCount ].xEvents = xEvents;
+                    pxEvents[ xCount ].pvData = pxSocket->pvEPollData;
+                    xCount++;
+                }
+            }
         }
+        ( void ) xTaskResumeAll();
+
+        return xCount;
     }
+    /*-----------------------------------------------------------*/
 
+/**
+ * @brief Unregister a socket from its epoll set.  The scheduler must be
+ *        suspended by the caller.
+ *
+ * @param[in] pxSocket: The socket.
+ */
+    static void prvEPollRemove( FreeRTOS_Socket_t * pxSocket )
+    {
+        if( listLIST_ITEM_CONTAINER( &( pxSocket->xEPollReadyItem ) ) != NULL )
+        {
+            ( void ) uxListRemove( &( pxSocket->xEPollReadyItem ) );
+        }
 
-#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+        ( void ) uxListRemove( &( pxSocket->xEPollMemberItem ) );
+        pxSocket->pxEPollSet = NULL;
+        pxSocket->xSelectBits = 0U;
+        pxSocket->xEPollEvents = 0U;
+    }
+
+#endif /* ipconfigSUPPORT_EPOLL == 1 */
 /*-----------------------------------------------------------*/
 
 /**
@@ -828,7 +1800,7 @@ int32_t FreeRTOS_recvfrom( Socket_t xSocket,
     BaseType_t lPacketCount;
     NetworkBufferDescriptor_t * pxNetworkBuffer;
     const void * pvCopySource;
-    FreeRTOS_Socket_t const * pxSocket = xSocket;
+    FreeRTOS_Socket_t * pxSocket = xSocket;
     TickType_t xRemainingTime = ( TickType_t ) 0; /* Obsolete assignment, but some compilers output a warning if its not done. */
     BaseType_t xTimed = pdFALSE;
     TimeOut_t xTimeOut;
@@ -861,8 +1833,7 @@ int32_t FreeRTOS_recvfrom( Socket_t xSocket,
                     #if ( ipconfigSUPPORT_SIGNALS != 0 )
                         {
                             /* Just check for the interrupt flag. */
-                            xEventBits = xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_INTR,
-                                                              pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, socketDONT_BLOCK );
+                            xEventBits = xSocketWaitEvents( pxSocket, ( EventBits_t ) eSOCKET_INTR, socketDONT_BLOCK );
                         }
                     #endif /* ipconfigSUPPORT_SIGNALS */
                     break;
@@ -883,8 +1854,7 @@ int32_t FreeRTOS_recvfrom( Socket_t xSocket,
             /* Wait for arrival of data.  While waiting, the IP-task may set the
              * 'eSOCKET_RECEIVE' bit in 'xEventGroup', if it receives data for this
              * socket, thus unblocking this API call. */
-            xEventBits = xEventGroupWaitBits( pxSocket->xEventGroup, ( ( EventBits_t ) eSOCKET_RECEIVE ) | ( ( EventBits_t ) eSOCKET_INTR ),
-                                              pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
+            xEventBits = xSocketWaitEvents( pxSocket, ( ( EventBits_t ) eSOCKET_RECEIVE ) | ( ( EventBits_t ) eSOCKET_INTR ), xRemainingTime );
 
             #if ( ipconfigSUPPORT_SIGNALS != 0 )
                 {
@@ -893,7 +1863,7 @@ int32_t FreeRTOS_recvfrom( Socket_t xSocket,
                         if( ( xEventBits & ( EventBits_t ) eSOCKET_RECEIVE ) != 0U )
                         {
                             /* Shouldn't have cleared the eSOCKET_RECEIVE flag. */
-                            ( void ) xEventGroupSetBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_RECEIVE );
+                            vSocketSetEvents( pxSocket, ( EventBits_t ) eSOCKET_RECEIVE );
                         }
 
                         break;
@@ -1132,6 +2102,12 @@ int32_t FreeRTOS_sendto( Socket_t xSocket,
                  * space that will eventually get used by the Ethernet header. */
                 pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = pxSocket->ucSocketOptions;
 
+                #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+                    {
+                        prvSetDestinationMAC( pxSocket, pxNetworkBuffer );
+                    }
+                #endif
+
                 /* Tell the networking task that the packet needs sending. */
                 xStackTxEvent.pvData = pxNetworkBuffer;
 
@@ -1186,6 +2162,62 @@ int32_t FreeRTOS_sendto( Socket_t xSocket,
 } /* Tested */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+
+/**
+ * @brief Copy the MAC-address that the socket stored for the destination of a
+ *        packet into its Ethernet header, so that the IP-task does not need to
+ *        look it up.  The generation of the stored MAC-address is passed along,
+ *        the IP-task will check whether it is still valid.  The entry is only
+ *        changed by the IP-task, which makes its sequence number odd while
+ *        doing so.  The copy is only used when the sequence number was even,
+ *        and unchanged after copying.
+ *
+ * @param[in] pxSocket: The UDP socket that sends the packet.
+ * @param[in] pxNetworkBuffer: The packet, ulIPAddress holds the destination.
+ */
+    static void prvSetDestinationMAC( const FreeRTOS_Socket_t * pxSocket,
+                                      NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        EthernetHeader_t * pxEthernetHeader = ipCAST_PTR_TO_TYPE_PTR( EthernetHeader_t, pxNetworkBuffer->pucEthernetBuffer );
+        uint32_t ulSequence = pxSocket->u.xUDP.ulDestinationSequence;
+        uint32_t ulGeneration = 0U;
+        uint32_t ulDestinationIP;
+
+        if( ( ulSequence & 1U ) == 0U )
+        {
+            ipMEMORY_BARRIER();
+
+            ulGeneration = pxSocket->u.xUDP.ulDestinationGeneration;
+            ulDestinationIP = pxSocket->u.xUDP.ulDestinationIP;
+            ( void ) memcpy( pxEthernetHeader->xDestinationAddress.ucBytes, pxSocket->u.xUDP.xDestinationMAC.ucBytes, sizeof( pxEthernetHeader->xDestinationAddress.ucBytes ) );
+
+            ipMEMORY_BARRIER();
+
+            if( pxSocket->u.xUDP.ulDestinationSequence != ulSequence )
+            {
+                /* The IP-task has changed the entry while it was being copied. */
+                ulGeneration = 0U;
+            }
+            else if( ( ulDestinationIP != pxNetworkBuffer->ulIPAddress ) ||
+                     ( ulGeneration != ulARPGetGeneration() ) )
+            {
+                /* The entry is about another destination, or it is outdated. */
+                ulGeneration = 0U;
+            }
+            else
+            {
+                /* The MAC-address belongs to the destination, as long as the
+                 * generation does not change. */
+            }
+        }
+
+        ( void ) memcpy( &( pxNetworkBuffer->pucEthernetBuffer[ ipDESTINATION_GENERATION_OFFSET ] ), &( ulGeneration ), sizeof( ulGeneration ) );
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_DESTINATION_CACHE */
+
 /**
  * @brief binds a socket to a local port number. If port 0 is provided,
  *        a system provided port number will be assigned. This function
@@ -1258,7 +2290,7 @@ BaseType_t FreeRTOS_bind( Socket_t xSocket,
         {
             /* The IP-task will set the 'eSOCKET_BOUND' bit when it has done its
              * job. */
-            ( void ) xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_BOUND, pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, portMAX_DELAY );
+            ( void ) xSocketWaitEvents( pxSocket, ( EventBits_t ) eSOCKET_BOUND, portMAX_DELAY );
 
             if( !socketSOCKET_IS_BOUND( pxSocket ) )
             {
@@ -1477,6 +2509,18 @@ BaseType_t FreeRTOS_closesocket( Socket_t xSocket )
         /* Let the IP task close the socket to keep it synchronised with the
          * packet handling. */
 
+        #if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+            {
+                FreeRTOS_Socket_t * pxStaticSocket = ( FreeRTOS_Socket_t * ) xSocket;
+
+                if( ( pxStaticSocket->ucStaticSocket != pdFALSE_UNSIGNED ) && ( xIsCallingFromIPTask() == pdFALSE ) )
+                {
+                    /* Ask the IP-task to tell when the memory can be used again. */
+                    pxStaticSocket->xCloseTask = xTaskGetCurrentTaskHandle();
+                }
+            }
+        #endif /* ipconfigSUPPORT_STATIC_SOCKETS */
+
         /* The timeout value below is only used if this function is called from
          * a user task. If this function is called by the IP-task, it may fail
          * to close the socket when the event queue is full.
@@ -1488,6 +2532,12 @@ BaseType_t FreeRTOS_closesocket( Socket_t xSocket )
         }
         else
         {
+            #if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+                {
+                    prvStaticSocketWaitClosed( ( FreeRTOS_Socket_t * ) xSocket );
+                }
+            #endif
+
             xResult = 1;
         }
     }
@@ -1528,21 +2578,43 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
                 if( pxSocket->u.xTCP.rxStream != NULL )
                 {
                     iptraceMEM_STATS_DELETE( pxSocket->u.xTCP.rxStream );
-                    vPortFreeLarge( pxSocket->u.xTCP.rxStream );
+                    prvTCPFreeStream( pxSocket->u.xTCP.rxStream );
                 }
 
                 if( pxSocket->u.xTCP.txStream != NULL )
                 {
-                    iptraceMEM_STATS_DELETE( pxSocket->u.xTCP.txStream );
-                    vPortFreeLarge( pxSocket->u.xTCP.txStream );
+                    iptraceMEM_STATS_DELETE( pxSocket->u.xTCP.txStream );
+                    prvTCPFreeStream( pxSocket->u.xTCP.txStream );
+                }
+
+                #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+                    {
+                        /* Give the growth of the txStream back to the budget. */
+                        uxTxStreamBudget += pxSocket->u.xTCP.uxTxStreamGrowth;
+                        pxSocket->u.xTCP.uxTxStreamGrowth = 0U;
+                    }
+                #endif /* ipconfigUSE_TCP_TX_AUTOTUNING */
+
+                /* In case this is a child socket, make sure the child-count of the
+                 * parent socket is decreased. */
+                prvTCPSetSocketCount( pxSocket );
+            }
+        }
+    #endif /* ipconfigUSE_TCP == 1 */
+
+    #if ( ipconfigSUPPORT_EPOLL == 1 )
+        {
+            if( pxSocket->pxEPollSet != NULL )
+            {
+                /* The epoll set must forget about the socket. */
+                vTaskSuspendAll();
+                {
+                    prvEPollRemove( pxSocket );
                 }
-
-                /* In case this is a child socket, make sure the child-count of the
-                 * parent socket is decreased. */
-                prvTCPSetSocketCount( pxSocket );
+                ( void ) xTaskResumeAll();
             }
         }
-    #endif /* ipconfigUSE_TCP == 1 */
+    #endif /* ipconfigSUPPORT_EPOLL */
 
     /* Socket must be unbound first, to ensure no more packets are queued on
      * it. */
@@ -1578,10 +2650,14 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
         }
     }
 
-    if( pxSocket->xEventGroup != NULL )
-    {
-        vEventGroupDelete( pxSocket->xEventGroup );
-    }
+    #if ( ipconfigSOCKET_USES_NOTIFY == 0 )
+        {
+            if( pxSocket->xEventGroup != NULL )
+            {
+                vEventGroupDelete( pxSocket->xEventGroup );
+            }
+        }
+    #endif
 
     #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigHAS_DEBUG_PRINTF != 0 )
         {
@@ -1599,7 +2675,17 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 
     /* And finally, after all resources have been freed, free the socket space */
     iptraceMEM_STATS_DELETE( pxSocket );
-    vPortFreeSocket( pxSocket );
+    #if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+        if( pxSocket->ucStaticSocket != pdFALSE_UNSIGNED )
+        {
+            /* The memory belongs to the user, who may be waiting for it. */
+            prvStaticSocketRelease( pxSocket );
+        }
+        else
+    #endif
+    {
+        prvSocketFree( pxSocket, pdFALSE );
+    }
 
     return NULL;
 } /* Tested */
@@ -1717,6 +2803,13 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
             else
             {
                 pxSocket->u.xTCP.uxRxStreamSize = ulNewValue;
+
+                #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 )
+                    {
+                        /* The new value is the maximum, start again with a small stream. */
+                        pxSocket->u.xTCP.uxRxStreamMaxSize = 0U;
+                    }
+                #endif
             }
 
             xReturn = 0;
@@ -1949,6 +3042,46 @@ BaseType_t FreeRTOS_setsockopt( Socket_t xSocket,
                    }
                    break;
 
+                #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                    case FREERTOS_SO_TCP_ACK_POLICY: /* Set the delayed-ACK policy, parameter is pointer to TCPAckPolicy_t */
+                       {
+                           if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_TCP )
+                           {
+                               FreeRTOS_debug_printf( ( "FREERTOS_SO_TCP_ACK_POLICY: wrong socket type\n" ) );
+                               break; /* will return -pdFREERTOS_ERRNO_EINVAL */
+                           }
+
+                           pxSocket->u.xTCP.xAckPolicy = *( ipPOINTER_CAST( const TCPAckPolicy_t *, pvOptionValue ) );
+                           /* A new quick-ACK period starts, also for a connected socket. */
+                           pxSocket->u.xTCP.ucQuickAckRemaining = pxSocket->u.xTCP.xAckPolicy.ucQuickAckSegments;
+                       }
+                        xReturn = 0;
+                        break;
+                #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
+                #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                    case FREERTOS_SO_RCVLOWAT: /* Only wake up a reader when this many bytes can be read, parameter is pointer to size_t */
+                    case FREERTOS_SO_SNDLOWAT: /* Only wake up a writer when this many bytes can be written, parameter is pointer to size_t */
+                       {
+                           if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_TCP )
+                           {
+                               FreeRTOS_debug_printf( ( "FREERTOS_SO_%cLOWAT: wrong socket type\n", ( lOptionName == FREERTOS_SO_RCVLOWAT ) ? 'R' : 'S' ) );
+                               break; /* will return -pdFREERTOS_ERRNO_EINVAL */
+                           }
+
+                           if( lOptionName == FREERTOS_SO_RCVLOWAT )
+                           {
+                               pxSocket->u.xTCP.uxRcvLowat = *( ipPOINTER_CAST( const size_t *, pvOptionValue ) );
+                           }
+                           else
+                           {
+                               pxSocket->u.xTCP.uxSndLowat = *( ipPOINTER_CAST( const size_t *, pvOptionValue ) );
+                           }
+                       }
+                        xReturn = 0;
+                        break;
+                #endif /* ipconfigSOCKET_WAKE_COALESCING */
+
                 case FREERTOS_SO_SNDBUF: /* Set the size of the send buffer, in units of MSS (TCP only) */
                 case FREERTOS_SO_RCVBUF: /* Set the size of the receive buffer, in units of MSS (TCP only) */
                     xReturn = prvSockopt_so_buffer( pxSocket, lOptionName, pvOptionValue );
@@ -2806,6 +3939,16 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 {
 /* _HT_ must work this out, now vSocketWakeUpUser will be called for any important
  * event or transition */
+    #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+        {
+            if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+            {
+                pxSocket->u.xTCP.bits.bWakeDeferred = pdFALSE_UNSIGNED;
+                pxSocket->u.xTCP.xWakeStats.ulWakeUps++;
+            }
+        }
+    #endif /* ipconfigSOCKET_WAKE_COALESCING */
+
     #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
         {
             if( pxSocket->pxUserSemaphore != NULL )
@@ -2824,6 +3967,15 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         }
     #endif /* ipconfigSOCKET_HAS_USER_WAKE_CALLBACK */
 
+    #if ( ipconfigSUPPORT_EPOLL == 1 )
+        {
+            if( pxSocket->pxEPollSet != NULL )
+            {
+                vSocketEPollSignal( pxSocket, ( pxSocket->xEventBits >> SOCKET_EVENT_BIT_COUNT ) & ( ( EventBits_t ) eSELECT_ALL ) );
+            }
+        }
+    #endif /* ipconfigSUPPORT_EPOLL */
+
     #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
         {
             if( pxSocket->pxSocketSet != NULL )
@@ -2841,13 +3993,175 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         }
     #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 
-    if( ( pxSocket->xEventGroup != NULL ) && ( pxSocket->xEventBits != 0U ) )
+    #if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+        if( pxSocket->xEventBits != 0U )
+    #else
+        if( ( pxSocket->xEventGroup != NULL ) && ( pxSocket->xEventBits != 0U ) )
+    #endif
     {
-        ( void ) xEventGroupSetBits( pxSocket->xEventGroup, pxSocket->xEventBits );
+        vSocketSetEvents( pxSocket, pxSocket->xEventBits );
     }
 
     pxSocket->xEventBits = 0U;
 }
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+
+/**
+ * @brief Remove a waiting task from the list of a socket, if it is still in it.
+ *        Must be called from a critical section.
+ *
+ * @param[in] pxSocket: The socket.
+ * @param[in] pxWaiter: The waiter to be removed.
+ */
+    static void prvSocketRemoveWaiter( FreeRTOS_Socket_t * pxSocket,
+                                       const SocketWaiter_t * pxWaiter )
+    {
+        SocketWaiter_t ** ppxLink = &( pxSocket->pxWaiters );
+
+        while( *ppxLink != NULL )
+        {
+            if( *ppxLink == pxWaiter )
+            {
+                *ppxLink = pxWaiter->pxNext;
+                break;
+            }
+
+            ppxLink = &( ( *ppxLink )->pxNext );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Wait until at least one of the given events has occurred on a socket,
+ *        or until the time expires.  This replaces xEventGroupWaitBits() with
+ *        'xClearOnExit' set and 'xWaitAllBits' cleared.  The task adds itself
+ *        to the list of waiters of the socket, and vSocketSetEvents() hands the
+ *        events to it and wakes it up with a notification at index
+ *        ipconfigSOCKET_NOTIFY_INDEX.  A notification may be left from an
+ *        earlier wait that timed out, so the result is checked after each
+ *        wake-up.
+ *
+ * @param[in] pxSocket: The socket.
+ * @param[in] xEvents: The events to wait for.
+ * @param[in] xTicksToWait: The maximum time to wait.
+ *
+ * @return The events that were found, or zero when the time expired.
+ */
+    EventBits_t xSocketWaitEvents( FreeRTOS_Socket_t * pxSocket,
+                                   EventBits_t xEvents,
+                                   TickType_t xTicksToWait )
+    {
+        SocketWaiter_t xWaiter;
+        TimeOut_t xTimeOut;
+        TickType_t xRemainingTime = xTicksToWait;
+        BaseType_t xTimedOut;
+        uint8_t ucFound;
+
+        vTaskSetTimeOutState( &xTimeOut );
+
+        taskENTER_CRITICAL();
+        {
+            ucFound = pxSocket->ucPendingEvents & ( uint8_t ) xEvents;
+
+            if( ucFound != 0U )
+            {
+                pxSocket->ucPendingEvents &= ( uint8_t ) ~ucFound;
+            }
+            else
+            {
+                xWaiter.xTask = xTaskGetCurrentTaskHandle();
+                xWaiter.ucWaitEvents = ( uint8_t ) xEvents;
+                xWaiter.ucResultEvents = 0U;
+                xWaiter.pxNext = pxSocket->pxWaiters;
+                pxSocket->pxWaiters = &( xWaiter );
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        while( ucFound == 0U )
+        {
+            xTimedOut = xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime );
+
+            if( xTimedOut == pdFALSE )
+            {
+                ( void ) ulTaskNotifyTakeIndexed( ipconfigSOCKET_NOTIFY_INDEX, pdTRUE, xRemainingTime );
+            }
+
+            taskENTER_CRITICAL();
+            {
+                /* vSocketSetEvents() removes the waiter from the list when it
+                 * hands over events. */
+                ucFound = xWaiter.ucResultEvents;
+
+                if( ( ucFound == 0U ) && ( xTimedOut != pdFALSE ) )
+                {
+                    prvSocketRemoveWaiter( pxSocket, &( xWaiter ) );
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( xTimedOut != pdFALSE )
+            {
+                break;
+            }
+        }
+
+        return ( EventBits_t ) ucFound;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Set events of a socket.  Like with an event group, the events are
+ *        handed to every task that is waiting for them, and they remain pending
+ *        when no task is waiting.
+ *
+ * @param[in] pxSocket: The socket.
+ * @param[in] xEvents: The events to be set.
+ */
+    void vSocketSetEvents( FreeRTOS_Socket_t * pxSocket,
+                           EventBits_t xEvents )
+    {
+        SocketWaiter_t ** ppxLink;
+        SocketWaiter_t * pxWaiter;
+        uint8_t ucMatch;
+        uint8_t ucHandedOver = 0U;
+
+        taskENTER_CRITICAL();
+        {
+            pxSocket->ucPendingEvents |= ( uint8_t ) ( xEvents & ( EventBits_t ) eSOCKET_ALL );
+            ppxLink = &( pxSocket->pxWaiters );
+
+            while( *ppxLink != NULL )
+            {
+                pxWaiter = *ppxLink;
+                ucMatch = pxSocket->ucPendingEvents & pxWaiter->ucWaitEvents;
+
+                if( ucMatch != 0U )
+                {
+                    /* The waiter lives on the stack of its task, and it may
+                     * return as soon as it sees the result.  So it is removed
+                     * and notified before leaving the critical section, like
+                     * xTaskGenericNotify() does itself. */
+                    *ppxLink = pxWaiter->pxNext;
+                    pxWaiter->ucResultEvents |= ucMatch;
+                    ucHandedOver |= ucMatch;
+                    ( void ) xTaskNotifyGiveIndexed( pxWaiter->xTask, ipconfigSOCKET_NOTIFY_INDEX );
+                }
+                else
+                {
+                    ppxLink = &( pxWaiter->pxNext );
+                }
+            }
+
+            pxSocket->ucPendingEvents &= ( uint8_t ) ~ucHandedOver;
+        }
+        taskEXIT_CRITICAL();
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigSOCKET_USES_NOTIFY */
 
 /*-----------------------------------------------------------*/
 
@@ -3064,39 +4378,285 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                     vTaskSetTimeOutState( &xTimeOut );
                 }
 
-                /* Did it get connected while sleeping ? */
-                xResult = FreeRTOS_issocketconnected( pxSocket );
+                /* Did it get connected while sleeping ? */
+                xResult = FreeRTOS_issocketconnected( pxSocket );
+
+                /* Returns positive when connected, negative means an error */
+                if( xResult < 0 )
+                {
+                    /* Return the error */
+                    break;
+                }
+
+                if( xResult > 0 )
+                {
+                    /* Socket now connected, return a zero */
+                    xResult = 0;
+                    break;
+                }
+
+                /* Is it allowed to sleep more? */
+                if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+                {
+                    xResult = -pdFREERTOS_ERRNO_ETIMEDOUT;
+                    break;
+                }
+
+                /* Go sleeping until we get any down-stream event */
+                ( void ) xSocketWaitEvents( pxSocket, ( EventBits_t ) eSOCKET_CONNECT, xRemainingTime );
+            }
+        }
+
+        return xResult;
+    }
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_CONNECT_ANY != 0 )
+
+/**
+ * @brief Start a non-blocking connect to one of the addresses passed to
+ *        FreeRTOS_connect_any().
+ *
+ * @param[in] ulIPAddress: The IP-address to connect to, in network byte order.
+ * @param[in] usPort: The port number to connect to, in host byte order.
+ * @param[in] xSocketSet: The socket set to which the new socket is added.
+ *
+ * @return The connecting socket, or FREERTOS_INVALID_SOCKET when the attempt
+ *         could not be started.
+ */
+    static Socket_t prvConnectAnyStart( uint32_t ulIPAddress,
+                                        uint16_t usPort,
+                                        SocketSet_t xSocketSet )
+    {
+        struct freertos_sockaddr xAddress;
+        TickType_t xNoTimeout = 0U;
+        Socket_t xSocket;
+
+        xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+
+        if( xSocket != FREERTOS_INVALID_SOCKET )
+        {
+            /* Let FreeRTOS_connect() return as soon as the connection has been started. */
+            ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &( xNoTimeout ), sizeof( xNoTimeout ) );
+
+            ( void ) memset( &( xAddress ), 0, sizeof( xAddress ) );
+            xAddress.sin_addr = ulIPAddress;
+            xAddress.sin_port = FreeRTOS_htons( usPort );
+
+            if( FreeRTOS_connect( xSocket, &( xAddress ), sizeof( xAddress ) ) == -pdFREERTOS_ERRNO_EWOULDBLOCK )
+            {
+                FreeRTOS_FD_SET( xSocket, xSocketSet, ( EventBits_t ) eSELECT_WRITE | ( EventBits_t ) eSELECT_EXCEPT );
+            }
+            else
+            {
+                ( void ) FreeRTOS_closesocket( xSocket );
+                xSocket = FREERTOS_INVALID_SOCKET;
+            }
+        }
+
+        return xSocket;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Connect to the first one of several addresses of the same host that
+ *        accepts the connection.  The attempts are started one after the other
+ *        in the order of the array, a new attempt is started every
+ *        ipconfigTCP_CONNECT_ANY_DELAY_MS msec, or as soon as all earlier
+ *        attempts have failed.  The attempts that lose the race are closed.
+ *
+ * @param[in] pulIPAddresses: The IP-addresses to try, in network byte order.
+ * @param[in] xCount: The number of addresses, at most ipconfigTCP_CONNECT_ANY_MAX
+ *                    will be tried.
+ * @param[in] usPort: The port number to connect to, in host byte order.
+ * @param[in] xTimeout: The maximum time to wait for a connection.
+ *
+ * @return The connected socket, or FREERTOS_INVALID_SOCKET when none of the
+ *         addresses could be reached in time.
+ */
+    Socket_t FreeRTOS_connect_any( const uint32_t * pulIPAddresses,
+                                   BaseType_t xCount,
+                                   uint16_t usPort,
+                                   TickType_t xTimeout )
+    {
+        Socket_t xSockets[ ipconfigTCP_CONNECT_ANY_MAX ];
+        Socket_t xConnected = FREERTOS_INVALID_SOCKET;
+        SocketSet_t xSocketSet = NULL;
+        TimeOut_t xTimeOut;
+        TickType_t xRemainingTime = xTimeout;
+        TickType_t xLastStart = 0U;
+        TickType_t xElapsed;
+        TickType_t xWaitTime;
+        TickType_t xDefaultTimeout = ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME;
+        const TickType_t xDelay = pdMS_TO_TICKS( ipconfigTCP_CONNECT_ANY_DELAY_MS );
+        BaseType_t xAttempts = ( BaseType_t ) FreeRTOS_min_int32( ( int32_t ) xCount, ( int32_t ) ipconfigTCP_CONNECT_ANY_MAX );
+        BaseType_t xStarted = 0;
+        BaseType_t xActive = 0;
+        BaseType_t xStartNext = pdTRUE;
+        BaseType_t xState;
+        BaseType_t x;
+
+        if( ( pulIPAddresses != NULL ) && ( xAttempts > 0 ) )
+        {
+            xSocketSet = FreeRTOS_CreateSocketSet();
+        }
+
+        if( xSocketSet != NULL )
+        {
+            vTaskSetTimeOutState( &( xTimeOut ) );
+
+            for( ; ; )
+            {
+                if( xStarted < xAttempts )
+                {
+                    xElapsed = xTaskGetTickCount() - xLastStart;
+
+                    if( ( xStartNext != pdFALSE ) || ( xElapsed >= xDelay ) )
+                    {
+                        xSockets[ xStarted ] = prvConnectAnyStart( pulIPAddresses[ xStarted ], usPort, xSocketSet );
+
+                        if( xSockets[ xStarted ] != FREERTOS_INVALID_SOCKET )
+                        {
+                            xActive++;
+                        }
+
+                        xStarted++;
+                        xLastStart = xTaskGetTickCount();
+                        /* When this attempt could not be started, start the next one right away. */
+                        xStartNext = ( xActive == 0 ) ? pdTRUE : pdFALSE;
+                        continue;
+                    }
+                }
+
+                if( xActive == 0 )
+                {
+                    /* All attempts have failed. */
+                    break;
+                }
+
+                if( xTaskCheckForTimeOut( &( xTimeOut ), &( xRemainingTime ) ) != pdFALSE )
+                {
+                    break;
+                }
+
+                xWaitTime = xRemainingTime;
+
+                if( xStarted < xAttempts )
+                {
+                    /* Wake up in time to start the next attempt. */
+                    xElapsed = xTaskGetTickCount() - xLastStart;
+
+                    if( ( xDelay > xElapsed ) && ( ( xDelay - xElapsed ) < xWaitTime ) )
+                    {
+                        xWaitTime = xDelay - xElapsed;
+                    }
+                }
+
+                ( void ) FreeRTOS_select( xSocketSet, xWaitTime );
+
+                for( x = 0; x < xStarted; x++ )
+                {
+                    if( xSockets[ x ] == FREERTOS_INVALID_SOCKET )
+                    {
+                        continue;
+                    }
+
+                    if( FreeRTOS_issocketconnected( xSockets[ x ] ) > 0 )
+                    {
+                        xConnected = xSockets[ x ];
+                        xSockets[ x ] = FREERTOS_INVALID_SOCKET;
+                        break;
+                    }
+
+                    xState = FreeRTOS_connstatus( xSockets[ x ] );
+
+                    if( ( xState == ( BaseType_t ) eCLOSED ) || ( xState == ( BaseType_t ) eCLOSE_WAIT ) )
+                    {
+                        /* This attempt was refused or timed out, the next one may start now. */
+                        FreeRTOS_FD_CLR( xSockets[ x ], xSocketSet, ( EventBits_t ) eSELECT_ALL );
+                        ( void ) FreeRTOS_closesocket( xSockets[ x ] );
+                        xSockets[ x ] = FREERTOS_INVALID_SOCKET;
+                        xActive--;
+                        xStartNext = pdTRUE;
+                    }
+                }
+
+                if( xConnected != FREERTOS_INVALID_SOCKET )
+                {
+                    break;
+                }
+            }
+
+            /* Close the attempts that lost the race or that are still pending. */
+            for( x = 0; x < xStarted; x++ )
+            {
+                if( xSockets[ x ] != FREERTOS_INVALID_SOCKET )
+                {
+                    FreeRTOS_FD_CLR( xSockets[ x ], xSocketSet, ( EventBits_t ) eSELECT_ALL );
+                    ( void ) FreeRTOS_closesocket( xSockets[ x ] );
+                }
+            }
+
+            if( xConnected != FREERTOS_INVALID_SOCKET )
+            {
+                FreeRTOS_FD_CLR( xConnected, xSocketSet, ( EventBits_t ) eSELECT_ALL );
+                ( void ) FreeRTOS_setsockopt( xConnected, 0, FREERTOS_SO_RCVTIMEO, &( xDefaultTimeout ), sizeof( xDefaultTimeout ) );
+            }
+
+            FreeRTOS_DeleteSocketSet( xSocketSet );
+        }
+
+        return xConnected;
+    }
+    /*-----------------------------------------------------------*/
 
-                /* Returns positive when connected, negative means an error */
-                if( xResult < 0 )
-                {
-                    /* Return the error */
-                    break;
-                }
+    #if ( ipconfigUSE_DNS_CACHE != 0 )
 
-                if( xResult > 0 )
+/**
+ * @brief Look up the addresses of a host, and connect to the first one that
+ *        accepts the connection, see FreeRTOS_connect_any().
+ *
+ * @param[in] pcHostName: The name of the host.
+ * @param[in] usPort: The port number to connect to, in host byte order.
+ * @param[in] xTimeout: The maximum time to wait for a connection, the time
+ *                      needed for the look-up is not included.
+ *
+ * @return The connected socket, or FREERTOS_INVALID_SOCKET.
+ */
+        Socket_t FreeRTOS_connect_host( const char * pcHostName,
+                                        uint16_t usPort,
+                                        TickType_t xTimeout )
+        {
+            DNSAddress_t xAddresses[ ipconfigTCP_CONNECT_ANY_MAX ];
+            uint32_t ulIPAddresses[ ipconfigTCP_CONNECT_ANY_MAX ];
+            Socket_t xSocket = FREERTOS_INVALID_SOCKET;
+            BaseType_t xCount;
+            BaseType_t x;
+
+            /* FreeRTOS_gethostbyname() fills the cache, which holds all addresses. */
+            if( FreeRTOS_gethostbyname( pcHostName ) != 0U )
+            {
+                xCount = FreeRTOS_dnslookup_all( pcHostName, xAddresses, ipconfigTCP_CONNECT_ANY_MAX );
+
+                for( x = 0; x < xCount; x++ )
                 {
-                    /* Socket now connected, return a zero */
-                    xResult = 0;
-                    break;
+                    ulIPAddresses[ x ] = xAddresses[ x ].ulIPAddress;
                 }
 
-                /* Is it allowed to sleep more? */
-                if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+                if( xCount > 0 )
                 {
-                    xResult = -pdFREERTOS_ERRNO_ETIMEDOUT;
-                    break;
+                    xSocket = FreeRTOS_connect_any( ulIPAddresses, xCount, usPort, xTimeout );
                 }
-
-                /* Go sleeping until we get any down-stream event */
-                ( void ) xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_CONNECT, pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
             }
+
+            return xSocket;
         }
 
-        return xResult;
-    }
+    #endif /* ipconfigUSE_DNS_CACHE */
 
-#endif /* ipconfigUSE_TCP */
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_CONNECT_ANY != 0 ) */
 /*-----------------------------------------------------------*/
 
 #if ( ipconfigUSE_TCP == 1 )
@@ -3229,7 +4789,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 }
 
                 /* Go sleeping until we get any down-stream event */
-                ( void ) xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_ACCEPT, pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
+                ( void ) xSocketWaitEvents( pxSocket, ( EventBits_t ) eSOCKET_ACCEPT, xRemainingTime );
             }
         }
 
@@ -3281,14 +4841,18 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         }
         else
         {
-            if( pxSocket->u.xTCP.rxStream != NULL )
-            {
-                xByteCount = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
-            }
-            else
+            sockENTER_STREAM_CRITICAL();
             {
-                xByteCount = 0;
+                if( pxSocket->u.xTCP.rxStream != NULL )
+                {
+                    xByteCount = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
+                }
+                else
+                {
+                    xByteCount = 0;
+                }
             }
+            sockEXIT_STREAM_CRITICAL();
 
             while( xByteCount == 0 )
             {
@@ -3342,8 +4906,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                         #if ( ipconfigSUPPORT_SIGNALS != 0 )
                             {
                                 /* Just check for the interrupt flag. */
-                                xEventBits = xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_INTR,
-                                                                  pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, socketDONT_BLOCK );
+                                xEventBits = xSocketWaitEvents( pxSocket, ( EventBits_t ) eSOCKET_INTR, socketDONT_BLOCK );
                             }
                         #endif /* ipconfigSUPPORT_SIGNALS */
                         break;
@@ -3368,9 +4931,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 }
 
                 /* Block until there is a down-stream event. */
-                xEventBits = xEventGroupWaitBits( pxSocket->xEventGroup,
-                                                  ( EventBits_t ) eSOCKET_RECEIVE | ( EventBits_t ) eSOCKET_CLOSED | ( EventBits_t ) eSOCKET_INTR,
-                                                  pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
+                xEventBits = xSocketWaitEvents( pxSocket, ( EventBits_t ) eSOCKET_RECEIVE | ( EventBits_t ) eSOCKET_CLOSED | ( EventBits_t ) eSOCKET_INTR, xRemainingTime );
                 #if ( ipconfigSUPPORT_SIGNALS != 0 )
                     {
                         if( ( xEventBits & ( EventBits_t ) eSOCKET_INTR ) != 0U )
@@ -3384,14 +4945,18 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                     }
                 #endif /* ipconfigSUPPORT_SIGNALS */
 
-                if( pxSocket->u.xTCP.rxStream != NULL )
-                {
-                    xByteCount = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
-                }
-                else
+                sockENTER_STREAM_CRITICAL();
                 {
-                    xByteCount = 0;
+                    if( pxSocket->u.xTCP.rxStream != NULL )
+                    {
+                        xByteCount = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
+                    }
+                    else
+                    {
+                        xByteCount = 0;
+                    }
                 }
+                sockEXIT_STREAM_CRITICAL();
             }
 
             #if ( ipconfigSUPPORT_SIGNALS != 0 )
@@ -3401,7 +4966,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                     {
                         /* Shouldn't have cleared other flags. */
                         xEventBits &= ~( ( EventBits_t ) eSOCKET_INTR );
-                        ( void ) xEventGroupSetBits( pxSocket->xEventGroup, xEventBits );
+                        vSocketSetEvents( pxSocket, xEventBits );
                     }
 
                     xByteCount = -pdFREERTOS_ERRNO_EINTR;
@@ -3411,6 +4976,19 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
             if( xByteCount > 0 )
             {
+                #if ( ipTCP_GUARD_RX_STREAM != 0 )
+                    {
+                        /* The IP-task may not replace the rxStream while it is being read.
+                         * The flag is set in a critical section, in which the IP-task
+                         * can not be replacing the stream. */
+                        taskENTER_CRITICAL();
+                        {
+                            pxSocket->u.xTCP.ucRxStreamBusy = 1U;
+                        }
+                        taskEXIT_CRITICAL();
+                    }
+                #endif
+
                 if( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_ZERO_COPY ) == 0U )
                 {
                     BaseType_t xIsPeek = ( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_MSG_PEEK ) != 0U ) ? 1L : 0L;
@@ -3439,9 +5017,24 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 }
                 else
                 {
+                    #if ( ipTCP_GUARD_RX_STREAM != 0 )
+                        {
+                            /* The application keeps a pointer into the rxStream,
+                             * which may therefore not be replaced anymore. */
+                            pxSocket->u.xTCP.ucRxStreamPinned = 1U;
+                        }
+                    #endif
+
                     /* Zero-copy reception of data: pvBuffer is a pointer to a pointer. */
                     xByteCount = ( BaseType_t ) uxStreamBufferGetPtr( pxSocket->u.xTCP.rxStream, ipPOINTER_CAST( uint8_t * *, pvBuffer ) );
                 }
+
+                #if ( ipTCP_GUARD_RX_STREAM != 0 )
+                    {
+                        ipMEMORY_BARRIER();
+                        pxSocket->u.xTCP.ucRxStreamBusy = 0U;
+                    }
+                #endif
             }
             else
             {
@@ -3544,12 +5137,31 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
          * member pointers. */
         if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) == pdTRUE )
         {
-            pxBuffer = pxSocket->u.xTCP.txStream;
+            #if ( ipTCP_GUARD_TX_STREAM != 0 )
+                {
+                    /* The caller writes to the txStream before it calls
+                     * FreeRTOS_send(), so the stream may not be replaced anymore.
+                     * The flag is the only field written. */
+                    FreeRTOS_Socket_t * pxWritable = ipPOINTER_CAST( FreeRTOS_Socket_t *, pxSocket );
+
+                    taskENTER_CRITICAL();
+                    {
+                        pxWritable->u.xTCP.ucTxStreamPinned = 1U;
+                        pxBuffer = pxSocket->u.xTCP.txStream;
+                    }
+                    taskEXIT_CRITICAL();
+                }
+            #else
+                {
+                    pxBuffer = pxSocket->u.xTCP.txStream;
+                }
+            #endif
 
             if( pxBuffer != NULL )
             {
                 size_t uxSpace = uxStreamBufferGetSpace( pxBuffer );
-                size_t uxRemain = pxBuffer->LENGTH - pxBuffer->uxHead;
+                /* Writing may continue into the mirror behind the end of the stream. */
+                size_t uxRemain = ( pxBuffer->LENGTH + sbMIRROR_OF( pxBuffer ) ) - pxBuffer->uxHead;
 
                 if( uxRemain <= uxSpace )
                 {
@@ -3612,7 +5224,11 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
             xBytesLeft = ( BaseType_t ) uxDataLength;
 
             /* xByteCount is number of bytes that can be sent now. */
-            xByteCount = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
+            sockENTER_STREAM_CRITICAL();
+            {
+                xByteCount = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
+            }
+            sockEXIT_STREAM_CRITICAL();
 
             /* While there are still bytes to be sent. */
             while( xBytesLeft > 0 )
@@ -3653,8 +5269,28 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                         pxSocket->u.xTCP.bits.bCloseRequested = pdTRUE;
                     }
 
+                    #if ( ipTCP_GUARD_TX_STREAM != 0 )
+                        {
+                            /* The IP-task will not replace the txStream while it is
+                             * being accessed.  The flag is set in a critical section,
+                             * in which the IP-task can not be replacing the stream. */
+                            taskENTER_CRITICAL();
+                            {
+                                pxSocket->u.xTCP.ucTxStreamBusy = 1U;
+                            }
+                            taskEXIT_CRITICAL();
+                        }
+                    #endif
+
                     xByteCount = ( BaseType_t ) uxStreamBufferAdd( pxSocket->u.xTCP.txStream, 0U, pucSource, ( size_t ) xByteCount );
 
+                    #if ( ipTCP_GUARD_TX_STREAM != 0 )
+                        {
+                            ipMEMORY_BARRIER();
+                            pxSocket->u.xTCP.ucTxStreamBusy = 0U;
+                        }
+                    #endif
+
                     if( xCloseAfterSend != pdFALSE )
                     {
                         /* Now when the IP-task transmits the data, it will also
@@ -3733,10 +5369,13 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 }
 
                 /* Go sleeping until down-stream events are received. */
-                ( void ) xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_SEND | ( EventBits_t ) eSOCKET_CLOSED,
-                                              pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
+                ( void ) xSocketWaitEvents( pxSocket, ( EventBits_t ) eSOCKET_SEND | ( EventBits_t ) eSOCKET_CLOSED, xRemainingTime );
 
-                xByteCount = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
+                sockENTER_STREAM_CRITICAL();
+                {
+                    xByteCount = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
+                }
+                sockEXIT_STREAM_CRITICAL();
             }
 
             /* How much was actually sent? */
@@ -3955,14 +5594,39 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
              * IP-task goes to sleep. */
             if( pxSocket->xEventBits != 0U )
             {
+                #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                    {
+                        if( pxSocket->u.xTCP.bits.bWakeDeferred == pdFALSE_UNSIGNED )
+                        {
+                            pxSocket->u.xTCP.bits.bWakeDeferred = pdTRUE_UNSIGNED;
+                            pxSocket->u.xTCP.xWakeDeferTime = xNow;
+                        }
+                    }
+                #endif /* ipconfigSOCKET_WAKE_COALESCING */
+
                 if( xWillSleep != pdFALSE )
                 {
                     /* The IP-task is about to go to sleep, so messages can be
                      * sent to the socket owners. */
                     vSocketWakeUpUser( pxSocket );
                 }
+
+                #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                    else if( ( xNow - pxSocket->u.xTCP.xWakeDeferTime ) >= pdMS_TO_TICKS( ipconfigSOCKET_WAKE_MAX_DEFER_MS ) )
+                    {
+                        /* The IP-task stays busy, do not let the owner wait any
+                         * longer. */
+                        vSocketWakeUpUser( pxSocket );
+                    }
+                #endif /* ipconfigSOCKET_WAKE_COALESCING */
                 else
                 {
+                    #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                        {
+                            pxSocket->u.xTCP.xWakeStats.ulDeferred++;
+                        }
+                    #endif /* ipconfigSOCKET_WAKE_COALESCING */
+
                     /* Or else make sure this will be called again to wake-up
                      * the sockets' owner. */
                     xShortest = ( TickType_t ) 0;
@@ -4038,127 +5702,480 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
             }
         }
 
-        if( pxResult == NULL )
+        if( pxResult == NULL )
+        {
+            /* An exact match was not found, maybe a listening socket was
+             * found. */
+            pxResult = pxListenSocket;
+        }
+
+        return pxResult;
+    }
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/**
+ * @brief For the web server: borrow the circular Rx buffer for inspection.
+ *        HTML driver wants to see if a sequence of 13/10/13/10 is available.
+ *
+ * @param[in] xSocket: The socket whose Rx stream is to be returned.
+ *
+ * @return The Rx stream of the socket if all checks pass, else NULL.
+ */
+    const struct xSTREAM_BUFFER * FreeRTOS_get_rx_buf( ConstSocket_t xSocket )
+    {
+        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+        const struct xSTREAM_BUFFER * pxReturn = NULL;
+
+
+        /* Confirm that this is a TCP socket before dereferencing structure
+         * member pointers. */
+        if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) == pdTRUE )
+        {
+            #if ( ipTCP_GUARD_RX_STREAM != 0 )
+                {
+                    /* The caller keeps a pointer to the rxStream, which may not
+                     * be replaced anymore.  The flag is the only field written. */
+                    FreeRTOS_Socket_t * pxWritable = ipPOINTER_CAST( FreeRTOS_Socket_t *, pxSocket );
+
+                    taskENTER_CRITICAL();
+                    {
+                        pxWritable->u.xTCP.ucRxStreamPinned = 1U;
+                        pxReturn = pxSocket->u.xTCP.rxStream;
+                    }
+                    taskEXIT_CRITICAL();
+                }
+            #else
+                {
+                    pxReturn = pxSocket->u.xTCP.rxStream;
+                }
+            #endif
+        }
+
+        return pxReturn;
+    }
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/**
+ * @brief Create the stream buffer for the given socket.
+ *
+ * @param[in] pxSocket: the socket to create the stream for.
+ * @param[in] xIsInputStream: Is this input stream? pdTRUE/pdFALSE?
+ *
+ * @return The stream buffer.
+ */
+    static StreamBuffer_t * prvTCPCreateStream( FreeRTOS_Socket_t * pxSocket,
+                                                BaseType_t xIsInputStream )
+    {
+        StreamBuffer_t * pxBuffer;
+        size_t uxLength;
+        size_t uxSize;
+
+        /* Now that a stream is created, the maximum size is fixed before
+         * creation, it could still be changed with setsockopt(). */
+        if( xIsInputStream != pdFALSE )
+        {
+            uxLength = pxSocket->u.xTCP.uxRxStreamSize;
+
+            if( pxSocket->u.xTCP.uxLittleSpace == 0U )
+            {
+                pxSocket->u.xTCP.uxLittleSpace = ( sock20_PERCENT * pxSocket->u.xTCP.uxRxStreamSize ) / sock100_PERCENT;
+            }
+
+            if( pxSocket->u.xTCP.uxEnoughSpace == 0U )
+            {
+                pxSocket->u.xTCP.uxEnoughSpace = ( sock80_PERCENT * pxSocket->u.xTCP.uxRxStreamSize ) / sock100_PERCENT;
+            }
+        }
+        else
+        {
+            uxLength = pxSocket->u.xTCP.uxTxStreamSize;
+        }
+
+        pxBuffer = prvTCPAllocateStream( uxLength, &( uxSize ) );
+
+        if( pxBuffer == NULL )
+        {
+            FreeRTOS_debug_printf( ( "prvTCPCreateStream: malloc failed\n" ) );
+            pxSocket->u.xTCP.bits.bMallocError = pdTRUE;
+            vTCPStateChange( pxSocket, eCLOSE_WAIT );
+        }
+        else
+        {
+            uxLength = pxBuffer->LENGTH;
+
+            if( xTCPWindowLoggingLevel != 0 )
+            {
+                FreeRTOS_debug_printf( ( "prvTCPCreateStream: %cxStream created %u bytes (total %u)\n", ( xIsInputStream != 0 ) ? 'R' : 'T', ( unsigned ) uxLength, ( unsigned ) uxSize ) );
+            }
+
+            if( xIsInputStream != 0 )
+            {
+                iptraceMEM_STATS_CREATE( tcpRX_STREAM_BUFFER, pxBuffer, uxSize );
+                pxSocket->u.xTCP.rxStream = pxBuffer;
+            }
+            else
+            {
+                iptraceMEM_STATS_CREATE( tcpTX_STREAM_BUFFER, pxBuffer, uxSize );
+                pxSocket->u.xTCP.txStream = pxBuffer;
+            }
+        }
+
+        return pxBuffer;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Allocate a stream buffer and clear its markers.
+ *
+ * @param[in] uxStreamSize: The minimum number of bytes that the stream must hold.
+ * @param[out] puxAllocatedSize: The number of bytes allocated, including the header.
+ *
+ * @return The stream buffer, or NULL when the allocation failed.
+ */
+    static StreamBuffer_t * prvTCPAllocateStream( size_t uxStreamSize,
+                                                  size_t * puxAllocatedSize )
+    {
+        StreamBuffer_t * pxBuffer;
+        size_t uxLength = uxStreamSize;
+        size_t uxSize;
+
+        /* Add an extra 4 (or 8) bytes. */
+        uxLength += sizeof( size_t );
+
+        /* And make the length a multiple of sizeof( size_t ). */
+        uxLength &= ~( sizeof( size_t ) - 1U );
+
+        /* The mirror, if any, is stored after the end of the stream. */
+        uxSize = ( sizeof( *pxBuffer ) + uxLength + sbMIRROR_SIZE( uxLength ) ) - sizeof( pxBuffer->ucArray );
+
+        #if ( ipconfigSOCKET_POOL != 0 )
+            {
+                pxBuffer = ipCAST_PTR_TO_TYPE_PTR( StreamBuffer_t, prvSocketPoolTake( socketPOOL_STREAM_SMALL, socketPOOL_STREAM_LARGE, uxSize ) );
+
+                if( pxBuffer == NULL )
+                {
+                    pxBuffer = ipCAST_PTR_TO_TYPE_PTR( StreamBuffer_t, pvPortMallocLarge( uxSize ) );
+                }
+            }
+        #else
+            {
+                pxBuffer = ipCAST_PTR_TO_TYPE_PTR( StreamBuffer_t, pvPortMallocLarge( uxSize ) );
+            }
+        #endif /* ipconfigSOCKET_POOL */
+
+        if( pxBuffer != NULL )
+        {
+            /* Clear the markers of the stream */
+            ( void ) memset( pxBuffer, 0, sizeof( *pxBuffer ) - sizeof( pxBuffer->ucArray ) );
+            pxBuffer->LENGTH = ( size_t ) uxLength;
+
+            #if ( ipconfigSTREAM_BUFFER_MIRROR_SIZE != 0 )
+                {
+                    /* Only streams allocated here have a mirror. */
+                    pxBuffer->uxMirrorSize = sbMIRROR_SIZE( uxLength );
+                }
+            #endif
+        }
+
+        *puxAllocatedSize = uxSize;
+
+        return pxBuffer;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Free a stream buffer that was allocated by prvTCPAllocateStream().
+ *
+ * @param[in] pxBuffer: The stream buffer to be freed.
+ */
+    static void prvTCPFreeStream( StreamBuffer_t * pxBuffer )
+    {
+        #if ( ipconfigSOCKET_POOL != 0 )
+            if( prvSocketPoolGive( pxBuffer ) == pdFALSE )
+        #endif
         {
-            /* An exact match was not found, maybe a listening socket was
-             * found. */
-            pxResult = pxListenSocket;
+            vPortFreeLarge( pxBuffer );
         }
-
-        return pxResult;
     }
+    /*-----------------------------------------------------------*/
 
-#endif /* ipconfigUSE_TCP */
-/*-----------------------------------------------------------*/
+    #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 )
 
-#if ( ipconfigUSE_TCP == 1 )
+/**
+ * @brief Set the size of the rxStream that will be created.  When the low- and
+ *        high-water marks have been set already, they will be scaled along.
+ *
+ * @param[in] pxSocket: The TCP socket.
+ * @param[in] uxNewSize: The new size of the rxStream in bytes.
+ */
+        void vTCPSetRxStreamSize( FreeRTOS_Socket_t * pxSocket,
+                                  size_t uxNewSize )
+        {
+            IPTCPSocket_t * pxTCP = &( pxSocket->u.xTCP );
+            size_t uxOldSize = pxTCP->uxRxStreamSize;
+
+            if( uxOldSize != 0U )
+            {
+                pxTCP->uxLittleSpace = ( ( ( pxTCP->uxLittleSpace * sock100_PERCENT ) / uxOldSize ) * uxNewSize ) / sock100_PERCENT;
+                pxTCP->uxEnoughSpace = ( ( ( pxTCP->uxEnoughSpace * sock100_PERCENT ) / uxOldSize ) * uxNewSize ) / sock100_PERCENT;
+            }
+
+            pxTCP->uxRxStreamSize = uxNewSize;
+        }
+        /*-----------------------------------------------------------*/
 
 /**
- * @brief For the web server: borrow the circular Rx buffer for inspection.
- *        HTML driver wants to see if a sequence of 13/10/13/10 is available.
+ * @brief Replace the rxStream of a socket with a stream of a different size.
+ *        This is only done while the stream is empty, and while no user task is
+ *        reading from it.  A stream to which the application got a direct
+ *        pointer is never replaced, and the stream never becomes smaller than
+ *        the reception window that has been advertised.  Called from the IP-task.
  *
- * @param[in] xSocket: The socket whose Rx stream is to be returned.
+ * @param[in] pxSocket: The TCP socket.
+ * @param[in] uxNewSize: The new size of the rxStream in bytes.
  *
- * @return The Rx stream of the socket if all checks pass, else NULL.
+ * @return pdTRUE when the stream has been replaced, otherwise pdFALSE.
  */
-    const struct xSTREAM_BUFFER * FreeRTOS_get_rx_buf( ConstSocket_t xSocket )
-    {
-        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
-        const struct xSTREAM_BUFFER * pxReturn = NULL;
+        BaseType_t xTCPResizeRxStream( FreeRTOS_Socket_t * pxSocket,
+                                       size_t uxNewSize )
+        {
+            StreamBuffer_t * pxOldStream = pxSocket->u.xTCP.rxStream;
+            StreamBuffer_t * pxNewStream = NULL;
+            size_t uxSize;
+            BaseType_t xResult = pdFALSE;
+            /* The number of bytes that the peer may send without waiting for a
+             * new window advertisement. */
+            int32_t lAdvertised = ( int32_t ) ( pxSocket->u.xTCP.ulHighestRxAllowed - pxSocket->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber );
+
+            /* Data that was allowed by the advertised window must still fit. */
+            if( ( lAdvertised <= 0 ) || ( uxNewSize >= ( size_t ) lAdvertised ) )
+            {
+                pxNewStream = prvTCPAllocateStream( uxNewSize, &( uxSize ) );
+            }
 
+            if( pxNewStream != NULL )
+            {
+                taskENTER_CRITICAL();
+                {
+                    /* Check again in a critical section, in which no user task
+                     * can access the stream, also not from another core: the
+                     * stream must be empty, without data stored out of order. */
+                    if( ( pxSocket->u.xTCP.ucRxStreamBusy == 0U ) &&
+                        ( pxSocket->u.xTCP.ucRxStreamPinned == 0U ) &&
+                        ( pxOldStream->uxTail == pxOldStream->uxHead ) &&
+                        ( pxOldStream->uxFront == pxOldStream->uxHead ) )
+                    {
+                        pxSocket->u.xTCP.rxStream = pxNewStream;
+                        xResult = pdTRUE;
+                    }
+                }
+                taskEXIT_CRITICAL();
 
-        /* Confirm that this is a TCP socket before dereferencing structure
-         * member pointers. */
-        if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) == pdTRUE )
-        {
-            pxReturn = pxSocket->u.xTCP.rxStream;
-        }
+                if( xResult != pdFALSE )
+                {
+                    if( xTCPWindowLoggingLevel != 0 )
+                    {
+                        FreeRTOS_debug_printf( ( "xTCPResizeRxStream: %u -> %u bytes\n",
+                                                 ( unsigned ) pxSocket->u.xTCP.uxRxStreamSize,
+                                                 ( unsigned ) uxNewSize ) );
+                    }
 
-        return pxReturn;
-    }
+                    vTCPSetRxStreamSize( pxSocket, uxNewSize );
+                    iptraceMEM_STATS_DELETE( pxOldStream );
+                    prvTCPFreeStream( pxOldStream );
+                    iptraceMEM_STATS_CREATE( tcpRX_STREAM_BUFFER, pxNewStream, uxSize );
+                }
+                else
+                {
+                    prvTCPFreeStream( pxNewStream );
+                }
+            }
 
-#endif /* ipconfigUSE_TCP */
-/*-----------------------------------------------------------*/
+            return xResult;
+        }
+        /*-----------------------------------------------------------*/
+    #endif /* ipconfigUSE_TCP_RX_AUTOTUNING */
 
-#if ( ipconfigUSE_TCP == 1 )
+    #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
 
 /**
- * @brief Create the stream buffer for the given socket.
+ * @brief Replace the txStream of a socket with a stream of a different size.
+ *        The data that has not been acknowledged yet is copied to the start of
+ *        the new stream, and the transmission segments are moved along.  The
+ *        growth beyond 'uxTxStreamSize' is taken from a budget shared by all
+ *        sockets.  A stream obtained with FreeRTOS_get_tx_head() is never
+ *        replaced.  Called from the IP-task.
  *
- * @param[in] pxSocket: the socket to create the stream for.
- * @param[in] xIsInputStream: Is this input stream? pdTRUE/pdFALSE?
+ * @param[in] pxSocket: The TCP socket.
+ * @param[in] uxNewSize: The new size of the txStream in bytes.
  *
- * @return The stream buffer.
+ * @return pdTRUE when the stream has been replaced, otherwise pdFALSE.
  */
-    static StreamBuffer_t * prvTCPCreateStream( FreeRTOS_Socket_t * pxSocket,
-                                                BaseType_t xIsInputStream )
-    {
-        StreamBuffer_t * pxBuffer;
-        size_t uxLength;
-        size_t uxSize;
-
-        /* Now that a stream is created, the maximum size is fixed before
-         * creation, it could still be changed with setsockopt(). */
-        if( xIsInputStream != pdFALSE )
-        {
-            uxLength = pxSocket->u.xTCP.uxRxStreamSize;
+        BaseType_t xTCPResizeTxStream( FreeRTOS_Socket_t * pxSocket,
+                                       size_t uxNewSize )
+        {
+            IPTCPSocket_t * pxTCP = &( pxSocket->u.xTCP );
+            StreamBuffer_t * pxOldStream = pxTCP->txStream;
+            StreamBuffer_t * pxNewStream = NULL;
+            size_t uxGrowth = 0U;
+            size_t uxHead = pxOldStream->uxHead;
+            size_t uxTail = pxOldStream->uxTail;
+            size_t uxCount = uxStreamBufferDistance( pxOldStream, uxTail, uxHead );
+            size_t uxSize;
+            BaseType_t xResult = pdFALSE;
+
+            if( uxNewSize > pxTCP->uxTxStreamSize )
+            {
+                uxGrowth = uxNewSize - pxTCP->uxTxStreamSize;
+            }
 
-            if( pxSocket->u.xTCP.uxLittleSpace == 0U )
+            /* Only the growth beyond the configured size is taken from the budget. */
+            if( ( uxGrowth <= pxTCP->uxTxStreamGrowth ) ||
+                ( ( uxGrowth - pxTCP->uxTxStreamGrowth ) <= uxTxStreamBudget ) )
             {
-                pxSocket->u.xTCP.uxLittleSpace = ( sock20_PERCENT * pxSocket->u.xTCP.uxRxStreamSize ) / sock100_PERCENT;
+                pxNewStream = prvTCPAllocateStream( uxNewSize, &( uxSize ) );
             }
 
-            if( pxSocket->u.xTCP.uxEnoughSpace == 0U )
+            if( ( pxNewStream != NULL ) && ( uxCount < pxNewStream->LENGTH ) )
             {
-                pxSocket->u.xTCP.uxEnoughSpace = ( sock80_PERCENT * pxSocket->u.xTCP.uxRxStreamSize ) / sock100_PERCENT;
+                /* The user task only adds data beyond the head, the IP-task is
+                 * the only one advancing the tail.  The data can be copied
+                 * without suspending the scheduler. */
+                ( void ) uxStreamBufferGet( pxOldStream, 0U, pxNewStream->ucArray, uxCount, pdTRUE );
+
+                #if ( ipconfigSTREAM_BUFFER_MIRROR_SIZE != 0 )
+                    {
+                        /* The data was not added through uxStreamBufferAdd(), so
+                         * the mirror must be filled here. */
+                        ( void ) memcpy( &( pxNewStream->ucArray[ pxNewStream->LENGTH ] ),
+                                         pxNewStream->ucArray,
+                                         FreeRTOS_min_size_t( uxCount, sbMIRROR_OF( pxNewStream ) ) );
+                    }
+                #endif
+
+                taskENTER_CRITICAL();
+                {
+                    /* Check again in a critical section, in which no user task
+                     * can access the stream, also not from another core: no data
+                     * may have been added in the mean time, and the application
+                     * may not have a pointer into the stream. */
+                    if( ( pxTCP->ucTxStreamBusy == 0U ) &&
+                        ( pxTCP->ucTxStreamPinned == 0U ) &&
+                        ( pxOldStream->uxHead == uxHead ) )
+                    {
+                        pxNewStream->uxMid = uxStreamBufferDistance( pxOldStream, uxTail, pxOldStream->uxMid );
+                        pxNewStream->uxHead = uxCount;
+                        pxNewStream->uxFront = uxCount;
+                        pxTCP->txStream = pxNewStream;
+                        xResult = pdTRUE;
+                    }
+                }
+                taskEXIT_CRITICAL();
             }
-        }
-        else
-        {
-            uxLength = pxSocket->u.xTCP.uxTxStreamSize;
-        }
 
-        /* Add an extra 4 (or 8) bytes. */
-        uxLength += sizeof( size_t );
+            if( xResult != pdFALSE )
+            {
+                if( xTCPWindowLoggingLevel != 0 )
+                {
+                    FreeRTOS_debug_printf( ( "xTCPResizeTxStream: %u -> %u bytes (%u in use)\n",
+                                             ( unsigned ) ( pxTCP->uxTxStreamSize + pxTCP->uxTxStreamGrowth ),
+                                             ( unsigned ) uxNewSize,
+                                             ( unsigned ) uxCount ) );
+                }
 
-        /* And make the length a multiple of sizeof( size_t ). */
-        uxLength &= ~( sizeof( size_t ) - 1U );
+                vTCPWindowTxRebase( &( pxTCP->xTCPWindow ), ( int32_t ) uxTail, ( int32_t ) pxOldStream->LENGTH );
 
-        uxSize = ( sizeof( *pxBuffer ) + uxLength ) - sizeof( pxBuffer->ucArray );
+                uxTxStreamBudget = ( uxTxStreamBudget + pxTCP->uxTxStreamGrowth ) - uxGrowth;
+                pxTCP->uxTxStreamGrowth = uxGrowth;
 
-        pxBuffer = ipCAST_PTR_TO_TYPE_PTR( StreamBuffer_t, pvPortMallocLarge( uxSize ) );
+                iptraceMEM_STATS_DELETE( pxOldStream );
+                prvTCPFreeStream( pxOldStream );
+                iptraceMEM_STATS_CREATE( tcpTX_STREAM_BUFFER, pxNewStream, uxSize );
+            }
+            else if( pxNewStream != NULL )
+            {
+                prvTCPFreeStream( pxNewStream );
+            }
+            else
+            {
+                /* Not enough budget or memory. */
+            }
 
-        if( pxBuffer == NULL )
-        {
-            FreeRTOS_debug_printf( ( "prvTCPCreateStream: malloc failed\n" ) );
-            pxSocket->u.xTCP.bits.bMallocError = pdTRUE;
-            vTCPStateChange( pxSocket, eCLOSE_WAIT );
+            return xResult;
         }
-        else
+        /*-----------------------------------------------------------*/
+    #endif /* ipconfigUSE_TCP_TX_AUTOTUNING */
+
+    #if ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+
+/**
+ * @brief The TIME_WAIT state of a connection is kept in the table, and its FIN
+ *        has been acknowledged: the txStream is not needed anymore.  Neither
+ *        is the rxStream, unless it still holds data for FreeRTOS_recv().  A
+ *        stream that a user task is accessing, or points into, is left alone;
+ *        it will be freed when the socket is closed.  Called from the IP-task.
+ *
+ * @param[in] pxSocket: The TCP socket.
+ */
+        void vTCPReleaseStreams( FreeRTOS_Socket_t * pxSocket )
         {
-            /* Clear the markers of the stream */
-            ( void ) memset( pxBuffer, 0, sizeof( *pxBuffer ) - sizeof( pxBuffer->ucArray ) );
-            pxBuffer->LENGTH = ( size_t ) uxLength;
+            IPTCPSocket_t * pxTCP = &( pxSocket->u.xTCP );
+            StreamBuffer_t * pxRxStream = NULL;
+            StreamBuffer_t * pxTxStream = NULL;
 
-            if( xTCPWindowLoggingLevel != 0 )
+            taskENTER_CRITICAL();
             {
-                FreeRTOS_debug_printf( ( "prvTCPCreateStream: %cxStream created %u bytes (total %u)\n", ( xIsInputStream != 0 ) ? 'R' : 'T', ( unsigned ) uxLength, ( unsigned ) uxSize ) );
+                /* No user task can access the streams now, also not from
+                 * another core. */
+                if( ( pxTCP->rxStream != NULL ) &&
+                    ( pxTCP->ucRxStreamBusy == 0U ) &&
+                    ( pxTCP->ucRxStreamPinned == 0U ) &&
+                    ( uxStreamBufferGetSize( pxTCP->rxStream ) == 0U ) )
+                {
+                    pxRxStream = pxTCP->rxStream;
+                    pxTCP->rxStream = NULL;
+                }
+
+                if( ( pxTCP->txStream != NULL ) &&
+                    ( pxTCP->ucTxStreamBusy == 0U ) &&
+                    ( pxTCP->ucTxStreamPinned == 0U ) )
+                {
+                    pxTxStream = pxTCP->txStream;
+                    pxTCP->txStream = NULL;
+                }
             }
+            taskEXIT_CRITICAL();
 
-            if( xIsInputStream != 0 )
+            if( pxRxStream != NULL )
             {
-                iptraceMEM_STATS_CREATE( tcpRX_STREAM_BUFFER, pxBuffer, uxSize );
-                pxSocket->u.xTCP.rxStream = pxBuffer;
+                iptraceMEM_STATS_DELETE( pxRxStream );
+                prvTCPFreeStream( pxRxStream );
             }
-            else
+
+            if( pxTxStream != NULL )
             {
-                iptraceMEM_STATS_CREATE( tcpTX_STREAM_BUFFER, pxBuffer, uxSize );
-                pxSocket->u.xTCP.txStream = pxBuffer;
+                iptraceMEM_STATS_DELETE( pxTxStream );
+                prvTCPFreeStream( pxTxStream );
+
+                #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+                    {
+                        /* Give the growth of the txStream back to the budget. */
+                        uxTxStreamBudget += pxTCP->uxTxStreamGrowth;
+                        pxTCP->uxTxStreamGrowth = 0U;
+                    }
+                #endif
             }
         }
-
-        return pxBuffer;
-    }
+        /*-----------------------------------------------------------*/
+    #endif /* ipconfigTCP_TIME_WAIT_TABLE */
 
 
 #endif /* ipconfigUSE_TCP */
@@ -4290,18 +6307,30 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                         }
                     }
 
-                    /* New incoming data is available, wake up the user.   User's
-                     * semaphores will be set just before the IP-task goes asleep. */
-                    pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_RECEIVE;
-
-                    #if ipconfigSUPPORT_SELECT_FUNCTION == 1
+                    #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                        if( ( uxStreamBufferGetSize( pxStream ) < pxSocket->u.xTCP.uxRcvLowat ) &&
+                            ( pxSocket->u.xTCP.bits.bLowWater == pdFALSE_UNSIGNED ) )
                         {
-                            if( ( pxSocket->xSelectBits & ( EventBits_t ) eSELECT_READ ) != 0U )
+                            /* Not enough data yet to wake up the reader, and the
+                             * rxStream is not running out of space. */
+                            pxSocket->u.xTCP.xWakeStats.ulBelowLowat++;
+                        }
+                        else
+                    #endif /* ipconfigSOCKET_WAKE_COALESCING */
+                    {
+                        /* New incoming data is available, wake up the user.   User's
+                         * semaphores will be set just before the IP-task goes asleep. */
+                        pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_RECEIVE;
+
+                        #if ipconfigSUPPORT_SELECT_FUNCTION == 1
                             {
-                                pxSocket->xEventBits |= ( ( ( EventBits_t ) eSELECT_READ ) << SOCKET_EVENT_BIT_COUNT );
+                                if( ( pxSocket->xSelectBits & ( EventBits_t ) eSELECT_READ ) != 0U )
+                                {
+                                    pxSocket->xEventBits |= ( ( ( EventBits_t ) eSELECT_READ ) << SOCKET_EVENT_BIT_COUNT );
+                                }
                             }
-                        }
-                    #endif
+                        #endif
+                    }
                 }
             }
         }
@@ -4386,13 +6415,20 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 xResult = 0;
             }
         }
-        else if( pxSocket->u.xTCP.txStream == NULL )
-        {
-            xResult = ( BaseType_t ) pxSocket->u.xTCP.uxTxStreamSize;
-        }
         else
         {
-            xResult = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
+            sockENTER_STREAM_CRITICAL();
+            {
+                if( pxSocket->u.xTCP.txStream == NULL )
+                {
+                    xResult = ( BaseType_t ) pxSocket->u.xTCP.uxTxStreamSize;
+                }
+                else
+                {
+                    xResult = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
+                }
+            }
+            sockEXIT_STREAM_CRITICAL();
         }
 
         return xResult;
@@ -4423,14 +6459,18 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         }
         else
         {
-            if( pxSocket->u.xTCP.txStream != NULL )
-            {
-                xReturn = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
-            }
-            else
+            sockENTER_STREAM_CRITICAL();
             {
-                xReturn = ( BaseType_t ) pxSocket->u.xTCP.uxTxStreamSize;
+                if( pxSocket->u.xTCP.txStream != NULL )
+                {
+                    xReturn = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
+                }
+                else
+                {
+                    xReturn = ( BaseType_t ) pxSocket->u.xTCP.uxTxStreamSize;
+                }
             }
+            sockEXIT_STREAM_CRITICAL();
         }
 
         return xReturn;
@@ -4461,14 +6501,18 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         }
         else
         {
-            if( pxSocket->u.xTCP.txStream != NULL )
-            {
-                xReturn = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.txStream );
-            }
-            else
+            sockENTER_STREAM_CRITICAL();
             {
-                xReturn = 0;
+                if( pxSocket->u.xTCP.txStream != NULL )
+                {
+                    xReturn = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.txStream );
+                }
+                else
+                {
+                    xReturn = 0;
+                }
             }
+            sockEXIT_STREAM_CRITICAL();
         }
 
         return xReturn;
@@ -4543,6 +6587,68 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         return xReturn;
     }
 
+    #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+
+/**
+ * @brief Get a copy of the counters of the ACK's that a TCP socket has sent
+ *        in response to received data.
+ *
+ * @param[in] xSocket: The TCP socket.
+ * @param[out] pxStatistics: The counters will be copied to this structure.
+ *
+ * @return 0 on success, or -pdFREERTOS_ERRNO_EINVAL when the socket is not a
+ *         TCP socket.
+ */
+        BaseType_t FreeRTOS_GetTCPAckStatistics( ConstSocket_t xSocket,
+                                                 TCPAckStatistics_t * pxStatistics )
+        {
+            const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+            BaseType_t xReturn;
+
+            if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_TCP )
+            {
+                xReturn = -pdFREERTOS_ERRNO_EINVAL;
+            }
+            else
+            {
+                *pxStatistics = pxSocket->u.xTCP.xAckStatistics;
+                xReturn = 0;
+            }
+
+            return xReturn;
+        }
+    #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
+    #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+
+/**
+ * @brief Get a copy of the wake-up counters of a TCP socket.
+ *
+ * @param[in] xSocket: The socket.
+ * @param[out] pxStats: The counters will be copied to this structure.
+ *
+ * @return 0 on success, or -pdFREERTOS_ERRNO_EINVAL when it is not a TCP socket.
+ */
+        BaseType_t FreeRTOS_GetSocketWakeStats( ConstSocket_t xSocket,
+                                                SocketWakeStats_t * pxStats )
+        {
+            const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+            BaseType_t xReturn;
+
+            if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_TCP )
+            {
+                xReturn = -pdFREERTOS_ERRNO_EINVAL;
+            }
+            else
+            {
+                *pxStats = pxSocket->u.xTCP.xWakeStats;
+                xReturn = 0;
+            }
+
+            return xReturn;
+        }
+    #endif /* ipconfigSOCKET_WAKE_COALESCING */
+
 
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
@@ -4600,13 +6706,20 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         {
             xReturn = -pdFREERTOS_ERRNO_EINVAL;
         }
-        else if( pxSocket->u.xTCP.rxStream != NULL )
-        {
-            xReturn = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
-        }
         else
         {
-            xReturn = 0;
+            sockENTER_STREAM_CRITICAL();
+            {
+                if( pxSocket->u.xTCP.rxStream != NULL )
+                {
+                    xReturn = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
+                }
+                else
+                {
+                    xReturn = 0;
+                }
+            }
+            sockEXIT_STREAM_CRITICAL();
         }
 
         return xReturn;
@@ -4988,15 +7101,22 @@ BaseType_t xSocketValid( Socket_t xSocket )
             }
             else
         #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
-        if( pxSocket->xEventGroup != NULL )
-        {
-            ( void ) xEventGroupSetBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_INTR );
-            xReturn = 0;
-        }
-        else
-        {
-            xReturn = -pdFREERTOS_ERRNO_EINVAL;
-        }
+        #if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+            {
+                vSocketSetEvents( pxSocket, ( EventBits_t ) eSOCKET_INTR );
+                xReturn = 0;
+            }
+        #else
+            if( pxSocket->xEventGroup != NULL )
+            {
+                vSocketSetEvents( pxSocket, ( EventBits_t ) eSOCKET_INTR );
+                xReturn = 0;
+            }
+            else
+            {
+                xReturn = -pdFREERTOS_ERRNO_EINVAL;
+            }
+        #endif /* ipconfigSOCKET_USES_NOTIFY */
 
         return xReturn;
     }
@@ -5023,7 +7143,9 @@ BaseType_t xSocketValid( Socket_t xSocket )
 
         configASSERT( pxSocket != NULL );
         configASSERT( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP );
-        configASSERT( pxSocket->xEventGroup != NULL );
+        #if ( ipconfigSOCKET_USES_NOTIFY == 0 )
+            configASSERT( pxSocket->xEventGroup != NULL );
+        #endif
 
         xEvent.eEventType = eSocketSignalEvent;
         xEvent.pvData = pxSocket;
@@ -99,8 +99,8 @@ size_t uxStreamBufferDistance( const StreamBuffer_t * pxBuffer,
  */
 size_t uxStreamBufferGetSpace( const StreamBuffer_t * pxBuffer )
 {
-    size_t uxHead = pxBuffer->uxHead;
-    size_t uxTail = pxBuffer->uxTail;
+    size_t uxHead = sbLOAD_ACQUIRE( pxBuffer->uxHead );
+    size_t uxTail = sbLOAD_ACQUIRE( pxBuffer->uxTail );
 
     return uxStreamBufferSpace( pxBuffer, uxHead, uxTail );
 }
@@ -114,8 +114,8 @@ size_t uxStreamBufferGetSpace( const StreamBuffer_t * pxBuffer )
  */
 size_t uxStreamBufferFrontSpace( const StreamBuffer_t * pxBuffer )
 {
-    size_t uxFront = pxBuffer->uxFront;
-    size_t uxTail = pxBuffer->uxTail;
+    size_t uxFront = sbLOAD_ACQUIRE( pxBuffer->uxFront );
+    size_t uxTail = sbLOAD_ACQUIRE( pxBuffer->uxTail );
 
     return uxStreamBufferSpace( pxBuffer, uxFront, uxTail );
 }
@@ -130,8 +130,8 @@ size_t uxStreamBufferFrontSpace( const StreamBuffer_t * pxBuffer )
  */
 size_t uxStreamBufferGetSize( const StreamBuffer_t * pxBuffer )
 {
-    size_t uxHead = pxBuffer->uxHead;
-    size_t uxTail = pxBuffer->uxTail;
+    size_t uxHead = sbLOAD_ACQUIRE( pxBuffer->uxHead );
+    size_t uxTail = sbLOAD_ACQUIRE( pxBuffer->uxTail );
 
     return uxStreamBufferDistance( pxBuffer, uxTail, uxHead );
 }
@@ -145,8 +145,8 @@ size_t uxStreamBufferGetSize( const StreamBuffer_t * pxBuffer )
  */
 size_t uxStreamBufferMidSpace( const StreamBuffer_t * pxBuffer )
 {
-    size_t uxHead = pxBuffer->uxHead;
-    size_t uxMid = pxBuffer->uxMid;
+    size_t uxHead = sbLOAD_ACQUIRE( pxBuffer->uxHead );
+    size_t uxMid = sbLOAD_ACQUIRE( pxBuffer->uxMid );
 
     return uxStreamBufferDistance( pxBuffer, uxMid, uxHead );
 }
@@ -177,7 +177,7 @@ void vStreamBufferMoveMid( StreamBuffer_t * pxBuffer,
 {
     /* Increment uxMid, but no further than uxHead */
     size_t uxSize = uxStreamBufferMidSpace( pxBuffer );
-    size_t uxMid = pxBuffer->uxMid;
+    size_t uxMid = sbLOAD_RELAXED( pxBuffer->uxMid );
     size_t uxMoveCount = uxCount;
 
     if( uxMoveCount > uxSize )
@@ -192,7 +192,7 @@ void vStreamBufferMoveMid( StreamBuffer_t * pxBuffer,
         uxMid -= pxBuffer->LENGTH;
     }
 
-    pxBuffer->uxMid = uxMid;
+    ( void ) sbSTORE_RELEASE( pxBuffer->uxMid, uxMid );
 }
 /*-----------------------------------------------------------*/
 
@@ -210,7 +210,7 @@ BaseType_t xStreamBufferLessThenEqual( const StreamBuffer_t * pxBuffer,
                                        const size_t uxRight )
 {
     BaseType_t xReturn = pdFALSE;
-    size_t uxTail = pxBuffer->uxTail;
+    size_t uxTail = sbLOAD_ACQUIRE( pxBuffer->uxTail );
 
     /* Returns true if ( uxLeft <= uxRight ) */
     if( ( uxLeft - uxTail ) <= ( uxRight - uxTail ) )
@@ -236,15 +236,67 @@ BaseType_t xStreamBufferLessThenEqual( const StreamBuffer_t * pxBuffer,
 size_t uxStreamBufferGetPtr( StreamBuffer_t * pxBuffer,
                              uint8_t ** ppucData )
 {
-    size_t uxNextTail = pxBuffer->uxTail;
+    size_t uxNextTail = sbLOAD_RELAXED( pxBuffer->uxTail );
     size_t uxSize = uxStreamBufferGetSize( pxBuffer );
 
     *ppucData = pxBuffer->ucArray + uxNextTail;
 
-    return FreeRTOS_min_size_t( uxSize, pxBuffer->LENGTH - uxNextTail );
+    /* A mirror behind the end of the stream makes more data contiguous. */
+    return FreeRTOS_min_size_t( uxSize, ( pxBuffer->LENGTH + sbMIRROR_OF( pxBuffer ) ) - uxNextTail );
 }
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigSTREAM_BUFFER_MIRROR_SIZE != 0 )
+
+/**
+ * @brief Make the start of the stream and its mirror equal again, after bytes
+ *        have been written to the stream.
+ *
+ * @param[in] pxBuffer: The circular stream buffer.
+ * @param[in] uxStart: The position of the first byte that was written.
+ * @param[in] uxCount: The number of bytes that were written.
+ * @param[in] xInMirror: pdTRUE when the bytes beyond the end of the stream were
+ *                       written to the mirror, through a pointer obtained from
+ *                       FreeRTOS_get_tx_head().  pdFALSE when they were written
+ *                       to the start of the stream.
+ */
+    static void prvStreamBufferSyncMirror( StreamBuffer_t * pxBuffer,
+                                           size_t uxStart,
+                                           size_t uxCount,
+                                           BaseType_t xInMirror )
+    {
+        size_t uxMirror = sbMIRROR_OF( pxBuffer );
+        size_t uxEnd = uxStart + uxCount;
+        size_t uxWrapped;
+
+        if( uxStart < uxMirror )
+        {
+            /* Bytes were written to the start of the stream, which is mirrored. */
+            ( void ) memcpy( &( pxBuffer->ucArray[ pxBuffer->LENGTH + uxStart ] ),
+                             &( pxBuffer->ucArray[ uxStart ] ),
+                             FreeRTOS_min_size_t( uxEnd, uxMirror ) - uxStart );
+        }
+
+        if( uxEnd > pxBuffer->LENGTH )
+        {
+            /* The bytes wrapped around the end of the stream.  They never reach
+             * the position 'uxStart', so the two copies do not overlap. */
+            uxWrapped = FreeRTOS_min_size_t( uxEnd - pxBuffer->LENGTH, uxMirror );
+
+            if( xInMirror != pdFALSE )
+            {
+                ( void ) memcpy( pxBuffer->ucArray, &( pxBuffer->ucArray[ pxBuffer->LENGTH ] ), uxWrapped );
+            }
+            else
+            {
+                ( void ) memcpy( &( pxBuffer->ucArray[ pxBuffer->LENGTH ] ), pxBuffer->ucArray, uxWrapped );
+            }
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigSTREAM_BUFFER_MIRROR_SIZE */
+
 /**
  * @brief Adds data to a stream buffer.
  *
@@ -283,7 +335,7 @@ size_t uxStreamBufferAdd( StreamBuffer_t * pxBuffer,
 
     if( uxCount != 0U )
     {
-        uxNextHead = pxBuffer->uxHead;
+        uxNextHead = sbLOAD_RELAXED( pxBuffer->uxHead );
 
         if( uxOffset != 0U )
         {
@@ -316,6 +368,14 @@ size_t uxStreamBufferAdd( StreamBuffer_t * pxBuffer,
             }
         }
 
+        #if ( ipconfigSTREAM_BUFFER_MIRROR_SIZE != 0 )
+            {
+                /* When 'pucData' is NULL, the bytes have been written in-place,
+                 * and those beyond the end of the stream are in the mirror. */
+                prvStreamBufferSyncMirror( pxBuffer, uxNextHead, uxCount, ( pucData == NULL ) ? pdTRUE : pdFALSE );
+            }
+        #endif
+
         if( uxOffset == 0U )
         {
             /* ( uxOffset == 0 ) means: write at uxHead position */
@@ -326,13 +386,15 @@ size_t uxStreamBufferAdd( StreamBuffer_t * pxBuffer,
                 uxNextHead -= pxBuffer->LENGTH;
             }
 
-            pxBuffer->uxHead = uxNextHead;
+            /* The data has been copied, now it may become visible to the
+             * consumer. */
+            ( void ) sbSTORE_RELEASE( pxBuffer->uxHead, uxNextHead );
         }
 
-        if( xStreamBufferLessThenEqual( pxBuffer, pxBuffer->uxFront, uxNextHead ) != pdFALSE )
+        if( xStreamBufferLessThenEqual( pxBuffer, sbLOAD_RELAXED( pxBuffer->uxFront ), uxNextHead ) != pdFALSE )
         {
             /* Advance the front pointer */
-            pxBuffer->uxFront = uxNextHead;
+            ( void ) sbSTORE_RELEASE( pxBuffer->uxFront, uxNextHead );
         }
     }
 
@@ -377,7 +439,7 @@ size_t uxStreamBufferGet( StreamBuffer_t * pxBuffer,
 
     if( uxCount > 0U )
     {
-        uxNextTail = pxBuffer->uxTail;
+        uxNextTail = sbLOAD_RELAXED( pxBuffer->uxTail );
 
         if( uxOffset != 0U )
         {
@@ -393,8 +455,8 @@ size_t uxStreamBufferGet( StreamBuffer_t * pxBuffer,
         {
             /* Calculate the number of bytes that can be read - which may be
              * less than the number wanted if the data wraps around to the start of
-             * the buffer. */
-            uxFirst = FreeRTOS_min_size_t( pxBuffer->LENGTH - uxNextTail, uxCount );
+             * the buffer, and reaches beyond the mirror. */
+            uxFirst = FreeRTOS_min_size_t( ( pxBuffer->LENGTH + sbMIRROR_OF( pxBuffer ) ) - uxNextTail, uxCount );
 
             /* Obtain the number of bytes it is possible to obtain in the first
              * read. */
@@ -405,7 +467,7 @@ size_t uxStreamBufferGet( StreamBuffer_t * pxBuffer,
             if( uxCount > uxFirst )
             {
                 /*...then read the remaining bytes from the start of the buffer. */
-                ( void ) memcpy( &( pucData[ uxFirst ] ), pxBuffer->ucArray, uxCount - uxFirst );
+                ( void ) memcpy( &( pucData[ uxFirst ] ), &( pxBuffer->ucArray[ ( uxNextTail + uxFirst ) - pxBuffer->LENGTH ] ), uxCount - uxFirst );
             }
         }
 
@@ -420,7 +482,9 @@ size_t uxStreamBufferGet( StreamBuffer_t * pxBuffer,
                 uxNextTail -= pxBuffer->LENGTH;
             }
 
-            pxBuffer->uxTail = uxNextTail;
+            /* The data has been copied, now the space may be used by the
+             * producer. */
+            ( void ) sbSTORE_RELEASE( pxBuffer->uxTail, uxNextTail );
         }
     }
 
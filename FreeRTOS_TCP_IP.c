@@ -241,6 +241,13 @@
     static UBaseType_t prvSetSynAckOptions( FreeRTOS_Socket_t * pxSocket,
                                             TCPHeader_t * pxTCPHeader );
 
+/*
+ * Write the MSS, window scale and SACK-permitted options of a SYN or SYN+ACK.
+ */
+    static UBaseType_t prvWriteSynAckOptions( TCPHeader_t * pxTCPHeader,
+                                              uint16_t usMSS,
+                                              uint8_t ucWinScaleFactor );
+
 /*
  * For anti-hang protection and TCP keep-alive messages.  Called in two places:
  * after receiving a packet and after a state change.  The socket's alive timer
@@ -288,6 +295,34 @@
                                       NetworkBufferDescriptor_t * pxNetworkBuffer,
                                       uint32_t ulReceiveLength );
 
+    #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 )
+
+/*
+ * Called from prvStoreRxData().  Measure the amount of data received per
+ * round-trip time, and grow or shrink the rxStream accordingly.
+ */
+        static void prvTCPRxAutoTune( FreeRTOS_Socket_t * pxSocket,
+                                      uint32_t ulReceiveLength );
+    #endif
+
+    #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+
+/*
+ * Called from prvHandleEstablished().  Measure the amount of data acknowledged
+ * per round-trip time, and grow or shrink the txStream accordingly.
+ */
+        static void prvTCPTxAutoTune( FreeRTOS_Socket_t * pxSocket,
+                                      uint32_t ulAckedLength );
+    #endif
+
+    #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+
+/*
+ * Check if enough space is free in the txStream to wake up a writer.
+ */
+        static BaseType_t prvTCPSendLowatReached( FreeRTOS_Socket_t * pxSocket );
+    #endif
+
 /*
  * Set the TCP options (if any) for the outgoing packet.
  */
@@ -321,6 +356,18 @@
                                    uint32_t ulReceiveLength,
                                    BaseType_t xByteCount );
 
+    #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+
+/*
+ * Called from prvSendData() when data has been received in the established
+ * state.  Applies the socket's ACK policy and updates the ACK counters.
+ */
+        static BaseType_t prvTCPAckPolicyCheck( FreeRTOS_Socket_t * pxSocket,
+                                                uint32_t ulReceiveLength,
+                                                BaseType_t xMayDelay,
+                                                BaseType_t xWindowIsSmall );
+    #endif
+
 /*
  * The heart of all: check incoming packet for valid data and acks and do what
  * is necessary in each state.
@@ -352,6 +399,11 @@
  */
     static void prvSocketSetMSS( FreeRTOS_Socket_t * pxSocket );
 
+/*
+ * Determine the MSS that will be used for a peer.
+ */
+    static uint32_t prvTCPMSSForPeer( uint32_t ulRemoteIP );
+
 /*
  * Return either a newly created socket, or the current socket in a connected
  * state (depends on the 'bReuseSocket' flag).
@@ -366,6 +418,114 @@
     static BaseType_t prvTCPSocketCopy( FreeRTOS_Socket_t * pxNewSocket,
                                         FreeRTOS_Socket_t * pxSocket );
 
+/*
+ * Create a child socket for a listening socket.
+ */
+    static FreeRTOS_Socket_t * prvTCPCreateChild( FreeRTOS_Socket_t * pxSocket,
+                                                  NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*
+ * Prepare a socket that answers a connection request from a peer.
+ */
+    static void prvTCPListenSetup( FreeRTOS_Socket_t * pxSocket,
+                                   const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                   uint32_t ulInitialSequenceNumber,
+                                   uint32_t ulRemoteSequenceNumber );
+
+    #if ( ipconfigTCP_SYN_QUEUE != 0 )
+
+/** @brief A connection request that was answered with a SYN+ACK, for which the
+ *         final ACK has not been received yet. */
+        typedef struct xTCP_SYN_ENTRY
+        {
+            uint32_t ulRemoteIP;       /**< The IP-address of the peer, in host-endian notation. */
+            uint32_t ulRemoteSequence; /**< The sequence number of the SYN of the peer. */
+            uint32_t ulOurSequence;    /**< The sequence number of our SYN+ACK. */
+            TickType_t xCreateTime;    /**< The time at which the first SYN was received. */
+            uint16_t usRemotePort;     /**< The port number of the peer. */
+            uint16_t usLocalPort;      /**< The port number of the listening socket, or zero when the entry is free. */
+            uint16_t usPeerMSS;        /**< The MSS option of the peer, or zero when it was absent. */
+            uint8_t ucPeerWinScale;    /**< The window scale option of the peer. */
+            uint8_t ucHasWinScale;     /**< pdTRUE when the peer sent a window scale option. */
+        } TCPSynEntry_t;
+
+/** @brief The table of half-open connections, only accessed by the IP-task. */
+        static TCPSynEntry_t xTCPSynQueue[ ipconfigTCP_SYN_QUEUE_LENGTH ];
+
+/*
+ * Store a connection request in the table of half-open connections, and answer
+ * it with a SYN+ACK.
+ */
+        static void prvTCPSynQueueAdd( const FreeRTOS_Socket_t * pxSocket,
+                                       NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                       uint32_t ulInitialSequenceNumber );
+
+/*
+ * Check if a packet completes a handshake that was stored in the table of
+ * half-open connections, and if so, create the child socket.
+ */
+        static BaseType_t prvTCPSynQueueAccept( FreeRTOS_Socket_t ** ppxSocket,
+                                                NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*
+ * Find the entry of a half-open connection, dropping entries that have expired.
+ */
+        static TCPSynEntry_t * prvTCPSynQueueFind( uint16_t usLocalPort,
+                                                   uint32_t ulRemoteIP,
+                                                   uint16_t usRemotePort );
+
+/*
+ * Read the MSS and window scale options from a SYN.
+ */
+        static void prvTCPSynQueueOptions( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                           TCPSynEntry_t * pxEntry );
+    #endif /* ipconfigTCP_SYN_QUEUE */
+
+    #if ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+
+/** @brief A connection that was closed by this side, and which is waiting for
+ *         old packets to disappear from the network. */
+        typedef struct xTCP_TIME_WAIT_ENTRY
+        {
+            uint32_t ulRemoteIP;       /**< The IP-address of the peer, in host-endian notation. */
+            uint32_t ulRemoteSequence; /**< The sequence number that follows the FIN of the peer. */
+            uint32_t ulOurSequence;    /**< The sequence number that follows our FIN. */
+            uint32_t ulWindowSize;     /**< The last window advertised by the peer, after scaling. */
+            TickType_t xCloseTime;     /**< The time at which the last ACK was sent. */
+            uint16_t usRemotePort;     /**< The port number of the peer. */
+            uint16_t usLocalPort;      /**< The local port number, or zero when the entry is free. */
+        } TCPTimeWaitEntry_t;
+
+/** @brief The table of connections in TIME_WAIT, only accessed by the IP-task. */
+        static TCPTimeWaitEntry_t xTCPTimeWaitTable[ ipconfigTCP_TIME_WAIT_LENGTH ];
+
+/*
+ * Remember a connection that has been closed in the TIME_WAIT table.
+ */
+        static void prvTCPTimeWaitAdd( const FreeRTOS_Socket_t * pxSocket );
+
+/*
+ * Check if a packet that can not be handled by an active socket belongs to a
+ * connection in the TIME_WAIT table.
+ */
+        static BaseType_t prvTCPTimeWaitCheck( const FreeRTOS_Socket_t * pxSocket,
+                                               NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*
+ * Forget a connection in the TIME_WAIT table before reusing its port numbers,
+ * and return an initial sequence number beyond the old connection.
+ */
+        static uint32_t prvTCPTimeWaitReuse( const FreeRTOS_Socket_t * pxSocket,
+                                             uint32_t ulInitialSequenceNumber );
+
+/*
+ * Find a connection in the TIME_WAIT table, dropping entries that have expired.
+ */
+        static TCPTimeWaitEntry_t * prvTCPTimeWaitFind( uint16_t usLocalPort,
+                                                        uint32_t ulRemoteIP,
+                                                        uint16_t usRemotePort );
+    #endif /* ipconfigTCP_TIME_WAIT_TABLE */
+
 /*
  * prvTCPStatusAgeCheck() will see if the socket has been in a non-connected
  * state for too long.  If so, the socket will be closed, and -1 will be
@@ -384,6 +544,50 @@
         static uint8_t prvWinScaleFactor( const FreeRTOS_Socket_t * pxSocket );
     #endif
 
+    #if ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) && ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION == 0 )
+
+/*
+ * Split a TCP super-segment into segments of at most 'uxSegmentSize' bytes
+ * and pass each of them to the network interface.
+ */
+        static void prvTCPSendSegmented( FreeRTOS_Socket_t * pxSocket,
+                                         const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                         size_t uxHeaderLength,
+                                         size_t uxSegmentSize );
+    #endif
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+
+/*
+ * Look up the MAC-address of the peer again after a change in the ARP cache.
+ */
+        static void prvTCPCheckPeerMAC( FreeRTOS_Socket_t * pxSocket,
+                                        EthernetHeader_t * pxEthernetHeader );
+    #endif
+
+    #if ( ipconfigUSE_TCP_RX_COALESCING != 0 )
+
+/*
+ * Return the number of payload bytes of a received packet when it is a TCP
+ * segment that may be coalesced with its neighbours, otherwise zero.
+ */
+        static size_t prvCoalesceCandidate( const NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*
+ * Check if 'pxNext' continues the flow of 'pxPrevious' without a gap.
+ */
+        static BaseType_t prvCoalesceMatch( const TCPPacket_t * pxPrevious,
+                                            const TCPPacket_t * pxNext,
+                                            uint32_t ulExpectedSequence );
+
+/*
+ * Copy a run of 'uxCount' coalescable segments into a new network buffer.
+ */
+        static NetworkBufferDescriptor_t * prvCoalesceMerge( const NetworkBufferDescriptor_t * pxFirstBuffer,
+                                                             size_t uxCount,
+                                                             size_t uxPayloadLength );
+    #endif
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -588,6 +792,12 @@
 
                             prvTCPReturnPacket( pxSocket, pxSocket->u.xTCP.pxAckMessage, ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER, ipconfigZERO_COPY_TX_DRIVER );
 
+                            #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                                {
+                                    pxSocket->u.xTCP.xAckStatistics.ulTimerAcks++;
+                                }
+                            #endif
+
                             #if ( ipconfigZERO_COPY_TX_DRIVER != 0 )
                                 {
                                     /* The ownership has been passed to the SEND routine,
@@ -829,6 +1039,11 @@
         const void * pvCopySource;
         void * pvCopyDest;
 
+        #if ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 )
+            size_t uxHeaderLength;
+            size_t uxSegmentSize = 0U;
+        #endif
+
 
         /* For sending, a pseudo network buffer will be used, as explained above. */
 
@@ -880,6 +1095,14 @@
                  * size of this socket's reception window. */
                 pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
 
+                #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                    {
+                        /* This packet acknowledges all data received so far. */
+                        pxSocket->u.xTCP.ucAckPendingSegments = 0U;
+                        pxSocket->u.xTCP.bits.bAckNow = pdFALSE_UNSIGNED;
+                    }
+                #endif
+
                 if( pxSocket->u.xTCP.rxStream != NULL )
                 {
                     /* An RX stream was created already, see how much space is
@@ -1020,7 +1243,32 @@
             pxNetworkBuffer->xDataLength = ( size_t ) ulLen;
             pxNetworkBuffer->xDataLength += ipSIZE_OF_ETH_HEADER;
 
+            #if ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 )
+                {
+                    /* The length of the Ethernet, IP and TCP headers, including options. */
+                    uxHeaderLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER;
+                    uxHeaderLength += ( size_t ) ( ( pxTCPPacket->xTCPHeader.ucTCPOffset & tcpVALID_BITS_IN_TCP_OFFSET_BYTE ) >> 2 );
+
+                    /* The sliding window has cut the data in segments of its MSS. */
+                    if( ( pxSocket != NULL ) && ( pxNetworkBuffer->xDataLength > ( uxHeaderLength + ( size_t ) pxSocket->u.xTCP.xTCPWindow.usMSS ) ) )
+                    {
+                        /* This is a super-segment, it must be split before it is sent. */
+                        uxSegmentSize = ( size_t ) pxSocket->u.xTCP.xTCPWindow.usMSS;
+                    }
+
+                    #if ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION != 0 )
+                        {
+                            pxNetworkBuffer->usSegmentSize = ( uint16_t ) uxSegmentSize;
+                        }
+                    #endif
+                }
+            #endif /* ipconfigUSE_TCP_SEGMENTATION_OFFLOAD */
+
             #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                #if ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 )
+                    /* The checksums of a super-segment are calculated per segment. */
+                    if( uxSegmentSize == 0U )
+                #endif
                 {
                     /* calculate the IP header checksum, in case the driver won't do that. */
                     pxIPHeader->usHeaderChecksum = 0x00U;
@@ -1038,6 +1286,13 @@
                 }
             #endif
 
+            #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+                if( ( pxSocket != NULL ) && ( pxSocket->u.xTCP.ulARPGeneration != ulARPGetGeneration() ) )
+                {
+                    prvTCPCheckPeerMAC( pxSocket, pxEthernetHeader );
+                }
+            #endif
+
             /* Fill in the destination MAC addresses. */
             ( void ) memcpy( ( void * ) ( &( pxEthernetHeader->xDestinationAddress ) ),
                              ( const void * ) ( &( pxEthernetHeader->xSourceAddress ) ),
@@ -1069,9 +1324,25 @@
                 }
             #endif /* if defined( ipconfigETHERNET_MINIMUM_PACKET_BYTES ) */
 
-            /* Send! */
-            iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
-            ( void ) xNetworkInterfaceOutput( pxNetworkBuffer, xDoRelease );
+            #if ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) && ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION == 0 )
+                if( uxSegmentSize != 0U )
+                {
+                    /* The driver can not segment, do it here. */
+                    prvTCPSendSegmented( pxSocket, pxNetworkBuffer, uxHeaderLength, uxSegmentSize );
+
+                    if( xDoRelease != pdFALSE )
+                    {
+                        /* The ownership of the super-segment was passed to this function. */
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    }
+                }
+                else
+            #endif /* ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) && ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION == 0 ) */
+            {
+                /* Send! */
+                iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
+                ( void ) xNetworkInterfaceOutput( pxNetworkBuffer, xDoRelease );
+            }
 
             if( xDoRelease == pdFALSE )
             {
@@ -1089,6 +1360,146 @@
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+
+/**
+ * @brief The MAC-address of the peer is stored in the packet header of the
+ *        socket, and it is not looked up for every packet.  When the ARP cache
+ *        or the address configuration has changed, look it up again.  When it
+ *        is not in the ARP cache, the stored MAC-address is kept.
+ *
+ * @param[in] pxSocket: The socket of the connection.
+ * @param[in] pxEthernetHeader: The Ethernet header of the packet to be sent,
+ *                              still with the MAC-address of the peer as source.
+ */
+        static void prvTCPCheckPeerMAC( FreeRTOS_Socket_t * pxSocket,
+                                        EthernetHeader_t * pxEthernetHeader )
+        {
+            uint32_t ulRemoteIP = FreeRTOS_htonl( pxSocket->u.xTCP.ulRemoteIP );
+            MACAddress_t xEthAddress;
+            EthernetHeader_t * pxTemplateHeader;
+
+            if( eARPGetCacheEntry( &( ulRemoteIP ), &( xEthAddress ) ) == eARPCacheHit )
+            {
+                pxTemplateHeader = ipCAST_PTR_TO_TYPE_PTR( EthernetHeader_t, pxSocket->u.xTCP.xPacket.u.ucLastPacket );
+                ( void ) memcpy( pxTemplateHeader->xSourceAddress.ucBytes, xEthAddress.ucBytes, sizeof( xEthAddress.ucBytes ) );
+                ( void ) memcpy( pxEthernetHeader->xSourceAddress.ucBytes, xEthAddress.ucBytes, sizeof( xEthAddress.ucBytes ) );
+            }
+
+            pxSocket->u.xTCP.ulARPGeneration = ulARPGetGeneration();
+        }
+
+    #endif /* ipconfigUSE_DESTINATION_CACHE */
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) && ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION == 0 )
+
+/**
+ * @brief Split a TCP super-segment and send the parts.  The headers of the
+ *        super-segment are used as a template: only the sequence number, the
+ *        IP length and identification, the flags and the checksums are changed
+ *        per segment.  The payload of each segment is copied directly from the
+ *        txStream, prvTCPPrepareSend() did not copy it into the super-segment.
+ *
+ * @param[in] pxSocket: The socket owning the connection.
+ * @param[in] pxNetworkBuffer: The network buffer holding the headers of the
+ *                             super-segment. It is not released by this function.
+ * @param[in] uxHeaderLength: The length of the Ethernet, IP and TCP headers.
+ * @param[in] uxSegmentSize: The maximum number of payload bytes per segment.
+ */
+        static void prvTCPSendSegmented( FreeRTOS_Socket_t * pxSocket,
+                                         const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                         size_t uxHeaderLength,
+                                         size_t uxSegmentSize )
+        {
+            const TCPPacket_t * pxSuperPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+            StreamBuffer_t * pxStream = pxSocket->u.xTCP.txStream;
+            TCPPacket_t * pxTCPPacket;
+            NetworkBufferDescriptor_t * pxSegment;
+            size_t uxDataLength = pxNetworkBuffer->xDataLength - uxHeaderLength;
+            size_t uxDone = 0U;
+            size_t uxStreamOffset;
+            size_t uxLength;
+            size_t uxBufferLength;
+            uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxSuperPacket->xTCPHeader.ulSequenceNumber );
+
+            /* Translate the position in txStream to an offset from the tail marker. */
+            uxStreamOffset = uxStreamBufferDistance( pxStream, pxStream->uxTail, ( size_t ) pxSocket->u.xTCP.lBurstStreamPos );
+
+            while( uxDone < uxDataLength )
+            {
+                uxLength = FreeRTOS_min_size_t( uxSegmentSize, uxDataLength - uxDone );
+                uxBufferLength = uxHeaderLength + uxLength;
+
+                #if defined( ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+                    {
+                        uxBufferLength = FreeRTOS_max_size_t( uxBufferLength, ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES );
+                    }
+                #endif
+
+                pxSegment = pxGetNetworkBufferWithDescriptor( uxBufferLength, 0U );
+
+                if( pxSegment == NULL )
+                {
+                    /* Out of network buffers.  The sliding window will retransmit
+                     * the remaining data when it is not acknowledged. */
+                    break;
+                }
+
+                /* Copy the header template, followed by the payload of this
+                 * segment, which is taken from the txStream in 'peek' mode. */
+                ( void ) memcpy( pxSegment->pucEthernetBuffer, pxNetworkBuffer->pucEthernetBuffer, uxHeaderLength );
+                ( void ) uxStreamBufferGet( pxStream, uxStreamOffset + uxDone, &( pxSegment->pucEthernetBuffer[ uxHeaderLength ] ), uxLength, pdTRUE );
+                pxSegment->xDataLength = uxHeaderLength + uxLength;
+
+                pxTCPPacket = ipCAST_PTR_TO_TYPE_PTR( TCPPacket_t, pxSegment->pucEthernetBuffer );
+                pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
+                pxTCPPacket->xIPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( pxSegment->xDataLength - ipSIZE_OF_ETH_HEADER ) );
+
+                if( uxDone != 0U )
+                {
+                    /* The first segment keeps the identification of the template. */
+                    pxTCPPacket->xIPHeader.usIdentification = FreeRTOS_htons( usPacketIdentifier );
+                    usPacketIdentifier++;
+                }
+
+                if( ( uxDone + uxLength ) < uxDataLength )
+                {
+                    /* Only the last segment may carry the PSH and FIN flags. */
+                    pxTCPPacket->xTCPHeader.ucTCPFlags &= ( ( uint8_t ) ~( tcpTCP_FLAG_PSH | tcpTCP_FLAG_FIN ) );
+                }
+
+                #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                    {
+                        pxTCPPacket->xIPHeader.usHeaderChecksum = 0x00U;
+                        pxTCPPacket->xIPHeader.usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxTCPPacket->xIPHeader.ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+                        pxTCPPacket->xIPHeader.usHeaderChecksum = ~FreeRTOS_htons( pxTCPPacket->xIPHeader.usHeaderChecksum );
+
+                        ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxTCPPacket, pxSegment->xDataLength, pdTRUE );
+                    }
+                #endif /* ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 */
+
+                #if defined( ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+                    {
+                        if( pxSegment->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+                        {
+                            ( void ) memset( &( pxSegment->pucEthernetBuffer[ pxSegment->xDataLength ] ), 0, ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES - pxSegment->xDataLength );
+                            pxSegment->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
+                        }
+                    }
+                #endif /* if defined( ipconfigETHERNET_MINIMUM_PACKET_BYTES ) */
+
+                iptraceNETWORK_INTERFACE_OUTPUT( pxSegment->xDataLength, pxSegment->pucEthernetBuffer );
+                ( void ) xNetworkInterfaceOutput( pxSegment, pdTRUE );
+
+                ulSequenceNumber += ( uint32_t ) uxLength;
+                uxDone += uxLength;
+            }
+        }
+
+    #endif /* ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) && ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION == 0 ) */
+    /*-----------------------------------------------------------*/
+
 /**
  * @brief Create the TCP window for the given socket.
  *
@@ -1104,6 +1515,32 @@
         uint32_t ulRxWindowSize = ( uint32_t ) pxSocket->u.xTCP.uxRxWinSize;
         uint32_t ulTxWindowSize = ( uint32_t ) pxSocket->u.xTCP.uxTxWinSize;
 
+        #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 )
+            {
+                if( pxSocket->u.xTCP.uxRxStreamMaxSize == 0U )
+                {
+                    /* The configured size becomes the maximum, the connection
+                     * starts with a small reception stream.  The window keeps
+                     * its size, the advertised window is limited by the space
+                     * in the stream. */
+                    pxSocket->u.xTCP.uxRxStreamMaxSize = pxSocket->u.xTCP.uxRxStreamSize;
+                    vTCPSetRxStreamSize( pxSocket, FreeRTOS_min_size_t( ( size_t ) ipconfigTCP_RX_AUTOTUNE_INITIAL_SIZE, pxSocket->u.xTCP.uxRxStreamMaxSize ) );
+                }
+
+                pxSocket->u.xTCP.uxRxStreamTargetSize = pxSocket->u.xTCP.uxRxStreamSize;
+                pxSocket->u.xTCP.ulRxTuneBytes = 0U;
+                pxSocket->u.xTCP.xRxTuneTime = xTaskGetTickCount();
+            }
+        #endif /* ipconfigUSE_TCP_RX_AUTOTUNING */
+
+        #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+            {
+                pxSocket->u.xTCP.ulTxTuneBytes = 0U;
+                pxSocket->u.xTCP.xTxTuneTime = xTaskGetTickCount();
+                pxSocket->u.xTCP.ucTxStreamLimited = 0U;
+            }
+        #endif /* ipconfigUSE_TCP_TX_AUTOTUNING */
+
         if( xTCPWindowLoggingLevel != 0 )
         {
             FreeRTOS_debug_printf( ( "Limits (using): TCP Win size %u Water %u <= %u <= %u\n",
@@ -1201,6 +1638,15 @@
             {
                 xReturn = pdFALSE;
             }
+
+            #if ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+                else
+                {
+                    /* The peer may still remember an earlier connection between
+                     * the same ports. */
+                    ulInitialSequenceNumber = prvTCPTimeWaitReuse( pxSocket, ulInitialSequenceNumber );
+                }
+            #endif
         }
 
         if( xReturn != pdFALSE )
@@ -1607,19 +2053,24 @@
             {
                 /* Just advancing the tail index, 'ulCount' bytes have been confirmed. */
                 ( void ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, 0, NULL, ( size_t ) ulCount, pdFALSE );
-                pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_SEND;
+                #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                    if( prvTCPSendLowatReached( pxSocket ) != pdFALSE )
+                #endif
+                {
+                    pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_SEND;
 
-                #if ipconfigSUPPORT_SELECT_FUNCTION == 1
-                    {
-                        if( ( pxSocket->xSelectBits & ( EventBits_t ) eSELECT_WRITE ) != 0U )
+                    #if ipconfigSUPPORT_SELECT_FUNCTION == 1
                         {
-                            /* The field 'xEventBits' is used to store regular socket events
-                             * (at most 8), as well as 'select events', which will be left-shifted.
-                             */
-                            pxSocket->xEventBits |= ( ( EventBits_t ) eSELECT_WRITE ) << SOCKET_EVENT_BIT_COUNT;
+                            if( ( pxSocket->xSelectBits & ( EventBits_t ) eSELECT_WRITE ) != 0U )
+                            {
+                                /* The field 'xEventBits' is used to store regular socket events
+                                 * (at most 8), as well as 'select events', which will be left-shifted.
+                                 */
+                                pxSocket->xEventBits |= ( ( EventBits_t ) eSELECT_WRITE ) << SOCKET_EVENT_BIT_COUNT;
+                            }
                         }
-                    }
-                #endif
+                    #endif
+                }
 
                 /* In case the socket owner has installed an OnSent handler,
                  * call it now. */
@@ -1693,7 +2144,33 @@
     static UBaseType_t prvSetSynAckOptions( FreeRTOS_Socket_t * pxSocket,
                                             TCPHeader_t * pxTCPHeader )
     {
-        uint16_t usMSS = pxSocket->u.xTCP.usMSS;
+        uint8_t ucWinScaleFactor = 0U;
+
+        #if ( ipconfigUSE_TCP_WIN != 0 )
+            {
+                pxSocket->u.xTCP.ucMyWinScaleFactor = prvWinScaleFactor( pxSocket );
+                ucWinScaleFactor = pxSocket->u.xTCP.ucMyWinScaleFactor;
+            }
+        #endif
+
+        return prvWriteSynAckOptions( pxTCPHeader, pxSocket->u.xTCP.usMSS, ucWinScaleFactor );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Write the options of a SYN or SYN+ACK: the MSS, and when TCP windows
+ *        are used, the window scale factor and SACK-permitted.
+ *
+ * @param[in,out] pxTCPHeader: The TCP header in which the options are written.
+ * @param[in] usMSS: The MSS to be advertised.
+ * @param[in] ucWinScaleFactor: The window scale factor to be advertised.
+ *
+ * @return The length of the options in bytes.
+ */
+    static UBaseType_t prvWriteSynAckOptions( TCPHeader_t * pxTCPHeader,
+                                              uint16_t usMSS,
+                                              uint8_t ucWinScaleFactor )
+    {
         UBaseType_t uxOptionsLength;
 
         /* We send out the TCP Maximum Segment Size option with our SYN[+ACK]. */
@@ -1705,16 +2182,15 @@
 
         #if ( ipconfigUSE_TCP_WIN != 0 )
             {
-                pxSocket->u.xTCP.ucMyWinScaleFactor = prvWinScaleFactor( pxSocket );
-
                 pxTCPHeader->ucOptdata[ 4 ] = tcpTCP_OPT_NOOP;
                 pxTCPHeader->ucOptdata[ 5 ] = ( uint8_t ) ( tcpTCP_OPT_WSOPT );
                 pxTCPHeader->ucOptdata[ 6 ] = ( uint8_t ) ( tcpTCP_OPT_WSOPT_LEN );
-                pxTCPHeader->ucOptdata[ 7 ] = ( uint8_t ) pxSocket->u.xTCP.ucMyWinScaleFactor;
+                pxTCPHeader->ucOptdata[ 7 ] = ucWinScaleFactor;
                 uxOptionsLength = 8U;
             }
         #else
             {
+                ( void ) ucWinScaleFactor;
                 uxOptionsLength = 4U;
             }
         #endif /* if ( ipconfigUSE_TCP_WIN != 0 ) */
@@ -1790,6 +2266,13 @@
             /* Is the socket connected now ? */
             if( bAfter != pdFALSE )
             {
+                #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                    {
+                        /* The peer starts in slow start, do not delay the first ACK's. */
+                        pxSocket->u.xTCP.ucQuickAckRemaining = pxSocket->u.xTCP.xAckPolicy.ucQuickAckSegments;
+                    }
+                #endif
+
                 /* if bPassQueued is true, this socket is an orphan until it gets connected. */
                 if( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED )
                 {
@@ -2109,7 +2592,26 @@
              * Because some TCP-stacks (like uIP) use it for flow-control. */
             if( pxSocket->u.xTCP.usMSS > 1U )
             {
-                lDataLen = ( int32_t ) ulTCPWindowTxGet( pxTCPWindow, pxSocket->u.xTCP.ulWindowSize, &lStreamPos );
+                #if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 )
+                    {
+                        /* The sliding window cuts the data in segments of its
+                         * own MSS, which is also used to split a super-segment. */
+                        uint32_t ulMaxLength = ( uint32_t ) pxTCPWindow->usMSS;
+
+                        if( xBufferAllocFixedSize == pdFALSE )
+                        {
+                            /* Network buffers have a variable size, so several
+                             * segments can be combined into one super-segment. */
+                            ulMaxLength *= ( uint32_t ) ipconfigTCP_SEGMENTATION_OFFLOAD_MAX_SEGMENTS;
+                        }
+
+                        lDataLen = ( int32_t ) ulTCPWindowTxGetBurst( pxTCPWindow, pxSocket->u.xTCP.ulWindowSize, &lStreamPos, ulMaxLength );
+                    }
+                #else
+                    {
+                        lDataLen = ( int32_t ) ulTCPWindowTxGet( pxTCPWindow, pxSocket->u.xTCP.ulWindowSize, &lStreamPos );
+                    }
+                #endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) */
             }
 
             if( lDataLen > 0 )
@@ -2129,23 +2631,36 @@
 
                     pucSendData = &( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength ] );
 
-                    /* Translate the position in txStream to an offset from the tail
-                     * marker. */
-                    uxOffset = uxStreamBufferDistance( pxSocket->u.xTCP.txStream, pxSocket->u.xTCP.txStream->uxTail, ( size_t ) lStreamPos );
+                    #if ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) && ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION == 0 )
+                        if( lDataLen > ( int32_t ) pxTCPWindow->usMSS )
+                        {
+                            /* This super-segment will be split by prvTCPSendSegmented(),
+                             * which copies the data of each segment directly from the
+                             * txStream. */
+                            pxSocket->u.xTCP.lBurstStreamPos = lStreamPos;
+                            ulDataGot = ( uint32_t ) lDataLen;
+                        }
+                        else
+                    #endif
+                    {
+                        /* Translate the position in txStream to an offset from the tail
+                         * marker. */
+                        uxOffset = uxStreamBufferDistance( pxSocket->u.xTCP.txStream, pxSocket->u.xTCP.txStream->uxTail, ( size_t ) lStreamPos );
 
-                    /* Here data is copied from the txStream in 'peek' mode.  Only
-                     * when the packets are acked, the tail marker will be updated. */
-                    ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
+                        /* Here data is copied from the txStream in 'peek' mode.  Only
+                         * when the packets are acked, the tail marker will be updated. */
+                        ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
 
-                    #if ( ipconfigHAS_DEBUG_PRINTF != 0 )
-                        {
-                            if( ulDataGot != ( uint32_t ) lDataLen )
+                        #if ( ipconfigHAS_DEBUG_PRINTF != 0 )
                             {
-                                FreeRTOS_debug_printf( ( "uxStreamBufferGet: pos %d offs %u only %u != %d\n",
-                                                         ( int ) lStreamPos, ( unsigned ) uxOffset, ( unsigned ) ulDataGot, ( int ) lDataLen ) );
+                                if( ulDataGot != ( uint32_t ) lDataLen )
+                                {
+                                    FreeRTOS_debug_printf( ( "uxStreamBufferGet: pos %d offs %u only %u != %d\n",
+                                                             ( int ) lStreamPos, ( unsigned ) uxOffset, ( unsigned ) ulDataGot, ( int ) lDataLen ) );
+                                }
                             }
-                        }
-                    #endif
+                        #endif
+                    }
 
                     /* If the owner of the socket requests a closure, add the FIN
                      * flag to the last packet. */
@@ -2453,6 +2968,30 @@
                     /* This is the third of the three-way hand shake: the last
                      * ACK. */
                     pxTCPHeader->ucTCPFlags = tcpTCP_FLAG_ACK;
+
+                    #if ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+                        {
+                            /* The TIME_WAIT state is kept in the table, the socket
+                             * does not need its window segments and streams
+                             * anymore. */
+                            prvTCPTimeWaitAdd( pxSocket );
+                            vTCPWindowDestroy( pxTCPWindow );
+
+                            if( ( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED ) &&
+                                ( ( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) ||
+                                  ( pxSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) ) )
+                            {
+                                /* A child socket that was never accepted: nobody
+                                 * will close it, so delete it as soon as the last
+                                 * ACK has been sent. */
+                                vSocketCloseNextTime( pxSocket );
+                            }
+                            else
+                            {
+                                vTCPReleaseStreams( pxSocket );
+                            }
+                        }
+                    #endif
                 }
                 else
                 {
@@ -2609,6 +3148,12 @@
              * ack (SACK) option to confirm it.  In that case, lTCPAddRxdata() will be
              * called later to store an out-of-order packet (in case lOffset is
              * negative). */
+            #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 )
+                {
+                    prvTCPRxAutoTune( pxSocket, ulReceiveLength );
+                }
+            #endif
+
             if( pxSocket->u.xTCP.rxStream != NULL )
             {
                 ulSpace = ( uint32_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.rxStream );
@@ -2620,10 +3165,21 @@
 
             lOffset = lTCPWindowRxCheck( pxTCPWindow, ulSequenceNumber, ulReceiveLength, ulSpace );
 
-            if( lOffset >= 0 )
-            {
-                /* New data has arrived and may be made available to the user.  See
-                 * if the head marker in rxStream may be advanced, only if lOffset == 0.
+            #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                {
+                    if( lOffset != 0 )
+                    {
+                        /* The data was not expected, or it was stored out of order.
+                         * The peer must learn about it as soon as possible. */
+                        pxSocket->u.xTCP.bits.bAckNow = pdTRUE_UNSIGNED;
+                    }
+                }
+            #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
+            if( lOffset >= 0 )
+            {
+                /* New data has arrived and may be made available to the user.  See
+                 * if the head marker in rxStream may be advanced, only if lOffset == 0.
                  * In case the low-water mark is reached, bLowWater will be set
                  * "low-water" here stands for "little space". */
                 lStored = lTCPAddRxdata( pxSocket, ( uint32_t ) lOffset, pucRecvData, ulReceiveLength );
@@ -2651,6 +3207,13 @@
                     {
                         ( void ) lTCPAddRxdata( pxSocket, 0U, NULL, pxTCPWindow->ulUserDataLength );
                         pxTCPWindow->ulUserDataLength = 0;
+
+                        #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                            {
+                                /* A gap has been filled, acknowledge it immediately. */
+                                pxSocket->u.xTCP.bits.bAckNow = pdTRUE_UNSIGNED;
+                            }
+                        #endif
                     }
                 }
             #endif /* ipconfigUSE_TCP_WIN */
@@ -2664,6 +3227,194 @@
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 )
+
+/**
+ * @brief Receive buffer auto-tuning.  Count the bytes received during about one
+ *        round-trip time.  The rxStream should be able to hold twice that amount
+ *        so that the peer will not be limited by the advertised window.  When the
+ *        free heap becomes low, the stream returns to its initial size.  The
+ *        stream is replaced as soon as it is empty.
+ *
+ * @param[in] pxSocket: The socket owning the connection.
+ * @param[in] ulReceiveLength: The number of bytes that have just been received.
+ */
+        static void prvTCPRxAutoTune( FreeRTOS_Socket_t * pxSocket,
+                                      uint32_t ulReceiveLength )
+        {
+            IPTCPSocket_t * pxTCP = &( pxSocket->u.xTCP );
+            TickType_t xNow = xTaskGetTickCount();
+            TickType_t xRoundTrip;
+            size_t uxTarget;
+            size_t uxInitialSize = FreeRTOS_min_size_t( ( size_t ) ipconfigTCP_RX_AUTOTUNE_INITIAL_SIZE, pxTCP->uxRxStreamMaxSize );
+            BaseType_t xLowMemory = ( xPortGetFreeHeapSize() < ( size_t ) ipconfigTCP_RX_AUTOTUNE_LOW_HEAP ) ? pdTRUE : pdFALSE;
+
+            pxTCP->ulRxTuneBytes += ulReceiveLength;
+
+            /* 'lSRTT' is expressed in ms. */
+            xRoundTrip = pdMS_TO_TICKS( ( uint32_t ) pxTCP->xTCPWindow.lSRTT );
+
+            if( xRoundTrip < 1U )
+            {
+                xRoundTrip = 1U;
+            }
+
+            if( ( xNow - pxTCP->xRxTuneTime ) >= xRoundTrip )
+            {
+                uxTarget = ( size_t ) FreeRTOS_round_up( 2U * pxTCP->ulRxTuneBytes, ( uint32_t ) pxTCP->usMSS );
+                uxTarget = FreeRTOS_min_size_t( uxTarget, pxTCP->uxRxStreamMaxSize );
+
+                if( ( uxTarget > pxTCP->uxRxStreamTargetSize ) && ( xLowMemory == pdFALSE ) )
+                {
+                    pxTCP->uxRxStreamTargetSize = uxTarget;
+                }
+
+                pxTCP->ulRxTuneBytes = 0U;
+                pxTCP->xRxTuneTime = xNow;
+            }
+
+            if( xLowMemory != pdFALSE )
+            {
+                pxTCP->uxRxStreamTargetSize = uxInitialSize;
+            }
+
+            if( pxTCP->uxRxStreamTargetSize == pxTCP->uxRxStreamSize )
+            {
+                /* The size is right. */
+            }
+            else if( pxTCP->rxStream == NULL )
+            {
+                /* The stream will be created with the new size. */
+                vTCPSetRxStreamSize( pxSocket, pxTCP->uxRxStreamTargetSize );
+            }
+            else if( pxTCP->ucRxStreamPinned != 0U )
+            {
+                /* The application has a direct pointer into the stream. */
+                pxTCP->uxRxStreamTargetSize = pxTCP->uxRxStreamSize;
+            }
+            else if( uxStreamBufferGetSize( pxTCP->rxStream ) == 0U )
+            {
+                if( xTCPResizeRxStream( pxSocket, pxTCP->uxRxStreamTargetSize ) == pdFALSE )
+                {
+                    /* Do not try again before the next measurement. */
+                    pxTCP->uxRxStreamTargetSize = pxTCP->uxRxStreamSize;
+                }
+            }
+            else
+            {
+                /* Wait until the user has read all data. */
+            }
+        }
+        /*-----------------------------------------------------------*/
+    #endif /* ipconfigUSE_TCP_RX_AUTOTUNING */
+
+    #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+
+/**
+ * @brief Check if enough space is free in the txStream to wake up a writer, as
+ *        set with FREERTOS_SO_SNDLOWAT.  The threshold is limited to the size
+ *        of the txStream, so an empty stream will always wake up the writer.
+ *
+ * @param[in] pxSocket: The socket owning the connection.
+ *
+ * @return pdTRUE when the writer should be woken up, otherwise pdFALSE.
+ */
+        static BaseType_t prvTCPSendLowatReached( FreeRTOS_Socket_t * pxSocket )
+        {
+            size_t uxLowat = FreeRTOS_min_size_t( pxSocket->u.xTCP.uxSndLowat, pxSocket->u.xTCP.uxTxStreamSize );
+            BaseType_t xReturn = pdTRUE;
+
+            if( uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream ) < uxLowat )
+            {
+                pxSocket->u.xTCP.xWakeStats.ulBelowLowat++;
+                xReturn = pdFALSE;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+    #endif /* ipconfigSOCKET_WAKE_COALESCING */
+
+    #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+
+/**
+ * @brief Send buffer auto-tuning.  Count the bytes acknowledged during about one
+ *        round-trip time.  When the application had to wait for space, the
+ *        txStream grows to twice that amount, but not beyond twice the effective
+ *        transmission window: more data can not be in flight.  When the stream
+ *        is used much less, it shrinks again towards its configured size.
+ *
+ * @param[in] pxSocket: The socket owning the connection.
+ * @param[in] ulAckedLength: The number of bytes that have just been acknowledged.
+ */
+        static void prvTCPTxAutoTune( FreeRTOS_Socket_t * pxSocket,
+                                      uint32_t ulAckedLength )
+        {
+            IPTCPSocket_t * pxTCP = &( pxSocket->u.xTCP );
+            TickType_t xNow = xTaskGetTickCount();
+            TickType_t xRoundTrip;
+            size_t uxCurrentSize = pxTCP->uxTxStreamSize + pxTCP->uxTxStreamGrowth;
+            size_t uxMaxSize;
+            size_t uxTarget;
+            uint32_t ulWindow;
+
+            pxTCP->ulTxTuneBytes += ulAckedLength;
+
+            /* 'lSRTT' is expressed in ms. */
+            xRoundTrip = pdMS_TO_TICKS( ( uint32_t ) pxTCP->xTCPWindow.lSRTT );
+
+            if( xRoundTrip < 1U )
+            {
+                xRoundTrip = 1U;
+            }
+
+            if( ( xNow - pxTCP->xTxTuneTime ) >= xRoundTrip )
+            {
+                /* The amount of data in flight is limited by the transmission
+                 * window and by the window advertised by the peer. */
+                ulWindow = FreeRTOS_min_uint32( pxTCP->xTCPWindow.xSize.ulTxWindowLength, pxTCP->ulWindowSize );
+                uxMaxSize = FreeRTOS_min_size_t( ( size_t ) ipconfigTCP_TX_AUTOTUNE_MAX_SIZE, 2U * ( size_t ) ulWindow );
+                uxMaxSize = FreeRTOS_max_size_t( uxMaxSize, pxTCP->uxTxStreamSize );
+
+                uxTarget = ( size_t ) FreeRTOS_round_up( 2U * pxTCP->ulTxTuneBytes, ( uint32_t ) pxTCP->usMSS );
+                uxTarget = FreeRTOS_min_size_t( uxTarget, uxMaxSize );
+
+                if( pxTCP->ucTxStreamPinned != 0U )
+                {
+                    /* The application writes directly into the stream. */
+                }
+                else if( pxTCP->ucTxStreamLimited != 0U )
+                {
+                    if( uxTarget > uxCurrentSize )
+                    {
+                        ( void ) xTCPResizeTxStream( pxSocket, uxTarget );
+                    }
+                }
+                else if( uxCurrentSize > pxTCP->uxTxStreamSize )
+                {
+                    uxTarget = FreeRTOS_max_size_t( uxTarget, pxTCP->uxTxStreamSize );
+
+                    /* Shrink when less than half of the stream is being used,
+                     * and when the outstanding data fits in the smaller stream. */
+                    if( ( uxTarget < ( uxCurrentSize / 2U ) ) &&
+                        ( uxStreamBufferGetSize( pxTCP->txStream ) < uxTarget ) )
+                    {
+                        ( void ) xTCPResizeTxStream( pxSocket, uxTarget );
+                    }
+                }
+                else
+                {
+                    /* The stream has its configured size. */
+                }
+
+                pxTCP->ulTxTuneBytes = 0U;
+                pxTCP->xTxTuneTime = xNow;
+                pxTCP->ucTxStreamLimited = 0U;
+            }
+        }
+        /*-----------------------------------------------------------*/
+    #endif /* ipconfigUSE_TCP_TX_AUTOTUNING */
+
 /**
  * @brief Set the TCP options (if any) for the outgoing packet.
  *
@@ -2932,22 +3683,43 @@
              * txStream. */
             if( ( pxSocket->u.xTCP.txStream != NULL ) && ( ulCount > 0U ) )
             {
+                #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+                    {
+                        /* Was the application waiting for space in the txStream? */
+                        if( uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream ) < ( size_t ) pxSocket->u.xTCP.usMSS )
+                        {
+                            pxSocket->u.xTCP.ucTxStreamLimited = 1U;
+                        }
+                    }
+                #endif /* ipconfigUSE_TCP_TX_AUTOTUNING */
+
                 /* Just advancing the tail index, 'ulCount' bytes have been
                  * confirmed, and because there is new space in the txStream, the
                  * user/owner should be woken up. */
                 /* _HT_ : only in case the socket's waiting? */
                 if( uxStreamBufferGet( pxSocket->u.xTCP.txStream, 0U, NULL, ( size_t ) ulCount, pdFALSE ) != 0U )
                 {
-                    pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_SEND;
-
-                    #if ipconfigSUPPORT_SELECT_FUNCTION == 1
+                    #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
                         {
-                            if( ( pxSocket->xSelectBits & ( ( EventBits_t ) eSELECT_WRITE ) ) != 0U )
-                            {
-                                pxSocket->xEventBits |= ( ( EventBits_t ) eSELECT_WRITE ) << SOCKET_EVENT_BIT_COUNT;
-                            }
+                            prvTCPTxAutoTune( pxSocket, ulCount );
                         }
+                    #endif /* ipconfigUSE_TCP_TX_AUTOTUNING */
+
+                    #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                        if( prvTCPSendLowatReached( pxSocket ) != pdFALSE )
                     #endif
+                    {
+                        pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_SEND;
+
+                        #if ipconfigSUPPORT_SELECT_FUNCTION == 1
+                            {
+                                if( ( pxSocket->xSelectBits & ( ( EventBits_t ) eSELECT_WRITE ) ) != 0U )
+                                {
+                                    pxSocket->xEventBits |= ( ( EventBits_t ) eSELECT_WRITE ) << SOCKET_EVENT_BIT_COUNT;
+                                }
+                            }
+                        #endif
+                    }
 
                     /* In case the socket owner has installed an OnSent handler,
                      * call it now. */
@@ -3099,6 +3871,8 @@
 
         #if ( ipconfigUSE_TCP_WIN == 1 )
             int32_t lMinLength;
+            BaseType_t xDelayAck;
+            uint32_t ulDelayMS = tcpDELAYED_ACK_LONGER_DELAY_MS;
         #endif
 
         /* Set the time-out field, so that we'll be called by the IP-task in case no
@@ -3120,6 +3894,32 @@
                     ( xSendLength == xSizeWithoutData ) &&                         /* No Tx data or options to be sent. */
                     ( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eESTABLISHED ) && /* Connection established. */
                     ( pxTCPHeader->ucTCPFlags == tcpTCP_FLAG_ACK ) )               /* There are no other flags than an ACK. */
+                {
+                    xDelayAck = pdTRUE;
+                }
+                else
+                {
+                    xDelayAck = pdFALSE;
+                }
+
+                #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                    {
+                        if( ( ulReceiveLength > 0U ) && ( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eESTABLISHED ) )
+                        {
+                            if( prvTCPAckPolicyCheck( pxSocket, ulReceiveLength, xDelayAck, ( lRxSpace < lMinLength ) ? pdTRUE : pdFALSE ) != pdFALSE )
+                            {
+                                xDelayAck = pdFALSE;
+                            }
+                        }
+
+                        if( pxSocket->u.xTCP.xAckPolicy.usDelayMS != 0U )
+                        {
+                            ulDelayMS = ( uint32_t ) pxSocket->u.xTCP.xAckPolicy.usDelayMS;
+                        }
+                    }
+                #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
+                if( xDelayAck != pdFALSE )
                 {
                     uint32_t ulCurMSS = ( uint32_t ) pxSocket->u.xTCP.usMSS;
                     int32_t lCurMSS = ( int32_t ) ulCurMSS;
@@ -3145,7 +3945,7 @@
                         /* Normally a delayed ACK should wait 200 ms for a next incoming
                          * packet.  Only wait 20 ms here to gain performance.  A slow ACK
                          * for full-size message. */
-                        pxSocket->u.xTCP.usTimeout = ( uint16_t ) pdMS_TO_TICKS( tcpDELAYED_ACK_LONGER_DELAY_MS );
+                        pxSocket->u.xTCP.usTimeout = ( uint16_t ) pdMS_TO_TICKS( ulDelayMS );
 
                         if( pxSocket->u.xTCP.usTimeout < 1U )
                         {
@@ -3220,6 +4020,79 @@
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+
+/**
+ * @brief Apply the ACK policy of a socket after data has been received in the
+ *        established state, and update the ACK counters.
+ *
+ * @param[in] pxSocket: The socket owning the TCP connection.
+ * @param[in] ulReceiveLength: The number of bytes received.
+ * @param[in] xMayDelay: pdTRUE when the standard rules allow the ACK to be postponed.
+ * @param[in] xWindowIsSmall: pdTRUE when there is less than 2 x MSS of space
+ *                            in the reception window.
+ *
+ * @return pdTRUE when the ACK must be sent immediately, otherwise pdFALSE.
+ */
+        static BaseType_t prvTCPAckPolicyCheck( FreeRTOS_Socket_t * pxSocket,
+                                                uint32_t ulReceiveLength,
+                                                BaseType_t xMayDelay,
+                                                BaseType_t xWindowIsSmall )
+        {
+            IPTCPSocket_t * pxTCP = &( pxSocket->u.xTCP );
+            TCPAckStatistics_t * pxStatistics = &( pxTCP->xAckStatistics );
+            uint32_t ulPending;
+            BaseType_t xAckNow = pdTRUE;
+
+            if( pxTCP->bits.bAckNow != pdFALSE_UNSIGNED )
+            {
+                /* Out-of-order data, a duplicate, or a gap was filled. */
+                pxStatistics->ulOutOfOrderAcks++;
+            }
+            else if( ( xWindowIsSmall != pdFALSE ) || ( pxTCP->bits.bWinChange != pdFALSE_UNSIGNED ) )
+            {
+                /* The window must be updated without delay. */
+                pxStatistics->ulWindowAcks++;
+            }
+            else if( xMayDelay == pdFALSE )
+            {
+                /* There is data, an option, or a flag to be sent. */
+            }
+            else if( pxTCP->ucQuickAckRemaining != 0U )
+            {
+                pxTCP->ucQuickAckRemaining--;
+                pxStatistics->ulQuickAcks++;
+            }
+            else
+            {
+                /* Count the number of full-size segments that were not yet
+                 * acknowledged. */
+                ulPending = ( uint32_t ) pxTCP->ucAckPendingSegments;
+                ulPending += ulReceiveLength / ( uint32_t ) pxTCP->usMSS;
+                pxTCP->ucAckPendingSegments = ( uint8_t ) FreeRTOS_min_uint32( ulPending, 0xffU );
+
+                if( ( pxTCP->xAckPolicy.ucAckEveryN != 0U ) &&
+                    ( pxTCP->ucAckPendingSegments >= pxTCP->xAckPolicy.ucAckEveryN ) )
+                {
+                    pxStatistics->ulEveryNAcks++;
+                }
+                else
+                {
+                    pxStatistics->ulDelayedAcks++;
+                    xAckNow = pdFALSE;
+                }
+            }
+
+            if( xAckNow != pdFALSE )
+            {
+                pxStatistics->ulImmediateAcks++;
+            }
+
+            return xAckNow;
+        }
+        /*-----------------------------------------------------------*/
+    #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
 /**
  * @brief Check incoming packets for valid data and handle the state of the
  *        TCP connection and respond according to the situation.
@@ -3506,6 +4379,23 @@
  * @param[in] pxSocket: The socket whose MSS is to be set.
  */
     static void prvSocketSetMSS( FreeRTOS_Socket_t * pxSocket )
+    {
+        uint32_t ulMSS = prvTCPMSSForPeer( pxSocket->u.xTCP.ulRemoteIP );
+
+        FreeRTOS_debug_printf( ( "prvSocketSetMSS: %u bytes for %xip:%u\n", ( unsigned ) ulMSS, ( unsigned ) pxSocket->u.xTCP.ulRemoteIP, pxSocket->u.xTCP.usRemotePort ) );
+
+        pxSocket->u.xTCP.usMSS = ( uint16_t ) ulMSS;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Determine the MSS that will be used for a peer.
+ *
+ * @param[in] ulRemoteIP: The IP-address of the peer, in host-endian notation.
+ *
+ * @return The MSS in bytes.
+ */
+    static uint32_t prvTCPMSSForPeer( uint32_t ulRemoteIP )
     {
         uint32_t ulMSS;
 
@@ -3520,86 +4410,342 @@
             }
         #endif
 
-        if( ( ( FreeRTOS_ntohl( pxSocket->u.xTCP.ulRemoteIP ) ^ *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) != 0U )
+        if( ( ( FreeRTOS_ntohl( ulRemoteIP ) ^ *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) != 0U )
         {
             /* Data for this peer will pass through a router, and maybe through
              * the internet.  Limit the MSS to 1400 bytes or less. */
             ulMSS = FreeRTOS_min_uint32( ( uint32_t ) tcpREDUCED_MSS_THROUGH_INTERNET, ulMSS );
         }
 
-        FreeRTOS_debug_printf( ( "prvSocketSetMSS: %u bytes for %xip:%u\n", ( unsigned ) ulMSS, ( unsigned ) pxSocket->u.xTCP.ulRemoteIP, pxSocket->u.xTCP.usRemotePort ) );
-
-        pxSocket->u.xTCP.usMSS = ( uint16_t ) ulMSS;
+        return ulMSS;
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_RX_COALESCING != 0 )
+
 /**
- * @brief Process the received TCP packet.
- *
- * @param[in] pxDescriptor: The descriptor in which the TCP packet is held.
+ * @brief Check if a received packet may take part in receive coalescing: an IPv4
+ *        packet without IP-options and without fragmentation, carrying a TCP
+ *        segment with payload and with no other flags than ACK and PSH.
  *
- * @return If the processing of the packet was successful, then pdPASS is returned
- *         or else pdFAIL.
+ * @param[in] pxNetworkBuffer: The network buffer holding the received packet.
  *
- * @note FreeRTOS_TCP_IP has only 2 public functions, this is the second one:
- *  xProcessReceivedTCPPacket()
- *      prvTCPHandleState()
- *          prvTCPPrepareSend()
- *              prvTCPReturnPacket()
- *              xNetworkInterfaceOutput()  // Sends data to the NIC
- *      prvTCPSendRepeated()
- *          prvTCPReturnPacket()        // Prepare for returning
- *          xNetworkInterfaceOutput()   // Sends data to the NIC
+ * @return The number of payload bytes when the packet is a candidate, otherwise 0.
  */
-    BaseType_t xProcessReceivedTCPPacket( NetworkBufferDescriptor_t * pxDescriptor )
-    {
-        /* Function might modify the parameter. */
-        NetworkBufferDescriptor_t * pxNetworkBuffer = pxDescriptor;
-
-        /* Map the buffer onto a ProtocolHeaders_t struct for easy access to the fields. */
-        const ProtocolHeaders_t * pxProtocolHeaders = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( ProtocolHeaders_t,
-                                                                                          &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
-        FreeRTOS_Socket_t * pxSocket;
-        uint16_t ucTCPFlags = pxProtocolHeaders->xTCPHeader.ucTCPFlags;
-        uint32_t ulLocalIP;
-        uint16_t usLocalPort = FreeRTOS_htons( pxProtocolHeaders->xTCPHeader.usDestinationPort );
-        uint16_t usRemotePort = FreeRTOS_htons( pxProtocolHeaders->xTCPHeader.usSourcePort );
-        uint32_t ulRemoteIP;
-        uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxProtocolHeaders->xTCPHeader.ulSequenceNumber );
-        uint32_t ulAckNumber = FreeRTOS_ntohl( pxProtocolHeaders->xTCPHeader.ulAckNr );
-        BaseType_t xResult = pdPASS;
+        static size_t prvCoalesceCandidate( const NetworkBufferDescriptor_t * pxNetworkBuffer )
+        {
+            const TCPPacket_t * pxTCPPacket;
+            size_t uxIPLength;
+            size_t uxTCPHeaderLength;
+            size_t uxPayloadLength = 0U;
+            uint16_t usFragment;
 
-        configASSERT( pxNetworkBuffer != NULL );
-        configASSERT( pxNetworkBuffer->pucEthernetBuffer != NULL );
-        const IPHeader_t * pxIPHeader;
+            if( pxNetworkBuffer->xDataLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ) )
+            {
+                pxTCPPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+
+                usFragment = FreeRTOS_ntohs( pxTCPPacket->xIPHeader.usFragmentOffset );
+                usFragment &= ( uint16_t ) ( ipFRAGMENT_OFFSET_BIT_MASK | ipFRAGMENT_FLAGS_MORE_FRAGMENTS );
+                uxIPLength = ( size_t ) FreeRTOS_ntohs( pxTCPPacket->xIPHeader.usLength );
+                uxTCPHeaderLength = ( size_t ) ( ( pxTCPPacket->xTCPHeader.ucTCPOffset & tcpVALID_BITS_IN_TCP_OFFSET_BYTE ) >> 2 );
+
+                if( ( pxTCPPacket->xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE ) &&
+                    ( pxTCPPacket->xIPHeader.ucVersionHeaderLength == 0x45U ) &&
+                    ( pxTCPPacket->xIPHeader.ucProtocol == ( uint8_t ) ipPROTOCOL_TCP ) &&
+                    ( usFragment == 0U ) &&
+                    ( ( pxTCPPacket->xTCPHeader.ucTCPFlags & ( uint8_t ) ~tcpTCP_FLAG_PSH ) == tcpTCP_FLAG_ACK ) &&
+                    ( uxTCPHeaderLength >= ipSIZE_OF_TCP_HEADER ) &&
+                    ( uxIPLength > ( ipSIZE_OF_IPv4_HEADER + uxTCPHeaderLength ) ) &&
+                    ( ( ipSIZE_OF_ETH_HEADER + uxIPLength ) <= pxNetworkBuffer->xDataLength ) )
+                {
+                    uxPayloadLength = uxIPLength - ( ipSIZE_OF_IPv4_HEADER + uxTCPHeaderLength );
+                }
+            }
 
-        /* Check for a minimum packet size. */
-        if( pxNetworkBuffer->xDataLength < ( ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) + ipSIZE_OF_TCP_HEADER ) )
-        {
-            xResult = pdFAIL;
+            return uxPayloadLength;
         }
-        else
-        {
-            /* Map the ethernet buffer onto the IPHeader_t struct for easy access to the fields. */
-            pxIPHeader = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( IPHeader_t, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
-            ulLocalIP = FreeRTOS_htonl( pxIPHeader->ulDestinationIPAddress );
-            ulRemoteIP = FreeRTOS_htonl( pxIPHeader->ulSourceIPAddress );
-
-            /* Find the destination socket, and if not found: return a socket listing to
-             * the destination PORT. */
-            pxSocket = ( FreeRTOS_Socket_t * ) pxTCPSocketLookup( ulLocalIP, usLocalPort, ulRemoteIP, usRemotePort );
+        /*-----------------------------------------------------------*/
 
-            if( ( pxSocket == NULL ) || ( prvTCPSocketIsActive( pxSocket->u.xTCP.ucTCPState ) == pdFALSE ) )
+/**
+ * @brief Check if a segment directly follows the previous one of the same
+ *        connection.  Acknowledgement, window and options must be unchanged, and
+ *        the previous segment may not have the PSH flag set.
+ *
+ * @param[in] pxPrevious: The previous TCP packet of the run.
+ * @param[in] pxNext: The TCP packet that may be appended to the run.
+ * @param[in] ulExpectedSequence: The sequence number that the next segment must have.
+ *
+ * @return pdTRUE when 'pxNext' may be appended to the run, otherwise pdFALSE.
+ */
+        static BaseType_t prvCoalesceMatch( const TCPPacket_t * pxPrevious,
+                                            const TCPPacket_t * pxNext,
+                                            uint32_t ulExpectedSequence )
+        {
+            BaseType_t xResult = pdFALSE;
+            const uint8_t * pucPreviousOptions = &( ( ( const uint8_t * ) &( pxPrevious->xTCPHeader ) )[ ipSIZE_OF_TCP_HEADER ] );
+            const uint8_t * pucNextOptions = &( ( ( const uint8_t * ) &( pxNext->xTCPHeader ) )[ ipSIZE_OF_TCP_HEADER ] );
+            size_t uxOptionsLength;
+
+            if( ( pxNext->xIPHeader.ulSourceIPAddress == pxPrevious->xIPHeader.ulSourceIPAddress ) &&
+                ( pxNext->xIPHeader.ulDestinationIPAddress == pxPrevious->xIPHeader.ulDestinationIPAddress ) &&
+                ( pxNext->xIPHeader.ucDifferentiatedServicesCode == pxPrevious->xIPHeader.ucDifferentiatedServicesCode ) &&
+                ( pxNext->xTCPHeader.usSourcePort == pxPrevious->xTCPHeader.usSourcePort ) &&
+                ( pxNext->xTCPHeader.usDestinationPort == pxPrevious->xTCPHeader.usDestinationPort ) &&
+                ( pxNext->xTCPHeader.ulAckNr == pxPrevious->xTCPHeader.ulAckNr ) &&
+                ( pxNext->xTCPHeader.usWindow == pxPrevious->xTCPHeader.usWindow ) &&
+                ( pxNext->xTCPHeader.ucTCPOffset == pxPrevious->xTCPHeader.ucTCPOffset ) &&
+                ( ( pxPrevious->xTCPHeader.ucTCPFlags & tcpTCP_FLAG_PSH ) == 0U ) &&
+                ( FreeRTOS_ntohl( pxNext->xTCPHeader.ulSequenceNumber ) == ulExpectedSequence ) )
             {
-                /* A TCP messages is received but either there is no socket with the
-                 * given port number or the there is a socket, but it is in one of these
-                 * non-active states:  eCLOSED, eCLOSE_WAIT, eFIN_WAIT_2, eCLOSING, or
-                 * eTIME_WAIT. */
+                uxOptionsLength = ( size_t ) ( ( pxPrevious->xTCPHeader.ucTCPOffset & tcpVALID_BITS_IN_TCP_OFFSET_BYTE ) >> 2 );
+                uxOptionsLength -= ipSIZE_OF_TCP_HEADER;
 
-                FreeRTOS_debug_printf( ( "TCP: No active socket on port %d (%xip:%d)\n", usLocalPort, ( unsigned ) ulRemoteIP, usRemotePort ) );
+                if( memcmp( pucPreviousOptions, pucNextOptions, uxOptionsLength ) == 0 )
+                {
+                    xResult = pdTRUE;
+                }
+            }
 
-                /* Send a RST to all packets that can not be handled.  As a result
-                 * the other party will get a ECONN error.  There are two exceptions:
+            return xResult;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy a run of coalescable segments into a single new network buffer.
+ *        The headers are taken from the first segment, the TCP flags from the
+ *        last one.
+ *
+ * @param[in] pxFirstBuffer: The first buffer of the run, the others follow
+ *                           through 'pxNextBuffer'.
+ * @param[in] uxCount: The number of segments in the run.
+ * @param[in] uxPayloadLength: The total number of payload bytes in the run.
+ *
+ * @return The new network buffer, or NULL when no buffer could be obtained.
+ */
+        static NetworkBufferDescriptor_t * prvCoalesceMerge( const NetworkBufferDescriptor_t * pxFirstBuffer,
+                                                             size_t uxCount,
+                                                             size_t uxPayloadLength )
+        {
+            const TCPPacket_t * pxSourcePacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxFirstBuffer->pucEthernetBuffer );
+            const NetworkBufferDescriptor_t * pxSource = pxFirstBuffer;
+            NetworkBufferDescriptor_t * pxMerged;
+            TCPPacket_t * pxMergedPacket;
+            size_t uxHeaderLength;
+            size_t uxOffset;
+            size_t uxLength;
+            size_t uxIndex;
+            uint8_t ucTCPFlags = 0U;
+
+            uxHeaderLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER +
+                             ( size_t ) ( ( pxSourcePacket->xTCPHeader.ucTCPOffset & tcpVALID_BITS_IN_TCP_OFFSET_BYTE ) >> 2 );
+
+            pxMerged = pxGetNetworkBufferWithDescriptor( uxHeaderLength + uxPayloadLength, 0U );
+
+            if( pxMerged != NULL )
+            {
+                ( void ) memcpy( pxMerged->pucEthernetBuffer, pxFirstBuffer->pucEthernetBuffer, uxHeaderLength );
+                uxOffset = uxHeaderLength;
+
+                for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+                {
+                    pxSourcePacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxSource->pucEthernetBuffer );
+                    ucTCPFlags = pxSourcePacket->xTCPHeader.ucTCPFlags;
+                    uxLength = prvCoalesceCandidate( pxSource );
+
+                    ( void ) memcpy( &( pxMerged->pucEthernetBuffer[ uxOffset ] ),
+                                     &( pxSource->pucEthernetBuffer[ uxHeaderLength ] ),
+                                     uxLength );
+                    uxOffset += uxLength;
+                    pxSource = pxSource->pxNextBuffer;
+                }
+
+                pxMergedPacket = ipCAST_PTR_TO_TYPE_PTR( TCPPacket_t, pxMerged->pucEthernetBuffer );
+                pxMergedPacket->xIPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( uxOffset - ipSIZE_OF_ETH_HEADER ) );
+                pxMergedPacket->xTCPHeader.ucTCPFlags = ucTCPFlags;
+                pxMerged->xDataLength = uxOffset;
+
+                /* Mark the buffer as merged, xCheckSizeFields() will allow it to
+                 * be larger than the MTU. */
+                pxMerged->usCoalescedCount = ( uint16_t ) uxCount;
+            }
+
+            return pxMerged;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Receive coalescing ("software GRO"): merge consecutive in-order TCP
+ *        segments of the same connection, as found in a chain of received
+ *        packets, into one larger segment.  The TCP state machine, the
+ *        sliding window, the wake-up of the socket owner and the decision to
+ *        send an ACK will then run once per batch, in stead of once per segment.
+ *        The checksums of a merged packet are not updated, which is why this
+ *        requires ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM.
+ *
+ * @param[in] pxFirstBuffer: The first of a chain of network buffers, linked
+ *                           through 'pxNextBuffer'.
+ *
+ * @return The first network buffer of the resulting chain.
+ */
+        NetworkBufferDescriptor_t * pxTCPCoalesceReceivedPackets( NetworkBufferDescriptor_t * pxFirstBuffer )
+        {
+            NetworkBufferDescriptor_t * pxReturn = pxFirstBuffer;
+            NetworkBufferDescriptor_t ** ppxLink = &( pxReturn );
+            NetworkBufferDescriptor_t * pxHead = pxFirstBuffer;
+            NetworkBufferDescriptor_t * pxLast;
+            NetworkBufferDescriptor_t * pxNext;
+            NetworkBufferDescriptor_t * pxMerged;
+            size_t uxCount;
+            size_t uxPayloadLength;
+            size_t uxLength;
+            uint32_t ulExpectedSequence;
+
+            /* A merged packet is larger than the MTU, it can only be stored
+             * when network buffers have a variable size. */
+            if( xBufferAllocFixedSize == pdFALSE )
+            {
+                while( pxHead != NULL )
+                {
+                    pxLast = pxHead;
+                    uxCount = 1U;
+                    uxPayloadLength = prvCoalesceCandidate( pxHead );
+
+                    if( uxPayloadLength != 0U )
+                    {
+                        ulExpectedSequence = FreeRTOS_ntohl( ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxHead->pucEthernetBuffer )->xTCPHeader.ulSequenceNumber );
+                        ulExpectedSequence += ( uint32_t ) uxPayloadLength;
+
+                        while( ( uxCount < ( size_t ) ipconfigTCP_RX_COALESCING_MAX_SEGMENTS ) && ( pxLast->pxNextBuffer != NULL ) )
+                        {
+                            pxNext = pxLast->pxNextBuffer;
+                            uxLength = prvCoalesceCandidate( pxNext );
+
+                            if( ( uxLength == 0U ) ||
+                                ( prvCoalesceMatch( ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxLast->pucEthernetBuffer ),
+                                                    ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxNext->pucEthernetBuffer ),
+                                                    ulExpectedSequence ) == pdFALSE ) )
+                            {
+                                break;
+                            }
+
+                            ulExpectedSequence += ( uint32_t ) uxLength;
+                            uxPayloadLength += uxLength;
+                            uxCount++;
+                            pxLast = pxNext;
+                        }
+                    }
+
+                    pxMerged = NULL;
+
+                    if( uxCount > 1U )
+                    {
+                        pxMerged = prvCoalesceMerge( pxHead, uxCount, uxPayloadLength );
+                    }
+
+                    if( pxMerged != NULL )
+                    {
+                        /* Let the merged packet take the place of the run. */
+                        pxMerged->pxNextBuffer = pxLast->pxNextBuffer;
+                        *ppxLink = pxMerged;
+                        pxLast->pxNextBuffer = NULL;
+
+                        while( pxHead != NULL )
+                        {
+                            pxNext = pxHead->pxNextBuffer;
+                            vReleaseNetworkBufferAndDescriptor( pxHead );
+                            pxHead = pxNext;
+                        }
+
+                        pxLast = pxMerged;
+                    }
+
+                    ppxLink = &( pxLast->pxNextBuffer );
+                    pxHead = pxLast->pxNextBuffer;
+                }
+            }
+
+            return pxReturn;
+        }
+        /*-----------------------------------------------------------*/
+    #endif /* ipconfigUSE_TCP_RX_COALESCING != 0 */
+
+/**
+ * @brief Process the received TCP packet.
+ *
+ * @param[in] pxDescriptor: The descriptor in which the TCP packet is held.
+ *
+ * @return If the processing of the packet was successful, then pdPASS is returned
+ *         or else pdFAIL.
+ *
+ * @note FreeRTOS_TCP_IP has only 2 public functions, this is the second one:
+ *  xProcessReceivedTCPPacket()
+ *      prvTCPHandleState()
+ *          prvTCPPrepareSend()
+ *              prvTCPReturnPacket()
+ *              xNetworkInterfaceOutput()  // Sends data to the NIC
+ *      prvTCPSendRepeated()
+ *          prvTCPReturnPacket()        // Prepare for returning
+ *          xNetworkInterfaceOutput()   // Sends data to the NIC
+ */
+    BaseType_t xProcessReceivedTCPPacket( NetworkBufferDescriptor_t * pxDescriptor )
+    {
+        /* Function might modify the parameter. */
+        NetworkBufferDescriptor_t * pxNetworkBuffer = pxDescriptor;
+
+        /* Map the buffer onto a ProtocolHeaders_t struct for easy access to the fields. */
+        const ProtocolHeaders_t * pxProtocolHeaders = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( ProtocolHeaders_t,
+                                                                                          &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
+        FreeRTOS_Socket_t * pxSocket;
+        uint16_t ucTCPFlags = pxProtocolHeaders->xTCPHeader.ucTCPFlags;
+        uint32_t ulLocalIP;
+        uint16_t usLocalPort = FreeRTOS_htons( pxProtocolHeaders->xTCPHeader.usDestinationPort );
+        uint16_t usRemotePort = FreeRTOS_htons( pxProtocolHeaders->xTCPHeader.usSourcePort );
+        uint32_t ulRemoteIP;
+        uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxProtocolHeaders->xTCPHeader.ulSequenceNumber );
+        uint32_t ulAckNumber = FreeRTOS_ntohl( pxProtocolHeaders->xTCPHeader.ulAckNr );
+        BaseType_t xResult = pdPASS;
+
+        configASSERT( pxNetworkBuffer != NULL );
+        configASSERT( pxNetworkBuffer->pucEthernetBuffer != NULL );
+        const IPHeader_t * pxIPHeader;
+
+        /* Check for a minimum packet size. */
+        if( pxNetworkBuffer->xDataLength < ( ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) + ipSIZE_OF_TCP_HEADER ) )
+        {
+            xResult = pdFAIL;
+        }
+        else
+        {
+            /* Map the ethernet buffer onto the IPHeader_t struct for easy access to the fields. */
+            pxIPHeader = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( IPHeader_t, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+            ulLocalIP = FreeRTOS_htonl( pxIPHeader->ulDestinationIPAddress );
+            ulRemoteIP = FreeRTOS_htonl( pxIPHeader->ulSourceIPAddress );
+
+            /* Find the destination socket, and if not found: return a socket listing to
+             * the destination PORT. */
+            pxSocket = ( FreeRTOS_Socket_t * ) pxTCPSocketLookup( ulLocalIP, usLocalPort, ulRemoteIP, usRemotePort );
+
+            #if ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+                if( prvTCPTimeWaitCheck( pxSocket, pxNetworkBuffer ) != pdFALSE )
+                {
+                    /* The packet belongs to a connection in TIME_WAIT, and it has
+                     * been answered or dropped. */
+                    xResult = pdFAIL;
+                }
+                else
+            #endif /* ipconfigTCP_TIME_WAIT_TABLE */
+
+            if( ( pxSocket == NULL ) || ( prvTCPSocketIsActive( pxSocket->u.xTCP.ucTCPState ) == pdFALSE ) )
+            {
+                /* A TCP messages is received but either there is no socket with the
+                 * given port number or the there is a socket, but it is in one of these
+                 * non-active states:  eCLOSED, eCLOSE_WAIT, eFIN_WAIT_2, eCLOSING, or
+                 * eTIME_WAIT. */
+
+                FreeRTOS_debug_printf( ( "TCP: No active socket on port %d (%xip:%d)\n", usLocalPort, ( unsigned ) ulRemoteIP, usRemotePort ) );
+
+                /* Send a RST to all packets that can not be handled.  As a result
+                 * the other party will get a ECONN error.  There are two exceptions:
                  * 1) A packet that already has the RST flag set.
                  * 2) A packet that only has the ACK flag set.
                  * A packet with only the ACK flag set might be the last ACK in
@@ -3619,6 +4765,19 @@
 
                 if( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eTCP_LISTEN )
                 {
+                    #if ( ipconfigTCP_SYN_QUEUE != 0 )
+                        if( prvTCPSynQueueAccept( &pxSocket, pxNetworkBuffer ) != pdFALSE )
+                        {
+                            /* The packet completed a handshake, and pxSocket is now the
+                             * new child socket, or NULL when it could not be created. */
+                            if( pxSocket == NULL )
+                            {
+                                xResult = pdFAIL;
+                            }
+                        }
+                        else
+                    #endif /* ipconfigTCP_SYN_QUEUE */
+
                     /* The matching socket is in a listening state.  Test if the peer
                      * has set the SYN flag. */
                     if( ( ucTCPFlags & tcpTCP_FLAG_CTRL ) != tcpTCP_FLAG_SYN )
@@ -3856,58 +5015,674 @@
                 }
                 else
                 {
-                    FreeRTOS_Socket_t * pxNewSocket = ( FreeRTOS_Socket_t * )
-                                                      FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+                    #if ( ipconfigTCP_SYN_QUEUE != 0 )
+                        {
+                            /* The child socket will be created when the handshake has
+                             * been completed. */
+                            prvTCPSynQueueAdd( pxSocket, pxNetworkBuffer, ulInitialSequenceNumber );
+                        }
+                    #else
+                        {
+                            pxReturn = prvTCPCreateChild( pxSocket, pxNetworkBuffer );
+                        }
+                    #endif
+                }
+            }
+        }
+
+        if( ( ulInitialSequenceNumber != 0U ) && ( pxReturn != NULL ) )
+        {
+            /* Map the byte stream onto the ProtocolHeaders_t for easy access to the fields. */
+            const ProtocolHeaders_t * pxProtocolHeaders = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( ProtocolHeaders_t,
+                                                                                              &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
+
+            prvTCPListenSetup( pxReturn,
+                               pxNetworkBuffer,
+                               ulInitialSequenceNumber,
+                               FreeRTOS_ntohl( pxProtocolHeaders->xTCPHeader.ulSequenceNumber ) );
+        }
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Create a child socket for a listening socket, which inherits the
+ *        properties of its parent.
+ *
+ * @param[in] pxSocket: The listening socket.
+ * @param[in] pxNetworkBuffer: The packet that asks for a connection.  A RST will
+ *                             be sent in case the socket can not be created.
+ *
+ * @return The new socket, or NULL when it could not be created.
+ */
+    static FreeRTOS_Socket_t * prvTCPCreateChild( FreeRTOS_Socket_t * pxSocket,
+                                                  NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        FreeRTOS_Socket_t * pxReturn = NULL;
+        FreeRTOS_Socket_t * pxNewSocket = ( FreeRTOS_Socket_t * )
+                                          FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+
+        if( ( pxNewSocket == NULL ) || ( pxNewSocket == FREERTOS_INVALID_SOCKET ) )
+        {
+            FreeRTOS_debug_printf( ( "TCP: Listen: new socket failed\n" ) );
+            ( void ) prvTCPSendReset( pxNetworkBuffer );
+        }
+        else if( prvTCPSocketCopy( pxNewSocket, pxSocket ) != pdFALSE )
+        {
+            /* The socket will be connected immediately, no time for the
+             * owner to setsockopt's, therefore copy properties of the server
+             * socket to the new socket.  Only the binding might fail (due to
+             * lack of resources). */
+            pxReturn = pxNewSocket;
+        }
+        else
+        {
+            /* Copying failed somehow. */
+        }
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Prepare a socket that answers a connection request: store the address
+ *        of the peer, create the TCP window, and go to the state eSYN_FIRST.
+ *
+ * @param[in] pxSocket: The socket that will be connected.
+ * @param[in] pxNetworkBuffer: A packet received from the peer.
+ * @param[in] ulInitialSequenceNumber: Our initial sequence number.
+ * @param[in] ulRemoteSequenceNumber: The sequence number of the SYN of the peer.
+ */
+    static void prvTCPListenSetup( FreeRTOS_Socket_t * pxSocket,
+                                   const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                   uint32_t ulInitialSequenceNumber,
+                                   uint32_t ulRemoteSequenceNumber )
+    {
+        /* Map the ethernet buffer onto a TCPPacket_t struct for easy access to the fields. */
+        const TCPPacket_t * pxTCPPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+
+        pxSocket->u.xTCP.usRemotePort = FreeRTOS_htons( pxTCPPacket->xTCPHeader.usSourcePort );
+        pxSocket->u.xTCP.ulRemoteIP = FreeRTOS_htonl( pxTCPPacket->xIPHeader.ulSourceIPAddress );
+        pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber = ulInitialSequenceNumber;
+
+        /* Here is the SYN action. */
+        pxSocket->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber = ulRemoteSequenceNumber;
+        prvSocketSetMSS( pxSocket );
+
+        prvTCPCreateWindow( pxSocket );
+
+        vTCPStateChange( pxSocket, eSYN_FIRST );
+
+        /* Make a copy of the header up to the TCP header.  It is needed later
+         * on, whenever data must be sent to the peer. */
+        ( void ) memcpy( ( void * ) pxSocket->u.xTCP.xPacket.u.ucLastPacket,
+                         ( const void * ) pxNetworkBuffer->pucEthernetBuffer,
+                         sizeof( pxSocket->u.xTCP.xPacket.u.ucLastPacket ) );
+    }
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigTCP_SYN_QUEUE != 0 )
+
+/**
+ * @brief Find the entry of a half-open connection.  Entries that have expired
+ *        are freed while looking.
+ *
+ * @param[in] usLocalPort: The port number of the listening socket.
+ * @param[in] ulRemoteIP: The IP-address of the peer, in host-endian notation.
+ * @param[in] usRemotePort: The port number of the peer.
+ *
+ * @return The entry, or NULL when it was not found.
+ */
+        static TCPSynEntry_t * prvTCPSynQueueFind( uint16_t usLocalPort,
+                                                   uint32_t ulRemoteIP,
+                                                   uint16_t usRemotePort )
+        {
+            TCPSynEntry_t * pxReturn = NULL;
+            TCPSynEntry_t * pxEntry;
+            TickType_t xNow = xTaskGetTickCount();
+            UBaseType_t uxIndex;
+
+            for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigTCP_SYN_QUEUE_LENGTH; uxIndex++ )
+            {
+                pxEntry = &( xTCPSynQueue[ uxIndex ] );
+
+                if( pxEntry->usLocalPort == 0U )
+                {
+                    /* A free entry. */
+                }
+                else if( ( xNow - pxEntry->xCreateTime ) >= pdMS_TO_TICKS( ipconfigTCP_SYN_QUEUE_TIMEOUT_MS ) )
+                {
+                    /* The handshake was not completed in time. */
+                    pxEntry->usLocalPort = 0U;
+                }
+                else if( ( pxEntry->usLocalPort == usLocalPort ) &&
+                         ( pxEntry->ulRemoteIP == ulRemoteIP ) &&
+                         ( pxEntry->usRemotePort == usRemotePort ) )
+                {
+                    pxReturn = pxEntry;
+                }
+                else
+                {
+                    /* An entry of another connection. */
+                }
+            }
+
+            return pxReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Read the MSS and window scale options from a SYN, which will be applied
+ *        to the child socket once the handshake has been completed.
+ *
+ * @param[in] pxNetworkBuffer: The SYN packet.
+ * @param[out] pxEntry: The entry in which the options are stored.
+ */
+        static void prvTCPSynQueueOptions( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                           TCPSynEntry_t * pxEntry )
+        {
+            /* Map the ethernet buffer onto a TCPPacket_t struct for easy access to the fields. */
+            const TCPPacket_t * pxTCPPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+            const uint8_t * pucPtr = pxTCPPacket->xTCPHeader.ucOptdata;
+            size_t uxOptionOffset = ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) + ipSIZE_OF_TCP_HEADER;
+            size_t uxLength = 0U;
+            size_t uxIndex = 0U;
+
+            pxEntry->usPeerMSS = 0U;
+            pxEntry->ucPeerWinScale = 0U;
+            pxEntry->ucHasWinScale = ( uint8_t ) pdFALSE;
+
+            if( pxTCPPacket->xTCPHeader.ucTCPOffset > tcpTCP_OFFSET_STANDARD_LENGTH )
+            {
+                uxLength = ( ( size_t ) ( pxTCPPacket->xTCPHeader.ucTCPOffset >> 4U ) - 5U ) << 2U;
+
+                if( pxNetworkBuffer->xDataLength < ( uxOptionOffset + uxLength ) )
+                {
+                    /* The options are truncated, ignore them. */
+                    uxLength = 0U;
+                }
+            }
 
-                    if( ( pxNewSocket == NULL ) || ( pxNewSocket == FREERTOS_INVALID_SOCKET ) )
+            while( uxIndex < uxLength )
+            {
+                if( pucPtr[ uxIndex ] == tcpTCP_OPT_END )
+                {
+                    break;
+                }
+                else if( pucPtr[ uxIndex ] == tcpTCP_OPT_NOOP )
+                {
+                    uxIndex++;
+                }
+                else if( ( ( uxIndex + 1U ) >= uxLength ) ||
+                         ( pucPtr[ uxIndex + 1U ] < 2U ) ||
+                         ( ( uxIndex + ( size_t ) pucPtr[ uxIndex + 1U ] ) > uxLength ) )
+                {
+                    /* The options are malformed, stop reading them. */
+                    break;
+                }
+                else
+                {
+                    if( ( pucPtr[ uxIndex ] == tcpTCP_OPT_MSS ) && ( pucPtr[ uxIndex + 1U ] == tcpTCP_OPT_MSS_LEN ) )
                     {
-                        FreeRTOS_debug_printf( ( "TCP: Listen: new socket failed\n" ) );
-                        ( void ) prvTCPSendReset( pxNetworkBuffer );
+                        pxEntry->usPeerMSS = usChar2u16( &( pucPtr[ uxIndex + 2U ] ) );
                     }
-                    else if( prvTCPSocketCopy( pxNewSocket, pxSocket ) != pdFALSE )
+                    else if( ( pucPtr[ uxIndex ] == tcpTCP_OPT_WSOPT ) && ( pucPtr[ uxIndex + 1U ] == tcpTCP_OPT_WSOPT_LEN ) )
                     {
-                        /* The socket will be connected immediately, no time for the
-                         * owner to setsockopt's, therefore copy properties of the server
-                         * socket to the new socket.  Only the binding might fail (due to
-                         * lack of resources). */
-                        pxReturn = pxNewSocket;
+                        pxEntry->ucPeerWinScale = pucPtr[ uxIndex + 2U ];
+                        pxEntry->ucHasWinScale = ( uint8_t ) pdTRUE;
                     }
                     else
                     {
-                        /* Copying failed somehow. */
+                        /* Other options are handled once the socket exists. */
                     }
+
+                    uxIndex += ( size_t ) pucPtr[ uxIndex + 1U ];
                 }
             }
         }
+        /*-----------------------------------------------------------*/
 
-        if( ( ulInitialSequenceNumber != 0U ) && ( pxReturn != NULL ) )
+/**
+ * @brief Store a connection request in the table of half-open connections, and
+ *        answer it with a SYN+ACK.  The SYN+ACK has the same options and window
+ *        that a child socket would send.  When the table is full, the oldest
+ *        entry is replaced.
+ *
+ * @param[in] pxSocket: The listening socket.
+ * @param[in] pxNetworkBuffer: The SYN packet, which will be used to send the SYN+ACK.
+ * @param[in] ulInitialSequenceNumber: Our initial sequence number.
+ */
+        static void prvTCPSynQueueAdd( const FreeRTOS_Socket_t * pxSocket,
+                                       NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                       uint32_t ulInitialSequenceNumber )
         {
-            /* Map the byte stream onto the ProtocolHeaders_t for easy access to the fields. */
-            const ProtocolHeaders_t * pxProtocolHeaders = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( ProtocolHeaders_t,
-                                                                                              &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
+            /* Map the ethernet buffer onto a TCPPacket_t struct for easy access to the fields. */
+            TCPPacket_t * pxTCPPacket = ipCAST_PTR_TO_TYPE_PTR( TCPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+            TCPHeader_t * pxTCPHeader = &( pxTCPPacket->xTCPHeader );
+            uint32_t ulRemoteIP = FreeRTOS_ntohl( pxTCPPacket->xIPHeader.ulSourceIPAddress );
+            uint16_t usRemotePort = FreeRTOS_ntohs( pxTCPHeader->usSourcePort );
+            TCPSynEntry_t * pxEntry = prvTCPSynQueueFind( pxSocket->usLocalPort, ulRemoteIP, usRemotePort );
+            TickType_t xNow = xTaskGetTickCount();
+            UBaseType_t uxIndex;
+            UBaseType_t uxOptionsLength;
+            uint32_t ulMSS;
+            uint32_t ulSpace;
+            uint8_t ucWinScaleFactor = 0U;
+
+            if( pxEntry == NULL )
+            {
+                /* Take a free entry, or otherwise the oldest one. */
+                for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigTCP_SYN_QUEUE_LENGTH; uxIndex++ )
+                {
+                    if( xTCPSynQueue[ uxIndex ].usLocalPort == 0U )
+                    {
+                        pxEntry = &( xTCPSynQueue[ uxIndex ] );
+                        break;
+                    }
+
+                    if( ( pxEntry == NULL ) || ( ( xNow - xTCPSynQueue[ uxIndex ].xCreateTime ) > ( xNow - pxEntry->xCreateTime ) ) )
+                    {
+                        pxEntry = &( xTCPSynQueue[ uxIndex ] );
+                    }
+                }
+
+                configASSERT( pxEntry != NULL );
+
+                if( pxEntry->usLocalPort != 0U )
+                {
+                    FreeRTOS_debug_printf( ( "TCP: SYN queue full, forget %xip:%u\n", ( unsigned ) pxEntry->ulRemoteIP, pxEntry->usRemotePort ) );
+                }
+
+                pxEntry->ulRemoteIP = ulRemoteIP;
+                pxEntry->usRemotePort = usRemotePort;
+                pxEntry->usLocalPort = pxSocket->usLocalPort;
+                pxEntry->ulRemoteSequence = FreeRTOS_ntohl( pxTCPHeader->ulSequenceNumber );
+                pxEntry->ulOurSequence = ulInitialSequenceNumber;
+                pxEntry->xCreateTime = xNow;
+                prvTCPSynQueueOptions( pxNetworkBuffer, pxEntry );
+            }
+            else
+            {
+                /* The peer repeats its SYN, answer it with the same sequence number. */
+            }
+
+            /* Use the MSS that the child socket will get, which is reduced when the
+             * peer asks for a smaller MSS. */
+            ulMSS = prvTCPMSSForPeer( ulRemoteIP );
+
+            if( pxEntry->usPeerMSS != 0U )
+            {
+                ulMSS = FreeRTOS_min_uint32( ulMSS, FreeRTOS_max_uint32( ( uint32_t ) pxEntry->usPeerMSS, tcpMINIMUM_SEGMENT_LENGTH ) );
+            }
+
+            /* Advertise the reception window as prvTCPReturnPacket() would do for a
+             * child socket that has no reception stream yet. */
+            ulSpace = FreeRTOS_min_uint32( ( uint32_t ) pxSocket->u.xTCP.uxRxWinSize * ulMSS, ( uint32_t ) pxSocket->u.xTCP.uxRxStreamSize );
+
+            #if ( ipconfigUSE_TCP_WIN != 0 )
+                {
+                    /* The same factor as prvWinScaleFactor() will find. */
+                    size_t uxWinSize = pxSocket->u.xTCP.uxRxWinSize * ( size_t ) ulMSS;
+
+                    while( uxWinSize > 0xffffU )
+                    {
+                        uxWinSize >>= 1;
+                        ucWinScaleFactor++;
+                    }
 
-            pxReturn->u.xTCP.usRemotePort = FreeRTOS_htons( pxTCPPacket->xTCPHeader.usSourcePort );
-            pxReturn->u.xTCP.ulRemoteIP = FreeRTOS_htonl( pxTCPPacket->xIPHeader.ulSourceIPAddress );
-            pxReturn->u.xTCP.xTCPWindow.ulOurSequenceNumber = ulInitialSequenceNumber;
+                    ulSpace >>= ucWinScaleFactor;
+                }
+            #endif /* ipconfigUSE_TCP_WIN */
 
-            /* Here is the SYN action. */
-            pxReturn->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber = FreeRTOS_ntohl( pxProtocolHeaders->xTCPHeader.ulSequenceNumber );
-            prvSocketSetMSS( pxReturn );
+            if( ulSpace > 0xfffcU )
+            {
+                ulSpace = 0xfffcU;
+            }
 
-            prvTCPCreateWindow( pxReturn );
+            uxOptionsLength = prvWriteSynAckOptions( pxTCPHeader, ( uint16_t ) ulMSS, ucWinScaleFactor );
+            pxTCPHeader->ucTCPFlags = ( uint8_t ) tcpTCP_FLAG_SYN | ( uint8_t ) tcpTCP_FLAG_ACK;
+            pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 );
+            pxTCPHeader->usWindow = FreeRTOS_htons( ( uint16_t ) ulSpace );
 
-            vTCPStateChange( pxReturn, eSYN_FIRST );
+            /* Without a socket, prvTCPReturnPacket() swaps the sequence number and
+             * the acknowledge number. */
+            pxTCPHeader->ulSequenceNumber = FreeRTOS_htonl( pxEntry->ulRemoteSequence + 1U );
+            pxTCPHeader->ulAckNr = FreeRTOS_htonl( pxEntry->ulOurSequence );
 
-            /* Make a copy of the header up to the TCP header.  It is needed later
-             * on, whenever data must be sent to the peer. */
-            ( void ) memcpy( ( void * ) pxReturn->u.xTCP.xPacket.u.ucLastPacket,
-                             ( const void * ) pxNetworkBuffer->pucEthernetBuffer,
-                             sizeof( pxReturn->u.xTCP.xPacket.u.ucLastPacket ) );
+            prvTCPReturnPacket( NULL, pxNetworkBuffer, ( uint32_t ) ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + uxOptionsLength ), pdFALSE );
         }
+        /*-----------------------------------------------------------*/
 
-        return pxReturn;
-    }
-    /*-----------------------------------------------------------*/
+/**
+ * @brief Check if a packet for a listening socket is the final ACK of a handshake
+ *        that was stored in the table of half-open connections.  If so, create the
+ *        child socket and bring it in the state eSYN_RECEIVED, as if it had sent
+ *        the SYN+ACK itself.  The packet will then establish the connection.
+ *
+ * @param[in,out] ppxSocket: The listening socket.  When the handshake is found, it
+ *                           will be replaced by the child socket, or by NULL when
+ *                           the child could not be created.
+ * @param[in] pxNetworkBuffer: The packet received.
+ *
+ * @return pdTRUE when the packet completed a handshake, otherwise pdFALSE.
+ */
+        static BaseType_t prvTCPSynQueueAccept( FreeRTOS_Socket_t ** ppxSocket,
+                                                NetworkBufferDescriptor_t * pxNetworkBuffer )
+        {
+            FreeRTOS_Socket_t * pxSocket = *ppxSocket;
+            FreeRTOS_Socket_t * pxNewSocket = NULL;
+            /* Map the ethernet buffer onto a TCPPacket_t struct for easy access to the fields. */
+            const TCPPacket_t * pxTCPPacket = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( TCPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+            uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber );
+            uint32_t ulAckNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulAckNr );
+            const uint8_t ucFlagsMask = ( uint8_t ) tcpTCP_FLAG_SYN | ( uint8_t ) tcpTCP_FLAG_RST | ( uint8_t ) tcpTCP_FLAG_ACK;
+            TCPSynEntry_t * pxEntry = NULL;
+            TCPWindow_t * pxTCPWindow;
+            uint8_t ucOptions[ tcpTCP_OPT_MSS_LEN ];
+            BaseType_t xResult = pdFALSE;
+
+            if( ( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED ) &&
+                ( ( pxTCPPacket->xTCPHeader.ucTCPFlags & ucFlagsMask ) == tcpTCP_FLAG_ACK ) )
+            {
+                pxEntry = prvTCPSynQueueFind( pxSocket->usLocalPort,
+                                              FreeRTOS_ntohl( pxTCPPacket->xIPHeader.ulSourceIPAddress ),
+                                              FreeRTOS_ntohs( pxTCPPacket->xTCPHeader.usSourcePort ) );
+            }
+
+            if( ( pxEntry != NULL ) &&
+                ( ulAckNumber == ( pxEntry->ulOurSequence + 1U ) ) &&
+                ( ulSequenceNumber == ( pxEntry->ulRemoteSequence + 1U ) ) )
+            {
+                /* The handshake has been completed, the entry is not needed anymore. */
+                pxEntry->usLocalPort = 0U;
+                xResult = pdTRUE;
+
+                if( pxSocket->u.xTCP.usChildCount >= pxSocket->u.xTCP.usBacklog )
+                {
+                    FreeRTOS_printf( ( "Check: Socket %u already has %u / %u child%s\n",
+                                       pxSocket->usLocalPort,
+                                       pxSocket->u.xTCP.usChildCount,
+                                       pxSocket->u.xTCP.usBacklog,
+                                       ( pxSocket->u.xTCP.usChildCount == 1U ) ? "" : "ren" ) );
+                    ( void ) prvTCPSendReset( pxNetworkBuffer );
+                }
+                else
+                {
+                    pxNewSocket = prvTCPCreateChild( pxSocket, pxNetworkBuffer );
+                }
+
+                if( pxNewSocket != NULL )
+                {
+                    prvTCPListenSetup( pxNewSocket, pxNetworkBuffer, pxEntry->ulOurSequence, pxEntry->ulRemoteSequence );
+
+                    /* Apply the options of the SYN, as prvCheckOptions() would have
+                     * done when the SYN arrived. */
+                    if( pxEntry->usPeerMSS != 0U )
+                    {
+                        ucOptions[ 0 ] = ( uint8_t ) tcpTCP_OPT_MSS;
+                        ucOptions[ 1 ] = ( uint8_t ) tcpTCP_OPT_MSS_LEN;
+                        ucOptions[ 2 ] = ( uint8_t ) ( pxEntry->usPeerMSS >> 8 );
+                        ucOptions[ 3 ] = ( uint8_t ) ( pxEntry->usPeerMSS & 0xffU );
+                        ( void ) prvSingleStepTCPHeaderOptions( ucOptions, tcpTCP_OPT_MSS_LEN, pxNewSocket, pdTRUE );
+                    }
+
+                    if( pxEntry->ucHasWinScale != ( uint8_t ) pdFALSE )
+                    {
+                        ucOptions[ 0 ] = ( uint8_t ) tcpTCP_OPT_WSOPT;
+                        ucOptions[ 1 ] = ( uint8_t ) tcpTCP_OPT_WSOPT_LEN;
+                        ucOptions[ 2 ] = pxEntry->ucPeerWinScale;
+                        ( void ) prvSingleStepTCPHeaderOptions( ucOptions, tcpTCP_OPT_WSOPT_LEN, pxNewSocket, pdTRUE );
+                    }
+
+                    /* Do what prvTCPHandleState() does when it sends the SYN+ACK in
+                     * the state eSYN_FIRST. */
+                    #if ( ipconfigUSE_TCP_WIN != 0 )
+                        {
+                            pxNewSocket->u.xTCP.ucMyWinScaleFactor = prvWinScaleFactor( pxNewSocket );
+                        }
+                    #endif
+                    vTCPStateChange( pxNewSocket, eSYN_RECEIVED );
+
+                    pxTCPWindow = &( pxNewSocket->u.xTCP.xTCPWindow );
+                    pxTCPWindow->rx.ulHighestSequenceNumber = ulSequenceNumber;
+                    pxTCPWindow->rx.ulCurrentSequenceNumber = ulSequenceNumber;
+                    pxTCPWindow->ulNextTxSequenceNumber = pxTCPWindow->tx.ulFirstSequenceNumber + 1U;
+                    pxTCPWindow->tx.ulCurrentSequenceNumber = pxTCPWindow->tx.ulFirstSequenceNumber + 1U;
+                }
+
+                *ppxSocket = pxNewSocket;
+            }
+
+            return xResult;
+        }
+        /*-----------------------------------------------------------*/
+
+    #endif /* ipconfigTCP_SYN_QUEUE */
+
+    #if ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+
+/**
+ * @brief Find a connection in the TIME_WAIT table.  Entries that have expired
+ *        are freed while looking.
+ *
+ * @param[in] usLocalPort: The local port number.
+ * @param[in] ulRemoteIP: The IP-address of the peer, in host-endian notation.
+ * @param[in] usRemotePort: The port number of the peer.
+ *
+ * @return The entry, or NULL when it was not found.
+ */
+        static TCPTimeWaitEntry_t * prvTCPTimeWaitFind( uint16_t usLocalPort,
+                                                        uint32_t ulRemoteIP,
+                                                        uint16_t usRemotePort )
+        {
+            TCPTimeWaitEntry_t * pxReturn = NULL;
+            TCPTimeWaitEntry_t * pxEntry;
+            TickType_t xNow = xTaskGetTickCount();
+            UBaseType_t uxIndex;
+
+            for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigTCP_TIME_WAIT_LENGTH; uxIndex++ )
+            {
+                pxEntry = &( xTCPTimeWaitTable[ uxIndex ] );
+
+                if( pxEntry->usLocalPort == 0U )
+                {
+                    /* A free entry. */
+                }
+                else if( ( xNow - pxEntry->xCloseTime ) >= pdMS_TO_TICKS( ipconfigTCP_TIME_WAIT_MS ) )
+                {
+                    /* The old connection can not disturb a new one anymore. */
+                    pxEntry->usLocalPort = 0U;
+                }
+                else if( ( pxEntry->usLocalPort == usLocalPort ) &&
+                         ( pxEntry->ulRemoteIP == ulRemoteIP ) &&
+                         ( pxEntry->usRemotePort == usRemotePort ) )
+                {
+                    pxReturn = pxEntry;
+                }
+                else
+                {
+                    /* An entry of another connection. */
+                }
+            }
+
+            return pxReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Remember a connection in the TIME_WAIT table, after the last ACK has been
+ *        sent to the peer.  When the table is full, the oldest entry is replaced.
+ *
+ * @param[in] pxSocket: The socket of the connection, which has completed its
+ *                      closure.
+ */
+        static void prvTCPTimeWaitAdd( const FreeRTOS_Socket_t * pxSocket )
+        {
+            const TCPWindow_t * pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+            TCPTimeWaitEntry_t * pxEntry = prvTCPTimeWaitFind( pxSocket->usLocalPort,
+                                                               pxSocket->u.xTCP.ulRemoteIP,
+                                                               pxSocket->u.xTCP.usRemotePort );
+            TickType_t xNow = xTaskGetTickCount();
+            UBaseType_t uxIndex;
+
+            if( pxEntry == NULL )
+            {
+                /* Take a free entry, or otherwise the oldest one. */
+                for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigTCP_TIME_WAIT_LENGTH; uxIndex++ )
+                {
+                    if( xTCPTimeWaitTable[ uxIndex ].usLocalPort == 0U )
+                    {
+                        pxEntry = &( xTCPTimeWaitTable[ uxIndex ] );
+                        break;
+                    }
+
+                    if( ( pxEntry == NULL ) || ( ( xNow - xTCPTimeWaitTable[ uxIndex ].xCloseTime ) > ( xNow - pxEntry->xCloseTime ) ) )
+                    {
+                        pxEntry = &( xTCPTimeWaitTable[ uxIndex ] );
+                    }
+                }
+
+                configASSERT( pxEntry != NULL );
+
+                if( pxEntry->usLocalPort != 0U )
+                {
+                    FreeRTOS_debug_printf( ( "TCP: TIME_WAIT table full, forget %xip:%u\n", ( unsigned ) pxEntry->ulRemoteIP, pxEntry->usRemotePort ) );
+                }
+            }
+
+            pxEntry->ulRemoteIP = pxSocket->u.xTCP.ulRemoteIP;
+            pxEntry->usRemotePort = pxSocket->u.xTCP.usRemotePort;
+            pxEntry->usLocalPort = pxSocket->usLocalPort;
+            pxEntry->ulRemoteSequence = pxTCPWindow->rx.ulCurrentSequenceNumber;
+            pxEntry->ulOurSequence = pxTCPWindow->tx.ulFINSequenceNumber + 1U;
+            pxEntry->ulWindowSize = pxSocket->u.xTCP.ulWindowSize;
+            pxEntry->xCloseTime = xNow;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if a packet that can not be handled by an active socket belongs to
+ *        a connection in the TIME_WAIT table.  A repeated FIN is acknowledged
+ *        again, as the last ACK may have been lost.  A SYN with a higher sequence
+ *        number than the old connection starts a new connection, and the entry is
+ *        forgotten.  All other packets are dropped without sending a RST, also a
+ *        RST is ignored, as recommended by RFC 1337.
+ *
+ * @param[in] pxSocket: The socket found for the packet, or NULL.
+ * @param[in] pxNetworkBuffer: The packet received, which will be used to send the ACK.
+ *
+ * @return pdTRUE when the packet has been handled, pdFALSE when it must be handled
+ *         as usual.
+ */
+        static BaseType_t prvTCPTimeWaitCheck( const FreeRTOS_Socket_t * pxSocket,
+                                               NetworkBufferDescriptor_t * pxNetworkBuffer )
+        {
+            /* Map the ethernet buffer onto a TCPPacket_t struct for easy access to the fields. */
+            TCPPacket_t * pxTCPPacket = ipCAST_PTR_TO_TYPE_PTR( TCPPacket_t, pxNetworkBuffer->pucEthernetBuffer );
+            TCPHeader_t * pxTCPHeader = &( pxTCPPacket->xTCPHeader );
+            uint8_t ucTCPFlags = pxTCPHeader->ucTCPFlags;
+            const uint8_t ucFlagsMask = ( uint8_t ) tcpTCP_FLAG_SYN | ( uint8_t ) tcpTCP_FLAG_RST | ( uint8_t ) tcpTCP_FLAG_ACK | ( uint8_t ) tcpTCP_FLAG_FIN;
+            TCPTimeWaitEntry_t * pxEntry = NULL;
+            BaseType_t xResult = pdFALSE;
+
+            if( ( pxSocket == NULL ) ||
+                ( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eTCP_LISTEN ) ||
+                ( prvTCPSocketIsActive( pxSocket->u.xTCP.ucTCPState ) == pdFALSE ) )
+            {
+                pxEntry = prvTCPTimeWaitFind( FreeRTOS_ntohs( pxTCPHeader->usDestinationPort ),
+                                              FreeRTOS_ntohl( pxTCPPacket->xIPHeader.ulSourceIPAddress ),
+                                              FreeRTOS_ntohs( pxTCPHeader->usSourcePort ) );
+            }
+
+            if( pxEntry == NULL )
+            {
+                /* Not a connection in TIME_WAIT. */
+            }
+            else if( ( ucTCPFlags & tcpTCP_FLAG_RST ) != 0U )
+            {
+                /* Do not let a RST end the TIME_WAIT state early. */
+                xResult = pdTRUE;
+            }
+            else if( ( ucTCPFlags & ucFlagsMask ) == tcpTCP_FLAG_SYN )
+            {
+                if( ( ( int32_t ) ( FreeRTOS_ntohl( pxTCPHeader->ulSequenceNumber ) - pxEntry->ulRemoteSequence ) ) > 0 )
+                {
+                    /* The sequence number proves that this is a new connection,
+                     * the port numbers may be used again. */
+                    pxEntry->usLocalPort = 0U;
+                }
+                else
+                {
+                    /* An old duplicate SYN. */
+                    xResult = pdTRUE;
+                }
+            }
+            else if( ( ucTCPFlags & tcpTCP_FLAG_FIN ) != 0U )
+            {
+                /* The peer did not receive the last ACK, send it again and start
+                 * waiting again. */
+                pxEntry->xCloseTime = xTaskGetTickCount();
+
+                pxTCPHeader->ucTCPFlags = tcpTCP_FLAG_ACK;
+                pxTCPHeader->ucTCPOffset = ( ipSIZE_OF_TCP_HEADER ) << 2;
+
+                /* Without a socket, prvTCPReturnPacket() swaps the sequence number and
+                 * the acknowledge number. */
+                pxTCPHeader->ulSequenceNumber = FreeRTOS_htonl( pxEntry->ulRemoteSequence );
+                pxTCPHeader->ulAckNr = FreeRTOS_htonl( pxEntry->ulOurSequence );
+
+                prvTCPReturnPacket( NULL, pxNetworkBuffer, ( uint32_t ) ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ), pdFALSE );
+                xResult = pdTRUE;
+            }
+            else
+            {
+                /* A late packet of the old connection. */
+                xResult = pdTRUE;
+            }
+
+            return xResult;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Forget a connection in the TIME_WAIT table before connecting from the
+ *        same port to the same peer again.  The peer may still be in TIME_WAIT
+ *        itself, and it will only accept a SYN with a higher sequence number than
+ *        the old connection.
+ *
+ * @param[in] pxSocket: The socket that will connect.
+ * @param[in] ulInitialSequenceNumber: The initial sequence number that was chosen.
+ *
+ * @return The initial sequence number to be used.
+ */
+        static uint32_t prvTCPTimeWaitReuse( const FreeRTOS_Socket_t * pxSocket,
+                                             uint32_t ulInitialSequenceNumber )
+        {
+            TCPTimeWaitEntry_t * pxEntry = prvTCPTimeWaitFind( pxSocket->usLocalPort,
+                                                               pxSocket->u.xTCP.ulRemoteIP,
+                                                               pxSocket->u.xTCP.usRemotePort );
+            uint32_t ulReturn = ulInitialSequenceNumber;
+
+            if( pxEntry != NULL )
+            {
+                if( ( ( int32_t ) ( ulInitialSequenceNumber - pxEntry->ulOurSequence ) ) <= 0 )
+                {
+                    /* Start beyond the last window that the peer advertised, so
+                     * that no segment of the old connection, which may still be
+                     * in the network, falls into the new one.  With window
+                     * scaling that window can be larger than 64 KB. */
+                    ulReturn = pxEntry->ulOurSequence + pxEntry->ulWindowSize + 1U;
+                }
+
+                pxEntry->usLocalPort = 0U;
+            }
+
+            return ulReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+    #endif /* ipconfigTCP_TIME_WAIT_TABLE */
 
 /**
  * @brief Duplicates a socket after a listening socket receives a connection and bind
@@ -3935,6 +5710,19 @@
         pxNewSocket->u.xTCP.uxRxWinSize = pxSocket->u.xTCP.uxRxWinSize;
         pxNewSocket->u.xTCP.uxTxWinSize = pxSocket->u.xTCP.uxTxWinSize;
 
+        #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+            {
+                pxNewSocket->u.xTCP.xAckPolicy = pxSocket->u.xTCP.xAckPolicy;
+            }
+        #endif
+
+        #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+            {
+                pxNewSocket->u.xTCP.uxRcvLowat = pxSocket->u.xTCP.uxRcvLowat;
+                pxNewSocket->u.xTCP.uxSndLowat = pxSocket->u.xTCP.uxSndLowat;
+            }
+        #endif
+
         #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
             {
                 pxNewSocket->pxUserSemaphore = pxSocket->pxUserSemaphore;
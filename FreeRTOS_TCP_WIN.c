@@ -194,6 +194,14 @@
                                                   uint32_t ulWindowSize );
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 
+/*
+ * Find the segment that must be transmitted now, and mark it as sent.
+ */
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+        static TCPSegment_t * prvTCPWindowTxGetSegment( TCPWindow_t * pxWindow,
+                                                        uint32_t ulWindowSize );
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+
 /*
  * An acknowledge was received.  See if some outstanding data may be removed
  * from the transmission queue(s).
@@ -1480,6 +1488,44 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+
+/**
+ * @brief The txStream has been replaced with a stream in which the data starts at
+ *        index 0.  Translate the stream positions of all transmission segments.
+ *
+ * @param[in] pxWindow: The descriptor of the TCP sliding windows.
+ * @param[in] lTail: The tail index in the old stream.
+ * @param[in] lMax: The size of the old ( circular ) TX stream buffer.
+ */
+        void vTCPWindowTxRebase( TCPWindow_t * pxWindow,
+                                 int32_t lTail,
+                                 int32_t lMax )
+        {
+            const ListItem_t * pxIterator;
+            const ListItem_t * pxEnd = ipCAST_CONST_PTR_TO_CONST_TYPE_PTR( ListItem_t, &( pxWindow->xTxSegments.xListEnd ) );
+            TCPSegment_t * pxSegment;
+
+            for( pxIterator = listGET_NEXT( pxEnd );
+                 pxIterator != pxEnd;
+                 pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+            {
+                pxSegment = ipCAST_PTR_TO_TYPE_PTR( TCPSegment_t, listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                if( pxSegment->lStreamPos >= lTail )
+                {
+                    pxSegment->lStreamPos -= lTail;
+                }
+                else
+                {
+                    pxSegment->lStreamPos += lMax - lTail;
+                }
+            }
+        }
+
+    #endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 ) */
+/*-----------------------------------------------------------*/
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
@@ -1761,21 +1807,64 @@
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
- * @brief Get data that can be transmitted right now. There are three types of
- *        outstanding segments: Priority queue, Waiting queue, Normal TX queue.
+ * @brief A segment is about to be transmitted: add it to the waiting queue
+ *        and administer the transmission.
+ *
+ * @param[in] pxWindow: The descriptor of the TCP sliding windows.
+ * @param[in] pxSegment: The segment that will be transmitted.
+ */
+        static void prvTCPWindowTxMarkSent( TCPWindow_t * pxWindow,
+                                            TCPSegment_t * pxSegment )
+        {
+            configASSERT( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) == NULL );
+
+            /* Now that the segment will be transmitted, add it to the tail of
+             * the waiting queue. */
+            vListInsertFifo( &pxWindow->xWaitQueue, &pxSegment->xQueueItem );
+
+            /* And mark it as outstanding. */
+            pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
+
+            /* Administer the transmit count, needed for fast
+             * retransmissions. */
+            ( pxSegment->u.bits.ucTransmitCount )++;
+
+            /* If there have been several retransmissions (4), decrease the
+             * size of the transmission window to at most 2 times MSS. */
+            if( ( pxSegment->u.bits.ucTransmitCount == MAX_TRANSMIT_COUNT_USING_LARGE_WINDOW ) &&
+                ( pxWindow->xSize.ulTxWindowLength > ( 2U * ( ( uint32_t ) pxWindow->usMSS ) ) ) )
+            {
+                uint16_t usMSS2 = pxWindow->usMSS * 2U;
+                FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u - %u]: Change Tx window: %u -> %u\n",
+                                         pxWindow->usPeerPortNumber,
+                                         pxWindow->usOurPortNumber,
+                                         ( unsigned ) pxWindow->xSize.ulTxWindowLength,
+                                         usMSS2 ) );
+                pxWindow->xSize.ulTxWindowLength = usMSS2;
+            }
+
+            /* Clear the transmit timer. */
+            vTCPTimerSet( &( pxSegment->xTransmitTimer ) );
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Get the segment that can be transmitted right now. There are three types
+ *        of outstanding segments: Priority queue, Waiting queue, Normal TX queue.
  *
  * @param[in] pxWindow: The descriptor of the TCP sliding windows.
  * @param[in] ulWindowSize: The current size of the sliding RX window of the peer.
- * @param[out] plPosition: The index within the TX stream buffer of the first byte to be sent.
  *
- * @return The amount of data in bytes that can be transmitted right now.
+ * @return The segment, which has been marked as sent, or NULL when there is
+ *         nothing to send.
  */
-        uint32_t ulTCPWindowTxGet( TCPWindow_t * pxWindow,
-                                   uint32_t ulWindowSize,
-                                   int32_t * plPosition )
+        static TCPSegment_t * prvTCPWindowTxGetSegment( TCPWindow_t * pxWindow,
+                                                        uint32_t ulWindowSize )
         {
             TCPSegment_t * pxSegment;
-            uint32_t ulReturn = 0U;
 
             /* Fetches data to be sent-out now.
              *
@@ -1817,38 +1906,34 @@
             /* See if it has already been determined to return 0. */
             if( pxSegment != NULL )
             {
-                configASSERT( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) == NULL );
-
-                /* Now that the segment will be transmitted, add it to the tail of
-                 * the waiting queue. */
-                vListInsertFifo( &pxWindow->xWaitQueue, &pxSegment->xQueueItem );
-
-                /* And mark it as outstanding. */
-                pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
-
-                /* Administer the transmit count, needed for fast
-                 * retransmissions. */
-                ( pxSegment->u.bits.ucTransmitCount )++;
+                prvTCPWindowTxMarkSent( pxWindow, pxSegment );
 
-                /* If there have been several retransmissions (4), decrease the
-                 * size of the transmission window to at most 2 times MSS. */
-                if( ( pxSegment->u.bits.ucTransmitCount == MAX_TRANSMIT_COUNT_USING_LARGE_WINDOW ) &&
-                    ( pxWindow->xSize.ulTxWindowLength > ( 2U * ( ( uint32_t ) pxWindow->usMSS ) ) ) )
-                {
-                    uint16_t usMSS2 = pxWindow->usMSS * 2U;
-                    FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u - %u]: Change Tx window: %u -> %u\n",
-                                             pxWindow->usPeerPortNumber,
-                                             pxWindow->usOurPortNumber,
-                                             ( unsigned ) pxWindow->xSize.ulTxWindowLength,
-                                             usMSS2 ) );
-                    pxWindow->xSize.ulTxWindowLength = usMSS2;
-                }
+                pxWindow->ulOurSequenceNumber = pxSegment->ulSequenceNumber;
+            }
 
-                /* Clear the transmit timer. */
-                vTCPTimerSet( &( pxSegment->xTransmitTimer ) );
+            return pxSegment;
+        }
+        /*-----------------------------------------------------------*/
 
-                pxWindow->ulOurSequenceNumber = pxSegment->ulSequenceNumber;
+/**
+ * @brief Get data that can be transmitted right now. There are three types of
+ *        outstanding segments: Priority queue, Waiting queue, Normal TX queue.
+ *
+ * @param[in] pxWindow: The descriptor of the TCP sliding windows.
+ * @param[in] ulWindowSize: The current size of the sliding RX window of the peer.
+ * @param[out] plPosition: The index within the TX stream buffer of the first byte to be sent.
+ *
+ * @return The amount of data in bytes that can be transmitted right now.
+ */
+        uint32_t ulTCPWindowTxGet( TCPWindow_t * pxWindow,
+                                   uint32_t ulWindowSize,
+                                   int32_t * plPosition )
+        {
+            const TCPSegment_t * pxSegment = prvTCPWindowTxGetSegment( pxWindow, ulWindowSize );
+            uint32_t ulReturn = 0U;
 
+            if( pxSegment != NULL )
+            {
                 /* Inform the caller where to find the data within the queue. */
                 *plPosition = pxSegment->lStreamPos;
 
@@ -1863,6 +1948,83 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 )
+
+/**
+ * @brief Get a burst of data that can be transmitted right now.  The first
+ *        segment is obtained in the same way as in ulTCPWindowTxGet().  When it
+ *        is sent for the first time, and as long as the segments are completely
+ *        filled, new segments that directly follow in sequence will be appended,
+ *        so that they can be sent as a single super-segment.  A retransmission
+ *        is always sent on its own.
+ *
+ * @param[in] pxWindow: The descriptor of the TCP sliding windows.
+ * @param[in] ulWindowSize: The current size of the sliding RX window of the peer.
+ * @param[out] plPosition: The index within the TX stream buffer of the first byte to be sent.
+ * @param[in] ulMaxLength: The maximum number of bytes that may be combined.
+ *
+ * @return The amount of data in bytes that can be transmitted right now.
+ */
+        uint32_t ulTCPWindowTxGetBurst( TCPWindow_t * pxWindow,
+                                        uint32_t ulWindowSize,
+                                        int32_t * plPosition,
+                                        uint32_t ulMaxLength )
+        {
+            TCPSegment_t * pxSegment = prvTCPWindowTxGetSegment( pxWindow, ulWindowSize );
+            uint32_t ulReturn = 0U;
+            uint32_t ulFirstSequenceNumber = pxWindow->ulOurSequenceNumber;
+            BaseType_t xMayAppend = pdFALSE;
+
+            if( pxSegment != NULL )
+            {
+                *plPosition = pxSegment->lStreamPos;
+                ulReturn = ( uint32_t ) pxSegment->lDataLength;
+
+                /* Only a segment of new data, which is now sent for the first
+                 * time, may start a burst. */
+                if( pxSegment->u.bits.ucTransmitCount == 1U )
+                {
+                    xMayAppend = pdTRUE;
+                }
+            }
+
+            while( ( xMayAppend != pdFALSE ) && ( ( ulReturn % ( uint32_t ) pxWindow->usMSS ) == 0U ) )
+            {
+                pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxQueue ) );
+
+                /* Priority segments ( fast retransmissions ) will not wait for a
+                 * burst to complete.  And only new data that directly follows the
+                 * previous segment can be appended. */
+                if( ( listLIST_IS_EMPTY( &( pxWindow->xPriorityQueue ) ) == pdFALSE ) ||
+                    ( pxSegment == NULL ) ||
+                    ( pxSegment->ulSequenceNumber != ( ulFirstSequenceNumber + ulReturn ) ) ||
+                    ( ( ulReturn + ( uint32_t ) pxSegment->lDataLength ) > ulMaxLength ) )
+                {
+                    break;
+                }
+
+                /* pxTCPWindowTx_GetTXQueue() checks the space in the peer's
+                 * reception window. */
+                pxSegment = pxTCPWindowTx_GetTXQueue( pxWindow, ulWindowSize );
+
+                if( pxSegment == NULL )
+                {
+                    break;
+                }
+
+                prvTCPWindowTxMarkSent( pxWindow, pxSegment );
+                ulReturn += ( uint32_t ) pxSegment->lDataLength;
+            }
+
+            /* The super-segment starts with the sequence number of the first segment. */
+            pxWindow->ulOurSequenceNumber = ulFirstSequenceNumber;
+
+            return ulReturn;
+        }
+
+    #endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) */
+/*-----------------------------------------------------------*/
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
@@ -2330,6 +2492,38 @@
     #endif /* ipconfigUSE_TCP_WIN == 0 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_WIN == 0 ) && ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+
+/**
+ * @brief The txStream has been replaced with a stream in which the data starts at
+ *        index 0.  Translate the stream position of the transmission segment.
+ *
+ * @param[in] pxWindow: The window for the connection.
+ * @param[in] lTail: The tail index in the old stream.
+ * @param[in] lMax: The size of the old ( circular ) TX stream buffer.
+ */
+        void vTCPWindowTxRebase( TCPWindow_t * pxWindow,
+                                 int32_t lTail,
+                                 int32_t lMax )
+        {
+            TCPSegment_t * pxSegment = &( pxWindow->xTxSegment );
+
+            if( pxSegment->lDataLength > 0 )
+            {
+                if( pxSegment->lStreamPos >= lTail )
+                {
+                    pxSegment->lStreamPos -= lTail;
+                }
+                else
+                {
+                    pxSegment->lStreamPos += lMax - lTail;
+                }
+            }
+        }
+
+    #endif /* ( ipconfigUSE_TCP_WIN == 0 ) && ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 ) */
+/*-----------------------------------------------------------*/
+
     #if ( ipconfigUSE_TCP_WIN == 0 )
 
 /**
@@ -82,6 +82,16 @@ UDPPacketHeader_t xDefaultPartUDPPacketHeader =
 };
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+
+/*
+ * Let the sending socket store the MAC-address of the destination.
+ */
+    static void prvUDPStoreDestination( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                        const MACAddress_t * pxMACAddress );
+#endif
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Process the generated UDP packet and do other checks before sending the
  *        packet such as ARP cache check and address resolution.
@@ -95,6 +105,11 @@ void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuff
     eARPLookupResult_t eReturned;
     uint32_t ulIPAddress = pxNetworkBuffer->ulIPAddress;
     size_t uxPayloadSize;
+    BaseType_t xIsPending = pdFALSE;
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        uint32_t ulGeneration;
+    #endif
     /* memcpy() helper variables for MISRA Rule 21.15 compliance*/
     const void * pvCopySource;
     void * pvCopyDest;
@@ -113,8 +128,28 @@ void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuff
         uxPayloadSize = pxNetworkBuffer->xDataLength - sizeof( UDPPacket_t );
     }
 
-    /* Determine the ARP cache status for the requested IP address. */
-    eReturned = eARPGetCacheEntry( &( ulIPAddress ), &( pxUDPPacket->xEthernetHeader.xDestinationAddress ) );
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        ( void ) memcpy( &( ulGeneration ), &( pxNetworkBuffer->pucEthernetBuffer[ ipDESTINATION_GENERATION_OFFSET ] ), sizeof( ulGeneration ) );
+
+        if( ( ulGeneration != 0U ) && ( ulGeneration == ulARPGetGeneration() ) )
+        {
+            /* FreeRTOS_sendto() has copied the MAC-address that the socket
+             * stored, and it is still valid. */
+            eReturned = eARPCacheHit;
+        }
+        else
+    #endif /* ipconfigUSE_DESTINATION_CACHE */
+    {
+        /* Determine the ARP cache status for the requested IP address. */
+        eReturned = eARPGetCacheEntry( &( ulIPAddress ), &( pxUDPPacket->xEthernetHeader.xDestinationAddress ) );
+
+        #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+            if( eReturned == eARPCacheHit )
+            {
+                prvUDPStoreDestination( pxNetworkBuffer, &( pxUDPPacket->xEthernetHeader.xDestinationAddress ) );
+            }
+        #endif
+    }
 
     if( eReturned != eCantSendPacket )
     {
@@ -218,6 +253,17 @@ void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuff
                 }
             #endif
 
+            #if ( ipconfigUSE_MDNS != 0 )
+                {
+                    /* Multicast DNS messages are sent with a TTL of 255, so
+                     * that a receiver can tell that they come from the LAN. */
+                    if( pxNetworkBuffer->ulIPAddress == ipMDNS_IP_ADDR )
+                    {
+                        pxIPHeader->ucTimeToLive = 0xffU;
+                    }
+                }
+            #endif
+
             #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
                 {
                     pxIPHeader->usHeaderChecksum = 0U;
@@ -242,10 +288,22 @@ void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuff
              * outstanding, and perform retransmissions if necessary. */
             vARPRefreshCacheEntry( NULL, ulIPAddress );
 
-            /* Generate an ARP for the required IP address. */
-            iptracePACKET_DROPPED_TO_GENERATE_ARP( pxNetworkBuffer->ulIPAddress );
-            pxNetworkBuffer->ulIPAddress = ulIPAddress;
-            vARPGenerateRequestPacket( pxNetworkBuffer );
+            #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+                if( xARPQueuePendingPacket( ulIPAddress, pxNetworkBuffer, pdTRUE ) != pdFALSE )
+                {
+                    /* The packet will be sent when the ARP reply comes in. */
+                    FreeRTOS_OutputARPRequest( ulIPAddress );
+                    xIsPending = pdTRUE;
+                    eReturned = eCantSendPacket;
+                }
+                else
+            #endif /* ipconfigUSE_ARP_HASH_TABLE */
+            {
+                /* Generate an ARP for the required IP address. */
+                iptracePACKET_DROPPED_TO_GENERATE_ARP( pxNetworkBuffer->ulIPAddress );
+                pxNetworkBuffer->ulIPAddress = ulIPAddress;
+                vARPGenerateRequestPacket( pxNetworkBuffer );
+            }
         }
         else
         {
@@ -255,6 +313,15 @@ void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuff
         }
     }
 
+    #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+        else
+        {
+            /* An ARP request may be outstanding for the address, in which case
+             * the packet can wait for the reply. */
+            xIsPending = xARPQueuePendingPacket( ulIPAddress, pxNetworkBuffer, pdTRUE );
+        }
+    #endif
+
     if( eReturned != eCantSendPacket )
     {
         /* The network driver is responsible for freeing the network buffer
@@ -278,15 +345,63 @@ void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuff
         iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
         ( void ) xNetworkInterfaceOutput( pxNetworkBuffer, pdTRUE );
     }
-    else
+    else if( xIsPending == pdFALSE )
     {
         /* The packet can't be sent (DHCP not completed?).  Just drop the
          * packet. */
         vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
     }
+    else
+    {
+        /* The packet is waiting in the ARP cache. */
+    }
 }
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+
+/**
+ * @brief Let the socket that sends a packet store the MAC-address of its
+ *        destination.  As long as ulARPGetGeneration() does not change,
+ *        FreeRTOS_sendto() will copy that MAC-address into the next packets
+ *        for the same IP-address, and the ARP lookup will be skipped.
+ *
+ * @param[in] pxNetworkBuffer: The network buffer carrying the packet.
+ * @param[in] pxMACAddress: The MAC-address of the destination.
+ */
+    static void prvUDPStoreDestination( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                        const MACAddress_t * pxMACAddress )
+    {
+        FreeRTOS_Socket_t * pxSocket = NULL;
+
+        #if ( ipconfigSUPPORT_OUTGOING_PINGS == 1 )
+            /* A ping request was not sent through a socket. */
+            if( pxNetworkBuffer->usPort != ( uint16_t ) ipPACKET_CONTAINS_ICMP_DATA )
+        #endif
+        {
+            pxSocket = pxUDPSocketLookup( ( UBaseType_t ) pxNetworkBuffer->usBoundPort );
+        }
+
+        if( pxSocket != NULL )
+        {
+            /* FreeRTOS_sendto() may read the entry at any moment.  It will not
+             * use it when the sequence number is odd, or when the sequence number
+             * has changed while it was copying. */
+            pxSocket->u.xUDP.ulDestinationSequence++;
+            ipMEMORY_BARRIER();
+
+            pxSocket->u.xUDP.ulDestinationIP = pxNetworkBuffer->ulIPAddress;
+            ( void ) memcpy( pxSocket->u.xUDP.xDestinationMAC.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) );
+            pxSocket->u.xUDP.ulDestinationGeneration = ulARPGetGeneration();
+
+            ipMEMORY_BARRIER();
+            pxSocket->u.xUDP.ulDestinationSequence++;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_DESTINATION_CACHE */
+
 /**
  * @brief Process the received UDP packet.
  *
@@ -398,10 +513,16 @@ BaseType_t xProcessReceivedUDPPacket( NetworkBufferDescriptor_t * pxNetworkBuffe
                 ( void ) xTaskResumeAll();
 
                 /* Set the socket's receive event */
-                if( pxSocket->xEventGroup != NULL )
-                {
-                    ( void ) xEventGroupSetBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_RECEIVE );
-                }
+                #if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+                    {
+                        vSocketSetEvents( pxSocket, ( EventBits_t ) eSOCKET_RECEIVE );
+                    }
+                #else
+                    if( pxSocket->xEventGroup != NULL )
+                    {
+                        vSocketSetEvents( pxSocket, ( EventBits_t ) eSOCKET_RECEIVE );
+                    }
+                #endif
 
                 #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
                     {
@@ -412,6 +533,15 @@ BaseType_t xProcessReceivedUDPPacket( NetworkBufferDescriptor_t * pxNetworkBuffe
                     }
                 #endif
 
+                #if ( ipconfigSUPPORT_EPOLL == 1 )
+                    {
+                        if( pxSocket->pxEPollSet != NULL )
+                        {
+                            vSocketEPollSignal( pxSocket, ( EventBits_t ) eSELECT_READ );
+                        }
+                    }
+                #endif
+
                 #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
                     {
                         if( pxSocket->pxUserSemaphore != NULL )
@@ -429,6 +559,15 @@ BaseType_t xProcessReceivedUDPPacket( NetworkBufferDescriptor_t * pxNetworkBuffe
                         }
                     }
                 #endif
+
+                #if ( ipconfigDNS_USE_RESOLVER != 0 )
+                    {
+                        if( xIsDNSResolverSocket( pxSocket ) != pdFALSE )
+                        {
+                            ( void ) xSendDNSResolverEvent();
+                        }
+                    }
+                #endif
             }
         }
         else
@@ -461,6 +600,16 @@ BaseType_t xProcessReceivedUDPPacket( NetworkBufferDescriptor_t * pxNetworkBuffe
                 else
             #endif /* ipconfigUSE_LLMNR */
 
+            #if ( ipconfigUSE_MDNS != 0 )
+                /* An mDNS query or response, check for the destination port. */
+                if( usPort == FreeRTOS_ntohs( ipMDNS_PORT ) )
+                {
+                    vARPRefreshCacheEntry( &( pxUDPPacket->xEthernetHeader.xSourceAddress ), pxUDPPacket->xIPHeader.ulSourceIPAddress );
+                    xReturn = ( BaseType_t ) ulMDNSHandlePacket( pxNetworkBuffer );
+                }
+                else
+            #endif /* ipconfigUSE_MDNS */
+
             #if ( ipconfigUSE_NBNS == 1 )
                 /* a NetBIOS request, check for the destination port */
                 if( ( usPort == FreeRTOS_ntohs( ipNBNS_PORT ) ) ||
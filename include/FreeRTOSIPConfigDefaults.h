@@ -662,4 +662,626 @@
     #define ipconfigPROCESS_CUSTOM_ETHERNET_FRAMES    0
 #endif
 
+/* When ipconfigUSE_TCP_SEGMENTATION_OFFLOAD is non-zero, a TCP socket will
+ * combine consecutive segments of new data into one "super-segment" of at most
+ * ipconfigTCP_SEGMENTATION_OFFLOAD_MAX_SEGMENTS times MSS.  The data is copied
+ * from the TX stream and the headers are filled in once per burst.  Either
+ * the driver segments the packet (see ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION),
+ * or it will be split by the IP-task just before calling xNetworkInterfaceOutput().
+ * Super-segments are only made when ipconfigUSE_TCP_WIN is enabled, and when
+ * network buffers have a variable size, as in BufferAllocation_2.c. */
+#ifndef ipconfigUSE_TCP_SEGMENTATION_OFFLOAD
+    #define ipconfigUSE_TCP_SEGMENTATION_OFFLOAD    0
+#endif
+
+#ifndef ipconfigTCP_SEGMENTATION_OFFLOAD_MAX_SEGMENTS
+    #define ipconfigTCP_SEGMENTATION_OFFLOAD_MAX_SEGMENTS    ( 8 )
+#endif
+
+/* Define ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION as 1 if the network interface
+ * is able to segment a TCP super-segment (TSO).  The size of the segments is
+ * passed in the field 'usSegmentSize' of the network buffer descriptor; it will
+ * be zero for normal packets.  A driver that segments packets must also take
+ * care of the IP- and TCP-checksums. */
+#ifndef ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION
+    #define ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION    0
+#endif
+
+#if ( ipconfigTCP_SEGMENTATION_OFFLOAD_MAX_SEGMENTS < 1 ) || ( ( ipconfigTCP_SEGMENTATION_OFFLOAD_MAX_SEGMENTS * ipconfigNETWORK_MTU ) > 0xffff )
+    #error ipconfigTCP_SEGMENTATION_OFFLOAD_MAX_SEGMENTS must be at least 1 and a super-segment must fit in the 16-bit IP length field
+#endif
+
+#if ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION != 0 ) && ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+    #error A driver that segments TCP packets must also calculate the checksums
+#endif
+
+/* When ipconfigUSE_TCP_RX_COALESCING is non-zero, the IP-task will merge
+ * consecutive in-order TCP segments of the same connection, as found in a chain
+ * of received packets, into a single segment of at most
+ * ipconfigTCP_RX_COALESCING_MAX_SEGMENTS segments.  The TCP state machine, the
+ * wake-up of the socket owner and the ACK logic will then run once per batch.
+ * The driver must pass chains of packets (ipconfigUSE_LINKED_RX_MESSAGES) and
+ * it must have checked the checksums (ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM).
+ * Packets will only be merged when network buffers have a variable size, as in
+ * BufferAllocation_2.c. */
+#ifndef ipconfigUSE_TCP_RX_COALESCING
+    #define ipconfigUSE_TCP_RX_COALESCING    0
+#endif
+
+#ifndef ipconfigTCP_RX_COALESCING_MAX_SEGMENTS
+    #define ipconfigTCP_RX_COALESCING_MAX_SEGMENTS    ( 8 )
+#endif
+
+#if ( ipconfigUSE_TCP_RX_COALESCING != 0 )
+    #if ( ipconfigUSE_LINKED_RX_MESSAGES == 0 ) || ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM != 1 )
+        #error ipconfigUSE_TCP_RX_COALESCING requires ipconfigUSE_LINKED_RX_MESSAGES and ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM
+    #endif
+
+    #if ( ipconfigTCP_RX_COALESCING_MAX_SEGMENTS < 1 ) || ( ( ipconfigTCP_RX_COALESCING_MAX_SEGMENTS * ipconfigNETWORK_MTU ) > 0xffff )
+        #error ipconfigTCP_RX_COALESCING_MAX_SEGMENTS must be at least 1 and a merged packet must fit in the 16-bit IP length field
+    #endif
+#endif
+
+/* When ipconfigUSE_TCP_ACK_POLICY is non-zero, the socket option
+ * FREERTOS_SO_TCP_ACK_POLICY can be used to tune the delayed-ACK behaviour of
+ * a TCP socket: send an ACK after every N full-size segments, use a quick-ACK
+ * mode while the peer is in slow start, and change the maximum delay.  An ACK
+ * will not be delayed when data arrives out of order or when the reception
+ * window changes.  The socket keeps counters of the ACK's that it sent, see
+ * FreeRTOS_GetTCPAckStatistics().  Delayed ACK's are only used when
+ * ipconfigUSE_TCP_WIN is enabled. */
+#ifndef ipconfigUSE_TCP_ACK_POLICY
+    #define ipconfigUSE_TCP_ACK_POLICY    0
+#endif
+
+#if ( ipconfigUSE_TCP_ACK_POLICY != 0 ) && ( ipconfigUSE_TCP_WIN == 0 )
+    #error ipconfigUSE_TCP_ACK_POLICY requires ipconfigUSE_TCP_WIN
+#endif
+
+/* When ipconfigUSE_TCP_RX_AUTOTUNING is non-zero, the size of the reception
+ * stream of a TCP socket, as set with FREERTOS_SO_RCVBUF or
+ * FREERTOS_SO_WIN_PROPERTIES, becomes a maximum.  A connection starts with a
+ * stream of ipconfigTCP_RX_AUTOTUNE_INITIAL_SIZE bytes, which grows when the
+ * amount of data received per round-trip time grows.  When the free heap
+ * drops below ipconfigTCP_RX_AUTOTUNE_LOW_HEAP bytes, the stream returns to its
+ * initial size.  The stream is only replaced while it is empty, and it never
+ * becomes smaller than the window that was advertised to the peer.  The window
+ * scaling factor is based on the maximum size.  Once FreeRTOS_get_rx_buf() or
+ * a zero-copy FreeRTOS_recv() has been called, the application may hold a
+ * pointer into the stream, and the stream of that socket keeps its size. */
+#ifndef ipconfigUSE_TCP_RX_AUTOTUNING
+    #define ipconfigUSE_TCP_RX_AUTOTUNING    0
+#endif
+
+#ifndef ipconfigTCP_RX_AUTOTUNE_INITIAL_SIZE
+    #define ipconfigTCP_RX_AUTOTUNE_INITIAL_SIZE    ( 4U * ipconfigTCP_MSS )
+#endif
+
+#ifndef ipconfigTCP_RX_AUTOTUNE_LOW_HEAP
+    #define ipconfigTCP_RX_AUTOTUNE_LOW_HEAP    ( 16U * 1024U )
+#endif
+
+/* When ipconfigUSE_TCP_TX_AUTOTUNING is non-zero, the transmission stream of a
+ * TCP socket, as set with FREERTOS_SO_SNDBUF or FREERTOS_SO_WIN_PROPERTIES, may
+ * grow when the application is limited by a full stream.  The size follows the
+ * amount of data acknowledged per round-trip time, and is limited by twice the
+ * transmission window, and by ipconfigTCP_TX_AUTOTUNE_MAX_SIZE bytes.  All
+ * sockets together may not grow by more than ipconfigTCP_TX_AUTOTUNE_BUDGET
+ * bytes.  Growing or shrinking copies the outstanding data into a new stream.
+ * Once FreeRTOS_get_tx_head() has been called, the application writes directly
+ * into the stream, and the stream of that socket keeps its size. */
+#ifndef ipconfigUSE_TCP_TX_AUTOTUNING
+    #define ipconfigUSE_TCP_TX_AUTOTUNING    0
+#endif
+
+#ifndef ipconfigTCP_TX_AUTOTUNE_MAX_SIZE
+    #define ipconfigTCP_TX_AUTOTUNE_MAX_SIZE    ( 64U * 1024U )
+#endif
+
+#ifndef ipconfigTCP_TX_AUTOTUNE_BUDGET
+    #define ipconfigTCP_TX_AUTOTUNE_BUDGET    ( 64U * 1024U )
+#endif
+
+/* When ipconfigUSE_ARP_HASH_TABLE is non-zero, the ARP cache is indexed by hash
+ * tables on the IP-address and on the MAC-address, and the least recently
+ * refreshed entry is found without scanning the table.  This makes large values
+ * of ipconfigARP_CACHE_ENTRIES practical.  ipconfigARP_HASH_BUCKETS must be a
+ * power of two.  Every entry that waits for an ARP reply can hold up to
+ * ipconfigARP_PENDING_QUEUE_LENGTH packets, both received packets and packets
+ * to be sent.  They are processed as soon as the reply arrives. */
+#ifndef ipconfigUSE_ARP_HASH_TABLE
+    #define ipconfigUSE_ARP_HASH_TABLE    0
+#endif
+
+#ifndef ipconfigARP_HASH_BUCKETS
+    #define ipconfigARP_HASH_BUCKETS    64U
+#endif
+
+#ifndef ipconfigARP_PENDING_QUEUE_LENGTH
+    #define ipconfigARP_PENDING_QUEUE_LENGTH    4U
+#endif
+
+#if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+    #if ( ( ipconfigARP_HASH_BUCKETS & ( ipconfigARP_HASH_BUCKETS - 1U ) ) != 0U )
+        #error ipconfigARP_HASH_BUCKETS must be a power of two
+    #endif
+
+    #if ( ipconfigARP_CACHE_ENTRIES > 0xfffe )
+        #error ipconfigARP_CACHE_ENTRIES is too large for ipconfigUSE_ARP_HASH_TABLE
+    #endif
+
+    #if ( ipconfigARP_PENDING_QUEUE_LENGTH < 1 ) || ( ipconfigARP_PENDING_QUEUE_LENGTH > 8 )
+        #error ipconfigARP_PENDING_QUEUE_LENGTH must be between 1 and 8
+    #endif
+#endif /* ipconfigUSE_ARP_HASH_TABLE */
+
+/* When ipconfigUSE_ARP_TIMER_WHEEL is non-zero, every ARP cache entry is stored
+ * in a timer wheel with ipconfigARP_TIMER_WHEEL_SLOTS slots, at the period of
+ * the ARP timer in which it next needs attention.  The ARP timer only visits the
+ * entries of one slot, instead of all entries.  Before an entry expires, its
+ * ARP request is sent up to ipconfigARP_AGE_JITTER periods earlier, so that
+ * entries learnt at the same moment are not all refreshed at once.  This option
+ * requires ipconfigUSE_ARP_HASH_TABLE. */
+#ifndef ipconfigUSE_ARP_TIMER_WHEEL
+    #define ipconfigUSE_ARP_TIMER_WHEEL    0
+#endif
+
+#ifndef ipconfigARP_TIMER_WHEEL_SLOTS
+    #define ipconfigARP_TIMER_WHEEL_SLOTS    32U
+#endif
+
+#ifndef ipconfigARP_AGE_JITTER
+    #define ipconfigARP_AGE_JITTER    5U
+#endif
+
+#if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+    #if ( ipconfigUSE_ARP_HASH_TABLE == 0 )
+        #error ipconfigUSE_ARP_TIMER_WHEEL requires ipconfigUSE_ARP_HASH_TABLE
+    #endif
+
+    #if ( ( ipconfigARP_TIMER_WHEEL_SLOTS & ( ipconfigARP_TIMER_WHEEL_SLOTS - 1U ) ) != 0U )
+        #error ipconfigARP_TIMER_WHEEL_SLOTS must be a power of two
+    #endif
+#endif /* ipconfigUSE_ARP_TIMER_WHEEL */
+
+/* When ipconfigUSE_DESTINATION_CACHE is non-zero, a UDP socket remembers the
+ * MAC-address of the last IP-address that it sent to, and FreeRTOS_sendto()
+ * fills it in, so that the IP-task does not need to look it up in the ARP
+ * cache.  A TCP socket already stores the MAC-address of its peer, it will now
+ * look it up again after a change.  The stored MAC-addresses become invalid
+ * whenever the ARP cache or the address configuration changes. */
+#ifndef ipconfigUSE_DESTINATION_CACHE
+    #define ipconfigUSE_DESTINATION_CACHE    0
+#endif
+
+/* When ipconfigDNS_USE_RESOLVER is non-zero, DNS look-ups are handled by a
+ * resolver that runs in the IP-task.  It uses a single DNS socket, and it can have
+ * up to ipconfigDNS_RESOLVER_QUERIES queries outstanding, which are matched with
+ * their replies by the DNS identifier.  A query that is not answered within
+ * ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS is sent again, to the next one of the
+ * ipconfigDNS_RESOLVER_SERVERS DNS servers, up to ipconfigDNS_REQUEST_ATTEMPTS
+ * times.  FreeRTOS_gethostbyname() waits for the resolver to finish, while
+ * FreeRTOS_gethostbyname_a() returns immediately.  This option requires
+ * ipconfigDNS_USE_CALLBACKS. */
+#ifndef ipconfigDNS_USE_RESOLVER
+    #define ipconfigDNS_USE_RESOLVER    0
+#endif
+
+#ifndef ipconfigDNS_RESOLVER_QUERIES
+    #define ipconfigDNS_RESOLVER_QUERIES    8
+#endif
+
+#ifndef ipconfigDNS_RESOLVER_SERVERS
+    #define ipconfigDNS_RESOLVER_SERVERS    2
+#endif
+
+#if ( ipconfigDNS_USE_RESOLVER != 0 )
+    #if ( ipconfigDNS_USE_CALLBACKS == 0 )
+        #error ipconfigDNS_USE_RESOLVER requires ipconfigDNS_USE_CALLBACKS
+    #endif
+
+    #if ( ipconfigDNS_RESOLVER_QUERIES < 1 ) || ( ipconfigDNS_RESOLVER_SERVERS < 1 )
+        #error ipconfigDNS_RESOLVER_QUERIES and ipconfigDNS_RESOLVER_SERVERS must be at least 1
+    #endif
+#endif /* ipconfigDNS_USE_RESOLVER */
+
+/* When ipconfigUSE_DNS_CACHE_HASH is non-zero, the entries of the DNS cache are
+ * found through a case-insensitive hash of the host name, and the names are
+ * stored together in an arena of ipconfigDNS_CACHE_NAME_ARENA_SIZE bytes, instead
+ * of in a buffer of ipconfigDNS_CACHE_NAME_LENGTH bytes per entry.  When the
+ * cache is full, the least recently used entry is replaced.  A reply saying that
+ * a name has no address is cached as well (RFC 2308), for the time given in its
+ * SOA record, but for at most ipconfigDNS_CACHE_NEGATIVE_TTL_MAX seconds.
+ * When ipconfigDNS_CACHE_PREFETCH_SECONDS is non-zero, an entry that is used
+ * again within that many seconds before it expires, is refreshed by the
+ * resolver in the background.  This option requires ipconfigUSE_DNS_CACHE, and
+ * the prefetch requires ipconfigDNS_USE_RESOLVER. */
+#ifndef ipconfigUSE_DNS_CACHE_HASH
+    #define ipconfigUSE_DNS_CACHE_HASH    0
+#endif
+
+#ifndef ipconfigDNS_CACHE_HASH_BUCKETS
+    #define ipconfigDNS_CACHE_HASH_BUCKETS    32U
+#endif
+
+#ifndef ipconfigDNS_CACHE_NAME_ARENA_SIZE
+    #define ipconfigDNS_CACHE_NAME_ARENA_SIZE                                       \
+    ( ( ( ipconfigDNS_CACHE_ENTRIES * 32U ) > ipconfigDNS_CACHE_NAME_LENGTH ) ? \
+      ( ipconfigDNS_CACHE_ENTRIES * 32U ) : ipconfigDNS_CACHE_NAME_LENGTH )
+#endif
+
+#ifndef ipconfigDNS_CACHE_NEGATIVE_TTL_MAX
+    #define ipconfigDNS_CACHE_NEGATIVE_TTL_MAX    300U
+#endif
+
+#ifndef ipconfigDNS_CACHE_PREFETCH_SECONDS
+    #define ipconfigDNS_CACHE_PREFETCH_SECONDS    0U
+#endif
+
+#if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+    #if ( ipconfigUSE_DNS_CACHE == 0 )
+        #error ipconfigUSE_DNS_CACHE_HASH requires ipconfigUSE_DNS_CACHE
+    #endif
+
+    #if ( ( ipconfigDNS_CACHE_HASH_BUCKETS & ( ipconfigDNS_CACHE_HASH_BUCKETS - 1U ) ) != 0U )
+        #error ipconfigDNS_CACHE_HASH_BUCKETS must be a power of two
+    #endif
+
+    #if ( ipconfigDNS_CACHE_ENTRIES > 0xfffe ) || ( ipconfigDNS_CACHE_NAME_ARENA_SIZE > 0xffff )
+        #error ipconfigDNS_CACHE_ENTRIES or ipconfigDNS_CACHE_NAME_ARENA_SIZE is too large for ipconfigUSE_DNS_CACHE_HASH
+    #endif
+
+    #if ( ipconfigDNS_CACHE_NAME_ARENA_SIZE < ipconfigDNS_CACHE_NAME_LENGTH )
+        #error ipconfigDNS_CACHE_NAME_ARENA_SIZE must be able to hold a name of ipconfigDNS_CACHE_NAME_LENGTH bytes
+    #endif
+
+    #if ( ipconfigDNS_CACHE_PREFETCH_SECONDS != 0 ) && ( ipconfigDNS_USE_RESOLVER == 0 )
+        #error ipconfigDNS_CACHE_PREFETCH_SECONDS requires ipconfigDNS_USE_RESOLVER
+    #endif
+#endif /* ipconfigUSE_DNS_CACHE_HASH */
+
+/* When ipconfigUSE_TCP_CONNECT_ANY is non-zero, FreeRTOS_connect_any() can
+ * be used to connect to one of several addresses of the same host.  The
+ * connections are started one after the other, ipconfigTCP_CONNECT_ANY_DELAY_MS
+ * msec apart, and the first one that gets connected is returned.  At most
+ * ipconfigTCP_CONNECT_ANY_MAX addresses are tried.  The function uses a socket
+ * set, so it requires ipconfigSUPPORT_SELECT_FUNCTION. */
+#ifndef ipconfigUSE_TCP_CONNECT_ANY
+    #define ipconfigUSE_TCP_CONNECT_ANY    0
+#endif
+
+#ifndef ipconfigTCP_CONNECT_ANY_MAX
+    #define ipconfigTCP_CONNECT_ANY_MAX    4
+#endif
+
+#ifndef ipconfigTCP_CONNECT_ANY_DELAY_MS
+    #define ipconfigTCP_CONNECT_ANY_DELAY_MS    250U
+#endif
+
+#if ( ipconfigUSE_TCP_CONNECT_ANY != 0 )
+    #if ( ipconfigUSE_TCP == 0 ) || ( ipconfigSUPPORT_SELECT_FUNCTION == 0 )
+        #error ipconfigUSE_TCP_CONNECT_ANY requires ipconfigUSE_TCP and ipconfigSUPPORT_SELECT_FUNCTION
+    #endif
+
+    #if ( ipconfigTCP_CONNECT_ANY_MAX < 1 )
+        #error ipconfigTCP_CONNECT_ANY_MAX must be at least 1
+    #endif
+#endif /* ipconfigUSE_TCP_CONNECT_ANY */
+
+/* When ipconfigUSE_MDNS is non-zero, the device answers multicast DNS queries
+ * (RFC 6762) for its host name with the suffix ".local", and for the DNS-SD
+ * services (RFC 6763) registered with FreeRTOS_mDNSAddService().  The host name
+ * is returned by pcApplicationHostnameHook(), xApplicationDNSQueryHook() may
+ * accept other names.  Answers that the querier already knows are not sent.
+ * Names ending in ".local" are looked up with a one-shot mDNS query, and the
+ * addresses found in mDNS responses are stored in the DNS cache.  At most
+ * ipconfigMDNS_SERVICES services can be registered.  The network interface
+ * must accept the multicast MAC-address 01:00:5e:00:00:fb. */
+#ifndef ipconfigUSE_MDNS
+    #define ipconfigUSE_MDNS    0
+#endif
+
+#ifndef ipconfigMDNS_SERVICES
+    #define ipconfigMDNS_SERVICES    2
+#endif
+
+#if ( ipconfigUSE_MDNS != 0 )
+    #if ( ipconfigUSE_DNS == 0 )
+        #error ipconfigUSE_MDNS requires ipconfigUSE_DNS
+    #endif
+
+    #if ( ipconfigMDNS_SERVICES < 0 ) || ( ipconfigMDNS_SERVICES > 7 )
+        #error ipconfigMDNS_SERVICES must be between 0 and 7
+    #endif
+#endif /* ipconfigUSE_MDNS */
+
+/* When ipconfigDHCP_STORE_LEASE is non-zero, the DHCP client remembers its last
+ * lease, and the application can save and restore it with the hooks
+ * vApplicationDHCPSaveLeaseHook() and xApplicationDHCPRestoreLeaseHook().
+ * After a reset or a link-down event, the address of that lease is requested
+ * directly (the INIT-REBOOT state of RFC 2131), which takes one round trip
+ * instead of two.  When the server does not answer, or refuses the address,
+ * the client starts again with a discover message.
+ * When ipconfigDHCP_USE_LEASE_AT_ONCE is also non-zero, the address of the
+ * remembered lease is used immediately, while it is being revalidated.  Without
+ * an answer, it is used until it is time to renew the lease. */
+#ifndef ipconfigDHCP_STORE_LEASE
+    #define ipconfigDHCP_STORE_LEASE    0
+#endif
+
+#ifndef ipconfigDHCP_USE_LEASE_AT_ONCE
+    #define ipconfigDHCP_USE_LEASE_AT_ONCE    0
+#endif
+
+#if ( ipconfigDHCP_USE_LEASE_AT_ONCE != 0 ) && ( ipconfigDHCP_STORE_LEASE == 0 )
+    #error ipconfigDHCP_USE_LEASE_AT_ONCE requires ipconfigDHCP_STORE_LEASE
+#endif
+
+/* When ipconfigDHCP_USE_RAPID_COMMIT is non-zero, the DHCP discover message
+ * carries the Rapid Commit option of RFC 4039.  A server that supports it answers
+ * with an ACK straight away, and a lease is obtained in one round trip. */
+#ifndef ipconfigDHCP_USE_RAPID_COMMIT
+    #define ipconfigDHCP_USE_RAPID_COMMIT    0
+#endif
+
+/* When ipconfigDHCP_CHECK_ADDRESS_CONFLICT is non-zero, a newly leased address
+ * is checked for conflicts as described in RFC 5227.  The check does not delay
+ * the network-up event: the address is used at once, while a few ARP
+ * announcements are sent.  When another device claims the address, it is
+ * declined and the DHCP process starts again. */
+#ifndef ipconfigDHCP_CHECK_ADDRESS_CONFLICT
+    #define ipconfigDHCP_CHECK_ADDRESS_CONFLICT    0
+#endif
+
+#if ( ipconfigDHCP_CHECK_ADDRESS_CONFLICT != 0 ) && ( ipconfigARP_USE_CLASH_DETECTION == 0 )
+    #error ipconfigDHCP_CHECK_ADDRESS_CONFLICT requires ipconfigARP_USE_CLASH_DETECTION
+#endif
+
+/* When ipconfigSUPPORT_EPOLL is 1, the functions FreeRTOS_epoll_create(),
+ * FreeRTOS_epoll_ctl() and FreeRTOS_epoll_wait() are available.  Sockets are
+ * registered once, and the IP-task puts them in a ready list when their state
+ * changes.  Waiting costs time in proportion to the number of ready sockets,
+ * where FreeRTOS_select() checks every socket that is bound.  The events are
+ * the ones of FreeRTOS_select(), so ipconfigSUPPORT_SELECT_FUNCTION must be 1
+ * as well.  A socket can not be part of a socket set and an epoll set at the
+ * same time. */
+#ifndef ipconfigSUPPORT_EPOLL
+    #define ipconfigSUPPORT_EPOLL    0
+#endif
+
+#if ( ipconfigSUPPORT_EPOLL == 1 ) && ( ipconfigSUPPORT_SELECT_FUNCTION != 1 )
+    #error ipconfigSUPPORT_EPOLL requires ipconfigSUPPORT_SELECT_FUNCTION
+#endif
+
+/* When ipconfigSTREAM_BUFFER_USE_ATOMICS is 1, the indexes of a stream buffer
+ * are C11 atomic objects.  Each stream has one producer and one consumer, e.g.
+ * the user task filling a TX stream and the IP-task draining it.  An index is
+ * published with release semantics after the data has been copied, and read with
+ * acquire semantics by the other side, so the data is visible before the index
+ * that covers it, also on a multi-core target.  The compiler must support
+ * <stdatomic.h>. */
+#ifndef ipconfigSTREAM_BUFFER_USE_ATOMICS
+    #define ipconfigSTREAM_BUFFER_USE_ATOMICS    0
+#endif
+
+/* When ipconfigSTREAM_BUFFER_MIRROR_SIZE is non-zero, each TCP stream buffer
+ * is allocated with this many extra bytes after its end, which hold a copy of the
+ * first bytes of the stream.  A region that wraps around the end of the stream
+ * can then be accessed as a contiguous block, as long as it does not reach
+ * further than the mirror.  FreeRTOS_get_tx_head() and zero-copy FreeRTOS_recv()
+ * give access to larger blocks, and a TCP segment is copied from the stream with
+ * a single memcpy().  The price is the memory of the mirror, and copying the
+ * bytes that are written to the start of the stream twice.  A value of
+ * ipconfigTCP_MSS makes every segment contiguous. */
+#ifndef ipconfigSTREAM_BUFFER_MIRROR_SIZE
+    #define ipconfigSTREAM_BUFFER_MIRROR_SIZE    0
+#endif
+
+/* When ipconfigIP_RX_WORKER_COUNT is non-zero, that number of RX worker tasks
+ * check received IP-packets before they are passed to the IP-task.  The workers
+ * verify the IP and protocol checksums, or when the driver has done that, the
+ * length fields.  These checks do not depend on the state of the stack, and on
+ * a multi-core target they are done in parallel with the IP-task.  A packet is
+ * steered to a worker by a hash of its source address and ports, so the packets
+ * of a connection stay in order.  A chain of packets passed with
+ * ipconfigUSE_LINKED_RX_MESSAGES is split per worker.  The state of the stack,
+ * including all socket, ARP, DHCP and DNS processing, stays in the IP-task.  The
+ * workers are created with the stack size and priority of the IP-task. */
+#ifndef ipconfigIP_RX_WORKER_COUNT
+    #define ipconfigIP_RX_WORKER_COUNT    0
+#endif
+
+/* When ipconfigIP_EVENT_CLASSES is non-zero, the IP-task receives the events
+ * sent by xSendEventStructToIPTask() through three queues: one for received
+ * packets, one for packets to be transmitted, and one for all other events, such
+ * as eTCPTimerEvent and eSocketCloseEvent.  The other events are always handled
+ * first.  Received packets and transmissions are handled in turns of up to
+ * ipconfigIP_RX_EVENT_BUDGET and ipconfigIP_TX_EVENT_BUDGET events, so a burst of
+ * received packets can not hold up the rest.  Each of the queues has a length of
+ * ipconfigEVENT_QUEUE_LENGTH.  A counting semaphore counts their events, and the
+ * IP-task waits for it and for xNetworkEventQueue through a queue set, so
+ * configUSE_QUEUE_SETS and configUSE_COUNTING_SEMAPHORES must be 1.
+ * FreeRTOS_GetIPEventStats() returns histograms of the queue depth and the
+ * latency of each class of events. */
+#ifndef ipconfigIP_EVENT_CLASSES
+    #define ipconfigIP_EVENT_CLASSES    0
+#endif
+
+#ifndef ipconfigIP_RX_EVENT_BUDGET
+    #define ipconfigIP_RX_EVENT_BUDGET    8
+#endif
+
+#ifndef ipconfigIP_TX_EVENT_BUDGET
+    #define ipconfigIP_TX_EVENT_BUDGET    4
+#endif
+
+#if ( ipconfigIP_EVENT_CLASSES != 0 ) && ( configUSE_QUEUE_SETS != 1 )
+    #error ipconfigIP_EVENT_CLASSES requires configUSE_QUEUE_SETS
+#endif
+
+#if ( ipconfigIP_EVENT_CLASSES != 0 ) && ( configUSE_COUNTING_SEMAPHORES != 1 )
+    #error ipconfigIP_EVENT_CLASSES requires configUSE_COUNTING_SEMAPHORES
+#endif
+
+#if ( ipconfigIP_RX_EVENT_BUDGET < 1 ) || ( ipconfigIP_TX_EVENT_BUDGET < 1 )
+    #error ipconfigIP_RX_EVENT_BUDGET and ipconfigIP_TX_EVENT_BUDGET must be at least 1
+#endif
+
+/* When ipconfigSOCKET_WAKE_COALESCING is non-zero, the owner of a TCP socket is
+ * woken up less often while data is streaming:
+ * - With FREERTOS_SO_RCVLOWAT, a reader is only woken up when at least the given
+ *   number of bytes is waiting in the reception buffer, or when that buffer is
+ *   running out of space.
+ * - With FREERTOS_SO_SNDLOWAT, a writer is only woken up when at least the given
+ *   number of bytes is free in the transmission buffer.
+ * - The IP-task already postpones the wake-ups of TCP sockets until it is about to
+ *   sleep.  While it stays busy, a wake-up will not be postponed longer than
+ *   ipconfigSOCKET_WAKE_MAX_DEFER_MS.
+ * FreeRTOS_GetSocketWakeStats() returns the wake-up counters of a socket. */
+#ifndef ipconfigSOCKET_WAKE_COALESCING
+    #define ipconfigSOCKET_WAKE_COALESCING    0
+#endif
+
+#ifndef ipconfigSOCKET_WAKE_MAX_DEFER_MS
+    #define ipconfigSOCKET_WAKE_MAX_DEFER_MS    10U
+#endif
+
+#if ( ipconfigSOCKET_WAKE_COALESCING != 0 ) && ( ipconfigUSE_TCP == 0 )
+    #error ipconfigSOCKET_WAKE_COALESCING requires ipconfigUSE_TCP
+#endif
+
+/* When ipconfigSOCKET_USES_NOTIFY is non-zero, sockets do not get an event group.
+ * A task that blocks on a socket, for instance in FreeRTOS_recv(), registers
+ * itself in the socket, and it will be woken up with a notification at index
+ * ipconfigSOCKET_NOTIFY_INDEX of its notification array.  Any number of tasks
+ * may block on the same socket.  The index must be reserved for this purpose,
+ * and configTASK_NOTIFICATION_ARRAY_ENTRIES must be larger than it. */
+#ifndef ipconfigSOCKET_USES_NOTIFY
+    #define ipconfigSOCKET_USES_NOTIFY    0
+#endif
+
+#ifndef ipconfigSOCKET_NOTIFY_INDEX
+    #define ipconfigSOCKET_NOTIFY_INDEX    1
+#endif
+
+#if ( ipconfigSOCKET_USES_NOTIFY != 0 ) && ( ipconfigSOCKET_NOTIFY_INDEX == 0 )
+    #error ipconfigSOCKET_NOTIFY_INDEX must not be 0, the default index is used by the application and by ipconfigSELECT_USES_NOTIFY
+#endif
+
+#if ( ipconfigSOCKET_USES_NOTIFY != 0 ) && ( configTASK_NOTIFICATION_ARRAY_ENTRIES <= ipconfigSOCKET_NOTIFY_INDEX )
+    #error ipconfigSOCKET_USES_NOTIFY requires configTASK_NOTIFICATION_ARRAY_ENTRIES to be larger than ipconfigSOCKET_NOTIFY_INDEX
+#endif
+
+/* When ipconfigSOCKET_POOL is non-zero, sockets and the streams of TCP sockets
+ * are taken from statically allocated pools of fixed-size blocks:
+ * - ipconfigSOCKET_POOL_UDP_COUNT UDP sockets and ipconfigSOCKET_POOL_TCP_COUNT
+ *   TCP sockets, including the child sockets created by a listening socket.
+ * - Streams in two size classes: ipconfigSTREAM_POOL_SMALL_COUNT streams of up
+ *   to ipconfigSTREAM_POOL_SMALL_LENGTH bytes, and ipconfigSTREAM_POOL_LARGE_COUNT
+ *   streams of up to ipconfigSTREAM_POOL_LARGE_LENGTH bytes.  A stream is taken
+ *   from the smallest class that fits and has a free block.
+ * When a pool is exhausted, or when a stream is larger than both classes, the
+ * memory is allocated from the heap as before.  The defaults hold the streams of
+ * the TCP sockets in the pool, when they use the default buffer sizes. */
+#ifndef ipconfigSOCKET_POOL
+    #define ipconfigSOCKET_POOL    0
+#endif
+
+#ifndef ipconfigSOCKET_POOL_UDP_COUNT
+    #define ipconfigSOCKET_POOL_UDP_COUNT    4U
+#endif
+
+#ifndef ipconfigSOCKET_POOL_TCP_COUNT
+    #define ipconfigSOCKET_POOL_TCP_COUNT    4U
+#endif
+
+#ifndef ipconfigSTREAM_POOL_SMALL_LENGTH
+    #define ipconfigSTREAM_POOL_SMALL_LENGTH    ( 4U * ipconfigTCP_MSS )
+#endif
+
+#ifndef ipconfigSTREAM_POOL_SMALL_COUNT
+    #define ipconfigSTREAM_POOL_SMALL_COUNT    ( 2U * ipconfigSOCKET_POOL_TCP_COUNT )
+#endif
+
+#ifndef ipconfigSTREAM_POOL_LARGE_LENGTH
+    #define ipconfigSTREAM_POOL_LARGE_LENGTH    ( 16U * ipconfigTCP_MSS )
+#endif
+
+#ifndef ipconfigSTREAM_POOL_LARGE_COUNT
+    #define ipconfigSTREAM_POOL_LARGE_COUNT    0U
+#endif
+
+/* When ipconfigSUPPORT_STATIC_SOCKETS is non-zero, FreeRTOS_socket_static() creates
+ * a socket in memory that is provided by the caller, and which is not freed when
+ * the socket is closed.  The storage has the opaque type StaticSocket_t of
+ * ipconfigSTATIC_SOCKET_SIZE bytes.  The size of a TCP socket depends on the
+ * configuration, FreeRTOS_socket_static() asserts that it fits.  Closing a static
+ * socket is done by the IP-task.  FreeRTOS_closesocket() blocks until then, and
+ * it is woken with a notification at index ipconfigSOCKET_NOTIFY_INDEX. */
+#ifndef ipconfigSUPPORT_STATIC_SOCKETS
+    #define ipconfigSUPPORT_STATIC_SOCKETS    0
+#endif
+
+#ifndef ipconfigSTATIC_SOCKET_SIZE
+    #define ipconfigSTATIC_SOCKET_SIZE    ( 192U * sizeof( void * ) )
+#endif
+
+#if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 ) && ( ( ipconfigSOCKET_NOTIFY_INDEX == 0 ) || ( configTASK_NOTIFICATION_ARRAY_ENTRIES <= ipconfigSOCKET_NOTIFY_INDEX ) )
+    #error ipconfigSUPPORT_STATIC_SOCKETS requires a non-zero ipconfigSOCKET_NOTIFY_INDEX below configTASK_NOTIFICATION_ARRAY_ENTRIES
+#endif
+
+/* When ipconfigTCP_SYN_QUEUE is non-zero, a SYN that arrives at a listening
+ * socket does not create a child socket.  The request is stored in a table of
+ * ipconfigTCP_SYN_QUEUE_LENGTH half-open connections, which is shared by all
+ * listening sockets, and answered with a SYN+ACK.  The child socket is created
+ * when the final ACK of the handshake arrives.  A repeated SYN gets the same
+ * SYN+ACK, but the SYN+ACK itself is not repeated by the stack.  An entry expires
+ * after ipconfigTCP_SYN_QUEUE_TIMEOUT_MS.  When the table is full, the oldest entry
+ * is replaced.  Sockets with the option FREERTOS_SO_REUSE_LISTEN_SOCKET do not use
+ * the table. */
+#ifndef ipconfigTCP_SYN_QUEUE
+    #define ipconfigTCP_SYN_QUEUE    0
+#endif
+
+#ifndef ipconfigTCP_SYN_QUEUE_LENGTH
+    #define ipconfigTCP_SYN_QUEUE_LENGTH    16U
+#endif
+
+#ifndef ipconfigTCP_SYN_QUEUE_TIMEOUT_MS
+    #define ipconfigTCP_SYN_QUEUE_TIMEOUT_MS    20000U
+#endif
+
+#if ( ipconfigTCP_SYN_QUEUE != 0 ) && ( ipconfigUSE_TCP == 0 )
+    #error ipconfigTCP_SYN_QUEUE requires ipconfigUSE_TCP
+#endif
+
+/* When ipconfigTCP_TIME_WAIT_TABLE is non-zero, a connection that has been
+ * closed by this side is remembered in a table of ipconfigTCP_TIME_WAIT_LENGTH
+ * compact entries: the port numbers, the IP-address of the peer, the last
+ * sequence numbers and the window of the peer.  The socket does not take part in
+ * the closure anymore: a child socket that was never accepted is deleted right
+ * away, and a socket that is owned by the application returns its TCP window
+ * segments to the shared pool and frees its txStream, and its rxStream when
+ * there is nothing left to read.  A FIN that is repeated by the peer is
+ * acknowledged from the table.  An
+ * entry expires after ipconfigTCP_TIME_WAIT_MS.  A SYN from the same peer and port
+ * is accepted when its sequence number is higher than the last one of the old
+ * connection, and a new connection from the same port will use an initial
+ * sequence number beyond the last window of the old one. */
+#ifndef ipconfigTCP_TIME_WAIT_TABLE
+    #define ipconfigTCP_TIME_WAIT_TABLE    0
+#endif
+
+#ifndef ipconfigTCP_TIME_WAIT_LENGTH
+    #define ipconfigTCP_TIME_WAIT_LENGTH    16U
+#endif
+
+#ifndef ipconfigTCP_TIME_WAIT_MS
+    #define ipconfigTCP_TIME_WAIT_MS    60000U
+#endif
+
+#if ( ipconfigTCP_TIME_WAIT_TABLE != 0 ) && ( ipconfigUSE_TCP == 0 )
+    #error ipconfigTCP_TIME_WAIT_TABLE requires ipconfigUSE_TCP
+#endif
+
 #endif /* FREERTOS_DEFAULT_IP_CONFIG_H */
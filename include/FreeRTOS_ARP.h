@@ -48,6 +48,22 @@
         MACAddress_t xMACAddress; /**< The MAC address of an ARP cache entry. */
         uint8_t ucAge;            /**< A value that is periodically decremented but can also be refreshed by active communication.  The ARP cache entry is removed if the value reaches zero. */
         uint8_t ucValid;          /**< pdTRUE: xMACAddress is valid, pdFALSE: waiting for ARP reply */
+        #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+            uint16_t usNextIP;                                                  /**< 1 + the index of the next row in the same IP-address hash bucket, or 0. */
+            uint16_t usNextMAC;                                                 /**< 1 + the index of the next row in the same MAC-address hash bucket, or 0. */
+            uint16_t usNewer;                                                   /**< 1 + the index of the row that was refreshed after this one, or 0. */
+            uint16_t usOlder;                                                   /**< 1 + the index of the row that was refreshed before this one, or 0. */
+            uint8_t ucPendingCount;                                             /**< The number of packets waiting for the ARP reply. */
+            uint8_t ucPendingOutgoing;                                          /**< A bit for every waiting packet that is to be sent, the others were received. */
+            TickType_t xPendingTime;                                            /**< The time at which the first packet started waiting. */
+            struct xNETWORK_BUFFER * pxPending[ ipconfigARP_PENDING_QUEUE_LENGTH ]; /**< The packets waiting for the ARP reply. */
+            #if ( ipconfigUSE_ARP_TIMER_WHEEL != 0 )
+                uint16_t usWheelNext;                                           /**< 1 + the index of the next row in the same slot of the timer wheel, or 0. */
+                uint16_t usWheelPrev;                                           /**< 1 + the index of the previous row in the same slot of the timer wheel, or 0. */
+                uint16_t usWheelDue;                                            /**< The ARP timer period in which this row needs attention. */
+                uint8_t ucInWheel;                                              /**< pdTRUE when the row is stored in the timer wheel. */
+            #endif /* ipconfigUSE_ARP_TIMER_WHEEL */
+        #endif /* ipconfigUSE_ARP_HASH_TABLE */
     } ARPCacheRow_t;
 
     typedef enum
@@ -88,6 +104,39 @@
 
     BaseType_t xCheckRequiresARPResolution( NetworkBufferDescriptor_t * pxNetworkBuffer );
 
+    #if ( ipconfigUSE_ARP_HASH_TABLE != 0 )
+
+/*
+ * Let a packet wait for the ARP reply from ulIPAddress, for which an ARP request
+ * is outstanding.  The packet will be processed again as soon as the reply
+ * arrives.  Returns pdFALSE if the packet could not be queued.
+ */
+        BaseType_t xARPQueuePendingPacket( uint32_t ulIPAddress,
+                                           NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                           BaseType_t xIsOutgoing );
+
+/*
+ * Release the packets that have been waiting for an ARP reply for xMaxDelay
+ * clock ticks or more.  Returns pdTRUE if packets are still waiting.
+ */
+        BaseType_t xARPCheckPendingPackets( TickType_t xMaxDelay );
+    #endif /* ipconfigUSE_ARP_HASH_TABLE */
+
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+
+/*
+ * Return a number that changes every time that a MAC-address stored by a socket
+ * might have become invalid, because of a change in the ARP cache or in the
+ * address configuration.  The value is never zero.
+ */
+        uint32_t ulARPGetGeneration( void );
+
+/*
+ * Invalidate all MAC-addresses that are stored by sockets.
+ */
+        void vARPInvalidateDestinations( void );
+    #endif /* ipconfigUSE_DESTINATION_CACHE */
+
 /*
  * Look for ulIPAddress in the ARP cache.  If the IP address exists, copy the
  * associated MAC address into pxMACAddress, refresh the ARP cache entry's
@@ -113,6 +162,12 @@
  */
     void vARPAgeCache( void );
 
+/*
+ * Clear the ARP cache, called from the IP-task.  FreeRTOS_ClearARP() may be
+ * called by any task.
+ */
+    void vARPClearCache( void );
+
 /*
  * Send out an ARP request for the IP address contained in pxNetworkBuffer, and
  * add an entry into the ARP table that indicates that an ARP reply is
@@ -62,6 +62,34 @@
         #define dhcpINITIAL_DHCP_TX_PERIOD    ( pdMS_TO_TICKS( 5000U ) )
     #endif
 
+    #ifndef dhcpINIT_REBOOT_MAX_TX_PERIOD
+
+/** @brief An INIT-REBOOT request is sent twice.  When it is still not answered,
+ * the DHCP process starts again with a discover message. */
+        #define dhcpINIT_REBOOT_MAX_TX_PERIOD    ( 2U * dhcpINITIAL_DHCP_TX_PERIOD )
+    #endif
+
+    #ifndef dhcpCONFLICT_CHECK_PERIOD
+
+/** @brief The time between the ARP announcements that check whether a newly leased
+ * address is in use by another device.  See PROBE_MAX in RFC 5227. */
+        #define dhcpCONFLICT_CHECK_PERIOD    ( pdMS_TO_TICKS( 1000U ) )
+    #endif
+
+    #ifndef dhcpCONFLICT_CHECK_COUNT
+
+/** @brief The number of ARP announcements sent for a newly leased address.  See
+ * PROBE_NUM in RFC 5227. */
+        #define dhcpCONFLICT_CHECK_COUNT    ( 3U )
+    #endif
+
+    #ifndef dhcpDECLINE_RESTART_PERIOD
+
+/** @brief After declining an address that is in use, wait this long before starting
+ * again with a discover.  See section 3.1.5 of RFC 2131. */
+        #define dhcpDECLINE_RESTART_PERIOD    ( pdMS_TO_TICKS( 10000U ) )
+    #endif
+
 /* Codes of interest found in the DHCP options field. */
     #define dhcpIPv4_ZERO_PAD_OPTION_CODE              ( 0U )  /**< Used to pad other options to make them aligned. See RFC 2132. */
     #define dhcpIPv4_SUBNET_MASK_OPTION_CODE           ( 1U )  /**< Subnet mask. See RFC 2132. */
@@ -74,11 +102,13 @@
     #define dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE     ( 54U ) /**< Server Identifier. See RFC 2132. */
     #define dhcpIPv4_PARAMETER_REQUEST_OPTION_CODE     ( 55U ) /**< Parameter Request list. See RFC 2132. */
     #define dhcpIPv4_CLIENT_IDENTIFIER_OPTION_CODE     ( 61U ) /**<  Client Identifier. See RFC 2132. */
+    #define dhcpIPv4_RAPID_COMMIT_OPTION_CODE          ( 80U ) /**< Rapid commit. See RFC 4039. */
 
-/* The four DHCP message types of interest. */
+/* The DHCP message types of interest. */
     #define dhcpMESSAGE_TYPE_DISCOVER                  ( 1 ) /**< DHCP discover message. */
     #define dhcpMESSAGE_TYPE_OFFER                     ( 2 ) /**< DHCP offer message. */
     #define dhcpMESSAGE_TYPE_REQUEST                   ( 3 ) /**< DHCP request message. */
+    #define dhcpMESSAGE_TYPE_DECLINE                   ( 4 ) /**< DHCP decline message. */
     #define dhcpMESSAGE_TYPE_ACK                       ( 5 ) /**< DHCP acknowledgement. */
     #define dhcpMESSAGE_TYPE_NACK                      ( 6 ) /**< DHCP NACK. (Negative acknowledgement) */
 
@@ -184,6 +214,9 @@
         #if ( ipconfigDHCP_FALL_BACK_AUTO_IP != 0 )
             eGetLinkLayerAddress,  /**< When DHCP didn't respond, try to obtain a LinkLayer address 168.254.x.x. */
         #endif
+        #if ( ipconfigDHCP_CHECK_ADDRESS_CONFLICT != 0 )
+            eCheckLeasedAddress,   /**< The leased address is in use, check that no other device uses it. */
+        #endif
         eLeasedAddress,            /**< Resend the request at the appropriate time to renew the lease. */
         eNotUsingLeasedAddress     /**< DHCP failed, and a default IP address is being used. */
     } eDHCPState_t;
@@ -200,10 +233,36 @@
         TickType_t xDHCPTxPeriod;      /**< The maximum time that the client will wait for a reply. */
         BaseType_t xUseBroadcast;      /**< Try both without and with the broadcast flag */
         eDHCPState_t eDHCPState;       /**< Maintains the DHCP state machine state. */
+        #if ( ipconfigDHCP_STORE_LEASE != 0 )
+            uint32_t ulRebootIPAddress; /**< The address of the last lease, which will be requested with INIT-REBOOT. */
+            BaseType_t xInitReboot;     /**< pdTRUE while the address of the last lease is being requested. */
+            BaseType_t xLeaseRestored;  /**< pdTRUE once xApplicationDHCPRestoreLeaseHook() has been called. */
+        #endif
+        #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+            BaseType_t xRapidCommit;    /**< pdTRUE when the discover was answered with an ACK. */
+        #endif
+        #if ( ipconfigDHCP_CHECK_ADDRESS_CONFLICT != 0 )
+            UBaseType_t uxConflictChecks; /**< The number of ARP announcements sent for a new address. */
+        #endif
     };
 
     typedef struct xDHCP_DATA DHCPData_t;
 
+    #if ( ipconfigDHCP_STORE_LEASE != 0 )
+
+/** @brief A DHCP lease, as saved and restored by the application.  The
+ * addresses are stored in network byte order. */
+        typedef struct xDHCP_LEASE
+        {
+            uint32_t ulIPAddress;         /**< The leased IP-address, zero when there is no lease. */
+            uint32_t ulNetMask;           /**< The network mask. */
+            uint32_t ulGatewayAddress;    /**< The address of the gateway. */
+            uint32_t ulDNSServerAddress;  /**< The address of the DNS server. */
+            uint32_t ulDHCPServerAddress; /**< The DHCP server that granted the lease. */
+            uint32_t ulLeaseSeconds;      /**< The duration of the lease in seconds. */
+        } DHCPLease_t;
+    #endif /* ipconfigDHCP_STORE_LEASE */
+
 /* Returns the current state of a DHCP process. */
     eDHCPState_t eGetDHCPState( void );
 
@@ -240,6 +299,21 @@
                                                     uint32_t ulIPAddress );
     #endif /* ( ipconfigUSE_DHCP_HOOK != 0 ) */
 
+    #if ( ipconfigDHCP_STORE_LEASE != 0 )
+
+/* Called from the IP-task each time a lease has been acknowledged, so the
+ * application can keep it in non-volatile memory.  When the server refuses a
+ * lease, the hook is called with a lease of which ulIPAddress is zero. */
+        void vApplicationDHCPSaveLeaseHook( const DHCPLease_t * pxLease );
+
+/* Called from the IP-task once, before the first DHCP transaction.  Return
+ * pdTRUE after filling in the lease that was saved, with ulLeaseSeconds set to
+ * the part of the lease that has not expired yet.  The address of the lease
+ * will then be requested directly (INIT-REBOOT), instead of starting with a
+ * discover message. */
+        BaseType_t xApplicationDHCPRestoreLeaseHook( DHCPLease_t * pxLease );
+    #endif /* ( ipconfigDHCP_STORE_LEASE != 0 ) */
+
     #ifdef __cplusplus
         } /* extern "C" */
     #endif
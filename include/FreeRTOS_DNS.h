@@ -35,6 +35,8 @@
     #include "FreeRTOSIPConfigDefaults.h"
     #include "IPTraceMacroDefaults.h"
 
+    #include "FreeRTOS_Sockets.h"
+
 
     #if ( ipconfigBYTE_ORDER == pdFREERTOS_LITTLE_ENDIAN )
         #define dnsDNS_PORT             0x3500U  /**< Little endian: Port used for DNS. */
@@ -42,12 +44,14 @@
         #define dnsOUTGOING_FLAGS       0x0001U  /**< Little endian representation of standard query. */
         #define dnsRX_FLAGS_MASK        0x0f80U  /**< Little endian:  The bits of interest in the flags field of incoming DNS messages. */
         #define dnsEXPECTED_RX_FLAGS    0x0080U  /**< Little Endian: Should be a response, without any errors. */
+        #define dnsNXDOMAIN_RX_FLAGS    0x0380U  /**< Little Endian: A response saying that the name does not exist. */
     #else
         #define dnsDNS_PORT             0x0035U  /**< Big endian: Port used for DNS. */
         #define dnsONE_QUESTION         0x0001U  /**< Big endian representation of a DNS question.*/
         #define dnsOUTGOING_FLAGS       0x0100U  /**< Big endian representation of standard query. */
         #define dnsRX_FLAGS_MASK        0x800fU  /**< Big endian: The bits of interest in the flags field of incoming DNS messages. */
         #define dnsEXPECTED_RX_FLAGS    0x8000U  /**< Big endian: Should be a response, without any errors. */
+        #define dnsNXDOMAIN_RX_FLAGS    0x8003U  /**< Big endian: A response saying that the name does not exist. */
 
     #endif /* ipconfigBYTE_ORDER */
 
@@ -70,8 +74,25 @@
 
 /* Host types. */
     #define dnsTYPE_A_HOST            0x01U /**< DNS type A host. */
+    #define dnsTYPE_SOA               0x06U /**< DNS type start of authority. */
     #define dnsCLASS_IN               0x01U /**< DNS class IN (Internet). */
 
+    #if ( ipconfigUSE_MDNS != 0 )
+        #define dnsTYPE_PTR                0x0CU   /**< DNS type domain name pointer. */
+        #define dnsTYPE_TXT                0x10U   /**< DNS type text strings. */
+        #define dnsTYPE_SRV                0x21U   /**< DNS type service location. */
+        #define dnsTYPE_ANY                0xFFU   /**< DNS question type: all records. */
+        #define dnsCLASS_ANY               0xFFU   /**< DNS question class: all classes. */
+        #define dnsMDNS_CLASS_MASK         0x7FFFU /**< mDNS: the class without the top bit. */
+        #define dnsMDNS_CLASS_TOP_BIT      0x8000U /**< mDNS: unicast-response in a question, cache-flush in an answer. */
+        #define dnsMDNS_FLAGS_IS_RESPONSE  0x8400U /**< mDNS: an authoritative response. */
+        #define dnsMDNS_HOST_TTL_VALUE     120UL   /**< mDNS: TTL of the records that contain a host name. */
+        #define dnsMDNS_OTHER_TTL_VALUE    4500UL  /**< mDNS: TTL of the other records. */
+        #define dnsMDNS_LEGACY_TTL_VALUE   10UL    /**< mDNS: maximum TTL in an answer to a one-shot query. */
+        #define dnsMDNS_ANNOUNCEMENTS      2U      /**< mDNS: the number of unsolicited responses sent. */
+        #define dnsMDNS_ANNOUNCE_MS        1000U   /**< mDNS: the time between the unsolicited responses. */
+    #endif /* ipconfigUSE_MDNS */
+
 /* Maximum hostname length as defined in RFC 1035 section 3.1. */
     #define dnsMAX_HOSTNAME_LENGTH    0xFFU
 
@@ -123,6 +144,16 @@
     #endif /* ipconfigBYTE_ORDER == pdFREERTOS_BIG_ENDIAN */
 
     #define ipLLMNR_PORT           5355 /* Standard LLMNR port. */
+
+/* Multicast DNS (mDNS) uses the IP address 224.0.0.251 and the MAC address
+ * 01:00:5E:00:00:FB. */
+    #if ( ipconfigBYTE_ORDER == pdFREERTOS_BIG_ENDIAN )
+        #define ipMDNS_IP_ADDR    0xE00000FBUL
+    #else
+        #define ipMDNS_IP_ADDR    0xFB0000E0UL
+    #endif /* ipconfigBYTE_ORDER == pdFREERTOS_BIG_ENDIAN */
+
+    #define ipMDNS_PORT           5353 /* Standard mDNS port. */
     #define ipDNS_PORT             53   /* Standard DNS port. */
     #define ipDHCP_CLIENT          67
     #define ipDHCP_SERVER          68
@@ -146,13 +177,25 @@
         typedef struct xDNS_CACHE_TABLE_ROW
         {
             uint32_t ulIPAddresses[ ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY ]; /* The IP address(es) of an ARP cache entry. */
-            char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ];                    /* The name of the host */
+            #if ( ipconfigUSE_DNS_CACHE_HASH == 0 )
+                char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ];                /* The name of the host */
+            #endif
             uint32_t ulTTL;                                                  /* Time-to-Live (in seconds) from the DNS server. */
             uint32_t ulTimeWhenAddedInSeconds;
             #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
                 uint8_t ucNumIPAddresses;
                 uint8_t ucCurrentIPAddress;
             #endif
+            #if ( ipconfigUSE_DNS_CACHE_HASH != 0 )
+                uint32_t ulNameHash;   /* The hash of the name in lower case. */
+                uint16_t usNameOffset; /* The position of the name in the name arena. */
+                uint16_t usHashNext;   /* The next entry in the same hash bucket, or in the list of free entries. */
+                uint16_t usLRUPrev;    /* The entry that was used just after this one. */
+                uint16_t usLRUNext;    /* The entry that was used just before this one. */
+                uint16_t usHits;       /* The number of look-ups since the entry was stored. */
+                uint8_t ucNameLength;  /* The length of the name, without a terminating zero. */
+                uint8_t ucFlags;       /* The dnsCACHE_FLAG_ bits. */
+            #endif
         } DNSCacheRow_t;
     #endif /* if ( ipconfigUSE_DNS_CACHE == 1 ) */
 
@@ -171,6 +214,26 @@
     #include "pack_struct_end.h"
     typedef struct xDNSMessage DNSMessage_t;
 
+/** @brief A read position in a DNS message. */
+    typedef struct xDNS_READER
+    {
+        const uint8_t * pucMessage; /**< The first byte of the DNS message, compression pointers are relative to it. */
+        size_t uxLength;            /**< The number of bytes in the message. */
+        size_t uxOffset;            /**< The offset of the next byte to be read. */
+    } DNSReader_t;
+
+/** @brief A question or a resource record found in a DNS message.  The name is
+ * not copied, the record only refers to it. */
+    typedef struct xDNS_RECORD
+    {
+        size_t uxNameOffset;   /**< The offset of the name in the message, the name may be compressed. */
+        size_t uxDataOffset;   /**< The offset of the record data. */
+        uint32_t ulTTL;        /**< Time to live in seconds, zero for a question. */
+        uint16_t usType;       /**< The type of the record. */
+        uint16_t usClass;      /**< The class of the record. */
+        uint16_t usDataLength; /**< The length of the record data, zero for a question. */
+    } DNSRecord_t;
+
     #if ( ipconfigUSE_LLMNR == 1 )
 
         #include "pack_struct_start.h"
@@ -222,14 +285,14 @@
         typedef struct xNBNSAnswer NBNSAnswer_t;
     #endif /* if ( ipconfigUSE_NBNS == 1 ) */
 
-    #if ( ipconfigUSE_LLMNR == 1 ) || ( ipconfigUSE_NBNS == 1 )
+    #if ( ipconfigUSE_LLMNR == 1 ) || ( ipconfigUSE_NBNS == 1 ) || ( ipconfigUSE_MDNS != 0 )
 
 /*
  * The following function should be provided by the user and return true if it
  * matches the domain name.
  */
         extern BaseType_t xApplicationDNSQueryHook( const char * pcName );
-    #endif /* ( ipconfigUSE_LLMNR == 1 ) || ( ipconfigUSE_NBNS == 1 ) */
+    #endif /* ( ipconfigUSE_LLMNR == 1 ) || ( ipconfigUSE_NBNS == 1 ) || ( ipconfigUSE_MDNS != 0 ) */
 
 /*
  * LLMNR is very similar to DNS, so is handled by the DNS routines.
@@ -253,6 +316,33 @@
 
     #endif /* ipconfigUSE_NBNS */
 
+    #if ( ipconfigUSE_MDNS != 0 )
+        /* The mDNS MAC address is 01:00:5e:00:00:fb */
+        extern const MACAddress_t xMDNS_MacAddress;
+
+/*
+ * Inspect a multicast DNS message.  Queries for the host name or for one of
+ * the registered services are answered, the addresses found in responses are
+ * stored in the DNS cache.
+ */
+        uint32_t ulMDNSHandlePacket( NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/* Register a DNS-SD service, e.g. FreeRTOS_mDNSAddService( "Printer", "_ipp._tcp",
+ * 631, "rp=ipp" ).  The strings are not copied, they must remain valid.  The
+ * text may be NULL.  Returns pdPASS when the service was added, and announced. */
+        BaseType_t FreeRTOS_mDNSAddService( const char * pcInstance,
+                                            const char * pcService,
+                                            uint16_t usPort,
+                                            const char * pcText );
+
+/* Announce the host name and the registered services again. */
+        BaseType_t FreeRTOS_mDNSAnnounce( void );
+
+/* For internal use only: start, and continue sending unsolicited responses. */
+        void vMDNSStartAnnouncing( void );
+        void vMDNSAnnounceProcess( void );
+    #endif /* ipconfigUSE_MDNS */
+
     #if ( ipconfigUSE_DNS_CACHE != 0 )
 
 /* Look for the indicated host name in the DNS cache. Returns the IPv4
@@ -262,6 +352,19 @@
 /* Remove all entries from the DNS cache. */
         void FreeRTOS_dnsclear( void );
 
+/** @brief An address of a host, as returned by FreeRTOS_dnslookup_all(). */
+        typedef struct xDNS_ADDRESS
+        {
+            uint32_t ulIPAddress; /**< The IPv4 address, in network byte order. */
+            uint32_t ulTTL;       /**< The number of seconds that the address remains valid. */
+        } DNSAddress_t;
+
+/* Copy at most xMaxCount cached addresses of a host to pxAddresses.  Returns
+ * the number of addresses copied, 0 if the host is not in the cache. */
+        BaseType_t FreeRTOS_dnslookup_all( const char * pcHostName,
+                                           DNSAddress_t * pxAddresses,
+                                           BaseType_t xMaxCount );
+
     #endif /* ipconfigUSE_DNS_CACHE != 0 */
 
     #if ( ipconfigDNS_USE_CALLBACKS != 0 )
@@ -321,6 +424,33 @@
         extern void vDNSCheckCallBack( void * pvSearchID );
     #endif
 
+    #if ( ipconfigDNS_USE_RESOLVER != 0 )
+
+/*
+ * Set the address of an alternative DNS server of the resolver, where xIndex
+ * is between 1 and ipconfigDNS_RESOLVER_SERVERS - 1.  Server 0 is the DNS
+ * server of the network configuration.
+ */
+        BaseType_t FreeRTOS_SetDNSResolverServer( BaseType_t xIndex,
+                                                  uint32_t ulIPAddress );
+
+/*
+ * Let the resolver handle its replies, send new queries and retransmit the
+ * ones that were not answered.  It will be called "internally", by the IP-task.
+ */
+        void vDNSResolverProcess( void );
+
+/*
+ * Ask the IP-task to call vDNSResolverProcess().
+ */
+        BaseType_t xSendDNSResolverEvent( void );
+
+/*
+ * Returns pdTRUE if xSocket is the socket of the resolver.
+ */
+        BaseType_t xIsDNSResolverSocket( Socket_t xSocket );
+    #endif /* ipconfigDNS_USE_RESOLVER */
+
 
     #ifdef __cplusplus
         } /* extern "C" */
@@ -135,6 +135,12 @@
         #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
             struct xNETWORK_BUFFER * pxNextBuffer; /**< Possible optimisation for expert users - requires network driver support. */
         #endif
+        #if ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION != 0 )
+            uint16_t usSegmentSize; /**< When non-zero, the driver must split this TCP packet in segments of this size. */
+        #endif
+        #if ( ipconfigUSE_TCP_RX_COALESCING != 0 )
+            uint16_t usCoalescedCount; /**< The number of received TCP segments merged into this packet, 0 for a packet as received from the driver. */
+        #endif
     } NetworkBufferDescriptor_t;
 
     #include "pack_struct_start.h"
@@ -309,6 +315,33 @@
         UBaseType_t uxGetMinimumIPQueueSpace( void );
     #endif
 
+    #if ( ipconfigIP_EVENT_CLASSES != 0 )
+
+/* The classes of events of the IP-task, in the order of priority. */
+        #define ipEVENT_CLASS_CONTROL     ( 0 )
+        #define ipEVENT_CLASS_TX          ( 1 )
+        #define ipEVENT_CLASS_RX          ( 2 )
+        #define ipEVENT_CLASS_COUNT       ( 3 )
+
+/* The number of buckets in a histogram.  Bucket 0 counts the value 0, bucket n
+ * counts the values from 2^(n-1) up to 2^n - 1, and the last bucket counts all
+ * larger values as well. */
+        #define ipEVENT_HISTOGRAM_SIZE    ( 8 )
+
+/**
+ * The statistics of one class of events of the IP-task.
+ */
+        typedef struct xIP_EVENT_STATS
+        {
+            uint32_t ulEventCount;                        /**< The number of events handled. */
+            uint32_t ulDepth[ ipEVENT_HISTOGRAM_SIZE ];   /**< The number of events in the queue when one was taken, including that one. */
+            uint32_t ulLatency[ ipEVENT_HISTOGRAM_SIZE ]; /**< The number of clock ticks between sending and taking an event. */
+        } IPEventStats_t;
+
+        void FreeRTOS_GetIPEventStats( IPEventStats_t pxStats[ ipEVENT_CLASS_COUNT ],
+                                       BaseType_t xReset );
+    #endif /* ipconfigIP_EVENT_CLASSES */
+
     #if ( ipconfigHAS_PRINTF != 0 )
         extern void vPrintResourceStats( void );
     #else
@@ -340,16 +373,17 @@
     void vSetMultiCastIPv4MacAddress( uint32_t ulIPAddress,
                                       MACAddress_t * pxMACAddress );
 
-    #if ( ipconfigDHCP_REGISTER_HOSTNAME == 1 )
+    #if ( ipconfigDHCP_REGISTER_HOSTNAME == 1 ) || ( ipconfigUSE_MDNS != 0 )
 
 /* DHCP has an option for clients to register their hostname.  It doesn't
  * have much use, except that a device can be found in a router along with its
  * name. If this option is used the callback below must be provided by the
- * application writer to return a const string, denoting the device's name. */
+ * application writer to return a const string, denoting the device's name.
+ * mDNS announces the same name, with the suffix ".local". */
 /* Typically this function is defined in a user module. */
         const char * pcApplicationHostnameHook( void );
 
-    #endif /* ipconfigDHCP_REGISTER_HOSTNAME */
+    #endif /* ( ipconfigDHCP_REGISTER_HOSTNAME == 1 ) || ( ipconfigUSE_MDNS != 0 ) */
 
 
 /* This xApplicationGetRandomNumber() will set *pulNumber to a random number,
@@ -305,6 +305,9 @@
         eSocketSelectEvent,    /*11: Send a message to the IP-task for select(). */
         eSocketSignalEvent,    /*12: A socket must be signalled. */
         eSocketSetDeleteEvent, /*13: A socket set must be deleted. */
+        eDNSResolverEvent,     /*14: The DNS resolver has a query to send, or a reply to handle. */
+        eMDNSAnnounceEvent,    /*15: Announce the host name and the DNS-SD services through mDNS. */
+        eARPClearEvent,        /*16: FreeRTOS_ClearARP() was called by another task than the IP-task. */
     } eIPEvent_t;
 
 /**
@@ -325,6 +328,13 @@
     #define ipFRAGMENTATION_PARAMETERS_OFFSET    ( 6 )
     #define ipSOCKET_OPTIONS_OFFSET              ( 6 )
 
+/* Offset into the Ethernet frame at which FreeRTOS_sendto() stores the generation
+ * of the destination MAC-address that it copied from the socket, or zero.  It is
+ * also part of the source address, which is filled in by the IP-task. */
+    #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+        #define ipDESTINATION_GENERATION_OFFSET    ( 8 )
+    #endif
+
 
 /* The offset into a UDP packet at which the UDP data (payload) starts. */
     #define ipUDP_PAYLOAD_OFFSET_IPv4    ( sizeof( UDPPacket_t ) )
@@ -448,6 +458,33 @@
 
     #define ipPOINTER_CAST( TYPE, pointer )    ( ( TYPE ) ( pointer ) )
 
+/* A barrier that keeps the compiler, and the processor, from moving memory
+ * accesses across it.  It is used where a user task and the IP-task exchange a
+ * flag and a pointer.  For compilers other than GCC, the port must define
+ * portMEMORY_BARRIER(). */
+    #ifndef ipMEMORY_BARRIER
+        #if defined( __GNUC__ )
+            #define ipMEMORY_BARRIER()    __sync_synchronize()
+        #else
+            #define ipMEMORY_BARRIER()    portMEMORY_BARRIER()
+        #endif
+    #endif
+
+/* The IP-task replaces the streams of a socket while auto-tuning, and releases
+ * them when a closed connection is kept in the TIME_WAIT table.  In both cases,
+ * a user task marks when it is using a stream, see ucRxStreamBusy. */
+    #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 ) || ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+        #define ipTCP_GUARD_RX_STREAM    1
+    #else
+        #define ipTCP_GUARD_RX_STREAM    0
+    #endif
+
+    #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 ) || ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+        #define ipTCP_GUARD_TX_STREAM    1
+    #else
+        #define ipTCP_GUARD_TX_STREAM    0
+    #endif
+
 /* ICMP packets are sent using the same function as UDP packets.  The port
  * number is used to distinguish between the two, as 0 is an invalid UDP port. */
     #define ipPACKET_CONTAINS_ICMP_DATA    ( 0 )
@@ -618,6 +655,12 @@
                 #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
                     bConnPassed : 1,       /**< Connecting socket: Socket has been passed in a successful select()  */
                 #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
+                #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                    bAckNow : 1,           /**< Data was received out of order or a gap was filled: do not delay the next ACK */
+                #endif /* ipconfigUSE_TCP_ACK_POLICY */
+                #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                    bWakeDeferred : 1,     /**< The IP-task is postponing a wake-up of the owner since 'xWakeDeferTime' */
+                #endif /* ipconfigSOCKET_WAKE_COALESCING */
                 bFinAccepted : 1,          /**< This socket has received (or sent) a FIN and accepted it */
                     bFinSent : 1,          /**< We've sent out a FIN */
                     bFinRecv : 1,          /**< We've received a FIN from our peer */
@@ -653,6 +696,44 @@
             #if ( ipconfigUSE_TCP_WIN == 1 )
                 NetworkBufferDescriptor_t * pxAckMessage; /**< The pointer to the ACK message */
             #endif /* ipconfigUSE_TCP_WIN */
+            #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                TCPAckPolicy_t xAckPolicy;                /**< The policy set with FREERTOS_SO_TCP_ACK_POLICY */
+                TCPAckStatistics_t xAckStatistics;        /**< Counters of the ACK's sent in response to received data */
+                uint8_t ucAckPendingSegments;             /**< The number of full-size segments received since the last ACK */
+                uint8_t ucQuickAckRemaining;              /**< The number of segments that will still be acknowledged immediately */
+            #endif /* ipconfigUSE_TCP_ACK_POLICY */
+            #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 )
+                size_t uxRxStreamMaxSize;                 /**< The maximum size of the rxStream, zero as long as the connection has not started */
+                size_t uxRxStreamTargetSize;              /**< The size that the rxStream should get */
+                uint32_t ulRxTuneBytes;                   /**< The number of bytes received in the current measurement period */
+                TickType_t xRxTuneTime;                   /**< The time at which the current measurement period started */
+            #endif /* ipconfigUSE_TCP_RX_AUTOTUNING */
+            #if ( ipTCP_GUARD_RX_STREAM != 0 )
+                volatile uint8_t ucRxStreamBusy;          /**< Non-zero while FreeRTOS_recv() is accessing the rxStream */
+                volatile uint8_t ucRxStreamPinned;        /**< Non-zero once the application got a direct pointer into the rxStream, which will then not be replaced or released */
+            #endif /* ipTCP_GUARD_RX_STREAM */
+            #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+                size_t uxTxStreamGrowth;                  /**< The number of bytes by which the txStream exceeds uxTxStreamSize, taken from the shared budget */
+                uint32_t ulTxTuneBytes;                   /**< The number of bytes acknowledged in the current measurement period */
+                TickType_t xTxTuneTime;                   /**< The time at which the current measurement period started */
+                uint8_t ucTxStreamLimited;                /**< Non-zero when the txStream was found full in the current measurement period */
+            #endif /* ipconfigUSE_TCP_TX_AUTOTUNING */
+            #if ( ipTCP_GUARD_TX_STREAM != 0 )
+                volatile uint8_t ucTxStreamBusy;          /**< Non-zero while FreeRTOS_send() is accessing the txStream */
+                volatile uint8_t ucTxStreamPinned;        /**< Non-zero once FreeRTOS_get_tx_head() was used, the txStream will then not be replaced or released */
+            #endif /* ipTCP_GUARD_TX_STREAM */
+            #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                size_t uxRcvLowat;                        /**< The number of bytes in the rxStream that wakes up a reader, see FREERTOS_SO_RCVLOWAT */
+                size_t uxSndLowat;                        /**< The free space in the txStream that wakes up a writer, see FREERTOS_SO_SNDLOWAT */
+                TickType_t xWakeDeferTime;                /**< The time at which the IP-task started to postpone a wake-up */
+                SocketWakeStats_t xWakeStats;             /**< The wake-up counters */
+            #endif /* ipconfigSOCKET_WAKE_COALESCING */
+            #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+                uint32_t ulARPGeneration;                 /**< ulARPGetGeneration() when the MAC-address of the peer in xPacket was last checked */
+            #endif
+            #if ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 ) && ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION == 0 )
+                int32_t lBurstStreamPos;                  /**< The position in txStream of the data of a super-segment, which the IP-task will split */
+            #endif
             LastTCPPacket_t xPacket;                      /**< Buffer space to store the last TCP header received. */
             uint8_t tcpflags;                             /**< TCP flags */
             #if ( ipconfigUSE_TCP_WIN != 0 )
@@ -692,6 +773,12 @@
                                               */
             FOnUDPSent_t pxHandleSent;       /**< Function pointer to handle the events after a successful send. */
         #endif /* ipconfigUSE_CALLBACKS */
+        #if ( ipconfigUSE_DESTINATION_CACHE != 0 )
+            uint32_t ulDestinationIP;                   /**< The last IP-address to which a packet was sent, in network byte order. */
+            MACAddress_t xDestinationMAC;               /**< The MAC-address to which packets for ulDestinationIP are sent. */
+            volatile uint32_t ulDestinationGeneration;  /**< ulARPGetGeneration() when the entry was filled in, or zero while it is not valid. */
+            volatile uint32_t ulDestinationSequence;    /**< Incremented by the IP-task before and after it changes the entry, odd while the entry is being changed. */
+        #endif /* ipconfigUSE_DESTINATION_CACHE */
     } IPUDPSocket_t;
 
 /* Formally typedef'd as eSocketEvent_t. */
@@ -707,6 +794,20 @@
         eSOCKET_ALL = 0x007F,
     };
 
+    #if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+
+/**
+ * A task that waits for events of a socket, see xSocketWaitEvents().  It lives on
+ * the stack of the waiting task, and is linked into the list of the socket.
+ */
+        typedef struct xSOCKET_WAITER
+        {
+            struct xSOCKET_WAITER * pxNext; /**< The next task waiting for the same socket. */
+            TaskHandle_t xTask;             /**< The waiting task. */
+            uint8_t ucWaitEvents;           /**< The events that the task is waiting for. */
+            uint8_t ucResultEvents;         /**< The events that were handed to the task. */
+        } SocketWaiter_t;
+    #endif /* ipconfigSOCKET_USES_NOTIFY */
 
 /**
  * Structure to hold information for a socket.
@@ -714,7 +815,12 @@
     typedef struct xSOCKET
     {
         EventBits_t xEventBits;                /**< The eventbits to keep track of events. */
-        EventGroupHandle_t xEventGroup;        /**< The event group for this socket. */
+        #if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+            SocketWaiter_t * pxWaiters; /**< The list of tasks waiting for events of this socket. */
+            uint8_t ucPendingEvents;    /**< The events that were not yet handed to a waiting task. */
+        #else
+            EventGroupHandle_t xEventGroup; /**< The event group for this socket. */
+        #endif /* ipconfigSOCKET_USES_NOTIFY */
 
         ListItem_t xBoundSocketListItem;       /**< Used to reference the socket from a bound sockets list. */
         TickType_t xReceiveBlockTime;          /**< if recv[to] is called while no data is available, wait this amount of time. Unit in clock-ticks */
@@ -723,6 +829,11 @@
         uint16_t usLocalPort;                  /**< Local port on this machine */
         uint8_t ucSocketOptions;               /**< Socket options */
         uint8_t ucProtocol;                    /**< choice of FREERTOS_IPPROTO_UDP/TCP */
+        #if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+            uint8_t ucStaticSocket;            /**< pdTRUE when the memory was provided by the caller of FreeRTOS_socket_static(). */
+            volatile uint8_t ucStaticClosed;   /**< Set by the IP-task when it has closed a static socket, and no longer uses its memory. */
+            TaskHandle_t xCloseTask;           /**< The task waiting in FreeRTOS_closesocket() until a static socket is closed. */
+        #endif /* ipconfigSUPPORT_STATIC_SOCKETS */
         #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
             SemaphoreHandle_t pxUserSemaphore; /**< The user semaphore */
         #endif /* ipconfigSOCKET_HAS_USER_SEMAPHORE */
@@ -737,6 +848,13 @@
             EventBits_t xSocketBits;          /**< These bits indicate the events which have actually occurred.
                                                * They are maintained by the IP-task */
         #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
+        #if ( ipconfigSUPPORT_EPOLL == 1 )
+            struct xEPOLL_SET * pxEPollSet; /**< The epoll set to which the socket is registered, or NULL.  The interesting events are stored in xSelectBits. */
+            ListItem_t xEPollMemberItem;    /**< Links the socket into the member list of its epoll set. */
+            ListItem_t xEPollReadyItem;     /**< Links the socket into the ready list of its epoll set. */
+            EventBits_t xEPollEvents;       /**< The events that have occurred but which were not reported yet. */
+            void * pvEPollData;             /**< The value that FreeRTOS_epoll_wait() returns with the socket. */
+        #endif /* ipconfigSUPPORT_EPOLL */
         /* TCP/UDP specific fields: */
         /* Before accessing any member of this structure, it should be confirmed */
         /* that the protocol corresponds with the type of structure */
@@ -821,11 +939,72 @@
                            const uint8_t * pcData,
                            uint32_t ulByteCount );
 
+    #if ( ipconfigUSE_TCP_RX_AUTOTUNING != 0 )
+
+/*
+ * Receive buffer auto-tuning: change the size of the rxStream that will be
+ * created, and scale the low- and high-water marks along with it.
+ */
+        void vTCPSetRxStreamSize( FreeRTOS_Socket_t * pxSocket,
+                                  size_t uxNewSize );
+
+/*
+ * Receive buffer auto-tuning: replace an empty rxStream with one of a different
+ * size.  Returns pdTRUE if the stream was replaced.
+ */
+        BaseType_t xTCPResizeRxStream( FreeRTOS_Socket_t * pxSocket,
+                                       size_t uxNewSize );
+    #endif /* ipconfigUSE_TCP_RX_AUTOTUNING */
+
+    #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+
+/*
+ * Send buffer auto-tuning: copy the contents of the txStream into a new stream
+ * of a different size, within the budget shared by all sockets.  Returns pdTRUE
+ * if the stream was replaced.
+ */
+        BaseType_t xTCPResizeTxStream( FreeRTOS_Socket_t * pxSocket,
+                                       size_t uxNewSize );
+    #endif /* ipconfigUSE_TCP_TX_AUTOTUNING */
+
+    #if ( ipconfigTCP_TIME_WAIT_TABLE != 0 )
+
+/*
+ * The TIME_WAIT state of a connection is kept in the table: free its txStream,
+ * and its rxStream when there is nothing left to read.
+ */
+        void vTCPReleaseStreams( FreeRTOS_Socket_t * pxSocket );
+    #endif /* ipconfigTCP_TIME_WAIT_TABLE */
+
 /*
  * Currently called for any important event.
  */
     void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket );
 
+    #if ( ipconfigSOCKET_USES_NOTIFY != 0 )
+
+/*
+ * Wait until at least one of the given events has occurred on a socket, or
+ * until the time expires.  The events found are cleared and returned.
+ */
+        EventBits_t xSocketWaitEvents( FreeRTOS_Socket_t * pxSocket,
+                                       EventBits_t xEvents,
+                                       TickType_t xTicksToWait );
+
+/*
+ * Set events of a socket, and wake up the task that waits for them.
+ */
+        void vSocketSetEvents( FreeRTOS_Socket_t * pxSocket,
+                               EventBits_t xEvents );
+    #else
+
+/* The events of a socket are kept in its event group. */
+        #define xSocketWaitEvents( pxSocket, xEvents, xTicksToWait ) \
+    xEventGroupWaitBits( ( pxSocket )->xEventGroup, ( xEvents ), pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, ( xTicksToWait ) )
+        #define vSocketSetEvents( pxSocket, xEvents ) \
+    ( void ) xEventGroupSetBits( ( pxSocket )->xEventGroup, ( xEvents ) )
+    #endif /* ipconfigSOCKET_USES_NOTIFY */
+
 /*
  * Some helping function, their meaning should be clear.
  * Going by MISRA rules, these utility functions should not be defined
@@ -916,6 +1095,24 @@
 
     #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 
+    #if ( ipconfigSUPPORT_EPOLL == 1 )
+
+/** @brief Structure of an epoll set.  Both lists are protected by suspending the
+ * scheduler, because they are accessed by the IP-task and by the user. */
+        typedef struct xEPOLL_SET
+        {
+            EventGroupHandle_t xWaitGroup; /**< Wakes up FreeRTOS_epoll_wait() when a socket becomes ready. */
+            List_t xMemberList;            /**< All sockets that are registered to the set. */
+            List_t xReadyList;             /**< The sockets that have events to report. */
+        } SocketEPoll_t;
+
+/* Called by the IP-task when events occur on a socket that is registered to an
+ * epoll set. */
+        extern void vSocketEPollSignal( FreeRTOS_Socket_t * pxSocket,
+                                        EventBits_t xEvents );
+
+    #endif /* ipconfigSUPPORT_EPOLL */
+
     #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 ) || ( ipconfigUSE_TCP == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
         extern ipDECL_CAST_PTR_FUNC_FOR_TYPE( ListItem_t );
         extern ipDECL_CAST_CONST_PTR_FUNC_FOR_TYPE( ListItem_t );
@@ -929,11 +1126,19 @@
         void vIPReloadDNSTimer( uint32_t ulCheckTime );
         void vIPSetDnsTimerEnableState( BaseType_t xEnableState );
     #endif
+    #if ( ipconfigUSE_MDNS != 0 )
+        void vIPReloadMDNSTimer( uint32_t ulCheckTime );
+        void vIPSetMDNSTimerEnableState( BaseType_t xEnableState );
+    #endif
 
 
 /* Send the network-up event and start the ARP timer. */
     void vIPNetworkUpCalls( void );
 
+/* Send the network-down event and stop the ARP timer, while the network
+ * interface stays up. */
+    void vIPNetworkDownCalls( void );
+
     #ifdef __cplusplus
         } /* extern "C" */
     #endif
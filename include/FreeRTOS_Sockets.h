@@ -138,6 +138,15 @@
 
     #define FREERTOS_SO_SET_LOW_HIGH_WATER            ( 18 )
 
+    #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+        #define FREERTOS_SO_TCP_ACK_POLICY            ( 19 ) /* Set the delayed-ACK policy, parameter is pointer to TCPAckPolicy_t */
+    #endif
+
+    #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+        #define FREERTOS_SO_RCVLOWAT                  ( 20 ) /* Only wake up a reader when this many bytes can be read, parameter is pointer to size_t (TCP only) */
+        #define FREERTOS_SO_SNDLOWAT                  ( 21 ) /* Only wake up a writer when this many bytes can be written, parameter is pointer to size_t (TCP only) */
+    #endif
+
     #define FREERTOS_NOT_LAST_IN_FRAGMENTED_PACKET    ( 0x80 ) /* For internal use only, but also part of an 8-bit bitwise value. */
     #define FREERTOS_FRAGMENTED_PACKET                ( 0x40 ) /* For internal use only, but also part of an 8-bit bitwise value. */
 
@@ -176,6 +185,43 @@
         size_t uxEnoughSpace; /**< Send a GO when buffer space grows above X bytes */
     } LowHighWater_t;
 
+/**
+ * Structure to pass for the 'FREERTOS_SO_TCP_ACK_POLICY' option.  A value of
+ * zero in any of the fields selects the default behaviour.
+ */
+    typedef struct xTCP_ACK_POLICY
+    {
+        uint8_t ucAckEveryN;        /**< Send an ACK at least after every N full-size segments, 0 = no limit */
+        uint8_t ucQuickAckSegments; /**< The number of segments that will be acknowledged immediately after the connection is established */
+        uint16_t usDelayMS;         /**< The maximum time that an ACK for full-size segments may be postponed, in ms */
+    } TCPAckPolicy_t;
+
+/**
+ * Counters of the ACK's that were sent in response to received data, see
+ * FreeRTOS_GetTCPAckStatistics().
+ */
+    typedef struct xTCP_ACK_STATISTICS
+    {
+        uint32_t ulDelayedAcks;    /**< An ACK was postponed */
+        uint32_t ulTimerAcks;      /**< A postponed ACK was sent because its timer expired */
+        uint32_t ulImmediateAcks;  /**< An ACK was sent without delay, for any of the reasons below or because there was data or a flag to send */
+        uint32_t ulQuickAcks;      /**< An ACK was sent immediately in quick-ACK mode */
+        uint32_t ulEveryNAcks;     /**< An ACK was sent because 'ucAckEveryN' segments were received */
+        uint32_t ulOutOfOrderAcks; /**< An ACK was sent because data was received out of order, or a gap was filled */
+        uint32_t ulWindowAcks;     /**< An ACK was sent because the reception window changed or became small */
+    } TCPAckStatistics_t;
+
+/**
+ * Counters of the wake-ups of the owner of a TCP socket, see
+ * FreeRTOS_GetSocketWakeStats().
+ */
+    typedef struct xSOCKET_WAKE_STATS
+    {
+        uint32_t ulWakeUps;    /**< The owner was woken up */
+        uint32_t ulDeferred;   /**< A wake-up was postponed because the IP-task was busy */
+        uint32_t ulBelowLowat; /**< An event did not wake up the owner because of FREERTOS_SO_RCVLOWAT or FREERTOS_SO_SNDLOWAT */
+    } SocketWakeStats_t;
+
 /* For compatibility with the expected Berkeley sockets naming. */
     #define socklen_t    uint32_t
 
@@ -223,6 +269,17 @@
     typedef struct xSOCKET         * Socket_t;
     typedef struct xSOCKET const   * ConstSocket_t;
 
+    #if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+
+/* The storage for a socket that is created with FreeRTOS_socket_static().  Its
+ * contents are private, only its size of ipconfigSTATIC_SOCKET_SIZE bytes is
+ * public.  FreeRTOS_socket_static() checks that the socket fits in it. */
+        typedef struct xSTATIC_SOCKET
+        {
+            void * pvDummy[ ( ipconfigSTATIC_SOCKET_SIZE + sizeof( void * ) - 1U ) / sizeof( void * ) ];
+        } StaticSocket_t;
+    #endif /* ( ipconfigSUPPORT_STATIC_SOCKETS != 0 ) */
+
     extern BaseType_t xSocketValid( Socket_t xSocket );
 
     #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
@@ -233,6 +290,14 @@
         typedef struct xSOCKET_SET * SocketSet_t;
     #endif /* ( ipconfigSUPPORT_SELECT_FUNCTION == 1 ) */
 
+    #if ( ipconfigSUPPORT_EPOLL == 1 )
+
+/* An EPollSet_t holds the sockets that were registered with FreeRTOS_epoll_ctl(),
+ * and keeps a list of the sockets that are ready.  FreeRTOS_epoll_wait() only
+ * looks at that list. */
+        typedef struct xEPOLL_SET * EPollSet_t;
+    #endif /* ( ipconfigSUPPORT_EPOLL == 1 ) */
+
 /**
  * FULL, UP-TO-DATE AND MAINTAINED REFERENCE DOCUMENTATION FOR ALL THESE
  * FUNCTIONS IS AVAILABLE ON THE FOLLOWING URL:
@@ -241,6 +306,18 @@
     Socket_t FreeRTOS_socket( BaseType_t xDomain,
                               BaseType_t xType,
                               BaseType_t xProtocol );
+
+    #if ( ipconfigSUPPORT_STATIC_SOCKETS != 0 )
+
+/* Create a socket in the memory that 'pxSocketBuffer' points to.  The memory must
+ * remain valid until the IP-task has closed the socket.  FreeRTOS_closesocket()
+ * waits for that, unless it is called from the IP-task. */
+        Socket_t FreeRTOS_socket_static( BaseType_t xDomain,
+                                         BaseType_t xType,
+                                         BaseType_t xProtocol,
+                                         StaticSocket_t * pxSocketBuffer );
+    #endif /* ( ipconfigSUPPORT_STATIC_SOCKETS != 0 ) */
+
     int32_t FreeRTOS_recvfrom( Socket_t xSocket,
                                void * pvBuffer,
                                size_t uxBufferLength,
@@ -287,6 +364,23 @@
         BaseType_t FreeRTOS_shutdown( Socket_t xSocket,
                                       BaseType_t xHow );
 
+        #if ( ipconfigUSE_TCP_CONNECT_ANY != 0 )
+
+/* Connect to the first one of several addresses that accepts the connection.
+ * Returns the connected socket, or FREERTOS_INVALID_SOCKET. */
+            Socket_t FreeRTOS_connect_any( const uint32_t * pulIPAddresses,
+                                           BaseType_t xCount,
+                                           uint16_t usPort,
+                                           TickType_t xTimeout );
+
+            #if ( ipconfigUSE_DNS_CACHE != 0 )
+                /* Look up a host name and connect to one of its addresses. */
+                Socket_t FreeRTOS_connect_host( const char * pcHostName,
+                                                uint16_t usPort,
+                                                TickType_t xTimeout );
+            #endif
+        #endif /* ipconfigUSE_TCP_CONNECT_ANY */
+
         #if ( ipconfigSUPPORT_SIGNALS != 0 )
             /* Send a signal to the task which is waiting for a given socket. */
             BaseType_t FreeRTOS_SignalSocket( Socket_t xSocket );
@@ -309,6 +403,18 @@
 /* Returns the actual size of MSS being used. */
             BaseType_t FreeRTOS_mss( ConstSocket_t xSocket );
 
+            #if ( ipconfigUSE_TCP_ACK_POLICY != 0 )
+                /* Get a copy of the ACK counters of a TCP socket. */
+                BaseType_t FreeRTOS_GetTCPAckStatistics( ConstSocket_t xSocket,
+                                                         TCPAckStatistics_t * pxStatistics );
+            #endif
+
+            #if ( ipconfigSOCKET_WAKE_COALESCING != 0 )
+                /* Get a copy of the wake-up counters of a TCP socket. */
+                BaseType_t FreeRTOS_GetSocketWakeStats( ConstSocket_t xSocket,
+                                                        SocketWakeStats_t * pxStats );
+            #endif
+
         #endif /* ( ipconfigUSE_TCP == 1 ) */
 
 /* For internal use only: return the connection status. */
@@ -513,6 +619,41 @@
 
     #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 
+    #if ( ipconfigSUPPORT_EPOLL == 1 )
+
+/* The operations of FreeRTOS_epoll_ctl(). */
+        #define FREERTOS_EPOLL_CTL_ADD    ( 1 ) /**< Register a socket. */
+        #define FREERTOS_EPOLL_CTL_MOD    ( 2 ) /**< Change the events or the data of a registered socket. */
+        #define FREERTOS_EPOLL_CTL_DEL    ( 3 ) /**< Unregister a socket. */
+
+/* The events of FreeRTOS_epoll_ctl() are a combination of eSELECT_READ,
+ * eSELECT_WRITE and eSELECT_EXCEPT.  By default, a socket is reported as long
+ * as it is ready (level-triggered).  When FREERTOS_EPOLL_EDGE is included, a
+ * socket is only reported once after each new event (edge-triggered). */
+        #define FREERTOS_EPOLL_EDGE       ( 0x0100U )
+
+/** @brief A socket that is ready, as returned by FreeRTOS_epoll_wait(). */
+        typedef struct xEPOLL_EVENT
+        {
+            Socket_t xSocket;    /**< The socket that is ready. */
+            EventBits_t xEvents; /**< The events that occurred, see eSelectEvent_t. */
+            void * pvData;       /**< The value that was passed to FreeRTOS_epoll_ctl(). */
+        } EPollEvent_t;
+
+        EPollSet_t FreeRTOS_epoll_create( void );
+        void FreeRTOS_epoll_delete( EPollSet_t xEPollSet );
+        BaseType_t FreeRTOS_epoll_ctl( EPollSet_t xEPollSet,
+                                       BaseType_t xOperation,
+                                       Socket_t xSocket,
+                                       EventBits_t xEvents,
+                                       void * pvData );
+        BaseType_t FreeRTOS_epoll_wait( EPollSet_t xEPollSet,
+                                        EPollEvent_t * pxEvents,
+                                        BaseType_t xMaxEvents,
+                                        TickType_t xBlockTimeTicks );
+
+    #endif /* ipconfigSUPPORT_EPOLL */
+
     #ifdef __cplusplus
         } /* extern "C" */
     #endif
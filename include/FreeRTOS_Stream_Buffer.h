@@ -40,17 +40,60 @@
         extern "C" {
     #endif
 
+    #if ( ipconfigSTREAM_BUFFER_USE_ATOMICS != 0 )
+        #include <stdatomic.h>
+
+/**
+ * An index that is written by one side of the stream, and read by the other side.
+ */
+        typedef atomic_size_t   StreamBufferIndex_t;
+
+/* Read an index that may have been published by the other side. */
+        #define sbLOAD_ACQUIRE( xIndex )                atomic_load_explicit( &( xIndex ), memory_order_acquire )
+/* Read an index that is only written by the calling side. */
+        #define sbLOAD_RELAXED( xIndex )                atomic_load_explicit( &( xIndex ), memory_order_relaxed )
+/* Publish an index, after the data that it covers has been copied. */
+        #define sbSTORE_RELEASE( xIndex, uxValue )      atomic_store_explicit( &( xIndex ), ( uxValue ), memory_order_release )
+    #else
+
+/**
+ * An index that is written by one side of the stream, and read by the other side.
+ */
+        typedef volatile size_t StreamBufferIndex_t;
+
+        #define sbLOAD_ACQUIRE( xIndex )                ( xIndex )
+        #define sbLOAD_RELAXED( xIndex )                ( xIndex )
+        #define sbSTORE_RELEASE( xIndex, uxValue )      ( ( xIndex ) = ( uxValue ) )
+    #endif /* ipconfigSTREAM_BUFFER_USE_ATOMICS */
+
+    #if ( ipconfigSTREAM_BUFFER_MIRROR_SIZE != 0 )
+
+/* The number of bytes at the start of a stream of 'uxLength' bytes, that are
+ * repeated after its end. */
+        #define sbMIRROR_SIZE( uxLength )    FreeRTOS_min_size_t( ( size_t ) ipconfigSTREAM_BUFFER_MIRROR_SIZE, ( uxLength ) )
+
+/* The size of the mirror that was actually allocated behind a stream.  It is
+ * zero for streams that were not created by prvTCPAllocateStream(). */
+        #define sbMIRROR_OF( pxBuffer )      ( ( pxBuffer )->uxMirrorSize )
+    #else
+        #define sbMIRROR_SIZE( uxLength )    ( 0U )
+        #define sbMIRROR_OF( pxBuffer )      ( 0U )
+    #endif
+
 /**
  * structure to store all the details of a stream buffer.
  */
     typedef struct xSTREAM_BUFFER
     {
-        volatile size_t uxTail;              /**< next item to read */
-        volatile size_t uxMid;               /**< iterator within the valid items */
-        volatile size_t uxHead;              /**< next position store a new item */
-        volatile size_t uxFront;             /**< iterator within the free space */
+        StreamBufferIndex_t uxTail;          /**< next item to read */
+        StreamBufferIndex_t uxMid;           /**< iterator within the valid items */
+        StreamBufferIndex_t uxHead;          /**< next position store a new item */
+        StreamBufferIndex_t uxFront;         /**< iterator within the free space */
         size_t LENGTH;                       /**< const value: number of reserved elements */
-        uint8_t ucArray[ sizeof( size_t ) ]; /**< array big enough to store any pointer address */
+        #if ( ipconfigSTREAM_BUFFER_MIRROR_SIZE != 0 )
+            size_t uxMirrorSize;             /**< const value: number of bytes mirrored behind 'LENGTH', may be zero */
+        #endif
+        uint8_t ucArray[ sizeof( size_t ) ]; /**< array big enough to store any pointer address, followed by the mirror */
     } StreamBuffer_t;
 
     void vStreamBufferClear( StreamBuffer_t * pxBuffer );
@@ -32,6 +32,15 @@
 
     BaseType_t xProcessReceivedTCPPacket( NetworkBufferDescriptor_t * pxDescriptor );
 
+    #if ( ipconfigUSE_TCP_RX_COALESCING != 0 )
+
+/*
+ * Merge consecutive in-order TCP segments found in a chain of received
+ * packets.  Returns the first buffer of the new chain.
+ */
+        NetworkBufferDescriptor_t * pxTCPCoalesceReceivedPackets( NetworkBufferDescriptor_t * pxFirstBuffer );
+    #endif
+
     typedef enum eTCP_STATE
     {
         /* Comments about the TCP states are borrowed from the very useful
@@ -203,12 +203,31 @@
  * it will return pdTRUE */
     BaseType_t xTCPWindowTxDone( const TCPWindow_t * pxWindow );
 
+    #if ( ipconfigUSE_TCP_TX_AUTOTUNING != 0 )
+
+/* The txStream has been linearised into a new stream, starting at index 0.
+ * Translate the stream positions of the transmission segments. */
+        void vTCPWindowTxRebase( TCPWindow_t * pxWindow,
+                                 int32_t lTail,
+                                 int32_t lMax );
+    #endif
+
 /* Fetches data to be sent.
  * 'plPosition' will point to a location with the circular data buffer: txStream */
     uint32_t ulTCPWindowTxGet( TCPWindow_t * pxWindow,
                                uint32_t ulWindowSize,
                                int32_t * plPosition );
 
+    #if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_SEGMENTATION_OFFLOAD != 0 )
+
+/* Fetches a burst of consecutive segments, to be sent as a single super-segment
+ * of at most 'ulMaxLength' bytes. */
+        uint32_t ulTCPWindowTxGetBurst( TCPWindow_t * pxWindow,
+                                        uint32_t ulWindowSize,
+                                        int32_t * plPosition,
+                                        uint32_t ulMaxLength );
+    #endif
+
 /* Receive a normal ACK */
     uint32_t ulTCPWindowTxAck( TCPWindow_t * pxWindow,
                                uint32_t ulSequenceNumber );
@@ -299,6 +299,20 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
                             pxReturn->pxNextBuffer = NULL;
                         }
                     #endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+
+                    #if ( ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION != 0 )
+                        {
+                            /* A normal packet, which the driver must not segment. */
+                            pxReturn->usSegmentSize = 0U;
+                        }
+                    #endif /* ipconfigDRIVER_INCLUDED_TCP_SEGMENTATION */
+
+                    #if ( ipconfigUSE_TCP_RX_COALESCING != 0 )
+                        {
+                            /* Not a packet that was merged by the IP-task. */
+                            pxReturn->usCoalescedCount = 0U;
+                        }
+                    #endif /* ipconfigUSE_TCP_RX_COALESCING */
                 }
             }
             else
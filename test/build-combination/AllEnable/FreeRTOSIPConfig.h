@@ -299,6 +299,86 @@ extern uint32_t ulRand();
 #define ipconfigSOCKET_HAS_USER_WAKE_CALLBACK    ( 1 )
 #define ipconfigUSE_CALLBACKS                    ( 1 )
 
+/* Combine consecutive TCP segments into super-segments. */
+#define ipconfigUSE_TCP_SEGMENTATION_OFFLOAD     ( 1 )
+
+/* Pass chains of received packets, and merge in-order TCP segments. */
+#define ipconfigUSE_LINKED_RX_MESSAGES           ( 1 )
+#define ipconfigUSE_TCP_RX_COALESCING            ( 1 )
+
+/* Allow FREERTOS_SO_TCP_ACK_POLICY to tune the delayed ACK's. */
+#define ipconfigUSE_TCP_ACK_POLICY               ( 1 )
+
+/* Let the reception streams of TCP sockets grow and shrink. */
+#define ipconfigUSE_TCP_RX_AUTOTUNING            ( 1 )
+
+/* Let the transmission streams of TCP sockets grow within a shared budget. */
+#define ipconfigUSE_TCP_TX_AUTOTUNING            ( 1 )
+
+/* Look up ARP entries through hash tables, and let packets wait per entry. */
+#define ipconfigUSE_ARP_HASH_TABLE               ( 1 )
+
+/* Age the ARP cache entries through a timer wheel. */
+#define ipconfigUSE_ARP_TIMER_WHEEL              ( 1 )
+
+/* Let sockets store the MAC-address of their destination. */
+#define ipconfigUSE_DESTINATION_CACHE            ( 1 )
+
+/* Resolve host names through a resolver in the IP-task, which needs the
+ * asynchronous DNS API. */
+#define ipconfigDNS_USE_CALLBACKS                ( 1 )
+#define ipconfigDNS_USE_RESOLVER                 ( 1 )
+
+/* Find DNS cache entries through a hash table, and cache negative answers. */
+#define ipconfigUSE_DNS_CACHE_HASH               ( 1 )
+#define ipconfigDNS_CACHE_PREFETCH_SECONDS       ( 30U )
+
+/* Let FreeRTOS_connect_any() race connections to several addresses of a host. */
+#define ipconfigUSE_TCP_CONNECT_ANY              ( 1 )
+
+/* Answer mDNS queries and announce DNS-SD services. */
+#define ipconfigUSE_MDNS                         ( 1 )
+
+/* Request the address of the last lease directly, and use it at once. */
+#define ipconfigDHCP_STORE_LEASE                 ( 1 )
+#define ipconfigDHCP_USE_LEASE_AT_ONCE           ( 1 )
+
+/* Lease in one round trip, and check new addresses for conflicts. */
+#define ipconfigDHCP_USE_RAPID_COMMIT            ( 1 )
+#define ipconfigDHCP_CHECK_ADDRESS_CONFLICT      ( 1 )
+#define ipconfigARP_USE_CLASH_DETECTION          ( 1 )
+
+/* Wait for ready sockets through a ready list. */
+#define ipconfigSUPPORT_EPOLL                    ( 1 )
+
+/* Publish the indexes of stream buffers with C11 acquire/release atomics. */
+#define ipconfigSTREAM_BUFFER_USE_ATOMICS        ( 1 )
+
+/* Mirror the start of stream buffers, so that a segment is always contiguous. */
+#define ipconfigSTREAM_BUFFER_MIRROR_SIZE        ( ipconfigTCP_MSS )
+
+/* Check received packets in two RX worker tasks. */
+#define ipconfigIP_RX_WORKER_COUNT               ( 2 )
+
+/* Handle control events before a burst of received packets. */
+#define ipconfigIP_EVENT_CLASSES                 ( 1 )
+
+/* Wake up the owners of TCP sockets less often while streaming. */
+#define ipconfigSOCKET_WAKE_COALESCING           ( 1 )
+
+/* Wake up tasks blocked on a socket with a task notification. */
+#define ipconfigSOCKET_USES_NOTIFY               ( 1 )
+
+/* Take sockets and streams from static pools, and provide FreeRTOS_socket_static(). */
+#define ipconfigSOCKET_POOL                      ( 1 )
+#define ipconfigSUPPORT_STATIC_SOCKETS           ( 1 )
+
+/* Only create a child socket when the TCP handshake has completed. */
+#define ipconfigTCP_SYN_QUEUE                    ( 1 )
+
+/* Remember closed connections in a compact TIME_WAIT table. */
+#define ipconfigTCP_TIME_WAIT_TABLE              ( 1 )
+
 
 #define portINLINE                               __inline
 
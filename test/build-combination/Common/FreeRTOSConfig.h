@@ -57,6 +57,7 @@
 #define configQUEUE_REGISTRY_SIZE                  0
 #define configUSE_APPLICATION_TASK_TAG             1
 #define configUSE_COUNTING_SEMAPHORES              1
+#define configUSE_QUEUE_SETS                       1
 #define configUSE_ALTERNATIVE_API                  0
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS    3      /* FreeRTOS+FAT requires 2 pointers if a CWD is supported. */
 #define configRECORD_STACK_HIGH_ADDRESS            1
@@ -76,6 +77,9 @@
 /* Event group related definitions. */
 #define configUSE_EVENT_GROUPS                     1
 
+/* Index 1 of the notification array is used by ipconfigSOCKET_USES_NOTIFY. */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES      2
+
 /* Run time stats gathering definitions. */
 unsigned long ulGetRunTimeCounterValue( void );
 void vConfigureTimerForRunTimeStats( void );
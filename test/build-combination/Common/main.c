@@ -136,9 +136,10 @@ void vApplicationIPNetworkEventHook( eIPCallbackEvent_t eNetworkEvent )
 
 /*-----------------------------------------------------------*/
 
-#if ( ( ipconfigUSE_LLMNR != 0 ) || \
-    ( ipconfigUSE_NBNS != 0 ) ||    \
-    ( ipconfigDHCP_REGISTER_HOSTNAME == 1 ) )
+#if ( ( ipconfigUSE_LLMNR != 0 ) ||              \
+    ( ipconfigUSE_NBNS != 0 ) ||                 \
+    ( ipconfigDHCP_REGISTER_HOSTNAME == 1 ) ||   \
+    ( ipconfigUSE_MDNS != 0 ) )
 
     const char * pcApplicationHostnameHook( void )
     {
@@ -147,10 +148,10 @@ void vApplicationIPNetworkEventHook( eIPCallbackEvent_t eNetworkEvent )
         return mainHOST_NAME;
     }
 
-#endif /* if ( ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 ) || ( ipconfigDHCP_REGISTER_HOSTNAME == 1 ) ) */
+#endif /* if ( ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 ) || ( ipconfigDHCP_REGISTER_HOSTNAME == 1 ) || ( ipconfigUSE_MDNS != 0 ) ) */
 /*-----------------------------------------------------------*/
 
-#if ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 )
+#if ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 ) || ( ipconfigUSE_MDNS != 0 )
 
     BaseType_t xApplicationDNSQueryHook( const char * pcName )
     {
@@ -175,7 +176,7 @@ void vApplicationIPNetworkEventHook( eIPCallbackEvent_t eNetworkEvent )
         return xReturn;
     }
 
-#endif /* if ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 ) */
+#endif /* if ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 ) || ( ipconfigUSE_MDNS != 0 ) */
 /*-----------------------------------------------------------*/
 
 void vApplicationIdleHook( void )
@@ -348,6 +349,19 @@ BaseType_t xNetworkInterfaceInitialise( void )
     }
 #endif
 
+#if ( ipconfigUSE_DHCP != 0 ) && ( ipconfigDHCP_STORE_LEASE != 0 )
+    void vApplicationDHCPSaveLeaseHook( const DHCPLease_t * pxLease )
+    {
+        /* Provide a stub for this function. */
+    }
+
+    BaseType_t xApplicationDHCPRestoreLeaseHook( DHCPLease_t * pxLease )
+    {
+        /* Provide a stub for this function. */
+        return pdFALSE;
+    }
+#endif
+
 void vApplicationPingReplyHook( ePingReplyStatus_t eStatus,
                                 uint16_t usIdentifier )
 {
@@ -24,10 +24,10 @@
 * Signature of function under test
 ****************************************************************/
 
-size_t prvReadNameField( const uint8_t * pucByte,
-                         size_t uxRemainingBytes,
-                         char * pcName,
-                         size_t uxDestLen );
+BaseType_t prvDNSCopyName( const DNSReader_t * pxReader,
+                           size_t uxNameOffset,
+                           char * pcName,
+                           size_t uxDestLen );
 
 /****************************************************************
 * The function under test is not defined in all configurations
@@ -35,25 +35,25 @@ size_t prvReadNameField( const uint8_t * pucByte,
 
 #if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
 
-/* prvReadNameField is defined in this configuration */
+/* prvDNSCopyName is defined in this configuration */
 
 #else
 
-/* prvReadNameField is not defined in this configuration, stub it. */
+/* prvDNSCopyName is not defined in this configuration, stub it. */
 
-    size_t prvReadNameField( const uint8_t * pucByte,
-                             size_t uxRemainingBytes,
-                             char * pcName,
-                             size_t uxDestLen )
+    BaseType_t prvDNSCopyName( const DNSReader_t * pxReader,
+                               size_t uxNameOffset,
+                               char * pcName,
+                               size_t uxDestLen )
     {
-        return 0;
+        return pdFAIL;
     }
 
 #endif /* if ( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 ) */
 
 
 /****************************************************************
-* Proof of prvReadNameField function contract
+* Proof of prvDNSCopyName function contract
 ****************************************************************/
 
 void harness()
@@ -66,37 +66,34 @@ void harness()
     __CPROVER_assert( NAME_SIZE >= 4,
                       "NAME_SIZE >= 4 required for good coverage." );
 
-
-    size_t uxRemainingBytes;
+    DNSReader_t xReader;
+    size_t uxNameOffset;
     size_t uxDestLen;
+    BaseType_t xResult;
 
-    uint8_t * pucByte = malloc( uxRemainingBytes );
+    xReader.pucMessage = malloc( xReader.uxLength );
     char * pcName = malloc( uxDestLen );
 
     /* Preconditions */
 
-    __CPROVER_assume( uxRemainingBytes < CBMC_MAX_OBJECT_SIZE );
+    __CPROVER_assume( xReader.uxLength < CBMC_MAX_OBJECT_SIZE );
+    __CPROVER_assume( xReader.uxLength <= NETWORK_BUFFER_SIZE );
     __CPROVER_assume( uxDestLen < CBMC_MAX_OBJECT_SIZE );
-
-    __CPROVER_assume( uxRemainingBytes <= NETWORK_BUFFER_SIZE );
     __CPROVER_assume( uxDestLen <= NAME_SIZE );
 
-    __CPROVER_assume( pucByte != NULL );
+    __CPROVER_assume( xReader.pucMessage != NULL );
     __CPROVER_assume( pcName != NULL );
 
-    /* Avoid overflow on uxSourceLen - 1U with uxSourceLen == uxRemainingBytes */
-    /*__CPROVER_assume(uxRemainingBytes > 0); */
-
-    /* Avoid overflow on uxDestLen - 1U */
-    __CPROVER_assume( uxDestLen > 0 );
-
-    size_t index = prvReadNameField( pucByte,
-                                     uxRemainingBytes,
-                                     pcName,
-                                     uxDestLen );
+    xResult = prvDNSCopyName( &xReader,
+                              uxNameOffset,
+                              pcName,
+                              uxDestLen );
 
     /* Postconditions */
 
-    __CPROVER_assert( index <= uxDestLen + 1 && index <= uxRemainingBytes,
-                      "prvReadNamefield: index <= uxDestLen+1" );
+    if( xResult == pdPASS )
+    {
+        __CPROVER_assert( strlen( pcName ) < uxDestLen,
+                          "prvDNSCopyName: the name fits in pcName" );
+    }
 }
@@ -24,11 +24,10 @@
 * Signature of function under test
 ****************************************************************/
 
-size_t prvSkipNameField( const uint8_t * pucByte,
-                         size_t uxLength );
+BaseType_t prvDNSReadName( DNSReader_t * pxReader );
 
 /****************************************************************
-* Proof of prvSkipNameField function contract
+* Proof of prvDNSReadName function contract
 ****************************************************************/
 
 void harness()
@@ -36,19 +35,36 @@ void harness()
     __CPROVER_assert( NETWORK_BUFFER_SIZE < CBMC_MAX_OBJECT_SIZE,
                       "NETWORK_BUFFER_SIZE < CBMC_MAX_OBJECT_SIZE" );
 
-    size_t uxLength;
-    uint8_t * pucByte = malloc( uxLength );
+    DNSReader_t xReader;
+    size_t uxStart;
+    BaseType_t xResult;
+
+    xReader.pucMessage = malloc( xReader.uxLength );
 
     /* Preconditions */
 
-    __CPROVER_assume( uxLength < CBMC_MAX_OBJECT_SIZE );
-    __CPROVER_assume( uxLength <= NETWORK_BUFFER_SIZE );
-    __CPROVER_assume( pucByte != NULL );
+    __CPROVER_assume( xReader.uxLength < CBMC_MAX_OBJECT_SIZE );
+    __CPROVER_assume( xReader.uxLength <= NETWORK_BUFFER_SIZE );
+    __CPROVER_assume( xReader.uxOffset <= xReader.uxLength );
+    __CPROVER_assume( xReader.pucMessage != NULL );
+
+    uxStart = xReader.uxOffset;
 
-    size_t index = prvSkipNameField( pucByte, uxLength );
+    xResult = prvDNSReadName( &xReader );
 
     /* Postconditions */
 
-    __CPROVER_assert( index <= uxLength,
-                      "prvSkipNameField: index <= uxLength" );
+    __CPROVER_assert( xReader.uxOffset <= xReader.uxLength,
+                      "prvDNSReadName: uxOffset <= uxLength" );
+
+    if( xResult == pdPASS )
+    {
+        __CPROVER_assert( xReader.uxOffset > uxStart,
+                          "prvDNSReadName: a name was read" );
+    }
+    else
+    {
+        __CPROVER_assert( xReader.uxOffset == uxStart,
+                          "prvDNSReadName: nothing was read" );
+    }
 }
@@ -29,81 +29,79 @@ uint32_t prvParseDNSReply( uint8_t * pucUDPPayloadBuffer,
                            BaseType_t xExpected );
 
 /****************************************************************
-* Abstraction of prvReadNameField proved in ReadNameField
+* Abstraction of prvDNSReadRecord, prvDNSReadName is proved in DNSReadName
 ****************************************************************/
 
-size_t prvReadNameField( const uint8_t * pucByte,
-                         size_t uxRemainingBytes,
-                         char * pcName,
-                         size_t uxDestLen )
+BaseType_t prvDNSReadRecord( DNSReader_t * pxReader,
+                             DNSRecord_t * pxRecord,
+                             BaseType_t xIsQuestion )
 {
     __CPROVER_assert( NETWORK_BUFFER_SIZE < CBMC_MAX_OBJECT_SIZE,
                       "NETWORK_BUFFER_SIZE < CBMC_MAX_OBJECT_SIZE" );
-    __CPROVER_assert( NAME_SIZE < CBMC_MAX_OBJECT_SIZE,
-                      "NAME_SIZE < CBMC_MAX_OBJECT_SIZE" );
-    __CPROVER_assert( NAME_SIZE >= 4,
-                      "NAME_SIZE >= 4 required for good coverage." );
-
 
     /* Preconditions */
-    __CPROVER_assert( uxRemainingBytes < CBMC_MAX_OBJECT_SIZE,
-                      "ReadNameField: uxRemainingBytes < CBMC_MAX_OBJECT_SIZE)" );
-    __CPROVER_assert( uxDestLen < CBMC_MAX_OBJECT_SIZE,
-                      "ReadNameField: uxDestLen < CBMC_MAX_OBJECT_SIZE)" );
-
-    __CPROVER_assert( uxRemainingBytes <= NETWORK_BUFFER_SIZE,
-                      "ReadNameField: uxRemainingBytes <= NETWORK_BUFFER_SIZE)" );
-
-    /* This precondition in the function contract for prvReadNameField
-     * fails because prvCheckOptions called prvReadNameField with the
-     * constant value 254.
-     * __CPROVER_assert(uxDestLen <= NAME_SIZE,
-     *       "ReadNameField: uxDestLen <= NAME_SIZE)");
-     */
-
-    __CPROVER_assert( pucByte != NULL,
-                      "ReadNameField:  pucByte != NULL )" );
-    __CPROVER_assert( pcName != NULL,
-                      "ReadNameField:  pcName != NULL )" );
-
-    __CPROVER_assert( uxDestLen > 0,
-                      "ReadNameField: uxDestLen > 0)" );
+    __CPROVER_assert( pxReader != NULL,
+                      "DNSReadRecord: pxReader != NULL" );
+    __CPROVER_assert( pxRecord != NULL,
+                      "DNSReadRecord: pxRecord != NULL" );
+    __CPROVER_assert( pxReader->uxLength <= NETWORK_BUFFER_SIZE,
+                      "DNSReadRecord: uxLength <= NETWORK_BUFFER_SIZE" );
+    __CPROVER_assert( pxReader->uxOffset <= pxReader->uxLength,
+                      "DNSReadRecord: uxOffset <= uxLength" );
 
     /* Return value */
-    size_t index;
-
-    /* Postconditions */
-    __CPROVER_assume( index <= uxDestLen + 1 && index <= uxRemainingBytes );
-
-    return index;
+    BaseType_t xResult;
+    size_t uxOffset;
+    DNSRecord_t xRecord;
+
+    /* Postconditions: a question takes at least 5 bytes, a resource record
+     * at least 11 bytes, and the data of a record is within the message. */
+    if( xResult == pdPASS )
+    {
+        __CPROVER_assume( uxOffset <= pxReader->uxLength );
+        __CPROVER_assume( uxOffset >= pxReader->uxOffset + ( ( xIsQuestion != pdFALSE ) ? 5U : 11U ) );
+        __CPROVER_assume( xRecord.uxNameOffset == pxReader->uxOffset );
+        __CPROVER_assume( xRecord.uxDataOffset + xRecord.usDataLength == uxOffset );
+
+        *pxRecord = xRecord;
+        pxReader->uxOffset = uxOffset;
+    }
+
+    return xResult;
 }
 
 /****************************************************************
-* Abstraction of prvSkipNameField proved in SkipNameField
+* Abstraction of prvDNSCopyName proved in DNSCopyName
 ****************************************************************/
 
-size_t prvSkipNameField( const uint8_t * pucByte,
-                         size_t uxLength )
+BaseType_t prvDNSCopyName( const DNSReader_t * pxReader,
+                           size_t uxNameOffset,
+                           char * pcName,
+                           size_t uxDestLen )
 {
-    __CPROVER_assert( NETWORK_BUFFER_SIZE < CBMC_MAX_OBJECT_SIZE,
-                      "NETWORK_BUFFER_SIZE < CBMC_MAX_OBJECT_SIZE" );
-
+    __CPROVER_assert( NAME_SIZE < CBMC_MAX_OBJECT_SIZE,
+                      "NAME_SIZE < CBMC_MAX_OBJECT_SIZE" );
+    __CPROVER_assert( NAME_SIZE >= 4,
+                      "NAME_SIZE >= 4 required for good coverage." );
 
     /* Preconditions */
-    __CPROVER_assert( uxLength < CBMC_MAX_OBJECT_SIZE,
-                      "SkipNameField: uxLength < CBMC_MAX_OBJECT_SIZE)" );
-    __CPROVER_assert( uxLength <= NETWORK_BUFFER_SIZE,
-                      "SkipNameField: uxLength <= NETWORK_BUFFER_SIZE)" );
-    __CPROVER_assert( pucByte != NULL,
-                      "SkipNameField: pucByte != NULL)" );
+    __CPROVER_assert( pxReader != NULL,
+                      "DNSCopyName: pxReader != NULL" );
+    __CPROVER_assert( pcName != NULL,
+                      "DNSCopyName: pcName != NULL" );
+    __CPROVER_assert( uxDestLen > 0,
+                      "DNSCopyName: uxDestLen > 0" );
 
     /* Return value */
-    size_t index;
+    BaseType_t xResult;
 
     /* Postconditions */
-    __CPROVER_assume( index <= uxLength );
+    if( xResult == pdPASS )
+    {
+        pcName[ uxDestLen - 1U ] = '\0';
+    }
 
-    return index;
+    return xResult;
 }
 
 /****************************************************************
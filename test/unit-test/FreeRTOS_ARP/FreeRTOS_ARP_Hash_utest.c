@@ -0,0 +1,505 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_task.h"
+#include "mock_NetworkBufferManagement.h"
+
+#include "FreeRTOS_ARP.h"
+
+#include "FreeRTOS_ARP_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigUSE_ARP_HASH_TABLE defined as
+ * non-zero, see ut.cmake. */
+
+extern ARPCacheRow_t xARPCache[ ipconfigARP_CACHE_ENTRIES ];
+
+/* The first IP-address that is used in this file.  The others follow it. */
+#define hashFIRST_IP_ADDRESS    0xC0A80101U
+
+/* The events that were sent to the IP-task by prvSendEventStub(). */
+static IPStackEvent_t xSentEvents[ ipconfigARP_PENDING_QUEUE_LENGTH ];
+
+/* The number of events in xSentEvents[]. */
+static BaseType_t xSentEventCount;
+
+/*
+ * @brief Empty the ARP cache, including the hash tables and the list that is
+ *        ordered by the time of refreshing.
+ */
+static void prvResetARPCache( void )
+{
+    vARPClearCache();
+    xSentEventCount = 0;
+}
+
+/*
+ * @brief Make a MAC-address whose last byte is 'ucLast'.
+ */
+static void prvSetMACAddress( MACAddress_t * pxMACAddress,
+                              uint8_t ucLast )
+{
+    static const uint8_t ucBytes[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x00 };
+
+    memcpy( pxMACAddress->ucBytes, ucBytes, sizeof( ucBytes ) );
+    pxMACAddress->ucBytes[ ipMAC_ADDRESS_LENGTH_BYTES - 1 ] = ucLast;
+}
+
+/*
+ * @brief Store the events that are sent to the IP-task.
+ */
+static BaseType_t prvSendEventStub( const IPStackEvent_t * pxEvent,
+                                    TickType_t uxTimeout,
+                                    int callback_count )
+{
+    ( void ) callback_count;
+
+    TEST_ASSERT_EQUAL( 0, uxTimeout );
+    TEST_ASSERT_LESS_THAN( ipconfigARP_PENDING_QUEUE_LENGTH, xSentEventCount );
+
+    xSentEvents[ xSentEventCount ] = *pxEvent;
+    xSentEventCount++;
+
+    return pdPASS;
+}
+
+/*
+ * @brief Store the event that FreeRTOS_ClearARP() sends to the IP-task, which
+ *        must wait until there is space in the queue.
+ */
+static BaseType_t prvClearEventStub( const IPStackEvent_t * pxEvent,
+                                     TickType_t uxTimeout,
+                                     int callback_count )
+{
+    ( void ) callback_count;
+
+    TEST_ASSERT_EQUAL( portMAX_DELAY, uxTimeout );
+
+    xSentEvents[ xSentEventCount ] = *pxEvent;
+    xSentEventCount++;
+
+    return pdPASS;
+}
+
+/*
+ * @brief An entry that was added can be found by IP-address and by MAC-address.
+ */
+void test_vARPRefreshCacheEntry_Hash_NewEntryIsFound( void )
+{
+    MACAddress_t xMACAddress, xFoundMAC;
+    uint32_t ulIPAddress = 0U;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( hashFIRST_IP_ADDRESS ) );
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( hashFIRST_IP_ADDRESS + 1U ) );
+
+    TEST_ASSERT_EQUAL( eARPCacheHit, eARPGetCacheEntryByMac( &xMACAddress, &ulIPAddress ) );
+    TEST_ASSERT_EQUAL_HEX32( hashFIRST_IP_ADDRESS, ulIPAddress );
+
+    /* Ask for the MAC-address of a device on the local network. */
+    *ipLOCAL_IP_ADDRESS_POINTER = hashFIRST_IP_ADDRESS + 0x10U;
+    ulIPAddress = hashFIRST_IP_ADDRESS;
+    xIsIPv4Multicast_ExpectAndReturn( hashFIRST_IP_ADDRESS, pdFALSE );
+
+    TEST_ASSERT_EQUAL( eARPCacheHit, eARPGetCacheEntry( &ulIPAddress, &xFoundMAC ) );
+    TEST_ASSERT_EQUAL_MEMORY( xMACAddress.ucBytes, xFoundMAC.ucBytes, sizeof( xFoundMAC.ucBytes ) );
+
+    *ipLOCAL_IP_ADDRESS_POINTER = 0U;
+}
+
+/*
+ * @brief Two IP-addresses that fall in the same bucket are both found, also
+ *        after the other one has been removed.
+ */
+void test_vARPRefreshCacheEntry_Hash_SameBucket( void )
+{
+    MACAddress_t xMACAddress1, xMACAddress2;
+    /* The hash of an IP-address does not use bit 6 of the last byte. */
+    uint32_t ulIPAddress1 = hashFIRST_IP_ADDRESS;
+    uint32_t ulIPAddress2 = hashFIRST_IP_ADDRESS ^ 0x40U;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress1, 0x01 );
+    prvSetMACAddress( &xMACAddress2, 0x02 );
+
+    vARPRefreshCacheEntry( &xMACAddress1, ulIPAddress1 );
+    vARPRefreshCacheEntry( &xMACAddress2, ulIPAddress2 );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( ulIPAddress1 ) );
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( ulIPAddress2 ) );
+
+    /* Remove the entry that was added last, it is the first in the bucket. */
+    TEST_ASSERT_EQUAL_HEX32( ulIPAddress2, ulARPRemoveCacheEntryByMac( &xMACAddress2 ) );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( ulIPAddress1 ) );
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( ulIPAddress2 ) );
+    TEST_ASSERT_EQUAL_HEX32( 0U, ulARPRemoveCacheEntryByMac( &xMACAddress2 ) );
+
+    /* Add it again, and now remove the entry that is last in the bucket. */
+    vARPRefreshCacheEntry( &xMACAddress2, ulIPAddress2 );
+    TEST_ASSERT_EQUAL_HEX32( ulIPAddress1, ulARPRemoveCacheEntryByMac( &xMACAddress1 ) );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( ulIPAddress1 ) );
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( ulIPAddress2 ) );
+}
+
+/*
+ * @brief When the cache is full, a new entry replaces the one that was
+ *        refreshed least recently.
+ */
+void test_vARPRefreshCacheEntry_Hash_ReplacesLeastRecentlyRefreshed( void )
+{
+    MACAddress_t xMACAddress;
+    uint32_t ulIndex;
+
+    prvResetARPCache();
+
+    for( ulIndex = 0U; ulIndex < ( uint32_t ) ipconfigARP_CACHE_ENTRIES; ulIndex++ )
+    {
+        prvSetMACAddress( &xMACAddress, ( uint8_t ) ( ulIndex + 1U ) );
+        vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS + ulIndex );
+    }
+
+    /* The first entry is refreshed, the second one is now the oldest. */
+    prvSetMACAddress( &xMACAddress, 1U );
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+
+    prvSetMACAddress( &xMACAddress, 0x80U );
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS + 0x80U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( hashFIRST_IP_ADDRESS ) );
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( hashFIRST_IP_ADDRESS + 1U ) );
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( hashFIRST_IP_ADDRESS + 0x80U ) );
+
+    for( ulIndex = 2U; ulIndex < ( uint32_t ) ipconfigARP_CACHE_ENTRIES; ulIndex++ )
+    {
+        TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( hashFIRST_IP_ADDRESS + ulIndex ) );
+    }
+}
+
+/*
+ * @brief A known MAC-address that shows up with a new IP-address takes its row
+ *        along, the old IP-address is forgotten.
+ */
+void test_vARPRefreshCacheEntry_Hash_MACAddressMoves( void )
+{
+    MACAddress_t xMACAddress;
+    uint32_t ulIPAddress = 0U;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS + 1U );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( hashFIRST_IP_ADDRESS ) );
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( hashFIRST_IP_ADDRESS + 1U ) );
+
+    TEST_ASSERT_EQUAL( eARPCacheHit, eARPGetCacheEntryByMac( &xMACAddress, &ulIPAddress ) );
+    TEST_ASSERT_EQUAL_HEX32( hashFIRST_IP_ADDRESS + 1U, ulIPAddress );
+}
+
+/*
+ * @brief A reserved entry makes a look-up return eCantSendPacket, until the
+ *        reply arrives.
+ */
+void test_vARPRefreshCacheEntry_Hash_ReservedEntry( void )
+{
+    MACAddress_t xMACAddress, xFoundMAC;
+    uint32_t ulIPAddress = hashFIRST_IP_ADDRESS;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+    *ipLOCAL_IP_ADDRESS_POINTER = hashFIRST_IP_ADDRESS + 0x10U;
+
+    vARPRefreshCacheEntry( NULL, hashFIRST_IP_ADDRESS );
+
+    xIsIPv4Multicast_ExpectAndReturn( hashFIRST_IP_ADDRESS, pdFALSE );
+    TEST_ASSERT_EQUAL( eCantSendPacket, eARPGetCacheEntry( &ulIPAddress, &xFoundMAC ) );
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( hashFIRST_IP_ADDRESS ) );
+
+    /* The reply arrives. */
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+
+    xIsIPv4Multicast_ExpectAndReturn( hashFIRST_IP_ADDRESS, pdFALSE );
+    TEST_ASSERT_EQUAL( eARPCacheHit, eARPGetCacheEntry( &ulIPAddress, &xFoundMAC ) );
+    TEST_ASSERT_EQUAL_MEMORY( xMACAddress.ucBytes, xFoundMAC.ucBytes, sizeof( xFoundMAC.ucBytes ) );
+
+    *ipLOCAL_IP_ADDRESS_POINTER = 0U;
+}
+
+/*
+ * @brief A packet can only wait for an address that has an outstanding ARP
+ *        request.
+ */
+void test_xARPQueuePendingPacket_NoOutstandingRequest( void )
+{
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    MACAddress_t xMACAddress;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+
+    /* The address is not in the cache. */
+    TEST_ASSERT_EQUAL( pdFALSE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &xNetworkBuffer, pdTRUE ) );
+
+    /* The address is known already. */
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+    TEST_ASSERT_EQUAL( pdFALSE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &xNetworkBuffer, pdTRUE ) );
+}
+
+/*
+ * @brief The packets that wait for an ARP reply are passed to the IP-task when
+ *        the reply arrives, with an event that depends on their direction.
+ */
+void test_xARPQueuePendingPacket_FlushedOnReply( void )
+{
+    NetworkBufferDescriptor_t xOutgoing, xIncoming;
+    MACAddress_t xMACAddress;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+
+    vARPRefreshCacheEntry( NULL, hashFIRST_IP_ADDRESS );
+
+    xTaskGetTickCount_ExpectAndReturn( 10 );
+    vIPSetARPResolutionTimerEnableState_Expect( pdTRUE );
+    TEST_ASSERT_EQUAL( pdTRUE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &xOutgoing, pdTRUE ) );
+
+    vIPSetARPResolutionTimerEnableState_Expect( pdTRUE );
+    TEST_ASSERT_EQUAL( pdTRUE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &xIncoming, pdFALSE ) );
+
+    xSendEventStructToIPTask_Stub( prvSendEventStub );
+
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+
+    TEST_ASSERT_EQUAL( 2, xSentEventCount );
+    TEST_ASSERT_EQUAL( eStackTxEvent, xSentEvents[ 0 ].eEventType );
+    TEST_ASSERT_EQUAL_PTR( &xOutgoing, xSentEvents[ 0 ].pvData );
+    TEST_ASSERT_EQUAL( eNetworkRxEvent, xSentEvents[ 1 ].eEventType );
+    TEST_ASSERT_EQUAL_PTR( &xIncoming, xSentEvents[ 1 ].pvData );
+
+    /* Nothing is waiting any more. */
+    xTaskGetTickCount_ExpectAndReturn( 20 );
+    TEST_ASSERT_EQUAL( pdFALSE, xARPCheckPendingPackets( 0U ) );
+}
+
+/*
+ * @brief A packet that can not be passed to the IP-task is released.
+ */
+void test_xARPQueuePendingPacket_SendEventFails( void )
+{
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    MACAddress_t xMACAddress;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+
+    vARPRefreshCacheEntry( NULL, hashFIRST_IP_ADDRESS );
+
+    xTaskGetTickCount_ExpectAndReturn( 10 );
+    vIPSetARPResolutionTimerEnableState_Expect( pdTRUE );
+    TEST_ASSERT_EQUAL( pdTRUE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &xNetworkBuffer, pdTRUE ) );
+
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdFAIL );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer );
+
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+}
+
+/*
+ * @brief The queue of an entry holds at most ipconfigARP_PENDING_QUEUE_LENGTH
+ *        packets.
+ */
+void test_xARPQueuePendingPacket_QueueFull( void )
+{
+    NetworkBufferDescriptor_t xNetworkBuffers[ ipconfigARP_PENDING_QUEUE_LENGTH + 1 ];
+    UBaseType_t uxIndex;
+
+    prvResetARPCache();
+
+    vARPRefreshCacheEntry( NULL, hashFIRST_IP_ADDRESS );
+
+    xTaskGetTickCount_ExpectAndReturn( 10 );
+
+    for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigARP_PENDING_QUEUE_LENGTH; uxIndex++ )
+    {
+        vIPSetARPResolutionTimerEnableState_Expect( pdTRUE );
+        TEST_ASSERT_EQUAL( pdTRUE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &( xNetworkBuffers[ uxIndex ] ), pdTRUE ) );
+    }
+
+    TEST_ASSERT_EQUAL( pdFALSE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &( xNetworkBuffers[ uxIndex ] ), pdTRUE ) );
+
+    /* Clearing the cache releases the waiting packets. */
+    for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigARP_PENDING_QUEUE_LENGTH; uxIndex++ )
+    {
+        vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ uxIndex ] ) );
+    }
+
+    vARPClearCache();
+
+    xTaskGetTickCount_ExpectAndReturn( 20 );
+    TEST_ASSERT_EQUAL( pdFALSE, xARPCheckPendingPackets( 0U ) );
+}
+
+/*
+ * @brief Packets that waited too long for a reply are released.
+ */
+void test_xARPCheckPendingPackets_Timeout( void )
+{
+    NetworkBufferDescriptor_t xNetworkBuffer1, xNetworkBuffer2;
+
+    prvResetARPCache();
+
+    vARPRefreshCacheEntry( NULL, hashFIRST_IP_ADDRESS );
+    vARPRefreshCacheEntry( NULL, hashFIRST_IP_ADDRESS + 1U );
+
+    xTaskGetTickCount_ExpectAndReturn( 10 );
+    vIPSetARPResolutionTimerEnableState_Expect( pdTRUE );
+    TEST_ASSERT_EQUAL( pdTRUE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &xNetworkBuffer1, pdTRUE ) );
+
+    xTaskGetTickCount_ExpectAndReturn( 12 );
+    vIPSetARPResolutionTimerEnableState_Expect( pdTRUE );
+    TEST_ASSERT_EQUAL( pdTRUE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS + 1U, &xNetworkBuffer2, pdFALSE ) );
+
+    /* Nothing has waited long enough. */
+    xTaskGetTickCount_ExpectAndReturn( 15 );
+    TEST_ASSERT_EQUAL( pdTRUE, xARPCheckPendingPackets( 10U ) );
+
+    /* Only the first packet has waited long enough. */
+    xTaskGetTickCount_ExpectAndReturn( 21 );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer1 );
+    TEST_ASSERT_EQUAL( pdTRUE, xARPCheckPendingPackets( 10U ) );
+
+    xTaskGetTickCount_ExpectAndReturn( 22 );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer2 );
+    TEST_ASSERT_EQUAL( pdFALSE, xARPCheckPendingPackets( 10U ) );
+}
+
+/*
+ * @brief The packets that wait for an entry that expires are released.
+ */
+void test_vARPAgeCache_Hash_ExpiredEntryReleasesPackets( void )
+{
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    BaseType_t xRetry;
+
+    prvResetARPCache();
+
+    vARPRefreshCacheEntry( NULL, hashFIRST_IP_ADDRESS );
+
+    xTaskGetTickCount_ExpectAndReturn( 10 );
+    vIPSetARPResolutionTimerEnableState_Expect( pdTRUE );
+    TEST_ASSERT_EQUAL( pdTRUE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &xNetworkBuffer, pdTRUE ) );
+
+    /* Every period an ARP request is sent again, this test does not look at
+     * those requests. */
+    pxGetNetworkBufferWithDescriptor_IgnoreAndReturn( NULL );
+
+    for( xRetry = 1; xRetry < ( BaseType_t ) ipconfigMAX_ARP_RETRANSMISSIONS; xRetry++ )
+    {
+        xTaskGetTickCount_ExpectAndReturn( 100 );
+        vARPAgeCache();
+
+        /* The packet is still waiting. */
+        xTaskGetTickCount_ExpectAndReturn( 100 );
+        TEST_ASSERT_EQUAL( pdTRUE, xARPCheckPendingPackets( 1000U ) );
+    }
+
+    /* The last period clears the entry. */
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer );
+    xTaskGetTickCount_ExpectAndReturn( 100 );
+    vARPAgeCache();
+
+    xTaskGetTickCount_ExpectAndReturn( 100 );
+    TEST_ASSERT_EQUAL( pdFALSE, xARPCheckPendingPackets( 1000U ) );
+
+    /* The reservation is gone, so no packet can wait for it. */
+    TEST_ASSERT_EQUAL( pdFALSE, xARPQueuePendingPacket( hashFIRST_IP_ADDRESS, &xNetworkBuffer, pdTRUE ) );
+}
+
+/*
+ * @brief When called from the IP-task, FreeRTOS_ClearARP() clears the cache and
+ *        its hash tables immediately.
+ */
+void test_FreeRTOS_ClearARP_Hash_FromIPTask( void )
+{
+    MACAddress_t xMACAddress;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdTRUE );
+    xIsCallingFromIPTask_ExpectAndReturn( pdTRUE );
+
+    FreeRTOS_ClearARP();
+
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( hashFIRST_IP_ADDRESS ) );
+}
+
+/*
+ * @brief When called from another task, FreeRTOS_ClearARP() leaves the cache
+ *        alone and asks the IP-task to clear it.
+ */
+void test_FreeRTOS_ClearARP_Hash_OtherTask( void )
+{
+    MACAddress_t xMACAddress;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+    vARPRefreshCacheEntry( &xMACAddress, hashFIRST_IP_ADDRESS );
+
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdTRUE );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xSendEventStructToIPTask_Stub( prvClearEventStub );
+
+    FreeRTOS_ClearARP();
+    TEST_ASSERT_EQUAL( 1, xSentEventCount );
+    TEST_ASSERT_EQUAL( eARPClearEvent, xSentEvents[ 0 ].eEventType );
+
+    /* The IP-task will clear the cache when it handles the event. */
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( hashFIRST_IP_ADDRESS ) );
+
+    vARPClearCache();
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( hashFIRST_IP_ADDRESS ) );
+}
@@ -0,0 +1,295 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_task.h"
+#include "mock_NetworkBufferManagement.h"
+
+#include "FreeRTOS_ARP.h"
+
+#include "FreeRTOS_ARP_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigUSE_ARP_HASH_TABLE and
+ * ipconfigUSE_ARP_TIMER_WHEEL defined as non-zero, see ut.cmake. */
+
+/* The first IP-address that is used in this file.  The others follow it. */
+#define wheelFIRST_IP_ADDRESS    0xC0A80101U
+
+/* The number of periods after which a valid entry is visited for the first
+ * time, when no jitter is applied. */
+#define wheelFIRST_VISIT         ( ipconfigMAX_ARP_AGE - 3 )
+
+/* The number of ARP requests that were sent, counted by prvGetBufferStub(). */
+static BaseType_t xRequestCount;
+
+/*
+ * @brief Count the network buffers that are asked for by
+ *        FreeRTOS_OutputARPRequest().  NULL is returned, so nothing is sent.
+ */
+static NetworkBufferDescriptor_t * prvGetBufferStub( size_t xRequestedSizeBytes,
+                                                     TickType_t xBlockTimeTicks,
+                                                     int callback_count )
+{
+    ( void ) callback_count;
+
+    TEST_ASSERT_EQUAL( sizeof( ARPPacket_t ), xRequestedSizeBytes );
+    TEST_ASSERT_EQUAL( 0, xBlockTimeTicks );
+
+    xRequestCount++;
+
+    return NULL;
+}
+
+/*
+ * @brief Call vARPAgeCache() 'xPeriods' times.
+ */
+static void prvAgeCache( BaseType_t xPeriods )
+{
+    BaseType_t xPeriod;
+
+    for( xPeriod = 0; xPeriod < xPeriods; xPeriod++ )
+    {
+        vARPAgeCache();
+    }
+}
+
+/*
+ * @brief Empty the ARP cache and the timer wheel, and reset the number of ARP
+ *        requests.
+ */
+static void prvResetARPCache( void )
+{
+    vARPClearCache();
+
+    /* The clock does not move, so only the first call to vARPAgeCache() in
+     * this file sends a gratuitous ARP. */
+    xTaskGetTickCount_IgnoreAndReturn( 1000 );
+    pxGetNetworkBufferWithDescriptor_Stub( prvGetBufferStub );
+
+    /* Let the gratuitous ARP be sent, if it hasn't been sent yet. */
+    prvAgeCache( 1 );
+    xRequestCount = 0;
+}
+
+/*
+ * @brief Make a MAC-address whose last byte is 'ucLast'.
+ */
+static void prvSetMACAddress( MACAddress_t * pxMACAddress,
+                              uint8_t ucLast )
+{
+    static const uint8_t ucBytes[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x00 };
+
+    memcpy( pxMACAddress->ucBytes, ucBytes, sizeof( ucBytes ) );
+    pxMACAddress->ucBytes[ ipMAC_ADDRESS_LENGTH_BYTES - 1 ] = ucLast;
+}
+
+/*
+ * @brief Age the cache until an ARP request is sent.
+ *
+ * @return The number of periods that passed.
+ */
+static BaseType_t prvAgeUntilRequest( void )
+{
+    BaseType_t xPeriods = 0;
+    BaseType_t xCount = xRequestCount;
+
+    while( ( xRequestCount == xCount ) && ( xPeriods <= ipconfigMAX_ARP_AGE ) )
+    {
+        prvAgeCache( 1 );
+        xPeriods++;
+    }
+
+    return xPeriods;
+}
+
+/*
+ * @brief A valid entry is left alone until it is about to expire, then it is
+ *        refreshed every period until it is removed.
+ */
+void test_vARPAgeCache_Wheel_ValidEntryExpires( void )
+{
+    MACAddress_t xMACAddress;
+    BaseType_t xPeriods;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+
+    vARPRefreshCacheEntry( &xMACAddress, wheelFIRST_IP_ADDRESS );
+
+    xPeriods = prvAgeUntilRequest();
+
+    TEST_ASSERT_LESS_OR_EQUAL( wheelFIRST_VISIT, xPeriods );
+    TEST_ASSERT_GREATER_OR_EQUAL( wheelFIRST_VISIT - ipconfigARP_AGE_JITTER, xPeriods );
+    TEST_ASSERT_EQUAL( 1, xRequestCount );
+
+    /* Two more requests, and it is still there. */
+    prvAgeCache( 2 );
+    TEST_ASSERT_EQUAL( 3, xRequestCount );
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( wheelFIRST_IP_ADDRESS ) );
+
+    /* The last request, and it is removed. */
+    prvAgeCache( 1 );
+    TEST_ASSERT_EQUAL( 4, xRequestCount );
+    TEST_ASSERT_EQUAL( pdFALSE, xIsIPInARPCache( wheelFIRST_IP_ADDRESS ) );
+
+    /* The wheel is empty now. */
+    prvAgeCache( ipconfigMAX_ARP_AGE );
+    TEST_ASSERT_EQUAL( 4, xRequestCount );
+}
+
+/*
+ * @brief A refresh of an entry postpones its first visit.
+ */
+void test_vARPAgeCache_Wheel_RefreshPostpones( void )
+{
+    MACAddress_t xMACAddress;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+
+    vARPRefreshCacheEntry( &xMACAddress, wheelFIRST_IP_ADDRESS );
+    prvAgeCache( 100 );
+
+    vARPRefreshCacheEntry( &xMACAddress, wheelFIRST_IP_ADDRESS );
+    prvAgeCache( wheelFIRST_VISIT - ipconfigARP_AGE_JITTER - 1 );
+
+    TEST_ASSERT_EQUAL( 0, xRequestCount );
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( wheelFIRST_IP_ADDRESS ) );
+}
+
+/*
+ * @brief Entries that are learnt at the same moment are not all refreshed in
+ *        the same period.
+ */
+void test_vARPAgeCache_Wheel_Jitter( void )
+{
+    MACAddress_t xMACAddress;
+    BaseType_t xPeriods1, xPeriods2;
+
+    prvResetARPCache();
+
+    /* The two IP-addresses only differ in bit 0, their jitter differs by one. */
+    prvSetMACAddress( &xMACAddress, 0x01 );
+    vARPRefreshCacheEntry( &xMACAddress, wheelFIRST_IP_ADDRESS );
+    prvSetMACAddress( &xMACAddress, 0x02 );
+    vARPRefreshCacheEntry( &xMACAddress, wheelFIRST_IP_ADDRESS ^ 1U );
+
+    xPeriods1 = prvAgeUntilRequest();
+    TEST_ASSERT_EQUAL( 1, xRequestCount );
+
+    xPeriods2 = xPeriods1 + prvAgeUntilRequest();
+    TEST_ASSERT_GREATER_THAN( xPeriods1, xPeriods2 );
+}
+
+/*
+ * @brief An entry that waits for a reply is visited every period, and it is
+ *        removed after ipconfigMAX_ARP_RETRANSMISSIONS requests.
+ */
+void test_vARPAgeCache_Wheel_ReservedEntryExpires( void )
+{
+    prvResetARPCache();
+
+    vARPRefreshCacheEntry( NULL, wheelFIRST_IP_ADDRESS );
+
+    prvAgeCache( ipconfigMAX_ARP_RETRANSMISSIONS - 1 );
+    TEST_ASSERT_EQUAL( ipconfigMAX_ARP_RETRANSMISSIONS - 1, xRequestCount );
+
+    /* The reservation is still there, so no new one is made. */
+    vARPRefreshCacheEntry( NULL, wheelFIRST_IP_ADDRESS );
+
+    prvAgeCache( 1 );
+    TEST_ASSERT_EQUAL( ipconfigMAX_ARP_RETRANSMISSIONS, xRequestCount );
+
+    /* It is gone now. */
+    prvAgeCache( ipconfigMAX_ARP_AGE );
+    TEST_ASSERT_EQUAL( ipconfigMAX_ARP_RETRANSMISSIONS, xRequestCount );
+}
+
+/*
+ * @brief An entry that waits for a reply is not visited every period any more
+ *        once the reply has arrived.
+ */
+void test_vARPAgeCache_Wheel_ReplyArrives( void )
+{
+    MACAddress_t xMACAddress;
+
+    prvResetARPCache();
+    prvSetMACAddress( &xMACAddress, 0x01 );
+
+    vARPRefreshCacheEntry( NULL, wheelFIRST_IP_ADDRESS );
+
+    prvAgeCache( 2 );
+    TEST_ASSERT_EQUAL( 2, xRequestCount );
+
+    vARPRefreshCacheEntry( &xMACAddress, wheelFIRST_IP_ADDRESS );
+
+    prvAgeCache( wheelFIRST_VISIT - ipconfigARP_AGE_JITTER - 1 );
+    TEST_ASSERT_EQUAL( 2, xRequestCount );
+    TEST_ASSERT_EQUAL( pdTRUE, xIsIPInARPCache( wheelFIRST_IP_ADDRESS ) );
+}
+
+/*
+ * @brief Entries that are removed, or that are cleared with the cache, are
+ *        taken out of the timer wheel.
+ */
+void test_vARPAgeCache_Wheel_RemovedEntries( void )
+{
+    MACAddress_t xMACAddress;
+
+    prvResetARPCache();
+
+    prvSetMACAddress( &xMACAddress, 0x01 );
+    vARPRefreshCacheEntry( &xMACAddress, wheelFIRST_IP_ADDRESS );
+    vARPRefreshCacheEntry( NULL, wheelFIRST_IP_ADDRESS + 1U );
+
+    TEST_ASSERT_EQUAL_HEX32( wheelFIRST_IP_ADDRESS, ulARPRemoveCacheEntryByMac( &xMACAddress ) );
+
+    /* Only the reserved entry sends requests. */
+    prvAgeCache( ipconfigMAX_ARP_AGE );
+    TEST_ASSERT_EQUAL( ipconfigMAX_ARP_RETRANSMISSIONS, xRequestCount );
+
+    prvResetARPCache();
+
+    vARPRefreshCacheEntry( &xMACAddress, wheelFIRST_IP_ADDRESS );
+    vARPRefreshCacheEntry( NULL, wheelFIRST_IP_ADDRESS + 1U );
+
+    vARPClearCache();
+
+    prvAgeCache( ipconfigMAX_ARP_AGE );
+    TEST_ASSERT_EQUAL( 0, xRequestCount );
+}
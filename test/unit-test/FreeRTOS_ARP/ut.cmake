@@ -90,3 +90,60 @@ create_test(${utest_name}
             "${utest_dep_list}"
             "${test_include_directories}"
         )
+
+# ===============  ARP cache indexed by hash tables (edit)  ====================
+
+set(hash_real_name "${project_name}_Hash_real")
+set(hash_utest_name "${project_name}_Hash_utest")
+
+create_real_library(${hash_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+target_compile_definitions(${hash_real_name} PUBLIC
+            ipconfigUSE_ARP_HASH_TABLE=1
+        )
+
+set( hash_link_list "" )
+list(APPEND hash_link_list
+            -l${mock_name}
+            lib${hash_real_name}.a
+        )
+
+create_test(${hash_utest_name}
+            "${project_name}/${hash_utest_name}.c"
+            "${hash_link_list}"
+            "${hash_real_name}"
+            "${test_include_directories}"
+        )
+
+# ===============  ARP cache aged through a timer wheel (edit)  ================
+
+set(wheel_real_name "${project_name}_Wheel_real")
+set(wheel_utest_name "${project_name}_Wheel_utest")
+
+create_real_library(${wheel_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+target_compile_definitions(${wheel_real_name} PUBLIC
+            ipconfigUSE_ARP_HASH_TABLE=1
+            ipconfigUSE_ARP_TIMER_WHEEL=1
+        )
+
+set( wheel_link_list "" )
+list(APPEND wheel_link_list
+            -l${mock_name}
+            lib${wheel_real_name}.a
+        )
+
+create_test(${wheel_utest_name}
+            "${project_name}/${wheel_utest_name}.c"
+            "${wheel_link_list}"
+            "${wheel_real_name}"
+            "${test_include_directories}"
+        )
@@ -0,0 +1,392 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_UDP_IP.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_task.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_FreeRTOS_DHCP_mock.h"
+
+#include "FreeRTOS_DHCP.h"
+
+#include "FreeRTOS_DHCP_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigDHCP_STORE_LEASE and
+ * ipconfigDHCP_USE_LEASE_AT_ONCE defined as non-zero, see ut.cmake. */
+
+extern Socket_t xDHCPSocket;
+extern DHCPData_t xDHCPData;
+
+/* The addresses that are used in this file, in network byte order. */
+#define leaseIP_ADDRESS         0x0A00A8C0U /* 192.168.0.10 */
+#define leaseSERVER_ADDRESS     0x0100A8C0U /* 192.168.0.1 */
+#define leaseOTHER_SERVER       0x0200A8C0U /* 192.168.0.2 */
+#define leaseNET_MASK           0x00FFFFFFU /* 255.255.255.0 */
+#define leaseGATEWAY_ADDRESS    0xFE00A8C0U /* 192.168.0.254 */
+
+/* The transaction ID that the replies will carry. */
+#define leaseTRANSACTION_ID     0x01ABCDEFU
+
+static const char * pcHostName = "Unit-Test";
+
+/* The network buffer that is handed out by prvGetNetworkBufferStub(). */
+static uint8_t ucEthernetBuffer[ ipconfigNETWORK_MTU ];
+static NetworkBufferDescriptor_t xNetworkBuffer;
+
+/* The DHCP message that was passed to FreeRTOS_sendto(). */
+static const uint8_t * pucSentMessage;
+static size_t uxSentLength;
+
+/* The reply that will be returned by prvRecvFromStub(). */
+static uint8_t ucReply[ sizeof( DHCPMessage_IPv4_t ) + 32U ];
+static size_t uxReplyLength;
+
+/* The lease that xApplicationDHCPRestoreLeaseHook() will return, if any. */
+static DHCPLease_t xRestoredLease;
+static BaseType_t xHasRestoredLease;
+static BaseType_t xRestoreCount;
+
+/* The last lease that was passed to vApplicationDHCPSaveLeaseHook(). */
+static DHCPLease_t xSavedLease;
+static BaseType_t xSaveCount;
+
+/*
+ * @brief The application hook that is asked for a lease that was saved earlier.
+ */
+BaseType_t xApplicationDHCPRestoreLeaseHook( DHCPLease_t * pxLease )
+{
+    xRestoreCount++;
+
+    if( xHasRestoredLease != pdFALSE )
+    {
+        *pxLease = xRestoredLease;
+    }
+
+    return xHasRestoredLease;
+}
+
+/*
+ * @brief The application hook that is called when a lease must be saved or
+ *        forgotten.
+ */
+void vApplicationDHCPSaveLeaseHook( const DHCPLease_t * pxLease )
+{
+    xSaveCount++;
+    xSavedLease = *pxLease;
+}
+
+/*
+ * @brief Forget all DHCP state, and all that the hooks have seen.
+ */
+static void prvResetDHCPData( void )
+{
+    static struct xSOCKET xTestSocket;
+
+    memset( &xDHCPData, 0, sizeof( xDHCPData ) );
+    xDHCPData.ulTransactionId = leaseTRANSACTION_ID;
+    xDHCPSocket = &xTestSocket;
+    *ipLOCAL_IP_ADDRESS_POINTER = 0U;
+
+    memset( &xRestoredLease, 0, sizeof( xRestoredLease ) );
+    memset( &xSavedLease, 0, sizeof( xSavedLease ) );
+    xHasRestoredLease = pdFALSE;
+    xRestoreCount = 0;
+    xSaveCount = 0;
+    pucSentMessage = NULL;
+    uxSentLength = 0U;
+}
+
+/*
+ * @brief Hand out the same network buffer each time.
+ */
+static NetworkBufferDescriptor_t * prvGetNetworkBufferStub( size_t uxRequestedSizeBytes,
+                                                            TickType_t xBlockTimeTicks,
+                                                            int callback_count )
+{
+    ( void ) xBlockTimeTicks;
+    ( void ) callback_count;
+
+    TEST_ASSERT_LESS_OR_EQUAL( sizeof( ucEthernetBuffer ), uxRequestedSizeBytes );
+
+    memset( ucEthernetBuffer, 0, sizeof( ucEthernetBuffer ) );
+    xNetworkBuffer.pucEthernetBuffer = ucEthernetBuffer;
+
+    return &( xNetworkBuffer );
+}
+
+/*
+ * @brief Remember the DHCP message that is being sent.
+ */
+static int32_t prvSendToStub( Socket_t xSocket,
+                              const void * pvBuffer,
+                              size_t uxTotalDataLength,
+                              BaseType_t xFlags,
+                              const struct freertos_sockaddr * pxDestinationAddress,
+                              socklen_t xDestinationAddressLength,
+                              int callback_count )
+{
+    ( void ) xSocket;
+    ( void ) pxDestinationAddress;
+    ( void ) xDestinationAddressLength;
+    ( void ) callback_count;
+
+    TEST_ASSERT_EQUAL( FREERTOS_ZERO_COPY, xFlags );
+
+    pucSentMessage = ( const uint8_t * ) pvBuffer;
+    uxSentLength = uxTotalDataLength;
+
+    return ( int32_t ) uxTotalDataLength;
+}
+
+/*
+ * @brief Return the reply that was made by prvCreateReply().
+ */
+static int32_t prvRecvFromStub( Socket_t xSocket,
+                                void * pvBuffer,
+                                size_t uxBufferLength,
+                                BaseType_t xFlags,
+                                struct freertos_sockaddr * pxSourceAddress,
+                                socklen_t * pxSourceAddressLength,
+                                int callback_count )
+{
+    ( void ) xSocket;
+    ( void ) uxBufferLength;
+    ( void ) pxSourceAddress;
+    ( void ) pxSourceAddressLength;
+    ( void ) callback_count;
+
+    TEST_ASSERT_EQUAL( FREERTOS_ZERO_COPY, xFlags );
+    *( ( uint8_t ** ) pvBuffer ) = ucReply;
+
+    return ( int32_t ) uxReplyLength;
+}
+
+/*
+ * @brief Make a reply of type 'ucMessageType' from the server 'ulServerAddress',
+ *        which offers leaseIP_ADDRESS for 'ulLeaseSeconds'.
+ */
+static void prvCreateReply( uint8_t ucMessageType,
+                            uint32_t ulServerAddress,
+                            uint32_t ulLeaseSeconds )
+{
+    DHCPMessage_IPv4_t * pxMessage = ( DHCPMessage_IPv4_t * ) ucReply;
+    uint8_t * pucOption = &( ucReply[ sizeof( DHCPMessage_IPv4_t ) ] );
+    uint32_t ulLeaseTime = FreeRTOS_htonl( ulLeaseSeconds );
+
+    memset( ucReply, 0, sizeof( ucReply ) );
+    pxMessage->ucOpcode = dhcpREPLY_OPCODE;
+    pxMessage->ucAddressType = dhcpADDRESS_TYPE_ETHERNET;
+    pxMessage->ucAddressLength = dhcpETHERNET_ADDRESS_LENGTH;
+    pxMessage->ulTransactionID = FreeRTOS_htonl( leaseTRANSACTION_ID );
+    pxMessage->ulYourIPAddress_yiaddr = leaseIP_ADDRESS;
+    pxMessage->ulDHCPCookie = dhcpCOOKIE;
+    memcpy( pxMessage->ucClientHardwareAddress, ipLOCAL_MAC_ADDRESS, sizeof( MACAddress_t ) );
+
+    *( pucOption++ ) = dhcpIPv4_MESSAGE_TYPE_OPTION_CODE;
+    *( pucOption++ ) = 1U;
+    *( pucOption++ ) = ucMessageType;
+
+    *( pucOption++ ) = dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE;
+    *( pucOption++ ) = 4U;
+    memcpy( pucOption, &( ulServerAddress ), sizeof( ulServerAddress ) );
+    pucOption += sizeof( ulServerAddress );
+
+    *( pucOption++ ) = dhcpIPv4_LEASE_TIME_OPTION_CODE;
+    *( pucOption++ ) = 4U;
+    memcpy( pucOption, &( ulLeaseTime ), sizeof( ulLeaseTime ) );
+    pucOption += sizeof( ulLeaseTime );
+
+    *( pucOption++ ) = dhcpOPTION_END_BYTE;
+
+    uxReplyLength = ( size_t ) ( pucOption - ucReply );
+}
+
+/*
+ * @brief Look for option 'ucCode' in the message that was sent.
+ *
+ * @return The option's data, or NULL when the option is not present.
+ */
+static const uint8_t * prvFindSentOption( uint8_t ucCode )
+{
+    const uint8_t * pucResult = NULL;
+    size_t uxIndex = sizeof( DHCPMessage_IPv4_t );
+
+    TEST_ASSERT_NOT_NULL( pucSentMessage );
+
+    while( ( uxIndex + 1U ) < uxSentLength )
+    {
+        if( pucSentMessage[ uxIndex ] == ( uint8_t ) dhcpOPTION_END_BYTE )
+        {
+            break;
+        }
+
+        if( pucSentMessage[ uxIndex ] == ucCode )
+        {
+            pucResult = &( pucSentMessage[ uxIndex + 2U ] );
+            break;
+        }
+
+        uxIndex += 2U + pucSentMessage[ uxIndex + 1U ];
+    }
+
+    return pucResult;
+}
+
+/*
+ * @brief Expect the calls that are made while a DHCP message is sent.
+ */
+static void prvExpectSend( void )
+{
+    pcApplicationHostnameHook_ExpectAndReturn( pcHostName );
+    pxGetNetworkBufferWithDescriptor_Stub( prvGetNetworkBufferStub );
+    FreeRTOS_sendto_Stub( prvSendToStub );
+}
+
+/*
+ * @brief A restored lease is used at once: the network is reported to be up
+ *        while the INIT-REBOOT request is sent.
+ */
+void test_vDHCPProcess_RestoredLease_UsedAtOnce( void )
+{
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingSendFirstDiscover;
+
+    xHasRestoredLease = pdTRUE;
+    xRestoredLease.ulIPAddress = leaseIP_ADDRESS;
+    xRestoredLease.ulNetMask = leaseNET_MASK;
+    xRestoredLease.ulGatewayAddress = leaseGATEWAY_ADDRESS;
+    xRestoredLease.ulLeaseSeconds = 3600U;
+
+    xApplicationDHCPHook_ExpectAndReturn( eDHCPPhasePreDiscover, xNetworkAddressing.ulDefaultIPAddress, eDHCPContinue );
+    xTaskGetTickCount_ExpectAndReturn( 100U );
+    vIPNetworkUpCalls_Expect();
+    vARPSendGratuitous_Expect();
+    prvExpectSend();
+
+    vDHCPProcess( pdFALSE, eWaitingSendFirstDiscover );
+
+    TEST_ASSERT_EQUAL( eWaitingAcknowledge, xDHCPData.eDHCPState );
+    TEST_ASSERT_EQUAL( pdTRUE, xDHCPData.xInitReboot );
+    TEST_ASSERT_EQUAL_HEX32( leaseIP_ADDRESS, *ipLOCAL_IP_ADDRESS_POINTER );
+    TEST_ASSERT_EQUAL_HEX32( 0x0000A8C0U | ~leaseNET_MASK, xNetworkAddressing.ulBroadcastAddress );
+
+    /* The request has no server identifier. */
+    TEST_ASSERT_NOT_NULL( prvFindSentOption( dhcpIPv4_REQUEST_IP_ADDRESS_OPTION_CODE ) );
+    TEST_ASSERT_NULL( prvFindSentOption( dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE ) );
+}
+
+/*
+ * @brief A NACK to an INIT-REBOOT request takes away the address that was
+ *        used already, and reports the network to be down.
+ */
+void test_vDHCPProcess_InitReboot_NACK_NetworkDown( void )
+{
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingAcknowledge;
+    xDHCPData.xInitReboot = pdTRUE;
+    xDHCPData.ulRebootIPAddress = leaseIP_ADDRESS;
+    xDHCPData.ulOfferedIPAddress = leaseIP_ADDRESS;
+    xDHCPData.xDHCPTxTime = 100U;
+    xDHCPData.xDHCPTxPeriod = dhcpINITIAL_DHCP_TX_PERIOD;
+    *ipLOCAL_IP_ADDRESS_POINTER = leaseIP_ADDRESS;
+
+    prvCreateReply( dhcpMESSAGE_TYPE_NACK, leaseSERVER_ADDRESS, 3600U );
+    FreeRTOS_recvfrom_Stub( prvRecvFromStub );
+    vIPNetworkDownCalls_Expect();
+    FreeRTOS_ReleaseUDPPayloadBuffer_Expect( ucReply );
+    xTaskGetTickCount_ExpectAndReturn( 101U );
+
+    vDHCPProcess( pdFALSE, eWaitingAcknowledge );
+
+    TEST_ASSERT_EQUAL( eInitialWait, xDHCPData.eDHCPState );
+    TEST_ASSERT_EQUAL( pdFALSE, xDHCPData.xInitReboot );
+    TEST_ASSERT_EQUAL_HEX32( 0U, *ipLOCAL_IP_ADDRESS_POINTER );
+    TEST_ASSERT_EQUAL( 1, xSaveCount );
+    TEST_ASSERT_EQUAL_HEX32( 0U, xSavedLease.ulIPAddress );
+}
+
+/*
+ * @brief A NACK to a normal request does not touch the network state.
+ */
+void test_vDHCPProcess_Request_NACK_NetworkStaysDown( void )
+{
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingAcknowledge;
+    xDHCPData.ulDHCPServerAddress = leaseSERVER_ADDRESS;
+    xDHCPData.xDHCPTxTime = 100U;
+    xDHCPData.xDHCPTxPeriod = dhcpINITIAL_DHCP_TX_PERIOD;
+
+    prvCreateReply( dhcpMESSAGE_TYPE_NACK, leaseSERVER_ADDRESS, 3600U );
+    FreeRTOS_recvfrom_Stub( prvRecvFromStub );
+    FreeRTOS_ReleaseUDPPayloadBuffer_Expect( ucReply );
+    xTaskGetTickCount_ExpectAndReturn( 101U );
+
+    vDHCPProcess( pdFALSE, eWaitingAcknowledge );
+
+    TEST_ASSERT_EQUAL( eInitialWait, xDHCPData.eDHCPState );
+    TEST_ASSERT_EQUAL_HEX32( 0U, *ipLOCAL_IP_ADDRESS_POINTER );
+}
+
+/*
+ * @brief An INIT-REBOOT request that stays unanswered leaves the address in
+ *        use until the lease must be renewed.
+ */
+void test_vDHCPProcess_InitReboot_TimedOut_KeepsAddress( void )
+{
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingAcknowledge;
+    xDHCPData.xInitReboot = pdTRUE;
+    xDHCPData.ulRebootIPAddress = leaseIP_ADDRESS;
+    xDHCPData.ulOfferedIPAddress = leaseIP_ADDRESS;
+    xDHCPData.ulLeaseTime = 1800U * configTICK_RATE_HZ;
+    xDHCPData.xDHCPTxTime = 100U;
+    xDHCPData.xDHCPTxPeriod = dhcpINIT_REBOOT_MAX_TX_PERIOD;
+    *ipLOCAL_IP_ADDRESS_POINTER = leaseIP_ADDRESS;
+
+    FreeRTOS_recvfrom_ExpectAnyArgsAndReturn( 0 );
+    xTaskGetTickCount_ExpectAndReturn( 101U + dhcpINIT_REBOOT_MAX_TX_PERIOD );
+    vSocketClose_ExpectAnyArgsAndReturn( NULL );
+    vIPReloadDHCPTimer_Expect( 1800U * configTICK_RATE_HZ );
+
+    vDHCPProcess( pdFALSE, eWaitingAcknowledge );
+
+    TEST_ASSERT_EQUAL( eLeasedAddress, xDHCPData.eDHCPState );
+    TEST_ASSERT_EQUAL( pdFALSE, xDHCPData.xInitReboot );
+    TEST_ASSERT_EQUAL_HEX32( leaseIP_ADDRESS, *ipLOCAL_IP_ADDRESS_POINTER );
+}
@@ -0,0 +1,478 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_UDP_IP.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_task.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_FreeRTOS_DHCP_mock.h"
+
+#include "FreeRTOS_DHCP.h"
+
+#include "FreeRTOS_DHCP_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigDHCP_USE_RAPID_COMMIT and
+ * ipconfigDHCP_CHECK_ADDRESS_CONFLICT defined as non-zero, see ut.cmake. */
+
+extern Socket_t xDHCPSocket;
+extern DHCPData_t xDHCPData;
+
+/* The addresses that are used in this file, in network byte order. */
+#define rapidIP_ADDRESS        0x0A00A8C0U /* 192.168.0.10 */
+#define rapidSERVER_ADDRESS    0x0100A8C0U /* 192.168.0.1 */
+
+/* The transaction ID that the replies will carry. */
+#define rapidTRANSACTION_ID    0x01ABCDEFU
+
+static const char * pcHostName = "Unit-Test";
+
+/* The network buffer that is handed out by prvGetNetworkBufferStub(). */
+static uint8_t ucEthernetBuffer[ ipconfigNETWORK_MTU ];
+static NetworkBufferDescriptor_t xNetworkBuffer;
+
+/* The DHCP message that was passed to FreeRTOS_sendto(). */
+static const uint8_t * pucSentMessage;
+static size_t uxSentLength;
+
+/* The reply that will be returned by prvRecvFromStub(). */
+static uint8_t ucReply[ sizeof( DHCPMessage_IPv4_t ) + 32U ];
+static size_t uxReplyLength;
+
+/*
+ * @brief Forget all DHCP state.
+ */
+static void prvResetDHCPData( void )
+{
+    static struct xSOCKET xTestSocket;
+
+    memset( &xDHCPData, 0, sizeof( xDHCPData ) );
+    xDHCPData.ulTransactionId = rapidTRANSACTION_ID;
+    xDHCPSocket = &xTestSocket;
+    *ipLOCAL_IP_ADDRESS_POINTER = 0U;
+
+    xARPHadIPClash = pdFALSE;
+    pucSentMessage = NULL;
+    uxSentLength = 0U;
+}
+
+/*
+ * @brief Hand out the same network buffer each time.
+ */
+static NetworkBufferDescriptor_t * prvGetNetworkBufferStub( size_t uxRequestedSizeBytes,
+                                                            TickType_t xBlockTimeTicks,
+                                                            int callback_count )
+{
+    ( void ) xBlockTimeTicks;
+    ( void ) callback_count;
+
+    TEST_ASSERT_LESS_OR_EQUAL( sizeof( ucEthernetBuffer ), uxRequestedSizeBytes );
+
+    memset( ucEthernetBuffer, 0, sizeof( ucEthernetBuffer ) );
+    xNetworkBuffer.pucEthernetBuffer = ucEthernetBuffer;
+
+    return &( xNetworkBuffer );
+}
+
+/*
+ * @brief Remember the DHCP message that is being sent.
+ */
+static int32_t prvSendToStub( Socket_t xSocket,
+                              const void * pvBuffer,
+                              size_t uxTotalDataLength,
+                              BaseType_t xFlags,
+                              const struct freertos_sockaddr * pxDestinationAddress,
+                              socklen_t xDestinationAddressLength,
+                              int callback_count )
+{
+    ( void ) xSocket;
+    ( void ) pxDestinationAddress;
+    ( void ) xDestinationAddressLength;
+    ( void ) callback_count;
+
+    TEST_ASSERT_EQUAL( FREERTOS_ZERO_COPY, xFlags );
+
+    pucSentMessage = ( const uint8_t * ) pvBuffer;
+    uxSentLength = uxTotalDataLength;
+
+    return ( int32_t ) uxTotalDataLength;
+}
+
+/*
+ * @brief Return the reply that was made by prvCreateReply().
+ */
+static int32_t prvRecvFromStub( Socket_t xSocket,
+                                void * pvBuffer,
+                                size_t uxBufferLength,
+                                BaseType_t xFlags,
+                                struct freertos_sockaddr * pxSourceAddress,
+                                socklen_t * pxSourceAddressLength,
+                                int callback_count )
+{
+    ( void ) xSocket;
+    ( void ) uxBufferLength;
+    ( void ) pxSourceAddress;
+    ( void ) pxSourceAddressLength;
+    ( void ) callback_count;
+
+    TEST_ASSERT_EQUAL( FREERTOS_ZERO_COPY, xFlags );
+    *( ( uint8_t ** ) pvBuffer ) = ucReply;
+
+    return ( int32_t ) uxReplyLength;
+}
+
+/*
+ * @brief Make a reply of type 'ucMessageType' from the server 'ulServerAddress',
+ *        which offers rapidIP_ADDRESS for 'ulLeaseSeconds'.  When
+ *        'xRapidCommit' is pdTRUE, the reply has the rapid commit option.
+ */
+static void prvCreateReply( uint8_t ucMessageType,
+                            uint32_t ulServerAddress,
+                            uint32_t ulLeaseSeconds,
+                            BaseType_t xRapidCommit )
+{
+    DHCPMessage_IPv4_t * pxMessage = ( DHCPMessage_IPv4_t * ) ucReply;
+    uint8_t * pucOption = &( ucReply[ sizeof( DHCPMessage_IPv4_t ) ] );
+    uint32_t ulLeaseTime = FreeRTOS_htonl( ulLeaseSeconds );
+
+    memset( ucReply, 0, sizeof( ucReply ) );
+    pxMessage->ucOpcode = dhcpREPLY_OPCODE;
+    pxMessage->ucAddressType = dhcpADDRESS_TYPE_ETHERNET;
+    pxMessage->ucAddressLength = dhcpETHERNET_ADDRESS_LENGTH;
+    pxMessage->ulTransactionID = FreeRTOS_htonl( rapidTRANSACTION_ID );
+    pxMessage->ulYourIPAddress_yiaddr = rapidIP_ADDRESS;
+    pxMessage->ulDHCPCookie = dhcpCOOKIE;
+    memcpy( pxMessage->ucClientHardwareAddress, ipLOCAL_MAC_ADDRESS, sizeof( MACAddress_t ) );
+
+    *( pucOption++ ) = dhcpIPv4_MESSAGE_TYPE_OPTION_CODE;
+    *( pucOption++ ) = 1U;
+    *( pucOption++ ) = ucMessageType;
+
+    *( pucOption++ ) = dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE;
+    *( pucOption++ ) = 4U;
+    memcpy( pucOption, &( ulServerAddress ), sizeof( ulServerAddress ) );
+    pucOption += sizeof( ulServerAddress );
+
+    *( pucOption++ ) = dhcpIPv4_LEASE_TIME_OPTION_CODE;
+    *( pucOption++ ) = 4U;
+    memcpy( pucOption, &( ulLeaseTime ), sizeof( ulLeaseTime ) );
+    pucOption += sizeof( ulLeaseTime );
+
+    if( xRapidCommit != pdFALSE )
+    {
+        *( pucOption++ ) = dhcpIPv4_RAPID_COMMIT_OPTION_CODE;
+        *( pucOption++ ) = 0U;
+    }
+
+    *( pucOption++ ) = dhcpOPTION_END_BYTE;
+
+    uxReplyLength = ( size_t ) ( pucOption - ucReply );
+}
+
+/*
+ * @brief Look for option 'ucCode' in the message that was sent.
+ *
+ * @return The option's data, or NULL when the option is not present.
+ */
+static const uint8_t * prvFindSentOption( uint8_t ucCode )
+{
+    const uint8_t * pucResult = NULL;
+    size_t uxIndex = sizeof( DHCPMessage_IPv4_t );
+
+    TEST_ASSERT_NOT_NULL( pucSentMessage );
+
+    while( ( uxIndex + 1U ) < uxSentLength )
+    {
+        if( pucSentMessage[ uxIndex ] == ( uint8_t ) dhcpOPTION_END_BYTE )
+        {
+            break;
+        }
+
+        if( pucSentMessage[ uxIndex ] == ucCode )
+        {
+            pucResult = &( pucSentMessage[ uxIndex + 2U ] );
+            break;
+        }
+
+        uxIndex += 2U + pucSentMessage[ uxIndex + 1U ];
+    }
+
+    return pucResult;
+}
+
+/*
+ * @brief Expect the calls that are made while a DHCP message is sent.
+ */
+static void prvExpectSend( void )
+{
+    pcApplicationHostnameHook_ExpectAndReturn( pcHostName );
+    pxGetNetworkBufferWithDescriptor_Stub( prvGetNetworkBufferStub );
+    FreeRTOS_sendto_Stub( prvSendToStub );
+}
+
+/*
+ * @brief Expect the calls that are made when the DHCP process starts, in the
+ *        state eWaitingSendFirstDiscover.
+ */
+static void prvExpectFirstDiscover( void )
+{
+    xApplicationDHCPHook_ExpectAndReturn( eDHCPPhasePreDiscover, xNetworkAddressing.ulDefaultIPAddress, eDHCPContinue );
+    xTaskGetTickCount_ExpectAndReturn( 100U );
+    prvExpectSend();
+}
+
+/*
+ * @brief Expect the calls that are made when a lease has been acknowledged.
+ *        The DHCP timer is set to 'ulTimerPeriod'.
+ */
+static void prvExpectLeasedAddress( uint32_t ulTimerPeriod )
+{
+    vIPNetworkUpCalls_Expect();
+    vSocketClose_ExpectAnyArgsAndReturn( NULL );
+    vARPSendGratuitous_Expect();
+    vIPReloadDHCPTimer_Expect( ulTimerPeriod );
+}
+
+/*
+ * @brief The discover message asks for a rapid commit.
+ */
+void test_vDHCPProcess_Discover_HasRapidCommit( void )
+{
+    const uint8_t * pucOption;
+
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingSendFirstDiscover;
+
+    prvExpectFirstDiscover();
+
+    vDHCPProcess( pdFALSE, eWaitingSendFirstDiscover );
+
+    TEST_ASSERT_EQUAL( eWaitingOffer, xDHCPData.eDHCPState );
+
+    pucOption = prvFindSentOption( dhcpIPv4_MESSAGE_TYPE_OPTION_CODE );
+    TEST_ASSERT_NOT_NULL( pucOption );
+    TEST_ASSERT_EQUAL( dhcpMESSAGE_TYPE_DISCOVER, pucOption[ 0 ] );
+
+    pucOption = prvFindSentOption( dhcpIPv4_RAPID_COMMIT_OPTION_CODE );
+    TEST_ASSERT_NOT_NULL( pucOption );
+    /* The option has no data. */
+    TEST_ASSERT_EQUAL( 0, pucOption[ -1 ] );
+}
+
+/*
+ * @brief An ACK with the rapid commit option, in reply to a discover, is used
+ *        at once.  The new address is then checked for conflicts.
+ */
+void test_vDHCPProcess_RapidCommit_AckUsedAtOnce( void )
+{
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingOffer;
+
+    prvCreateReply( dhcpMESSAGE_TYPE_ACK, rapidSERVER_ADDRESS, 3600U, pdTRUE );
+    FreeRTOS_recvfrom_Stub( prvRecvFromStub );
+    FreeRTOS_ReleaseUDPPayloadBuffer_Expect( ucReply );
+    xApplicationDHCPHook_ExpectAndReturn( eDHCPPhasePreRequest, rapidIP_ADDRESS, eDHCPContinue );
+    prvExpectLeasedAddress( dhcpCONFLICT_CHECK_PERIOD );
+
+    vDHCPProcess( pdFALSE, eWaitingOffer );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xDHCPData.xRapidCommit );
+    TEST_ASSERT_EQUAL( eCheckLeasedAddress, xDHCPData.eDHCPState );
+    TEST_ASSERT_EQUAL( 1U, xDHCPData.uxConflictChecks );
+    TEST_ASSERT_EQUAL_HEX32( rapidIP_ADDRESS, *ipLOCAL_IP_ADDRESS_POINTER );
+    TEST_ASSERT_EQUAL_HEX32( rapidSERVER_ADDRESS, xDHCPData.ulDHCPServerAddress );
+    TEST_ASSERT_EQUAL( 1800U * configTICK_RATE_HZ, xDHCPData.ulLeaseTime );
+    /* No request was sent. */
+    TEST_ASSERT_NULL( pucSentMessage );
+}
+
+/*
+ * @brief An ACK without the rapid commit option, in reply to a discover, is
+ *        ignored.
+ */
+void test_vDHCPProcess_RapidCommit_AckWithoutOptionIgnored( void )
+{
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingOffer;
+    xDHCPData.xDHCPTxTime = 100U;
+    xDHCPData.xDHCPTxPeriod = dhcpINITIAL_DHCP_TX_PERIOD;
+
+    prvCreateReply( dhcpMESSAGE_TYPE_ACK, rapidSERVER_ADDRESS, 3600U, pdFALSE );
+    FreeRTOS_recvfrom_Stub( prvRecvFromStub );
+    FreeRTOS_ReleaseUDPPayloadBuffer_Expect( ucReply );
+    xTaskGetTickCount_ExpectAndReturn( 101U );
+
+    vDHCPProcess( pdFALSE, eWaitingOffer );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xDHCPData.xRapidCommit );
+    TEST_ASSERT_EQUAL( eWaitingOffer, xDHCPData.eDHCPState );
+    TEST_ASSERT_EQUAL_HEX32( 0U, *ipLOCAL_IP_ADDRESS_POINTER );
+}
+
+/*
+ * @brief A server that does not support rapid commit sends an offer, which is
+ *        answered with a request as usual.
+ */
+void test_vDHCPProcess_RapidCommit_OfferGetsRequest( void )
+{
+    const uint8_t * pucOption;
+
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingOffer;
+
+    prvCreateReply( dhcpMESSAGE_TYPE_OFFER, rapidSERVER_ADDRESS, 3600U, pdFALSE );
+    FreeRTOS_recvfrom_Stub( prvRecvFromStub );
+    FreeRTOS_ReleaseUDPPayloadBuffer_Expect( ucReply );
+    xApplicationDHCPHook_ExpectAndReturn( eDHCPPhasePreRequest, rapidIP_ADDRESS, eDHCPContinue );
+    prvExpectSend();
+    xTaskGetTickCount_ExpectAndReturn( 200U );
+
+    vDHCPProcess( pdFALSE, eWaitingOffer );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xDHCPData.xRapidCommit );
+    TEST_ASSERT_EQUAL( eWaitingAcknowledge, xDHCPData.eDHCPState );
+
+    pucOption = prvFindSentOption( dhcpIPv4_MESSAGE_TYPE_OPTION_CODE );
+    TEST_ASSERT_NOT_NULL( pucOption );
+    TEST_ASSERT_EQUAL( dhcpMESSAGE_TYPE_REQUEST, pucOption[ 0 ] );
+}
+
+/*
+ * @brief While nobody objects, a few more announcements are sent, after which
+ *        the timer is set to the time of renewal.
+ */
+void test_vDHCPProcess_CheckLeasedAddress_NoConflict( void )
+{
+    UBaseType_t uxCheck;
+
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eCheckLeasedAddress;
+    xDHCPData.uxConflictChecks = 1U;
+    xDHCPData.ulLeaseTime = 1800U * configTICK_RATE_HZ;
+
+    for( uxCheck = 1U; uxCheck < dhcpCONFLICT_CHECK_COUNT; uxCheck++ )
+    {
+        vARPSendGratuitous_Expect();
+        vIPReloadDHCPTimer_Expect( dhcpCONFLICT_CHECK_PERIOD );
+
+        vDHCPProcess( pdFALSE, eCheckLeasedAddress );
+
+        TEST_ASSERT_EQUAL( eCheckLeasedAddress, xDHCPData.eDHCPState );
+        TEST_ASSERT_EQUAL( uxCheck + 1U, xDHCPData.uxConflictChecks );
+    }
+
+    vIPReloadDHCPTimer_Expect( 1800U * configTICK_RATE_HZ );
+
+    vDHCPProcess( pdFALSE, eCheckLeasedAddress );
+
+    TEST_ASSERT_EQUAL( eLeasedAddress, xDHCPData.eDHCPState );
+}
+
+/*
+ * @brief When another device claims the address, the address is dropped, the
+ *        network is reported down, a decline is sent, and the DHCP process
+ *        starts again later.
+ */
+void test_vDHCPProcess_CheckLeasedAddress_Conflict( void )
+{
+    static struct xSOCKET xNewSocket;
+    const uint8_t * pucOption;
+    uint32_t ulValue;
+
+    prvResetDHCPData();
+    xDHCPSocket = NULL;
+    xDHCPData.eDHCPState = eCheckLeasedAddress;
+    xDHCPData.uxConflictChecks = 1U;
+    xDHCPData.ulOfferedIPAddress = rapidIP_ADDRESS;
+    xDHCPData.ulDHCPServerAddress = rapidSERVER_ADDRESS;
+    *ipLOCAL_IP_ADDRESS_POINTER = rapidIP_ADDRESS;
+    xARPHadIPClash = pdTRUE;
+
+    /* The network is reported down until a new address is acknowledged. */
+    vIPNetworkDownCalls_Expect();
+    /* A socket is created to send the decline. */
+    FreeRTOS_socket_ExpectAnyArgsAndReturn( &xNewSocket );
+    FreeRTOS_setsockopt_ExpectAnyArgsAndReturn( 0 );
+    FreeRTOS_setsockopt_ExpectAnyArgsAndReturn( 0 );
+    vSocketBind_ExpectAnyArgsAndReturn( 0 );
+    prvExpectSend();
+    vSocketClose_ExpectAndReturn( &xNewSocket, NULL );
+    vIPReloadDHCPTimer_Expect( dhcpDECLINE_RESTART_PERIOD );
+
+    vDHCPProcess( pdFALSE, eCheckLeasedAddress );
+
+    TEST_ASSERT_EQUAL( eInitialWait, xDHCPData.eDHCPState );
+    TEST_ASSERT_EQUAL_HEX32( 0U, *ipLOCAL_IP_ADDRESS_POINTER );
+    TEST_ASSERT_NULL( xDHCPSocket );
+
+    pucOption = prvFindSentOption( dhcpIPv4_MESSAGE_TYPE_OPTION_CODE );
+    TEST_ASSERT_NOT_NULL( pucOption );
+    TEST_ASSERT_EQUAL( dhcpMESSAGE_TYPE_DECLINE, pucOption[ 0 ] );
+
+    pucOption = prvFindSentOption( dhcpIPv4_REQUEST_IP_ADDRESS_OPTION_CODE );
+    TEST_ASSERT_NOT_NULL( pucOption );
+    memcpy( &( ulValue ), pucOption, sizeof( ulValue ) );
+    TEST_ASSERT_EQUAL_HEX32( rapidIP_ADDRESS, ulValue );
+
+    pucOption = prvFindSentOption( dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE );
+    TEST_ASSERT_NOT_NULL( pucOption );
+    memcpy( &( ulValue ), pucOption, sizeof( ulValue ) );
+    TEST_ASSERT_EQUAL_HEX32( rapidSERVER_ADDRESS, ulValue );
+}
+
+/*
+ * @brief The renewal of an address that is in use already is not checked
+ *        again.
+ */
+void test_vDHCPProcess_Renewal_NotChecked( void )
+{
+    prvResetDHCPData();
+    xDHCPData.eDHCPState = eWaitingAcknowledge;
+    xDHCPData.ulDHCPServerAddress = rapidSERVER_ADDRESS;
+    *ipLOCAL_IP_ADDRESS_POINTER = rapidIP_ADDRESS;
+
+    prvCreateReply( dhcpMESSAGE_TYPE_ACK, rapidSERVER_ADDRESS, 3600U, pdFALSE );
+    FreeRTOS_recvfrom_Stub( prvRecvFromStub );
+    FreeRTOS_ReleaseUDPPayloadBuffer_Expect( ucReply );
+    prvExpectLeasedAddress( 1800U * configTICK_RATE_HZ );
+
+    vDHCPProcess( pdFALSE, eWaitingAcknowledge );
+
+    TEST_ASSERT_EQUAL( eLeasedAddress, xDHCPData.eDHCPState );
+    TEST_ASSERT_EQUAL( 0U, xDHCPData.uxConflictChecks );
+}
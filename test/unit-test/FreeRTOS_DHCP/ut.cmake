@@ -92,3 +92,89 @@ create_test(${utest_name}
             "${utest_dep_list}"
             "${test_include_directories}"
         )
+
+# ===============  DHCP leases saved for INIT-REBOOT (edit)  ===================
+
+set(lease_real_name "${project_name}_Lease_real")
+set(lease_utest_name "${project_name}_Lease_utest")
+
+create_real_library(${lease_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+target_compile_definitions(${lease_real_name} PUBLIC
+            ipconfigDHCP_STORE_LEASE=1
+        )
+
+set( lease_link_list "" )
+list(APPEND lease_link_list
+            -l${mock_name}
+            lib${lease_real_name}.a
+        )
+
+create_test(${lease_utest_name}
+            "${project_name}/${lease_utest_name}.c"
+            "${lease_link_list}"
+            "${lease_real_name}"
+            "${test_include_directories}"
+        )
+
+# ==================  DHCP lease used at once (edit)  ==========================
+
+set(atonce_real_name "${project_name}_LeaseAtOnce_real")
+set(atonce_utest_name "${project_name}_LeaseAtOnce_utest")
+
+create_real_library(${atonce_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+target_compile_definitions(${atonce_real_name} PUBLIC
+            ipconfigDHCP_STORE_LEASE=1
+            ipconfigDHCP_USE_LEASE_AT_ONCE=1
+        )
+
+set( atonce_link_list "" )
+list(APPEND atonce_link_list
+            -l${mock_name}
+            lib${atonce_real_name}.a
+        )
+
+create_test(${atonce_utest_name}
+            "${project_name}/${atonce_utest_name}.c"
+            "${atonce_link_list}"
+            "${atonce_real_name}"
+            "${test_include_directories}"
+        )
+
+# ===========  DHCP rapid commit and address conflict check (edit)  ============
+
+set(rapid_real_name "${project_name}_RapidCommit_real")
+set(rapid_utest_name "${project_name}_RapidCommit_utest")
+
+create_real_library(${rapid_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+target_compile_definitions(${rapid_real_name} PUBLIC
+            ipconfigDHCP_USE_RAPID_COMMIT=1
+            ipconfigDHCP_CHECK_ADDRESS_CONFLICT=1
+        )
+
+set( rapid_link_list "" )
+list(APPEND rapid_link_list
+            -l${mock_name}
+            lib${rapid_real_name}.a
+        )
+
+create_test(${rapid_utest_name}
+            "${project_name}/${rapid_utest_name}.c"
+            "${rapid_link_list}"
+            "${rapid_real_name}"
+            "${test_include_directories}"
+        )
@@ -0,0 +1,529 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+#include "mock_queue.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_UDP_IP.h"
+#include "mock_NetworkBufferManagement.h"
+
+#include "FreeRTOS_DNS.h"
+
+#include "FreeRTOS_DNS_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigUSE_DNS_CACHE_HASH defined as
+ * non-zero, and with a DNS cache of 4 entries, see ut.cmake. */
+
+extern List_t xCallbackList;
+
+extern uint32_t prvParseDNSReply( uint8_t * pucUDPPayloadBuffer,
+                                  size_t uxBufferLength,
+                                  BaseType_t xExpected );
+
+/* The flags of a DNS reply, in network byte order. */
+#define dnsTEST_FLAGS_NO_ERROR    0x8180U
+#define dnsTEST_FLAGS_NXDOMAIN    0x8183U
+
+/* The number of seconds that an SOA record is valid in the replies built by
+ * prvBuildReply(), and the MINIMUM field of that record. */
+#define dnsTEST_SOA_TTL           600U
+#define dnsTEST_SOA_MINIMUM       60U
+
+/* The current time in clock ticks, returned by prvGetTickCountStub(). */
+static TickType_t xTickCount;
+
+/* The results passed to prvDNSCallback(). */
+static uint32_t ulCallbackAddress;
+static BaseType_t xCallbackCount;
+
+/*
+ * @brief Return the current time as set by the test.
+ */
+static TickType_t prvGetTickCountStub( int callback_count )
+{
+    ( void ) callback_count;
+
+    return xTickCount;
+}
+
+/*
+ * @brief Set the current time in seconds, as used by the DNS cache.
+ */
+static void prvSetSeconds( uint32_t ulSeconds )
+{
+    xTickCount = ( TickType_t ) ( ulSeconds * 1000U * portTICK_PERIOD_MS );
+}
+
+/*
+ * @brief Read a 16-bit number in network byte order.
+ */
+static uint16_t prvChar2u16Stub( const uint8_t * pucPtr,
+                                 int callback_count )
+{
+    ( void ) callback_count;
+
+    return ( uint16_t ) ( ( ( uint16_t ) pucPtr[ 0 ] << 8 ) | pucPtr[ 1 ] );
+}
+
+/*
+ * @brief Read a 32-bit number in network byte order.
+ */
+static uint32_t prvChar2u32Stub( const uint8_t * pucPtr,
+                                 int callback_count )
+{
+    ( void ) callback_count;
+
+    return ( ( uint32_t ) pucPtr[ 0 ] << 24 ) | ( ( uint32_t ) pucPtr[ 1 ] << 16 ) |
+           ( ( uint32_t ) pucPtr[ 2 ] << 8 ) | ( uint32_t ) pucPtr[ 3 ];
+}
+
+/*
+ * @brief Function to calculate smaller of the two numbers given.
+ */
+static uint32_t prvMinStub( uint32_t a,
+                            uint32_t b,
+                            int callback_count )
+{
+    ( void ) callback_count;
+
+    return ( a < b ) ? a : b;
+}
+
+/*
+ * @brief The call-back of FreeRTOS_gethostbyname_a().
+ */
+static void prvDNSCallback( const char * pcName,
+                            void * pvSearchID,
+                            uint32_t ulIPAddress )
+{
+    ( void ) pcName;
+    ( void ) pvSearchID;
+
+    ulCallbackAddress = ulIPAddress;
+    xCallbackCount++;
+}
+
+/*
+ * @brief Empty the DNS cache and the list of call-backs, and let the mocks
+ *        that are needed by every test run freely.
+ */
+static void prvResetDNSCache( void )
+{
+    vTaskSuspendAll_Ignore();
+    xTaskResumeAll_IgnoreAndReturn( pdFALSE );
+    xTaskGetTickCount_Stub( prvGetTickCountStub );
+    usChar2u16_Stub( prvChar2u16Stub );
+    ulChar2u32_Stub( prvChar2u32Stub );
+    FreeRTOS_min_uint32_Stub( prvMinStub );
+    FreeRTOS_inet_ntop_IgnoreAndReturn( NULL );
+
+    /* An empty list: the end marker points to itself. */
+    xCallbackList.xListEnd.pxNext = ( ListItem_t * ) &( xCallbackList.xListEnd );
+    xCallbackList.xListEnd.pxPrevious = ( ListItem_t * ) &( xCallbackList.xListEnd );
+    xCallbackList.uxNumberOfItems = 0U;
+
+    prvSetSeconds( 1000U );
+    ulCallbackAddress = 0U;
+    xCallbackCount = 0;
+
+    FreeRTOS_dnsclear();
+}
+
+/*
+ * @brief Write a 16-bit number in network byte order.
+ */
+static uint8_t * prvWrite16( uint8_t * pucPtr,
+                             uint16_t usValue )
+{
+    pucPtr[ 0 ] = ( uint8_t ) ( usValue >> 8 );
+    pucPtr[ 1 ] = ( uint8_t ) usValue;
+
+    return &( pucPtr[ 2 ] );
+}
+
+/*
+ * @brief Write a 32-bit number in network byte order.
+ */
+static uint8_t * prvWrite32( uint8_t * pucPtr,
+                             uint32_t ulValue )
+{
+    pucPtr = prvWrite16( pucPtr, ( uint16_t ) ( ulValue >> 16 ) );
+
+    return prvWrite16( pucPtr, ( uint16_t ) ulValue );
+}
+
+/*
+ * @brief Build a DNS reply for the A records of 'pcName'.
+ *
+ * @param[out] pucBuffer: The buffer for the reply.
+ * @param[in] usFlags: The flags of the reply.
+ * @param[in] pcName: The name that was looked up.
+ * @param[in] pulAddresses: The addresses in the answer section.
+ * @param[in] usAnswers: The number of addresses.
+ * @param[in] ulTTL: The TTL of the answers.
+ * @param[in] xAddSOA: pdTRUE to add an SOA record in the authority section.
+ *
+ * @return The length of the reply.
+ */
+static size_t prvBuildReply( uint8_t * pucBuffer,
+                             uint16_t usFlags,
+                             const char * pcName,
+                             const uint32_t * pulAddresses,
+                             uint16_t usAnswers,
+                             uint32_t ulTTL,
+                             BaseType_t xAddSOA )
+{
+    uint8_t * pucPtr = pucBuffer;
+    const char * pcLabel = pcName;
+    const char * pcDot;
+    size_t uxLength;
+    uint16_t usAnswer;
+
+    pucPtr = prvWrite16( pucPtr, 0x1234U );
+    pucPtr = prvWrite16( pucPtr, usFlags );
+    pucPtr = prvWrite16( pucPtr, 1U );
+    pucPtr = prvWrite16( pucPtr, usAnswers );
+    pucPtr = prvWrite16( pucPtr, ( xAddSOA != pdFALSE ) ? 1U : 0U );
+    pucPtr = prvWrite16( pucPtr, 0U );
+
+    /* The question. */
+    for( ; ; )
+    {
+        pcDot = strchr( pcLabel, '.' );
+        uxLength = ( pcDot != NULL ) ? ( size_t ) ( pcDot - pcLabel ) : strlen( pcLabel );
+        *( pucPtr++ ) = ( uint8_t ) uxLength;
+        memcpy( pucPtr, pcLabel, uxLength );
+        pucPtr += uxLength;
+
+        if( pcDot == NULL )
+        {
+            break;
+        }
+
+        pcLabel = &( pcDot[ 1 ] );
+    }
+
+    *( pucPtr++ ) = 0U;
+    pucPtr = prvWrite16( pucPtr, dnsTYPE_A_HOST );
+    pucPtr = prvWrite16( pucPtr, dnsCLASS_IN );
+
+    /* The answers refer to the name in the question. */
+    for( usAnswer = 0U; usAnswer < usAnswers; usAnswer++ )
+    {
+        pucPtr = prvWrite16( pucPtr, 0xC000U | sizeof( DNSMessage_t ) );
+        pucPtr = prvWrite16( pucPtr, dnsTYPE_A_HOST );
+        pucPtr = prvWrite16( pucPtr, dnsCLASS_IN );
+        pucPtr = prvWrite32( pucPtr, ulTTL );
+        pucPtr = prvWrite16( pucPtr, 4U );
+        memcpy( pucPtr, &( pulAddresses[ usAnswer ] ), 4U );
+        pucPtr += 4;
+    }
+
+    if( xAddSOA != pdFALSE )
+    {
+        pucPtr = prvWrite16( pucPtr, 0xC000U | sizeof( DNSMessage_t ) );
+        pucPtr = prvWrite16( pucPtr, dnsTYPE_SOA );
+        pucPtr = prvWrite16( pucPtr, dnsCLASS_IN );
+        pucPtr = prvWrite32( pucPtr, dnsTEST_SOA_TTL );
+        pucPtr = prvWrite16( pucPtr, 2U + ( 5U * 4U ) );
+        /* MNAME and RNAME are the root. */
+        *( pucPtr++ ) = 0U;
+        *( pucPtr++ ) = 0U;
+        pucPtr = prvWrite32( pucPtr, 1U );    /* SERIAL */
+        pucPtr = prvWrite32( pucPtr, 7200U ); /* REFRESH */
+        pucPtr = prvWrite32( pucPtr, 3600U ); /* RETRY */
+        pucPtr = prvWrite32( pucPtr, 86400U ); /* EXPIRE */
+        pucPtr = prvWrite32( pucPtr, dnsTEST_SOA_MINIMUM );
+    }
+
+    return ( size_t ) ( pucPtr - pucBuffer );
+}
+
+/*
+ * @brief Store the addresses of 'pcName' in the DNS cache, through a reply.
+ */
+static void prvStoreAddresses( const char * pcName,
+                               const uint32_t * pulAddresses,
+                               uint16_t usAnswers,
+                               uint32_t ulTTL )
+{
+    uint8_t ucBuffer[ 512 ];
+    size_t uxLength = prvBuildReply( ucBuffer, dnsTEST_FLAGS_NO_ERROR, pcName, pulAddresses, usAnswers, ulTTL, pdFALSE );
+
+    TEST_ASSERT_EQUAL_HEX32( pulAddresses[ usAnswers - 1U ], prvParseDNSReply( ucBuffer, uxLength, pdTRUE ) );
+}
+
+/*
+ * @brief Look up a name with FreeRTOS_gethostbyname_a().  The identifier can
+ *        not be generated, so no query is sent when the name is not cached.
+ */
+static uint32_t prvLookUpWithCallback( const char * pcName )
+{
+    FreeRTOS_inet_addr_ExpectAndReturn( pcName, 0U );
+    xApplicationGetRandomNumber_IgnoreAndReturn( pdFALSE );
+
+    return FreeRTOS_gethostbyname_a( pcName, prvDNSCallback, NULL, 0U );
+}
+
+/*
+ * @brief An address that was received can be found, also when the case of the
+ *        name differs.
+ */
+void test_prvProcessDNSCache_Hash_AddressIsFound( void )
+{
+    uint32_t ulAddress = 0x0A0B0C0DU;
+
+    prvResetDNSCache();
+
+    prvStoreAddresses( "Www.Example.COM", &ulAddress, 1U, 300U );
+
+    TEST_ASSERT_EQUAL_HEX32( ulAddress, FreeRTOS_dnslookup( "www.example.com" ) );
+    TEST_ASSERT_EQUAL_HEX32( ulAddress, FreeRTOS_dnslookup( "WWW.EXAMPLE.COM" ) );
+    TEST_ASSERT_EQUAL_HEX32( 0U, FreeRTOS_dnslookup( "www.example.org" ) );
+    TEST_ASSERT_EQUAL_HEX32( 0U, FreeRTOS_dnslookup( "www.example.co" ) );
+}
+
+/*
+ * @brief An entry is removed when its TTL has passed.
+ */
+void test_prvProcessDNSCache_Hash_EntryExpires( void )
+{
+    uint32_t ulAddress = 0x0A0B0C0DU;
+
+    prvResetDNSCache();
+
+    prvStoreAddresses( "www.example.com", &ulAddress, 1U, 300U );
+
+    prvSetSeconds( 1299U );
+    TEST_ASSERT_EQUAL_HEX32( ulAddress, FreeRTOS_dnslookup( "www.example.com" ) );
+
+    prvSetSeconds( 1300U );
+    TEST_ASSERT_EQUAL_HEX32( 0U, FreeRTOS_dnslookup( "www.example.com" ) );
+
+    /* Also when the time goes back, the entry is gone. */
+    prvSetSeconds( 1000U );
+    TEST_ASSERT_EQUAL_HEX32( 0U, FreeRTOS_dnslookup( "www.example.com" ) );
+}
+
+/*
+ * @brief The addresses of a name are returned in turn, and an address that is
+ *        received twice is stored once.
+ */
+void test_prvProcessDNSCache_Hash_MultipleAddresses( void )
+{
+    uint32_t ulAddresses[ 3 ] = { 0x0A000001U, 0x0A000002U, 0x0A000001U };
+
+    prvResetDNSCache();
+
+    prvStoreAddresses( "www.example.com", ulAddresses, 3U, 300U );
+
+    TEST_ASSERT_EQUAL_HEX32( ulAddresses[ 0 ], FreeRTOS_dnslookup( "www.example.com" ) );
+    TEST_ASSERT_EQUAL_HEX32( ulAddresses[ 1 ], FreeRTOS_dnslookup( "www.example.com" ) );
+    TEST_ASSERT_EQUAL_HEX32( ulAddresses[ 0 ], FreeRTOS_dnslookup( "www.example.com" ) );
+    TEST_ASSERT_EQUAL_HEX32( ulAddresses[ 1 ], FreeRTOS_dnslookup( "www.example.com" ) );
+}
+
+/*
+ * @brief When the cache is full, the least recently used entry is replaced.
+ */
+void test_prvProcessDNSCache_Hash_ReplacesLeastRecentlyUsed( void )
+{
+    static const char * const pcNames[] = { "host0.example.com", "host1.example.com", "host2.example.com", "host3.example.com", "host4.example.com" };
+    uint32_t ulAddress;
+    BaseType_t x;
+
+    prvResetDNSCache();
+
+    for( x = 0; x < ipconfigDNS_CACHE_ENTRIES; x++ )
+    {
+        ulAddress = 0x0A000001U + ( uint32_t ) x;
+        prvStoreAddresses( pcNames[ x ], &ulAddress, 1U, 300U );
+    }
+
+    /* Use the first entry, the second one is now the least recently used. */
+    TEST_ASSERT_EQUAL_HEX32( 0x0A000001U, FreeRTOS_dnslookup( pcNames[ 0 ] ) );
+
+    ulAddress = 0x0A000010U;
+    prvStoreAddresses( pcNames[ ipconfigDNS_CACHE_ENTRIES ], &ulAddress, 1U, 300U );
+
+    TEST_ASSERT_EQUAL_HEX32( 0x0A000001U, FreeRTOS_dnslookup( pcNames[ 0 ] ) );
+    TEST_ASSERT_EQUAL_HEX32( 0U, FreeRTOS_dnslookup( pcNames[ 1 ] ) );
+
+    for( x = 2; x < ipconfigDNS_CACHE_ENTRIES; x++ )
+    {
+        TEST_ASSERT_EQUAL_HEX32( 0x0A000001U + ( uint32_t ) x, FreeRTOS_dnslookup( pcNames[ x ] ) );
+    }
+
+    TEST_ASSERT_EQUAL_HEX32( 0x0A000010U, FreeRTOS_dnslookup( pcNames[ ipconfigDNS_CACHE_ENTRIES ] ) );
+}
+
+/*
+ * @brief Long names that do not fit in the name arena together replace the
+ *        least recently used entries, the others keep their names.
+ */
+void test_prvProcessDNSCache_Hash_NameArenaFull( void )
+{
+    char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ];
+    uint32_t ulAddress;
+    size_t uxLength = ( ipconfigDNS_CACHE_NAME_ARENA_SIZE / 2U ) + 1U;
+    BaseType_t x;
+
+    prvResetDNSCache();
+
+    TEST_ASSERT_LESS_THAN( sizeof( pcName ), uxLength );
+
+    /* Two short names. */
+    ulAddress = 0x0A000001U;
+    prvStoreAddresses( "a.example.com", &ulAddress, 1U, 300U );
+    ulAddress = 0x0A000002U;
+    prvStoreAddresses( "b.example.com", &ulAddress, 1U, 300U );
+
+    /* Two long names, each taking more than half of the arena. */
+    for( x = 0; x < 2; x++ )
+    {
+        memset( pcName, 'a' + ( char ) x, uxLength );
+        memcpy( &( pcName[ uxLength - 4U ] ), ".com", 4U );
+        pcName[ uxLength ] = '\0';
+
+        ulAddress = 0x0A000011U + ( uint32_t ) x;
+        prvStoreAddresses( pcName, &ulAddress, 1U, 300U );
+    }
+
+    /* Only the last long name is left. */
+    TEST_ASSERT_EQUAL_HEX32( 0x0A000012U, FreeRTOS_dnslookup( pcName ) );
+    pcName[ 0 ] = 'a';
+    TEST_ASSERT_EQUAL_HEX32( 0U, FreeRTOS_dnslookup( pcName ) );
+    TEST_ASSERT_EQUAL_HEX32( 0U, FreeRTOS_dnslookup( "a.example.com" ) );
+
+    /* A short name can be added again after compaction. */
+    ulAddress = 0x0A000003U;
+    prvStoreAddresses( "c.example.com", &ulAddress, 1U, 300U );
+    TEST_ASSERT_EQUAL_HEX32( 0x0A000003U, FreeRTOS_dnslookup( "c.example.com" ) );
+}
+
+/*
+ * @brief An NXDOMAIN reply is cached as a negative answer, for the lower of the
+ *        SOA TTL and its MINIMUM field.  Meanwhile, a look-up fails at once.
+ */
+void test_prvParseDNSReply_Hash_NXDOMAINIsCached( void )
+{
+    uint8_t ucBuffer[ 512 ];
+    size_t uxLength;
+
+    prvResetDNSCache();
+
+    uxLength = prvBuildReply( ucBuffer, dnsTEST_FLAGS_NXDOMAIN, "nowhere.example.com", NULL, 0U, 0U, pdTRUE );
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvParseDNSReply( ucBuffer, uxLength, pdTRUE ) );
+
+    TEST_ASSERT_EQUAL_HEX32( 0U, FreeRTOS_dnslookup( "nowhere.example.com" ) );
+
+    /* The call-back is called at once, with address zero. */
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvLookUpWithCallback( "nowhere.example.com" ) );
+    TEST_ASSERT_EQUAL( 1, xCallbackCount );
+    TEST_ASSERT_EQUAL_HEX32( 0U, ulCallbackAddress );
+
+    /* After the MINIMUM field of the SOA record, a query would be sent. */
+    prvSetSeconds( 1000U + dnsTEST_SOA_MINIMUM );
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvLookUpWithCallback( "nowhere.example.com" ) );
+    TEST_ASSERT_EQUAL( 1, xCallbackCount );
+}
+
+/*
+ * @brief A reply without an address is cached as a negative answer, a reply
+ *        without an SOA record is not cached.
+ */
+void test_prvParseDNSReply_Hash_NoAddressIsCached( void )
+{
+    uint8_t ucBuffer[ 512 ];
+    size_t uxLength;
+
+    prvResetDNSCache();
+
+    uxLength = prvBuildReply( ucBuffer, dnsTEST_FLAGS_NO_ERROR, "empty.example.com", NULL, 0U, 0U, pdTRUE );
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvParseDNSReply( ucBuffer, uxLength, pdTRUE ) );
+
+    uxLength = prvBuildReply( ucBuffer, dnsTEST_FLAGS_NXDOMAIN, "nosoa.example.com", NULL, 0U, 0U, pdFALSE );
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvParseDNSReply( ucBuffer, uxLength, pdTRUE ) );
+
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvLookUpWithCallback( "empty.example.com" ) );
+    TEST_ASSERT_EQUAL( 1, xCallbackCount );
+
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvLookUpWithCallback( "nosoa.example.com" ) );
+    TEST_ASSERT_EQUAL( 1, xCallbackCount );
+}
+
+/*
+ * @brief A reply that was not expected does not create a negative answer.
+ */
+void test_prvParseDNSReply_Hash_UnexpectedNXDOMAIN( void )
+{
+    uint8_t ucBuffer[ 512 ];
+    size_t uxLength;
+
+    prvResetDNSCache();
+
+    uxLength = prvBuildReply( ucBuffer, dnsTEST_FLAGS_NXDOMAIN, "nowhere.example.com", NULL, 0U, 0U, pdTRUE );
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvParseDNSReply( ucBuffer, uxLength, pdFALSE ) );
+
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvLookUpWithCallback( "nowhere.example.com" ) );
+    TEST_ASSERT_EQUAL( 0, xCallbackCount );
+}
+
+/*
+ * @brief An address that is received replaces a negative answer.
+ */
+void test_prvParseDNSReply_Hash_AddressReplacesNegative( void )
+{
+    uint8_t ucBuffer[ 512 ];
+    size_t uxLength;
+    uint32_t ulAddress = 0x0A0B0C0DU;
+
+    prvResetDNSCache();
+
+    uxLength = prvBuildReply( ucBuffer, dnsTEST_FLAGS_NXDOMAIN, "www.example.com", NULL, 0U, 0U, pdTRUE );
+    TEST_ASSERT_EQUAL_HEX32( 0U, prvParseDNSReply( ucBuffer, uxLength, pdTRUE ) );
+
+    prvStoreAddresses( "www.example.com", &ulAddress, 1U, 300U );
+
+    TEST_ASSERT_EQUAL_HEX32( ulAddress, prvLookUpWithCallback( "www.example.com" ) );
+    TEST_ASSERT_EQUAL( 1, xCallbackCount );
+    TEST_ASSERT_EQUAL_HEX32( ulAddress, ulCallbackAddress );
+}
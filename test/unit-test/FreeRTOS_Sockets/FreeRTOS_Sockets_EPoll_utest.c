@@ -0,0 +1,569 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_Sockets_list_macros.h"
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_NetworkInterface.h"
+#include "mock_FreeRTOS_DHCP.h"
+#include "mock_FreeRTOS_DNS.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+
+#include "FreeRTOS_Sockets.h"
+
+#include "FreeRTOS_Sockets_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigSUPPORT_EPOLL defined as 1,
+ * see ut.cmake. */
+
+/* The number of sockets that are used in this file. */
+#define epollSOCKET_COUNT    3
+
+/* The sockets that are registered to the epoll set.  They are UDP sockets, which
+ * are ready for reading while packets are waiting. */
+static FreeRTOS_Socket_t xSockets[ epollSOCKET_COUNT ];
+
+/* The value that is returned by xEventGroupCreate(). */
+static StaticEventGroup_t xEventGroup;
+
+/* The number of times that the event group of the epoll set was set. */
+static BaseType_t xSetBitsCount;
+
+/* When not NULL, this socket is signalled while FreeRTOS_epoll_wait() blocks. */
+static FreeRTOS_Socket_t * pxSignalWhileWaiting;
+
+/*
+ * @brief The list functions are mocked, these stubs behave like the kernel's
+ *        implementation, because the epoll set depends on the order of its
+ *        ready list.
+ */
+static void prvListInitialiseStub( List_t * const pxList,
+                                   int callback_count )
+{
+    ( void ) callback_count;
+
+    pxList->pxIndex = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->xListEnd.xItemValue = portMAX_DELAY;
+    pxList->xListEnd.pxNext = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->xListEnd.pxPrevious = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->uxNumberOfItems = 0U;
+}
+
+static void prvListInitialiseItemStub( ListItem_t * const pxItem,
+                                       int callback_count )
+{
+    ( void ) callback_count;
+
+    pxItem->pxContainer = NULL;
+}
+
+static void prvListInsertEndStub( List_t * const pxList,
+                                  ListItem_t * const pxNewListItem,
+                                  int callback_count )
+{
+    ListItem_t * const pxIndex = pxList->pxIndex;
+
+    ( void ) callback_count;
+
+    pxNewListItem->pxNext = pxIndex;
+    pxNewListItem->pxPrevious = pxIndex->pxPrevious;
+    pxIndex->pxPrevious->pxNext = pxNewListItem;
+    pxIndex->pxPrevious = pxNewListItem;
+    pxNewListItem->pxContainer = pxList;
+    pxList->uxNumberOfItems++;
+}
+
+static UBaseType_t prvListRemoveStub( ListItem_t * const pxItemToRemove,
+                                      int callback_count )
+{
+    List_t * const pxList = pxItemToRemove->pxContainer;
+
+    ( void ) callback_count;
+
+    pxItemToRemove->pxNext->pxPrevious = pxItemToRemove->pxPrevious;
+    pxItemToRemove->pxPrevious->pxNext = pxItemToRemove->pxNext;
+
+    if( pxList->pxIndex == pxItemToRemove )
+    {
+        pxList->pxIndex = pxItemToRemove->pxPrevious;
+    }
+
+    pxItemToRemove->pxContainer = NULL;
+    pxList->uxNumberOfItems--;
+
+    return pxList->uxNumberOfItems;
+}
+
+/*
+ * @brief Count the number of times that the epoll set is woken up.
+ */
+static EventBits_t prvEventGroupSetBitsStub( EventGroupHandle_t xEventGroup,
+                                             const EventBits_t uxBitsToSet,
+                                             int callback_count )
+{
+    ( void ) xEventGroup;
+    ( void ) callback_count;
+
+    xSetBitsCount++;
+
+    return uxBitsToSet;
+}
+
+/*
+ * @brief While FreeRTOS_epoll_wait() blocks, the IP-task signals a socket.
+ */
+static EventBits_t prvEventGroupWaitBitsStub( EventGroupHandle_t xEventGroup,
+                                              const EventBits_t uxBitsToWaitFor,
+                                              const BaseType_t xClearOnExit,
+                                              const BaseType_t xWaitForAllBits,
+                                              TickType_t xTicksToWait,
+                                              int callback_count )
+{
+    ( void ) xEventGroup;
+    ( void ) xClearOnExit;
+    ( void ) xWaitForAllBits;
+    ( void ) xTicksToWait;
+    ( void ) callback_count;
+
+    TEST_ASSERT_NOT_NULL( pxSignalWhileWaiting );
+    pxSignalWhileWaiting->u.xUDP.xWaitingPacketsList.uxNumberOfItems = 1U;
+    vSocketEPollSignal( pxSignalWhileWaiting, ( EventBits_t ) eSELECT_READ );
+    pxSignalWhileWaiting = NULL;
+
+    return uxBitsToWaitFor;
+}
+
+/*
+ * @brief Install the stubs, and prepare the sockets.
+ */
+static void prvResetSockets( void )
+{
+    BaseType_t xIndex;
+
+    vListInitialise_Stub( prvListInitialiseStub );
+    vListInitialiseItem_Stub( prvListInitialiseItemStub );
+    vListInsertEnd_Stub( prvListInsertEndStub );
+    uxListRemove_Stub( prvListRemoveStub );
+    xEventGroupSetBits_Stub( prvEventGroupSetBitsStub );
+    xEventGroupClearBits_IgnoreAndReturn( 0U );
+    vTaskSuspendAll_Ignore();
+    xTaskResumeAll_IgnoreAndReturn( pdFALSE );
+
+    memset( xSockets, 0, sizeof( xSockets ) );
+
+    for( xIndex = 0; xIndex < epollSOCKET_COUNT; xIndex++ )
+    {
+        xSockets[ xIndex ].ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_UDP;
+        prvListInitialiseItemStub( &( xSockets[ xIndex ].xEPollMemberItem ), 0 );
+        xSockets[ xIndex ].xEPollMemberItem.pvOwner = &( xSockets[ xIndex ] );
+        prvListInitialiseItemStub( &( xSockets[ xIndex ].xEPollReadyItem ), 0 );
+        xSockets[ xIndex ].xEPollReadyItem.pvOwner = &( xSockets[ xIndex ] );
+    }
+
+    xSetBitsCount = 0;
+    pxSignalWhileWaiting = NULL;
+}
+
+/*
+ * @brief Create an epoll set.
+ */
+static EPollSet_t prvCreateEPoll( void )
+{
+    EPollSet_t xEPoll;
+
+    xEventGroupCreate_ExpectAndReturn( ( EventGroupHandle_t ) &( xEventGroup ) );
+
+    xEPoll = FreeRTOS_epoll_create();
+    TEST_ASSERT_NOT_NULL( xEPoll );
+
+    return xEPoll;
+}
+
+/*
+ * @brief Delete an epoll set.
+ */
+static void prvDeleteEPoll( EPollSet_t xEPoll )
+{
+    vEventGroupDelete_Expect( ( EventGroupHandle_t ) &( xEventGroup ) );
+
+    FreeRTOS_epoll_delete( xEPoll );
+}
+
+/*
+ * @brief Wait for sockets without blocking.
+ */
+static BaseType_t prvPoll( EPollSet_t xEPoll,
+                           EPollEvent_t * pxEvents,
+                           BaseType_t xMaxEvents )
+{
+    vTaskSetTimeOutState_Ignore();
+    xTaskCheckForTimeOut_IgnoreAndReturn( pdTRUE );
+
+    return FreeRTOS_epoll_wait( xEPoll, pxEvents, xMaxEvents, 0U );
+}
+
+/*
+ * @brief No epoll set is made when its event group can not be created.
+ */
+void test_FreeRTOS_epoll_create_NoEventGroup( void )
+{
+    prvResetSockets();
+
+    xEventGroupCreate_ExpectAndReturn( NULL );
+
+    TEST_ASSERT_NULL( FreeRTOS_epoll_create() );
+}
+
+/*
+ * @brief FreeRTOS_epoll_ctl() checks its parameters and the registration of
+ *        the socket.
+ */
+void test_FreeRTOS_epoll_ctl_Errors( void )
+{
+    EPollSet_t xEPoll, xOtherEPoll;
+    SocketSelect_t xSocketSet;
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+    xOtherEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, FreeRTOS_epoll_ctl( NULL, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, NULL, eSELECT_READ, NULL ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, FREERTOS_INVALID_SOCKET, eSELECT_READ, NULL ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, FreeRTOS_epoll_ctl( xEPoll, 0, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+
+    /* The socket is not registered yet. */
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_ENOENT, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_MOD, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_ENOENT, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_DEL, &( xSockets[ 0 ] ), 0U, NULL ) );
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EEXIST, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EEXIST, FreeRTOS_epoll_ctl( xOtherEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_ENOENT, FreeRTOS_epoll_ctl( xOtherEPoll, FREERTOS_EPOLL_CTL_DEL, &( xSockets[ 0 ] ), 0U, NULL ) );
+
+    /* A socket that belongs to a socket set can not be registered. */
+    xSockets[ 1 ].pxSocketSet = &( xSocketSet );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EBUSY, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 1 ] ), eSELECT_READ, NULL ) );
+
+    prvDeleteEPoll( xOtherEPoll );
+    prvDeleteEPoll( xEPoll );
+
+    /* The sockets were unregistered. */
+    TEST_ASSERT_NULL( xSockets[ 0 ].pxEPollSet );
+    TEST_ASSERT_NULL( xSockets[ 0 ].xEPollMemberItem.pxContainer );
+}
+
+/*
+ * @brief FreeRTOS_epoll_wait() checks its parameters.
+ */
+void test_FreeRTOS_epoll_wait_Errors( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ 1 ];
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, FreeRTOS_epoll_wait( NULL, xEvents, 1, 0U ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, FreeRTOS_epoll_wait( xEPoll, NULL, 1, 0U ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, FreeRTOS_epoll_wait( xEPoll, xEvents, 0, 0U ) );
+
+    /* Nothing is ready. */
+    TEST_ASSERT_EQUAL( 0, prvPoll( xEPoll, xEvents, 1 ) );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief A socket that is ready when it is registered is reported at once.
+ */
+void test_FreeRTOS_epoll_ctl_ReadyWhenAdded( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+    int xData = 0;
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    xSockets[ 0 ].u.xUDP.xWaitingPacketsList.uxNumberOfItems = 1U;
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ, &( xData ) ) );
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 1 ] ), eSELECT_READ, NULL ) );
+    TEST_ASSERT_EQUAL( 1, xSetBitsCount );
+
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSockets[ 0 ] ), xEvents[ 0 ].xSocket );
+    TEST_ASSERT_EQUAL( eSELECT_READ, xEvents[ 0 ].xEvents );
+    TEST_ASSERT_EQUAL_PTR( &( xData ), xEvents[ 0 ].pvData );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief Only the events of interest put a socket in the ready list.
+ */
+void test_vSocketEPollSignal_EventsOfInterest( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_WRITE );
+    TEST_ASSERT_NULL( xSockets[ 0 ].xEPollReadyItem.pxContainer );
+    TEST_ASSERT_EQUAL( 0, xSetBitsCount );
+
+    /* A socket that is not registered is ignored. */
+    vSocketEPollSignal( &( xSockets[ 1 ] ), ( EventBits_t ) eSELECT_READ );
+    TEST_ASSERT_NULL( xSockets[ 1 ].xEPollReadyItem.pxContainer );
+
+    xSockets[ 0 ].u.xUDP.xWaitingPacketsList.uxNumberOfItems = 1U;
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_READ );
+    /* A second signal does not add the socket twice. */
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_READ );
+    TEST_ASSERT_EQUAL( 2, xSetBitsCount );
+
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSockets[ 0 ] ), xEvents[ 0 ].xSocket );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief The IP-task signals a socket through vSocketWakeUpUser().
+ */
+void test_vSocketWakeUpUser_SignalsEPoll( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 2 ] ), eSELECT_READ, NULL ) );
+
+    xSockets[ 2 ].u.xUDP.xWaitingPacketsList.uxNumberOfItems = 1U;
+    xSockets[ 2 ].xEventBits = ( ( EventBits_t ) eSELECT_READ ) << SOCKET_EVENT_BIT_COUNT;
+
+    vSocketWakeUpUser( &( xSockets[ 2 ] ) );
+
+    TEST_ASSERT_EQUAL( 0U, xSockets[ 2 ].xEventBits );
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSockets[ 2 ] ), xEvents[ 0 ].xSocket );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief A level-triggered socket is reported for as long as it is ready.
+ */
+void test_FreeRTOS_epoll_wait_LevelTriggered( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+
+    xSockets[ 0 ].u.xUDP.xWaitingPacketsList.uxNumberOfItems = 2U;
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_READ );
+
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_NOT_NULL( xSockets[ 0 ].xEPollReadyItem.pxContainer );
+
+    /* All packets have been read. */
+    xSockets[ 0 ].u.xUDP.xWaitingPacketsList.uxNumberOfItems = 0U;
+
+    TEST_ASSERT_EQUAL( 0, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_NULL( xSockets[ 0 ].xEPollReadyItem.pxContainer );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief An edge-triggered socket is reported once after each signal.
+ */
+void test_FreeRTOS_epoll_wait_EdgeTriggered( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ | FREERTOS_EPOLL_EDGE, NULL ) );
+
+    xSockets[ 0 ].u.xUDP.xWaitingPacketsList.uxNumberOfItems = 2U;
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_READ );
+
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_EQUAL( eSELECT_READ, xEvents[ 0 ].xEvents );
+
+    /* Still ready, but there was no new event. */
+    TEST_ASSERT_EQUAL( 0, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_NULL( xSockets[ 0 ].xEPollReadyItem.pxContainer );
+
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_READ );
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief When more sockets are ready than fit in the array, the others are
+ *        reported in the next call, in the order in which they became ready.
+ */
+void test_FreeRTOS_epoll_wait_MaxEvents( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+    BaseType_t xIndex;
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    for( xIndex = 0; xIndex < epollSOCKET_COUNT; xIndex++ )
+    {
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ xIndex ] ), eSELECT_READ | FREERTOS_EPOLL_EDGE, NULL ) );
+    }
+
+    vSocketEPollSignal( &( xSockets[ 2 ] ), ( EventBits_t ) eSELECT_READ );
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_READ );
+    vSocketEPollSignal( &( xSockets[ 1 ] ), ( EventBits_t ) eSELECT_READ );
+
+    TEST_ASSERT_EQUAL( 2, prvPoll( xEPoll, xEvents, 2 ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSockets[ 2 ] ), xEvents[ 0 ].xSocket );
+    TEST_ASSERT_EQUAL_PTR( &( xSockets[ 0 ] ), xEvents[ 1 ].xSocket );
+
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, 2 ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSockets[ 1 ] ), xEvents[ 0 ].xSocket );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief A socket that is unregistered leaves the ready list as well.
+ */
+void test_FreeRTOS_epoll_ctl_DeleteReadySocket( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_READ, NULL ) );
+    xSockets[ 0 ].u.xUDP.xWaitingPacketsList.uxNumberOfItems = 1U;
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_READ );
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_DEL, &( xSockets[ 0 ] ), 0U, NULL ) );
+
+    TEST_ASSERT_NULL( xSockets[ 0 ].pxEPollSet );
+    TEST_ASSERT_NULL( xSockets[ 0 ].xEPollReadyItem.pxContainer );
+    TEST_ASSERT_EQUAL( 0U, xSockets[ 0 ].xSelectBits );
+    TEST_ASSERT_EQUAL( 0, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief FREERTOS_EPOLL_CTL_MOD changes the events of interest and the data.
+ */
+void test_FreeRTOS_epoll_ctl_Modify( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+    int xData = 0;
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 0 ] ), eSELECT_EXCEPT, NULL ) );
+    xSockets[ 0 ].u.xUDP.xWaitingPacketsList.uxNumberOfItems = 1U;
+    vSocketEPollSignal( &( xSockets[ 0 ] ), ( EventBits_t ) eSELECT_READ );
+    TEST_ASSERT_EQUAL( 0, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+
+    /* The socket is ready for the new events, so it is reported at once. */
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_MOD, &( xSockets[ 0 ] ), eSELECT_READ, &( xData ) ) );
+
+    TEST_ASSERT_EQUAL( 1, prvPoll( xEPoll, xEvents, epollSOCKET_COUNT ) );
+    TEST_ASSERT_EQUAL_PTR( &( xData ), xEvents[ 0 ].pvData );
+
+    prvDeleteEPoll( xEPoll );
+}
+
+/*
+ * @brief FreeRTOS_epoll_wait() blocks until a socket is signalled.
+ */
+void test_FreeRTOS_epoll_wait_Blocks( void )
+{
+    EPollSet_t xEPoll;
+    EPollEvent_t xEvents[ epollSOCKET_COUNT ];
+
+    prvResetSockets();
+    xEPoll = prvCreateEPoll();
+
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_epoll_ctl( xEPoll, FREERTOS_EPOLL_CTL_ADD, &( xSockets[ 1 ] ), eSELECT_READ, NULL ) );
+    pxSignalWhileWaiting = &( xSockets[ 1 ] );
+
+    vTaskSetTimeOutState_Ignore();
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xEventGroupWaitBits_Stub( prvEventGroupWaitBitsStub );
+
+    TEST_ASSERT_EQUAL( 1, FreeRTOS_epoll_wait( xEPoll, xEvents, epollSOCKET_COUNT, pdMS_TO_TICKS( 1000U ) ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSockets[ 1 ] ), xEvents[ 0 ].xSocket );
+    TEST_ASSERT_NULL( pxSignalWhileWaiting );
+
+    prvDeleteEPoll( xEPoll );
+}
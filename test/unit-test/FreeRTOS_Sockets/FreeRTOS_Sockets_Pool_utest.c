@@ -0,0 +1,445 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_Sockets_list_macros.h"
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_NetworkInterface.h"
+#include "mock_FreeRTOS_DHCP.h"
+#include "mock_FreeRTOS_DNS.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+
+#include "FreeRTOS_Sockets.h"
+
+#include "FreeRTOS_Sockets_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigSOCKET_POOL and
+ * ipconfigSUPPORT_STATIC_SOCKETS defined as 1, and with small pools, see
+ * ut.cmake. */
+
+/* The size of a block in the pool of UDP sockets. */
+#define poolUDP_BLOCK_SIZE                                                                                        \
+    ( ( ( ( sizeof( FreeRTOS_Socket_t ) - sizeof( ( ( const FreeRTOS_Socket_t * ) NULL )->u ) ) + sizeof( IPUDPSocket_t ) ) \
+        + 7U ) & ~( ( size_t ) 7U ) )
+
+/* A stream length that fits in the small and in the large blocks. */
+#define poolSMALL_STREAM_LENGTH    1000U
+
+/* A stream length that only fits in the large blocks. */
+#define poolLARGE_STREAM_LENGTH    ( 8U * ipconfigTCP_MSS )
+
+/* A stream length that does not fit in any of the pools. */
+#define poolHUGE_STREAM_LENGTH     ( 32U * ipconfigTCP_MSS )
+
+/* The value that is returned by xEventGroupCreate(). */
+static StaticEventGroup_t xEventGroup;
+
+/* The handle of the task that closes a static socket. */
+static StaticTask_t xCloseTask;
+
+/* The number of times that the closing task waited for its notification. */
+static BaseType_t xNotifyTakeCount;
+
+/* The memory of a static socket. */
+static StaticSocket_t xStaticSocket;
+
+/*
+ * @brief The list functions are mocked, these stubs behave like the kernel's
+ *        implementation, so that vNetworkSocketsInit() leaves valid lists.
+ */
+static void prvListInitialiseStub( List_t * const pxList,
+                                   int callback_count )
+{
+    ( void ) callback_count;
+
+    pxList->pxIndex = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->xListEnd.xItemValue = portMAX_DELAY;
+    pxList->xListEnd.pxNext = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->xListEnd.pxPrevious = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->uxNumberOfItems = 0U;
+}
+
+static void prvListInitialiseItemStub( ListItem_t * const pxItem,
+                                       int callback_count )
+{
+    ( void ) callback_count;
+
+    pxItem->pxContainer = NULL;
+}
+
+/*
+ * @brief The IP-task handles the close event at once.
+ */
+static BaseType_t prvSendCloseEventStub( const IPStackEvent_t * pxEvent,
+                                         TickType_t uxTimeout,
+                                         int callback_count )
+{
+    ( void ) uxTimeout;
+    ( void ) callback_count;
+
+    TEST_ASSERT_EQUAL( eSocketCloseEvent, pxEvent->eEventType );
+    ( void ) vSocketClose( ( FreeRTOS_Socket_t * ) pxEvent->pvData );
+
+    return pdPASS;
+}
+
+/*
+ * @brief The first wake-up is caused by a notification that was left from an
+ *        earlier wait, during the second wait the IP-task closes the socket.
+ */
+static uint32_t prvNotifyTakeStub( UBaseType_t uxIndexToWaitOn,
+                                   BaseType_t xClearCountOnExit,
+                                   TickType_t xTicksToWait,
+                                   int callback_count )
+{
+    ( void ) xClearCountOnExit;
+    ( void ) xTicksToWait;
+
+    TEST_ASSERT_EQUAL( ipconfigSOCKET_NOTIFY_INDEX, uxIndexToWaitOn );
+
+    if( callback_count == 1 )
+    {
+        ( void ) vSocketClose( ( FreeRTOS_Socket_t * ) &( xStaticSocket ) );
+    }
+
+    xNotifyTakeCount++;
+
+    return 1U;
+}
+
+/*
+ * @brief Install the stubs, and initialise the socket lists and the pools.
+ */
+static void prvResetPools( void )
+{
+    vListInitialise_Stub( prvListInitialiseStub );
+    vListInitialiseItem_Stub( prvListInitialiseItemStub );
+    uxListRemove_IgnoreAndReturn( 0U );
+    xIPIsNetworkTaskReady_IgnoreAndReturn( pdTRUE );
+    FreeRTOS_round_up_IgnoreAndReturn( ipconfigTCP_TX_BUFFER_LENGTH );
+    FreeRTOS_max_uint32_IgnoreAndReturn( 1U );
+    vEventGroupDelete_Ignore();
+    vTCPWindowDestroy_Ignore();
+    uxStreamBufferAdd_IgnoreAndReturn( 0U );
+
+    vNetworkSocketsInit();
+
+    xNotifyTakeCount = 0;
+}
+
+/*
+ * @brief Create a socket, and check that it is valid.
+ */
+static FreeRTOS_Socket_t * prvCreateSocket( BaseType_t xProtocol )
+{
+    FreeRTOS_Socket_t * pxSocket;
+    BaseType_t xType = ( xProtocol == FREERTOS_IPPROTO_UDP ) ? FREERTOS_SOCK_DGRAM : FREERTOS_SOCK_STREAM;
+
+    xEventGroupCreate_ExpectAndReturn( ( EventGroupHandle_t ) &( xEventGroup ) );
+
+    pxSocket = ( FreeRTOS_Socket_t * ) FreeRTOS_socket( FREERTOS_AF_INET, xType, xProtocol );
+
+    TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, pxSocket );
+    TEST_ASSERT_NOT_NULL( pxSocket );
+
+    return pxSocket;
+}
+
+/*
+ * @brief Let a TCP socket create an rxStream of the given length.
+ */
+static StreamBuffer_t * prvCreateRxStream( FreeRTOS_Socket_t * pxSocket,
+                                           size_t uxLength )
+{
+    pxSocket->u.xTCP.uxRxStreamSize = uxLength;
+
+    /* A non-zero offset stores data out-of-order, which only needs the stream. */
+    TEST_ASSERT_EQUAL( 0, lTCPAddRxdata( pxSocket, 1U, NULL, 0U ) );
+    TEST_ASSERT_NOT_NULL( pxSocket->u.xTCP.rxStream );
+
+    return pxSocket->u.xTCP.rxStream;
+}
+
+/*
+ * @brief UDP sockets are taken from their pool until it is exhausted, then from
+ *        the heap.  Closed sockets return to the pool.
+ */
+void test_FreeRTOS_socket_UDPPool( void )
+{
+    FreeRTOS_Socket_t * pxFirst, * pxSecond, * pxHeap, * pxAgain;
+    uintptr_t uxStart;
+
+    prvResetPools();
+
+    pxFirst = prvCreateSocket( FREERTOS_IPPROTO_UDP );
+    pxSecond = prvCreateSocket( FREERTOS_IPPROTO_UDP );
+    pxHeap = prvCreateSocket( FREERTOS_IPPROTO_UDP );
+
+    /* The blocks of the pool are taken in order. */
+    uxStart = ( uintptr_t ) pxFirst;
+    TEST_ASSERT_EQUAL_PTR( uxStart + poolUDP_BLOCK_SIZE, pxSecond );
+    TEST_ASSERT_TRUE( ( ( uintptr_t ) pxHeap < uxStart ) ||
+                      ( ( uintptr_t ) pxHeap >= ( uxStart + ( ipconfigSOCKET_POOL_UDP_COUNT * poolUDP_BLOCK_SIZE ) ) ) );
+
+    /* The heap socket is given back to the heap, the other one to the pool. */
+    ( void ) vSocketClose( pxHeap );
+    ( void ) vSocketClose( pxSecond );
+
+    pxAgain = prvCreateSocket( FREERTOS_IPPROTO_UDP );
+    TEST_ASSERT_EQUAL_PTR( pxSecond, pxAgain );
+    TEST_ASSERT_EQUAL( FREERTOS_IPPROTO_UDP, pxAgain->ucProtocol );
+
+    ( void ) vSocketClose( pxAgain );
+    ( void ) vSocketClose( pxFirst );
+}
+
+/*
+ * @brief A block is given back to the pool when the event group of the socket
+ *        can not be created.
+ */
+void test_FreeRTOS_socket_NoEventGroup( void )
+{
+    FreeRTOS_Socket_t * pxFirst, * pxSecond;
+
+    prvResetPools();
+
+    pxFirst = prvCreateSocket( FREERTOS_IPPROTO_UDP );
+
+    xEventGroupCreate_ExpectAndReturn( NULL );
+    TEST_ASSERT_EQUAL( FREERTOS_INVALID_SOCKET, FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP ) );
+
+    pxSecond = prvCreateSocket( FREERTOS_IPPROTO_UDP );
+    TEST_ASSERT_EQUAL_PTR( ( uintptr_t ) pxFirst + poolUDP_BLOCK_SIZE, pxSecond );
+
+    ( void ) vSocketClose( pxSecond );
+    ( void ) vSocketClose( pxFirst );
+}
+
+/*
+ * @brief TCP sockets have a pool of their own, UDP sockets are not taken from it.
+ */
+void test_FreeRTOS_socket_TCPPool( void )
+{
+    FreeRTOS_Socket_t * pxUDP[ ipconfigSOCKET_POOL_UDP_COUNT ];
+    FreeRTOS_Socket_t * pxTCP, * pxHeap, * pxAgain;
+    BaseType_t xIndex;
+
+    prvResetPools();
+
+    for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigSOCKET_POOL_UDP_COUNT; xIndex++ )
+    {
+        pxUDP[ xIndex ] = prvCreateSocket( FREERTOS_IPPROTO_UDP );
+    }
+
+    pxTCP = prvCreateSocket( FREERTOS_IPPROTO_TCP );
+    pxHeap = prvCreateSocket( FREERTOS_IPPROTO_TCP );
+    TEST_ASSERT_EQUAL( FREERTOS_IPPROTO_TCP, pxTCP->ucProtocol );
+    TEST_ASSERT_EQUAL( ipconfigTCP_MSS, pxTCP->u.xTCP.usMSS );
+
+    ( void ) vSocketClose( pxTCP );
+
+    pxAgain = prvCreateSocket( FREERTOS_IPPROTO_TCP );
+    TEST_ASSERT_EQUAL_PTR( pxTCP, pxAgain );
+
+    ( void ) vSocketClose( pxAgain );
+    ( void ) vSocketClose( pxHeap );
+
+    for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigSOCKET_POOL_UDP_COUNT; xIndex++ )
+    {
+        ( void ) vSocketClose( pxUDP[ xIndex ] );
+    }
+}
+
+/*
+ * @brief A stream is taken from the smallest class that fits and has a free
+ *        block, otherwise from the heap.  Closing the socket gives the streams
+ *        back.
+ */
+void test_lTCPAddRxdata_StreamPools( void )
+{
+    FreeRTOS_Socket_t * pxSockets[ 4 ];
+    StreamBuffer_t * pxSmall, * pxLarge, * pxHeap, * pxHuge;
+    BaseType_t xIndex;
+
+    prvResetPools();
+
+    for( xIndex = 0; xIndex < 4; xIndex++ )
+    {
+        pxSockets[ xIndex ] = prvCreateSocket( FREERTOS_IPPROTO_TCP );
+    }
+
+    /* The first stream fills the small class, the second one takes a large block. */
+    pxSmall = prvCreateRxStream( pxSockets[ 0 ], poolSMALL_STREAM_LENGTH );
+    pxLarge = prvCreateRxStream( pxSockets[ 1 ], poolSMALL_STREAM_LENGTH );
+    TEST_ASSERT_NOT_EQUAL( pxSmall, pxLarge );
+    TEST_ASSERT_EQUAL( poolSMALL_STREAM_LENGTH + sizeof( size_t ), pxSmall->LENGTH );
+
+    /* Both classes are exhausted. */
+    pxHeap = prvCreateRxStream( pxSockets[ 2 ], poolSMALL_STREAM_LENGTH );
+    TEST_ASSERT_NOT_EQUAL( pxSmall, pxHeap );
+    TEST_ASSERT_NOT_EQUAL( pxLarge, pxHeap );
+
+    /* The small block is given back, and taken again by a small stream. */
+    ( void ) vSocketClose( pxSockets[ 0 ] );
+    pxSockets[ 0 ] = prvCreateSocket( FREERTOS_IPPROTO_TCP );
+    TEST_ASSERT_EQUAL_PTR( pxSmall, prvCreateRxStream( pxSockets[ 0 ], poolSMALL_STREAM_LENGTH ) );
+
+    /* A stream that does not fit in the small class only takes a large block. */
+    ( void ) vSocketClose( pxSockets[ 0 ] );
+    ( void ) vSocketClose( pxSockets[ 1 ] );
+    pxSockets[ 0 ] = prvCreateSocket( FREERTOS_IPPROTO_TCP );
+    pxSockets[ 1 ] = prvCreateSocket( FREERTOS_IPPROTO_TCP );
+    TEST_ASSERT_EQUAL_PTR( pxLarge, prvCreateRxStream( pxSockets[ 0 ], poolLARGE_STREAM_LENGTH ) );
+    TEST_ASSERT_EQUAL_PTR( pxSmall, prvCreateRxStream( pxSockets[ 1 ], poolSMALL_STREAM_LENGTH ) );
+
+    /* A stream that is larger than both classes comes from the heap. */
+    ( void ) vSocketClose( pxSockets[ 0 ] );
+    pxHuge = prvCreateRxStream( pxSockets[ 3 ], poolHUGE_STREAM_LENGTH );
+    TEST_ASSERT_NOT_EQUAL( pxLarge, pxHuge );
+    TEST_ASSERT_EQUAL( poolHUGE_STREAM_LENGTH + sizeof( size_t ), pxHuge->LENGTH );
+
+    for( xIndex = 1; xIndex < 4; xIndex++ )
+    {
+        ( void ) vSocketClose( pxSockets[ xIndex ] );
+    }
+}
+
+/*
+ * @brief FreeRTOS_socket_static() needs memory from the caller.
+ */
+void test_FreeRTOS_socket_static_NoBuffer( void )
+{
+    prvResetPools();
+
+    catch_assert( FreeRTOS_socket_static( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP, NULL ) );
+}
+
+/*
+ * @brief A static socket uses the memory of the caller, which is neither given
+ *        to the pool nor to the heap when the socket is closed.
+ *        FreeRTOS_closesocket() returns when the IP-task has closed the socket.
+ */
+void test_FreeRTOS_socket_static_Close( void )
+{
+    FreeRTOS_Socket_t * pxSocket, * pxPooled;
+
+    prvResetPools();
+
+    xEventGroupCreate_ExpectAndReturn( ( EventGroupHandle_t ) &( xEventGroup ) );
+    pxSocket = ( FreeRTOS_Socket_t * ) FreeRTOS_socket_static( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP, &( xStaticSocket ) );
+    TEST_ASSERT_EQUAL_PTR( &( xStaticSocket ), pxSocket );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, pxSocket->ucStaticSocket );
+
+    xIsCallingFromIPTask_IgnoreAndReturn( pdFALSE );
+    xTaskGetCurrentTaskHandle_ExpectAndReturn( ( TaskHandle_t ) &( xCloseTask ) );
+    xSendEventStructToIPTask_Stub( prvSendCloseEventStub );
+    xTaskGenericNotify_ExpectAndReturn( ( TaskHandle_t ) &( xCloseTask ), ipconfigSOCKET_NOTIFY_INDEX, 0U, eIncrement, NULL, pdPASS );
+
+    TEST_ASSERT_EQUAL( 1, FreeRTOS_closesocket( pxSocket ) );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, pxSocket->ucStaticClosed );
+    TEST_ASSERT_EQUAL( 0, xNotifyTakeCount );
+
+    /* The memory was not put in the pool. */
+    pxPooled = prvCreateSocket( FREERTOS_IPPROTO_UDP );
+    TEST_ASSERT_NOT_EQUAL( pxSocket, pxPooled );
+    ( void ) vSocketClose( pxPooled );
+
+    /* The memory can be used again. */
+    xEventGroupCreate_ExpectAndReturn( ( EventGroupHandle_t ) &( xEventGroup ) );
+    TEST_ASSERT_EQUAL_PTR( pxSocket, FreeRTOS_socket_static( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP, &( xStaticSocket ) ) );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, pxSocket->ucStaticClosed );
+    ( void ) vSocketClose( pxSocket );
+}
+
+/*
+ * @brief FreeRTOS_closesocket() keeps waiting until the static socket is closed,
+ *        also when it is woken up by an older notification.
+ */
+void test_FreeRTOS_closesocket_StaticWaits( void )
+{
+    FreeRTOS_Socket_t * pxSocket;
+
+    prvResetPools();
+
+    xEventGroupCreate_ExpectAndReturn( ( EventGroupHandle_t ) &( xEventGroup ) );
+    pxSocket = ( FreeRTOS_Socket_t * ) FreeRTOS_socket_static( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP, &( xStaticSocket ) );
+
+    xIsCallingFromIPTask_IgnoreAndReturn( pdFALSE );
+    xTaskGetCurrentTaskHandle_ExpectAndReturn( ( TaskHandle_t ) &( xCloseTask ) );
+    xSendEventStructToIPTask_IgnoreAndReturn( pdPASS );
+    ulTaskGenericNotifyTake_Stub( prvNotifyTakeStub );
+    xTaskGenericNotify_ExpectAndReturn( ( TaskHandle_t ) &( xCloseTask ), ipconfigSOCKET_NOTIFY_INDEX, 0U, eIncrement, NULL, pdPASS );
+
+    TEST_ASSERT_EQUAL( 1, FreeRTOS_closesocket( pxSocket ) );
+    TEST_ASSERT_EQUAL( 2, xNotifyTakeCount );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, pxSocket->ucStaticClosed );
+}
+
+/*
+ * @brief The IP-task does not wait when it closes a static socket, e.g. from a
+ *        callback.  Nobody is woken up when the socket is closed later.
+ */
+void test_FreeRTOS_closesocket_StaticFromIPTask( void )
+{
+    FreeRTOS_Socket_t * pxSocket;
+
+    prvResetPools();
+
+    xEventGroupCreate_ExpectAndReturn( ( EventGroupHandle_t ) &( xEventGroup ) );
+    pxSocket = ( FreeRTOS_Socket_t * ) FreeRTOS_socket_static( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP, &( xStaticSocket ) );
+
+    xIsCallingFromIPTask_IgnoreAndReturn( pdTRUE );
+    xSendEventStructToIPTask_IgnoreAndReturn( pdPASS );
+
+    TEST_ASSERT_EQUAL( 1, FreeRTOS_closesocket( pxSocket ) );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, pxSocket->ucStaticClosed );
+    TEST_ASSERT_NULL( pxSocket->xCloseTask );
+
+    ( void ) vSocketClose( pxSocket );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, pxSocket->ucStaticClosed );
+}
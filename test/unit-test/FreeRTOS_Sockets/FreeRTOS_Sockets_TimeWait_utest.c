@@ -0,0 +1,183 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_Sockets_list_macros.h"
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_NetworkInterface.h"
+#include "mock_FreeRTOS_DHCP.h"
+#include "mock_FreeRTOS_DNS.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+
+#include "FreeRTOS_Sockets.h"
+
+#include "FreeRTOS_Sockets_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigTCP_TIME_WAIT_TABLE defined as
+ * 1, see ut.cmake. */
+
+/* The socket of a connection that was added to the TIME_WAIT table. */
+static FreeRTOS_Socket_t xSocket;
+
+/*
+ * @brief Give the socket two streams, which are allocated the way
+ *        prvTCPFreeStream() releases them.
+ */
+static void prvCreateStreams( void )
+{
+    memset( &( xSocket ), 0, sizeof( xSocket ) );
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+    xSocket.u.xTCP.ucTCPState = ( uint8_t ) eCLOSE_WAIT;
+    xSocket.u.xTCP.rxStream = ( StreamBuffer_t * ) malloc( sizeof( StreamBuffer_t ) );
+    xSocket.u.xTCP.txStream = ( StreamBuffer_t * ) malloc( sizeof( StreamBuffer_t ) );
+    TEST_ASSERT_NOT_NULL( xSocket.u.xTCP.rxStream );
+    TEST_ASSERT_NOT_NULL( xSocket.u.xTCP.txStream );
+}
+
+/*
+ * @brief Free the streams that were kept.
+ */
+static void prvFreeStreams( void )
+{
+    free( xSocket.u.xTCP.rxStream );
+    free( xSocket.u.xTCP.txStream );
+    xSocket.u.xTCP.rxStream = NULL;
+    xSocket.u.xTCP.txStream = NULL;
+}
+
+/*
+ * @brief Both streams are freed when there is nothing left to read.
+ */
+void test_vTCPReleaseStreams_Empty( void )
+{
+    prvCreateStreams();
+
+    uxStreamBufferGetSize_ExpectAndReturn( xSocket.u.xTCP.rxStream, 0U );
+
+    vTCPReleaseStreams( &( xSocket ) );
+
+    TEST_ASSERT_NULL( xSocket.u.xTCP.rxStream );
+    TEST_ASSERT_NULL( xSocket.u.xTCP.txStream );
+}
+
+/*
+ * @brief The rxStream is kept as long as it holds data for FreeRTOS_recv().
+ */
+void test_vTCPReleaseStreams_UnreadData( void )
+{
+    StreamBuffer_t * pxRxStream;
+
+    prvCreateStreams();
+    pxRxStream = xSocket.u.xTCP.rxStream;
+
+    uxStreamBufferGetSize_ExpectAndReturn( pxRxStream, 10U );
+
+    vTCPReleaseStreams( &( xSocket ) );
+
+    TEST_ASSERT_EQUAL_PTR( pxRxStream, xSocket.u.xTCP.rxStream );
+    TEST_ASSERT_NULL( xSocket.u.xTCP.txStream );
+
+    prvFreeStreams();
+}
+
+/*
+ * @brief Streams that a user task is accessing are kept.
+ */
+void test_vTCPReleaseStreams_Busy( void )
+{
+    StreamBuffer_t * pxRxStream;
+    StreamBuffer_t * pxTxStream;
+
+    prvCreateStreams();
+    pxRxStream = xSocket.u.xTCP.rxStream;
+    pxTxStream = xSocket.u.xTCP.txStream;
+    xSocket.u.xTCP.ucRxStreamBusy = 1U;
+    xSocket.u.xTCP.ucTxStreamBusy = 1U;
+
+    vTCPReleaseStreams( &( xSocket ) );
+
+    TEST_ASSERT_EQUAL_PTR( pxRxStream, xSocket.u.xTCP.rxStream );
+    TEST_ASSERT_EQUAL_PTR( pxTxStream, xSocket.u.xTCP.txStream );
+
+    prvFreeStreams();
+}
+
+/*
+ * @brief Streams that the application points into are kept.
+ */
+void test_vTCPReleaseStreams_Pinned( void )
+{
+    StreamBuffer_t * pxRxStream;
+    StreamBuffer_t * pxTxStream;
+
+    prvCreateStreams();
+    pxRxStream = xSocket.u.xTCP.rxStream;
+    pxTxStream = xSocket.u.xTCP.txStream;
+    xSocket.u.xTCP.ucRxStreamPinned = 1U;
+    xSocket.u.xTCP.ucTxStreamPinned = 1U;
+
+    vTCPReleaseStreams( &( xSocket ) );
+
+    TEST_ASSERT_EQUAL_PTR( pxRxStream, xSocket.u.xTCP.rxStream );
+    TEST_ASSERT_EQUAL_PTR( pxTxStream, xSocket.u.xTCP.txStream );
+
+    prvFreeStreams();
+}
+
+/*
+ * @brief A socket that never created its streams is left as it is.
+ */
+void test_vTCPReleaseStreams_NoStreams( void )
+{
+    memset( &( xSocket ), 0, sizeof( xSocket ) );
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+
+    vTCPReleaseStreams( &( xSocket ) );
+
+    TEST_ASSERT_NULL( xSocket.u.xTCP.rxStream );
+    TEST_ASSERT_NULL( xSocket.u.xTCP.txStream );
+}
@@ -111,3 +111,94 @@ create_test(${utest_name}
             "${utest_dep_list}"
             "${test_include_directories}"
         )
+
+# ====================  epoll sets with a ready list (edit)  ===================
+
+set(epoll_real_name "${project_name}_EPoll_real")
+set(epoll_utest_name "${project_name}_EPoll_utest")
+
+create_real_library(${epoll_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+target_compile_definitions(${epoll_real_name} PUBLIC
+            ipconfigSUPPORT_EPOLL=1
+        )
+
+set( epoll_link_list "" )
+list(APPEND epoll_link_list
+            -l${mock_name}
+            lib${epoll_real_name}.a
+        )
+
+create_test(${epoll_utest_name}
+            "${project_name}/${epoll_utest_name}.c"
+            "${epoll_link_list}"
+            "${epoll_real_name}"
+            "${test_include_directories}"
+        )
+
+# ==============  socket pools and static sockets (edit)  ======================
+
+set(pool_real_name "${project_name}_Pool_real")
+set(pool_utest_name "${project_name}_Pool_utest")
+
+create_real_library(${pool_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+# Small pools, so that the tests can exhaust them.
+target_compile_definitions(${pool_real_name} PUBLIC
+            ipconfigSOCKET_POOL=1
+            ipconfigSOCKET_POOL_UDP_COUNT=2
+            ipconfigSOCKET_POOL_TCP_COUNT=1
+            ipconfigSTREAM_POOL_SMALL_COUNT=1
+            ipconfigSTREAM_POOL_LARGE_COUNT=1
+            ipconfigSUPPORT_STATIC_SOCKETS=1
+            configTASK_NOTIFICATION_ARRAY_ENTRIES=2
+        )
+
+set( pool_link_list "" )
+list(APPEND pool_link_list
+            -l${mock_name}
+            lib${pool_real_name}.a
+        )
+
+create_test(${pool_utest_name}
+            "${project_name}/${pool_utest_name}.c"
+            "${pool_link_list}"
+            "${pool_real_name}"
+            "${test_include_directories}"
+        )
+
+# ==============  streams released in TIME_WAIT (edit)  ========================
+
+set(timewait_real_name "${project_name}_TimeWait_real")
+set(timewait_utest_name "${project_name}_TimeWait_utest")
+
+create_real_library(${timewait_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+target_compile_definitions(${timewait_real_name} PUBLIC
+            ipconfigTCP_TIME_WAIT_TABLE=1
+        )
+
+set( timewait_link_list "" )
+list(APPEND timewait_link_list
+            -l${mock_name}
+            lib${timewait_real_name}.a
+        )
+
+create_test(${timewait_utest_name}
+            "${project_name}/${timewait_utest_name}.c"
+            "${timewait_link_list}"
+            "${timewait_real_name}"
+            "${test_include_directories}"
+        )
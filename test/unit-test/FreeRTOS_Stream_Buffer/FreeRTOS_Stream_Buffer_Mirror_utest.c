@@ -0,0 +1,380 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_semphr.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_UDP_IP.h"
+
+#include "FreeRTOS_Stream_Buffer.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigSTREAM_BUFFER_MIRROR_SIZE
+ * defined as non-zero, see ut.cmake. */
+
+/* The length of the streams used in this file. */
+#define mirrorBUFFER_LENGTH    64U
+
+/* The number of bytes that are mirrored behind the end of each stream. */
+#define mirrorMIRROR_SIZE      16U
+
+/*
+ * @brief Function to calculate smaller of the two numbers given.
+ */
+static size_t FreeRTOS_min_stub( size_t a,
+                                 size_t b,
+                                 int callback_count )
+{
+    /* Avoid compiler warnings about unused variable. */
+    ( void ) callback_count;
+
+    if( a < b )
+    {
+        return a;
+    }
+    else
+    {
+        return b;
+    }
+}
+
+/*
+ * @brief Allocate a cleared stream with a mirror of 'uxMirrorSize' bytes
+ *        behind its end, the way prvTCPAllocateStream() does.
+ */
+static StreamBuffer_t * prvCreateStream( size_t uxMirrorSize )
+{
+    size_t uxSize = sizeof( StreamBuffer_t ) - sizeof( ( ( StreamBuffer_t * ) NULL )->ucArray ) + mirrorBUFFER_LENGTH + uxMirrorSize;
+    StreamBuffer_t * pxBuffer = malloc( uxSize );
+
+    memset( pxBuffer, 0, uxSize );
+    pxBuffer->LENGTH = mirrorBUFFER_LENGTH;
+    pxBuffer->uxMirrorSize = uxMirrorSize;
+
+    return pxBuffer;
+}
+
+/*
+ * @brief Fill 'pucData' with a counting pattern, starting at 'ucFirst'.
+ */
+static void prvFillPattern( uint8_t * pucData,
+                            size_t uxLength,
+                            uint8_t ucFirst )
+{
+    size_t uxIndex;
+
+    for( uxIndex = 0; uxIndex < uxLength; uxIndex++ )
+    {
+        pucData[ uxIndex ] = ( uint8_t ) ( ucFirst + uxIndex );
+    }
+}
+
+/*
+ * @brief Data that wraps around the end of the stream is written to the
+ *        start of the stream, and copied to the mirror.
+ */
+void test_uxStreamBufferAdd_WrapsAround_MirrorUpdated( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( mirrorMIRROR_SIZE );
+    uint8_t pucData[ 10 ];
+    size_t uxReturn;
+
+    prvFillPattern( pucData, sizeof( pucData ), 0x30 );
+
+    pxLocalBuffer->uxHead = 60;
+    pxLocalBuffer->uxTail = 20;
+    pxLocalBuffer->uxFront = 60;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    uxReturn = uxStreamBufferAdd( pxLocalBuffer, 0, pucData, sizeof( pucData ) );
+
+    TEST_ASSERT_EQUAL( sizeof( pucData ), uxReturn );
+    TEST_ASSERT_EQUAL( 6, pxLocalBuffer->uxHead );
+    /* The first 4 bytes are at the end of the stream, the rest at its start. */
+    TEST_ASSERT_EQUAL_MEMORY( pucData, &( pxLocalBuffer->ucArray[ 60 ] ), 4 );
+    TEST_ASSERT_EQUAL_MEMORY( &( pucData[ 4 ] ), pxLocalBuffer->ucArray, 6 );
+    /* The mirror holds a copy of the start of the stream. */
+    TEST_ASSERT_EQUAL_MEMORY( pxLocalBuffer->ucArray, &( pxLocalBuffer->ucArray[ mirrorBUFFER_LENGTH ] ), 6 );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0, &( pxLocalBuffer->ucArray[ mirrorBUFFER_LENGTH + 6 ] ), mirrorMIRROR_SIZE - 6 );
+
+    free( pxLocalBuffer );
+}
+
+/*
+ * @brief Data written to the start of the stream is copied to the mirror,
+ *        as far as the mirror reaches.
+ */
+void test_uxStreamBufferAdd_AtStart_MirrorUpdated( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( mirrorMIRROR_SIZE );
+    uint8_t pucData[ 20 ];
+    size_t uxReturn;
+
+    prvFillPattern( pucData, sizeof( pucData ), 0x50 );
+
+    pxLocalBuffer->uxHead = 10;
+    pxLocalBuffer->uxTail = 10;
+    pxLocalBuffer->uxFront = 10;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    uxReturn = uxStreamBufferAdd( pxLocalBuffer, 0, pucData, sizeof( pucData ) );
+
+    TEST_ASSERT_EQUAL( sizeof( pucData ), uxReturn );
+    TEST_ASSERT_EQUAL( 30, pxLocalBuffer->uxHead );
+    TEST_ASSERT_EQUAL_MEMORY( pucData, &( pxLocalBuffer->ucArray[ 10 ] ), sizeof( pucData ) );
+    /* Only the bytes 10 to 15 fall within the mirror. */
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0, &( pxLocalBuffer->ucArray[ mirrorBUFFER_LENGTH ] ), 10 );
+    TEST_ASSERT_EQUAL_MEMORY( pucData, &( pxLocalBuffer->ucArray[ mirrorBUFFER_LENGTH + 10 ] ), mirrorMIRROR_SIZE - 10 );
+
+    free( pxLocalBuffer );
+}
+
+/*
+ * @brief Data that was written in-place beyond the end of the stream, i.e.
+ *        in the mirror, is copied to the start of the stream when the head
+ *        is advanced.
+ */
+void test_uxStreamBufferAdd_NULLData_WrittenInMirror_CopiedToStart( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( mirrorMIRROR_SIZE );
+    size_t uxReturn;
+
+    pxLocalBuffer->uxHead = 56;
+    pxLocalBuffer->uxTail = 20;
+    pxLocalBuffer->uxFront = 56;
+
+    /* The application wrote 12 bytes to the pointer that it got from
+     * FreeRTOS_get_tx_head(), 4 of them landed in the mirror. */
+    prvFillPattern( &( pxLocalBuffer->ucArray[ 56 ] ), 12, 0x70 );
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    uxReturn = uxStreamBufferAdd( pxLocalBuffer, 0, NULL, 12 );
+
+    TEST_ASSERT_EQUAL( 12, uxReturn );
+    TEST_ASSERT_EQUAL( 4, pxLocalBuffer->uxHead );
+    TEST_ASSERT_EQUAL_MEMORY( &( pxLocalBuffer->ucArray[ mirrorBUFFER_LENGTH ] ), pxLocalBuffer->ucArray, 4 );
+    TEST_ASSERT_EQUAL( 0x78, pxLocalBuffer->ucArray[ 0 ] );
+    TEST_ASSERT_EQUAL( 0x7B, pxLocalBuffer->ucArray[ 3 ] );
+    /* The rest of the start of the stream is not touched. */
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0, &( pxLocalBuffer->ucArray[ 4 ] ), 16 );
+
+    free( pxLocalBuffer );
+}
+
+/*
+ * @brief Data written at an offset, which wraps around the end of the
+ *        stream, is mirrored as well.
+ */
+void test_uxStreamBufferAdd_WithOffset_WrapsAround_MirrorUpdated( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( mirrorMIRROR_SIZE );
+    uint8_t pucData[ 8 ];
+    size_t uxReturn;
+
+    prvFillPattern( pucData, sizeof( pucData ), 0x90 );
+
+    pxLocalBuffer->uxHead = 50;
+    pxLocalBuffer->uxTail = 40;
+    pxLocalBuffer->uxFront = 50;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    /* Write 8 bytes at 12 bytes past the head: position 62. */
+    uxReturn = uxStreamBufferAdd( pxLocalBuffer, 12, pucData, sizeof( pucData ) );
+
+    TEST_ASSERT_EQUAL( sizeof( pucData ), uxReturn );
+    /* The head does not move, the front moves to the start of the data. */
+    TEST_ASSERT_EQUAL( 50, pxLocalBuffer->uxHead );
+    TEST_ASSERT_EQUAL( 62, pxLocalBuffer->uxFront );
+    TEST_ASSERT_EQUAL_MEMORY( pucData, &( pxLocalBuffer->ucArray[ 62 ] ), 2 );
+    TEST_ASSERT_EQUAL_MEMORY( &( pucData[ 2 ] ), pxLocalBuffer->ucArray, 6 );
+    TEST_ASSERT_EQUAL_MEMORY( pxLocalBuffer->ucArray, &( pxLocalBuffer->ucArray[ mirrorBUFFER_LENGTH ] ), 6 );
+
+    free( pxLocalBuffer );
+}
+
+/*
+ * @brief Data that wraps around the end of the stream can be read in one go,
+ *        as far as the mirror reaches.
+ */
+void test_uxStreamBufferGetPtr_WrappedData_ContiguousThroughMirror( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( mirrorMIRROR_SIZE );
+    uint8_t * pucData;
+    size_t uxReturn;
+
+    pxLocalBuffer->uxTail = 60;
+    pxLocalBuffer->uxHead = 10;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    uxReturn = uxStreamBufferGetPtr( pxLocalBuffer, &pucData );
+
+    /* All 14 bytes are contiguous: 4 in the stream and 10 in the mirror. */
+    TEST_ASSERT_EQUAL( 14, uxReturn );
+    TEST_ASSERT_EQUAL_PTR( &( pxLocalBuffer->ucArray[ 60 ] ), pucData );
+
+    free( pxLocalBuffer );
+}
+
+/*
+ * @brief Data that wraps around further than the mirror reaches, can only be
+ *        read in one go up to the end of the mirror.
+ */
+void test_uxStreamBufferGetPtr_WrappedData_BeyondMirror( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( mirrorMIRROR_SIZE );
+    uint8_t * pucData;
+    size_t uxReturn;
+
+    pxLocalBuffer->uxTail = 60;
+    pxLocalBuffer->uxHead = 30;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    uxReturn = uxStreamBufferGetPtr( pxLocalBuffer, &pucData );
+
+    TEST_ASSERT_EQUAL( 4 + mirrorMIRROR_SIZE, uxReturn );
+    TEST_ASSERT_EQUAL_PTR( &( pxLocalBuffer->ucArray[ 60 ] ), pucData );
+
+    free( pxLocalBuffer );
+}
+
+/*
+ * @brief A stream without a mirror, as created by the tools, stops at its
+ *        end, also when ipconfigSTREAM_BUFFER_MIRROR_SIZE is defined.
+ */
+void test_uxStreamBufferGetPtr_WrappedData_NoMirror( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( 0 );
+    uint8_t * pucData;
+    size_t uxReturn;
+
+    pxLocalBuffer->uxTail = 60;
+    pxLocalBuffer->uxHead = 10;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    uxReturn = uxStreamBufferGetPtr( pxLocalBuffer, &pucData );
+
+    TEST_ASSERT_EQUAL( 4, uxReturn );
+    TEST_ASSERT_EQUAL_PTR( &( pxLocalBuffer->ucArray[ 60 ] ), pucData );
+
+    free( pxLocalBuffer );
+}
+
+/*
+ * @brief Data that was added around the end of the stream reads back
+ *        correctly, when the read ends within the mirror.
+ */
+void test_uxStreamBufferGet_WrappedData_WithinMirror( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( mirrorMIRROR_SIZE );
+    uint8_t pucInput[ 20 ];
+    uint8_t pucOutput[ 20 ];
+    size_t uxReturn;
+
+    prvFillPattern( pucInput, sizeof( pucInput ), 0x10 );
+    memset( pucOutput, 0, sizeof( pucOutput ) );
+
+    pxLocalBuffer->uxHead = 54;
+    pxLocalBuffer->uxTail = 54;
+    pxLocalBuffer->uxFront = 54;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    uxReturn = uxStreamBufferAdd( pxLocalBuffer, 0, pucInput, sizeof( pucInput ) );
+    TEST_ASSERT_EQUAL( sizeof( pucInput ), uxReturn );
+
+    uxReturn = uxStreamBufferGet( pxLocalBuffer, 0, pucOutput, sizeof( pucOutput ), pdFALSE );
+
+    TEST_ASSERT_EQUAL( sizeof( pucOutput ), uxReturn );
+    TEST_ASSERT_EQUAL_MEMORY( pucInput, pucOutput, sizeof( pucInput ) );
+    TEST_ASSERT_EQUAL( 10, pxLocalBuffer->uxTail );
+
+    free( pxLocalBuffer );
+}
+
+/*
+ * @brief Data that was added around the end of the stream reads back
+ *        correctly, when the read reaches beyond the mirror.
+ */
+void test_uxStreamBufferGet_WrappedData_BeyondMirror( void )
+{
+    StreamBuffer_t * pxLocalBuffer = prvCreateStream( mirrorMIRROR_SIZE );
+    uint8_t pucInput[ 40 ];
+    uint8_t pucOutput[ 40 ];
+    size_t uxReturn;
+
+    prvFillPattern( pucInput, sizeof( pucInput ), 0xA0 );
+    memset( pucOutput, 0, sizeof( pucOutput ) );
+
+    pxLocalBuffer->uxHead = 50;
+    pxLocalBuffer->uxTail = 50;
+    pxLocalBuffer->uxFront = 50;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_stub );
+
+    uxReturn = uxStreamBufferAdd( pxLocalBuffer, 0, pucInput, sizeof( pucInput ) );
+    TEST_ASSERT_EQUAL( sizeof( pucInput ), uxReturn );
+
+    /* Peek first, then read with an offset, then read the lot. */
+    uxReturn = uxStreamBufferGet( pxLocalBuffer, 0, pucOutput, sizeof( pucOutput ), pdTRUE );
+    TEST_ASSERT_EQUAL( sizeof( pucOutput ), uxReturn );
+    TEST_ASSERT_EQUAL_MEMORY( pucInput, pucOutput, sizeof( pucInput ) );
+    TEST_ASSERT_EQUAL( 50, pxLocalBuffer->uxTail );
+
+    memset( pucOutput, 0, sizeof( pucOutput ) );
+    uxReturn = uxStreamBufferGet( pxLocalBuffer, 20, pucOutput, sizeof( pucOutput ), pdFALSE );
+    TEST_ASSERT_EQUAL( 20, uxReturn );
+    TEST_ASSERT_EQUAL_MEMORY( &( pucInput[ 20 ] ), pucOutput, 20 );
+    TEST_ASSERT_EQUAL( 50, pxLocalBuffer->uxTail );
+
+    memset( pucOutput, 0, sizeof( pucOutput ) );
+    uxReturn = uxStreamBufferGet( pxLocalBuffer, 0, pucOutput, sizeof( pucOutput ), pdFALSE );
+    TEST_ASSERT_EQUAL( sizeof( pucOutput ), uxReturn );
+    TEST_ASSERT_EQUAL_MEMORY( pucInput, pucOutput, sizeof( pucInput ) );
+    TEST_ASSERT_EQUAL( 26, pxLocalBuffer->uxTail );
+
+    free( pxLocalBuffer );
+}
@@ -107,3 +107,31 @@ create_test(${utest_name}
             "${utest_dep_list}"
             "${test_include_directories}"
         )
+
+# ============  Stream buffers with a mirror behind their end (edit)  ==========
+
+set(mirror_real_name "${project_name}_Mirror_real")
+set(mirror_utest_name "${project_name}_Mirror_utest")
+
+create_real_library(${mirror_real_name}
+                    "${real_source_files}"
+                    "${real_include_directories}"
+                    "${mock_name}"
+        )
+
+target_compile_definitions(${mirror_real_name} PUBLIC
+            ipconfigSTREAM_BUFFER_MIRROR_SIZE=16
+        )
+
+set( mirror_link_list "" )
+list(APPEND mirror_link_list
+            -l${mock_name}
+            lib${mirror_real_name}.a
+        )
+
+create_test(${mirror_utest_name}
+            "${project_name}/${mirror_utest_name}.c"
+            "${mirror_link_list}"
+            "${mirror_real_name}"
+            "${test_include_directories}"
+        )
@@ -0,0 +1,417 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_NetworkInterface.h"
+
+#include "FreeRTOS_TCP_IP.h"
+
+#include "FreeRTOS_TCP_IP_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigTCP_SYN_QUEUE defined as 1, and
+ * with a table of 2 entries, see ut.cmake. */
+
+/* The TCP flags and options, as defined in FreeRTOS_TCP_IP.c. */
+#define tcpTCP_FLAG_FIN         ( ( uint8_t ) 0x01U )
+#define tcpTCP_FLAG_SYN         ( ( uint8_t ) 0x02U )
+#define tcpTCP_FLAG_RST         ( ( uint8_t ) 0x04U )
+#define tcpTCP_FLAG_ACK         ( ( uint8_t ) 0x10U )
+
+#define tcpTCP_OPT_NOOP         1U
+#define tcpTCP_OPT_MSS          2U
+#define tcpTCP_OPT_WSOPT        3U
+#define tcpTCP_OPT_MSS_LEN      4U
+#define tcpTCP_OPT_WSOPT_LEN    3U
+
+/* The port number of the listening socket. */
+#define synLOCAL_PORT         80U
+
+/* The address of this node and of the peers, in host-endian notation. */
+#define synLOCAL_IP           0xC0A8010AUL
+#define synPEER_IP            0xC0A80114UL
+
+/* The initial sequence numbers of the peer and of this node. */
+#define synPEER_SEQUENCE      0x10000000UL
+#define synOUR_SEQUENCE       0x20000000UL
+
+/* The MSS that the peer asks for, smaller than ipconfigTCP_MSS. */
+#define synPEER_MSS           600U
+
+/* The window scale factor that the peer asks for. */
+#define synPEER_WIN_SCALE     3U
+
+/* The length of the options in a SYN: MSS, NOP and window scale. */
+#define synOPTIONS_LENGTH     8U
+
+/* The listening socket, and the child socket that FreeRTOS_socket() returns. */
+static FreeRTOS_Socket_t xListenSocket;
+static FreeRTOS_Socket_t xChildSocket;
+
+/* The packet that is received, and a copy of the last packet that was sent. */
+static uint8_t ucPacket[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+static uint8_t ucSentPacket[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+static NetworkBufferDescriptor_t xNetworkBuffer;
+static BaseType_t xSendCount;
+
+/* The time returned by xTaskGetTickCount().  It keeps increasing from test to
+ * test, so that entries left by an earlier test have expired. */
+static TickType_t xTickCount;
+
+static TickType_t prvGetTickCountStub( int callback_count )
+{
+    ( void ) callback_count;
+
+    return xTickCount;
+}
+
+static uint32_t prvMinStub( uint32_t a,
+                            uint32_t b,
+                            int callback_count )
+{
+    ( void ) callback_count;
+
+    return ( a <= b ) ? a : b;
+}
+
+static uint32_t prvMaxStub( uint32_t a,
+                            uint32_t b,
+                            int callback_count )
+{
+    ( void ) callback_count;
+
+    return ( a >= b ) ? a : b;
+}
+
+static uint16_t prvChar2u16Stub( const uint8_t * pucPtr,
+                                 int callback_count )
+{
+    ( void ) callback_count;
+
+    return ( uint16_t ) ( ( ( uint16_t ) pucPtr[ 0 ] << 8 ) | pucPtr[ 1 ] );
+}
+
+/*
+ * @brief Keep a copy of the packet that is sent.
+ */
+static BaseType_t prvNetworkInterfaceOutputStub( NetworkBufferDescriptor_t * const pxDescriptor,
+                                                 BaseType_t xReleaseAfterSend,
+                                                 int callback_count )
+{
+    ( void ) xReleaseAfterSend;
+    ( void ) callback_count;
+
+    TEST_ASSERT_TRUE( pxDescriptor->xDataLength <= sizeof( ucSentPacket ) );
+    memcpy( ucSentPacket, pxDescriptor->pucEthernetBuffer, pxDescriptor->xDataLength );
+    xSendCount++;
+
+    return pdPASS;
+}
+
+/*
+ * @brief Install the stubs, and prepare the listening socket.  The time moves
+ *        beyond the lifetime of the entries made by earlier tests.
+ */
+static void prvResetSynQueue( void )
+{
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_SYN_QUEUE_TIMEOUT_MS ) + 1U;
+
+    xTaskGetTickCount_Stub( prvGetTickCountStub );
+    FreeRTOS_min_uint32_Stub( prvMinStub );
+    FreeRTOS_max_uint32_Stub( prvMaxStub );
+    usChar2u16_Stub( prvChar2u16Stub );
+    usGenerateChecksum_IgnoreAndReturn( 0U );
+    usGenerateProtocolChecksum_IgnoreAndReturn( 0U );
+    xNetworkInterfaceOutput_Stub( prvNetworkInterfaceOutputStub );
+    pxTCPSocketLookup_IgnoreAndReturn( &( xListenSocket ) );
+
+    *ipLOCAL_IP_ADDRESS_POINTER = FreeRTOS_htonl( synLOCAL_IP );
+    xNetworkAddressing.ulNetMask = FreeRTOS_htonl( 0xFFFFFF00UL );
+
+    memset( &( xListenSocket ), 0, sizeof( xListenSocket ) );
+    xListenSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+    xListenSocket.usLocalPort = synLOCAL_PORT;
+    xListenSocket.u.xTCP.ucTCPState = ( uint8_t ) eTCP_LISTEN;
+    xListenSocket.u.xTCP.usBacklog = 4U;
+    xListenSocket.u.xTCP.uxRxWinSize = 4U;
+    xListenSocket.u.xTCP.uxRxStreamSize = 5000U;
+    xListenSocket.u.xTCP.uxTxStreamSize = 5000U;
+
+    memset( &( xChildSocket ), 0, sizeof( xChildSocket ) );
+    xChildSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+
+    memset( ucSentPacket, 0, sizeof( ucSentPacket ) );
+    xSendCount = 0;
+}
+
+/*
+ * @brief Fill the received packet.
+ */
+static void prvCreatePacket( uint32_t ulPeerIP,
+                             uint16_t usPeerPort,
+                             uint32_t ulSequenceNumber,
+                             uint32_t ulAckNumber,
+                             uint8_t ucTCPFlags,
+                             BaseType_t xWithOptions )
+{
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ucPacket;
+    size_t uxOptionsLength = ( xWithOptions != pdFALSE ) ? synOPTIONS_LENGTH : 0U;
+
+    memset( ucPacket, 0, sizeof( ucPacket ) );
+
+    pxTCPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+    pxTCPPacket->xIPHeader.ucVersionHeaderLength = 0x45U;
+    pxTCPPacket->xIPHeader.ucProtocol = ipPROTOCOL_TCP;
+    pxTCPPacket->xIPHeader.ulSourceIPAddress = FreeRTOS_htonl( ulPeerIP );
+    pxTCPPacket->xIPHeader.ulDestinationIPAddress = FreeRTOS_htonl( synLOCAL_IP );
+    pxTCPPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( usPeerPort );
+    pxTCPPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( synLOCAL_PORT );
+    pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
+    pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( ulAckNumber );
+    pxTCPPacket->xTCPHeader.ucTCPFlags = ucTCPFlags;
+    pxTCPPacket->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 );
+    pxTCPPacket->xTCPHeader.usWindow = FreeRTOS_htons( 0x2000U );
+
+    if( xWithOptions != pdFALSE )
+    {
+        pxTCPPacket->xTCPHeader.ucOptdata[ 0 ] = tcpTCP_OPT_MSS;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 1 ] = tcpTCP_OPT_MSS_LEN;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 2 ] = ( uint8_t ) ( synPEER_MSS >> 8 );
+        pxTCPPacket->xTCPHeader.ucOptdata[ 3 ] = ( uint8_t ) ( synPEER_MSS & 0xffU );
+        pxTCPPacket->xTCPHeader.ucOptdata[ 4 ] = tcpTCP_OPT_NOOP;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 5 ] = tcpTCP_OPT_WSOPT;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 6 ] = tcpTCP_OPT_WSOPT_LEN;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 7 ] = synPEER_WIN_SCALE;
+    }
+
+    xNetworkBuffer.pucEthernetBuffer = ucPacket;
+    xNetworkBuffer.xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + uxOptionsLength;
+}
+
+/*
+ * @brief Let a peer send a SYN to the listening socket.
+ */
+static BaseType_t prvReceiveSyn( uint32_t ulPeerIP,
+                                 uint16_t usPeerPort,
+                                 uint32_t ulInitialSequenceNumber )
+{
+    prvCreatePacket( ulPeerIP, usPeerPort, synPEER_SEQUENCE, 0U, tcpTCP_FLAG_SYN, pdTRUE );
+    ulApplicationGetNextSequenceNumber_ExpectAnyArgsAndReturn( ulInitialSequenceNumber );
+
+    return xProcessReceivedTCPPacket( &( xNetworkBuffer ) );
+}
+
+/*
+ * @brief Let a peer send an ACK to the listening socket.
+ */
+static BaseType_t prvReceiveAck( uint32_t ulPeerIP,
+                                 uint16_t usPeerPort,
+                                 uint32_t ulAckNumber )
+{
+    prvCreatePacket( ulPeerIP, usPeerPort, synPEER_SEQUENCE + 1U, ulAckNumber, tcpTCP_FLAG_ACK, pdFALSE );
+
+    return xProcessReceivedTCPPacket( &( xNetworkBuffer ) );
+}
+
+/*
+ * @brief Check that a RST was sent.
+ */
+static void prvCheckReset( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+
+    TEST_ASSERT_EQUAL( 1, xSendCount );
+    TEST_ASSERT_EQUAL_HEX8( tcpTCP_FLAG_RST | tcpTCP_FLAG_ACK, pxSent->xTCPHeader.ucTCPFlags );
+}
+
+/*
+ * @brief A SYN does not create a child socket, it is answered with a SYN+ACK
+ *        that has the options and window that a child socket would send.
+ */
+void test_xProcessReceivedTCPPacket_SynAnsweredWithoutSocket( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+
+    prvResetSynQueue();
+
+    /* FreeRTOS_socket() is not expected to be called. */
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveSyn( synPEER_IP, 5000U, synOUR_SEQUENCE ) );
+
+    TEST_ASSERT_EQUAL( 1, xSendCount );
+    TEST_ASSERT_EQUAL_HEX8( tcpTCP_FLAG_SYN | tcpTCP_FLAG_ACK, pxSent->xTCPHeader.ucTCPFlags );
+    TEST_ASSERT_EQUAL_HEX32( synOUR_SEQUENCE, FreeRTOS_ntohl( pxSent->xTCPHeader.ulSequenceNumber ) );
+    TEST_ASSERT_EQUAL_HEX32( synPEER_SEQUENCE + 1U, FreeRTOS_ntohl( pxSent->xTCPHeader.ulAckNr ) );
+    TEST_ASSERT_EQUAL_HEX32( FreeRTOS_htonl( synPEER_IP ), pxSent->xIPHeader.ulDestinationIPAddress );
+
+    /* The MSS of the peer is smaller, the window is 'uxRxWinSize' segments. */
+    TEST_ASSERT_EQUAL( tcpTCP_OPT_MSS, pxSent->xTCPHeader.ucOptdata[ 0 ] );
+    TEST_ASSERT_EQUAL( synPEER_MSS, ( ( uint16_t ) pxSent->xTCPHeader.ucOptdata[ 2 ] << 8 ) | pxSent->xTCPHeader.ucOptdata[ 3 ] );
+    TEST_ASSERT_EQUAL( tcpTCP_OPT_WSOPT, pxSent->xTCPHeader.ucOptdata[ 5 ] );
+    TEST_ASSERT_EQUAL( 0U, pxSent->xTCPHeader.ucOptdata[ 7 ] );
+    TEST_ASSERT_EQUAL( 4U * synPEER_MSS, FreeRTOS_ntohs( pxSent->xTCPHeader.usWindow ) );
+}
+
+/*
+ * @brief A repeated SYN is answered with the sequence number of the first
+ *        SYN+ACK.
+ */
+void test_xProcessReceivedTCPPacket_RepeatedSyn( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+
+    prvResetSynQueue();
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveSyn( synPEER_IP, 5000U, synOUR_SEQUENCE ) );
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveSyn( synPEER_IP, 5000U, synOUR_SEQUENCE + 0x1000U ) );
+
+    TEST_ASSERT_EQUAL( 2, xSendCount );
+    TEST_ASSERT_EQUAL_HEX32( synOUR_SEQUENCE, FreeRTOS_ntohl( pxSent->xTCPHeader.ulSequenceNumber ) );
+}
+
+/*
+ * @brief An ACK that does not match the SYN+ACK is answered with a RST, and the
+ *        entry is kept.  An ACK for an unknown peer gets a RST too.
+ */
+void test_xProcessReceivedTCPPacket_AckDoesNotMatch( void )
+{
+    prvResetSynQueue();
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveSyn( synPEER_IP, 5000U, synOUR_SEQUENCE ) );
+
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveAck( synPEER_IP, 5000U, synOUR_SEQUENCE + 2U ) );
+    prvCheckReset();
+
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveAck( synPEER_IP, 5001U, synOUR_SEQUENCE + 1U ) );
+    prvCheckReset();
+}
+
+/*
+ * @brief An entry expires when the handshake is not completed in time.
+ */
+void test_xProcessReceivedTCPPacket_EntryExpires( void )
+{
+    prvResetSynQueue();
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveSyn( synPEER_IP, 5000U, synOUR_SEQUENCE ) );
+
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_SYN_QUEUE_TIMEOUT_MS );
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveAck( synPEER_IP, 5000U, synOUR_SEQUENCE + 1U ) );
+    prvCheckReset();
+}
+
+/*
+ * @brief When the table is full, the oldest entry is replaced.
+ */
+void test_xProcessReceivedTCPPacket_TableFull( void )
+{
+    BaseType_t xIndex;
+
+    prvResetSynQueue();
+
+    /* One more request than the table can hold. */
+    for( xIndex = 0; xIndex <= ( BaseType_t ) ipconfigTCP_SYN_QUEUE_LENGTH; xIndex++ )
+    {
+        TEST_ASSERT_EQUAL( pdFAIL, prvReceiveSyn( synPEER_IP + ( uint32_t ) xIndex, 5000U, synOUR_SEQUENCE ) );
+        xTickCount++;
+    }
+
+    /* The first request was forgotten. */
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveAck( synPEER_IP, 5000U, synOUR_SEQUENCE + 1U ) );
+    prvCheckReset();
+}
+
+/*
+ * @brief The child socket is not created when the listening socket has reached
+ *        its backlog by the time the handshake completes.
+ */
+void test_xProcessReceivedTCPPacket_BacklogFull( void )
+{
+    prvResetSynQueue();
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveSyn( synPEER_IP, 5000U, synOUR_SEQUENCE ) );
+
+    xListenSocket.u.xTCP.usChildCount = xListenSocket.u.xTCP.usBacklog;
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveAck( synPEER_IP, 5000U, synOUR_SEQUENCE + 1U ) );
+    prvCheckReset();
+
+    /* The entry was used, a repeated ACK is not accepted anymore. */
+    xListenSocket.u.xTCP.usChildCount = 0U;
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveAck( synPEER_IP, 5000U, synOUR_SEQUENCE + 1U ) );
+    prvCheckReset();
+}
+
+/*
+ * @brief The final ACK creates the child socket, which gets the options of the
+ *        SYN and becomes connected.
+ */
+void test_xProcessReceivedTCPPacket_AckCreatesChild( void )
+{
+    prvResetSynQueue();
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceiveSyn( synPEER_IP, 5000U, synOUR_SEQUENCE ) );
+
+    FreeRTOS_socket_ExpectAndReturn( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP, &( xChildSocket ) );
+    vSocketBind_IgnoreAndReturn( 0 );
+    vTCPWindowCreate_Ignore();
+    vSocketWakeUpUser_Ignore();
+    vReleaseNetworkBufferAndDescriptor_Ignore();
+    xTCPWindowTxHasData_IgnoreAndReturn( pdFALSE );
+
+    TEST_ASSERT_EQUAL( pdPASS, prvReceiveAck( synPEER_IP, 5000U, synOUR_SEQUENCE + 1U ) );
+
+    TEST_ASSERT_EQUAL( synPEER_IP, xChildSocket.u.xTCP.ulRemoteIP );
+    TEST_ASSERT_EQUAL( 5000U, xChildSocket.u.xTCP.usRemotePort );
+    TEST_ASSERT_EQUAL( synPEER_MSS, xChildSocket.u.xTCP.usMSS );
+    TEST_ASSERT_EQUAL( synPEER_WIN_SCALE, xChildSocket.u.xTCP.ucPeerWinScaleFactor );
+    TEST_ASSERT_EQUAL( eESTABLISHED, xChildSocket.u.xTCP.ucTCPState );
+}
@@ -0,0 +1,517 @@
+/*
+ * FreeRTOS+TCP V2.3.4
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_NetworkInterface.h"
+
+#include "FreeRTOS_TCP_IP.h"
+
+#include "FreeRTOS_TCP_IP_stubs.c"
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* The tests in this file are built with ipconfigTCP_TIME_WAIT_TABLE defined as 1,
+ * and with a table of 2 entries, see ut.cmake. */
+
+/* The TCP flags, as defined in FreeRTOS_TCP_IP.c. */
+#define tcpTCP_FLAG_FIN    ( ( uint8_t ) 0x01U )
+#define tcpTCP_FLAG_SYN    ( ( uint8_t ) 0x02U )
+#define tcpTCP_FLAG_RST    ( ( uint8_t ) 0x04U )
+#define tcpTCP_FLAG_PSH    ( ( uint8_t ) 0x08U )
+#define tcpTCP_FLAG_ACK    ( ( uint8_t ) 0x10U )
+
+/* The local port number of the connection. */
+#define twLOCAL_PORT       80U
+
+/* The address of this node and of the peer, in host-endian notation. */
+#define twLOCAL_IP         0xC0A8010AUL
+#define twPEER_IP          0xC0A80114UL
+#define twPEER_PORT        5000U
+
+/* The sequence numbers of the FIN of the peer and of this node. */
+#define twPEER_FIN         0x10000100UL
+#define twOUR_FIN          0x20000200UL
+
+/* The window advertised by the peer, and its scale factor. */
+#define twPEER_WINDOW      0x2000U
+#define twPEER_WIN_SCALE   2U
+
+/* The socket of the connection. */
+static FreeRTOS_Socket_t xSocket;
+
+/* The packet that is received, and a copy of the last packet that was sent. */
+static uint8_t ucPacket[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+static uint8_t ucSentPacket[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+static NetworkBufferDescriptor_t xNetworkBuffer;
+static BaseType_t xSendCount;
+
+/* The time returned by xTaskGetTickCount().  It keeps increasing from test to
+ * test, so that entries left by an earlier test have expired. */
+static TickType_t xTickCount;
+
+/* The socket that was passed to vTCPReleaseStreams(). */
+static FreeRTOS_Socket_t * pxReleasedSocket;
+
+/*
+ * @brief vTCPReleaseStreams() is only declared when ipconfigTCP_TIME_WAIT_TABLE
+ *        is set, so it is not mocked.
+ */
+void vTCPReleaseStreams( FreeRTOS_Socket_t * pxSocket )
+{
+    pxReleasedSocket = pxSocket;
+}
+
+static TickType_t prvGetTickCountStub( int callback_count )
+{
+    ( void ) callback_count;
+
+    return xTickCount;
+}
+
+static uint32_t prvMinStub( uint32_t a,
+                            uint32_t b,
+                            int callback_count )
+{
+    ( void ) callback_count;
+
+    return ( a <= b ) ? a : b;
+}
+
+static uint32_t prvMaxStub( uint32_t a,
+                            uint32_t b,
+                            int callback_count )
+{
+    ( void ) callback_count;
+
+    return ( a >= b ) ? a : b;
+}
+
+/*
+ * @brief Keep a copy of the packet that is sent.
+ */
+static BaseType_t prvNetworkInterfaceOutputStub( NetworkBufferDescriptor_t * const pxDescriptor,
+                                                 BaseType_t xReleaseAfterSend,
+                                                 int callback_count )
+{
+    ( void ) xReleaseAfterSend;
+    ( void ) callback_count;
+
+    TEST_ASSERT_TRUE( pxDescriptor->xDataLength <= sizeof( ucSentPacket ) );
+    memcpy( ucSentPacket, pxDescriptor->pucEthernetBuffer, pxDescriptor->xDataLength );
+    xSendCount++;
+
+    return pdPASS;
+}
+
+/*
+ * @brief Install the stubs.  The time moves beyond the lifetime of the entries
+ *        made by earlier tests.
+ */
+static void prvResetTimeWait( void )
+{
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_TIME_WAIT_MS ) + 1U;
+
+    xTaskGetTickCount_Stub( prvGetTickCountStub );
+    FreeRTOS_min_uint32_Stub( prvMinStub );
+    FreeRTOS_max_uint32_Stub( prvMaxStub );
+    usGenerateChecksum_IgnoreAndReturn( 0U );
+    usGenerateProtocolChecksum_IgnoreAndReturn( 0U );
+    xNetworkInterfaceOutput_Stub( prvNetworkInterfaceOutputStub );
+    pxTCPSocketLookup_IgnoreAndReturn( &( xSocket ) );
+    vTCPWindowDestroy_Ignore();
+    vSocketWakeUpUser_Ignore();
+    vReleaseNetworkBufferAndDescriptor_Ignore();
+    xTCPWindowTxHasData_IgnoreAndReturn( pdFALSE );
+
+    *ipLOCAL_IP_ADDRESS_POINTER = FreeRTOS_htonl( twLOCAL_IP );
+    xNetworkAddressing.ulNetMask = FreeRTOS_htonl( 0xFFFFFF00UL );
+
+    memset( ucSentPacket, 0, sizeof( ucSentPacket ) );
+    xSendCount = 0;
+}
+
+/*
+ * @brief Fill the received packet.
+ */
+static void prvCreatePacket( uint16_t usPeerPort,
+                             uint32_t ulSequenceNumber,
+                             uint32_t ulAckNumber,
+                             uint8_t ucTCPFlags )
+{
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ucPacket;
+
+    memset( ucPacket, 0, sizeof( ucPacket ) );
+
+    pxTCPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+    pxTCPPacket->xIPHeader.ucVersionHeaderLength = 0x45U;
+    pxTCPPacket->xIPHeader.ucProtocol = ipPROTOCOL_TCP;
+    pxTCPPacket->xIPHeader.ulSourceIPAddress = FreeRTOS_htonl( twPEER_IP );
+    pxTCPPacket->xIPHeader.ulDestinationIPAddress = FreeRTOS_htonl( twLOCAL_IP );
+    pxTCPPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( usPeerPort );
+    pxTCPPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( twLOCAL_PORT );
+    pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
+    pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( ulAckNumber );
+    pxTCPPacket->xTCPHeader.ucTCPFlags = ucTCPFlags;
+    pxTCPPacket->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ipSIZE_OF_TCP_HEADER << 2 );
+    pxTCPPacket->xTCPHeader.usWindow = FreeRTOS_htons( twPEER_WINDOW );
+
+    xNetworkBuffer.pucEthernetBuffer = ucPacket;
+    xNetworkBuffer.xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+}
+
+/*
+ * @brief Let the peer send a packet to the socket.
+ */
+static BaseType_t prvReceive( uint16_t usPeerPort,
+                              uint32_t ulSequenceNumber,
+                              uint8_t ucTCPFlags )
+{
+    prvCreatePacket( usPeerPort, ulSequenceNumber, twOUR_FIN + 1U, ucTCPFlags );
+
+    return xProcessReceivedTCPPacket( &( xNetworkBuffer ) );
+}
+
+/*
+ * @brief Prepare a socket that has sent its FIN.
+ */
+static void prvInitSocket( uint16_t usPeerPort )
+{
+    memset( &( xSocket ), 0, sizeof( xSocket ) );
+    pxReleasedSocket = NULL;
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+    xSocket.usLocalPort = twLOCAL_PORT;
+    xSocket.u.xTCP.ulRemoteIP = twPEER_IP;
+    xSocket.u.xTCP.usRemotePort = usPeerPort;
+    xSocket.u.xTCP.ucTCPState = ( uint8_t ) eFIN_WAIT_1;
+    xSocket.u.xTCP.ucPeerWinScaleFactor = twPEER_WIN_SCALE;
+    xSocket.u.xTCP.bits.bFinSent = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber = twPEER_FIN;
+    xSocket.u.xTCP.xTCPWindow.rx.ulHighestSequenceNumber = twPEER_FIN;
+    xSocket.u.xTCP.xTCPWindow.tx.ulFINSequenceNumber = twOUR_FIN;
+    xSocket.u.xTCP.xTCPWindow.tx.ulCurrentSequenceNumber = twOUR_FIN;
+}
+
+/*
+ * @brief The peer answers the FIN of the socket with a FIN+ACK.  The socket
+ *        sends the last ACK, and the connection is added to the TIME_WAIT table.
+ */
+static void prvSendLastAck( uint16_t usPeerPort )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdPASS, prvReceive( usPeerPort, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+
+    /* The last ACK was sent. */
+    TEST_ASSERT_EQUAL( 1, xSendCount );
+    TEST_ASSERT_EQUAL_HEX8( tcpTCP_FLAG_ACK, pxSent->xTCPHeader.ucTCPFlags );
+    TEST_ASSERT_EQUAL_HEX32( twOUR_FIN + 1U, FreeRTOS_ntohl( pxSent->xTCPHeader.ulSequenceNumber ) );
+    TEST_ASSERT_EQUAL_HEX32( twPEER_FIN + 1U, FreeRTOS_ntohl( pxSent->xTCPHeader.ulAckNr ) );
+    TEST_ASSERT_EQUAL( eCLOSE_WAIT, xSocket.u.xTCP.ucTCPState );
+
+    memset( ucSentPacket, 0, sizeof( ucSentPacket ) );
+    xSendCount = 0;
+}
+
+/*
+ * @brief Close a connection of a socket that is owned by the application.  It
+ *        releases its streams once the connection is in the TIME_WAIT table.
+ */
+static void prvCloseConnection( uint16_t usPeerPort )
+{
+    prvInitSocket( usPeerPort );
+    prvSendLastAck( usPeerPort );
+    TEST_ASSERT_EQUAL_PTR( &( xSocket ), pxReleasedSocket );
+}
+
+/*
+ * @brief Check that the last ACK was sent again.
+ */
+static void prvCheckLastAck( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+
+    TEST_ASSERT_EQUAL( 1, xSendCount );
+    TEST_ASSERT_EQUAL_HEX8( tcpTCP_FLAG_ACK, pxSent->xTCPHeader.ucTCPFlags );
+    TEST_ASSERT_EQUAL_HEX32( twOUR_FIN + 1U, FreeRTOS_ntohl( pxSent->xTCPHeader.ulSequenceNumber ) );
+    TEST_ASSERT_EQUAL_HEX32( twPEER_FIN + 1U, FreeRTOS_ntohl( pxSent->xTCPHeader.ulAckNr ) );
+}
+
+/*
+ * @brief Check that a RST was sent, as for a connection that is not known.
+ */
+static void prvCheckReset( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+
+    TEST_ASSERT_EQUAL( 1, xSendCount );
+    TEST_ASSERT_EQUAL_HEX8( tcpTCP_FLAG_RST, pxSent->xTCPHeader.ucTCPFlags & tcpTCP_FLAG_RST );
+}
+
+/*
+ * @brief Let the closed socket connect to the same peer again, as
+ *        FreeRTOS_connect() does.
+ */
+static void prvConnect( void )
+{
+    xSocket.u.xTCP.ucTCPState = ( uint8_t ) eCONNECT_SYN;
+    xSocket.u.xTCP.bits.bConnPrepared = pdFALSE_UNSIGNED;
+    xSocket.u.xTCP.ucRepCount = 0U;
+    xSocket.u.xTCP.pxAckMessage = NULL;
+}
+
+/*
+ * @brief A child socket that was never accepted is deleted once the last ACK
+ *        has been sent, the TIME_WAIT state is kept in the table.
+ */
+void test_prvTCPHandleFin_ChildSocketClosed( void )
+{
+    prvResetTimeWait();
+    prvInitSocket( twPEER_PORT );
+    xSocket.u.xTCP.bits.bPassAccept = pdTRUE_UNSIGNED;
+
+    prvSendLastAck( twPEER_PORT );
+    TEST_ASSERT_NULL( pxReleasedSocket );
+
+    /* The IP-task closes the socket after handling the packet. */
+    vSocketClose_ExpectAndReturn( &( xSocket ), NULL );
+    vSocketCloseNextTime( NULL );
+
+    /* A repeated FIN is still answered. */
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckLastAck();
+}
+
+/*
+ * @brief A repeated FIN is answered with the last ACK, as often as it comes.
+ */
+void test_xProcessReceivedTCPPacket_RepeatedFinIsAcked( void )
+{
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckLastAck();
+
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckLastAck();
+}
+
+/*
+ * @brief A repeated FIN restarts the waiting time.
+ */
+void test_xProcessReceivedTCPPacket_RepeatedFinRestartsTime( void )
+{
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_TIME_WAIT_MS ) - 1U;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckLastAck();
+
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_TIME_WAIT_MS ) - 1U;
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckLastAck();
+}
+
+/*
+ * @brief A RST does not end the TIME_WAIT state.
+ */
+void test_xProcessReceivedTCPPacket_ResetIgnored( void )
+{
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN + 1U, tcpTCP_FLAG_RST ) );
+    TEST_ASSERT_EQUAL( 0, xSendCount );
+
+    /* The entry is still there. */
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckLastAck();
+}
+
+/*
+ * @brief A late segment of the old connection is dropped, without a RST.
+ */
+void test_xProcessReceivedTCPPacket_LateSegmentDropped( void )
+{
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN - 100U, tcpTCP_FLAG_PSH | tcpTCP_FLAG_ACK ) );
+    TEST_ASSERT_EQUAL( 0, xSendCount );
+}
+
+/*
+ * @brief An old duplicate SYN is dropped, without a RST.
+ */
+void test_xProcessReceivedTCPPacket_OldSynDropped( void )
+{
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_SYN ) );
+    TEST_ASSERT_EQUAL( 0, xSendCount );
+
+    /* The entry is still there. */
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckLastAck();
+}
+
+/*
+ * @brief A SYN with a higher sequence number starts a new connection: it is
+ *        handled as usual, and the entry is forgotten.
+ */
+void test_xProcessReceivedTCPPacket_NewSynAccepted( void )
+{
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+
+    /* The socket is closed, so the SYN is answered with a RST. */
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN + 0x10000U, tcpTCP_FLAG_SYN ) );
+    prvCheckReset();
+
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckReset();
+}
+
+/*
+ * @brief An entry expires after ipconfigTCP_TIME_WAIT_MS.
+ */
+void test_xProcessReceivedTCPPacket_EntryExpires( void )
+{
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_TIME_WAIT_MS );
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckReset();
+}
+
+/*
+ * @brief When the table is full, the oldest entry is replaced.
+ */
+void test_xProcessReceivedTCPPacket_TableFull( void )
+{
+    BaseType_t xIndex;
+
+    prvResetTimeWait();
+
+    /* One more connection than the table can hold. */
+    for( xIndex = 0; xIndex <= ( BaseType_t ) ipconfigTCP_TIME_WAIT_LENGTH; xIndex++ )
+    {
+        prvCloseConnection( twPEER_PORT + ( uint16_t ) xIndex );
+        xTickCount++;
+    }
+
+    /* The first connection was forgotten. */
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckReset();
+
+    /* The last one is still there. */
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT + ( uint16_t ) ipconfigTCP_TIME_WAIT_LENGTH, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckLastAck();
+}
+
+/*
+ * @brief A new connection between the same ports starts beyond the last window
+ *        that the peer advertised, when the chosen initial sequence number is too
+ *        low.  The entry is forgotten.
+ */
+void test_xTCPSocketCheck_ConnectReusesPorts( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+    uint32_t ulWindowSize;
+
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+    ulWindowSize = ( uint32_t ) twPEER_WINDOW << twPEER_WIN_SCALE;
+
+    /* Connect again, as FreeRTOS_connect() would. */
+    prvConnect();
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eARPCacheHit );
+    ulApplicationGetNextSequenceNumber_ExpectAnyArgsAndReturn( twOUR_FIN );
+    vTCPWindowCreate_Ignore();
+
+    ( void ) xTCPSocketCheck( &( xSocket ) );
+
+    TEST_ASSERT_EQUAL( 1, xSendCount );
+    TEST_ASSERT_EQUAL_HEX8( tcpTCP_FLAG_SYN, pxSent->xTCPHeader.ucTCPFlags );
+    TEST_ASSERT_EQUAL_HEX32( twOUR_FIN + 1U + ulWindowSize + 1U, FreeRTOS_ntohl( pxSent->xTCPHeader.ulSequenceNumber ) );
+
+    /* The entry was forgotten: when the socket is closed again, a FIN from the
+     * peer is not answered with the last ACK anymore. */
+    xSocket.u.xTCP.ucTCPState = ( uint8_t ) eCLOSED;
+    xSendCount = 0;
+    TEST_ASSERT_EQUAL( pdFAIL, prvReceive( twPEER_PORT, twPEER_FIN, tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) );
+    prvCheckReset();
+}
+
+/*
+ * @brief An initial sequence number that is already beyond the old connection
+ *        is kept.
+ */
+void test_xTCPSocketCheck_ConnectKeepsHigherSequence( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+
+    prvResetTimeWait();
+    prvCloseConnection( twPEER_PORT );
+
+    prvConnect();
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eARPCacheHit );
+    ulApplicationGetNextSequenceNumber_ExpectAnyArgsAndReturn( twOUR_FIN + 0x10U );
+    vTCPWindowCreate_Ignore();
+
+    ( void ) xTCPSocketCheck( &( xSocket ) );
+
+    TEST_ASSERT_EQUAL( 1, xSendCount );
+    TEST_ASSERT_EQUAL_HEX32( twOUR_FIN + 0x10U, FreeRTOS_ntohl( pxSent->xTCPHeader.ulSequenceNumber ) );
+}
@@ -33,6 +33,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdarg.h>
+#include <string.h>
 #include <ctype.h>
 
 /* FreeRTOS includes. */
@@ -208,7 +209,8 @@
             uxSize = ( sizeof( *xPacketBuffer ) + uxLength ) - sizeof( xPacketBuffer->ucArray );
             xPacketBuffer = ( StreamBuffer_t * ) pvPortMalloc( uxSize );
             configASSERT( xPacketBuffer != NULL );
-            vStreamBufferClear( xPacketBuffer );
+            /* Clear the markers, this stream has no mirror. */
+            ( void ) memset( xPacketBuffer, 0, sizeof( *xPacketBuffer ) - sizeof( xPacketBuffer->ucArray ) );
             xPacketBuffer->LENGTH = uxLength;
         }
 